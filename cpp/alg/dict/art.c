@@ -0,0 +1,912 @@
+/*** File art.c - Adaptive Radix Tree ***/
+#include <stdlib.h>
+#include <string.h>
+#include "art.h"
+
+#if ART_USE_SSE2 && defined(__SSE2__)
+#define ART_SSE2 1
+#include <emmintrin.h>
+#else
+#define ART_SSE2 0
+#endif
+
+
+/* Child pointers to items are marked by setting their lowest bit. */
+#define IS_ITEM(p) ((unsigned long)(p) & 1)
+#define MARK_ITEM(item) ((void *)((unsigned long)(item) | 1))
+#define ITEM(p) ((void *)((unsigned long)(p) & ~1UL))
+
+/* KEY() returns the key of an item in the tree t, and KEY_BYTE() returns byte
+ * d of key, counting from the most significant byte of a key_bytes long key.
+ */
+#define KEY(t, item) ((t)->get_value ? (t)->get_value(item) \
+                                     : (unsigned long)(t)->get_uint(item))
+#define KEY_BYTE(t, key, d) \
+    ((unsigned char)((key) >> (8 * ((t)->key_bytes - 1 - (d)))))
+
+/* Casts to each kind of node. */
+#define NODE4(p) ((art_node4_t *)(p))
+#define NODE16(p) ((art_node16_t *)(p))
+#define NODE48(p) ((art_node48_t *)(p))
+#define NODE256(p) ((art_node256_t *)(p))
+
+
+
+/* The size of each kind of node. */
+const int art_node_size[] = {
+    sizeof(art_node4_t), sizeof(art_node16_t), sizeof(art_node48_t),
+    sizeof(art_node256_t)
+};
+
+
+
+/* Prototypes for functions only visible within this file. */
+art_node_t *art_node_alloc(art_t *t, int type, art_node_t *from);
+void art_free_dfs(art_t *t, art_node_t *node);
+int art_prefix_mismatch(art_t *t, art_node_t *node, unsigned long key, int d);
+void **art_find_child(art_node_t *node, unsigned char b);
+art_node_t *art_add_child(art_t *t, art_node_t *node, unsigned char b,
+                          void *child);
+void *art_remove_child(art_t *t, art_node_t *node, unsigned char b,
+                       void **slot);
+void *art_child_at(art_node_t *node, int pos);
+int art_pos_byte(art_node_t *node, int pos);
+int art_next_pos(art_node_t *node, int pos);
+int art_prev_pos(art_node_t *node, int pos);
+void *art_cursor_descend(art_cursor_t *c, void *p, int first);
+void *art_cursor_step(art_cursor_t *c, int forward);
+
+
+
+/* art_alloc() - Allocates space for an adaptive radix tree and returns a
+ * pointer to it.  The function get_value() returns the key value for a data
+ * item, which must be less than 2 to the power of 8*key_bytes.  key_bytes is
+ * at most ART_MAX_KEY_BYTES, and the size of an unsigned long.  Nodes are
+ * allocated from the pool pointed to by pool, which may be shared with other
+ * dictionaries, or from a new pool of the tree's own if pool is NULL.
+ */
+art_t *art_alloc(unsigned long (* get_value)(const void *), int key_bytes,
+                 pool_t *pool)
+{
+    art_t *t;
+
+    t = malloc(sizeof(art_t));
+    t->own_pool = !pool;
+    t->pool = pool ? pool : pool_alloc();
+    t->root = NULL;
+    t->n = 0;
+    t->key_bytes = key_bytes;
+    t->get_value = get_value;
+    t->get_uint = NULL;
+    OP_RESET(t->ops);
+
+    return t;
+}
+
+
+/* art_free() - Frees space used by the adaptive radix tree pointed to by t.
+ * The nodes of a tree with its own pool are freed all at once, by freeing the
+ * pool.  Otherwise they are returned to the shared pool.
+ */
+void art_free(art_t *t)
+{
+    if(t->own_pool) pool_free(t->pool);
+    else if(t->root && !IS_ITEM(t->root)) art_free_dfs(t, t->root);
+    free(t);
+}
+
+void art_free_dfs(art_t *t, art_node_t *node)
+{
+    void *p;
+    int pos;
+
+    pos = art_next_pos(node, -1);
+    for(; pos >= 0; pos = art_next_pos(node, pos)) {
+        p = art_child_at(node, pos);
+        if(!IS_ITEM(p)) art_free_dfs(t, p);
+    }
+    pool_put(t->pool, node, art_node_size[node->type]);
+}
+
+
+/* art_insert() - Inserts an item into the adaptive radix tree pointed to by
+ * t, according the the value its key.  The key of an item in the tree must be
+ * unique among items in the tree.  If an item with the same key already
+ * exists in the tree, a pointer to that item is returned.  Otherwise, NULL is
+ * returned, indicating insertion was successful.
+ */
+void *art_insert(art_t *t, void *item)
+{
+    unsigned long key, other_key;
+    art_node_t *node, *split;
+    void **link, **slot, *p, *other;
+    int d, i, depth;
+
+    key = KEY(t, item);
+
+    /* link points to the pointer to the current node, and d is the number of
+     * key bytes which lead to it.
+     */
+    link = &t->root;
+    d = 0;
+    for(depth = 1;; depth++) {
+        p = *link;
+        if(!p) {
+            /* Only the root can be empty. */
+            t->root = MARK_ITEM(item);
+            t->n++;
+            return NULL;
+        }
+
+        OP_COMP(t->ops);
+        if(IS_ITEM(p)) {
+            other = ITEM(p);
+            other_key = KEY(t, other);
+            if(other_key == key) return other;  /* Item found. */
+
+            /* Replace the item by a Node4 holding both items, with the key
+             * bytes they share as its prefix.
+             */
+            node = art_node_alloc(t, ART_NODE4, NULL);
+            i = 0;
+            while(KEY_BYTE(t, other_key, d + i) == KEY_BYTE(t, key, d + i)) {
+                node->prefix[i] = KEY_BYTE(t, key, d + i);
+                i++;
+            }
+            node->prefix_len = i;
+            art_add_child(t, node, KEY_BYTE(t, other_key, d + i), p);
+            art_add_child(t, node, KEY_BYTE(t, key, d + i), MARK_ITEM(item));
+            *link = node;
+            break;
+        }
+
+        node = p;
+        if(node->prefix_len) {
+            i = art_prefix_mismatch(t, node, key, d);
+            if(i < node->prefix_len) {
+                /* The key leaves the prefix after i bytes.  Split the prefix
+                 * with a new Node4, keeping the node below it.
+                 */
+                split = art_node_alloc(t, ART_NODE4, NULL);
+                split->prefix_len = i;
+                memcpy(split->prefix, node->prefix, i);
+                art_add_child(t, split, node->prefix[i], node);
+                art_add_child(t, split, KEY_BYTE(t, key, d + i),
+                              MARK_ITEM(item));
+                node->prefix_len -= i + 1;
+                memmove(node->prefix, node->prefix + i + 1, node->prefix_len);
+                *link = split;
+                OP_RESTRUCT(t->ops);
+                break;
+            }
+            d += node->prefix_len;
+        }
+
+        slot = art_find_child(node, KEY_BYTE(t, key, d));
+        if(!slot) {
+            *link = art_add_child(t, node, KEY_BYTE(t, key, d),
+                                  MARK_ITEM(item));
+            break;
+        }
+        link = slot;
+        d++;
+    }
+
+    OP_DEPTH(t->ops, depth);
+    t->n++;
+
+    return NULL;
+}
+
+
+/* art_find() - Find an item in the adaptive radix tree with the same key as
+ * the item pointed to by `key_item'.  Returns a pointer to the item found, or
+ * NULL if no item was found.
+ */
+void *art_find(art_t *t, void *key_item)
+{
+    unsigned long key;
+    art_node_t *node;
+    void **slot, *p;
+    int d;
+
+    key = KEY(t, key_item);
+    p = t->root;
+    d = 0;
+    while(p && !IS_ITEM(p)) {
+        OP_COMP(t->ops);
+        node = p;
+        if(node->prefix_len) {
+            if(art_prefix_mismatch(t, node, key, d) < node->prefix_len) {
+                return NULL;
+            }
+            d += node->prefix_len;
+        }
+        slot = art_find_child(node, KEY_BYTE(t, key, d));
+        p = slot ? *slot : NULL;
+        d++;
+    }
+
+    /* Key bytes below the item's position have not been compared. */
+    if(!p) return NULL;
+    OP_COMP(t->ops);
+    return KEY(t, ITEM(p)) == key ? ITEM(p) : NULL;
+}
+
+
+/* art_find_min() - Returns a pointer to the minimum item in the adaptive
+ * radix tree pointed to by t.  If there are no items in the tree, a NULL
+ * pointer is returned.
+ */
+void *art_find_min(art_t *t)
+{
+    art_node_t *node;
+    void *p;
+
+    p = t->root;
+    if(!p) return NULL;
+    while(!IS_ITEM(p)) {
+        node = p;
+        p = art_child_at(node, art_next_pos(node, -1));
+    }
+
+    return ITEM(p);
+}
+
+
+/* art_delete() - Delete the item in the adaptive radix tree with the same key
+ * as the item pointed to by `key_item'.  Returns a pointer to the deleted
+ * item, and NULL if no item was found.
+ */
+void *art_delete(art_t *t, void *key_item)
+{
+    unsigned long key;
+    art_node_t *node;
+    void **link, **slot, *p, *item;
+    unsigned char b;
+    int d;
+
+    key = KEY(t, key_item);
+    p = t->root;
+    if(!p) return NULL;
+    if(IS_ITEM(p)) {
+        item = ITEM(p);
+        OP_COMP(t->ops);
+        if(KEY(t, item) != key) return NULL;
+        t->root = NULL;
+        t->n--;
+        return item;
+    }
+
+    link = &t->root;
+    d = 0;
+    for(;;) {
+        OP_COMP(t->ops);
+        node = p;
+        if(node->prefix_len) {
+            if(art_prefix_mismatch(t, node, key, d) < node->prefix_len) {
+                return NULL;
+            }
+            d += node->prefix_len;
+        }
+        b = KEY_BYTE(t, key, d);
+        if(!(slot = art_find_child(node, b))) return NULL;
+        p = *slot;
+        if(IS_ITEM(p)) break;
+        link = slot;
+        d++;
+    }
+
+    item = ITEM(p);
+    OP_COMP(t->ops);
+    if(KEY(t, item) != key) return NULL;
+
+    *link = art_remove_child(t, node, b, slot);
+    t->n--;
+
+    return item;
+}
+
+
+/* art_delete_min() - Deletes the item with the smallest key from the adaptive
+ * radix tree pointed to by t.  Returns a pointer to the deleted item.  Returns
+ * a NULL pointer if there are no items in the tree.
+ */
+void *art_delete_min(art_t *t)
+{
+    void *item;
+
+    item = art_find_min(t);
+    return item ? art_delete(t, item) : NULL;
+}
+
+
+/* art_cursor_alloc() - Returns a new cursor on the adaptive radix tree
+ * pointed to by t.  The cursor must be positioned by art_cursor_seek() before
+ * use, and again whenever the tree has been changed.
+ */
+art_cursor_t *art_cursor_alloc(art_t *t)
+{
+    art_cursor_t *c;
+
+    c = malloc(sizeof(art_cursor_t));
+    c->t = t;
+    c->tos = 0;
+    c->item = NULL;
+
+    return c;
+}
+
+
+/* art_cursor_free() - Frees space used by the cursor pointed to by c. */
+void art_cursor_free(art_cursor_t *c)
+{
+    free(c);
+}
+
+
+/* art_cursor_seek() - Moves the cursor pointed to by c to the first item with
+ * a key not less than that of the item pointed to by `key_item', or to the
+ * first item if key_item is NULL, and returns it.  If there is no such item,
+ * the cursor is moved past the last item and NULL is returned.
+ */
+void *art_cursor_seek(art_cursor_t *c, void *key_item)
+{
+    art_t *t;
+    art_node_t *node;
+    unsigned long key;
+    unsigned char b;
+    void *p, *item;
+    int d, i, pos;
+
+    t = c->t;
+    c->tos = 0;
+    c->item = NULL;
+    if(!(p = t->root)) return NULL;
+    if(!key_item) return art_cursor_descend(c, p, 1);
+
+    /* Follow the key down the tree, until reaching a subtree whose items are
+     * all greater than the key, or all less than it.
+     */
+    key = KEY(t, key_item);
+    d = 0;
+    for(;;) {
+        if(IS_ITEM(p)) {
+            if(KEY(t, ITEM(p)) >= key) return c->item = ITEM(p);
+            break;
+        }
+
+        node = p;
+        i = art_prefix_mismatch(t, node, key, d);
+        if(i < node->prefix_len) {
+            if(node->prefix[i] > KEY_BYTE(t, key, d + i)) {
+                return art_cursor_descend(c, p, 1);
+            }
+            break;
+        }
+        d += node->prefix_len;
+
+        b = KEY_BYTE(t, key, d);
+        pos = art_next_pos(node, -1);
+        while(pos >= 0 && art_pos_byte(node, pos) < b) {
+            pos = art_next_pos(node, pos);
+        }
+        if(pos < 0) break;
+
+        c->stack[c->tos] = node;
+        c->pos[c->tos++] = pos;
+        p = art_child_at(node, pos);
+        if(art_pos_byte(node, pos) > b) return art_cursor_descend(c, p, 1);
+        d++;
+    }
+
+    /* The items of subtree p are all less than the key, so the item wanted is
+     * the first one after the subtree.
+     */
+    item = art_cursor_step(c, 1);
+    if(!item) c->tos = 0;
+
+    return item;
+}
+
+
+/* art_cursor_next() - Moves the cursor pointed to by c to the next item and
+ * returns it.  If there is no next item, NULL is returned and the cursor is
+ * not moved.
+ */
+void *art_cursor_next(art_cursor_t *c)
+{
+    if(!c->item) return NULL;
+    return art_cursor_step(c, 1);
+}
+
+
+/* art_cursor_prev() - Moves the cursor pointed to by c to the previous item,
+ * or to the last item if it is past the last item, and returns it.  If there
+ * is no such item, NULL is returned and the cursor is not moved.
+ */
+void *art_cursor_prev(art_cursor_t *c)
+{
+    if(!c->item) {
+        if(!c->t->root) return NULL;
+        c->tos = 0;
+        return art_cursor_descend(c, c->t->root, 0);
+    }
+    return art_cursor_step(c, 0);
+}
+
+
+
+/*** Functions only visible within this file. ***/
+
+/* art_node_alloc() - Allocates an empty node of kind type.  If from is not
+ * NULL, its prefix is copied to the new node.
+ */
+art_node_t *art_node_alloc(art_t *t, int type, art_node_t *from)
+{
+    art_node_t *node;
+
+    OP_ALLOC(t->ops);
+    node = pool_get(t->pool, art_node_size[type]);
+    node->type = type;
+    node->n = 0;
+    if(from) {
+        node->prefix_len = from->prefix_len;
+        memcpy(node->prefix, from->prefix, from->prefix_len);
+    }
+    else {
+        node->prefix_len = 0;
+    }
+
+    if(type == ART_NODE48) {
+        memset(NODE48(node)->index, 0, 256);
+        memset(NODE48(node)->child, 0, 48 * sizeof(void *));
+    }
+    else if(type == ART_NODE256) {
+        memset(NODE256(node)->child, 0, 256 * sizeof(void *));
+    }
+
+    return node;
+}
+
+
+/* art_prefix_mismatch() - Returns the number of bytes of the prefix of the
+ * node pointed to by node which match key from byte d on.
+ */
+int art_prefix_mismatch(art_t *t, art_node_t *node, unsigned long key, int d)
+{
+    int i;
+
+    for(i = 0; i < node->prefix_len; i++) {
+        if(node->prefix[i] != KEY_BYTE(t, key, d + i)) break;
+    }
+
+    return i;
+}
+
+
+/* art_find_child() - Returns a pointer to the child pointer for key byte b in
+ * the node pointed to by node, or NULL if there is no such child.
+ */
+void **art_find_child(art_node_t *node, unsigned char b)
+{
+    art_node4_t *n4;
+    art_node16_t *n16;
+    int i;
+#if ART_SSE2
+    unsigned int m;
+#endif
+
+    switch(node->type) {
+    case ART_NODE4:
+        n4 = NODE4(node);
+        for(i = 0; i < node->n; i++) {
+            if(n4->key[i] == b) return &n4->child[i];
+        }
+        return NULL;
+
+    case ART_NODE16:
+        n16 = NODE16(node);
+#if ART_SSE2
+        /* Compare all 16 key bytes at once, ignoring those not in use. */
+        m = _mm_movemask_epi8(
+                _mm_cmpeq_epi8(_mm_set1_epi8((char)b),
+                               _mm_loadu_si128((const __m128i *)n16->key)))
+            & ((1u << node->n) - 1);
+        return m ? &n16->child[__builtin_ctz(m)] : NULL;
+#else
+        for(i = 0; i < node->n; i++) {
+            if(n16->key[i] == b) return &n16->child[i];
+        }
+        return NULL;
+#endif
+
+    case ART_NODE48:
+        i = NODE48(node)->index[b];
+        return i ? &NODE48(node)->child[i - 1] : NULL;
+
+    default:
+        return NODE256(node)->child[b] ? &NODE256(node)->child[b] : NULL;
+    }
+}
+
+
+/* art_add_child() - Adds the child pointer child, for key byte b, to the node
+ * pointed to by node, which has no child for b.  A full node is replaced by a
+ * node of the next larger kind.  Returns a pointer to the node now holding
+ * the children.
+ */
+art_node_t *art_add_child(art_t *t, art_node_t *node, unsigned char b,
+                          void *child)
+{
+    art_node_t *new_node;
+    unsigned char *key;
+    void **children;
+    int i, c, max;
+
+    OP_LINK(t->ops);
+    switch(node->type) {
+    case ART_NODE4:
+    case ART_NODE16:
+        if(node->type == ART_NODE4) {
+            key = NODE4(node)->key;
+            children = NODE4(node)->child;
+            max = 4;
+        }
+        else {
+            key = NODE16(node)->key;
+            children = NODE16(node)->child;
+            max = 16;
+        }
+
+        if(node->n < max) {
+            /* Keep the key bytes in increasing order. */
+            for(i = node->n; i > 0 && key[i - 1] > b; i--) {
+                key[i] = key[i - 1];
+                children[i] = children[i - 1];
+            }
+            key[i] = b;
+            children[i] = child;
+            node->n++;
+            return node;
+        }
+
+        new_node = art_node_alloc(t, node->type + 1, node);
+        if(node->type == ART_NODE4) {
+            memcpy(NODE16(new_node)->key, key, 4);
+            memcpy(NODE16(new_node)->child, children, 4 * sizeof(void *));
+        }
+        else {
+            for(i = 0; i < 16; i++) {
+                NODE48(new_node)->index[key[i]] = i + 1;
+                NODE48(new_node)->child[i] = children[i];
+            }
+        }
+        break;
+
+    case ART_NODE48:
+        if(node->n < 48) {
+            /* Deleted children can leave gaps, so look for a free position.
+             */
+            for(i = 0; NODE48(node)->child[i]; i++) ;
+            NODE48(node)->child[i] = child;
+            NODE48(node)->index[b] = i + 1;
+            node->n++;
+            return node;
+        }
+
+        new_node = art_node_alloc(t, ART_NODE256, node);
+        for(c = 0; c < 256; c++) {
+            if((i = NODE48(node)->index[c])) {
+                NODE256(new_node)->child[c] = NODE48(node)->child[i - 1];
+            }
+        }
+        break;
+
+    default:
+        NODE256(node)->child[b] = child;
+        node->n++;
+        return node;
+    }
+
+    new_node->n = node->n;
+    pool_put(t->pool, node, art_node_size[node->type]);
+    OP_RESTRUCT(t->ops);
+
+    return art_add_child(t, new_node, b, child);
+}
+
+
+/* art_remove_child() - Removes the child pointer at slot, for key byte b,
+ * from the node pointed to by node.  A sparse node is replaced by a node of
+ * the next smaller kind, and a Node4 with one child left is replaced by its
+ * child.  Returns the pointer which should now take the place of the node.
+ */
+void *art_remove_child(art_t *t, art_node_t *node, unsigned char b,
+                       void **slot)
+{
+    art_node_t *new_node, *child;
+    unsigned char *key;
+    void **children;
+    int i, c, len;
+
+    OP_LINK(t->ops);
+    switch(node->type) {
+    case ART_NODE4:
+    case ART_NODE16:
+        if(node->type == ART_NODE4) {
+            key = NODE4(node)->key;
+            children = NODE4(node)->child;
+        }
+        else {
+            key = NODE16(node)->key;
+            children = NODE16(node)->child;
+        }
+        for(i = slot - children + 1; i < node->n; i++) {
+            key[i - 1] = key[i];
+            children[i - 1] = children[i];
+        }
+        node->n--;
+
+        if(node->type == ART_NODE16) {
+            if(node->n > 3) return node;
+            new_node = art_node_alloc(t, ART_NODE4, node);
+            memcpy(NODE4(new_node)->key, key, node->n);
+            memcpy(NODE4(new_node)->child, children, node->n * sizeof(void *));
+            break;
+        }
+        if(node->n > 1) return node;
+
+        /* Replace the node by its only child.  An inner node child takes the
+         * node's prefix, and the key byte leading to it, onto the front of its
+         * own prefix.
+         */
+        child = children[0];
+        if(!IS_ITEM(child)) {
+            len = node->prefix_len + 1;
+            memmove(child->prefix + len, child->prefix, child->prefix_len);
+            memcpy(child->prefix, node->prefix, node->prefix_len);
+            child->prefix[node->prefix_len] = key[0];
+            child->prefix_len += len;
+        }
+        pool_put(t->pool, node, sizeof(art_node4_t));
+        OP_RESTRUCT(t->ops);
+        return child;
+
+    case ART_NODE48:
+        *slot = NULL;
+        NODE48(node)->index[b] = 0;
+        if(--node->n > 12) return node;
+
+        new_node = art_node_alloc(t, ART_NODE16, node);
+        for(c = i = 0; c < 256; c++) {
+            if(NODE48(node)->index[c]) {
+                NODE16(new_node)->key[i] = c;
+                NODE16(new_node)->child[i++] =
+                    NODE48(node)->child[NODE48(node)->index[c] - 1];
+            }
+        }
+        break;
+
+    default:
+        *slot = NULL;
+        if(--node->n > 37) return node;
+
+        new_node = art_node_alloc(t, ART_NODE48, node);
+        for(c = i = 0; c < 256; c++) {
+            if(NODE256(node)->child[c]) {
+                NODE48(new_node)->child[i] = NODE256(node)->child[c];
+                NODE48(new_node)->index[c] = ++i;
+            }
+        }
+        break;
+    }
+
+    new_node->n = node->n;
+    pool_put(t->pool, node, art_node_size[node->type]);
+    OP_RESTRUCT(t->ops);
+
+    return new_node;
+}
+
+
+/* art_child_at() - Returns the child pointer at position pos of the node
+ * pointed to by node.
+ */
+void *art_child_at(art_node_t *node, int pos)
+{
+    switch(node->type) {
+    case ART_NODE4:
+        return NODE4(node)->child[pos];
+    case ART_NODE16:
+        return NODE16(node)->child[pos];
+    case ART_NODE48:
+        return NODE48(node)->child[NODE48(node)->index[pos] - 1];
+    default:
+        return NODE256(node)->child[pos];
+    }
+}
+
+
+/* art_pos_byte() - Returns the key byte of the child at position pos of the
+ * node pointed to by node.
+ */
+int art_pos_byte(art_node_t *node, int pos)
+{
+    switch(node->type) {
+    case ART_NODE4:
+        return NODE4(node)->key[pos];
+    case ART_NODE16:
+        return NODE16(node)->key[pos];
+    default:
+        return pos;
+    }
+}
+
+
+/* art_next_pos() - Returns the position of the first child of the node
+ * pointed to by node after position pos, or -1 if there is none.  pos may be
+ * -1, to find the first child.
+ */
+int art_next_pos(art_node_t *node, int pos)
+{
+    switch(node->type) {
+    case ART_NODE4:
+    case ART_NODE16:
+        return pos + 1 < node->n ? pos + 1 : -1;
+    case ART_NODE48:
+        for(pos++; pos < 256; pos++) if(NODE48(node)->index[pos]) return pos;
+        return -1;
+    default:
+        for(pos++; pos < 256; pos++) if(NODE256(node)->child[pos]) return pos;
+        return -1;
+    }
+}
+
+
+/* art_prev_pos() - Returns the position of the last child of the node pointed
+ * to by node before position pos, or -1 if there is none.  pos may be 256, to
+ * find the last child.
+ */
+int art_prev_pos(art_node_t *node, int pos)
+{
+    switch(node->type) {
+    case ART_NODE4:
+    case ART_NODE16:
+        return (pos < node->n ? pos : node->n) - 1;
+    case ART_NODE48:
+        for(pos--; pos >= 0; pos--) if(NODE48(node)->index[pos]) return pos;
+        return -1;
+    default:
+        for(pos--; pos >= 0; pos--) if(NODE256(node)->child[pos]) return pos;
+        return -1;
+    }
+}
+
+
+/* art_cursor_descend() - Moves the cursor pointed to by c to the first item,
+ * or to the last item if first is 0, of the subtree p below the nodes on its
+ * stack, and returns it.
+ */
+void *art_cursor_descend(art_cursor_t *c, void *p, int first)
+{
+    art_node_t *node;
+    int pos;
+
+    while(!IS_ITEM(p)) {
+        node = p;
+        pos = first ? art_next_pos(node, -1) : art_prev_pos(node, 256);
+        c->stack[c->tos] = node;
+        c->pos[c->tos++] = pos;
+        p = art_child_at(node, pos);
+    }
+
+    return c->item = ITEM(p);
+}
+
+
+/* art_cursor_step() - Moves the cursor pointed to by c to the item after the
+ * subtree at the position on top of its stack, or before it if forward is 0,
+ * and returns it.  If there is no such item, NULL is returned and the cursor
+ * is not moved.
+ */
+void *art_cursor_step(art_cursor_t *c, int forward)
+{
+    int i, pos;
+
+    pos = -1;
+    for(i = c->tos - 1; i >= 0; i--) {
+        pos = forward ? art_next_pos(c->stack[i], c->pos[i])
+                      : art_prev_pos(c->stack[i], c->pos[i]);
+        if(pos >= 0) break;
+    }
+    if(i < 0) return NULL;
+
+    c->tos = i + 1;
+    c->pos[i] = pos;
+    return art_cursor_descend(c, art_child_at(c->stack[i], pos), forward);
+}
+
+
+
+/*** Implement the universal dictionary structure type ***/
+
+/*** Adaptive radix tree wrapper functions. ***/
+
+void *_art_alloc(int (* compar)(const void *, const void *),
+                 unsigned int (* getval)(const void *)) {
+    art_t *t;
+
+    t = art_alloc(NULL, sizeof(unsigned int), NULL);
+    t->get_uint = getval;
+    return t;
+}
+
+void _art_free(void *t) {
+    art_free((art_t *)t);
+}
+
+void *_art_insert(void *t, void *item) {
+    return art_insert((art_t *)t, item);
+}
+
+void *_art_delete(void *t, void *key_item) {
+    return art_delete((art_t *)t, key_item);
+}
+
+void *_art_delete_min(void *t) {
+    return art_delete_min((art_t *)t);
+}
+
+void *_art_find(void *t, void *key_item) {
+    return art_find((art_t *)t, key_item);
+}
+
+void *_art_find_min(void *t) {
+    return art_find_min((art_t *)t);
+}
+
+const opcount_t *_art_counts(void *t) {
+    return &((art_t *)t)->ops;
+}
+
+void *_art_cursor_alloc(void *t) {
+    return art_cursor_alloc((art_t *)t);
+}
+
+void _art_cursor_free(void *c) {
+    art_cursor_free((art_cursor_t *)c);
+}
+
+void *_art_cursor_seek(void *c, void *key_item) {
+    return art_cursor_seek((art_cursor_t *)c, key_item);
+}
+
+void *_art_cursor_next(void *c) {
+    return art_cursor_next((art_cursor_t *)c);
+}
+
+void *_art_cursor_prev(void *c) {
+    return art_cursor_prev((art_cursor_t *)c);
+}
+
+/* Adaptive radix tree info */
+const dict_info_t ART_info = {
+    _art_alloc,
+    _art_free,
+    _art_insert,
+    _art_delete,
+    _art_delete_min,
+    _art_find,
+    _art_find_min,
+    _art_counts,
+    _art_cursor_alloc,
+    _art_cursor_free,
+    _art_cursor_seek,
+    _art_cursor_next,
+    _art_cursor_prev,
+    NULL,  /* The shape of the tree does not depend on the order of
+            * insertion, so there is no bulk load.
+            */
+    NULL   /* No batched find. */
+};
@@ -0,0 +1,221 @@
+/*** File art.h - Adaptive Radix Tree ***/
+#ifndef ART_H
+#define ART_H
+#include "dict_info.h"  /* Defines the universal dictionary structure type. */
+#include "pool.h"
+
+/* An adaptive radix tree indexes items by an integer key of up to 8 bytes,
+ * obtained from an item by a get_value() function, like the digital and radix
+ * search trees of dst.h and rst.h.  Rather than branching on one bit of the
+ * key at each level, it branches on one byte, so a lookup visits at most one
+ * node per key byte.
+ *
+ * To keep the space used by nodes with few children small, there are four
+ * kinds of inner node, holding up to 4, 16, 48 and 256 children.  A node is
+ * replaced by the next larger kind when it is full, and by the next smaller
+ * kind when it becomes sparse:
+ *     Node4, Node16 - sorted arrays of key bytes, with a parallel array of
+ *                     child pointers.  Node16 is searched with SSE2
+ *                     instructions when available.
+ *     Node48 - a 256 entry array, indexed by key byte, of positions in an
+ *              array of 48 child pointers.
+ *     Node256 - an array of 256 child pointers, indexed by key byte.
+ *
+ * Two further techniques keep the tree shallow.  With path compression, a
+ * chain of inner nodes with one child each is removed, and the key bytes it
+ * covered are kept as a prefix in the node below it.  With lazy expansion, an
+ * item is stored as high in the tree as its key is unique, rather than at the
+ * level of its last key byte.  Items are stored directly as child pointers,
+ * marked by their lowest bit, so items must be aligned to at least 2 bytes.
+ *
+ * Keys are compared as unsigned integers, and items are kept in key order, so
+ * the tree supports the minimum and cursor operations of other ordered
+ * dictionaries.
+ */
+
+
+/*** Compile Time Options ***/
+
+/* Use 1 to search Node16 with SSE2 instructions when the compiler supports
+ * them, or 0 to always use portable C.
+ */
+#define ART_USE_SSE2 1
+
+/* The largest number of key bytes supported. */
+#define ART_MAX_KEY_BYTES 8
+
+
+
+/*** Structure Type Definitions. ***/
+
+/* The kinds of inner node. */
+#define ART_NODE4 0
+#define ART_NODE16 1
+#define ART_NODE48 2
+#define ART_NODE256 3
+
+/* The header shared by all kinds of inner node:
+ *     type - the kind of node, one of ART_NODE4 to ART_NODE256.
+ *     prefix_len - the number of key bytes in prefix.
+ *     n - the number of children.
+ *     prefix - the key bytes, shared by all items below the node, which come
+ *              before the byte the node branches on.
+ * Child pointers point to an inner node, or to an item if their lowest bit is
+ * set.
+ */
+typedef struct art_node {
+    unsigned char type;
+    unsigned char prefix_len;
+    unsigned short n;
+    unsigned char prefix[ART_MAX_KEY_BYTES];
+} art_node_t;
+
+typedef struct art_node4 {
+    art_node_t h;
+    unsigned char key[4];
+    void *child[4];
+} art_node4_t;
+
+typedef struct art_node16 {
+    art_node_t h;
+    unsigned char key[16];
+    void *child[16];
+} art_node16_t;
+
+/* index[b] is 1 more than the position in child[] of the child for key byte
+ * b, or 0 if there is no such child.
+ */
+typedef struct art_node48 {
+    art_node_t h;
+    unsigned char index[256];
+    void *child[48];
+} art_node48_t;
+
+typedef struct art_node256 {
+    art_node_t h;
+    void *child[256];
+} art_node256_t;
+
+/* The adaptive radix tree structure type has the following fields:
+ *   root - a pointer to the root inner node, or a marked pointer to the only
+ *          item, or NULL if the tree is empty.
+ *   n - the number of items stored in the tree.
+ *   key_bytes - the number of bytes in a key.
+ *   get_value - the function returning the key of an item.
+ *   get_uint - used in place of get_value when that is NULL, for trees
+ *              allocated through ART_info, whose get_value() functions return
+ *              an unsigned int.
+ *   pool - the pool that nodes are allocated from.
+ *   own_pool - 1 if the pool belongs to the tree, and 0 if it is shared.
+ *   ops - counts the operations performed on the tree, for experimental
+ *         purposes.
+ */
+typedef struct art {
+    void *root;
+    int n;
+    int key_bytes;
+    unsigned long (* get_value)(const void *);
+    unsigned int (* get_uint)(const void *);
+    pool_t *pool;
+    int own_pool;
+    opcount_t ops;
+} art_t;
+
+/* Structure type for a cursor on the adaptive radix tree.  stack[0..tos-1]
+ * holds the path of inner nodes from the root to the current item, and pos[i]
+ * is the position of the next node, or the item, in stack[i].  Positions are
+ * array indexes in Node4 and Node16, and key bytes in Node48 and Node256.
+ * item is the current item, or NULL when the cursor is past the last item.
+ */
+typedef struct art_cursor {
+    art_t *t;
+    art_node_t *stack[ART_MAX_KEY_BYTES];
+    int pos[ART_MAX_KEY_BYTES];
+    int tos;
+    void *item;
+} art_cursor_t;
+
+
+
+/*** Function prototypes. ***/
+
+/* art_alloc() - Allocates space for an adaptive radix tree and returns a
+ * pointer to it.  The function get_value() returns the key value for a data
+ * item, which must be less than 2 to the power of 8*key_bytes.  key_bytes is
+ * at most ART_MAX_KEY_BYTES, and the size of an unsigned long.  Nodes are
+ * allocated from the pool pointed to by pool, which may be shared with other
+ * dictionaries, or from a new pool of the tree's own if pool is NULL.
+ */
+art_t *art_alloc(unsigned long (* get_value)(const void *), int key_bytes,
+                 pool_t *pool);
+
+/* art_free() - Frees space used by the adaptive radix tree pointed to by t.
+ * The nodes of a tree with its own pool are freed all at once, by freeing the
+ * pool.  Otherwise they are returned to the shared pool.
+ */
+void art_free(art_t *t);
+
+/* art_insert() - Inserts an item into the adaptive radix tree pointed to by
+ * t, according the the value its key.  The key of an item in the tree must be
+ * unique among items in the tree.  If an item with the same key already
+ * exists in the tree, a pointer to that item is returned.  Otherwise, NULL is
+ * returned, indicating insertion was successful.
+ */
+void *art_insert(art_t *t, void *item);
+
+/* art_find() - Find an item in the adaptive radix tree with the same key as
+ * the item pointed to by `key_item'.  Returns a pointer to the item found, or
+ * NULL if no item was found.
+ */
+void *art_find(art_t *t, void *key_item);
+
+/* art_find_min() - Returns a pointer to the minimum item in the adaptive
+ * radix tree pointed to by t.  If there are no items in the tree, a NULL
+ * pointer is returned.
+ */
+void *art_find_min(art_t *t);
+
+/* art_delete() - Delete the item in the adaptive radix tree with the same key
+ * as the item pointed to by `key_item'.  Returns a pointer to the deleted
+ * item, and NULL if no item was found.
+ */
+void *art_delete(art_t *t, void *key_item);
+
+/* art_delete_min() - Deletes the item with the smallest key from the adaptive
+ * radix tree pointed to by t.  Returns a pointer to the deleted item.  Returns
+ * a NULL pointer if there are no items in the tree.
+ */
+void *art_delete_min(art_t *t);
+
+/* art_cursor_alloc() - Returns a new cursor on the adaptive radix tree
+ * pointed to by t.  The cursor must be positioned by art_cursor_seek() before
+ * use, and again whenever the tree has been changed.
+ */
+art_cursor_t *art_cursor_alloc(art_t *t);
+
+/* art_cursor_free() - Frees space used by the cursor pointed to by c. */
+void art_cursor_free(art_cursor_t *c);
+
+/* art_cursor_seek() - Moves the cursor pointed to by c to the first item with
+ * a key not less than that of the item pointed to by `key_item', or to the
+ * first item if key_item is NULL, and returns it.  If there is no such item,
+ * the cursor is moved past the last item and NULL is returned.
+ */
+void *art_cursor_seek(art_cursor_t *c, void *key_item);
+
+/* art_cursor_next() - Moves the cursor pointed to by c to the next item and
+ * returns it.  If there is no next item, NULL is returned and the cursor is
+ * not moved.
+ */
+void *art_cursor_next(art_cursor_t *c);
+
+/* art_cursor_prev() - Moves the cursor pointed to by c to the previous item,
+ * or to the last item if it is past the last item, and returns it.  If there
+ * is no such item, NULL is returned and the cursor is not moved.
+ */
+void *art_cursor_prev(art_cursor_t *c);
+
+/*** Alternative interface via the universal dictionary structure type. ***/
+extern const dict_info_t ART_info;
+
+#endif
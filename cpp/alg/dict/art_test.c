@@ -0,0 +1,290 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "art.h"
+
+
+#define N_ITEMS 15000
+#define KEY_BYTES 8
+
+/* Keys are 64 bits, formed from one of N_BASES random high halves and a small
+ * random low half, so that items share long key prefixes.
+ */
+#define N_BASES 4
+#define RND_MAX 30000
+
+
+typedef struct test_item {
+    unsigned long key;
+    int data;
+} test_item_t;
+
+
+unsigned long item_val(const void *item)
+{
+    return ((test_item_t *)item)->key;
+}
+
+
+/* Returns byte d of key, counting from the most significant byte. */
+int key_byte(unsigned long key, int d)
+{
+    return (int)(key >> (8 * (KEY_BYTES - 1 - d))) & 0xff;
+}
+
+/* check_subtree() - checks the subtree p, which is reached after d key bytes.
+ * Each inner node must have a number of children in the range for its kind,
+ * and its children in increasing order of key byte, and each item must have
+ * the key bytes leading to it.  Items must be reached in increasing order of
+ * key, with *last the key of the previous item, and *n the number of items
+ * reached so far.  Returns 0 if a check failed.
+ */
+int check_subtree(void *p, int d, unsigned long *last, int *n)
+{
+    static const int min_n[] = { 2, 4, 13, 38 }, max_n[] = { 4, 16, 48, 256 };
+    art_node_t *node;
+    unsigned long key;
+    void *child;
+    int i, b, c, count;
+
+    if((unsigned long)p & 1) {
+        key = item_val((void *)((unsigned long)p & ~1UL));
+        if(*n > 0 && key <= *last) return 0;
+        *last = key;
+        (*n)++;
+        return 1;
+    }
+
+    node = p;
+    if(node->n < min_n[node->type] || node->n > max_n[node->type]) return 0;
+    count = 0;
+    for(b = 0; b < 256; b++) {
+        switch(node->type) {
+        case ART_NODE4:
+            child = NULL;
+            for(i = 0; i < node->n; i++) {
+                if(((art_node4_t *)node)->key[i] == b) {
+                    child = ((art_node4_t *)node)->child[i];
+                }
+            }
+            break;
+        case ART_NODE16:
+            child = NULL;
+            for(i = 0; i < node->n; i++) {
+                if(((art_node16_t *)node)->key[i] == b) {
+                    child = ((art_node16_t *)node)->child[i];
+                }
+            }
+            break;
+        case ART_NODE48:
+            i = ((art_node48_t *)node)->index[b];
+            child = i ? ((art_node48_t *)node)->child[i - 1] : NULL;
+            break;
+        default:
+            child = ((art_node256_t *)node)->child[b];
+        }
+        if(!child) continue;
+        count++;
+
+        /* The items below the child must have the prefix and key byte. */
+        c = *n;
+        if(!check_subtree(child, d + node->prefix_len + 1, last, n)) return 0;
+        if(*n == c) return 0;
+        for(i = 0; i < node->prefix_len; i++) {
+            if(key_byte(*last, d + i) != node->prefix[i]) return 0;
+        }
+        if(key_byte(*last, d + node->prefix_len) != b) return 0;
+    }
+
+    return count == node->n;
+}
+
+/* check_tree() - checks the whole tree, and exits if a check fails. */
+void check_tree(art_t *t)
+{
+    unsigned long last;
+    int n;
+
+    n = 0;
+    last = 0;
+    if(t->root && (!check_subtree(t->root, 0, &last, &n) || n != t->n)) {
+        printf("tree structure is wrong.\n");
+        exit(1);
+    }
+}
+
+
+/* Compares the items pointed to by two elements of an array of item pointers,
+ * for sorting the array with qsort().
+ */
+int item_ptr_cmp(const void *p1, const void *p2)
+{
+    unsigned long k1, k2;
+
+    k1 = (*(test_item_t **)p1)->key;
+    k2 = (*(test_item_t **)p2)->key;
+    return k1 < k2 ? -1 : k1 > k2;
+}
+
+
+int main(void)
+{
+    art_t *t;
+    art_cursor_t *c;
+    pool_t *pool;
+    test_item_t item_array[N_ITEMS], *i, *i2, duplicate, lookup_item;
+    test_item_t *result, *sorted[N_ITEMS];
+    unsigned long bases[N_BASES];
+    int j;
+
+    for(j = 0; j < N_BASES; j++) {
+        bases[j] = (unsigned long)rand() << 40;
+        bases[j] ^= (unsigned long)rand() << 32;
+    }
+
+    /* Create an adaptive radix tree. */
+    t = art_alloc(item_val, KEY_BYTES, NULL);
+
+    /* Add some items to it. */
+    printf("Inserting items...");
+    for(j = 0; j < N_ITEMS; j++) {
+	i = &item_array[j];
+	i->key = bases[rand() % N_BASES] | (unsigned long)(rand() % RND_MAX);
+	i->data = rand() % RND_MAX;
+        if((i2 = art_insert(t, i))) {
+	    j--;  /* Duplicate - try again. */
+	}
+    }
+    check_tree(t);
+    printf("successful.\n");
+
+    /* Test duplicate detection. */
+    printf("\nAttempting insert to give duplicate key...");
+    i2 = &item_array[N_ITEMS/2];
+    duplicate.key = i2->key;  duplicate.data = rand() % RND_MAX;
+    if(art_insert(t, &duplicate) == i2) {
+	printf("duplicate detected.\n");
+    }
+    else {
+	printf("failed - duplicated undected.\n");
+	exit(1);
+    }
+
+    /* Test art_find() */
+    printf("\nTesting art_find() to find an item...");
+    lookup_item.key = item_array[N_ITEMS/2].key;  /* key to lookup. */
+    result = art_find(t, &lookup_item);
+    if(result) {
+	printf("%s\n", result->key == lookup_item.key
+	       ? "successful." : "failed.");
+    }
+    else {
+	printf("failed.\n");
+    }
+
+    /* Test art_find_min() */
+    printf("Testing art_find_min()...");
+    result = art_find_min(t);
+    if(result) printf("%lx.\n", result->key); else printf("failed.\n");
+
+    /* Test art_delete(). */
+    printf("\nTesting art_delete()...");
+    result = art_delete(t, &lookup_item);
+    if(result) {
+	printf("%s\n", result->key == lookup_item.key
+	       ? "successful." : "failed.");
+    }
+    else {
+	printf("failed.\n");
+    }
+    if(art_find(t, &lookup_item)) {
+        printf("deleted item was found.\n");
+        exit(1);
+    }
+
+    /* Test art_delete_min() */
+    printf("Testing art_delete_min()...");
+    result = art_delete_min(t);
+    if(result) printf("%lx.\n", result->key); else printf("failed.\n");
+
+    /* Test art_free(). */
+    printf("Testing art_free()...");
+    art_free(t);
+    printf("successful.\n");
+
+    /* Create a new tree then repeat art_insert()/art_delete(), checking the
+     * tree after each step.
+     */
+    pool = pool_alloc();  /* A shared pool, which nodes are returned to. */
+    t = art_alloc(item_val, KEY_BYTES, pool);
+    printf("\nRepeating art_insert()/art_delete()...");
+    for(j = 0; j < N_ITEMS; j++) {
+	i = &item_array[j];  /* Uniqueness of keys was enforced earlier. */
+        art_insert(t, i);
+    }
+    check_tree(t);
+    for(j = N_ITEMS/2; j < N_ITEMS; j++) {
+	i = &item_array[j];
+	if(art_delete(t, i) != i) { printf("failed.\n"); exit(1); }
+        if(j % 100 == 0) check_tree(t);
+    }
+    check_tree(t);
+    for(j = 0; j < N_ITEMS; j++) {
+	i = &item_array[j];
+	if((art_find(t, i) == i) != (j < N_ITEMS/2)) {
+            printf("failed.\n"); exit(1);
+        }
+    }
+    for(j = N_ITEMS/2; j < N_ITEMS; j++) {
+	i = &item_array[j];
+        art_insert(t, i);
+    }
+    check_tree(t);
+    printf("successful.\n");
+
+    /* Visit the items with a cursor, forwards from the first item, and
+     * backwards from the middle item.
+     */
+    printf("Testing the cursor...");
+    for(j = 0; j < N_ITEMS; j++) sorted[j] = &item_array[j];
+    qsort(sorted, N_ITEMS, sizeof(test_item_t *), item_ptr_cmp);
+    c = art_cursor_alloc(t);
+    result = art_cursor_seek(c, NULL);
+    for(j = 0; j < N_ITEMS; j++) {
+        if(result != sorted[j]) { printf("failed.\n"); exit(1); }
+        result = art_cursor_next(c);
+    }
+    if(result || art_cursor_prev(c) != sorted[N_ITEMS - 2]) {
+        printf("failed.\n"); exit(1);
+    }
+    lookup_item.key = sorted[N_ITEMS/2]->key;
+    result = art_cursor_seek(c, &lookup_item);
+    for(j = N_ITEMS/2; j >= 0; j--) {
+        if(result != sorted[j]) { printf("failed.\n"); exit(1); }
+        result = art_cursor_prev(c);
+    }
+    lookup_item.key = sorted[N_ITEMS - 1]->key + 1;
+    if(result || art_cursor_seek(c, &lookup_item)
+       || art_cursor_prev(c) != sorted[N_ITEMS - 1]) {
+        printf("failed.\n"); exit(1);
+    }
+    art_cursor_free(c);
+    printf("successful.\n");
+
+    /* Empty the tree with art_delete_min(), which must return items in
+     * increasing order of key.
+     */
+    printf("Emptying the tree with art_delete_min()...");
+    for(j = 0; j < N_ITEMS; j++) {
+        if(art_delete_min(t) != sorted[j]) { printf("failed.\n"); exit(1); }
+        if(j % 100 == 0) check_tree(t);
+    }
+    if(art_delete_min(t) || t->root) {
+        printf("failed.\n"); exit(1);
+    }
+    printf("successful.\n");
+    art_free(t);
+
+    pool_free(pool);
+
+    return 0;
+}
@@ -9,37 +9,73 @@
  * and prev pointers.
  */
 
+/* When AVL_RANKS is 1, RESIZE() recomputes the subtree size of node p from
+ * the sizes of its children, after a rotation has changed them.  Otherwise it
+ * does nothing.
+ */
+#if AVL_RANKS
+#define SIZE(p) ((p) ? (p)->size : 0)
+#define RESIZE(p) ((p)->size = SIZE((p)->left) + SIZE((p)->right) + 1)
+#else
+#define RESIZE(p)
+#endif
+
+
+#if AVL_RANKS
+/* avl_add_size() - Adds d to the subtree size of each of the n nodes on the
+ * path stack[].
+ */
+static void avl_add_size(avl_node_t **stack, int n, int d)
+{
+    int i;
+
+    for(i = 0; i < n; i++) stack[i]->size += d;
+}
+#endif
+
 
 /* avl_alloc() - Allocates space for a AVL tree and returns a pointer to it.
  * The function compar compares they keys of two items, and returns a negative,
  * zero, or positive integer depending on whether the first item is less than,
- * equal to, or greater than the second.
+ * equal to, or greater than the second.  Nodes are allocated from the pool
+ * pointed to by pool, which may be shared with other dictionaries, or from a
+ * new pool of the tree's own if pool is NULL.
  */
-avl_t *avl_alloc(int (* compar)(const void *, const void *))
+avl_t *avl_alloc(int (* compar)(const void *, const void *), pool_t *pool)
 {
     avl_t *t;
 
     t = malloc(sizeof(avl_t));
+    t->own_pool = !pool;
+    t->pool = pool ? pool : pool_alloc();
     t->root = NULL;
     t->compar = compar;
     t->stack = malloc(AVL_STACK_SIZE * sizeof(avl_node_t *));
     t->path_info = malloc(AVL_STACK_SIZE * sizeof(signed char));
     t->n = 0;
+    OP_RESET(t->ops);
 
     return t;
 }
 
 
-/* avl_free() - Frees space used by the AVL tree pointed to by t. */
+/* avl_free() - Frees space used by the AVL tree pointed to by t.  The nodes of
+ * a tree with its own pool are freed all at once, by freeing the pool.
+ * Otherwise they are returned to the shared pool.
+ */
 void avl_free(avl_t *t)
 {
     int tos;
     avl_node_t *p, **stack;
 
-    /* In order to free all nodes in the tree a depth first search is performed
-     * This is implemented using a stack.
+    /* The nodes of a tree with its own pool are freed with the pool.
+     * Otherwise, in order to return all nodes to the pool a depth first search
+     * is performed.  This is implemented using a stack.
      */
-    if(t->root) {
+    if(t->own_pool) {
+        pool_free(t->pool);
+    }
+    else if(t->root) {
         stack = t->stack;
 	stack[0] = t->root;
         tos = 1;
@@ -51,7 +87,7 @@ void avl_free(avl_t *t)
 	    if(p->right) {
 		stack[tos++] = p->right;
 	    }
-	    free(p);
+	    pool_put(t->pool, p, sizeof(avl_node_t));
 	}
     }
 
@@ -100,6 +136,7 @@ void *avl_insert(avl_t *t, void *item)
 	 */
         for(;;) {
 	    stack[tos] = p;
+	    OP_COMP(t->ops);
 	    cmp_result = compar(item, p->item);
 	    if(cmp_result < 0) {
 		path_info[tos] = -1;
@@ -134,7 +171,8 @@ void *avl_insert(avl_t *t, void *item)
     return_result = NULL;
     
     /* Allocated space for the new node. */
-    x = malloc(sizeof(avl_node_t));
+    x = pool_get(t->pool, sizeof(avl_node_t));
+    OP_ALLOC(t->ops);
     x->left = x->right = NULL;
     x->balance = 0;
     x->item = item;
@@ -143,7 +181,13 @@ void *avl_insert(avl_t *t, void *item)
      * tree.
      */
     *attach_x = x;
+    OP_LINK(t->ops);
+    OP_DEPTH(t->ops, tos);
     t->n++;
+#if AVL_RANKS
+    x->size = 1;
+    avl_add_size(stack, tos, 1);
+#endif
     	
     /* Now traverse the stack, updating balance information of ancestors,
      * and performing rotation if necessary.
@@ -207,6 +251,11 @@ void *avl_insert(avl_t *t, void *item)
 
 		    p->balance = q->balance = 0;
 
+		    RESIZE(p);
+		    RESIZE(q);
+		    OP_LINKS(t->ops, 3);
+		    OP_RESTRUCT(t->ops);
+
 		    /* A child pointer of p's parent changes from p to q.
 		     * If p was the root, the root node changes.
 		     */
@@ -282,6 +331,12 @@ void *avl_insert(avl_t *t, void *item)
 		    }
 		    r->balance = 0;
 		    
+		    RESIZE(p);
+		    RESIZE(q);
+		    RESIZE(r);
+		    OP_LINKS(t->ops, 5);
+		    OP_RESTRUCT(t->ops);
+
 		    /* A child pointer of p's parent changes from p to r.
 		     * If p was the root, the root node changes.
 		     */
@@ -327,6 +382,7 @@ void *avl_find(avl_t *t, void *key_item)
 	 */
         do {
 	    p = next_p;
+	    OP_COMP(t->ops);
 	    cmp_result = compar(key_item, p->item);
 	    if(cmp_result < 0) {
                 next_p = p->left;
@@ -345,6 +401,69 @@ void *avl_find(avl_t *t, void *key_item)
 }
 
 
+/* avl_find_many() - Finds the items in the AVL tree pointed to by t with the
+ * same keys as the n items pointed to by key_items[], and stores a pointer to
+ * each item found, or NULL, in items[].  The lookups are interleaved in groups
+ * of FIND_MANY_GROUP, with the next node of each prefetched, so that their
+ * cache misses overlap.
+ */
+void avl_find_many(avl_t *t, void **key_items, void **items, int n)
+{
+    int (* compar)(const void *, const void *);
+    int cmp_result;
+    avl_node_t *p[FIND_MANY_GROUP], *q;
+    int key_i[FIND_MANY_GROUP];
+    int i, j, group_n, active;
+
+    compar = t->compar;
+
+    for(i = 0; i < n; i += group_n) {
+	group_n = n - i < FIND_MANY_GROUP ? n - i : FIND_MANY_GROUP;
+	for(j = 0; j < group_n; j++) {
+	    PREFETCH(key_items[i+j]);
+	    p[j] = t->root;
+	    key_i[j] = i + j;
+	    items[i+j] = NULL;
+	}
+
+	/* Lookup j of the active lookups is at node p[j], for key
+	 * key_items[key_i[j]].  Each pass moves every active lookup down one
+	 * level.  The items of the nodes reached are prefetched before any of
+	 * them are compared, and the children moved to are prefetched for the
+	 * next pass.  A finished lookup is replaced by the last active one.
+	 */
+	active = t->root ? group_n : 0;
+	while(active) {
+	    for(j = 0; j < active; j++) PREFETCH(p[j]->item);
+	    for(j = 0; j < active; ) {
+		q = p[j];
+		OP_COMP(t->ops);
+		cmp_result = compar(key_items[key_i[j]], q->item);
+		if(cmp_result < 0) {
+		    q = q->left;
+		}
+		else if(cmp_result > 0) {
+		    q = q->right;
+		}
+		else {
+		    items[key_i[j]] = q->item;  /* Item found. */
+		    q = NULL;
+		}
+		if(q) {
+		    PREFETCH(q);
+		    p[j++] = q;
+		}
+		else {
+		    active--;
+		    p[j] = p[active];
+		    key_i[j] = key_i[active];
+		}
+	    }
+	}
+    }
+}
+
+
 /* avl_find_min() - Returns a pointer to the minimum item in the AVL
  * tree pointed to by t.  If there are no items in the tree a NULL pointer is
  * returned.
@@ -406,6 +525,7 @@ void *avl_delete(avl_t *t, void *key_item)
     
     /* Attempt to locate the item to be deleted. */
     for(;;) {
+	OP_COMP(t->ops);
 	cmp_result = compar(key_item, p->item);
 	if(cmp_result < 0) {
 	    path_info[tos] = -1;
@@ -431,6 +551,7 @@ void *avl_delete(avl_t *t, void *key_item)
     /* p points to the node to be deleted.  Currently, prev_p is on the top of
      * the stack.
      */
+    OP_LINK(t->ops);
     if(!p->left) {
 	/* Right child replaces p. */
 	if(tos == 0) {
@@ -504,13 +625,19 @@ void *avl_delete(avl_t *t, void *key_item)
 	 * p with m.
 	 */
 	m->balance = p->balance;
+#if AVL_RANKS
+	m->size = p->size;
+#endif
 	stack[stack_p] = m;
     }
 
     /* Get return value and free space used by node p. */
     return_item = p->item;
-    free(p);
+    pool_put(t->pool, p, sizeof(avl_node_t));
     t->n--;
+#if AVL_RANKS
+    avl_add_size(stack, tos, -1);
+#endif
 
     /* Perform rotations if necessary to rebalance the tree.  This is done
      * by traversing the stack, updating balance information of ancestors,
@@ -582,6 +709,11 @@ void *avl_delete(avl_t *t, void *key_item)
 			q->right = p;
 		    }
 
+		    RESIZE(p);
+		    RESIZE(q);
+		    OP_LINKS(t->ops, 3);
+		    OP_RESTRUCT(t->ops);
+
 		    /* A child pointer of p's parent changes from p to q.
 		     * If p was the root, the root node changes.
 		     */
@@ -667,6 +799,12 @@ void *avl_delete(avl_t *t, void *key_item)
 		    }
 		    r->balance = 0;
 		    
+		    RESIZE(p);
+		    RESIZE(q);
+		    RESIZE(r);
+		    OP_LINKS(t->ops, 5);
+		    OP_RESTRUCT(t->ops);
+
 		    /* A child pointer of p's parent changes from p to r.
 		     * If p was the root, the root node changes.
 		     */
@@ -734,6 +872,7 @@ void *avl_delete_min(avl_t *t)
     }
 
     /* Right child of p replaces p. */
+    OP_LINK(t->ops);
     if(tos == 0) {
         t->root = p->right;
     }
@@ -744,8 +883,11 @@ void *avl_delete_min(avl_t *t)
 
     /* Get return value and free space used by node p. */
     return_item = p->item;
-    free(p);
+    pool_put(t->pool, p, sizeof(avl_node_t));
     t->n--;
+#if AVL_RANKS
+    avl_add_size(stack, tos, -1);
+#endif
   
     /* Perform rotations if necessary to rebalance the tree.  This is done
      * by traversing the stack, updating balance information of ancestors,
@@ -801,6 +943,11 @@ void *avl_delete_min(avl_t *t)
 		    p->right = q->left;
 		    q->left = p;
 
+		    RESIZE(p);
+		    RESIZE(q);
+		    OP_LINKS(t->ops, 3);
+		    OP_RESTRUCT(t->ops);
+
 		    /* A child pointer of p's parent changes from p to q.
 		     * If p was the root, the root node changes.
 		     */
@@ -860,6 +1007,12 @@ void *avl_delete_min(avl_t *t)
 		    }
 		    r->balance = 0;
 		    
+		    RESIZE(p);
+		    RESIZE(q);
+		    RESIZE(r);
+		    OP_LINKS(t->ops, 5);
+		    OP_RESTRUCT(t->ops);
+
 		    /* A child pointer of p's parent changes from p to r.
 		     * If p was the root, the root node changes.
 		     */
@@ -883,13 +1036,265 @@ void *avl_delete_min(avl_t *t)
 }
 
 
+/* avl_build() - Builds a perfectly balanced subtree from the n items in the
+ * array items[], and returns its root.  The height of the subtree is stored
+ * in *height.
+ */
+avl_node_t *avl_build(avl_t *t, void **items, int n, int *height)
+{
+    avl_node_t *p;
+    int mid, left_height, right_height;
+
+    if(n == 0) {
+        *height = 0;
+        return NULL;
+    }
+
+    mid = n / 2;
+    p = pool_get(t->pool, sizeof(avl_node_t));
+    OP_ALLOC(t->ops);
+    p->item = items[mid];
+    p->left = avl_build(t, items, mid, &left_height);
+    p->right = avl_build(t, items + mid + 1, n - mid - 1, &right_height);
+    p->balance = right_height - left_height;
+#if AVL_RANKS
+    p->size = n;
+#endif
+    OP_LINK(t->ops);
+    *height = 1 + (left_height > right_height ? left_height : right_height);
+
+    return p;
+}
+
+
+/* avl_bulk_load() - Builds the AVL tree pointed to by t from the n items in
+ * the array items[], which must be in increasing order of key with no two keys
+ * equal.  An empty tree is built perfectly balanced, in O(n) time.  If the AVL
+ * tree is not empty, the items are inserted one at a time instead.
+ */
+void avl_bulk_load(avl_t *t, void **items, int n)
+{
+    int i, height;
+
+    if(t->n > 0) {
+        for(i = 0; i < n; i++) avl_insert(t, items[i]);
+        return;
+    }
+
+    t->root = avl_build(t, items, n, &height);
+    t->n = n;
+}
+
+
+#if AVL_RANKS
+/* avl_select() - Returns a pointer to the item of rank k in the AVL tree
+ * pointed to by t, which is the item with k items of smaller key in the tree,
+ * for k from 0 to n-1.  Returns NULL if there is no such item.  Takes O(log n)
+ * time.  Only provided when AVL_RANKS is 1.
+ */
+void *avl_select(avl_t *t, int k)
+{
+    avl_node_t *p;
+    int left_size;
+
+    if(k < 0 || k >= t->n) return NULL;
+
+    /* Descend from the root, skipping the left subtree and node p whenever
+     * there are no more than k items in them.
+     */
+    p = t->root;
+    for(;;) {
+        left_size = SIZE(p->left);
+        if(k < left_size) {
+            p = p->left;
+        }
+        else if(k > left_size) {
+            k -= left_size + 1;
+            p = p->right;
+        }
+        else {
+            return p->item;
+        }
+    }
+}
+
+
+/* avl_rank() - Returns the number of items in the AVL tree pointed to by t
+ * with a key less than that of the item pointed to by `key_item', which need
+ * not be in the tree.  Takes O(log n) time.  Only provided when AVL_RANKS is
+ * 1.
+ */
+int avl_rank(avl_t *t, void *key_item)
+{
+    int (* compar)(const void *, const void *);
+    int cmp_result, rank;
+    avl_node_t *p;
+
+    compar = t->compar;
+    rank = 0;
+
+    /* Each time the right branch is taken, the left subtree and node p have
+     * keys less than that of key_item.
+     */
+    p = t->root;
+    while(p) {
+        OP_COMP(t->ops);
+        cmp_result = compar(key_item, p->item);
+        if(cmp_result < 0) {
+            p = p->left;
+        }
+        else if(cmp_result > 0) {
+            rank += SIZE(p->left) + 1;
+            p = p->right;
+        }
+        else {
+            return rank + SIZE(p->left);
+        }
+    }
+
+    return rank;
+}
+#endif
+
+
+/* avl_cursor_alloc() - Returns a new cursor on the AVL tree pointed to by
+ * t.  The cursor must be positioned by avl_cursor_seek() before use, and
+ * again whenever the tree has been changed.
+ */
+avl_cursor_t *avl_cursor_alloc(avl_t *t)
+{
+    avl_cursor_t *c;
+
+    c = malloc(sizeof(avl_cursor_t));
+    c->t = t;
+    c->stack = malloc(AVL_STACK_SIZE * sizeof(avl_node_t *));
+    c->tos = 0;
+
+    return c;
+}
+
+
+/* avl_cursor_free() - Frees space used by the cursor pointed to by c. */
+void avl_cursor_free(avl_cursor_t *c)
+{
+    free(c->stack);
+    free(c);
+}
+
+
+/* avl_cursor_seek() - Moves the cursor pointed to by c to the first item
+ * with a key not less than that of the item pointed to by `key_item', or to
+ * the first item if key_item is NULL, and returns it.  If there is no such
+ * item, the cursor is moved past the last item and NULL is returned.
+ */
+void *avl_cursor_seek(avl_cursor_t *c, void *key_item)
+{
+    avl_t *t;
+    avl_node_t *p, **stack;
+    int cmp_result, tos;
+
+    t = c->t;
+    stack = c->stack;
+    tos = 0;
+    c->tos = 0;
+
+    /* The path to the last node at which the search went left, or stopped,
+     * is the path to the item sought.
+     */
+    for(p = t->root; p; ) {
+	stack[tos++] = p;
+	if(key_item) {
+	    OP_COMP(t->ops);
+	    cmp_result = t->compar(key_item, p->item);
+	}
+	else {
+	    cmp_result = -1;
+	}
+	if(cmp_result <= 0) {
+	    c->tos = tos;
+	    if(cmp_result == 0) break;
+	    p = p->left;
+	}
+	else {
+	    p = p->right;
+	}
+    }
+
+    return c->tos ? stack[c->tos - 1]->item : NULL;
+}
+
+
+/* avl_cursor_next() - Moves the cursor pointed to by c to the next item and
+ * returns it.  If there is no next item, NULL is returned and the cursor is
+ * not moved.
+ */
+void *avl_cursor_next(avl_cursor_t *c)
+{
+    avl_node_t *p, **stack;
+    int tos;
+
+    stack = c->stack;
+    tos = c->tos;
+    if(!tos) return NULL;
+
+    /* The next item is the minimum of the right subtree, if there is one. */
+    p = stack[tos-1]->right;
+    if(p) {
+	for(; p; p = p->left) stack[tos++] = p;
+	c->tos = tos;
+	return stack[tos-1]->item;
+    }
+
+    /* Otherwise it is the nearest ancestor whose left subtree holds the
+     * current node.
+     */
+    while(tos > 1 && stack[tos-2]->right == stack[tos-1]) tos--;
+    if(tos == 1) return NULL;
+    c->tos = tos - 1;
+    return stack[tos-2]->item;
+}
+
+
+/* avl_cursor_prev() - Moves the cursor pointed to by c to the previous
+ * item, or to the last item if it is past the last item, and returns it.  If
+ * there is no such item, NULL is returned and the cursor is not moved.
+ */
+void *avl_cursor_prev(avl_cursor_t *c)
+{
+    avl_node_t *p, **stack;
+    int tos;
+
+    stack = c->stack;
+    tos = c->tos;
+    p = tos ? stack[tos-1]->left : c->t->root;
+
+    /* The previous item is the maximum of the left subtree, if there is one.
+     * From past the last item, it is the maximum of the whole tree.
+     */
+    if(p) {
+	for(; p; p = p->right) stack[tos++] = p;
+	c->tos = tos;
+	return stack[tos-1]->item;
+    }
+    if(!tos) return NULL;
+
+    /* Otherwise it is the nearest ancestor whose right subtree holds the
+     * current node.
+     */
+    while(tos > 1 && stack[tos-2]->left == stack[tos-1]) tos--;
+    if(tos == 1) return NULL;
+    c->tos = tos - 1;
+    return stack[tos-2]->item;
+}
+
+
 /*** Implement the universal dictionary structure type ***/
 
 /*** AVL tree wrapper functions. ***/
 
 void *_avl_alloc(int (* compar)(const void *, const void *),
 		 unsigned int (* getval)(const void *)) {
-    return avl_alloc(compar);
+    return avl_alloc(compar, NULL);
 }
 
 void _avl_free(void *t) {
@@ -912,10 +1317,42 @@ void *_avl_find(void *t, void *key_item) {
     return avl_find((avl_t *)t, key_item);
 }
 
+void _avl_find_many(void *t, void **key_items, void **items, int n) {
+    avl_find_many((avl_t *)t, key_items, items, n);
+}
+
 void *_avl_find_min(void *t) {
     return avl_find_min((avl_t *)t);
 }
 
+const opcount_t *_avl_counts(void *t) {
+    return &((avl_t *)t)->ops;
+}
+
+void *_avl_cursor_alloc(void *t) {
+    return avl_cursor_alloc((avl_t *)t);
+}
+
+void _avl_cursor_free(void *c) {
+    avl_cursor_free((avl_cursor_t *)c);
+}
+
+void *_avl_cursor_seek(void *c, void *key_item) {
+    return avl_cursor_seek((avl_cursor_t *)c, key_item);
+}
+
+void *_avl_cursor_next(void *c) {
+    return avl_cursor_next((avl_cursor_t *)c);
+}
+
+void *_avl_cursor_prev(void *c) {
+    return avl_cursor_prev((avl_cursor_t *)c);
+}
+
+void _avl_bulk_load(void *t, void **items, int n) {
+    avl_bulk_load((avl_t *)t, items, n);
+}
+
 /* AVL tree info. */
 const dict_info_t AVL_info = {
     _avl_alloc,
@@ -924,5 +1361,13 @@ const dict_info_t AVL_info = {
     _avl_delete,
     _avl_delete_min,
     _avl_find,
-    _avl_find_min
+    _avl_find_min,
+    _avl_counts,
+    _avl_cursor_alloc,
+    _avl_cursor_free,
+    _avl_cursor_seek,
+    _avl_cursor_next,
+    _avl_cursor_prev,
+    _avl_bulk_load,
+    _avl_find_many
 };
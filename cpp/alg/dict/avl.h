@@ -5,6 +5,7 @@
 #ifndef AVL_H
 #define AVL_H
 #include "dict_info.h"  /* Defines the universal dictionary structure type. */
+#include "pool.h"
 
 
 /* Size of the stack used for storing path travesersed through the tree.
@@ -13,33 +14,67 @@
  */
 #define AVL_STACK_SIZE 1000
 
+/* Use 1 to keep the number of items in each subtree, which avl_select() and
+ * avl_rank() need, or 0 for the plain AVL tree without the cost of keeping
+ * the counts.  This can also be set when compiling, using -DAVL_RANKS=1.
+ */
+#ifndef AVL_RANKS
+#define AVL_RANKS 0
+#endif
 
-/* Structure type for nodes in the AVL tree. */
+
+/* Structure type for nodes in the AVL tree.  When AVL_RANKS is 1, size is the
+ * number of items in the subtree rooted at the node.
+ */
 typedef struct avl_node {
     void *item;
     struct avl_node *left, *right;
     signed char balance;
+#if AVL_RANKS
+    int size;
+#endif
 } avl_node_t;
 
-/* Structure type for the AVL tree. */
+/* Structure type for the AVL tree.  ops counts the operations performed on the
+ * tree, for experimental purposes.  Nodes are allocated from pool, which is
+ * the tree's own pool if own_pool is 1.
+ */
 typedef struct avl {
     avl_node_t *root;
     int n;
     int (* compar)(const void *, const void *);
     avl_node_t **stack;
     signed char *path_info;
+    pool_t *pool;
+    int own_pool;
+    opcount_t ops;
 } avl_t;
 
+/* Structure type for a cursor on the AVL tree.  stack[0..tos-1] holds the
+ * path from the root to the node of the current item, and tos is 0 when the
+ * cursor is past the last item.
+ */
+typedef struct avl_cursor {
+    avl_t *t;
+    avl_node_t **stack;
+    int tos;
+} avl_cursor_t;
+
 
 
 /* avl_alloc() - Allocates space for a AVL tree and returns a pointer to it.
  * The function compar compares they keys of two items, and returns a negative,
  * zero, or positive integer depending on whether the first item is less than,
- * equal to, or greater than the second.
+ * equal to, or greater than the second.  Nodes are allocated from the pool
+ * pointed to by pool, which may be shared with other dictionaries, or from a
+ * new pool of the tree's own if pool is NULL.
  */
-avl_t *avl_alloc(int (* compar)(const void *, const void *));
+avl_t *avl_alloc(int (* compar)(const void *, const void *), pool_t *pool);
 
-/* avl_free() - Frees space used by the AVL tree pointed to by t. */
+/* avl_free() - Frees space used by the AVL tree pointed to by t.  The nodes of
+ * a tree with its own pool are freed all at once, by freeing the pool.
+ * Otherwise they are returned to the shared pool.
+ */
 void avl_free(avl_t *t);
 
 /* avl_insert() - Inserts an item into the AVL tree pointed to by t,
@@ -56,6 +91,14 @@ void *avl_insert(avl_t *t, void *item);
  */
 void *avl_find(avl_t *t, void *key_item);
 
+/* avl_find_many() - Finds the items in the AVL tree pointed to by t with the
+ * same keys as the n items pointed to by key_items[], and stores a pointer to
+ * each item found, or NULL, in items[].  The lookups are interleaved in groups
+ * of FIND_MANY_GROUP, with the next node of each prefetched, so that their
+ * cache misses overlap.
+ */
+void avl_find_many(avl_t *t, void **key_items, void **items, int n);
+
 /* avl_find_min() - Returns a pointer to the minimum item in the AVL
  * tree pointed to by t.  If there are no items in the tree a NULL pointer is
  * returned.
@@ -74,6 +117,57 @@ void *avl_delete(avl_t *t, void *key_item);
  */
 void *avl_delete_min(avl_t *t);
 
+/* avl_bulk_load() - Builds the AVL tree pointed to by t from the n items in
+ * the array items[], which must be in increasing order of key with no two keys
+ * equal.  An empty tree is built perfectly balanced, in O(n) time.  If the AVL
+ * tree is not empty, the items are inserted one at a time instead.
+ */
+void avl_bulk_load(avl_t *t, void **items, int n);
+
+#if AVL_RANKS
+/* avl_select() - Returns a pointer to the item of rank k in the AVL tree
+ * pointed to by t, which is the item with k items of smaller key in the tree,
+ * for k from 0 to n-1.  Returns NULL if there is no such item.  Takes O(log n)
+ * time.  Only provided when AVL_RANKS is 1.
+ */
+void *avl_select(avl_t *t, int k);
+
+/* avl_rank() - Returns the number of items in the AVL tree pointed to by t
+ * with a key less than that of the item pointed to by `key_item', which need
+ * not be in the tree.  Takes O(log n) time.  Only provided when AVL_RANKS is
+ * 1.
+ */
+int avl_rank(avl_t *t, void *key_item);
+#endif
+
+/* avl_cursor_alloc() - Returns a new cursor on the AVL tree pointed to by
+ * t.  The cursor must be positioned by avl_cursor_seek() before use, and
+ * again whenever the tree has been changed.
+ */
+avl_cursor_t *avl_cursor_alloc(avl_t *t);
+
+/* avl_cursor_free() - Frees space used by the cursor pointed to by c. */
+void avl_cursor_free(avl_cursor_t *c);
+
+/* avl_cursor_seek() - Moves the cursor pointed to by c to the first item
+ * with a key not less than that of the item pointed to by `key_item', or to
+ * the first item if key_item is NULL, and returns it.  If there is no such
+ * item, the cursor is moved past the last item and NULL is returned.
+ */
+void *avl_cursor_seek(avl_cursor_t *c, void *key_item);
+
+/* avl_cursor_next() - Moves the cursor pointed to by c to the next item and
+ * returns it.  If there is no next item, NULL is returned and the cursor is
+ * not moved.
+ */
+void *avl_cursor_next(avl_cursor_t *c);
+
+/* avl_cursor_prev() - Moves the cursor pointed to by c to the previous
+ * item, or to the last item if it is past the last item, and returns it.  If
+ * there is no such item, NULL is returned and the cursor is not moved.
+ */
+void *avl_cursor_prev(avl_cursor_t *c);
+
 /*** Alternative interface via the universal dictionary structure type. ***/
 extern const dict_info_t AVL_info;
 
@@ -100,17 +100,78 @@ int item_cmp(const void *item1, const void *item2)
 }
 
 
+/* Compares the items pointed to by two elements of an array of item pointers,
+ * for sorting the array with qsort().
+ */
+int item_ptr_cmp(const void *p1, const void *p2)
+{
+    return item_cmp(*(test_item_t **)p1, *(test_item_t **)p2);
+}
+
+
+/* The rank and select tests are only built into avl_rank_test, which is
+ * compiled with -DAVL_RANKS=1.
+ */
+#if AVL_RANKS
+
+/* Returns the number of items in the subtree rooted at p, after checking the
+ * size held in each node of the subtree.
+ */
+int avl_size_r(avl_node_t *p)
+{
+    int size;
+
+    if(!p) return 0;
+    size = avl_size_r(p->left) + avl_size_r(p->right) + 1;
+    if(p->size != size) {
+	printf("failed - size %d at key %d.\n", p->size,
+	       ((test_item_t *)p->item)->data1);
+	exit(1);
+    }
+    return size;
+}
+
+
+/* Checks avl_select() and avl_rank() against the n items of items[], which
+ * are the items in the AVL tree in increasing order of key.
+ */
+void check_ranks(avl_t *t, test_item_t **items, int n)
+{
+    int k;
+
+    if(avl_size_r(t->root) != n) { printf("failed.\n"); exit(1); }
+    for(k = 0; k < n; k++) {
+	if(avl_select(t, k) != items[k] || avl_rank(t, items[k]) != k) {
+	    printf("failed - rank %d.\n", k);
+	    exit(1);
+	}
+    }
+    if(avl_select(t, -1) || avl_select(t, n)) {
+	printf("failed.\n");
+	exit(1);
+    }
+}
+#endif
+
+
 int main(void)
 {
     avl_t *t;
+    pool_t *pool;
     test_item_t item_array[N_ITEMS], *i, *i2, duplicate, lookup_item;
-    test_item_t *result;
+    test_item_t keys[N_ITEMS];
+    void *key_ptrs[N_ITEMS], *found[N_ITEMS];
+    test_item_t *result, *sorted[N_ITEMS];
     int j;
+#if AVL_RANKS
+    test_item_t *rest[N_ITEMS];
+    int n_rest;
+#endif
 
     exit_flag = 0;  /* For debugging. */
 
     /* Create an AVL search tree. */
-    t = avl_alloc(item_cmp);
+    t = avl_alloc(item_cmp, NULL);
     
     /* Add some items to it. */    
     printf("Inserting items:\n");
@@ -153,6 +214,23 @@ int main(void)
 	printf("failed.\n");
     }
 
+    /* Test avl_find_many() against avl_find(), with every second key
+     * changed so that it may not be in the tree.
+     */
+    printf("Testing avl_find_many()...");
+    for(j = 0; j < N_ITEMS; j++) {
+	keys[j].data1 = item_array[j].data1 + j % 2;
+	key_ptrs[j] = &keys[j];
+    }
+    avl_find_many(t, key_ptrs, found, N_ITEMS);
+    for(j = 0; j < N_ITEMS; j++) {
+	if(found[j] != avl_find(t, key_ptrs[j])) {
+	    printf("failed.\n");
+	    exit(1);
+	}
+    }
+    printf("successful.\n");
+
     /* Test avl_find_min() */
     printf("Testing avl_find_min()...");
     result = avl_find_min(t);
@@ -181,7 +259,8 @@ int main(void)
     printf("successful.\n");
     
     /* Create a new tree then repeat avl_insert()/avl_delete(). */
-    t = avl_alloc(item_cmp);
+    pool = pool_alloc();  /* A shared pool, which nodes are returned to. */
+    t = avl_alloc(item_cmp, pool);
     printf("\nRepeating avl_insert()/avl_delete()...");
     for(j = 0; j < N_ITEMS; j++) {
 	i = &item_array[j];  /* Uniqueness of keys was enforced earlier. */
@@ -229,5 +308,75 @@ int main(void)
     }
     avl_free(t);
     
+    /* Test avl_bulk_load() with the items in increasing order of key, then
+     * check that the result can be updated.
+     */
+    printf("\nTesting avl_bulk_load()...");
+    for(j = 0; j < N_ITEMS; j++) sorted[j] = &item_array[j];
+    qsort(sorted, N_ITEMS, sizeof(test_item_t *), item_ptr_cmp);
+    t = avl_alloc(item_cmp, NULL);
+    avl_bulk_load(t, (void **)sorted, N_ITEMS);
+    avl_dump_r(t->root, 0);
+    for(j = 0; j < N_ITEMS; j++) {
+	i = &item_array[j];
+	if(avl_find(t, i) != i) { printf("failed.\n"); exit(1); }
+    }
+    for(j = 0; j < N_ITEMS/2; j++) {
+	i = &item_array[j];
+	if(avl_delete(t, i) != i) { printf("failed.\n"); exit(1); }
+    }
+    avl_dump_r(t->root, 0);
+    for(j = 0; j < N_ITEMS/2; j++) {
+	i = &item_array[j];
+	avl_insert(t, i);
+    }
+    avl_dump_r(t->root, 0);
+    for(j = 0; j < N_ITEMS; j++) {
+	if(avl_delete_min(t) != sorted[j]) { printf("failed.\n"); exit(1); }
+    }
+    avl_free(t);
+    printf("successful.\n");
+
+#if AVL_RANKS
+    /* Test avl_select() and avl_rank() after inserting items in random order,
+     * after deleting every second item, and after deleting minimums, and on a
+     * tree from avl_bulk_load().  Deleted keys are looked up by avl_rank()
+     * as keys which are not in the tree.
+     */
+    printf("\nTesting avl_select() and avl_rank()...");
+    t = avl_alloc(item_cmp, pool);
+    for(j = 0; j < N_ITEMS; j++) avl_insert(t, &item_array[j]);
+    check_ranks(t, sorted, N_ITEMS);
+    n_rest = 0;
+    for(j = 0; j < N_ITEMS; j++) {
+	if(j % 2) {
+	    if(avl_delete(t, sorted[j]) != sorted[j]) {
+		printf("failed.\n");
+		exit(1);
+	    }
+	}
+	else {
+	    rest[n_rest++] = sorted[j];
+	}
+    }
+    check_ranks(t, rest, n_rest);
+    for(j = 1; j < N_ITEMS; j += 2) {
+	if(avl_rank(t, sorted[j]) != (j + 1) / 2) {
+	    printf("failed.\n");
+	    exit(1);
+	}
+    }
+    for(j = 0; j < n_rest / 2; j++) avl_delete_min(t);
+    check_ranks(t, rest + j, n_rest - j);
+    avl_free(t);
+    t = avl_alloc(item_cmp, pool);
+    avl_bulk_load(t, (void **)sorted, N_ITEMS);
+    check_ranks(t, sorted, N_ITEMS);
+    avl_free(t);
+    printf("successful.\n");
+#endif
+
+    pool_free(pool);
+
     return 0;
 }
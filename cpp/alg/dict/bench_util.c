@@ -0,0 +1,149 @@
+/*** File bench_util.c - Helpers Shared by the Test and Benchmark Programs ***/
+#include <stdlib.h>
+#include <time.h>
+#include <sys/time.h>
+#include "bench_util.h"
+
+
+
+/*** Prototypes of functions only visible within this file. ***/
+
+void *bench_worker(void *p);
+
+
+
+/*** Definitions of functions visible outside of this file. ***/
+
+/* wall_msec() - Returns the current wall clock time in milliseconds. */
+double wall_msec(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
+}
+
+
+/* now_nsec() - Returns the current monotonic time in nanoseconds. */
+double now_nsec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+
+/* next_rand() - Returns the next value of the xorshift random number
+ * generator with state pointed to by s, which must not be zero.
+ */
+unsigned long next_rand(unsigned long *s)
+{
+    *s ^= *s << 13;
+    *s ^= *s >> 7;
+    *s ^= *s << 17;
+    return *s;
+}
+
+
+/* hash_mix() - Returns x with its bits mixed by the 64-bit finaliser of
+ * MurmurHash3, for hashing integer keys.
+ */
+unsigned long hash_mix(unsigned long x)
+{
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdUL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53UL;
+    x ^= x >> 33;
+    return x;
+}
+
+
+/* bench_threads() - Runs the function fn in n_threads threads at once, each
+ * passed a pointer to its own bench_thread_t, with shared set to shared, and
+ * waits for them to finish.  Returns the total of the threads' errors.
+ */
+int bench_threads(int n_threads, void *(* fn)(void *), void *shared)
+{
+    pthread_t *threads;
+    bench_thread_t *args;
+    int i, errors;
+
+    threads = malloc(n_threads * sizeof(pthread_t));
+    args = malloc(n_threads * sizeof(bench_thread_t));
+
+    for(i = 0; i < n_threads; i++) {
+        args[i].shared = shared;
+        args[i].seed = BENCH_SEED + i * BENCH_SEED_STEP;
+        args[i].found = 0;
+        args[i].id = i;
+        args[i].errors = 0;
+        pthread_create(&threads[i], NULL, fn, &args[i]);
+    }
+    errors = 0;
+    for(i = 0; i < n_threads; i++) {
+        pthread_join(threads[i], NULL);
+        errors += args[i].errors;
+    }
+
+    free(threads);
+    free(args);
+
+    return errors;
+}
+
+
+/* bench_run() - Performs a throughput run, described by b, with n_threads
+ * threads, and returns the throughput in millions of operations per second.
+ */
+double bench_run(bench_t *b, int n_threads)
+{
+    double start, elapsed;
+
+    pthread_mutex_init(&b->lock, NULL);
+    start = wall_msec();
+    bench_threads(n_threads, bench_worker, b);
+    elapsed = wall_msec() - start;
+    pthread_mutex_destroy(&b->lock);
+
+    return n_threads * b->n_ops / elapsed / 1000.0;
+}
+
+
+
+/*** Definitions of functions only visible within this file. ***/
+
+/* bench_worker() - Performs the n_ops random operations of one thread of the
+ * throughput run pointed to by the thread's shared pointer.
+ */
+void *bench_worker(void *p)
+{
+    bench_thread_t *arg;
+    bench_t *b;
+    void *item;
+    long i;
+    unsigned long r;
+    int insert;
+
+    arg = p;
+    b = arg->shared;
+    insert = 1;
+    for(i = 0; i < b->n_ops; i++) {
+        r = next_rand(&arg->seed);
+        item = b->items + ((r >> 8) & (b->n_keys - 1)) * b->item_size;
+        if(b->locked) pthread_mutex_lock(&b->lock);
+        if((int)(r % 100) < b->read_pct) {
+            if(b->fns->find(b->t, item)) arg->found++;
+        }
+        else {
+            if(insert) b->fns->insert(b->t, item);
+            else b->fns->delete(b->t, item);
+            insert = !insert;
+        }
+        if(b->locked) pthread_mutex_unlock(&b->lock);
+    }
+
+    if(b->fns->thread_exit) b->fns->thread_exit();
+    return NULL;
+}
@@ -0,0 +1,110 @@
+/*** File bench_util.h - Helpers Shared by the Test and Benchmark Programs ***/
+#ifndef BENCH_UTIL_H
+#define BENCH_UTIL_H
+
+#include <pthread.h>
+
+/* Clocks, a random number generator and a hash function used by the test and
+ * benchmark programs, and the threaded throughput run of the tests of the
+ * concurrent dictionaries.
+ *
+ * A throughput run, bench_run(), has a number of threads perform random
+ * operations on the keys of an array of items, with the dictionary initially
+ * holding every second key.  A given percentage of operations are finds, and
+ * the rest are writes, which alternate between inserts and deletes so that
+ * the dictionary stays about half full.  The dictionary is used either
+ * directly, or through a single mutex which every operation holds.
+ * Throughput is reported in millions of operations per second of elapsed
+ * (wall clock) time.
+ */
+
+
+/* The seed of the random number generator of thread 0.  Thread i is seeded
+ * with BENCH_SEED + i * BENCH_SEED_STEP.
+ */
+#define BENCH_SEED 88172645463325252UL
+#define BENCH_SEED_STEP 0x9e3779b97f4a7c15UL
+
+
+
+/*** Structure Type Definitions. ***/
+
+/* The operations of a dictionary under test.  Each takes the dictionary and
+ * an item.  thread_exit, if not NULL, is called by each thread before it
+ * exits, for dictionaries which reclaim memory by epochs.
+ */
+typedef struct bench_fns {
+    void *(* find)(void *t, void *key_item);
+    void *(* insert)(void *t, void *item);
+    void *(* delete)(void *t, void *key_item);
+    void (* thread_exit)(void);
+} bench_fns_t;
+
+/* A throughput run:
+ *     fns, t - the dictionary and its operations.
+ *     locked - 1 if every operation holds lock, or 0 otherwise.
+ *     items - the items, of item_size bytes each.  Item k has key k.
+ *     n_keys - the number of items, a power of two.
+ *     read_pct - the percentage of operations that are finds.
+ *     n_ops - the number of operations per thread.
+ */
+typedef struct bench {
+    const bench_fns_t *fns;
+    void *t;
+    int locked;
+    pthread_mutex_t lock;
+    char *items;
+    int item_size;
+    int n_keys;
+    int read_pct;
+    long n_ops;
+} bench_t;
+
+/* The state of a thread started by bench_threads():
+ *     shared - the pointer given to bench_threads().
+ *     seed - the state of the thread's random number generator.
+ *     found - the number of finds that succeeded, which stops the finds being
+ *             optimised away.
+ *     id - the thread's number, from 0.
+ *     errors - the number of errors the thread found.
+ */
+typedef struct bench_thread {
+    void *shared;
+    unsigned long seed;
+    long found;
+    int id;
+    int errors;
+} bench_thread_t;
+
+
+
+/*** Function prototypes. ***/
+
+/* wall_msec() - Returns the current wall clock time in milliseconds. */
+double wall_msec(void);
+
+/* now_nsec() - Returns the current monotonic time in nanoseconds. */
+double now_nsec(void);
+
+/* next_rand() - Returns the next value of the xorshift random number
+ * generator with state pointed to by s, which must not be zero.
+ */
+unsigned long next_rand(unsigned long *s);
+
+/* hash_mix() - Returns x with its bits mixed by the 64-bit finaliser of
+ * MurmurHash3, for hashing integer keys.
+ */
+unsigned long hash_mix(unsigned long x);
+
+/* bench_threads() - Runs the function fn in n_threads threads at once, each
+ * passed a pointer to its own bench_thread_t, with shared set to shared, and
+ * waits for them to finish.  Returns the total of the threads' errors.
+ */
+int bench_threads(int n_threads, void *(* fn)(void *), void *shared);
+
+/* bench_run() - Performs a throughput run, described by b, with n_threads
+ * threads, and returns the throughput in millions of operations per second.
+ */
+double bench_run(bench_t *b, int n_threads);
+
+#endif
@@ -0,0 +1,815 @@
+/*** File bptree.c - B+ Tree ***/
+#include <stdlib.h>
+#include "bptree.h"
+
+
+/* The minimum number of keys in an internal node, and items in a leaf, other
+ * than the root.
+ */
+#define NODE_MIN (BPTREE_ORDER/2 - 1)
+#define LEAF_MIN (BPTREE_LEAF_SIZE/2)
+
+
+
+/* Prototypes for functions only visible within this file. */
+bptree_leaf_t *bptree_leaf_alloc(bptree_t *t);
+bptree_node_t *bptree_node_alloc(bptree_t *t);
+void bptree_free_subtree(bptree_t *t, void *p, int height);
+int bptree_upper(bptree_t *t, const unsigned int *key, int n, unsigned int k);
+int bptree_lower(bptree_t *t, const unsigned int *key, int n, unsigned int k);
+bptree_leaf_t *bptree_search(bptree_t *t, unsigned int k);
+void bptree_insert_up(bptree_t *t, unsigned int sep, void *right);
+void bptree_remove_entry(bptree_node_t *p, int i);
+void bptree_fix_leaf(bptree_t *t, bptree_leaf_t *leaf);
+void bptree_fix_nodes(bptree_t *t);
+
+
+
+/* bptree_alloc() - Allocates space for a B+ tree and returns a pointer to it.
+ * The function get_value() returns the key value for a data item.  Nodes and
+ * leaves are allocated from the pool pointed to by pool, which may be shared
+ * with other dictionaries, or from a new pool of the tree's own if pool is
+ * NULL.
+ */
+bptree_t *bptree_alloc(unsigned int (* get_value)(const void *), pool_t *pool)
+{
+    bptree_t *t;
+
+    t = malloc(sizeof(bptree_t));
+    t->own_pool = !pool;
+    t->pool = pool ? pool : pool_alloc();
+    OP_RESET(t->ops);
+    t->first = bptree_leaf_alloc(t);
+    t->root = t->first;
+    t->height = 0;
+    t->n = 0;
+    t->get_value = get_value;
+
+    return t;
+}
+
+
+/* bptree_free() - Frees space used by the B+ tree pointed to by t.  The nodes
+ * and leaves of a tree with its own pool are freed all at once, by freeing the
+ * pool.  Otherwise they are returned to the shared pool.
+ */
+void bptree_free(bptree_t *t)
+{
+    if(t->own_pool) {
+        pool_free(t->pool);
+    }
+    else {
+        bptree_free_subtree(t, t->root, t->height);
+    }
+    free(t);
+}
+
+
+/* bptree_insert() - Inserts an item into the B+ tree pointed to by t,
+ * according to the value of its key.  The key of an item in the B+ tree must
+ * be unique among items in the tree.  If an item with the same key already
+ * exists in the tree, a pointer to that item is returned.  Otherwise, NULL is
+ * returned, indicating insertion was successful.
+ */
+void *bptree_insert(bptree_t *t, void *item)
+{
+    bptree_leaf_t *leaf, *right;
+    unsigned int k;
+    int i, j, half;
+
+    k = t->get_value(item);
+    leaf = bptree_search(t, k);
+    i = bptree_lower(t, leaf->key, leaf->n, k);
+    if(i < leaf->n && leaf->key[i] == k) return leaf->item[i];
+    OP_DEPTH(t->ops, t->height + 1);
+
+    /* A full leaf is split in two, and the item is inserted into the half
+     * where it belongs.
+     */
+    if(leaf->n == BPTREE_LEAF_SIZE) {
+        right = bptree_leaf_alloc(t);
+        half = BPTREE_LEAF_SIZE / 2;
+        for(j = half; j < BPTREE_LEAF_SIZE; j++) {
+            right->key[j - half] = leaf->key[j];
+            right->item[j - half] = leaf->item[j];
+        }
+        right->n = BPTREE_LEAF_SIZE - half;
+        leaf->n = half;
+        right->next = leaf->next;
+        right->prev = leaf;
+        if(right->next) right->next->prev = right;
+        leaf->next = right;
+        OP_RESTRUCT(t->ops);
+
+        bptree_insert_up(t, right->key[0], right);
+        if(i > half) {
+            leaf = right;
+            i -= half;
+        }
+    }
+
+    for(j = leaf->n; j > i; j--) {
+        leaf->key[j] = leaf->key[j-1];
+        leaf->item[j] = leaf->item[j-1];
+    }
+    leaf->key[i] = k;
+    leaf->item[i] = item;
+    leaf->n++;
+    OP_LINK(t->ops);
+    t->n++;
+
+    return NULL;
+}
+
+
+/* bptree_find() - Find an item in the B+ tree with the same key as the item
+ * pointed to by `key_item'.  Returns a pointer to the item found, or NULL if
+ * no item was found.
+ */
+void *bptree_find(bptree_t *t, void *key_item)
+{
+    bptree_node_t *p;
+    bptree_leaf_t *leaf;
+    unsigned int k;
+    int h, i;
+
+    /* The path is not needed, so the search is done here without recording
+     * it.
+     */
+    k = t->get_value(key_item);
+    p = t->root;
+    for(h = t->height; h > 0; h--) {
+        p = p->child[bptree_upper(t, p->key, p->n, k)];
+    }
+    leaf = (bptree_leaf_t *)p;
+    i = bptree_lower(t, leaf->key, leaf->n, k);
+
+    return i < leaf->n && leaf->key[i] == k ? leaf->item[i] : NULL;
+}
+
+
+/* bptree_find_min() - Returns a pointer to the minimum item in the B+ tree
+ * pointed to by t.  If there are no items in the tree a NULL pointer is
+ * returned.
+ */
+void *bptree_find_min(bptree_t *t)
+{
+    return t->n ? t->first->item[0] : NULL;
+}
+
+
+/* bptree_delete() - Delete an item in the B+ tree with the same key as the
+ * item pointed to by `key_item'.  Returns a pointer to the deleted item, and
+ * NULL if no item was found.
+ */
+void *bptree_delete(bptree_t *t, void *key_item)
+{
+    bptree_leaf_t *leaf;
+    void *item;
+    unsigned int k;
+    int i;
+
+    k = t->get_value(key_item);
+    leaf = bptree_search(t, k);
+    i = bptree_lower(t, leaf->key, leaf->n, k);
+    if(i == leaf->n || leaf->key[i] != k) return NULL;
+
+    item = leaf->item[i];
+    leaf->n--;
+    for(; i < leaf->n; i++) {
+        leaf->key[i] = leaf->key[i+1];
+        leaf->item[i] = leaf->item[i+1];
+    }
+    OP_LINK(t->ops);
+    t->n--;
+
+    /* Keys in internal nodes only separate subtrees, so they do not need to
+     * be updated when the item with that key is deleted.
+     */
+    if(t->height > 0 && leaf->n < LEAF_MIN) bptree_fix_leaf(t, leaf);
+
+    return item;
+}
+
+
+/* bptree_delete_min() - Deletes the item with the smallest key from the B+
+ * tree pointed to by t.  Returns a pointer to the deleted item.  Returns a
+ * NULL pointer if there are no items in the tree.
+ */
+void *bptree_delete_min(bptree_t *t)
+{
+    return t->n ? bptree_delete(t, t->first->item[0]) : NULL;
+}
+
+
+
+/* bptree_bulk_load() - Builds the B+ tree pointed to by t from the n items in
+ * the array items[], which must be in increasing order of key with no two keys
+ * equal.  An empty tree is built bottom up, in O(n) time, with the items
+ * spread evenly over as few leaves as possible, and the leaves then the nodes
+ * of each level spread evenly over as few nodes as possible.  If the B+ tree
+ * is not empty, the items are inserted one at a time instead.
+ */
+void bptree_bulk_load(bptree_t *t, void **items, int n)
+{
+    void **level;
+    unsigned int *mins;
+    bptree_leaf_t *leaf, *right;
+    bptree_node_t *p;
+    int i, j, k, m, size, n_parents;
+
+    if(t->n > 0 || n == 0) {
+        for(i = 0; i < n; i++) bptree_insert(t, items[i]);
+        return;
+    }
+
+    /* Spreading m children evenly over the fewest nodes that can hold them
+     * gives each node more than half as many children as it can hold, unless
+     * there is only one node, so no node is less than half full.
+     *
+     * level[0..m-1] holds the nodes of the level being built, and
+     * mins[0..m-1] the smallest key under each.  Each level is written over
+     * the start of the one below it.
+     */
+    m = (n + BPTREE_LEAF_SIZE - 1) / BPTREE_LEAF_SIZE;
+    level = malloc(m * sizeof(void *));
+    mins = malloc(m * sizeof(unsigned int));
+
+    leaf = t->first;
+    for(i = j = 0; i < m; i++) {
+        if(i > 0) {
+            right = bptree_leaf_alloc(t);
+            right->prev = leaf;
+            leaf->next = right;
+            leaf = right;
+        }
+        size = n / m + (i < n % m);
+        for(k = 0; k < size; k++, j++) {
+            leaf->key[k] = t->get_value(items[j]);
+            leaf->item[k] = items[j];
+        }
+        leaf->n = size;
+        level[i] = leaf;
+        mins[i] = leaf->key[0];
+    }
+    OP_LINKS(t->ops, n);
+
+    while(m > 1) {
+        n_parents = (m + BPTREE_ORDER - 1) / BPTREE_ORDER;
+        for(i = j = 0; i < n_parents; i++) {
+            p = bptree_node_alloc(t);
+            size = m / n_parents + (i < m % n_parents);
+            mins[i] = mins[j];
+            for(k = 0; k < size; k++, j++) {
+                p->child[k] = level[j];
+                if(k > 0) p->key[k-1] = mins[j];
+            }
+            p->n = size - 1;
+            level[i] = p;
+        }
+        OP_LINKS(t->ops, m);
+        m = n_parents;
+        t->height++;
+    }
+
+    t->root = level[0];
+    t->n = n;
+
+    free(level);
+    free(mins);
+}
+
+
+/* bptree_cursor_alloc() - Returns a new cursor on the B+ tree pointed to by
+ * t.  The cursor must be positioned by bptree_cursor_seek() before use, and
+ * again whenever the tree has been changed.
+ */
+bptree_cursor_t *bptree_cursor_alloc(bptree_t *t)
+{
+    bptree_cursor_t *c;
+
+    c = malloc(sizeof(bptree_cursor_t));
+    c->t = t;
+    c->leaf = NULL;
+    c->i = 0;
+
+    return c;
+}
+
+
+/* bptree_cursor_free() - Frees space used by the cursor pointed to by c. */
+void bptree_cursor_free(bptree_cursor_t *c)
+{
+    free(c);
+}
+
+
+/* bptree_cursor_seek() - Moves the cursor pointed to by c to the first item
+ * with a key not less than that of the item pointed to by `key_item', or to
+ * the first item if key_item is NULL, and returns it.  If there is no such
+ * item, the cursor is moved past the last item and NULL is returned.
+ */
+void *bptree_cursor_seek(bptree_cursor_t *c, void *key_item)
+{
+    bptree_t *t;
+    bptree_leaf_t *leaf;
+    int i;
+
+    t = c->t;
+    if(key_item) {
+        leaf = bptree_search(t, t->get_value(key_item));
+        i = bptree_lower(t, leaf->key, leaf->n, t->get_value(key_item));
+    }
+    else {
+        leaf = t->first;
+        i = 0;
+    }
+
+    /* The item sought may be the first item of the next leaf.  Only the root
+     * leaf can be empty, and it has no next leaf.
+     */
+    if(i == leaf->n) {
+        leaf = leaf->next;
+        i = 0;
+    }
+    c->leaf = leaf;
+    c->i = i;
+
+    return leaf ? leaf->item[i] : NULL;
+}
+
+
+/* bptree_cursor_next() - Moves the cursor pointed to by c to the next item
+ * and returns it.  If there is no next item, NULL is returned and the cursor
+ * is not moved.
+ */
+void *bptree_cursor_next(bptree_cursor_t *c)
+{
+    if(!c->leaf) return NULL;
+
+    if(c->i + 1 < c->leaf->n) {
+        c->i++;
+    }
+    else {
+        if(!c->leaf->next) return NULL;
+        c->leaf = c->leaf->next;
+        c->i = 0;
+    }
+
+    return c->leaf->item[c->i];
+}
+
+
+/* bptree_cursor_prev() - Moves the cursor pointed to by c to the previous
+ * item, or to the last item if it is past the last item, and returns it.  If
+ * there is no such item, NULL is returned and the cursor is not moved.
+ */
+void *bptree_cursor_prev(bptree_cursor_t *c)
+{
+    bptree_node_t *p;
+    bptree_leaf_t *leaf;
+    int h;
+
+    if(c->leaf && c->i > 0) {
+        c->i--;
+        return c->leaf->item[c->i];
+    }
+
+    if(c->leaf) {
+        leaf = c->leaf->prev;
+    }
+    else {
+        /* Go down the rightmost path from the root. */
+        p = c->t->root;
+        for(h = c->t->height; h > 0; h--) p = p->child[p->n];
+        leaf = (bptree_leaf_t *)p;
+    }
+    if(!leaf || leaf->n == 0) return NULL;
+
+    c->leaf = leaf;
+    c->i = leaf->n - 1;
+
+    return leaf->item[c->i];
+}
+
+
+
+/*** Functions only visible within this file. ***/
+
+/* bptree_leaf_alloc() - returns a new, empty leaf. */
+bptree_leaf_t *bptree_leaf_alloc(bptree_t *t)
+{
+    bptree_leaf_t *leaf;
+
+    leaf = pool_get(t->pool, sizeof(bptree_leaf_t));
+    OP_ALLOC(t->ops);
+    leaf->n = 0;
+    leaf->next = leaf->prev = NULL;
+
+    return leaf;
+}
+
+
+/* bptree_node_alloc() - returns a new, empty internal node. */
+bptree_node_t *bptree_node_alloc(bptree_t *t)
+{
+    bptree_node_t *p;
+
+    p = pool_get(t->pool, sizeof(bptree_node_t));
+    OP_ALLOC(t->ops);
+    p->n = 0;
+
+    return p;
+}
+
+
+/* bptree_free_subtree() - returns the subtree rooted at the node pointed to
+ * by p, which has the given number of levels of internal nodes, to the pool of
+ * the tree t.
+ */
+void bptree_free_subtree(bptree_t *t, void *p, int height)
+{
+    bptree_node_t *node;
+    int i;
+
+    if(height > 0) {
+        node = p;
+        for(i = 0; i <= node->n; i++) {
+            bptree_free_subtree(t, node->child[i], height - 1);
+        }
+        pool_put(t->pool, p, sizeof(bptree_node_t));
+    }
+    else {
+        pool_put(t->pool, p, sizeof(bptree_leaf_t));
+    }
+}
+
+
+/* bptree_upper() - returns the number of keys in key[0..n-1], which is sorted,
+ * that are less than or equal to k.  This is the index of the child of an
+ * internal node to search for k.
+ */
+int bptree_upper(bptree_t *t, const unsigned int *key, int n, unsigned int k)
+{
+    int lo, hi, mid;
+
+    lo = 0;
+    hi = n;
+    while(lo < hi) {
+        mid = (lo + hi) / 2;
+        OP_COMP(t->ops);
+        if(key[mid] <= k) lo = mid + 1; else hi = mid;
+    }
+
+    return lo;
+}
+
+
+/* bptree_lower() - returns the number of keys in key[0..n-1], which is sorted,
+ * that are less than k.  This is the position of k in a leaf.
+ */
+int bptree_lower(bptree_t *t, const unsigned int *key, int n, unsigned int k)
+{
+    int lo, hi, mid;
+
+    lo = 0;
+    hi = n;
+    while(lo < hi) {
+        mid = (lo + hi) / 2;
+        OP_COMP(t->ops);
+        if(key[mid] < k) lo = mid + 1; else hi = mid;
+    }
+
+    return lo;
+}
+
+
+/* bptree_search() - returns the leaf where the key k belongs, recording the
+ * path to it in t->path and t->pos.
+ */
+bptree_leaf_t *bptree_search(bptree_t *t, unsigned int k)
+{
+    bptree_node_t *p;
+    int d, i;
+
+    p = t->root;
+    for(d = 0; d < t->height; d++) {
+        i = bptree_upper(t, p->key, p->n, k);
+        t->path[d] = p;
+        t->pos[d] = i;
+        p = p->child[i];
+    }
+
+    return (bptree_leaf_t *)p;
+}
+
+
+/* bptree_insert_up() - inserts the key sep and the node pointed to by right,
+ * which was split off to the right of the node at the end of the last search
+ * path, into the internal nodes on the path.  Full internal nodes are split in
+ * turn, and a new root is added if the root is split.
+ */
+void bptree_insert_up(bptree_t *t, unsigned int sep, void *right)
+{
+    bptree_node_t *p, *q;
+    unsigned int key[BPTREE_ORDER];
+    void *child[BPTREE_ORDER + 1];
+    int d, i, j, half;
+
+    for(d = t->height - 1; d >= 0; d--) {
+        p = t->path[d];
+        i = t->pos[d];
+        OP_LINK(t->ops);
+
+        if(p->n < BPTREE_ORDER - 1) {
+            for(j = p->n; j > i; j--) {
+                p->key[j] = p->key[j-1];
+                p->child[j+1] = p->child[j];
+            }
+            p->key[i] = sep;
+            p->child[i+1] = right;
+            p->n++;
+            return;
+        }
+
+        /* Split a full node.  The keys and children, including the new ones,
+         * are gathered, then the middle key moves up to the parent.
+         */
+        for(j = 0; j < i; j++) key[j] = p->key[j];
+        key[i] = sep;
+        for(j = i; j < p->n; j++) key[j+1] = p->key[j];
+        for(j = 0; j <= i; j++) child[j] = p->child[j];
+        child[i+1] = right;
+        for(j = i + 1; j <= p->n; j++) child[j+1] = p->child[j];
+
+        half = BPTREE_ORDER / 2;
+        q = bptree_node_alloc(t);
+        p->n = half;
+        for(j = 0; j < half; j++) {
+            p->key[j] = key[j];
+            p->child[j] = child[j];
+        }
+        p->child[half] = child[half];
+        q->n = BPTREE_ORDER - 1 - half;
+        for(j = 0; j < q->n; j++) {
+            q->key[j] = key[half+1+j];
+            q->child[j] = child[half+1+j];
+        }
+        q->child[q->n] = child[BPTREE_ORDER];
+        OP_RESTRUCT(t->ops);
+
+        sep = key[half];
+        right = q;
+    }
+
+    /* The root was split. */
+    p = bptree_node_alloc(t);
+    p->n = 1;
+    p->key[0] = sep;
+    p->child[0] = t->root;
+    p->child[1] = right;
+    OP_LINKS(t->ops, 2);
+    t->root = p;
+    t->height++;
+}
+
+
+/* bptree_remove_entry() - removes key i and child i + 1 from the internal
+ * node pointed to by p.
+ */
+void bptree_remove_entry(bptree_node_t *p, int i)
+{
+    p->n--;
+    for(; i < p->n; i++) {
+        p->key[i] = p->key[i+1];
+        p->child[i+1] = p->child[i+2];
+    }
+}
+
+
+/* bptree_fix_leaf() - restores the minimum number of items in the leaf
+ * pointed to by leaf, which is at the end of the last search path, by moving
+ * an item from a neighbouring leaf, or by merging with it.
+ */
+void bptree_fix_leaf(bptree_t *t, bptree_leaf_t *leaf)
+{
+    bptree_node_t *parent;
+    bptree_leaf_t *left, *right;
+    int i, j;
+
+    parent = t->path[t->height - 1];
+    i = t->pos[t->height - 1];
+
+    /* Use the neighbour on the left, unless the leaf is the first child. */
+    if(i > 0) {
+        left = parent->child[i-1];
+        right = leaf;
+    }
+    else {
+        left = leaf;
+        right = parent->child[1];
+        i = 1;
+    }
+
+    if(left->n + right->n > BPTREE_LEAF_SIZE) {
+        /* Move one item to the leaf that is short of items. */
+        if(left == leaf) {
+            left->key[left->n] = right->key[0];
+            left->item[left->n] = right->item[0];
+            left->n++;
+            right->n--;
+            for(j = 0; j < right->n; j++) {
+                right->key[j] = right->key[j+1];
+                right->item[j] = right->item[j+1];
+            }
+        }
+        else {
+            for(j = right->n; j > 0; j--) {
+                right->key[j] = right->key[j-1];
+                right->item[j] = right->item[j-1];
+            }
+            left->n--;
+            right->key[0] = left->key[left->n];
+            right->item[0] = left->item[left->n];
+            right->n++;
+        }
+        parent->key[i-1] = right->key[0];
+        OP_LINK(t->ops);
+        return;
+    }
+
+    /* Merge the right leaf into the left leaf. */
+    for(j = 0; j < right->n; j++) {
+        left->key[left->n + j] = right->key[j];
+        left->item[left->n + j] = right->item[j];
+    }
+    left->n += right->n;
+    left->next = right->next;
+    if(left->next) left->next->prev = left;
+    pool_put(t->pool, right, sizeof(bptree_leaf_t));
+    OP_RESTRUCT(t->ops);
+
+    bptree_remove_entry(parent, i-1);
+    bptree_fix_nodes(t);
+}
+
+
+/* bptree_fix_nodes() - restores the minimum number of keys in the internal
+ * nodes on the last search path, from the bottom up, after a key has been
+ * removed from the bottom one.  A node short of keys takes one from a
+ * neighbouring node, through the parent, or is merged with it.  An empty root
+ * is removed.
+ */
+void bptree_fix_nodes(bptree_t *t)
+{
+    bptree_node_t *p, *parent, *left, *right;
+    int d, i, j;
+
+    for(d = t->height - 1; d > 0 && t->path[d]->n < NODE_MIN; d--) {
+        p = t->path[d];
+        parent = t->path[d-1];
+        i = t->pos[d-1];
+        if(i > 0) {
+            left = parent->child[i-1];
+            right = p;
+        }
+        else {
+            left = p;
+            right = parent->child[1];
+            i = 1;
+        }
+
+        if(left->n + right->n >= BPTREE_ORDER - 1) {
+            /* Rotate one key through the parent. */
+            if(left == p) {
+                left->key[left->n] = parent->key[i-1];
+                left->child[left->n + 1] = right->child[0];
+                left->n++;
+                parent->key[i-1] = right->key[0];
+                right->n--;
+                for(j = 0; j < right->n; j++) {
+                    right->key[j] = right->key[j+1];
+                    right->child[j] = right->child[j+1];
+                }
+                right->child[right->n] = right->child[right->n + 1];
+            }
+            else {
+                right->child[right->n + 1] = right->child[right->n];
+                for(j = right->n; j > 0; j--) {
+                    right->key[j] = right->key[j-1];
+                    right->child[j] = right->child[j-1];
+                }
+                right->key[0] = parent->key[i-1];
+                right->child[0] = left->child[left->n];
+                right->n++;
+                left->n--;
+                parent->key[i-1] = left->key[left->n];
+            }
+            OP_LINK(t->ops);
+            return;
+        }
+
+        /* Merge the right node, and the key between them, into the left. */
+        left->key[left->n] = parent->key[i-1];
+        for(j = 0; j < right->n; j++) {
+            left->key[left->n + 1 + j] = right->key[j];
+            left->child[left->n + 1 + j] = right->child[j];
+        }
+        left->child[left->n + 1 + right->n] = right->child[right->n];
+        left->n += right->n + 1;
+        pool_put(t->pool, right, sizeof(bptree_node_t));
+        OP_RESTRUCT(t->ops);
+
+        bptree_remove_entry(parent, i-1);
+    }
+
+    /* The root is removed when its last two children have been merged. */
+    p = t->root;
+    if(t->height > 0 && p->n == 0) {
+        t->root = p->child[0];
+        t->height--;
+        pool_put(t->pool, p, sizeof(bptree_node_t));
+    }
+}
+
+
+
+/*** Implement the universal dictionary structure type ***/
+
+/*** B+ tree wrapper functions. ***/
+
+void *_bptree_alloc(int (* compar)(const void *, const void *),
+		    unsigned int (* get_value)(const void *)) {
+    return bptree_alloc(get_value, NULL);
+}
+
+void _bptree_free(void *t) {
+    bptree_free((bptree_t *)t);
+}
+
+void *_bptree_insert(void *t, void *item) {
+    return bptree_insert((bptree_t *)t, item);
+}
+
+void *_bptree_delete(void *t, void *key_item) {
+    return bptree_delete((bptree_t *)t, key_item);
+}
+
+void *_bptree_delete_min(void *t) {
+    return bptree_delete_min((bptree_t *)t);
+}
+
+void *_bptree_find(void *t, void *key_item) {
+    return bptree_find((bptree_t *)t, key_item);
+}
+
+void *_bptree_find_min(void *t) {
+    return bptree_find_min((bptree_t *)t);
+}
+
+const opcount_t *_bptree_counts(void *t) {
+    return &((bptree_t *)t)->ops;
+}
+
+void *_bptree_cursor_alloc(void *t) {
+    return bptree_cursor_alloc((bptree_t *)t);
+}
+
+void _bptree_cursor_free(void *c) {
+    bptree_cursor_free((bptree_cursor_t *)c);
+}
+
+void *_bptree_cursor_seek(void *c, void *key_item) {
+    return bptree_cursor_seek((bptree_cursor_t *)c, key_item);
+}
+
+void *_bptree_cursor_next(void *c) {
+    return bptree_cursor_next((bptree_cursor_t *)c);
+}
+
+void *_bptree_cursor_prev(void *c) {
+    return bptree_cursor_prev((bptree_cursor_t *)c);
+}
+
+void _bptree_bulk_load(void *t, void **items, int n) {
+    bptree_bulk_load((bptree_t *)t, items, n);
+}
+
+/* B+ tree info. */
+const dict_info_t BPTREE_info = {
+    _bptree_alloc,
+    _bptree_free,
+    _bptree_insert,
+    _bptree_delete,
+    _bptree_delete_min,
+    _bptree_find,
+    _bptree_find_min,
+    _bptree_counts,
+    _bptree_cursor_alloc,
+    _bptree_cursor_free,
+    _bptree_cursor_seek,
+    _bptree_cursor_next,
+    _bptree_cursor_prev,
+    _bptree_bulk_load,
+    NULL   /* No batched find. */
+};
@@ -0,0 +1,187 @@
+/*** File bptree.h - B+ Tree ***/
+#ifndef BPTREE_H
+#define BPTREE_H
+#include "dict_info.h"  /* Defines the universal dictionary structure type. */
+#include "pool.h"
+
+/* A B+ tree keeps all items in its leaves, and only keys in its internal
+ * nodes.  Nodes hold many keys, so the tree is shallow, and a search visits
+ * one node per level instead of one node per comparison.  Keys are obtained
+ * from items using a get_value() function, as in the digital search trees,
+ * and are stored in the nodes themselves.  A search within a node then only
+ * reads the node's key array, which spans a few cache lines, and does not
+ * follow a pointer to an item until the item has been found.
+ *
+ * An internal node with n keys has n + 1 children.  Child j holds the keys k
+ * with key[j-1] <= k < key[j].  Leaves are linked in key order, so that items
+ * can be scanned in order without going back up the tree.  All leaves are at
+ * the same depth.  Nodes other than the root are kept at least half full;
+ * after a deletion a node that is less than half full borrows from, or is
+ * merged with, a neighbouring node.
+ */
+
+
+/*** Compile Time Options ***/
+
+/* The maximum number of children of an internal node.  With 4 byte keys and
+ * 8 byte pointers, the default of 32 gives a key array of two 64 byte cache
+ * lines.
+ */
+#define BPTREE_ORDER 32
+
+/* The maximum number of items in a leaf. */
+#define BPTREE_LEAF_SIZE 32
+
+/* The maximum height of the tree.  A tree of height h holds at least
+ * 2 * (BPTREE_ORDER/2)^(h-1) * BPTREE_LEAF_SIZE/2 items.
+ */
+#define BPTREE_MAX_HEIGHT 16
+
+
+
+/*** Structure Type Definitions. ***/
+
+/* An internal node, with n keys and n + 1 children.  Children at the bottom
+ * level of internal nodes are leaves.
+ */
+typedef struct bptree_node {
+    int n;
+    unsigned int key[BPTREE_ORDER - 1];
+    void *child[BPTREE_ORDER];
+} bptree_node_t;
+
+/* A leaf, with n items and their keys in key order, and pointers to the next
+ * and previous leaves in key order.
+ */
+typedef struct bptree_leaf {
+    int n;
+    unsigned int key[BPTREE_LEAF_SIZE];
+    void *item[BPTREE_LEAF_SIZE];
+    struct bptree_leaf *next, *prev;
+} bptree_leaf_t;
+
+/* Structure type for the B+ tree:
+ *     root - the root, which is a leaf when height is 0.
+ *     first - the leaf holding the smallest keys.
+ *     height - the number of levels of internal nodes.
+ *     n - the number of items in the tree.
+ *     path, pos - the internal nodes on the path of the last search, and the
+ *                 index of the child taken at each.
+ *     get_value - a function which returns the key of an item.
+ *     pool - the pool that nodes and leaves are allocated from.
+ *     own_pool - 1 if the pool belongs to the tree, and 0 if it is shared.
+ *     ops - counts the operations performed on the tree, for experimental
+ *           purposes.
+ */
+typedef struct bptree {
+    void *root;
+    bptree_leaf_t *first;
+    int height;
+    int n;
+    bptree_node_t *path[BPTREE_MAX_HEIGHT];
+    int pos[BPTREE_MAX_HEIGHT];
+    unsigned int (* get_value)(const void *);
+    pool_t *pool;
+    int own_pool;
+    opcount_t ops;
+} bptree_t;
+
+/* Structure type for a cursor on the B+ tree.  The current item is item i of
+ * the leaf pointed to by leaf, and leaf is NULL when the cursor is past the
+ * last item.
+ */
+typedef struct bptree_cursor {
+    bptree_t *t;
+    bptree_leaf_t *leaf;
+    int i;
+} bptree_cursor_t;
+
+
+
+/* bptree_alloc() - Allocates space for a B+ tree and returns a pointer to it.
+ * The function get_value() returns the key value for a data item.  Nodes and
+ * leaves are allocated from the pool pointed to by pool, which may be shared
+ * with other dictionaries, or from a new pool of the tree's own if pool is
+ * NULL.
+ */
+bptree_t *bptree_alloc(unsigned int (* get_value)(const void *), pool_t *pool);
+
+/* bptree_free() - Frees space used by the B+ tree pointed to by t.  The nodes
+ * and leaves of a tree with its own pool are freed all at once, by freeing the
+ * pool.  Otherwise they are returned to the shared pool.
+ */
+void bptree_free(bptree_t *t);
+
+/* bptree_insert() - Inserts an item into the B+ tree pointed to by t,
+ * according to the value of its key.  The key of an item in the B+ tree must
+ * be unique among items in the tree.  If an item with the same key already
+ * exists in the tree, a pointer to that item is returned.  Otherwise, NULL is
+ * returned, indicating insertion was successful.
+ */
+void *bptree_insert(bptree_t *t, void *item);
+
+/* bptree_find() - Find an item in the B+ tree with the same key as the item
+ * pointed to by `key_item'.  Returns a pointer to the item found, or NULL if
+ * no item was found.
+ */
+void *bptree_find(bptree_t *t, void *key_item);
+
+/* bptree_find_min() - Returns a pointer to the minimum item in the B+ tree
+ * pointed to by t.  If there are no items in the tree a NULL pointer is
+ * returned.
+ */
+void *bptree_find_min(bptree_t *t);
+
+/* bptree_delete() - Delete an item in the B+ tree with the same key as the
+ * item pointed to by `key_item'.  Returns a pointer to the deleted item, and
+ * NULL if no item was found.
+ */
+void *bptree_delete(bptree_t *t, void *key_item);
+
+/* bptree_delete_min() - Deletes the item with the smallest key from the B+
+ * tree pointed to by t.  Returns a pointer to the deleted item.  Returns a
+ * NULL pointer if there are no items in the tree.
+ */
+void *bptree_delete_min(bptree_t *t);
+
+/* bptree_bulk_load() - Builds the B+ tree pointed to by t from the n items in
+ * the array items[], which must be in increasing order of key with no two keys
+ * equal.  An empty tree is built bottom up, in O(n) time, with the items
+ * spread evenly over as few leaves as possible, and the leaves then the nodes
+ * of each level spread evenly over as few nodes as possible.  If the B+ tree
+ * is not empty, the items are inserted one at a time instead.
+ */
+void bptree_bulk_load(bptree_t *t, void **items, int n);
+
+/* bptree_cursor_alloc() - Returns a new cursor on the B+ tree pointed to by
+ * t.  The cursor must be positioned by bptree_cursor_seek() before use, and
+ * again whenever the tree has been changed.
+ */
+bptree_cursor_t *bptree_cursor_alloc(bptree_t *t);
+
+/* bptree_cursor_free() - Frees space used by the cursor pointed to by c. */
+void bptree_cursor_free(bptree_cursor_t *c);
+
+/* bptree_cursor_seek() - Moves the cursor pointed to by c to the first item
+ * with a key not less than that of the item pointed to by `key_item', or to
+ * the first item if key_item is NULL, and returns it.  If there is no such
+ * item, the cursor is moved past the last item and NULL is returned.
+ */
+void *bptree_cursor_seek(bptree_cursor_t *c, void *key_item);
+
+/* bptree_cursor_next() - Moves the cursor pointed to by c to the next item
+ * and returns it.  If there is no next item, NULL is returned and the cursor
+ * is not moved.
+ */
+void *bptree_cursor_next(bptree_cursor_t *c);
+
+/* bptree_cursor_prev() - Moves the cursor pointed to by c to the previous
+ * item, or to the last item if it is past the last item, and returns it.  If
+ * there is no such item, NULL is returned and the cursor is not moved.
+ */
+void *bptree_cursor_prev(bptree_cursor_t *c);
+
+/*** Alternative interface via the universal dictionary structure type. ***/
+extern const dict_info_t BPTREE_info;
+
+#endif
@@ -0,0 +1,246 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "bptree.h"
+
+
+#define N_ITEMS 15000
+#define RND_MAX 30000
+
+
+typedef struct test_item {
+    int data1;
+    int data2;
+} test_item_t;
+
+
+unsigned int item_val(const void *item)
+{
+    return ((test_item_t *)item)->data1;
+}
+
+
+/* check_subtree() - checks the subtree rooted at p, of the given height, whose
+ * keys must lie in the range lo..hi-1 (without a limit when the bounds are
+ * NULL).  Checks that nodes other than the root are at least half full, that
+ * the leaves are reached in the order they are linked, and that their keys
+ * are sorted.  *leaf is the next leaf expected.  Returns the number of items
+ * in the subtree, or -1 if a check failed.
+ */
+int check_subtree(bptree_t *t, void *p, int height, unsigned int *lo,
+                  unsigned int *hi, bptree_leaf_t **leaf)
+{
+    bptree_node_t *node;
+    bptree_leaf_t *l;
+    int i, n, sum;
+
+    if(height == 0) {
+        l = p;
+        if(l != *leaf) return -1;
+        if(p != t->root && l->n < BPTREE_LEAF_SIZE/2) return -1;
+        for(i = 0; i < l->n; i++) {
+            if(i > 0 && l->key[i-1] >= l->key[i]) return -1;
+            if(lo && l->key[i] < *lo) return -1;
+            if(hi && l->key[i] >= *hi) return -1;
+            if(item_val(l->item[i]) != l->key[i]) return -1;
+        }
+        *leaf = l->next;
+        return l->n;
+    }
+
+    node = p;
+    if(p != t->root && node->n < BPTREE_ORDER/2 - 1) return -1;
+    if(p == t->root && node->n < 1) return -1;
+    sum = 0;
+    for(i = 0; i <= node->n; i++) {
+        if(i < node->n - 1 && node->key[i] >= node->key[i+1]) return -1;
+        n = check_subtree(t, node->child[i], height - 1,
+                          i > 0 ? &node->key[i-1] : lo,
+                          i < node->n ? &node->key[i] : hi, leaf);
+        if(n < 0) return -1;
+        sum += n;
+    }
+
+    return sum;
+}
+
+/* check_tree() - checks the whole tree, and exits if a check fails. */
+void check_tree(bptree_t *t)
+{
+    bptree_leaf_t *leaf;
+
+    leaf = t->first;
+    if(check_subtree(t, t->root, t->height, NULL, NULL, &leaf) != t->n
+       || leaf != NULL) {
+        printf("tree structure is wrong.\n");
+        exit(1);
+    }
+}
+
+
+/* Compares the items pointed to by two elements of an array of item pointers,
+ * for sorting the array with qsort().
+ */
+int item_ptr_cmp(const void *p1, const void *p2)
+{
+    return (*(test_item_t **)p1)->data1 - (*(test_item_t **)p2)->data1;
+}
+
+
+int main(void)
+{
+    bptree_t *t;
+    pool_t *pool;
+    test_item_t item_array[N_ITEMS], *i, *i2, duplicate, lookup_item;
+    test_item_t *result, *sorted[N_ITEMS];
+    int j, last;
+
+    /* Create a B+ tree. */
+    t = bptree_alloc(item_val, NULL);
+
+    /* Add some items to it. */
+    printf("Inserting items...");
+    for(j = 0; j < N_ITEMS; j++) {
+	i = &item_array[j];
+	i->data1 = rand() % RND_MAX;
+	i->data2 = rand() % RND_MAX;
+        if((i2 = bptree_insert(t, i))) {
+	    j--;  /* Duplicate - try again. */
+	}
+    }
+    check_tree(t);
+    printf("successful, height %d.\n", t->height);
+
+    /* Test duplicate detection. */
+    printf("\nAttempting insert to give duplicate key...");
+    i2 = &item_array[N_ITEMS/2];
+    duplicate.data1 = i2->data1;  duplicate.data2 = rand() % RND_MAX;
+    if(bptree_insert(t, &duplicate) == i2) {
+	printf("duplicate detected.\n");
+    }
+    else {
+	printf("failed - duplicated undected.\n");
+	exit(1);
+    }
+
+    /* Test bptree_find() */
+    printf("\nTesting bptree_find() to find an item...");
+    lookup_item.data1 = item_array[N_ITEMS/2].data1;  /* key to lookup. */
+    result = bptree_find(t, &lookup_item);
+    if(result) {
+	printf("%s\n", result->data1 == lookup_item.data1
+	       ? "successful." : "failed.");
+    }
+    else {
+	printf("failed.\n");
+    }
+
+    /* Test bptree_find_min() */
+    printf("Testing bptree_find_min()...");
+    result = bptree_find_min(t);
+    if(result) printf("%d.\n", result->data1); else printf("failed.\n");
+
+    /* Test bptree_delete(). */
+    printf("\nTesting bptree_delete()...");
+    result = bptree_delete(t, &lookup_item);
+    if(result) {
+	printf("%s\n", result->data1 == lookup_item.data1
+	       ? "successful." : "failed.");
+    }
+    else {
+	printf("failed.\n");
+    }
+    if(bptree_find(t, &lookup_item)) {
+        printf("deleted item was found.\n");
+        exit(1);
+    }
+
+    /* Test bptree_delete_min() */
+    printf("Testing bptree_delete_min()...");
+    result = bptree_delete_min(t);
+    if(result) printf("%d.\n", result->data1); else printf("failed.\n");
+
+    /* Test bptree_free(). */
+    printf("Testing bptree_free()...");
+    bptree_free(t);
+    printf("successful.\n");
+
+    /* Create a new tree then repeat bptree_insert()/bptree_delete(), checking
+     * the tree after each step.
+     */
+    pool = pool_alloc();  /* A shared pool, which nodes are returned to. */
+    t = bptree_alloc(item_val, pool);
+    printf("\nRepeating bptree_insert()/bptree_delete()...");
+    for(j = 0; j < N_ITEMS; j++) {
+	i = &item_array[j];  /* Uniqueness of keys was enforced earlier. */
+        bptree_insert(t, i);
+    }
+    check_tree(t);
+    for(j = N_ITEMS/2; j < N_ITEMS; j++) {
+	i = &item_array[j];
+	if(bptree_delete(t, i) != i) { printf("failed.\n"); exit(1); }
+        if(j % 100 == 0) check_tree(t);
+    }
+    check_tree(t);
+    for(j = 0; j < N_ITEMS; j++) {
+	i = &item_array[j];
+	if((bptree_find(t, i) == i) != (j < N_ITEMS/2)) {
+            printf("failed.\n"); exit(1);
+        }
+    }
+    for(j = N_ITEMS/2; j < N_ITEMS; j++) {
+	i = &item_array[j];
+        bptree_insert(t, i);
+    }
+    check_tree(t);
+    printf("successful.\n");
+
+    /* Empty the tree with bptree_delete_min(), which must return items in
+     * increasing order of key.
+     */
+    printf("Emptying the tree with bptree_delete_min()...");
+    last = -1;
+    for(j = 0; j < N_ITEMS; j++) {
+        result = bptree_delete_min(t);
+        if(!result || result->data1 <= last) { printf("failed.\n"); exit(1); }
+        last = result->data1;
+        if(j % 100 == 0) check_tree(t);
+    }
+    if(bptree_delete_min(t) || t->height != 0) {
+        printf("failed.\n"); exit(1);
+    }
+    printf("successful.\n");
+    bptree_free(t);
+
+    /* Test bptree_bulk_load() with the items in increasing order of key, then
+     * check that the result can be updated.
+     */
+    printf("\nTesting bptree_bulk_load()...");
+    for(j = 0; j < N_ITEMS; j++) sorted[j] = &item_array[j];
+    qsort(sorted, N_ITEMS, sizeof(test_item_t *), item_ptr_cmp);
+    t = bptree_alloc(item_val, NULL);
+    bptree_bulk_load(t, (void **)sorted, N_ITEMS);
+    check_tree(t);
+    for(j = 0; j < N_ITEMS; j++) {
+	i = &item_array[j];
+	if(bptree_find(t, i) != i) { printf("failed.\n"); exit(1); }
+    }
+    for(j = 0; j < N_ITEMS/2; j++) {
+	i = &item_array[j];
+	if(bptree_delete(t, i) != i) { printf("failed.\n"); exit(1); }
+    }
+    check_tree(t);
+    for(j = 0; j < N_ITEMS/2; j++) {
+	i = &item_array[j];
+	bptree_insert(t, i);
+    }
+    check_tree(t);
+    for(j = 0; j < N_ITEMS; j++) {
+	if(bptree_delete_min(t) != sorted[j]) { printf("failed.\n"); exit(1); }
+    }
+    bptree_free(t);
+    printf("successful.\n");
+
+    pool_free(pool);
+
+    return 0;
+}
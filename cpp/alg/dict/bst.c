@@ -9,33 +9,45 @@
 /* bst_alloc() - Allocates space for a binary search tree and returns a pointer
  * to it.  The function compar compares they keys of two items, and returns a
  * negative, zero, or positive integer depending on whether the first item is
- * less than, equal to, or greater than the second.
+ * less than, equal to, or greater than the second.  Nodes are allocated from
+ * the pool pointed to by pool, which may be shared with other dictionaries, or
+ * from a new pool of the tree's own if pool is NULL.
  */
-bst_t *bst_alloc(int (* compar)(const void *, const void *))
+bst_t *bst_alloc(int (* compar)(const void *, const void *), pool_t *pool)
 {
     bst_t *t;
 
 
     t = malloc(sizeof(bst_t));
+    t->own_pool = !pool;
+    t->pool = pool ? pool : pool_alloc();
     t->root = NULL;
     t->compar = compar;
     t->n = 0;
+    OP_RESET(t->ops);
 
     return t;
 }
 
 
-/* bst_free() - Frees space used by the binary search tree pointed to by t. */
+/* bst_free() - Frees space used by the binary search tree pointed to by t.
+ * The nodes of a tree with its own pool are freed all at once, by freeing the
+ * pool.  Otherwise they are returned to the shared pool.
+ */
 void bst_free(bst_t *t)
 {
     bst_node_t *p, **stack;
     int tos;
 
-    /* In order to free all nodes in the tree a depth first search is performed
-     * This is implemented using a stack.
+    /* The nodes of a tree with its own pool are freed with the pool.
+     * Otherwise, in order to return all nodes to the pool a depth first search
+     * is performed.  This is implemented using a stack.
      */
     
-    if(t->root) {
+    if(t->own_pool) {
+        pool_free(t->pool);
+    }
+    else if(t->root) {
         stack = malloc(t->n * sizeof(bst_node_t *));
 	stack[0] = t->root;
         tos = 1;
@@ -47,7 +59,7 @@ void bst_free(bst_t *t)
 	    if(p->right) {
 		stack[tos++] = p->right;
 	    }
-	    free(p);
+	    pool_put(t->pool, p, sizeof(bst_node_t));
 	}
 	free(stack);
     }
@@ -66,9 +78,10 @@ void *bst_insert(bst_t *t, void *item)
 {
     bst_node_t *x, *p, *next_p, **attach_x;
     int (* compar)(const void *, const void *);
-    int cmp_result;
+    int cmp_result, depth;
 
     
+    depth = 0;
     if((next_p = t->root)) {
         compar = t->compar;
 	
@@ -77,6 +90,8 @@ void *bst_insert(bst_t *t, void *item)
 	 */
         for(;;) {
 	    p = next_p;
+	    depth++;
+	    OP_COMP(t->ops);
 	    cmp_result = compar(item, p->item);
 	    if(cmp_result < 0) {
                 next_p = p->left;
@@ -101,11 +116,14 @@ void *bst_insert(bst_t *t, void *item)
 	attach_x = &t->root;
     }
 
-    x = malloc(sizeof(bst_node_t));
+    x = pool_get(t->pool, sizeof(bst_node_t));
+    OP_ALLOC(t->ops);
     x->left = x->right = NULL;
     x->item = item;
 
     *attach_x = x;
+    OP_LINK(t->ops);
+    OP_DEPTH(t->ops, depth);
     t->n++;
     
     return NULL;
@@ -131,6 +149,7 @@ void *bst_find(bst_t *t, void *key_item)
 	 */
         do {
 	    p = next_p;
+	    OP_COMP(t->ops);
 	    cmp_result = compar(key_item, p->item);
 	    if(cmp_result < 0) {
                 next_p = p->left;
@@ -149,6 +168,69 @@ void *bst_find(bst_t *t, void *key_item)
 }
 
 
+/* bst_find_many() - Finds the items in the binary search tree pointed to by t
+ * with the same keys as the n items pointed to by key_items[], and stores a
+ * pointer to each item found, or NULL, in items[].  The lookups are
+ * interleaved in groups of FIND_MANY_GROUP, with the next node of each
+ * prefetched, so that their cache misses overlap.
+ */
+void bst_find_many(bst_t *t, void **key_items, void **items, int n)
+{
+    int (* compar)(const void *, const void *);
+    int cmp_result;
+    bst_node_t *p[FIND_MANY_GROUP], *q;
+    int key_i[FIND_MANY_GROUP];
+    int i, j, group_n, active;
+
+    compar = t->compar;
+
+    for(i = 0; i < n; i += group_n) {
+	group_n = n - i < FIND_MANY_GROUP ? n - i : FIND_MANY_GROUP;
+	for(j = 0; j < group_n; j++) {
+	    PREFETCH(key_items[i+j]);
+	    p[j] = t->root;
+	    key_i[j] = i + j;
+	    items[i+j] = NULL;
+	}
+
+	/* Lookup j of the active lookups is at node p[j], for key
+	 * key_items[key_i[j]].  Each pass moves every active lookup down one
+	 * level.  The items of the nodes reached are prefetched before any of
+	 * them are compared, and the children moved to are prefetched for the
+	 * next pass.  A finished lookup is replaced by the last active one.
+	 */
+	active = t->root ? group_n : 0;
+	while(active) {
+	    for(j = 0; j < active; j++) PREFETCH(p[j]->item);
+	    for(j = 0; j < active; ) {
+		q = p[j];
+		OP_COMP(t->ops);
+		cmp_result = compar(key_items[key_i[j]], q->item);
+		if(cmp_result < 0) {
+		    q = q->left;
+		}
+		else if(cmp_result > 0) {
+		    q = q->right;
+		}
+		else {
+		    items[key_i[j]] = q->item;  /* Item found. */
+		    q = NULL;
+		}
+		if(q) {
+		    PREFETCH(q);
+		    p[j++] = q;
+		}
+		else {
+		    active--;
+		    p[j] = p[active];
+		    key_i[j] = key_i[active];
+		}
+	    }
+	}
+    }
+}
+
+
 /* bst_find_min() - Returns a pointer to the minimum item in the binary search
  * tree pointed to by t.  If there are no items in the tree a NULL pointer is
  * returned.
@@ -195,6 +277,7 @@ void *bst_delete(bst_t *t, void *key_item)
         for(;;) {
 	    prev_p = p;
 	    p = next_p;
+	    OP_COMP(t->ops);
 	    cmp_result = compar(key_item, p->item);
 	    if(cmp_result < 0) {
                 next_p = p->left;
@@ -214,6 +297,7 @@ void *bst_delete(bst_t *t, void *key_item)
     }
 
     /* p points to the node to be deleted. */
+    OP_LINK(t->ops);
     if(!p->left) {
 	/* Right child replaces p. */
 	if(!prev_p) {
@@ -271,7 +355,7 @@ void *bst_delete(bst_t *t, void *key_item)
 
     /* Get return value and free space used by node p. */
     return_item = p->item;
-    free(p);
+    pool_put(t->pool, p, sizeof(bst_node_t));
 
     t->n--;
     
@@ -305,6 +389,7 @@ void *bst_delete_min(bst_t *t)
     }
 
     /* Right child replaces p. */
+    OP_LINK(t->ops);
     if(!prev_p) {
         t->root = p->right;
     }
@@ -314,7 +399,7 @@ void *bst_delete_min(bst_t *t)
 
     /* Get return value and free space used by node p. */
     return_item = p->item;
-    free(p);
+    pool_put(t->pool, p, sizeof(bst_node_t));
 
     t->n--;
     
@@ -322,13 +407,197 @@ void *bst_delete_min(bst_t *t)
 }
 
 
+/* bst_build() - Builds a perfectly balanced subtree from the n items in the
+ * array items[], and returns its root.
+ */
+bst_node_t *bst_build(bst_t *t, void **items, int n)
+{
+    bst_node_t *p;
+    int mid;
+
+    if(n == 0) return NULL;
+
+    mid = n / 2;
+    p = pool_get(t->pool, sizeof(bst_node_t));
+    OP_ALLOC(t->ops);
+    p->item = items[mid];
+    p->left = bst_build(t, items, mid);
+    p->right = bst_build(t, items + mid + 1, n - mid - 1);
+    OP_LINK(t->ops);
+
+    return p;
+}
+
+
+/* bst_bulk_load() - Builds the binary search tree pointed to by t from the n
+ * items in the array items[], which must be in increasing order of key with no
+ * two keys equal.  An empty tree is built perfectly balanced, in O(n) time.
+ * If the binary search tree is not empty, the items are inserted one at a time
+ * instead.
+ */
+void bst_bulk_load(bst_t *t, void **items, int n)
+{
+    int i;
+
+    if(t->n > 0) {
+        for(i = 0; i < n; i++) bst_insert(t, items[i]);
+        return;
+    }
+
+    t->root = bst_build(t, items, n);
+    t->n = n;
+}
+
+
+/* bst_cursor_alloc() - Returns a new cursor on the binary search tree pointed
+ * to by t.  The cursor must be positioned by bst_cursor_seek() before use, and
+ * again whenever the tree has been changed.
+ */
+bst_cursor_t *bst_cursor_alloc(bst_t *t)
+{
+    bst_cursor_t *c;
+
+    c = malloc(sizeof(bst_cursor_t));
+    c->t = t;
+    c->stack = malloc(BST_STACK_SIZE * sizeof(bst_node_t *));
+    c->stack_size = BST_STACK_SIZE;
+    c->tos = 0;
+
+    return c;
+}
+
+
+/* bst_cursor_free() - Frees space used by the cursor pointed to by c. */
+void bst_cursor_free(bst_cursor_t *c)
+{
+    free(c->stack);
+    free(c);
+}
+
+
+/* bst_cursor_seek() - Moves the cursor pointed to by c to the first item
+ * with a key not less than that of the item pointed to by `key_item', or to
+ * the first item if key_item is NULL, and returns it.  If there is no such
+ * item, the cursor is moved past the last item and NULL is returned.
+ */
+void *bst_cursor_seek(bst_cursor_t *c, void *key_item)
+{
+    bst_t *t;
+    bst_node_t *p, **stack;
+    int cmp_result, tos;
+
+    t = c->t;
+
+    /* No path is longer than the number of items, which can not change until
+     * the cursor is next positioned by a seek.
+     */
+    if(t->n > c->stack_size) {
+        free(c->stack);
+        c->stack = malloc(t->n * sizeof(bst_node_t *));
+        c->stack_size = t->n;
+    }
+
+    stack = c->stack;
+    tos = 0;
+    c->tos = 0;
+
+    /* The path to the last node at which the search went left, or stopped,
+     * is the path to the item sought.
+     */
+    for(p = t->root; p; ) {
+	stack[tos++] = p;
+	if(key_item) {
+	    OP_COMP(t->ops);
+	    cmp_result = t->compar(key_item, p->item);
+	}
+	else {
+	    cmp_result = -1;
+	}
+	if(cmp_result <= 0) {
+	    c->tos = tos;
+	    if(cmp_result == 0) break;
+	    p = p->left;
+	}
+	else {
+	    p = p->right;
+	}
+    }
+
+    return c->tos ? stack[c->tos - 1]->item : NULL;
+}
+
+
+/* bst_cursor_next() - Moves the cursor pointed to by c to the next item and
+ * returns it.  If there is no next item, NULL is returned and the cursor is
+ * not moved.
+ */
+void *bst_cursor_next(bst_cursor_t *c)
+{
+    bst_node_t *p, **stack;
+    int tos;
+
+    stack = c->stack;
+    tos = c->tos;
+    if(!tos) return NULL;
+
+    /* The next item is the minimum of the right subtree, if there is one. */
+    p = stack[tos-1]->right;
+    if(p) {
+	for(; p; p = p->left) stack[tos++] = p;
+	c->tos = tos;
+	return stack[tos-1]->item;
+    }
+
+    /* Otherwise it is the nearest ancestor whose left subtree holds the
+     * current node.
+     */
+    while(tos > 1 && stack[tos-2]->right == stack[tos-1]) tos--;
+    if(tos == 1) return NULL;
+    c->tos = tos - 1;
+    return stack[tos-2]->item;
+}
+
+
+/* bst_cursor_prev() - Moves the cursor pointed to by c to the previous
+ * item, or to the last item if it is past the last item, and returns it.  If
+ * there is no such item, NULL is returned and the cursor is not moved.
+ */
+void *bst_cursor_prev(bst_cursor_t *c)
+{
+    bst_node_t *p, **stack;
+    int tos;
+
+    stack = c->stack;
+    tos = c->tos;
+    p = tos ? stack[tos-1]->left : c->t->root;
+
+    /* The previous item is the maximum of the left subtree, if there is one.
+     * From past the last item, it is the maximum of the whole tree.
+     */
+    if(p) {
+	for(; p; p = p->right) stack[tos++] = p;
+	c->tos = tos;
+	return stack[tos-1]->item;
+    }
+    if(!tos) return NULL;
+
+    /* Otherwise it is the nearest ancestor whose right subtree holds the
+     * current node.
+     */
+    while(tos > 1 && stack[tos-2]->left == stack[tos-1]) tos--;
+    if(tos == 1) return NULL;
+    c->tos = tos - 1;
+    return stack[tos-2]->item;
+}
+
+
 /*** Implement the universal dictionary structure type ***/
 
 /*** Binary search tree wrapper functions. ***/
 
 void *_bst_alloc(int (* compar)(const void *, const void *),
 		 unsigned int (* getval)(const void *)) {
-    return bst_alloc(compar);
+    return bst_alloc(compar, NULL);
 }
 
 void _bst_free(void *t) {
@@ -351,10 +620,42 @@ void *_bst_find(void *t, void *key_item) {
     return bst_find((bst_t *)t, key_item);
 }
 
+void _bst_find_many(void *t, void **key_items, void **items, int n) {
+    bst_find_many((bst_t *)t, key_items, items, n);
+}
+
 void *_bst_find_min(void *t) {
     return bst_find_min((bst_t *)t);
 }
 
+const opcount_t *_bst_counts(void *t) {
+    return &((bst_t *)t)->ops;
+}
+
+void *_bst_cursor_alloc(void *t) {
+    return bst_cursor_alloc((bst_t *)t);
+}
+
+void _bst_cursor_free(void *c) {
+    bst_cursor_free((bst_cursor_t *)c);
+}
+
+void *_bst_cursor_seek(void *c, void *key_item) {
+    return bst_cursor_seek((bst_cursor_t *)c, key_item);
+}
+
+void *_bst_cursor_next(void *c) {
+    return bst_cursor_next((bst_cursor_t *)c);
+}
+
+void *_bst_cursor_prev(void *c) {
+    return bst_cursor_prev((bst_cursor_t *)c);
+}
+
+void _bst_bulk_load(void *t, void **items, int n) {
+    bst_bulk_load((bst_t *)t, items, n);
+}
+
 /* Binary search tree info. */
 const dict_info_t BST_info = {
     _bst_alloc,
@@ -363,5 +664,13 @@ const dict_info_t BST_info = {
     _bst_delete,
     _bst_delete_min,
     _bst_find,
-    _bst_find_min
+    _bst_find_min,
+    _bst_counts,
+    _bst_cursor_alloc,
+    _bst_cursor_free,
+    _bst_cursor_seek,
+    _bst_cursor_next,
+    _bst_cursor_prev,
+    _bst_bulk_load,
+    _bst_find_many
 };
@@ -5,6 +5,7 @@
 #ifndef BST_H
 #define BST_H
 #include "dict_info.h"  /* Defines the universal dictionary structure type. */
+#include "pool.h"
 
 
 #define BST_STACK_SIZE 1000
@@ -16,22 +17,46 @@ typedef struct bst_node {
     struct bst_node *left, *right;
 } bst_node_t;
 
-/* Structure type for the binary search tree. */
+/* Structure type for the binary search tree.  ops counts the operations
+ * performed on the tree, for experimental purposes.  Nodes are allocated from
+ * pool, which is the tree's own pool if own_pool is 1.
+ */
 typedef struct bst {
     bst_node_t *root;
     int n;
     int (* compar)(const void *, const void *);
+    pool_t *pool;
+    int own_pool;
+    opcount_t ops;
 } bst_t;
 
+/* Structure type for a cursor on the binary search tree.  stack[0..tos-1]
+ * holds the path from the root to the node of the current item, and tos is 0
+ * when the cursor is past the last item.  The stack has room for stack_size
+ * nodes, which bst_cursor_seek() raises to the number of items in the tree,
+ * since the tree is not balanced.
+ */
+typedef struct bst_cursor {
+    bst_t *t;
+    bst_node_t **stack;
+    int stack_size;
+    int tos;
+} bst_cursor_t;
+
 
 /* bst_alloc() - Allocates space for a binary search tree and returns a pointer
  * to it.  The function compar compares they keys of two items, and returns a
  * negative, zero, or positive integer depending on whether the first item is
- * less than, equal to, or greater than the second.
+ * less than, equal to, or greater than the second.  Nodes are allocated from
+ * the pool pointed to by pool, which may be shared with other dictionaries, or
+ * from a new pool of the tree's own if pool is NULL.
  */
-bst_t *bst_alloc(int (* compar)(const void *, const void *));
+bst_t *bst_alloc(int (* compar)(const void *, const void *), pool_t *pool);
 
-/* bst_free() - Frees space used by the binary search tree pointed to by t. */
+/* bst_free() - Frees space used by the binary search tree pointed to by t.
+ * The nodes of a tree with its own pool are freed all at once, by freeing the
+ * pool.  Otherwise they are returned to the shared pool.
+ */
 void bst_free(bst_t *t);
 
 /* bst_insert() - Inserts an item into the binary search tree pointed to by t,
@@ -48,6 +73,14 @@ void *bst_insert(bst_t *t, void *item);
  */
 void *bst_find(bst_t *t, void *key_item);
 
+/* bst_find_many() - Finds the items in the binary search tree pointed to by t
+ * with the same keys as the n items pointed to by key_items[], and stores a
+ * pointer to each item found, or NULL, in items[].  The lookups are
+ * interleaved in groups of FIND_MANY_GROUP, with the next node of each
+ * prefetched, so that their cache misses overlap.
+ */
+void bst_find_many(bst_t *t, void **key_items, void **items, int n);
+
 /* bst_find_min() - Returns a pointer to the minimum item in the binary search
  * tree pointed to by t.  If there are no items in the tree a NULL pointer is
  * returned.
@@ -66,6 +99,42 @@ void *bst_delete(bst_t *t, void *key_item);
  */
 void *bst_delete_min(bst_t *t);
 
+/* bst_bulk_load() - Builds the binary search tree pointed to by t from the n
+ * items in the array items[], which must be in increasing order of key with no
+ * two keys equal.  An empty tree is built perfectly balanced, in O(n) time.
+ * If the binary search tree is not empty, the items are inserted one at a time
+ * instead.
+ */
+void bst_bulk_load(bst_t *t, void **items, int n);
+
+/* bst_cursor_alloc() - Returns a new cursor on the binary search tree pointed
+ * to by t.  The cursor must be positioned by bst_cursor_seek() before use, and
+ * again whenever the tree has been changed.
+ */
+bst_cursor_t *bst_cursor_alloc(bst_t *t);
+
+/* bst_cursor_free() - Frees space used by the cursor pointed to by c. */
+void bst_cursor_free(bst_cursor_t *c);
+
+/* bst_cursor_seek() - Moves the cursor pointed to by c to the first item
+ * with a key not less than that of the item pointed to by `key_item', or to
+ * the first item if key_item is NULL, and returns it.  If there is no such
+ * item, the cursor is moved past the last item and NULL is returned.
+ */
+void *bst_cursor_seek(bst_cursor_t *c, void *key_item);
+
+/* bst_cursor_next() - Moves the cursor pointed to by c to the next item and
+ * returns it.  If there is no next item, NULL is returned and the cursor is
+ * not moved.
+ */
+void *bst_cursor_next(bst_cursor_t *c);
+
+/* bst_cursor_prev() - Moves the cursor pointed to by c to the previous
+ * item, or to the last item if it is past the last item, and returns it.  If
+ * there is no such item, NULL is returned and the cursor is not moved.
+ */
+void *bst_cursor_prev(bst_cursor_t *c);
+
 /*** Alternative interface via the universal dictionary structure type. ***/
 extern const dict_info_t BST_info;
 
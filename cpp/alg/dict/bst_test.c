@@ -27,15 +27,28 @@ int item_cmp(const void *item1, const void *item2)
 }
 
 
+/* Compares the items pointed to by two elements of an array of item pointers,
+ * for sorting the array with qsort().
+ */
+int item_ptr_cmp(const void *p1, const void *p2)
+{
+    return item_cmp(*(test_item_t **)p1, *(test_item_t **)p2);
+}
+
+
 int main(void)
 {
     bst_t *t;
+    bst_cursor_t *c;
+    pool_t *pool;
     test_item_t item_array[N_ITEMS], *i, *i2, duplicate, lookup_item;
-    test_item_t *result;
+    test_item_t keys[N_ITEMS];
+    void *key_ptrs[N_ITEMS], *found[N_ITEMS];
+    test_item_t *result, *sorted[N_ITEMS];
     int j;
 
     /* Create a binary search tree. */
-    t = bst_alloc(item_cmp);
+    t = bst_alloc(item_cmp, NULL);
     
     /* Add some items to it. */    
     printf("Inserting items:\n");
@@ -76,6 +89,23 @@ int main(void)
 	printf("failed.\n");
     }
 
+    /* Test bst_find_many() against bst_find(), with every second key
+     * changed so that it may not be in the tree.
+     */
+    printf("Testing bst_find_many()...");
+    for(j = 0; j < N_ITEMS; j++) {
+	keys[j].data1 = item_array[j].data1 + j % 2;
+	key_ptrs[j] = &keys[j];
+    }
+    bst_find_many(t, key_ptrs, found, N_ITEMS);
+    for(j = 0; j < N_ITEMS; j++) {
+	if(found[j] != bst_find(t, key_ptrs[j])) {
+	    printf("failed.\n");
+	    exit(1);
+	}
+    }
+    printf("successful.\n");
+
     /* Test bst_find_min() */
     printf("Testing bst_find_min()...");
     result = bst_find_min(t);
@@ -104,7 +134,8 @@ int main(void)
     printf("successful.\n");
     
     /* Create a new tree then repeat bst_insert()/bst_delete(). */
-    t = bst_alloc(item_cmp);
+    pool = pool_alloc();  /* A shared pool, which nodes are returned to. */
+    t = bst_alloc(item_cmp, pool);
     printf("\nRepeating bst_insert()/bst_delete()...");
     for(j = 0; j < N_ITEMS; j++) {
 	i = &item_array[j];  /* Uniqueness of keys was enforced earlier. */
@@ -130,5 +161,57 @@ int main(void)
 
     bst_free(t);
     
+    /* Test bst_bulk_load() with the items in increasing order of key, then
+     * check that the result can be updated.
+     */
+    printf("\nTesting bst_bulk_load()...");
+    for(j = 0; j < N_ITEMS; j++) sorted[j] = &item_array[j];
+    qsort(sorted, N_ITEMS, sizeof(test_item_t *), item_ptr_cmp);
+    t = bst_alloc(item_cmp, NULL);
+    bst_bulk_load(t, (void **)sorted, N_ITEMS);
+    for(j = 0; j < N_ITEMS; j++) {
+	i = &item_array[j];
+	if(bst_find(t, i) != i) { printf("failed.\n"); exit(1); }
+    }
+    for(j = 0; j < N_ITEMS/2; j++) {
+	i = &item_array[j];
+	if(bst_delete(t, i) != i) { printf("failed.\n"); exit(1); }
+    }
+    for(j = 0; j < N_ITEMS/2; j++) {
+	i = &item_array[j];
+	bst_insert(t, i);
+    }
+    for(j = 0; j < N_ITEMS; j++) {
+	if(bst_delete_min(t) != sorted[j]) { printf("failed.\n"); exit(1); }
+    }
+    bst_free(t);
+    printf("successful.\n");
+
+    /* Test the cursor on a tree built by inserting the items in increasing
+     * order of key, which is a path much longer than BST_STACK_SIZE.  Seek
+     * the largest key, then step back to the first item and forward again.
+     */
+    printf("\nTesting bst cursor on a tree from sorted inserts...");
+    t = bst_alloc(item_cmp, pool);
+    for(j = 0; j < N_ITEMS; j++) bst_insert(t, sorted[j]);
+    c = bst_cursor_alloc(t);
+    if(bst_cursor_seek(c, sorted[N_ITEMS-1]) != sorted[N_ITEMS-1]) {
+	printf("failed.\n");
+	exit(1);
+    }
+    for(j = N_ITEMS - 2; j >= 0; j--) {
+	if(bst_cursor_prev(c) != sorted[j]) { printf("failed.\n"); exit(1); }
+    }
+    if(bst_cursor_prev(c)) { printf("failed.\n"); exit(1); }
+    for(j = 1; j < N_ITEMS; j++) {
+	if(bst_cursor_next(c) != sorted[j]) { printf("failed.\n"); exit(1); }
+    }
+    if(bst_cursor_next(c)) { printf("failed.\n"); exit(1); }
+    bst_cursor_free(c);
+    bst_free(t);
+    printf("successful.\n");
+
+    pool_free(pool);
+
     return 0;
 }
@@ -0,0 +1,206 @@
+/*** File: chash_test.c - Test program for the concurrent hash table ***/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "chashtbl.h"
+#include "hashtbl.h"
+#include "ebr.h"
+#include "bench_util.h"
+
+
+/* This program first checks the concurrent hash table, then measures its
+ * throughput against the hash table of hashtbl.h protected by a single mutex,
+ * with the runs of bench_run() in bench_util.h.  Both tables are sized for
+ * all of the keys, so that growing them is not timed.  Runs are made for read
+ * percentages 100, 90, 75 and 50, and for 1 up to the number of online
+ * processors, or a maximum number of threads given on the command line.
+ *
+ * Usage: chash_test [ops_per_thread [max_threads]]
+ */
+
+#define N_KEYS (1 << 20)
+
+
+/* Structure type for items. */
+typedef struct test_item {
+    int key;
+    int other_data;
+} test_item_t;
+
+/* The tables being compared. */
+#define CONCURRENT 0
+#define LOCKED 1
+char *table_desc[] = { "Concurrent", "Mutex+hash_tbl" };
+
+/* items[k] - the item with key k.  Items are never freed during a run, so
+ * they do not need to be reclaimed.
+ */
+test_item_t *items;
+
+
+/* Function to compare two items. */
+int compare_fn(const void *item1, const void *item2)
+{
+    return ((test_item_t *)item1)->key - ((test_item_t *)item2)->key;
+}
+
+/* Hash function to use. */
+unsigned long hash_fn(const void *item)
+{
+    return hash_mix((unsigned long)((test_item_t *)item)->key);
+}
+
+
+/* Table wrapper functions for bench_run(). */
+void *_chash_find(void *t, void *item) {
+    return chash_tbl_find((chash_tbl_t *)t, item);
+}
+
+void *_chash_insert(void *t, void *item) {
+    return chash_tbl_insert((chash_tbl_t *)t, item);
+}
+
+void *_chash_delete(void *t, void *item) {
+    return chash_tbl_delete((chash_tbl_t *)t, item);
+}
+
+void *_hash_find(void *t, void *item) {
+    return hash_tbl_find((hash_tbl_t *)t, item);
+}
+
+void *_hash_insert(void *t, void *item) {
+    return hash_tbl_insert((hash_tbl_t *)t, item);
+}
+
+void *_hash_delete(void *t, void *item) {
+    return hash_tbl_delete((hash_tbl_t *)t, item);
+}
+
+const bench_fns_t table_fns[] = {
+    { _chash_find, _chash_insert, _chash_delete, ebr_thread_exit },
+    { _hash_find, _hash_insert, _hash_delete, NULL }
+};
+
+
+/* Perform one run on the table selected by `table', with n_threads threads,
+ * and return the throughput in millions of operations per second.  For the
+ * concurrent table, the number of items is also checked against the items
+ * that can be found, and the number of errors is added to *errors.
+ */
+double run(bench_t *b, int table, int n_threads, int *errors)
+{
+    chash_tbl_t *ctbl;
+    hash_tbl_t *ltbl;
+    double mops;
+    int k, n;
+
+    b->fns = &table_fns[table];
+    b->locked = table == LOCKED;
+    if(table == CONCURRENT) {
+        b->t = ctbl = chash_tbl_alloc(N_KEYS, hash_fn, compare_fn);
+        for(k = 0; k < N_KEYS; k += 2) chash_tbl_insert(ctbl, &items[k]);
+    }
+    else {
+        b->t = ltbl = hash_tbl_alloc(N_KEYS, hash_fn, compare_fn);
+        for(k = 0; k < N_KEYS; k += 2) hash_tbl_insert(ltbl, &items[k]);
+    }
+
+    mops = bench_run(b, n_threads);
+
+    if(table == CONCURRENT) {
+        n = 0;
+        for(k = 0; k < N_KEYS; k++) {
+            if(chash_tbl_find(ctbl, &items[k]) == &items[k]) n++;
+        }
+        if(n != ctbl->n_items) (*errors)++;
+        ebr_thread_exit();
+        chash_tbl_free(ctbl);
+    }
+    else {
+        hash_tbl_free(ltbl);
+    }
+
+    return mops;
+}
+
+
+/* Check single threaded operation of the concurrent table, including growth
+ * from a small initial size.  Returns the number of errors.
+ */
+int check(void)
+{
+    chash_tbl_t *tbl;
+    test_item_t other;
+    int k, errors;
+
+    errors = 0;
+    tbl = chash_tbl_alloc(1, hash_fn, compare_fn);
+    for(k = 0; k < N_KEYS / 16; k++) {
+        if(chash_tbl_insert(tbl, &items[k])) errors++;
+    }
+    for(k = 0; k < N_KEYS / 16; k++) {
+        other.key = k;
+        if(chash_tbl_insert(tbl, &other) != &items[k]) errors++;
+        if(chash_tbl_find(tbl, &other) != &items[k]) errors++;
+    }
+    for(k = 1; k < N_KEYS / 16; k += 2) {
+        if(chash_tbl_delete(tbl, &items[k]) != &items[k]) errors++;
+    }
+    for(k = 0; k < N_KEYS / 16; k++) {
+        if(chash_tbl_find(tbl, &items[k]) != (k % 2 ? NULL : &items[k])) {
+            errors++;
+        }
+    }
+    if(tbl->n_items != N_KEYS / 32) errors++;
+
+    ebr_thread_exit();
+    chash_tbl_free(tbl);
+
+    return errors;
+}
+
+
+int main(int argc, char *argv[])
+{
+    static const int read_pcts[] = { 100, 90, 75, 50 };
+    bench_t b;
+    long n_ops;
+    int i, k, t, table, max_threads, errors;
+
+    n_ops = argc > 1 ? atol(argv[1]) : 1000000;
+    max_threads = argc > 2 ? atoi(argv[2])
+                           : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if(max_threads < 1) max_threads = 1;
+
+    items = malloc(N_KEYS * sizeof(test_item_t));
+    for(k = 0; k < N_KEYS; k++) {
+        items[k].key = k;
+        items[k].other_data = 0;
+    }
+
+    errors = check();
+    printf("Single threaded check: %s\n", errors ? "FAILED" : "passed");
+
+    printf("\nThroughput (million operations per second), %d keys, %ld "
+           "operations per thread\n", N_KEYS, n_ops);
+    printf("table,\t\treads,\tthreads,\tMops/s\n");
+    b.items = (char *)items;
+    b.item_size = sizeof(test_item_t);
+    b.n_keys = N_KEYS;
+    b.n_ops = n_ops;
+    for(i = 0; i < (int)(sizeof(read_pcts)/sizeof(int)); i++) {
+        b.read_pct = read_pcts[i];
+        for(table = CONCURRENT; table <= LOCKED; table++) {
+            for(t = 1; t <= max_threads; t++) {
+                printf("%s\t%d%%\t%d\t%.2f\n", table_desc[table],
+                       b.read_pct, t, run(&b, table, t, &errors));
+            }
+        }
+    }
+
+    if(errors) printf("\n%d errors\n", errors);
+    free(items);
+
+    return errors != 0;
+}
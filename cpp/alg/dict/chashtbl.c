@@ -0,0 +1,270 @@
+/*** File chashtbl.c - Concurrent Hash Table ***/
+#include <stdlib.h>
+#include "chashtbl.h"
+#include "ebr.h"
+
+
+
+/*** Prototypes of functions only visible within this file. ***/
+
+chash_array_t *chash_array_alloc(int n_buckets);
+void chash_array_free(void *p);
+chash_node_t *chash_tbl_search(chash_tbl_t *tbl, chash_array_t *array,
+                               const void *item, unsigned long hash);
+void chash_tbl_grow(chash_tbl_t *tbl, int old_n_buckets);
+
+
+
+/*** Definitions of functions visible outside of this file. ***/
+
+/* chash_tbl_alloc() - Returns a pointer to a concurrent hash table with space
+ * for at least n_items items before it first needs to grow.  Pointers to the
+ * following functions are required:
+ *     hash_fn - A hash function, which hashes the key of the item pointed to
+ *               by item to an unsigned long.
+ *     comp_fn - A comparison function.  Should returns zero only if item1 and
+ *               item2 have the same key.
+ */
+chash_tbl_t *chash_tbl_alloc(int n_items,
+                             unsigned long (*hash_fn)(const void *item),
+                             int (*comp_fn)(const void *item1,
+                                            const void *item2)
+                             )
+{
+    chash_tbl_t *tbl;
+    int i, n_buckets;
+
+    n_buckets = CHASH_TBL_STRIPES;
+    while(n_buckets * CHASH_TBL_MAX_LOAD < n_items) n_buckets *= 2;
+
+    tbl = malloc(sizeof(chash_tbl_t));
+    tbl->array = chash_array_alloc(n_buckets);
+    tbl->n_items = 0;
+    for(i = 0; i < CHASH_TBL_STRIPES; i++) {
+        pthread_mutex_init(&tbl->locks[i], NULL);
+    }
+    tbl->hash_fn = hash_fn;
+    tbl->compare_fn = comp_fn;
+
+    return tbl;
+}
+
+
+/* chash_tbl_free() - Frees up space used by the hash table pointed to by tbl.
+ * No other thread may be using the table.
+ */
+void chash_tbl_free(chash_tbl_t *tbl)
+{
+    int i;
+
+    for(i = 0; i < CHASH_TBL_STRIPES; i++) {
+        pthread_mutex_destroy(&tbl->locks[i]);
+    }
+    chash_array_free(tbl->array);
+    free(tbl);
+}
+
+
+/* chash_tbl_insert() - Insert the item pointed to by `item' into the hash
+ * table pointed to by tbl.  If an item with the same key already exists in
+ * the table, a pointer to that item is returned.  If the item was inserted
+ * successfully, NULL is returned.
+ */
+void *chash_tbl_insert(chash_tbl_t *tbl, void *item)
+{
+    unsigned long hash;
+    chash_array_t *array;
+    chash_node_t *node;
+    pthread_mutex_t *lock;
+    int i, n_buckets;
+
+    hash = tbl->hash_fn(item);
+    lock = &tbl->locks[hash & (CHASH_TBL_STRIPES - 1)];
+    pthread_mutex_lock(lock);
+
+    /* The array can only be replaced while all locks are held, so it is read
+     * after locking.
+     */
+    array = tbl->array;
+    node = chash_tbl_search(tbl, array, item, hash);
+    if(node) {
+        /* An item with this key already exists. */
+        pthread_mutex_unlock(lock);
+        return node->item;
+    }
+
+    i = (int)(hash & (array->n_buckets - 1));
+    node = malloc(sizeof(chash_node_t));
+    node->item = item;
+    node->hash = hash;
+    node->next = array->buckets[i];
+
+    /* The node must be complete before finds can reach it. */
+    __sync_synchronize();
+    array->buckets[i] = node;
+    n_buckets = array->n_buckets;
+    pthread_mutex_unlock(lock);
+
+    if(__sync_add_and_fetch(&tbl->n_items, 1) > n_buckets * CHASH_TBL_MAX_LOAD) {
+        chash_tbl_grow(tbl, n_buckets);
+    }
+
+    return NULL;
+}
+
+
+/* chash_tbl_find() - Returns a pointer to an item with the same key as `item'
+ * in the hash table pointed to by tbl.  If no matching item is found, NULL is
+ * returned.  This does not take any lock.
+ */
+void *chash_tbl_find(chash_tbl_t *tbl, void *item)
+{
+    chash_node_t *node;
+    void *found;
+
+    ebr_enter();
+    node = chash_tbl_search(tbl, tbl->array, item, tbl->hash_fn(item));
+    found = node ? node->item : NULL;
+    ebr_exit();
+
+    return found;
+}
+
+
+/* chash_tbl_delete() - Deletes an item with the same key as `item' from the
+ * hash table pointed to by tbl.  Returns a pointer to the item that was
+ * deleted from the hash table, or NULL if no item was deleted.
+ */
+void *chash_tbl_delete(chash_tbl_t *tbl, void *item)
+{
+    unsigned long hash;
+    chash_array_t *array;
+    chash_node_t *node, *volatile *prev_ptr;
+    pthread_mutex_t *lock;
+    void *found;
+
+    hash = tbl->hash_fn(item);
+    lock = &tbl->locks[hash & (CHASH_TBL_STRIPES - 1)];
+    pthread_mutex_lock(lock);
+
+    array = tbl->array;
+    prev_ptr = &array->buckets[hash & (array->n_buckets - 1)];
+    for(node = *prev_ptr; node; node = node->next) {
+        if(node->hash == hash && !tbl->compare_fn(node->item, item)) break;
+        prev_ptr = &node->next;
+    }
+    if(!node) {
+        pthread_mutex_unlock(lock);
+        return NULL;
+    }
+
+    /* Finds already on the node can still follow its next pointer, which is
+     * left unchanged.
+     */
+    *prev_ptr = node->next;
+    pthread_mutex_unlock(lock);
+
+    found = node->item;
+    __sync_sub_and_fetch(&tbl->n_items, 1);
+    ebr_retire(node, free);
+
+    return found;
+}
+
+
+
+/*** Definitions of functions that are only visible within this file. ***/
+
+/* chash_array_alloc() - returns a bucket array with n_buckets empty buckets.
+ */
+chash_array_t *chash_array_alloc(int n_buckets)
+{
+    chash_array_t *array;
+    int i;
+
+    array = malloc(sizeof(chash_array_t));
+    array->n_buckets = n_buckets;
+    array->buckets = malloc(n_buckets * sizeof(chash_node_t *));
+    for(i = 0; i < n_buckets; i++) array->buckets[i] = NULL;
+
+    return array;
+}
+
+
+/* chash_array_free() - frees the bucket array pointed to by p, and the nodes
+ * in its buckets.
+ */
+void chash_array_free(void *p)
+{
+    chash_array_t *array;
+    chash_node_t *node, *next;
+    int i;
+
+    array = p;
+    for(i = 0; i < array->n_buckets; i++) {
+        for(node = array->buckets[i]; node; node = next) {
+            next = node->next;
+            free(node);
+        }
+    }
+    free((void *)array->buckets);
+    free(array);
+}
+
+
+/* chash_tbl_search() - returns the node in the bucket array pointed to by
+ * array holding an item with the same key as the item pointed to by item,
+ * whose hash value is hash, or NULL if there is no such node.
+ */
+chash_node_t *chash_tbl_search(chash_tbl_t *tbl, chash_array_t *array,
+                               const void *item, unsigned long hash)
+{
+    chash_node_t *node;
+
+    node = array->buckets[hash & (array->n_buckets - 1)];
+    while(node) {
+        if(node->hash == hash && !tbl->compare_fn(node->item, item)) break;
+        node = node->next;
+    }
+
+    return node;
+}
+
+
+/* chash_tbl_grow() - doubles the number of buckets in the table pointed to by
+ * tbl, unless another thread has already grown it from old_n_buckets.
+ */
+void chash_tbl_grow(chash_tbl_t *tbl, int old_n_buckets)
+{
+    chash_array_t *old_array, *new_array;
+    chash_node_t *node, *copy;
+    int i, j;
+
+    for(i = 0; i < CHASH_TBL_STRIPES; i++) pthread_mutex_lock(&tbl->locks[i]);
+
+    old_array = tbl->array;
+    if(old_array->n_buckets == old_n_buckets) {
+        /* Copy the nodes, so that finds still walking the old array see it
+         * unchanged.
+         */
+        new_array = chash_array_alloc(old_n_buckets * 2);
+        for(i = 0; i < old_n_buckets; i++) {
+            for(node = old_array->buckets[i]; node; node = node->next) {
+                j = (int)(node->hash & (new_array->n_buckets - 1));
+                copy = malloc(sizeof(chash_node_t));
+                copy->item = node->item;
+                copy->hash = node->hash;
+                copy->next = new_array->buckets[j];
+                new_array->buckets[j] = copy;
+            }
+        }
+
+        __sync_synchronize();
+        tbl->array = new_array;
+        ebr_retire(old_array, chash_array_free);
+    }
+
+    for(i = CHASH_TBL_STRIPES - 1; i >= 0; i--) {
+        pthread_mutex_unlock(&tbl->locks[i]);
+    }
+}
@@ -0,0 +1,118 @@
+/*** File chashtbl.h - Concurrent Hash Table ***/
+#ifndef CHASHTBL_H
+#define CHASHTBL_H
+
+#include <pthread.h>
+
+/* A hash table which may be used by many threads at once.  It has the same
+ * item and compare function contract as the hash table in hashtbl.h.
+ *
+ * Items are kept in chains of nodes, one chain per bucket.  Finds do not take
+ * any lock.  They walk a chain while other threads may be changing it, so
+ * nodes are linked and unlinked with single pointer stores, and a node is only
+ * linked in after it has been completely filled in.  Inserts and deletes lock
+ * one of CHASH_TBL_STRIPES mutexes, chosen by the low bits of the hash value,
+ * so writers to different stripes do not block each other.  The number of
+ * buckets is always a multiple of the number of stripes, so every bucket is
+ * covered by exactly one stripe.
+ *
+ * When the table grows, all stripes are locked and a new bucket array is
+ * built with new nodes, leaving the old array unchanged for any finds still
+ * walking it.  Unlinked nodes and old bucket arrays are freed using the
+ * epoch-based reclamation of ebr.h, so no node is freed while a find could
+ * still be reading it.
+ *
+ * The table does not free items.  If a thread deletes an item while other
+ * threads may still be using a pointer to it returned by chash_tbl_find(),
+ * the item should be freed with ebr_retire(), and the other threads should
+ * use it only between ebr_enter() and ebr_exit().  Each thread that used the
+ * table should call ebr_thread_exit() before it exits.
+ */
+
+
+/*** Compile Time Options ***/
+
+/* The number of write locks.  Must be a power of 2. */
+#define CHASH_TBL_STRIPES 64
+
+/* The maximum average number of items per bucket before the table grows. */
+#define CHASH_TBL_MAX_LOAD 1.0
+
+
+
+/*** Structure Type Definitions. ***/
+
+/* A node in a bucket's chain, holding an item and its hash value. */
+typedef struct chash_node {
+    void *item;
+    unsigned long hash;
+    struct chash_node *volatile next;
+} chash_node_t;
+
+/* A bucket array:
+ *     n_buckets - the number of buckets, a power of 2.
+ *     buckets - an array of pointers to the first node of each bucket.
+ */
+typedef struct chash_array {
+    int n_buckets;
+    chash_node_t *volatile *buckets;
+} chash_array_t;
+
+/* Structure type definition for the concurrent hash table:
+ *     array - the current bucket array.
+ *     n_items - the number of items in the table.
+ *     locks - the stripe locks.  Bucket i is covered by lock
+ *             i % CHASH_TBL_STRIPES.
+ *     hash_fn - a pointer to the function for hashing an items key.
+ *     compare_fn - a pointer to the function for comparing items.
+ */
+typedef struct chash_tbl {
+    chash_array_t *volatile array;
+    volatile int n_items;
+    pthread_mutex_t locks[CHASH_TBL_STRIPES];
+    unsigned long (*hash_fn)(const void *item);
+    int (*compare_fn)(const void *item1, const void *item2);
+} chash_tbl_t;
+
+
+
+/* chash_tbl_alloc() - Returns a pointer to a concurrent hash table with space
+ * for at least n_items items before it first needs to grow.  Pointers to the
+ * following functions are required:
+ *     hash_fn - A hash function, which hashes the key of the item pointed to
+ *               by item to an unsigned long.  The low bits of the value are
+ *               used, so they should be well mixed.
+ *     comp_fn - A comparison function.  Should returns zero only if item1 and
+ *               item2 have the same key.
+ */
+chash_tbl_t *chash_tbl_alloc(int n_items,
+                             unsigned long (*hash_fn)(const void *item),
+                             int (*comp_fn)(const void *item1,
+                                            const void *item2)
+                             );
+
+/* chash_tbl_free() - Frees up space used by the hash table pointed to by tbl.
+ * No other thread may be using the table.
+ */
+void chash_tbl_free(chash_tbl_t *tbl);
+
+/* chash_tbl_insert() - Insert the item pointed to by `item' into the hash
+ * table pointed to by tbl.  If an item with the same key already exists in
+ * the table, a pointer to that item is returned.  If the item was inserted
+ * successfully, NULL is returned.
+ */
+void *chash_tbl_insert(chash_tbl_t *tbl, void *item);
+
+/* chash_tbl_find() - Returns a pointer to an item with the same key as `item'
+ * in the hash table pointed to by tbl.  If no matching item is found, NULL is
+ * returned.  This does not take any lock.
+ */
+void *chash_tbl_find(chash_tbl_t *tbl, void *item);
+
+/* chash_tbl_delete() - Deletes an item with the same key as `item' from the
+ * hash table pointed to by tbl.  Returns a pointer to the item that was
+ * deleted from the hash table, or NULL if no item was deleted.
+ */
+void *chash_tbl_delete(chash_tbl_t *tbl, void *item);
+
+#endif
@@ -0,0 +1,410 @@
+/*** File cskip_list.c - Concurrent Skip List ***/
+#include <stdlib.h>
+#include <math.h>
+#include "cskip_list.h"
+#include "ebr.h"
+
+
+/* Forward pointers are marked by setting their lowest bit. */
+#define MARKED(p) ((unsigned long)(p) & 1)
+#define MARK(p) ((cskip_node_t *)((unsigned long)(p) | 1))
+#define UNMARK(p) ((cskip_node_t *)((unsigned long)(p) & ~1UL))
+
+/* The size of a node with l forward pointers. */
+#define NODE_SIZE(l) \
+    (sizeof(cskip_node_t) + ((l) - 1) * sizeof(cskip_node_t *))
+
+
+
+/*** Variables Shared Between Functions in this File ***/
+
+/* The state of the calling thread's random number generator, or 0 if it has
+ * not been seeded.
+ */
+__thread unsigned long cskip_list_seed = 0;
+
+
+
+/*** Prototypes of functions only visible within this file. ***/
+
+int cskip_list_search(cskip_list_t *t, const void *item,
+                      cskip_node_t **preds, cskip_node_t **succs);
+cskip_node_t *cskip_list_first(cskip_list_t *t);
+int cskip_list_remove(cskip_list_t *t, cskip_node_t *node);
+void cskip_list_release(cskip_node_t *node);
+int cskip_list_rand_level(double p, int max_level);
+
+
+
+/*** Definitions of functions visible outside of this file. ***/
+
+/* cskip_list_alloc() - Allocates space for a concurrent skip list and returns
+ * a pointer to it.  The parameter, max_n, specifies the expected maximum
+ * number of nodes to be stored in the list. The parameter, prob, specifies
+ * the probability for height increase when generating random node heights.
+ * The function compar compares they keys of two items, and returns a
+ * negative, zero, or positive integer depending on whether the first item is
+ * less than, equal to, or greater than the second.
+ */
+cskip_list_t *cskip_list_alloc(int max_n, double prob,
+                               int (* compar)(const void *, const void *))
+{
+    cskip_list_t *t;
+    int i, max_level;
+
+    max_level = -log(max_n)/log(prob);
+    if(max_level < 1) max_level = 1;
+    if(max_level > CSKIP_LIST_MAX_LEVEL) max_level = CSKIP_LIST_MAX_LEVEL;
+
+    t = malloc(sizeof(cskip_list_t));
+    t->head = malloc(NODE_SIZE(max_level));
+    t->head->item = NULL;
+    t->head->size = max_level;
+    t->head->pending = 0;
+    for(i = 0; i < max_level; i++) t->head->forward[i] = NULL;
+    t->p = prob;
+    t->max_level = max_level;
+    t->compar = compar;
+    t->n = 0;
+
+    return t;
+}
+
+
+/* cskip_list_free() - Frees space used by the skip list pointed to by t.  No
+ * other thread may be using the list.
+ */
+void cskip_list_free(cskip_list_t *t)
+{
+    cskip_node_t *node, *next;
+
+    /* Deleted nodes have already been unlinked and retired, so only the nodes
+     * of items still in the list remain.
+     */
+    for(node = UNMARK(t->head->forward[0]); node; node = next) {
+        next = UNMARK(node->forward[0]);
+        free(node);
+    }
+    free(t->head);
+    free(t);
+}
+
+
+/* cskip_list_insert() - Inserts an item into the skip list pointed to by t,
+ * according the the value its key.  The key of an item in the skip list must
+ * be unique among items in the list.  If an item with the same key already
+ * exists in the list, a pointer to that item is returned.  Otherwise, NULL is
+ * returned, indicating insertion was successful.
+ */
+void *cskip_list_insert(cskip_list_t *t, void *item)
+{
+    cskip_node_t *preds[CSKIP_LIST_MAX_LEVEL], *succs[CSKIP_LIST_MAX_LEVEL];
+    cskip_node_t *node, *succ;
+    void *found;
+    int i, level;
+
+    level = cskip_list_rand_level(t->p, t->max_level);
+    node = malloc(NODE_SIZE(level));
+    node->item = item;
+    node->size = level;
+    node->pending = 2;  /* This insert, and the delete to come. */
+
+    ebr_enter();
+
+    /* Link the node in at level 0.  Once this succeeds the item is in the
+     * list.  The node is complete before the compare-and-swap, which is a
+     * full barrier, makes it reachable.
+     */
+    for(;;) {
+        if(cskip_list_search(t, item, preds, succs)) {
+            found = succs[0]->item;
+            ebr_exit();
+            free(node);
+            return found;
+        }
+        for(i = 0; i < level; i++) node->forward[i] = succs[i];
+        if(__sync_bool_compare_and_swap(&preds[0]->forward[0], succs[0],
+                                        node)) {
+            break;
+        }
+    }
+    __sync_add_and_fetch(&t->n, 1);
+
+    /* Link the node in at each higher level, searching again whenever the
+     * predecessor has changed.  A delete may mark the node at any time, after
+     * which its forward pointers cannot change and linking stops.
+     */
+    for(i = 1; i < level; i++) {
+        for(;;) {
+            succ = node->forward[i];
+            if(MARKED(succ)) goto end_link_loop;
+            if(succ != succs[i] &&
+               !__sync_bool_compare_and_swap(&node->forward[i], succ,
+                                             succs[i])) {
+                goto end_link_loop;
+            }
+            if(__sync_bool_compare_and_swap(&preds[i]->forward[i], succs[i],
+                                            node)) {
+                break;
+            }
+            cskip_list_search(t, item, preds, succs);
+            if(MARKED(node->forward[0])) goto end_link_loop;
+        }
+    }
+  end_link_loop:
+
+    /* If the node has been deleted, it may have been linked in at a level
+     * after the delete unlinked it.  Searching for it again unlinks it.
+     */
+    if(MARKED(node->forward[0])) cskip_list_search(t, item, preds, succs);
+    cskip_list_release(node);
+
+    ebr_exit();
+
+    return NULL;
+}
+
+
+/* cskip_list_find() - Find an item in the skip list with the same key as the
+ * item pointed to by `key_item'.  Returns a pointer to the item found, or NULL
+ * if no item was found.  This does not change the list.
+ */
+void *cskip_list_find(cskip_list_t *t, void *key_item)
+{
+    int (* compar)(const void *, const void *);
+    cskip_node_t *pred, *curr, *succ;
+    void *found;
+    int i;
+
+    compar = t->compar;
+    ebr_enter();
+
+    /* Marked nodes are stepped over rather than unlinked. */
+    pred = t->head;
+    curr = NULL;
+    for(i = t->max_level - 1; i >= 0; i--) {
+        curr = UNMARK(pred->forward[i]);
+        while(curr) {
+            succ = curr->forward[i];
+            if(MARKED(succ)) {
+                curr = UNMARK(succ);
+                continue;
+            }
+            if(compar(curr->item, key_item) >= 0) break;
+            pred = curr;
+            curr = succ;
+        }
+    }
+    found = curr && compar(curr->item, key_item) == 0 ? curr->item : NULL;
+
+    ebr_exit();
+
+    return found;
+}
+
+
+/* cskip_list_find_min() - Returns a pointer to the minimum item in the skip
+ * list pointed to by t.  If there are no items in the list a NULL pointer is
+ * returned.
+ */
+void *cskip_list_find_min(cskip_list_t *t)
+{
+    cskip_node_t *node;
+    void *found;
+
+    ebr_enter();
+    node = cskip_list_first(t);
+    found = node ? node->item : NULL;
+    ebr_exit();
+
+    return found;
+}
+
+
+/* cskip_list_delete() - Delete the item in the skip list with the same key as
+ * the item pointed to by `key_item'.  Returns a pointer to the deleted item,
+ * and NULL if no item was found.
+ */
+void *cskip_list_delete(cskip_list_t *t, void *key_item)
+{
+    cskip_node_t *preds[CSKIP_LIST_MAX_LEVEL], *succs[CSKIP_LIST_MAX_LEVEL];
+    void *found;
+
+    ebr_enter();
+
+    /* If another thread deletes the node first, the item was not in the list
+     * from that point on.
+     */
+    found = NULL;
+    if(cskip_list_search(t, key_item, preds, succs) &&
+       cskip_list_remove(t, succs[0])) {
+        found = succs[0]->item;
+    }
+
+    ebr_exit();
+
+    return found;
+}
+
+
+/* cskip_list_delete_min() - Deletes the item with the smallest key from the
+ * skip list pointed to by t.  Returns a pointer to the deleted item.  Returns
+ * a NULL pointer if there are no items in the list.
+ */
+void *cskip_list_delete_min(cskip_list_t *t)
+{
+    cskip_node_t *node;
+    void *found;
+
+    ebr_enter();
+
+    /* Retry while other threads delete the first node first. */
+    while((node = cskip_list_first(t)) && !cskip_list_remove(t, node)) ;
+    found = node ? node->item : NULL;
+
+    ebr_exit();
+
+    return found;
+}
+
+
+
+/*** Definitions of functions that are only visible within this file. ***/
+
+/* cskip_list_search() - searches the skip list pointed to by t for the item
+ * pointed to by item, unlinking any marked nodes on the way.  On return,
+ * succs[i] is the first node at level i whose key is not less than that of
+ * item, or NULL, and preds[i] is the node before it.  Returns non-zero if
+ * succs[0] has the same key as item.  Must be called between ebr_enter() and
+ * ebr_exit().
+ */
+int cskip_list_search(cskip_list_t *t, const void *item,
+                      cskip_node_t **preds, cskip_node_t **succs)
+{
+    int (* compar)(const void *, const void *);
+    cskip_node_t *pred, *curr, *succ;
+    int i, cmp_result;
+
+    compar = t->compar;
+
+  retry:
+    pred = t->head;
+    curr = NULL;
+    cmp_result = 1;
+    for(i = t->max_level - 1; i >= 0; i--) {
+        curr = UNMARK(pred->forward[i]);
+        for(;;) {
+            if(!curr) {
+                cmp_result = 1;
+                break;
+            }
+            succ = curr->forward[i];
+            if(MARKED(succ)) {
+                /* This fails if pred has itself been marked, or another node
+                 * has been linked in after it.
+                 */
+                if(!__sync_bool_compare_and_swap(&pred->forward[i], curr,
+                                                 UNMARK(succ))) {
+                    goto retry;
+                }
+                curr = UNMARK(succ);
+                continue;
+            }
+            if((cmp_result = compar(curr->item, item)) >= 0) break;
+            pred = curr;
+            curr = succ;
+        }
+        preds[i] = pred;
+        succs[i] = curr;
+    }
+
+    return cmp_result == 0;
+}
+
+
+/* cskip_list_first() - returns the first node in the skip list pointed to by
+ * t which is not marked, or NULL if there is none.  Must be called between
+ * ebr_enter() and ebr_exit().
+ */
+cskip_node_t *cskip_list_first(cskip_list_t *t)
+{
+    cskip_node_t *node;
+
+    node = UNMARK(t->head->forward[0]);
+    while(node && MARKED(node->forward[0])) node = UNMARK(node->forward[0]);
+
+    return node;
+}
+
+
+/* cskip_list_remove() - deletes the node pointed to by node from the skip list
+ * pointed to by t, by marking its forward pointers from the top level down.
+ * Returns non-zero if the calling thread marked its level 0 pointer, and zero
+ * if another thread did.  Must be called between ebr_enter() and ebr_exit().
+ */
+int cskip_list_remove(cskip_list_t *t, cskip_node_t *node)
+{
+    cskip_node_t *preds[CSKIP_LIST_MAX_LEVEL], *succs[CSKIP_LIST_MAX_LEVEL];
+    cskip_node_t *succ;
+    int i;
+
+    for(i = node->size - 1; i > 0; i--) {
+        do {
+            succ = node->forward[i];
+        } while(!MARKED(succ) &&
+                !__sync_bool_compare_and_swap(&node->forward[i], succ,
+                                              MARK(succ)));
+    }
+
+    do {
+        succ = node->forward[0];
+        if(MARKED(succ)) return 0;
+    } while(!__sync_bool_compare_and_swap(&node->forward[0], succ,
+                                          MARK(succ)));
+    __sync_sub_and_fetch(&t->n, 1);
+
+    /* Unlink the node at every level. */
+    cskip_list_search(t, node->item, preds, succs);
+    cskip_list_release(node);
+
+    return 1;
+}
+
+
+/* cskip_list_release() - marks the node pointed to by node as finished with by
+ * its insert or delete, and retires it if both have finished.  The node must
+ * be unlinked at every level by then.
+ */
+void cskip_list_release(cskip_node_t *node)
+{
+    if(__sync_sub_and_fetch(&node->pending, 1) == 0) ebr_retire(node, free);
+}
+
+
+/* cskip_list_rand_level() - Returns a random level, based on the probability,
+ * p, and the maximum level allowed, max_level.  Each thread has its own
+ * xorshift generator, since rand() is not safe to share.
+ */
+int cskip_list_rand_level(double p, int max_level)
+{
+    unsigned long rand_mark;
+    int i;
+
+    /* Seed from the address of the thread's own seed, which differs between
+     * threads.
+     */
+    if(!cskip_list_seed) {
+        cskip_list_seed = (unsigned long)&cskip_list_seed;
+        cskip_list_seed = cskip_list_seed * 0x9e3779b97f4a7c15UL | 1;
+    }
+
+    rand_mark = p * 4294967295.0;
+    for(i = 1; i < max_level; i++) {
+        cskip_list_seed ^= cskip_list_seed << 13;
+        cskip_list_seed ^= cskip_list_seed >> 7;
+        cskip_list_seed ^= cskip_list_seed << 17;
+        if((cskip_list_seed >> 32) > rand_mark) break;
+    }
+
+    return i;
+}
@@ -0,0 +1,127 @@
+/*** File cskip_list.h - Concurrent Skip List ***/
+#ifndef CSKIP_LIST_H
+#define CSKIP_LIST_H
+
+/* A skip list which may be used by many threads at once.  It has the same
+ * item and compare function contract as the skip list in skip_list.h.
+ *
+ * No operation takes a lock.  Each node has one forward pointer per level,
+ * and the lowest bit of a forward pointer is used as a mark, meaning that the
+ * node holding it is being deleted.  A delete first marks the node's forward
+ * pointers from the top level down.  Marking the level 0 pointer removes the
+ * item from the list, and only one thread can do this for a node.  Marked
+ * nodes are then unlinked, at every level, by any search that passes them.
+ * An insert links a node in at level 0 first, which adds the item to the
+ * list, and then links it in at each higher level in turn, giving up if the
+ * node is marked meanwhile.
+ *
+ * Searches keep their path through the list in local arrays, so unlike
+ * skip_list_t there is no shared update array.  Nodes are taken from malloc(),
+ * since a pool is not safe for use by several threads.  A node is freed using
+ * the epoch-based reclamation of ebr.h once both the insert and the delete
+ * that handled it have finished and it has been unlinked at every level.
+ *
+ * The list does not free items.  If a thread deletes an item while other
+ * threads may still be using a pointer to it returned by cskip_list_find(),
+ * the item should be freed with ebr_retire(), and the other threads should
+ * use it only between ebr_enter() and ebr_exit().  Each thread that used the
+ * list should call ebr_thread_exit() before it exits.
+ */
+
+
+/*** Compile Time Options ***/
+
+/* The largest number of levels any list may have. */
+#define CSKIP_LIST_MAX_LEVEL 32
+
+
+
+/*** Structure Type Definitions. ***/
+
+/* Structure type for concurrent skip list nodes.
+ *     item - the node's item.
+ *     size - the number of forward pointers the node has.
+ *     pending - the number of the node's insert and delete operations which
+ *               are still to finish with the node.  The node is retired by
+ *               the operation which reduces it to zero.
+ *     forward - the forward pointers, each possibly marked.  The array is
+ *               allocated with the node, and extends past the end of the
+ *               structure when it has more than one entry.
+ */
+typedef struct cskip_node {
+    void *item;
+    int size;
+    volatile int pending;
+    struct cskip_node *volatile forward[1];
+} cskip_node_t;
+
+/* Structure type definition for a concurrent skip list.
+ *     head - a node without an item, whose forward pointers are the head
+ *            pointers of the list.  It has max_level forward pointers.
+ *     p - the probability with which a node is given each level above its
+ *         first.
+ *     max_level - the number of levels in the list.
+ *     compar - a function for comparing items in the list.
+ *     n - the number of items currently stored in the list.
+ */
+typedef struct cskip_list {
+    cskip_node_t *head;
+    double p;
+    int max_level;
+    int (* compar)(const void *, const void *);
+    volatile int n;
+} cskip_list_t;
+
+
+
+/*** Function prototypes. ***/
+
+/* cskip_list_alloc() - Allocates space for a concurrent skip list and returns
+ * a pointer to it.  The parameter, max_n, specifies the expected maximum
+ * number of nodes to be stored in the list. The parameter, prob, specifies
+ * the probability for height increase when generating random node heights.
+ * The function compar compares they keys of two items, and returns a
+ * negative, zero, or positive integer depending on whether the first item is
+ * less than, equal to, or greater than the second.
+ */
+cskip_list_t *cskip_list_alloc(int max_n, double prob,
+                               int (* compar)(const void *, const void *));
+
+/* cskip_list_free() - Frees space used by the skip list pointed to by t.  No
+ * other thread may be using the list.
+ */
+void cskip_list_free(cskip_list_t *t);
+
+/* cskip_list_insert() - Inserts an item into the skip list pointed to by t,
+ * according the the value its key.  The key of an item in the skip list must
+ * be unique among items in the list.  If an item with the same key already
+ * exists in the list, a pointer to that item is returned.  Otherwise, NULL is
+ * returned, indicating insertion was successful.
+ */
+void *cskip_list_insert(cskip_list_t *t, void *item);
+
+/* cskip_list_find() - Find an item in the skip list with the same key as the
+ * item pointed to by `key_item'.  Returns a pointer to the item found, or NULL
+ * if no item was found.  This does not change the list.
+ */
+void *cskip_list_find(cskip_list_t *t, void *key_item);
+
+/* cskip_list_find_min() - Returns a pointer to the minimum item in the skip
+ * list pointed to by t.  If there are no items in the list a NULL pointer is
+ * returned.
+ */
+void *cskip_list_find_min(cskip_list_t *t);
+
+/* cskip_list_delete() - Delete the item in the skip list with the same key as
+ * the item pointed to by `key_item'.  Returns a pointer to the deleted item,
+ * and NULL if no item was found.
+ */
+void *cskip_list_delete(cskip_list_t *t, void *key_item);
+
+/* cskip_list_delete_min() - Deletes the item with the smallest key from the
+ * skip list pointed to by t.  Returns a pointer to the deleted item.  Returns
+ * a NULL pointer if there are no items in the list.
+ */
+void *cskip_list_delete_min(cskip_list_t *t);
+
+#endif
@@ -0,0 +1,267 @@
+/*** File: cskip_test.c - Test program for the concurrent skip list ***/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "cskip_list.h"
+#include "skip_list.h"
+#include "ebr.h"
+#include "bench_util.h"
+
+
+/* This program first checks the concurrent skip list, then measures its
+ * throughput against the skip list of skip_list.h protected by a single
+ * mutex, with the runs of bench_run() in bench_util.h.
+ *
+ * The checks are made with one thread, and then with CHECK_THREADS threads
+ * inserting, finding and deleting at once, after which the contents of the
+ * list are compared with what they should be.  Throughput runs are made for
+ * read percentages 100, 90, 50 and 0, and for 1 up to the number of online
+ * processors, or a maximum number of threads given on the command line.
+ *
+ * Usage: cskip_test [ops_per_thread [max_threads]]
+ */
+
+#define N_KEYS (1 << 20)
+#define CHECK_THREADS 4
+
+
+/* Structure type for items. */
+typedef struct test_item {
+    int key;
+    int other_data;
+} test_item_t;
+
+/* The lists being compared. */
+#define CONCURRENT 0
+#define LOCKED 1
+char *list_desc[] = { "Concurrent", "Mutex+skip_list" };
+
+/* items[k] - the item with key k.  Items are never freed during a run, so
+ * they do not need to be reclaimed.
+ */
+test_item_t *items;
+
+
+/* Function to compare two items. */
+int compar(const void *item1, const void *item2)
+{
+    return ((test_item_t *)item1)->key - ((test_item_t *)item2)->key;
+}
+
+
+/* List wrapper functions for bench_run(). */
+void *_cskip_find(void *t, void *item) {
+    return cskip_list_find((cskip_list_t *)t, item);
+}
+
+void *_cskip_insert(void *t, void *item) {
+    return cskip_list_insert((cskip_list_t *)t, item);
+}
+
+void *_cskip_delete(void *t, void *item) {
+    return cskip_list_delete((cskip_list_t *)t, item);
+}
+
+void *_skip_find(void *t, void *item) {
+    return skip_list_find((skip_list_t *)t, item);
+}
+
+void *_skip_insert(void *t, void *item) {
+    return skip_list_insert((skip_list_t *)t, item);
+}
+
+void *_skip_delete(void *t, void *item) {
+    return skip_list_delete((skip_list_t *)t, item);
+}
+
+const bench_fns_t list_fns[] = {
+    { _cskip_find, _cskip_insert, _cskip_delete, ebr_thread_exit },
+    { _skip_find, _skip_insert, _skip_delete, NULL }
+};
+
+
+/* Perform one run on the list selected by `list', with n_threads threads,
+ * and return the throughput in millions of operations per second.  For the
+ * concurrent list, the number of items is also checked against the items
+ * that can be found, and the number of errors is added to *errors.
+ */
+double run(bench_t *b, int list, int n_threads, int *errors)
+{
+    cskip_list_t *clist;
+    skip_list_t *llist;
+    double mops;
+    int k, n;
+
+    b->fns = &list_fns[list];
+    b->locked = list == LOCKED;
+    if(list == CONCURRENT) {
+        b->t = clist = cskip_list_alloc(N_KEYS, 0.5, compar);
+        for(k = 0; k < N_KEYS; k += 2) cskip_list_insert(clist, &items[k]);
+    }
+    else {
+        b->t = llist = skip_list_alloc(N_KEYS, 0.5, compar, NULL);
+        for(k = 0; k < N_KEYS; k += 2) skip_list_insert(llist, &items[k]);
+    }
+
+    mops = bench_run(b, n_threads);
+
+    if(list == CONCURRENT) {
+        n = 0;
+        for(k = 0; k < N_KEYS; k++) {
+            if(cskip_list_find(clist, &items[k]) == &items[k]) n++;
+        }
+        if(n != clist->n) (*errors)++;
+        ebr_thread_exit();
+        cskip_list_free(clist);
+    }
+    else {
+        skip_list_free(llist);
+    }
+
+    return mops;
+}
+
+
+/* Thread id of the concurrent check.  Inserts the keys k with
+ * k % CHECK_THREADS == id, in random order, while finding other keys, and then
+ * deletes those of its keys with (k / CHECK_THREADS) odd.
+ */
+void *check_worker(void *p)
+{
+    bench_thread_t *arg;
+    cskip_list_t *clist;
+    int i, j, n, tmp, *keys;
+
+    arg = p;
+    clist = arg->shared;
+    n = N_KEYS / 16 / CHECK_THREADS;
+    keys = malloc(n * sizeof(int));
+    for(i = 0; i < n; i++) keys[i] = i * CHECK_THREADS + arg->id;
+    for(i = n - 1; i > 0; i--) {
+        j = (int)(next_rand(&arg->seed) % (i + 1));
+        tmp = keys[i];  keys[i] = keys[j];  keys[j] = tmp;
+    }
+
+    for(i = 0; i < n; i++) {
+        if(cskip_list_insert(clist, &items[keys[i]])) arg->errors++;
+        if(cskip_list_find(clist, &items[keys[i]]) != &items[keys[i]]) {
+            arg->errors++;
+        }
+        if(cskip_list_find(clist, &items[next_rand(&arg->seed)
+                                         % (N_KEYS / 16)])) {
+            arg->found++;
+        }
+    }
+    for(i = 0; i < n; i++) {
+        if(keys[i] / CHECK_THREADS % 2) {
+            if(cskip_list_delete(clist, &items[keys[i]]) != &items[keys[i]]) {
+                arg->errors++;
+            }
+            if(cskip_list_find(clist, &items[keys[i]])) arg->errors++;
+        }
+    }
+
+    free(keys);
+    ebr_thread_exit();
+    return NULL;
+}
+
+
+/* Check operation of the concurrent list, first with one thread and then with
+ * CHECK_THREADS threads.  Returns the number of errors.
+ */
+int check(void)
+{
+    cskip_list_t *clist;
+    test_item_t other, *item;
+    int k, errors;
+
+    errors = 0;
+    clist = cskip_list_alloc(N_KEYS / 16, 0.5, compar);
+    for(k = N_KEYS / 16 - 1; k >= 0; k--) {
+        if(cskip_list_insert(clist, &items[k])) errors++;
+    }
+    for(k = 0; k < N_KEYS / 16; k++) {
+        other.key = k;
+        if(cskip_list_insert(clist, &other) != &items[k]) errors++;
+        if(cskip_list_find(clist, &other) != &items[k]) errors++;
+    }
+    for(k = 1; k < N_KEYS / 16; k += 2) {
+        if(cskip_list_delete(clist, &items[k]) != &items[k]) errors++;
+        if(cskip_list_delete(clist, &items[k])) errors++;
+    }
+    for(k = 0; k < N_KEYS / 16; k++) {
+        if(cskip_list_find(clist, &items[k]) != (k % 2 ? NULL : &items[k])) {
+            errors++;
+        }
+    }
+    if(clist->n != N_KEYS / 32) errors++;
+    if(cskip_list_find_min(clist) != &items[0]) errors++;
+    for(k = 0; k < N_KEYS / 16; k += 2) {
+        if(cskip_list_delete_min(clist) != &items[k]) errors++;
+    }
+    if(cskip_list_delete_min(clist) || clist->n != 0) errors++;
+    cskip_list_free(clist);
+
+    clist = cskip_list_alloc(N_KEYS / 16, 0.5, compar);
+    errors += bench_threads(CHECK_THREADS, check_worker, clist);
+
+    /* Items must come out in order, and be exactly those not deleted. */
+    for(k = 0; k < N_KEYS / 16; k++) {
+        if(k / CHECK_THREADS % 2) continue;
+        item = cskip_list_delete_min(clist);
+        if(item != &items[k]) errors++;
+    }
+    if(cskip_list_delete_min(clist) || clist->n != 0) errors++;
+
+    ebr_thread_exit();
+    cskip_list_free(clist);
+
+    return errors;
+}
+
+
+int main(int argc, char *argv[])
+{
+    static const int read_pcts[] = { 100, 90, 50, 0 };
+    bench_t b;
+    long n_ops;
+    int i, k, t, list, max_threads, errors;
+
+    n_ops = argc > 1 ? atol(argv[1]) : 1000000;
+    max_threads = argc > 2 ? atoi(argv[2])
+                           : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if(max_threads < 1) max_threads = 1;
+
+    items = malloc(N_KEYS * sizeof(test_item_t));
+    for(k = 0; k < N_KEYS; k++) {
+        items[k].key = k;
+        items[k].other_data = 0;
+    }
+
+    errors = check();
+    printf("Check: %s\n", errors ? "FAILED" : "passed");
+
+    printf("\nThroughput (million operations per second), %d keys, %ld "
+           "operations per thread\n", N_KEYS, n_ops);
+    printf("list,\t\treads,\tthreads,\tMops/s\n");
+    b.items = (char *)items;
+    b.item_size = sizeof(test_item_t);
+    b.n_keys = N_KEYS;
+    b.n_ops = n_ops;
+    for(i = 0; i < (int)(sizeof(read_pcts)/sizeof(int)); i++) {
+        b.read_pct = read_pcts[i];
+        for(list = CONCURRENT; list <= LOCKED; list++) {
+            for(t = 1; t <= max_threads; t++) {
+                printf("%s\t%d%%\t%d\t%.2f\n", list_desc[list],
+                       b.read_pct, t, run(&b, list, t, &errors));
+            }
+        }
+    }
+
+    if(errors) printf("\n%d errors\n", errors);
+    free(items);
+
+    return errors != 0;
+}
@@ -0,0 +1,523 @@
+/*** File: dict_bench.c - Workload driven benchmark for the dictionaries ***/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <math.h>
+#include <time.h>
+#include "bst.h"
+#include "avl.h"
+#include "tree23.h"
+#include "rbtree.h"
+#include "dst.h"
+#include "rst.h"
+#include "bptree.h"
+#include "skip_list.h"
+#include "art.h"
+#include "hashtbl.h"
+#include "bench_util.h"
+
+
+/* This program measures the dictionaries under a range of workloads.  Each
+ * run fills a dictionary with a working set of n items, whose keys are every
+ * second key in the range 0..2n-1, and then performs a mix of operations on
+ * keys drawn from a key distribution:
+ *
+ *     uniform - keys chosen uniformly at random.
+ *     zipf - keys chosen with a Zipfian distribution with parameter
+ *            ZIPF_THETA, so that a few keys are used far more often than the
+ *            rest.  The popular keys are scattered over the key range.
+ *     seq - keys taken in increasing order, wrapping around at the end of the
+ *           key range.
+ *     sorted - as for seq, but the working set is also inserted in increasing
+ *              order of key.  This is the worst case for unbalanced trees.
+ *
+ * The operation mixes are:
+ *     read - 90% finds, 5% inserts and 5% deletes.
+ *     write - 10% finds, 45% inserts and 45% deletes.
+ *     queue - 50% inserts and 50% delete_min() calls, as in a priority queue.
+ *             Dictionaries without delete_min() are skipped.
+ *
+ * The default working set sizes range from fitting in the first level cache
+ * to needing main memory.  Every LATENCY_SAMPLE'th operation is timed on its
+ * own, giving latency percentiles in nanoseconds, with the cost of reading
+ * the clock taken off.  Throughput is over all operations.  A run is stopped
+ * after TIME_LIMIT seconds of filling or of operations, which is reported in
+ * its status.
+ *
+ * Alongside the dictionaries of dict_test, the hash table of hashtbl.h is
+ * measured through wrappers below.
+ *
+ * Usage: dict_bench [-b dicts] [-d dists] [-m mixes] [-n sizes] [-o ops]
+ *                   [-t seconds] [-f text|csv|json]
+ * where dicts, dists, mixes and sizes are comma separated lists, such as
+ * "-b RB,ART -n 1000,1000000".  By default all are run.  CSV and JSON output
+ * includes the date, so that results of separate runs can be compared.
+ */
+
+#define LATENCY_SAMPLE 8
+#define TIME_LIMIT 10.0
+#define ZIPF_THETA 0.99
+
+
+/* Structure type for items. */
+typedef struct test_item {
+    int key;
+    int other_data;
+} test_item_t;
+
+/* Function to compare two items. */
+int item_cmp(const void *item1, const void *item2)
+{
+    return ((test_item_t *)item1)->key - ((test_item_t *)item2)->key;
+}
+
+unsigned int item_val(const void *item)
+{
+    return ((test_item_t *)item)->key;
+}
+
+/* Hash function for the hash table. */
+unsigned long item_hash(const void *item)
+{
+    return hash_mix((unsigned long)((test_item_t *)item)->key);
+}
+
+
+/*** Hash table wrapper functions. ***/
+
+/* The hash table grows as needed, so it starts small. */
+void *_hash_alloc(int (* compar)(const void *, const void *),
+                  unsigned int (* getval)(const void *)) {
+    return hash_tbl_alloc(16, item_hash, compar);
+}
+
+void _hash_free(void *t) {
+    hash_tbl_free((hash_tbl_t *)t);
+}
+
+void *_hash_insert(void *t, void *item) {
+    return hash_tbl_insert((hash_tbl_t *)t, item);
+}
+
+void *_hash_delete(void *t, void *key_item) {
+    return hash_tbl_delete((hash_tbl_t *)t, key_item);
+}
+
+void *_hash_find(void *t, void *key_item) {
+    return hash_tbl_find((hash_tbl_t *)t, key_item);
+}
+
+const dict_info_t HASH_info = {
+    _hash_alloc, _hash_free, _hash_insert, _hash_delete,
+    NULL,  /* The table is not ordered, so there is no delete_min(). */
+    _hash_find,
+    NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL
+};
+
+
+/* The dictionaries measured. */
+typedef struct dict_desc {
+    char *name;
+    const dict_info_t *fns;
+} dict_desc_t;
+
+dict_desc_t dicts[] = {
+    { "bst", &BST_info },
+    { "avl", &AVL_info },
+    { "23", &TREE23_info },
+    { "RB", &RBTREE_info },
+    { "dst", &DST_info },
+    { "rst", &RST_info },
+    { "B+", &BPTREE_info },
+    { "skip", &SKIP_LIST_info },
+    { "ART", &ART_info },
+    { "hash", &HASH_info },
+};
+#define N_DICTS ((int)(sizeof(dicts) / sizeof(dict_desc_t)))
+
+/* Key distributions. */
+#define UNIFORM 0
+#define ZIPF 1
+#define SEQ 2
+#define SORTED 3
+char *dist_names[] = { "uniform", "zipf", "seq", "sorted" };
+#define N_DISTS 4
+
+/* Operation mixes, as percentages of finds, inserts, deletes and delete_min()
+ * calls.
+ */
+#define FIND 0
+#define INSERT 1
+#define DELETE 2
+#define DELETE_MIN 3
+typedef struct mix {
+    char *name;
+    int pct[4];
+} mix_t;
+
+mix_t mixes[] = {
+    { "read", { 90, 5, 5, 0 } },
+    { "write", { 10, 45, 45, 0 } },
+    { "queue", { 0, 50, 0, 50 } },
+};
+#define N_MIXES ((int)(sizeof(mixes) / sizeof(mix_t)))
+
+/* Working set sizes, from the first level cache to main memory. */
+int default_sizes[] = { 1000, 30000, 1000000 };
+
+
+/* The state of a key generator:
+ *     dist - the key distribution.
+ *     n_keys - keys are in the range 0..n_keys-1.
+ *     seed - the state of the random number generator.
+ *     next - the next key for the seq and sorted distributions.
+ *     zetan, eta, alpha, half_pow_theta - constants of the Zipfian
+ *                                         distribution.
+ */
+typedef struct keygen {
+    int dist;
+    int n_keys;
+    unsigned long seed;
+    long next;
+    double zetan, eta, alpha, half_pow_theta;
+} keygen_t;
+
+/* The result of a run. */
+typedef struct result {
+    long ops;
+    double ops_per_sec;
+    double p50, p90, p99, p999, max;
+    char *status;
+} result_t;
+
+/* The cost of reading the clock, in nanoseconds. */
+double clock_cost;
+
+/* Sum of the item keys returned, which keeps operations from being optimised
+ * away.
+ */
+long sink;
+
+
+/* Return a random number in the range [0, 1). */
+double next_unit(unsigned long *s)
+{
+    return (next_rand(s) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/* Compare two doubles, for sorting with qsort(). */
+int double_cmp(const void *p1, const void *p2)
+{
+    double d1 = *(const double *)p1, d2 = *(const double *)p2;
+    return d1 < d2 ? -1 : d1 > d2;
+}
+
+
+/* Set up the key generator pointed to by g.  The Zipfian distribution is
+ * that of Gray et al., "Quickly generating billion-record synthetic
+ * databases", SIGMOD 1994.
+ */
+void keygen_init(keygen_t *g, int dist, int n_keys, unsigned long seed)
+{
+    double zeta2;
+    int i;
+
+    g->dist = dist;
+    g->n_keys = n_keys;
+    g->seed = seed;
+    g->next = 0;
+    if(dist == ZIPF) {
+        g->zetan = 0;
+        for(i = 1; i <= n_keys; i++) g->zetan += 1.0 / pow(i, ZIPF_THETA);
+        zeta2 = 1.0 + 1.0 / pow(2, ZIPF_THETA);
+        g->alpha = 1.0 / (1.0 - ZIPF_THETA);
+        g->eta = (1.0 - pow(2.0 / n_keys, 1.0 - ZIPF_THETA))
+                 / (1.0 - zeta2 / g->zetan);
+        g->half_pow_theta = 1.0 + pow(0.5, ZIPF_THETA);
+    }
+}
+
+/* Return the next key from the key generator pointed to by g. */
+int keygen_next(keygen_t *g)
+{
+    unsigned long rank;
+    double u, uz;
+
+    switch(g->dist) {
+    case UNIFORM:
+        return (int)(next_rand(&g->seed) % g->n_keys);
+    case ZIPF:
+        u = next_unit(&g->seed);
+        uz = u * g->zetan;
+        if(uz < 1.0) rank = 0;
+        else if(uz < g->half_pow_theta) rank = 1;
+        else rank = g->n_keys * pow(g->eta * u - g->eta + 1.0, g->alpha);
+        if(rank >= (unsigned long)g->n_keys) rank = g->n_keys - 1;
+
+        /* Scatter the ranks over the key range, with a multiplier which is a
+         * prime larger than any key range.
+         */
+        return (int)(rank * 2654435761UL % g->n_keys);
+    default:
+        return (int)(g->next++ % g->n_keys);
+    }
+}
+
+
+/* Perform one run of n_ops operations of the given mix, with keys from
+ * distribution dist, on the dictionary desc holding a working set of n items,
+ * and fill in *res.  items[k] is the item with key k, for k in 0..2n-1.
+ */
+void run(dict_desc_t *desc, int dist, mix_t *mix, int n, long n_ops,
+         double time_limit, test_item_t *items, result_t *res)
+{
+    const dict_info_t *fns;
+    keygen_t g;
+    void *t, *found;
+    test_item_t *item;
+    int *order, i, j, k, tmp, op, n_lat;
+    double *lat, start, t0, elapsed;
+    long ops;
+    unsigned long seed;
+
+    fns = desc->fns;
+    memset(res, 0, sizeof(result_t));
+    if(mix->pct[DELETE_MIN] && !fns->delete_min) {
+        res->status = "no_delete_min";
+        return;
+    }
+
+    /* Fill the dictionary, in increasing order of key for the sorted
+     * distribution, and in random order otherwise.
+     */
+    seed = 88172645463325252UL;
+    order = malloc(n * sizeof(int));
+    for(i = 0; i < n; i++) order[i] = 2 * i;
+    if(dist != SORTED) {
+        for(i = n - 1; i > 0; i--) {
+            j = (int)(next_rand(&seed) % (i + 1));
+            tmp = order[i];  order[i] = order[j];  order[j] = tmp;
+        }
+    }
+    t = fns->alloc(item_cmp, item_val);
+    start = now_nsec();
+    for(i = 0; i < n; i++) {
+        fns->insert(t, &items[order[i]]);
+        if(i % 1024 == 1023 && now_nsec() - start > time_limit * 1e9) break;
+    }
+    free(order);
+    if(i < n) {
+        fns->free(t);
+        res->status = "fill_timeout";
+        return;
+    }
+
+    keygen_init(&g, dist, 2 * n, seed);
+    lat = malloc((n_ops / LATENCY_SAMPLE + 1) * sizeof(double));
+    n_lat = 0;
+    start = now_nsec();
+    for(ops = 0; ops < n_ops; ops++) {
+        k = (int)(next_rand(&seed) % 100);
+        for(op = FIND; op < DELETE_MIN && k >= mix->pct[op]; op++) {
+            k -= mix->pct[op];
+        }
+
+        /* The key is made before the clock is read, so that a sampled
+         * latency is the operation alone.
+         */
+        item = op == DELETE_MIN ? NULL : &items[keygen_next(&g)];
+
+        t0 = ops % LATENCY_SAMPLE == 0 ? now_nsec() : 0;
+        switch(op) {
+        case FIND:
+            found = fns->find(t, item);
+            break;
+        case INSERT:
+            found = fns->insert(t, item);
+            break;
+        case DELETE:
+            found = fns->delete(t, item);
+            break;
+        default:
+            found = fns->delete_min(t);
+        }
+        if(found) sink += ((test_item_t *)found)->key;
+
+        if(ops % LATENCY_SAMPLE == 0) {
+            lat[n_lat++] = now_nsec() - t0 - clock_cost;
+            if(n_lat % 512 == 0 && now_nsec() - start > time_limit * 1e9) {
+                ops++;
+                break;
+            }
+        }
+    }
+    elapsed = now_nsec() - start;
+    fns->free(t);
+
+    res->ops = ops;
+    res->ops_per_sec = ops / elapsed * 1e9;
+    res->status = ops < n_ops ? "run_timeout" : "ok";
+    qsort(lat, n_lat, sizeof(double), double_cmp);
+    for(i = 0; i < n_lat; i++) if(lat[i] < 0) lat[i] = 0;
+    res->p50 = lat[(int)(n_lat * 0.5)];
+    res->p90 = lat[(int)(n_lat * 0.9)];
+    res->p99 = lat[(int)(n_lat * 0.99)];
+    res->p999 = lat[(int)(n_lat * 0.999)];
+    res->max = lat[n_lat - 1];
+    free(lat);
+}
+
+
+/* Returns non-zero if name is in the comma separated list, or if list is
+ * NULL.
+ */
+int in_list(const char *list, const char *name)
+{
+    const char *p;
+    int len;
+
+    if(!list) return 1;
+    len = strlen(name);
+    for(p = list; p; p = strchr(p, ',') ? strchr(p, ',') + 1 : NULL) {
+        if(!strncmp(p, name, len) && (p[len] == ',' || p[len] == '\0')) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Set up the median cost of reading the clock. */
+void measure_clock_cost(void)
+{
+    double samples[1001], t0;
+    int i;
+
+    for(i = 0; i < 1001; i++) {
+        t0 = now_nsec();
+        samples[i] = now_nsec() - t0;
+    }
+    qsort(samples, 1001, sizeof(double), double_cmp);
+    clock_cost = samples[500];
+}
+
+
+int main(int argc, char *argv[])
+{
+    char *dict_list, *dist_list, *mix_list, *format, *p, date[32];
+    int *sizes, n_sizes, max_size, d, s, m, i, k, first;
+    long n_ops;
+    double time_limit;
+    test_item_t *items;
+    result_t res;
+    time_t now;
+
+    dict_list = dist_list = mix_list = NULL;
+    format = "text";
+    sizes = default_sizes;
+    n_sizes = sizeof(default_sizes) / sizeof(int);
+    n_ops = 1000000;
+    time_limit = TIME_LIMIT;
+    while((k = getopt(argc, argv, "b:d:m:n:o:t:f:")) != -1) {
+        switch(k) {
+        case 'b': dict_list = optarg;  break;
+        case 'd': dist_list = optarg;  break;
+        case 'm': mix_list = optarg;  break;
+        case 'o': n_ops = atol(optarg);  break;
+        case 't': time_limit = atof(optarg);  break;
+        case 'f': format = optarg;  break;
+        case 'n':
+            sizes = malloc((strlen(optarg) / 2 + 1) * sizeof(int));
+            n_sizes = 0;
+            for(p = optarg; p; p = strchr(p, ',')) {
+                if(*p == ',') p++;
+                sizes[n_sizes++] = atoi(p);
+            }
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-b dicts] [-d dists] [-m mixes] "
+                    "[-n sizes] [-o ops] [-t seconds] [-f text|csv|json]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+    if(n_ops < LATENCY_SAMPLE) n_ops = LATENCY_SAMPLE;
+
+    max_size = 0;
+    for(s = 0; s < n_sizes; s++) if(sizes[s] > max_size) max_size = sizes[s];
+    items = malloc(2 * max_size * sizeof(test_item_t));
+    for(k = 0; k < 2 * max_size; k++) {
+        items[k].key = k;
+        items[k].other_data = 0;
+    }
+    measure_clock_cost();
+
+    now = time(NULL);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+    if(!strcmp(format, "csv")) {
+        printf("date,dict,dist,mix,size,ops,ops_per_sec,p50_ns,p90_ns,"
+               "p99_ns,p999_ns,max_ns,status\n");
+    }
+    else if(!strcmp(format, "json")) {
+        printf("{\"date\": \"%s\", \"clock_cost_ns\": %.1f, \"results\": [",
+               date, clock_cost);
+    }
+    else {
+        printf("Latencies in nanoseconds, with %.0f ns of clock cost taken "
+               "off.\n", clock_cost);
+        printf("%-6s %-8s %-6s %8s %12s %8s %8s %8s %8s %10s  %s\n",
+               "dict", "dist", "mix", "size", "ops/s", "p50", "p90", "p99",
+               "p99.9", "max", "status");
+    }
+
+    first = 1;
+    for(s = 0; s < n_sizes; s++) {
+        for(d = 0; d < N_DISTS; d++) {
+            if(!in_list(dist_list, dist_names[d])) continue;
+            for(m = 0; m < N_MIXES; m++) {
+                if(!in_list(mix_list, mixes[m].name)) continue;
+                for(i = 0; i < N_DICTS; i++) {
+                    if(!in_list(dict_list, dicts[i].name)) continue;
+                    run(&dicts[i], d, &mixes[m], sizes[s], n_ops, time_limit,
+                        items, &res);
+
+                    if(!strcmp(format, "csv")) {
+                        printf("%s,%s,%s,%s,%d,%ld,%.0f,%.0f,%.0f,%.0f,%.0f,"
+                               "%.0f,%s\n", date, dicts[i].name,
+                               dist_names[d], mixes[m].name, sizes[s],
+                               res.ops, res.ops_per_sec, res.p50, res.p90,
+                               res.p99, res.p999, res.max, res.status);
+                    }
+                    else if(!strcmp(format, "json")) {
+                        printf("%s\n  {\"dict\": \"%s\", \"dist\": \"%s\", "
+                               "\"mix\": \"%s\", \"size\": %d, \"ops\": %ld, "
+                               "\"ops_per_sec\": %.0f, \"p50_ns\": %.0f, "
+                               "\"p90_ns\": %.0f, \"p99_ns\": %.0f, "
+                               "\"p999_ns\": %.0f, \"max_ns\": %.0f, "
+                               "\"status\": \"%s\"}", first ? "" : ",",
+                               dicts[i].name, dist_names[d], mixes[m].name,
+                               sizes[s], res.ops, res.ops_per_sec, res.p50,
+                               res.p90, res.p99, res.p999, res.max,
+                               res.status);
+                    }
+                    else {
+                        printf("%-6s %-8s %-6s %8d %12.0f %8.0f %8.0f %8.0f "
+                               "%8.0f %10.0f  %s\n", dicts[i].name,
+                               dist_names[d], mixes[m].name, sizes[s],
+                               res.ops_per_sec, res.p50, res.p90, res.p99,
+                               res.p999, res.max, res.status);
+                    }
+                    fflush(stdout);
+                    first = 0;
+                }
+            }
+        }
+    }
+    if(!strcmp(format, "json")) printf("\n]}\n");
+
+    free(items);
+    if(sizes != default_sizes) free(sizes);
+
+    return 0;
+}
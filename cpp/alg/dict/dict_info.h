@@ -5,6 +5,7 @@
  *** the universal definition of a dictionary data structure can use different
  *** dictionaries interchangeably for testing or comparison purposes.
  ***/
+#include "../timing/opcount.h"
 
 /* Structure that is provided to algorithm which uses a dictionary. */
 typedef struct dict_info {
@@ -16,8 +17,30 @@ typedef struct dict_info {
     void *(*delete_min)(void *t);
     void *(*find)(void *t, void *key_item);
     void *(*find_min)(void *t);
+    const opcount_t *(*counts)(void *t);
+    void *(*cursor_alloc)(void *t);
+    void (*cursor_free)(void *c);
+    void *(*seek)(void *c, void *key_item);
+    void *(*next)(void *c);
+    void *(*prev)(void *c);
+    void (*bulk_load)(void *t, void **items, int n);
+    void (*find_many)(void *t, void **key_items, void **items, int n);
 } dict_info_t;
 
+/* Number of lookups find_many() advances together.  Each group should need no
+ * more cache lines in flight than the processor can fetch at once.
+ */
+#define FIND_MANY_GROUP 16
+
+/* PREFETCH(p) starts loading the memory pointed to by p into the cache, where
+ * the compiler provides a way to do so.  Otherwise it does nothing.
+ */
+#ifdef __GNUC__
+#define PREFETCH(p) __builtin_prefetch(p)
+#else
+#define PREFETCH(p)
+#endif
+
 /* A pointer to a compar() function, which compares two items in the
  * dictionary, is normally supplied as an argument to a dictionaries alloc()
  * function.  However, some dictionaries instead use a getval() function, which
@@ -34,4 +57,47 @@ typedef struct dict_info {
  * algorithm calls the universal alloc() function.
  */
 
+/* The counts() function returns the operation counts of a dictionary.  The
+ * counts are only kept when OP_COUNTS is 1; otherwise they remain zero.
+ */
+
+/* Ordered dictionaries provide cursors, for visiting items in key order.  The
+ * cursor functions are NULL for dictionaries which do not keep items in key
+ * order.
+ *     cursor_alloc(t) - returns a new cursor on the dictionary pointed to by
+ *                       t, which must be positioned by seek() before use.
+ *     cursor_free(c) - frees the cursor pointed to by c.
+ *     seek(c, key_item) - moves the cursor to the first item with a key not
+ *                         less than that of the item pointed to by key_item,
+ *                         or to the first item if key_item is NULL, and
+ *                         returns it.  If there is no such item, the cursor
+ *                         is moved past the last item and NULL is returned.
+ *     next(c) - moves the cursor to the next item and returns it.
+ *     prev(c) - moves the cursor to the previous item and returns it.  From
+ *               past the last item, this moves to the last item.
+ * When there is no next or previous item, next() and prev() return NULL and
+ * leave the cursor where it is.  A step costs amortised O(1) time, so a range
+ * of k items is visited in O(log n + k) time.  A cursor must be positioned
+ * again by seek() after the dictionary has been changed.
+ */
+
+/* bulk_load(t, items, n) builds the dictionary pointed to by t from the n
+ * items in the array items[], which must be in increasing order of key with no
+ * two keys equal.  An empty dictionary is built directly in O(n) time, rather
+ * than by n insertions; if it is not empty the items are simply inserted.
+ * bulk_load is NULL for dictionaries which do not gain from sorted input.
+ */
+
+/* find_many(t, key_items, items, n) finds the items with the same keys as the
+ * n items pointed to by key_items[], storing a pointer to each item found, or
+ * NULL, in items[].  The result is the same as calling find() n times, but
+ * the lookups are advanced in groups of FIND_MANY_GROUP, one step of each in
+ * turn, and the next node of each is prefetched.  The cache misses of the
+ * lookups in a group then overlap, rather than each waiting on the last.
+ * This pays off once the dictionary no longer fits in the cache; for small
+ * dictionaries the extra bookkeeping can make it slower than find().
+ * find_many is NULL for dictionaries which do not provide it, in which case
+ * find() can be called for each key instead.
+ */
+
 #endif
@@ -7,17 +7,28 @@
 #include "rbtree.h"
 #include "dst.h"
 #include "rst.h"
+#include "bptree.h"
+#include "skip_list.h"
+#include "art.h"
 #include "rand.h"
 
 #define N_ITEMS 250000
 
+/* The range scans timed are N_SCANS seeks, each followed by SCAN_LEN steps
+ * forward.
+ */
+#define N_SCANS 25000
+#define SCAN_LEN 100
+
 int exit_flag;
 
 
 typedef struct time_info {
     char *desc;
     const dict_info_t *fns;
-    clockval_t ins_time, del_time, dm_time, find_time;
+    clockval_t ins_time, del_time, dm_time, find_time, scan_time, bulk_time;
+    clockval_t free_time;
+    opcount_t ops;  /* Operation counts over all of the tests. */
 } time_info_t;
 
 
@@ -54,6 +65,14 @@ int item_cmp2(const void *item1, const void *item2)
     return ((test_item_t *)item1)->data2 - ((test_item_t *)item2)->data2;
 }
 
+/* Compares the items pointed to by two elements of an array of item pointers,
+ * for sorting the array with qsort().
+ */
+int item_ptr_cmp(const void *p1, const void *p2)
+{
+    return item_cmp(*(test_item_t **)p1, *(test_item_t **)p2);
+}
+
 unsigned int item_val(const void *item)
 {
     return ((test_item_t *)item)->data1;
@@ -63,12 +82,15 @@ unsigned int item_val(const void *item)
 /* An array of time info structures holds the information for each dictionary.
  */
 time_info_t dict_times[] = {
-    { "bst",&BST_info,0,0,0,0 },
-    { "avl",&AVL_info,0,0,0,0 },
-    { "23",&TREE23_info,0,0,0,0 },
-    { "RB",&RBTREE_info,0,0,0,0 },
-    { "dst",&DST_info,0,0,0,0 },
-    { "rst",&RST_info,0,0,0,0 },
+    { "bst",&BST_info,0,0,0,0,0,0,0 },
+    { "avl",&AVL_info,0,0,0,0,0,0,0 },
+    { "23",&TREE23_info,0,0,0,0,0,0,0 },
+    { "RB",&RBTREE_info,0,0,0,0,0,0,0 },
+    { "dst",&DST_info,0,0,0,0,0,0,0 },
+    { "rst",&RST_info,0,0,0,0,0,0,0 },
+    { "B+",&BPTREE_info,0,0,0,0,0,0,0 },
+    { "skip",&SKIP_LIST_info,0,0,0,0,0,0,0 },
+    { "ART",&ART_info,0,0,0,0,0,0,0 },
 };
 
 
@@ -77,14 +99,16 @@ int main(void)
     tree23_t *t23;
     time_info_t *time_struct;
     void *t;  /* pointer to the dictionary */
-    test_item_t **item_array, **item_array2, *item;
-    int i, j, test_n;
+    void *c;  /* pointer to a cursor on the dictionary */
+    test_item_t **item_array, **item_array2, **sorted_array;
+    test_item_t *item, *first, *next;
+    int i, j, k, test_n;
 
 
     /* Set up an array of items, using a 2-3 tree to avoid duplicating items.
      */
     item_array = malloc(N_ITEMS * sizeof(test_item_t *));
-    t23 = tree23_alloc(item_cmp);    
+    t23 = tree23_alloc(item_cmp, NULL);
     printf("Setting up items...\n");
     for(j = 0; j < N_ITEMS; j++) {
 	item = item_array[j] = malloc(sizeof(test_item_t));
@@ -99,7 +123,7 @@ int main(void)
      * array, but in a different (random) order.
      */
     item_array2 = malloc(N_ITEMS * sizeof(test_item_t *));
-    t23 = tree23_alloc(item_cmp2);
+    t23 = tree23_alloc(item_cmp2, NULL);
     for(j = 0; j < N_ITEMS; j++) {
 	item = item_array[j];
 	item->data2 = rand_generate();
@@ -112,6 +136,13 @@ int main(void)
     }
     tree23_free(t23);    
 
+    /* A third array holds the items in increasing order of key, for loading
+     * dictionaries from sorted input.
+     */
+    sorted_array = malloc(N_ITEMS * sizeof(test_item_t *));
+    for(j = 0; j < N_ITEMS; j++) sorted_array[j] = item_array[j];
+    qsort(sorted_array, N_ITEMS, sizeof(test_item_t *), item_ptr_cmp);
+
 
     
     /* Create a dictionary and time insert(), delete(), and delete_min(). */
@@ -161,6 +192,44 @@ int main(void)
 	    }
 	}
 	time_struct->find_time += timer_stop();
+
+	/* Range scans, for dictionaries which keep items in key order.  The
+	 * scans are then repeated untimed, checking that each one is in
+	 * increasing order and that stepping back returns to where it started.
+	 */
+	if(time_struct->fns->cursor_alloc) {
+	    printf("  Timing range scans\n");
+	    c = time_struct->fns->cursor_alloc(t);
+	    timer_start();
+	    for(j = 0; j < N_SCANS; j++) {
+		time_struct->fns->seek(c, item_array2[j]);
+		for(k = 0; k < SCAN_LEN; k++) {
+		    if(!time_struct->fns->next(c)) break;
+		}
+	    }
+	    time_struct->scan_time += timer_stop();
+
+	    for(j = 0; j < N_SCANS; j++) {
+		item = first = time_struct->fns->seek(c, item_array2[j]);
+		if(first != item_array2[j]) {
+		    printf("failed.\n"); exit(1);
+		}
+		for(k = 0; k < SCAN_LEN; k++) {
+		    if(!(next = time_struct->fns->next(c))) break;
+		    if(item_cmp(next, item) <= 0) {
+			printf("failed.\n"); exit(1);
+		    }
+		    item = next;
+		}
+		for(; k > 0; k--) {
+		    item = time_struct->fns->prev(c);
+		}
+		if(item != first) {
+		    printf("failed.\n"); exit(1);
+		}
+	    }
+	    time_struct->fns->cursor_free(c);
+	}
 	
 	printf("  Timing delete()\n");
         timer_start();
@@ -187,10 +256,37 @@ int main(void)
 	    }
 	}
 	time_struct->dm_time += timer_stop();
+
+	/* Loading from sorted input, checked by emptying the dictionary again
+	 * with delete_min().
+	 */
+	if(time_struct->fns->bulk_load) {
+	    printf("  Timing bulk_load()\n");
+	    timer_start();
+	    time_struct->fns->bulk_load(t, (void **)sorted_array, N_ITEMS);
+	    time_struct->bulk_time += timer_stop();
+	    for(j = 0; j < N_ITEMS; j++) {
+		if(time_struct->fns->delete_min(t) != sorted_array[j]) {
+		    printf("failed.\n"); exit(1);
+		}
+	    }
+	}
+
+	time_struct->ops = *time_struct->fns->counts(t);
+
+	/* Free a full dictionary. */
+	printf("  Timing free()\n");
+        for(j = 0; j < N_ITEMS; j++) {
+            time_struct->fns->insert(t, item_array[j]);
+        }
+	timer_start();
+	time_struct->fns->free(t);
+	time_struct->free_time += timer_stop();
     }
 
     free(item_array);
     free(item_array2);
+    free(sorted_array);
 
     
     /*** Display Results ***/
@@ -203,11 +299,31 @@ int main(void)
 	printf("\t%.2f",
 	    (double)dict_times[i].find_time/((double)CLOCK_DIV));
     }
+    printf("\nscan");
+    for(i = 0; i < test_n; i++) {
+	if(dict_times[i].fns->cursor_alloc) {
+	    printf("\t%.2f",
+		(double)dict_times[i].scan_time/((double)CLOCK_DIV));
+	}
+	else {
+	    printf("\t-");
+	}
+    }
     printf("\ninsert");
     for(i = 0; i < test_n; i++) {
 	printf("\t%.2f",
 	    (double)dict_times[i].ins_time/((double)CLOCK_DIV));
     }
+    printf("\nbulk");
+    for(i = 0; i < test_n; i++) {
+	if(dict_times[i].fns->bulk_load) {
+	    printf("\t%.2f",
+		(double)dict_times[i].bulk_time/((double)CLOCK_DIV));
+	}
+	else {
+	    printf("\t-");
+	}
+    }
     printf("\ndelete");
     for(i = 0; i < test_n; i++) {
 	printf("\t%.2f",
@@ -218,7 +334,35 @@ int main(void)
 	printf("\t%.2f",
 	    (double)dict_times[i].dm_time/((double)CLOCK_DIV));
     }
+    printf("\nfree");
+    for(i = 0; i < test_n; i++) {
+	printf("\t%.2f",
+	    (double)dict_times[i].free_time/((double)CLOCK_DIV));
+    }
+    printf("\n");
+
+#if OP_COUNTS
+    /* Operation counts are for all of the above operations together. */
+    printf("\nOperation counts:\n");
+    for(i = 0; i < test_n; i++) {
+        printf("\t%s", dict_times[i].desc);
+    }
+    printf("\ncomps");
+    for(i = 0; i < test_n; i++) printf("\t%ld", dict_times[i].ops.comps);
+    printf("\nallocs");
+    for(i = 0; i < test_n; i++) printf("\t%ld", dict_times[i].ops.allocs);
+    printf("\nlinks");
+    for(i = 0; i < test_n; i++) printf("\t%ld", dict_times[i].ops.links);
+    printf("\nrestruct");
+    for(i = 0; i < test_n; i++) {
+	printf("\t%ld", dict_times[i].ops.restructs);
+    }
+    printf("\ndepth");
+    for(i = 0; i < test_n; i++) {
+	printf("\t%d", dict_times[i].ops.max_depth);
+    }
     printf("\n");
+#endif
 
     
     return 0;
@@ -3,40 +3,49 @@
 
 
 /* Prototypes for functions only visible within this file. */
-void dst_free_dfs(dst_node_t *p);
+void dst_free_dfs(dst_t *t, dst_node_t *p);
 
 
 /* dst_alloc() - Allocates space for a digital search tree and returns a
  * pointer to it.  The function get_value() returns the key value for a data
- * item.
+ * item.  Nodes are allocated from the pool pointed to by pool, which may be
+ * shared with other dictionaries, or from a new pool of the tree's own if pool
+ * is NULL.
  */
-dst_t *dst_alloc(unsigned int (* get_value)(const void *), int max_b)
+dst_t *dst_alloc(unsigned int (* get_value)(const void *), int max_b,
+	       pool_t *pool)
 {
     dst_t *t;
     
 
     t = malloc(sizeof(dst_t));
+    t->own_pool = !pool;
+    t->pool = pool ? pool : pool_alloc();
     t->root = NULL;
     t->n = 0;
     t->max_b = max_b;
     t->get_value = get_value;
+    OP_RESET(t->ops);
 
     return t;
 }
 
 
 /* dst_free() - Frees space used by the digital search tree pointed to by t.
+ * The nodes of a tree with its own pool are freed all at once, by freeing the
+ * pool.  Otherwise they are returned to the shared pool.
  */
 void dst_free(dst_t *t) {
-    dst_free_dfs(t->root);
+    if(t->own_pool) pool_free(t->pool);
+    else dst_free_dfs(t, t->root);
     free(t);
 }
 
-void dst_free_dfs(dst_node_t *p) {
+void dst_free_dfs(dst_t *t, dst_node_t *p) {
     if(!p) return;
-    dst_free_dfs(p->a[0]);
-    dst_free_dfs(p->a[1]);
-    free(p);
+    dst_free_dfs(t, p->a[0]);
+    dst_free_dfs(t, p->a[1]);
+    pool_put(t->pool, p, sizeof(dst_node_t));
 }
 
 
@@ -65,6 +74,7 @@ void *dst_insert(dst_t *t, void *item)
         for(;;) {
 	    p = next_p;
 
+	    OP_COMP(t->ops);
 	    if(p->key == key) {
 		return p->item;  /* Item found. */
 	    }
@@ -76,6 +86,7 @@ void *dst_insert(dst_t *t, void *item)
 
             if(!next_p) {  /* Empty position to insert at. */
 		child_link = &p->a[j];
+		OP_DEPTH(t->ops, t->max_b - i);
 		break;
 	    }
 
@@ -89,13 +100,15 @@ void *dst_insert(dst_t *t, void *item)
     }
 
     /* Create a new node. */
-    x = malloc(sizeof(dst_node_t));
+    x = pool_get(t->pool, sizeof(dst_node_t));
+    OP_ALLOC(t->ops);
     x->a[0] = x->a[1] = NULL;
     x->key = key;
     x->item = item;
 
     /* Join the new node onto the tree. */
     *child_link = x;
+    OP_LINK(t->ops);
 
     t->n++;
 
@@ -123,6 +136,7 @@ void *dst_find(dst_t *t, void *key_item) {
         for(;;) {
 	    p = next_p;
 
+	    OP_COMP(t->ops);
 	    if(p->key == key) {
 		return p->item;  /* Item found. */
 	    }
@@ -158,6 +172,7 @@ void *dst_find_min(dst_t *t)
 	min_key = 0xFFFFFFFF;  /* Note the sign bit. */
 	for(;;) {
 	    p = next_p;
+	    OP_COMP(t->ops);
 	    if(p->key <= min_key) {
 	        min_node = p;
 		min_key = p->key;
@@ -198,6 +213,7 @@ void *dst_delete(dst_t *t, void *key_item) {
         for(;;) {
 	    p = next_p;
 
+	    OP_COMP(t->ops);
 	    if(p->key == key) {
 		break;  /* Item found. */
 	    }
@@ -245,7 +261,9 @@ void *dst_delete(dst_t *t, void *key_item) {
     }
 
     /* Node q is moved to replace node p. */
+    OP_LINK(t->ops);
     if(p != q) {
+        OP_LINK(t->ops);
         *child_link = NULL;
         *del_child_link = q;
         q->a[0] = p->a[0];
@@ -256,7 +274,7 @@ void *dst_delete(dst_t *t, void *key_item) {
     }
     
     return_item = p->item;
-    free(p);
+    pool_put(t->pool, p, sizeof(dst_node_t));
 
     return return_item;
 }
@@ -280,6 +298,7 @@ void *dst_delete(dst_t *t, void *key_item) {
         for(;;) {
 	    p = next_p;
 
+	    OP_COMP(t->ops);
 	    if(p->key == key) {
 		break;  /* Item found. */
 	    }
@@ -319,6 +338,7 @@ void *dst_delete(dst_t *t, void *key_item) {
     q = p->a[j];
     q2 = p->a[!j];    
     *child_link = q;
+    OP_LINK(t->ops);
 	
     while(q) {
 	/* Before assigning left and right children to q, obtain the next
@@ -334,6 +354,7 @@ void *dst_delete(dst_t *t, void *key_item) {
 	/* Assign left and right pointers. */
 	q->a[!j] = q2;
 	q->a[j] = next_q;
+	OP_LINK(t->ops);
 	    
         /* Obtain the next values for j, q, and q2. */
 	j = next_j;
@@ -343,7 +364,7 @@ void *dst_delete(dst_t *t, void *key_item) {
 
 
     return_item = p->item;
-    free(p);
+    pool_put(t->pool, p, sizeof(dst_node_t));
 
     return return_item;
 }
@@ -369,6 +390,7 @@ void *dst_delete_min(dst_t *t)
     child_link = &t->root;
     for(;;) {
 	p = next_p;
+	OP_COMP(t->ops);
 	if(p->key <= min_key) {
             min_node = p;
 	    min_child_link = child_link;
@@ -387,14 +409,16 @@ void *dst_delete_min(dst_t *t)
      * min_child_link, and min_key variables during the search.
      */
     *child_link = NULL;
+    OP_LINK(t->ops);
     if(min_node != p) {
+        OP_LINK(t->ops);
         *min_child_link = p;
         p->a[0] = min_node->a[0];
         p->a[1] = min_node->a[1];
     }
 
     return_item = min_node->item;
-    free(min_node);
+    pool_put(t->pool, min_node, sizeof(dst_node_t));
 
     return return_item;
 }
@@ -406,7 +430,7 @@ void *dst_delete_min(dst_t *t)
 
 void *_dst_alloc(int (* compar)(const void *, const void *),
 		 unsigned int (* getval)(const void *)) {
-    return dst_alloc(getval, 8*sizeof(unsigned int));
+    return dst_alloc(getval, 8*sizeof(unsigned int), NULL);
 }
 
 void _dst_free(void *t) {
@@ -433,6 +457,10 @@ void *_dst_find_min(void *t) {
     return dst_find_min((dst_t *)t);
 }
 
+const opcount_t *_dst_counts(void *t) {
+    return &((dst_t *)t)->ops;
+}
+
 /* Digital search tree info */
 const dict_info_t DST_info = {
     _dst_alloc,
@@ -441,5 +469,13 @@ const dict_info_t DST_info = {
     _dst_delete,
     _dst_delete_min,
     _dst_find,
-    _dst_find_min
+    _dst_find_min,
+    _dst_counts,
+    NULL,  /* Items are not kept in key order, so there are no cursors. */
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,  /* Sorted input does not help, so there is no bulk load. */
+    NULL   /* No batched find. */
 };
@@ -1,6 +1,7 @@
 #ifndef DST_H
 #define DST_H
 #include "dict_info.h"  /* Defines the universal dictionary structure type. */
+#include "pool.h"
 
 /* This digital search tree implementation has code for two different
  * rearangement schemes after deleting a node.  Use #define DST_FAST_DELETE 1
@@ -18,21 +19,33 @@ typedef struct dst_node {
 } dst_node_t;
 
 
+/* ops counts the operations performed on the tree, for experimental purposes.
+ * Nodes are allocated from pool, which is the tree's own pool if own_pool is
+ * 1.
+ */
 typedef struct dst {
     dst_node_t *root;
     int n;
     int max_b;
     unsigned int (* get_value)(const void *);
+    pool_t *pool;
+    int own_pool;
+    opcount_t ops;
 } dst_t;
 
 
 /* dst_alloc() - Allocates space for a digital search tree and returns a
  * pointer to it.  The function get_value() returns the key value for a data
- * item.
+ * item.  Nodes are allocated from the pool pointed to by pool, which may be
+ * shared with other dictionaries, or from a new pool of the tree's own if pool
+ * is NULL.
  */
-dst_t *dst_alloc(unsigned int (* get_value)(const void *), int max_b);
+dst_t *dst_alloc(unsigned int (* get_value)(const void *), int max_b,
+	       pool_t *pool);
 
 /* dst_free() - Frees space used by the digital search tree pointed to by t.
+ * The nodes of a tree with its own pool are freed all at once, by freeing the
+ * pool.  Otherwise they are returned to the shared pool.
  */
 void dst_free(dst_t *t);
 
@@ -48,13 +48,14 @@ unsigned int item_value(const void *item)
 int main(void)
 {
     dst_t *t;
+    pool_t *pool;
     test_item_t item_array[N_ITEMS], *i, *i2, duplicate, lookup_item;
     test_item_t *result;
     int j;
 
 
     /* Create a dgital search tree. */
-    t = dst_alloc(item_value, MAX_BITS);
+    t = dst_alloc(item_value, MAX_BITS, NULL);
     
     /* Add some items to it. */    
     printf("Inserting items:\n");
@@ -123,7 +124,8 @@ int main(void)
     printf("successful.\n");
     
     /* Create a new tree then repeat dst_insert()/dst_delete(). */
-    t = dst_alloc(item_value, MAX_BITS);
+    pool = pool_alloc();  /* A shared pool, which nodes are returned to. */
+    t = dst_alloc(item_value, MAX_BITS, pool);
     printf("\nRepeating dst_insert()/dst_delete()...\n");
     for(j = 0; j < N_ITEMS; j++) {
 	i = &item_array[j];  /* Uniqueness of keys was enforced earlier. */
@@ -171,5 +173,7 @@ int main(void)
     }
     dst_free(t);
     
+    pool_free(pool);
+
     return 0;
 }
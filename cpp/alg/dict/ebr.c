@@ -0,0 +1,228 @@
+/*** File ebr.c - Epoch-Based Memory Reclamation ***/
+#include <stdlib.h>
+#include <sched.h>
+#include "ebr.h"
+
+
+
+/*** Structure Types ***/
+
+/* A retired block of memory, waiting to be freed by free_fn(p). */
+typedef struct ebr_garbage {
+    void *p;
+    void (*free_fn)(void *p);
+    struct ebr_garbage *next;
+} ebr_garbage_t;
+
+/* The registration of a thread.
+ *     epoch - the global epoch seen when the thread's current critical
+ *             section started.
+ *     active - non-zero while the thread is in a critical section.
+ *     in_use - non-zero while the record is registered to a thread.  Records
+ *              released by ebr_thread_exit() are reused by new threads.
+ *     nesting - the depth of nested critical sections.
+ *     n_retired - the number of calls to ebr_retire() by the thread.
+ *     limbo[i] - a list of memory retired by the thread in epoch tag[i].
+ *     next - the next record in the list of all records.
+ */
+typedef struct ebr_thread {
+    volatile long epoch;
+    volatile int active;
+    volatile int in_use;
+    int nesting;
+    long n_retired;
+    long tag[3];
+    ebr_garbage_t *limbo[3];
+    struct ebr_thread *next;
+} ebr_thread_t;
+
+
+
+/*** Variables Shared Between Functions in this File ***/
+
+/* The global epoch. */
+volatile long ebr_epoch = 0;
+
+/* The list of all thread records.  Records are only ever added, at the head.
+ */
+ebr_thread_t *volatile ebr_threads = NULL;
+
+/* The record of the calling thread, or NULL if it is not registered. */
+__thread ebr_thread_t *ebr_self = NULL;
+
+
+
+/*** Prototypes of functions only visible within this file. ***/
+
+ebr_thread_t *ebr_register(void);
+int ebr_try_advance(void);
+void ebr_collect(ebr_thread_t *rec);
+
+
+
+/*** Definitions of functions visible outside of this file. ***/
+
+/* ebr_enter() - starts a read-side critical section for the calling thread.
+ */
+void ebr_enter(void)
+{
+    ebr_thread_t *rec;
+
+    rec = ebr_self ? ebr_self : ebr_register();
+    if(rec->nesting++ == 0) {
+        /* Announce that the thread is active before reading the epoch, so
+         * that the epoch cannot advance twice without the thread being seen.
+         */
+        rec->active = 1;
+        __sync_synchronize();
+        rec->epoch = ebr_epoch;
+        __sync_synchronize();
+    }
+}
+
+
+/* ebr_exit() - ends a read-side critical section for the calling thread.
+ */
+void ebr_exit(void)
+{
+    ebr_thread_t *rec;
+
+    rec = ebr_self;
+    if(--rec->nesting == 0) {
+        /* All reads of shared memory must complete before the thread is seen
+         * as inactive.
+         */
+        __sync_synchronize();
+        rec->active = 0;
+    }
+}
+
+
+/* ebr_retire() - frees the memory pointed to by p, by calling free_fn(p),
+ * once no thread can still be reading it.
+ */
+void ebr_retire(void *p, void (*free_fn)(void *p))
+{
+    ebr_thread_t *rec;
+    ebr_garbage_t *g;
+    long e;
+    int i;
+
+    rec = ebr_self ? ebr_self : ebr_register();
+
+    /* Free any lists that are old enough.  This includes the list for the
+     * current epoch modulo 3 if it was last used three or more epochs ago.
+     */
+    ebr_collect(rec);
+
+    e = ebr_epoch;
+    i = (int)(e % 3);
+    if(!rec->limbo[i]) rec->tag[i] = e;
+
+    g = malloc(sizeof(ebr_garbage_t));
+    g->p = p;
+    g->free_fn = free_fn;
+    g->next = rec->limbo[i];
+    rec->limbo[i] = g;
+
+    if(++rec->n_retired % EBR_RETIRE_BATCH == 0) {
+        ebr_try_advance();
+        ebr_collect(rec);
+    }
+}
+
+
+/* ebr_thread_exit() - waits until the memory retired by the calling thread can
+ * be freed, frees it, and releases the thread's registration.
+ */
+void ebr_thread_exit(void)
+{
+    ebr_thread_t *rec;
+
+    rec = ebr_self;
+    if(!rec) return;
+
+    while(rec->limbo[0] || rec->limbo[1] || rec->limbo[2]) {
+        ebr_try_advance();
+        ebr_collect(rec);
+        if(rec->limbo[0] || rec->limbo[1] || rec->limbo[2]) sched_yield();
+    }
+
+    ebr_self = NULL;
+    __sync_synchronize();
+    rec->in_use = 0;
+}
+
+
+
+/*** Definitions of functions that are only visible within this file. ***/
+
+/* ebr_register() - registers the calling thread, reusing a released record if
+ * there is one, and returns its record.
+ */
+ebr_thread_t *ebr_register(void)
+{
+    ebr_thread_t *rec;
+
+    for(rec = ebr_threads; rec; rec = rec->next) {
+        if(!rec->in_use && __sync_bool_compare_and_swap(&rec->in_use, 0, 1)) {
+            break;
+        }
+    }
+
+    if(!rec) {
+        rec = malloc(sizeof(ebr_thread_t));
+        rec->in_use = 1;
+        rec->limbo[0] = rec->limbo[1] = rec->limbo[2] = NULL;
+        do {
+            rec->next = ebr_threads;
+        } while(!__sync_bool_compare_and_swap(&ebr_threads, rec->next, rec));
+    }
+
+    rec->active = 0;
+    rec->nesting = 0;
+    rec->n_retired = 0;
+    ebr_self = rec;
+
+    return rec;
+}
+
+
+/* ebr_try_advance() - advances the global epoch if every thread in a critical
+ * section has seen the current epoch.  Returns non-zero if it was advanced.
+ */
+int ebr_try_advance(void)
+{
+    ebr_thread_t *rec;
+    long e;
+
+    e = ebr_epoch;
+    __sync_synchronize();
+    for(rec = ebr_threads; rec; rec = rec->next) {
+        if(rec->in_use && rec->active && rec->epoch != e) return 0;
+    }
+
+    return __sync_bool_compare_and_swap(&ebr_epoch, e, e + 1);
+}
+
+
+/* ebr_collect() - frees the lists of retired memory of the thread record
+ * pointed to by rec that were retired at least two epochs ago.
+ */
+void ebr_collect(ebr_thread_t *rec)
+{
+    ebr_garbage_t *g, *next;
+    long e;
+    int i;
+
+    e = ebr_epoch;
+    for(i = 0; i < 3; i++) {
+        if(!rec->limbo[i] || rec->tag[i] + 2 > e) continue;
+        for(g = rec->limbo[i]; g; g = next) {
+            next = g->next;
+            g->free_fn(g->p);
+            free(g);
+        }
+        rec->limbo[i] = NULL;
+    }
+}
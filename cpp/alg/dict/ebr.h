@@ -0,0 +1,57 @@
+/*** File ebr.h - Epoch-Based Memory Reclamation ***/
+#ifndef EBR_H
+#define EBR_H
+
+/* Epoch-based reclamation lets lock-free data structures free memory that
+ * other threads may still be reading.  A thread reads shared nodes only
+ * between ebr_enter() and ebr_exit(), which mark a read-side critical
+ * section.  After a node has been unlinked, so that no new reader can reach
+ * it, it is passed to ebr_retire() instead of being freed.  It is freed once
+ * every thread that was in a critical section at the time has left it.
+ *
+ * A global epoch counter is advanced only when every thread in a critical
+ * section has seen the current epoch.  Memory retired in epoch e is therefore
+ * safe to free once the global epoch reaches e + 2.  Each thread keeps its
+ * retired memory in one of three lists, by epoch modulo 3, and frees a list
+ * when it finds that the list is two epochs old.
+ *
+ * There is a single reclamation domain for the whole process.  Each thread is
+ * registered automatically on its first call, and should call
+ * ebr_thread_exit() before it exits so that its retired memory is freed.
+ * Critical sections may be nested.  Atomic operations use the GCC __sync
+ * builtins, and per-thread state uses GCC's __thread storage class.
+ */
+
+
+/*** Compile Time Options ***/
+
+/* The number of calls to ebr_retire() by a thread between attempts to advance
+ * the global epoch.
+ */
+#define EBR_RETIRE_BATCH 64
+
+
+
+/*** Function prototypes. ***/
+
+/* ebr_enter() - starts a read-side critical section for the calling thread.
+ */
+void ebr_enter(void);
+
+/* ebr_exit() - ends a read-side critical section for the calling thread.
+ */
+void ebr_exit(void);
+
+/* ebr_retire() - frees the memory pointed to by p, by calling free_fn(p),
+ * once no thread can still be reading it.  p must already be unreachable by
+ * new readers.
+ */
+void ebr_retire(void *p, void (*free_fn)(void *p));
+
+/* ebr_thread_exit() - waits until the memory retired by the calling thread can
+ * be freed, frees it, and releases the thread's registration.  The calling
+ * thread must not be in a critical section.
+ */
+void ebr_thread_exit(void);
+
+#endif
@@ -0,0 +1,192 @@
+/*** File: find_many_bench.c - Batched lookups against repeated finds ***/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "bst.h"
+#include "avl.h"
+#include "tree23.h"
+#include "rbtree.h"
+#include "bench_util.h"
+
+
+/* This program compares the find_many() function of the tree dictionaries
+ * with calling find() once for each key.  Each run fills a dictionary with n
+ * items, inserted in random order, whose keys are every second key in the
+ * range 0..2n-1.  The same n_lookups keys, chosen uniformly at random from
+ * the key range so that about half are found, are then looked up both ways.
+ * The results must be the same.  Each way is timed over rounds repetitions,
+ * and the best time is reported in nanoseconds per lookup.
+ *
+ * The default sizes go well beyond the last level cache, where the lookups
+ * are bound by the latency of main memory and find_many() gains the most.
+ *
+ * Usage: find_many_bench [-b dicts] [-n sizes] [-o lookups] [-r rounds]
+ * where dicts and sizes are comma separated lists, such as "-b AVL,RB -n
+ * 1000000".  By default all are run.
+ */
+
+
+/* Structure type for items. */
+typedef struct test_item {
+    int key;
+    int other_data;
+} test_item_t;
+
+/* Function to compare two items. */
+int item_cmp(const void *item1, const void *item2)
+{
+    return ((test_item_t *)item1)->key - ((test_item_t *)item2)->key;
+}
+
+/* The dictionaries measured. */
+typedef struct dict_desc {
+    const char *name;
+    const dict_info_t *fns;
+} dict_desc_t;
+
+dict_desc_t dicts[] = {
+    { "BST", &BST_info },
+    { "AVL", &AVL_info },
+    { "2-3", &TREE23_info },
+    { "RB", &RBTREE_info }
+};
+#define N_DICTS ((int)(sizeof(dicts) / sizeof(dict_desc_t)))
+
+
+/* Fills the dictionary of desc with n items and looks up n_lookups random
+ * keys with find() and with find_many(), printing the best time of each over
+ * rounds repetitions.
+ */
+void run(dict_desc_t *desc, int n, int n_lookups, int rounds)
+{
+    const dict_info_t *fns = desc->fns;
+    test_item_t *items, *keys;
+    void **key_ptrs, **found, **found_many, *t;
+    unsigned long seed = 1;
+    double start, find_time, many_time, ns;
+    int i, j, r, n_found, match, key;
+
+    items = malloc(n * sizeof(test_item_t));
+    keys = malloc(n_lookups * sizeof(test_item_t));
+    key_ptrs = malloc(n_lookups * sizeof(void *));
+    found = malloc(n_lookups * sizeof(void *));
+    found_many = malloc(n_lookups * sizeof(void *));
+
+    /* Insert the items in random order, so that the nodes which are close
+     * in the tree are not close in memory.
+     */
+    for(i = 0; i < n; i++) {
+        items[i].key = 2 * i;
+        items[i].other_data = i;
+    }
+    for(i = n - 1; i > 0; i--) {
+        j = next_rand(&seed) % (i + 1);
+        key = items[i].key;
+        items[i].key = items[j].key;
+        items[j].key = key;
+    }
+    t = fns->alloc(item_cmp, NULL);
+    for(i = 0; i < n; i++) fns->insert(t, &items[i]);
+
+    for(i = 0; i < n_lookups; i++) {
+        keys[i].key = next_rand(&seed) % (2 * n);
+        key_ptrs[i] = &keys[i];
+    }
+
+    find_time = many_time = 0;
+    r = 0;
+    do {
+        start = now_nsec();
+        for(i = 0; i < n_lookups; i++) found[i] = fns->find(t, key_ptrs[i]);
+        ns = now_nsec() - start;
+        if(r == 0 || ns < find_time) find_time = ns;
+
+        start = now_nsec();
+        fns->find_many(t, key_ptrs, found_many, n_lookups);
+        ns = now_nsec() - start;
+        if(r == 0 || ns < many_time) many_time = ns;
+    } while(++r < rounds);
+
+    match = memcmp(found, found_many, n_lookups * sizeof(void *)) == 0;
+    for(i = n_found = 0; i < n_lookups; i++) if(found[i]) n_found++;
+
+    printf("%-5s %10d %10d %8.1f %10.1f %8.2f  %s\n", desc->name, n,
+           n_found, find_time / n_lookups, many_time / n_lookups,
+           find_time / many_time, match ? "match" : "DIFFER");
+    fflush(stdout);
+
+    fns->free(t);
+    free(items);
+    free(keys);
+    free(key_ptrs);
+    free(found);
+    free(found_many);
+}
+
+
+/* Returns 1 if name is in the comma separated list, or if list is NULL. */
+int in_list(const char *list, const char *name)
+{
+    const char *p;
+    int len;
+
+    if(!list) return 1;
+    len = strlen(name);
+    for(p = list; p; p = strchr(p, ',') ? strchr(p, ',') + 1 : NULL) {
+        if(!strncmp(p, name, len) && (p[len] == ',' || p[len] == '\0')) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+
+int main(int argc, char *argv[])
+{
+    int sizes[32] = { 100000, 1000000, 10000000 };
+    int n_sizes = 3, n_lookups = 1000000, rounds = 3;
+    const char *dict_list = NULL;
+    char *p;
+    int d, i, k;
+
+    while((k = getopt(argc, argv, "b:n:o:r:")) != -1) {
+        switch(k) {
+          case 'b':
+            dict_list = optarg;
+            break;
+          case 'n':
+            n_sizes = 0;
+            for(p = optarg; p && n_sizes < 32; p = strchr(p, ',')) {
+                if(*p == ',') p++;
+                sizes[n_sizes++] = atoi(p);
+            }
+            break;
+          case 'o':
+            n_lookups = atoi(optarg);
+            break;
+          case 'r':
+            rounds = atoi(optarg);
+            break;
+          default:
+            fprintf(stderr, "Usage: %s [-b dicts] [-n sizes] [-o lookups]"
+                    " [-r rounds]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    printf("%d lookups, best of %d rounds; nanoseconds per lookup\n",
+           n_lookups, rounds);
+    printf("%-5s %10s %10s %8s %10s %8s  %s\n", "dict", "n", "found", "find",
+           "find_many", "speedup", "results");
+    for(i = 0; i < n_sizes; i++) {
+        for(d = 0; d < N_DICTS; d++) {
+            if(in_list(dict_list, dicts[d].name)) {
+                run(&dicts[d], sizes[i], n_lookups, rounds);
+            }
+        }
+    }
+
+    return 0;
+}
@@ -6,11 +6,17 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "hashtbl.h"
+#include "bench_util.h"
 
 
 #define N_ITEMS 150
 #define N_BUCKETS 13
 
+/* The benchmark uses a table of 2^BENCH_LOG_SIZE slots, filled to each load
+ * factor in turn, from 0.5 to 0.9.
+ */
+#define BENCH_LOG_SIZE 20
+
 
 /* Structure type for items. */
 typedef struct test_item {
@@ -26,14 +32,73 @@ int compare_fn(const void *item1, const void *item2)
 }
 
 /* Hash function to use. */
-int hash_fn(const void *item, int n)
+unsigned long hash_fn(const void *item)
 {
-    /* Generate the hash value by using the key as a seed for the random number
-     * generator, and taking the second random number generated.
-     */
-    srand(((test_item_t *)item)->key);
-    rand();
-    return rand() % n;
+    return hash_mix((unsigned long)((test_item_t *)item)->key);
+}
+
+
+/* Print the average time per operation in nanoseconds, for n operations that
+ * took nsec nanoseconds.
+ */
+void print_ns(double nsec, int n)
+{
+    printf("\t%.1f", nsec / n);
+}
+
+
+/* Benchmark insert, successful and unsuccessful find, and delete, with the
+ * table filled to load factors 0.5, 0.6, ..., 0.9.
+ */
+void benchmark(void)
+{
+    int i, n, size, lf;
+    test_item_t *items, *absent;
+    hash_tbl_t *tbl;
+    double start;
+    long found;
+
+    size = 1 << BENCH_LOG_SIZE;
+    items = malloc(size * sizeof(test_item_t));
+    absent = malloc(size * sizeof(test_item_t));
+    for(i = 0; i < size; i++) {
+        items[i].key = i;
+        absent[i].key = size + i;
+    }
+
+    printf("\nBenchmark (nsec per operation), table size = %d\n", size);
+    printf("load,\tinsert,\tfind,\tmiss,\tdelete\n");
+    for(lf = 5; lf <= 9; lf++) {
+        n = (int)((double)size * lf / 10);
+
+        /* Asking for space for n items gives a table of size slots. */
+        tbl = hash_tbl_alloc(n, hash_fn, compare_fn);
+        found = 0;
+        printf("0.%d", lf);
+
+        start = now_nsec();
+        for(i = 0; i < n; i++) hash_tbl_insert(tbl, &items[i]);
+        print_ns(now_nsec() - start, n);
+
+        start = now_nsec();
+        for(i = 0; i < n; i++) if(hash_tbl_find(tbl, &items[i])) found++;
+        print_ns(now_nsec() - start, n);
+
+        start = now_nsec();
+        for(i = 0; i < n; i++) if(hash_tbl_find(tbl, &absent[i])) found++;
+        print_ns(now_nsec() - start, n);
+
+        start = now_nsec();
+        for(i = 0; i < n; i++) hash_tbl_delete(tbl, &items[i]);
+        print_ns(now_nsec() - start, n);
+
+        if(found != n || tbl->capacity != size) printf("\terror");
+        putchar('\n');
+        hash_tbl_free(tbl);
+    }
+
+    free(items);
+    free(absent);
 }
 
 
@@ -52,7 +117,9 @@ int main(void)
 	items[i].key = i*i;
     }
 
-    /* Create a has table with N_BUCKETS buckets. */
+    /* Create a hash table with initial space for N_BUCKETS items.  It grows
+     * as the items are inserted.
+     */
     hash_table = hash_tbl_alloc(N_BUCKETS, hash_fn, compare_fn);
 
     /* Insert all the items into the hash table. */
@@ -97,5 +164,18 @@ int main(void)
     }
     printf("passed.\n");
 
+    /* Deleted items must no longer be found. */
+    printf("Testing find after delete...");
+    for(i = 0; i < N_ITEMS; i++) {
+        if(hash_tbl_find(hash_table, &items[i])) {
+	    printf("error.\n");
+	    exit(1);
+	}
+    }
+    printf("passed.\n");
+    hash_tbl_free(hash_table);
+
+    benchmark();
+
     return 0;
 }
@@ -5,26 +5,61 @@
 #include <stdlib.h>
 #include "hashtbl.h"
 
+#if HASH_TBL_USE_SSE2 && defined(__SSE2__)
+#define HASH_TBL_SSE2 1
+#include <emmintrin.h>
+#else
+#define HASH_TBL_SSE2 0
+#endif
 
-/* hash_tbl_alloc() - Returns a pointer to a hash table with n_buckets buckets.
- * Pointers to the following functions are required:
+/* The index of the lowest set bit in the non-zero mask m. */
+#if defined(__GNUC__)
+#define LOWEST_BIT(m) __builtin_ctz(m)
+#else
+#define LOWEST_BIT(m) hash_tbl_lowest_bit(m)
+#endif
+
+
+
+/*** Prototypes of functions only visible within this file. ***/
+
+unsigned int hash_tbl_match(const signed char *group, signed char h2);
+unsigned int hash_tbl_match_empty(const signed char *group);
+unsigned int hash_tbl_match_free(const signed char *group);
+int hash_tbl_lowest_bit(unsigned int m);
+int hash_tbl_lookup(hash_tbl_t *tbl, const void *item, unsigned long hash);
+int hash_tbl_free_slot(hash_tbl_t *tbl, unsigned long hash);
+void hash_tbl_resize(hash_tbl_t *tbl, int capacity);
+
+
+
+/*** Definitions of functions visible outside of this file. ***/
+
+/* hash_tbl_alloc() - Returns a pointer to a hash table with space for at
+ * least n_items items before it first needs to grow.  Pointers to the
+ * following functions are required:
  *     hash_fn - A hash function, which hashes the key of the item pointed to
- *               by item to a bucket number between 0 and n-1.
+ *               by item to an unsigned long.
  *     comp_fn - A comparison function.  Should returns zero only if item1 and
  *               item2 have the same key.
  */
-hash_tbl_t *hash_tbl_alloc(int n_buckets,
-			   int (*hash_fn)(const void *item, int n),
+hash_tbl_t *hash_tbl_alloc(int n_items,
+			   unsigned long (*hash_fn)(const void *item),
 			   int (*comp_fn)(const void *item1, const void *item2)
                            )
 {
     hash_tbl_t *tbl;
+    int capacity;
+
+    capacity = HASH_TBL_GROUP;
+    while(capacity * HASH_TBL_MAX_LOAD < n_items) capacity *= 2;
 
     tbl = malloc(sizeof(hash_tbl_t));
-    tbl->buckets = malloc(n_buckets * sizeof(hash_tbl_item_t *));
-    tbl->n_buckets = n_buckets;
+    tbl->ctrl = NULL;
+    tbl->slots = NULL;
     tbl->hash_fn = hash_fn;
     tbl->compare_fn = comp_fn;
+    hash_tbl_resize(tbl, capacity);
 
     return tbl;
 }
@@ -34,24 +69,8 @@ hash_tbl_t *hash_tbl_alloc(int n_buckets,
  */
 void hash_tbl_free(hash_tbl_t *tbl)
 {
-    int i, n;
-    hash_tbl_item_t **buckets, *item_ptr, *free_item;
-
-    /* First free space used by any of the items in the has table. */
-    n = tbl->n_buckets;
-    buckets = tbl->buckets;
-    for(i = 0; i < n; i++) {
-        if((item_ptr = buckets[i])) {
-            while(item_ptr) {
-		free_item = item_ptr;
-		item_ptr = item_ptr->next;
-                free(free_item);
-	    }
-	}
-    }
-
-    /* Now free the hash table and its buckets. */
-    free(buckets);
+    free(tbl->ctrl);
+    free(tbl->slots);
     free(tbl);
 }
 
@@ -63,35 +82,33 @@ void hash_tbl_free(hash_tbl_t *tbl)
  */
 void *hash_tbl_insert(hash_tbl_t *tbl, void *item)
 {
+    unsigned long hash;
     int pos;
-    hash_tbl_item_t *new_item, *item_ptr, *next_item,  **buckets;
-    hash_tbl_item_t **update_ptr;
-
-    buckets = tbl->buckets;
-
-    /* Get the bucket position for the item being inserted. */
-    pos = tbl->hash_fn(item, tbl->n_buckets);
-    next_item = buckets[pos];
-    if(next_item) {
-        do {
-            item_ptr = next_item;
-	    if(!tbl->compare_fn(item_ptr->item, item)) {
-		/* An item with this key already exists. */
-		return item_ptr->item;
-	    }
-	    next_item = item_ptr->next;
-        } while(next_item);
-	update_ptr = &item_ptr->next;
+
+    hash = tbl->hash_fn(item);
+    pos = hash_tbl_lookup(tbl, item, hash);
+    if(pos >= 0) {
+        /* An item with this key already exists. */
+        return tbl->slots[pos];
     }
-    else {
-        update_ptr = &buckets[pos];
+
+    /* Make room first if needed.  When most used slots are DELETED, the
+     * table is rebuilt at the same size, which clears them.
+     */
+    if(tbl->n_items + tbl->n_deleted >= tbl->max_used) {
+        if(tbl->n_items < tbl->max_used / 2) {
+            hash_tbl_resize(tbl, tbl->capacity);
+        }
+        else {
+            hash_tbl_resize(tbl, tbl->capacity * 2);
+        }
     }
-    
-    /* Create a new hash table item for the item being inserted. */
-    new_item = malloc(sizeof(hash_tbl_item_t));
-    new_item->item = item;
-    new_item->next = NULL;
-    *update_ptr = new_item;
+
+    pos = hash_tbl_free_slot(tbl, hash);
+    if(tbl->ctrl[pos] == HASH_TBL_DELETED) tbl->n_deleted--;
+    tbl->ctrl[pos] = (signed char)(hash & 0x7f);
+    tbl->slots[pos] = item;
+    tbl->n_items++;
 
     return NULL;
 }
@@ -105,25 +122,9 @@ void *hash_tbl_insert(hash_tbl_t *tbl, void *item)
 void *hash_tbl_find(hash_tbl_t *tbl, void *item)
 {
     int pos;
-    hash_tbl_item_t *item_ptr, *next_item,  **buckets;
-
-    buckets = tbl->buckets;
-
-    /* Get the bucket position for the item being inserted. */
-    pos = tbl->hash_fn(item, tbl->n_buckets);
-    next_item = buckets[pos];
-    if(next_item) {
-        do {
-            item_ptr = next_item;
-	    if(!tbl->compare_fn(item_ptr->item, item)) {
-		/* An item with this key already exists. */
-		return item_ptr->item;
-	    }
-	    next_item = item_ptr->next;
-        } while(next_item);
-    }
-    
-    return NULL;
+
+    pos = hash_tbl_lookup(tbl, item, tbl->hash_fn(item));
+    return pos >= 0 ? tbl->slots[pos] : NULL;
 }
 
 
@@ -134,34 +135,181 @@ void *hash_tbl_find(hash_tbl_t *tbl, void *item)
 void *hash_tbl_delete(hash_tbl_t *tbl, void *item)
 {
     int pos;
-    hash_tbl_item_t *item_ptr, *next_item, *prev_item, **buckets;
-    hash_tbl_item_t *return_item;
-
-    buckets = tbl->buckets;
-
-    /* Get the bucket position for the item being inserted. */
-    pos = tbl->hash_fn(item, tbl->n_buckets);
-    next_item = buckets[pos];
-    if(next_item) {
-        item_ptr = NULL;
-        do {
-	    prev_item = item_ptr;
-            item_ptr = next_item;
-	    if(!tbl->compare_fn(item_ptr->item, item)) {
-		/* An item with this key already exists. */
-		return_item = item_ptr->item;
-		free(item_ptr);
-		if(prev_item) {
-		    prev_item->next = next_item;
-		}
-		else {
-                    buckets[pos] = next_item;
-		}
-		return return_item;
-	    }
-	    next_item = item_ptr->next;
-        } while(next_item);
+    signed char *group;
+
+    pos = hash_tbl_lookup(tbl, item, tbl->hash_fn(item));
+    if(pos < 0) return NULL;
+
+    /* A probe only continues past a group with no EMPTY slots.  So if this
+     * group has an EMPTY slot, no probe continues past it, and the slot can
+     * become EMPTY.  Otherwise it must be marked DELETED.
+     */
+    group = tbl->ctrl + (pos & ~(HASH_TBL_GROUP - 1));
+    if(hash_tbl_match_empty(group)) {
+        tbl->ctrl[pos] = HASH_TBL_EMPTY;
+    }
+    else {
+        tbl->ctrl[pos] = HASH_TBL_DELETED;
+        tbl->n_deleted++;
     }
+    tbl->n_items--;
 
-    return NULL;
+    return tbl->slots[pos];
+}
+
+
+
+/*** Definitions of functions that are only visible within this file. ***/
+
+/* hash_tbl_match() - returns a mask with bit i set for each slot i of group
+ * whose control byte is h2.
+ */
+unsigned int hash_tbl_match(const signed char *group, signed char h2)
+{
+#if HASH_TBL_SSE2
+    __m128i g;
+
+    g = _mm_loadu_si128((const __m128i *)group);
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8(h2)));
+#else
+    unsigned int m;
+    int i;
+
+    m = 0;
+    for(i = 0; i < HASH_TBL_GROUP; i++) if(group[i] == h2) m |= 1u << i;
+    return m;
+#endif
+}
+
+
+/* hash_tbl_match_empty() - returns a mask with bit i set for each EMPTY slot
+ * i of group.
+ */
+unsigned int hash_tbl_match_empty(const signed char *group)
+{
+    return hash_tbl_match(group, HASH_TBL_EMPTY);
+}
+
+
+/* hash_tbl_match_free() - returns a mask with bit i set for each EMPTY or
+ * DELETED slot i of group.  These are the control bytes with the sign bit
+ * set.
+ */
+unsigned int hash_tbl_match_free(const signed char *group)
+{
+#if HASH_TBL_SSE2
+    return _mm_movemask_epi8(_mm_loadu_si128((const __m128i *)group));
+#else
+    unsigned int m;
+    int i;
+
+    m = 0;
+    for(i = 0; i < HASH_TBL_GROUP; i++) if(group[i] < 0) m |= 1u << i;
+    return m;
+#endif
+}
+
+
+/* hash_tbl_lowest_bit() - returns the index of the lowest set bit in the
+ * non-zero mask m.
+ */
+int hash_tbl_lowest_bit(unsigned int m)
+{
+    int i;
+
+    for(i = 0; !(m & 1); i++) m >>= 1;
+    return i;
+}
+
+
+/* hash_tbl_lookup() - returns the slot holding an item with the same key as
+ * the item pointed to by item, whose hash value is hash, or -1 if there is
+ * no such item.
+ *
+ * Groups are probed in the order g, g+1, g+3, g+6, ... (modulo the number of
+ * groups), which visits every group when the number of groups is a power of 2.
+ */
+int hash_tbl_lookup(hash_tbl_t *tbl, const void *item, unsigned long hash)
+{
+    signed char h2;
+    unsigned int m;
+    int g, step, group_mask, pos;
+
+    h2 = (signed char)(hash & 0x7f);
+    group_mask = tbl->capacity / HASH_TBL_GROUP - 1;
+    g = (int)((hash >> 7) & group_mask);
+
+    for(step = 1; ; step++) {
+        pos = g * HASH_TBL_GROUP;
+        m = hash_tbl_match(tbl->ctrl + pos, h2);
+        while(m) {
+            if(!tbl->compare_fn(tbl->slots[pos + LOWEST_BIT(m)], item)) {
+                return pos + LOWEST_BIT(m);
+            }
+            m &= m - 1;
+        }
+        if(hash_tbl_match_empty(tbl->ctrl + pos)) return -1;
+        if(step > group_mask) return -1;
+        g = (g + step) & group_mask;
+    }
+}
+
+
+/* hash_tbl_free_slot() - returns the first EMPTY or DELETED slot in the probe
+ * sequence for the hash value hash.  The table must have such a slot.
+ */
+int hash_tbl_free_slot(hash_tbl_t *tbl, unsigned long hash)
+{
+    unsigned int m;
+    int g, step, group_mask, pos;
+
+    group_mask = tbl->capacity / HASH_TBL_GROUP - 1;
+    g = (int)((hash >> 7) & group_mask);
+
+    for(step = 1; ; step++) {
+        pos = g * HASH_TBL_GROUP;
+        m = hash_tbl_match_free(tbl->ctrl + pos);
+        if(m) return pos + LOWEST_BIT(m);
+        g = (g + step) & group_mask;
+    }
+}
+
+
+/* hash_tbl_resize() - rebuilds the table pointed to by tbl with the given
+ * number of slots, reinserting any items it holds.  This also clears DELETED
+ * slots.
+ */
+void hash_tbl_resize(hash_tbl_t *tbl, int capacity)
+{
+    signed char *old_ctrl;
+    void **old_slots;
+    unsigned long hash;
+    int i, old_capacity, pos;
+
+    old_ctrl = tbl->ctrl;
+    old_slots = tbl->slots;
+    old_capacity = old_ctrl ? tbl->capacity : 0;
+
+    tbl->capacity = capacity;
+    tbl->max_used = (int)(capacity * HASH_TBL_MAX_LOAD);
+    tbl->ctrl = malloc(capacity);
+    tbl->slots = malloc(capacity * sizeof(void *));
+    for(i = 0; i < capacity; i++) tbl->ctrl[i] = HASH_TBL_EMPTY;
+    tbl->n_items = 0;
+    tbl->n_deleted = 0;
+
+    /* Items in the old table all have distinct keys, so they can be placed
+     * without looking them up.
+     */
+    for(i = 0; i < old_capacity; i++) {
+        if(old_ctrl[i] < 0) continue;
+        hash = tbl->hash_fn(old_slots[i]);
+        pos = hash_tbl_free_slot(tbl, hash);
+        tbl->ctrl[pos] = (signed char)(hash & 0x7f);
+        tbl->slots[pos] = old_slots[i];
+        tbl->n_items++;
+    }
+
+    free(old_ctrl);
+    free(old_slots);
 }
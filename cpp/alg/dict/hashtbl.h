@@ -5,49 +5,97 @@
 #ifndef HASHTBL_H
 #define HASHTBL_H
 
-/*** Structure Type Definitions. ***/
+/* The hash table uses open addressing in the style of a "Swiss table".  Items
+ * are stored in an array of slots, and each slot has a one byte control value
+ * which is either EMPTY, DELETED, or, for a slot holding an item, the low 7
+ * bits of the item's hash value.  Slots are grouped into groups of
+ * HASH_TBL_GROUP consecutive slots.  The remaining bits of the hash value
+ * choose the group where probing for an item starts.  The control bytes of a
+ * whole group are compared against the 7 bit hash value at once, using SSE2
+ * instructions where available, so that the compare function is usually only
+ * called for the item being looked for.  Probing moves on to other groups
+ * until a group with an EMPTY slot is reached.
+ *
+ * Hash values are full unsigned long values that do not depend on the table
+ * size, so the table can grow without the hash function being changed.  The
+ * table doubles in size when the slots in use, including DELETED slots, would
+ * exceed HASH_TBL_MAX_LOAD of the slots.
+ */
+
+
+/*** Compile Time Options ***/
+
+/* The maximum fraction of slots that may be in use, including DELETED slots,
+ * before the table is resized.
+ */
+#define HASH_TBL_MAX_LOAD 0.9375
+
+/* Use 1 to probe groups of control bytes with SSE2 instructions when the
+ * compiler supports them, or 0 to always use portable C.
+ */
+#define HASH_TBL_USE_SSE2 1
+
 
-/* Structure type definition for items in the hash table:
- *     item - a pointer to the item.
- *     next - a pointer to the next item in the buckets linked list.
+
+/*** Constants ***/
+
+/* The number of slots in a group.  The table size is always a power of 2
+ * which is at least this.
  */
-typedef struct hash_tbl_item {
-    void *item;
-    struct hash_tbl_item *next;
-} hash_tbl_item_t;
+#define HASH_TBL_GROUP 16
+
+/* Control byte values for slots not holding an item.  Control bytes of slots
+ * holding an item are in the range 0 to 127.
+ */
+#define HASH_TBL_EMPTY   ((signed char)-128)
+#define HASH_TBL_DELETED ((signed char)-2)
+
+
+
+/*** Structure Type Definitions. ***/
 
 /* Structure type definition for the hash table:
- *     n_buckets - the number of buckets in the hash table.
- *     buckets - an array of pointers to head items in the linked lists of
- *               hash table buckets.
+ *     capacity - the number of slots, a power of 2.
+ *     n_items - the number of items in the table.
+ *     n_deleted - the number of DELETED slots.
+ *     max_used - the table is resized before n_items + n_deleted exceeds
+ *                this.
+ *     ctrl - an array of control bytes, one for each slot.
+ *     slots - an array of pointers to the items in each slot.
  *     hash_fn - a pointer to the function for hashing an items key.
  *     compare_fn - a pointer to the function for comparing items.
  */
 typedef struct hash_tbl {
-    int n_buckets;
-    hash_tbl_item_t **buckets;
-    int (*hash_fn)(const void *item, int n);
+    int capacity;
+    int n_items;
+    int n_deleted;
+    int max_used;
+    signed char *ctrl;
+    void **slots;
+    unsigned long (*hash_fn)(const void *item);
     int (*compare_fn)(const void *item1, const void *item2);
 } hash_tbl_t;
 
 
 
-/* hash_tbl_alloc() - Returns a pointer to a hash table with n_buckets buckets.
- * Pointers to the following functions are required:
+/* hash_tbl_alloc() - Returns a pointer to a hash table with space for at
+ * least n_items items before it first needs to grow.  Pointers to the
+ * following functions are required:
  *     hash_fn - A hash function, which hashes the key of the item pointed to
- *               by item to a bucket number between 0 and n-1.
+ *               by item to an unsigned long.  All bits of the value are used,
+ *               so they should be well mixed.
  *     comp_fn - A comparison function.  Should returns zero only if item1 and
  *               item2 have the same key.
  */
-hash_tbl_t *hash_tbl_alloc(int n_buckets,
-			   int (*hash_fn)(const void *item, int n),
+hash_tbl_t *hash_tbl_alloc(int n_items,
+			   unsigned long (*hash_fn)(const void *item),
 			   int (*comp_fn)(const void *item1, const void *item2)
                            );
 
 /* hash_tbl_free() - Frees up space used by the hash table pointed to by tbl.
  */
 void hash_tbl_free(hash_tbl_t *tbl);
-    
+
 /* hash_tbl_insert() - Insert the item pointed to by `item' into the hash table
  * pointed to by tbl.  If an item with the same key already exists in the
  * table, a pointer to that item is returned.  If the item was inserted
@@ -0,0 +1,258 @@
+/*** File: mph_test.c - Test program for the minimal perfect hash table ***/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "mphtbl.h"
+#include "hashtbl.h"
+#include "bench_util.h"
+
+
+/* This program first checks the minimal perfect hash table on sets of several
+ * sizes: every item must be found, each in its own slot, and keys which are
+ * not in the set must not be found.  The same checks are made on each table
+ * after it has been saved to a file and loaded again, and a set with two
+ * equal keys must fail to build.
+ *
+ * It then builds a table of N_BENCH items with 1 up to the number of online
+ * processors, or a maximum number of threads given on the command line, and
+ * reports the build times, the size of the index in bits per item, and the
+ * time to load the table from a file.  Last, it compares the time per find
+ * with the hash table of hashtbl.h, for keys in the set and keys not in it.
+ * All times are elapsed (wall clock) times.
+ *
+ * Usage: mph_test [max_threads]
+ */
+
+#define N_BENCH (1 << 22)
+#define N_LOOKUPS (1 << 22)
+
+
+/* Structure type for items.  Keys in the sets are even, so odd keys are not
+ * in them.
+ */
+typedef struct test_item {
+    int key;
+    int other_data;
+} test_item_t;
+
+
+/* Function to compare two items. */
+int compare_fn(const void *item1, const void *item2)
+{
+    return ((test_item_t *)item1)->key - ((test_item_t *)item2)->key;
+}
+
+/* Hash function to use. */
+unsigned long hash_fn(const void *item)
+{
+    return hash_mix((unsigned long)((test_item_t *)item)->key);
+}
+
+
+/* Make n items with keys 0, 2, ..., 2n-2, and return an array of pointers to
+ * them in random order.  The items are in the block pointed to by *block.
+ */
+void **make_items(int n, test_item_t **block)
+{
+    void **items, *tmp;
+    unsigned long seed = 88172645463325252UL;
+    int i, j;
+
+    *block = malloc(n * sizeof(test_item_t) + 1);
+    items = malloc(n * sizeof(void *) + 1);
+    for(i = 0; i < n; i++) {
+        (*block)[i].key = 2 * i;
+        (*block)[i].other_data = i;
+        items[i] = &(*block)[i];
+    }
+    for(i = n - 1; i > 0; i--) {
+        j = (int)(next_rand(&seed) % (i + 1));
+        tmp = items[i];  items[i] = items[j];  items[j] = tmp;
+    }
+
+    return items;
+}
+
+
+/* Check the table pointed to by tbl, which should hold the n items with keys
+ * 0, 2, ..., 2n-2.  When loaded is 0, the items found must be those of block.
+ * Returns the number of errors.
+ */
+int check_tbl(mph_tbl_t *tbl, int n, test_item_t *block, int loaded)
+{
+    test_item_t key, *found;
+    char *seen;
+    int i, slot, errors;
+
+    errors = 0;
+    seen = calloc(n + 1, 1);
+    for(i = 0; i < n; i++) {
+        key.key = 2 * i;
+        slot = mph_tbl_index(tbl, &key);
+        if(slot < 0 || slot >= n || seen[slot]) {
+            errors++;
+            continue;
+        }
+        seen[slot] = 1;
+        found = mph_tbl_find(tbl, &key);
+        if(!found || found->key != 2 * i || found->other_data != i
+           || (!loaded && found != &block[i])
+           || tbl->items[slot] != found) {
+            errors++;
+        }
+        key.key = 2 * i + 1;
+        if(mph_tbl_find(tbl, &key)) errors++;
+    }
+    free(seen);
+
+    return errors;
+}
+
+
+/* Check tables of n items, built with n_threads threads.  Returns the number
+ * of errors.
+ */
+int check(int n, int n_threads)
+{
+    mph_tbl_t *tbl, *loaded;
+    test_item_t *block;
+    void **items;
+    FILE *fp;
+    int errors;
+
+    errors = 0;
+    items = make_items(n, &block);
+    tbl = mph_tbl_build(items, n, n_threads, hash_fn, compare_fn);
+    if(!tbl) return 1;
+    errors += check_tbl(tbl, n, block, 0);
+
+    fp = tmpfile();
+    if(!fp || mph_tbl_save(tbl, fp, sizeof(test_item_t)) != 0) return 1;
+    rewind(fp);
+    loaded = mph_tbl_load(fp, hash_fn, compare_fn);
+    fclose(fp);
+    if(!loaded) return 1;
+    errors += check_tbl(loaded, n, block, 1);
+    mph_tbl_free(tbl);
+
+    /* Two items with the same key. */
+    if(n >= 2) {
+        block[0].key = block[1].key;
+        if((tbl = mph_tbl_build(items, n, n_threads, hash_fn, compare_fn))) {
+            errors++;
+            mph_tbl_free(tbl);
+        }
+    }
+
+    mph_tbl_free(loaded);
+    free(items);
+    free(block);
+
+    return errors;
+}
+
+
+/* Build a table of N_BENCH items with 1 up to max_threads threads, and then
+ * compare the time per find with the hash table of hashtbl.h.
+ */
+void bench(int max_threads)
+{
+    mph_tbl_t *tbl;
+    hash_tbl_t *htbl;
+    test_item_t *block, *keys;
+    void **items;
+    FILE *fp;
+    unsigned long seed = 2463534242UL;
+    double start, msec, bits;
+    long found;
+    int i, t, hit;
+
+    items = make_items(N_BENCH, &block);
+
+    printf("\nBuilding a table of %d items\n", N_BENCH);
+    printf("threads,\tmsec\n");
+    tbl = NULL;
+    for(t = 1; t <= max_threads; t++) {
+        if(tbl) mph_tbl_free(tbl);
+        start = wall_msec();
+        tbl = mph_tbl_build(items, N_BENCH, t, hash_fn, compare_fn);
+        printf("%d\t%.1f\n", t, wall_msec() - start);
+    }
+
+    bits = 8.0 * (tbl->n_parts * sizeof(mph_part_t)
+                  + tbl->n_buckets * sizeof(unsigned short)
+                  + tbl->n_remap * sizeof(unsigned int)) / N_BENCH;
+    printf("Index size: %.2f bits per item\n", bits);
+
+    fp = tmpfile();
+    mph_tbl_save(tbl, fp, sizeof(test_item_t));
+    rewind(fp);
+    start = wall_msec();
+    mph_tbl_free(tbl);
+    tbl = mph_tbl_load(fp, hash_fn, compare_fn);
+    printf("Load from file: %.1f msec\n", wall_msec() - start);
+    fclose(fp);
+
+    htbl = hash_tbl_alloc(N_BENCH, hash_fn, compare_fn);
+    for(i = 0; i < N_BENCH; i++) hash_tbl_insert(htbl, items[i]);
+
+    keys = malloc(N_LOOKUPS * sizeof(test_item_t));
+    printf("\nFind time (nsec)\n");
+    printf("keys,\t\tmph,\thashtbl\n");
+    for(hit = 1; hit >= 0; hit--) {
+        for(i = 0; i < N_LOOKUPS; i++) {
+            keys[i].key = 2 * (int)(next_rand(&seed) % N_BENCH) + !hit;
+        }
+        printf("%s", hit ? "present" : "absent ");
+
+        found = 0;
+        start = wall_msec();
+        for(i = 0; i < N_LOOKUPS; i++) {
+            if(mph_tbl_find(tbl, &keys[i])) found++;
+        }
+        msec = wall_msec() - start;
+        printf("\t%.1f", msec * 1e6 / N_LOOKUPS);
+
+        start = wall_msec();
+        for(i = 0; i < N_LOOKUPS; i++) {
+            if(hash_tbl_find(htbl, &keys[i])) found--;
+        }
+        msec = wall_msec() - start;
+        printf("\t%.1f\n", msec * 1e6 / N_LOOKUPS);
+        if(found) printf("Find results differ\n");
+    }
+
+    mph_tbl_free(tbl);
+    hash_tbl_free(htbl);
+    free(keys);
+    free(items);
+    free(block);
+}
+
+
+int main(int argc, char *argv[])
+{
+    static const int sizes[] = { 0, 1, 2, 100, 20000, 300000 };
+    int i, t, max_threads, errors, e;
+
+    max_threads = argc > 1 ? atoi(argv[1])
+                           : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if(max_threads < 1) max_threads = 1;
+
+    errors = 0;
+    for(i = 0; i < (int)(sizeof(sizes) / sizeof(int)); i++) {
+        for(t = 1; t <= 4; t *= 4) {
+            e = check(sizes[i], t);
+            printf("Check of %d items, %d threads: %s\n", sizes[i], t,
+                   e ? "FAILED" : "passed");
+            errors += e;
+        }
+    }
+
+    bench(max_threads);
+
+    if(errors) printf("\n%d errors\n", errors);
+
+    return errors != 0;
+}
@@ -0,0 +1,548 @@
+/*** File mphtbl.c - Minimal Perfect Hash Table ***/
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "mphtbl.h"
+
+/* The fraction of items sent to the dense buckets, and the fraction of
+ * buckets which are dense, as in PTHash.  MPH_TBL_SKEW is MPH_TBL_DENSE_ITEMS
+ * of 2^32.
+ */
+#define MPH_TBL_DENSE_ITEMS 0.6
+#define MPH_TBL_DENSE_BUCKETS 0.3
+#define MPH_TBL_SKEW ((unsigned long)(MPH_TBL_DENSE_ITEMS * 4294967296.0))
+
+/* The number of pilots which are tried for each bucket. */
+#define MPH_TBL_PILOTS 65536
+
+/* The seed of the hash that chooses partitions, which also spreads the bits
+ * of pilots.
+ */
+#define MPH_TBL_SEED 0x9e3779b97f4a7c15UL
+
+/* The first bytes of a saved table. */
+#define MPH_TBL_MAGIC "MPHT"
+
+/* The state passed to each thread building partitions:
+ *     tbl - the table being built.
+ *     x - the partition hash of each item, grouped by partition.
+ *     items - the items, in the same order as x.
+ *     first - the first partition the thread builds.  It builds every
+ *             step-th partition from there.
+ *     failed - set to 1 if a partition could not be built.
+ */
+typedef struct mph_build_arg {
+    mph_tbl_t *tbl;
+    unsigned long *x;
+    void **items;
+    int first, step;
+    int failed;
+} mph_build_arg_t;
+
+/* The header of a saved table. */
+typedef struct mph_file_header {
+    char magic[4];
+    int n_items, n_parts, n_buckets, n_remap;
+    int item_size;
+    unsigned long seed;
+} mph_file_header_t;
+
+
+
+/*** Prototypes of functions only visible within this file. ***/
+
+unsigned long mph_tbl_mix(unsigned long x);
+unsigned int mph_tbl_part(mph_tbl_t *tbl, unsigned long x);
+unsigned int mph_tbl_bucket(unsigned long z, unsigned int n_buckets);
+unsigned int mph_tbl_pos(unsigned long z, unsigned long pilot, unsigned int m);
+void *mph_tbl_build_thread(void *p);
+int mph_tbl_build_part(mph_tbl_t *tbl, int part_no, unsigned long *x,
+                       void **items);
+mph_tbl_t *mph_tbl_new(int n_items, int n_parts, int n_buckets, int n_remap);
+
+
+
+/*** Definitions of functions visible outside of this file. ***/
+
+/* mph_tbl_build() - Returns a pointer to a minimal perfect hash table of the
+ * n_items items pointed to by items[], built by n_threads threads.  Pointers
+ * to the following functions are required:
+ *     hash_fn - A hash function, which hashes the key of the item pointed to
+ *               by item to an unsigned long.
+ *     comp_fn - A comparison function.  Should returns zero only if item1 and
+ *               item2 have the same key.
+ * No two items may have the same hash value.  If two do, or the table can not
+ * otherwise be built, NULL is returned.
+ */
+mph_tbl_t *mph_tbl_build(void **items, int n_items, int n_threads,
+			 unsigned long (*hash_fn)(const void *item),
+			 int (*comp_fn)(const void *item1, const void *item2)
+                         )
+{
+    mph_tbl_t *tbl;
+    mph_part_t *part;
+    mph_build_arg_t *args;
+    pthread_t *threads;
+    unsigned long *x, *part_x;
+    void **part_items;
+    int *start;
+    int i, p, n_parts, n_buckets, n_remap, failed;
+    unsigned int m;
+
+    /* Hash the items, and count the items of each partition. */
+    n_parts = (n_items + MPH_TBL_PARTITION - 1) / MPH_TBL_PARTITION;
+    if(n_parts < 1) n_parts = 1;
+    tbl = mph_tbl_new(n_items, n_parts, 0, 0);
+    tbl->seed = MPH_TBL_SEED;
+    tbl->hash_fn = hash_fn;
+    tbl->compare_fn = comp_fn;
+
+    x = malloc(n_items * sizeof(unsigned long));
+    start = calloc(n_parts + 1, sizeof(int));
+    for(i = 0; i < n_items; i++) {
+        x[i] = mph_tbl_mix(hash_fn(items[i]) ^ tbl->seed);
+        start[mph_tbl_part(tbl, x[i]) + 1]++;
+    }
+
+    /* Lay out the partitions, their pilots and their remap entries. */
+    n_buckets = n_remap = 0;
+    for(p = 0; p < n_parts; p++) {
+        part = &tbl->parts[p];
+        part->offset = start[p];
+        part->n = start[p + 1];
+        m = (unsigned int)(part->n / MPH_TBL_LOAD);
+        part->m = m < part->n ? part->n : m;
+        part->bucket = n_buckets;
+        part->n_buckets = (part->n + MPH_TBL_BUCKET_SIZE - 1)
+                          / MPH_TBL_BUCKET_SIZE;
+        part->remap = n_remap;
+        n_buckets += part->n_buckets;
+        n_remap += part->m - part->n;
+        start[p + 1] += start[p];
+    }
+    tbl->n_buckets = n_buckets;
+    tbl->n_remap = n_remap;
+    tbl->pilots = realloc(tbl->pilots, n_buckets * sizeof(unsigned short) + 1);
+    tbl->remap = realloc(tbl->remap, n_remap * sizeof(unsigned int) + 1);
+
+    /* Group the items by partition. */
+    part_x = malloc(n_items * sizeof(unsigned long));
+    part_items = malloc(n_items * sizeof(void *));
+    for(i = 0; i < n_items; i++) {
+        p = start[mph_tbl_part(tbl, x[i])]++;
+        part_x[p] = x[i];
+        part_items[p] = items[i];
+    }
+    free(x);
+    free(start);
+
+    /* Build the partitions, with each thread taking every n_threads-th
+     * partition.
+     */
+    if(n_threads > n_parts) n_threads = n_parts;
+    if(n_threads < 1) n_threads = 1;
+    args = malloc(n_threads * sizeof(mph_build_arg_t));
+    threads = malloc(n_threads * sizeof(pthread_t));
+    for(i = 0; i < n_threads; i++) {
+        args[i].tbl = tbl;
+        args[i].x = part_x;
+        args[i].items = part_items;
+        args[i].first = i;
+        args[i].step = n_threads;
+        args[i].failed = 0;
+        if(i > 0) {
+            pthread_create(&threads[i], NULL, mph_tbl_build_thread, &args[i]);
+        }
+    }
+    mph_tbl_build_thread(&args[0]);
+    failed = args[0].failed;
+    for(i = 1; i < n_threads; i++) {
+        pthread_join(threads[i], NULL);
+        failed |= args[i].failed;
+    }
+
+    free(args);
+    free(threads);
+    free(part_x);
+    free(part_items);
+
+    if(failed) {
+        mph_tbl_free(tbl);
+        return NULL;
+    }
+    return tbl;
+}
+
+
+/* mph_tbl_free() - Frees up space used by the minimal perfect hash table
+ * pointed to by tbl, including the items if it was loaded from a file.
+ */
+void mph_tbl_free(mph_tbl_t *tbl)
+{
+    free(tbl->parts);
+    free(tbl->pilots);
+    free(tbl->remap);
+    free(tbl->items);
+    free(tbl->store);
+    free(tbl);
+}
+
+
+/* mph_tbl_index() - Returns the slot, from 0 to n_items - 1, of the item in
+ * the table pointed to by tbl with the same key as `item'.  Each item of the
+ * table has a different slot.  For keys not in the table, the slot of an
+ * arbitrary item, or -1, is returned.
+ */
+int mph_tbl_index(mph_tbl_t *tbl, const void *item)
+{
+    mph_part_t *part;
+    unsigned long x, z, pilot;
+    unsigned int pos;
+
+    x = mph_tbl_mix(tbl->hash_fn(item) ^ tbl->seed);
+    part = &tbl->parts[mph_tbl_part(tbl, x)];
+    if(!part->n) return -1;
+
+    z = mph_tbl_mix(x ^ part->seed);
+    pilot = tbl->pilots[part->bucket + mph_tbl_bucket(z, part->n_buckets)];
+    pos = mph_tbl_pos(z, pilot, part->m);
+    if(pos >= part->n) pos = tbl->remap[part->remap + pos - part->n];
+
+    return part->offset + pos;
+}
+
+
+/* mph_tbl_find() - Returns a pointer to an item with the same key as `item'
+ * in the minimal perfect hash table pointed to by tbl.  If no matching item is
+ * found, NULL is returned.
+ */
+void *mph_tbl_find(mph_tbl_t *tbl, const void *item)
+{
+    void *found;
+    int i;
+
+    i = mph_tbl_index(tbl, item);
+    if(i < 0) return NULL;
+    found = tbl->items[i];
+    return tbl->compare_fn(found, item) == 0 ? found : NULL;
+}
+
+
+/* mph_tbl_save() - Writes the minimal perfect hash table pointed to by tbl to
+ * the file fp, with the item_size bytes of each item.  The items must not
+ * hold pointers.  The file is only readable on machines with the same byte
+ * order and type sizes.  Returns 0 on success, or -1 if a write failed.
+ */
+int mph_tbl_save(mph_tbl_t *tbl, FILE *fp, int item_size)
+{
+    mph_file_header_t h;
+    int i;
+
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, MPH_TBL_MAGIC, 4);
+    h.n_items = tbl->n_items;
+    h.n_parts = tbl->n_parts;
+    h.n_buckets = tbl->n_buckets;
+    h.n_remap = tbl->n_remap;
+    h.item_size = item_size;
+    h.seed = tbl->seed;
+
+    if(fwrite(&h, sizeof(h), 1, fp) != 1
+       || fwrite(tbl->parts, sizeof(mph_part_t), h.n_parts, fp)
+          != (size_t)h.n_parts
+       || fwrite(tbl->pilots, sizeof(unsigned short), h.n_buckets, fp)
+          != (size_t)h.n_buckets
+       || fwrite(tbl->remap, sizeof(unsigned int), h.n_remap, fp)
+          != (size_t)h.n_remap) {
+        return -1;
+    }
+    for(i = 0; i < tbl->n_items; i++) {
+        if(fwrite(tbl->items[i], item_size, 1, fp) != 1) return -1;
+    }
+
+    return fflush(fp) == 0 ? 0 : -1;
+}
+
+
+/* mph_tbl_load() - Reads a minimal perfect hash table written by
+ * mph_tbl_save() from the file fp, and returns a pointer to it.  The items
+ * are read into space owned by the table.  hash_fn and comp_fn must be the
+ * functions the table was built with.  Returns NULL if the file could not be
+ * read.
+ */
+mph_tbl_t *mph_tbl_load(FILE *fp,
+			unsigned long (*hash_fn)(const void *item),
+			int (*comp_fn)(const void *item1, const void *item2))
+{
+    mph_file_header_t h;
+    mph_tbl_t *tbl;
+    size_t size;
+    int i;
+
+    if(fread(&h, sizeof(h), 1, fp) != 1
+       || memcmp(h.magic, MPH_TBL_MAGIC, 4) != 0
+       || h.n_items < 0 || h.n_parts < 1 || h.n_buckets < 0
+       || h.n_remap < 0 || h.item_size < 1) {
+        return NULL;
+    }
+
+    tbl = mph_tbl_new(h.n_items, h.n_parts, h.n_buckets, h.n_remap);
+    tbl->seed = h.seed;
+    tbl->hash_fn = hash_fn;
+    tbl->compare_fn = comp_fn;
+    size = (size_t)h.n_items * h.item_size;
+    tbl->store = malloc(size + 1);
+
+    if(fread(tbl->parts, sizeof(mph_part_t), h.n_parts, fp)
+          != (size_t)h.n_parts
+       || fread(tbl->pilots, sizeof(unsigned short), h.n_buckets, fp)
+          != (size_t)h.n_buckets
+       || fread(tbl->remap, sizeof(unsigned int), h.n_remap, fp)
+          != (size_t)h.n_remap
+       || fread(tbl->store, 1, size, fp) != size) {
+        mph_tbl_free(tbl);
+        return NULL;
+    }
+    for(i = 0; i < h.n_items; i++) {
+        tbl->items[i] = tbl->store + (size_t)i * h.item_size;
+    }
+
+    return tbl;
+}
+
+
+
+/*** Definitions of functions that are only visible within this file. ***/
+
+/* mph_tbl_mix() - returns the bits of x mixed by the 64-bit finaliser of
+ * MurmurHash3.  Different values of x give different results.
+ */
+unsigned long mph_tbl_mix(unsigned long x)
+{
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdUL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53UL;
+    x ^= x >> 33;
+    return x;
+}
+
+
+/* mph_tbl_part() - returns the partition of the item with partition hash x,
+ * from the high 32 bits of x.
+ */
+unsigned int mph_tbl_part(mph_tbl_t *tbl, unsigned long x)
+{
+    return (unsigned int)(((x >> 32) * (unsigned long)tbl->n_parts) >> 32);
+}
+
+
+/* mph_tbl_bucket() - returns the bucket, from 0 to n_buckets - 1, of the item
+ * with bucket hash z.  MPH_TBL_DENSE_ITEMS of the items go to the first
+ * MPH_TBL_DENSE_BUCKETS of the buckets.
+ */
+unsigned int mph_tbl_bucket(unsigned long z, unsigned int n_buckets)
+{
+    unsigned long hi;
+    unsigned int dense;
+
+    hi = z >> 32;
+    dense = (unsigned int)(n_buckets * MPH_TBL_DENSE_BUCKETS);
+    if(dense == 0) return (unsigned int)((hi * n_buckets) >> 32);
+    if((z & 0xffffffffUL) < MPH_TBL_SKEW) {
+        return (unsigned int)((hi * dense) >> 32);
+    }
+    return dense + (unsigned int)((hi * (n_buckets - dense)) >> 32);
+}
+
+
+/* mph_tbl_pos() - returns the position, from 0 to m - 1, of the item with
+ * bucket hash z when its bucket has the given pilot.  The pilot is mixed in
+ * before the bits of the position are mixed, since an exclusive or of the
+ * position alone would move all of a bucket's items together, and never
+ * separate two which collide.  The high 32 bits of the mixed value are scaled
+ * to m, which avoids a division.
+ */
+unsigned int mph_tbl_pos(unsigned long z, unsigned long pilot, unsigned int m)
+{
+    return (unsigned int)(((mph_tbl_mix(z ^ (pilot * MPH_TBL_SEED)) >> 32)
+                           * m) >> 32);
+}
+
+
+/* mph_tbl_build_thread() - builds the partitions given by the
+ * mph_build_arg_t pointed to by p.
+ */
+void *mph_tbl_build_thread(void *p)
+{
+    mph_build_arg_t *arg;
+    mph_part_t *part;
+    int i;
+
+    arg = p;
+    for(i = arg->first; i < arg->tbl->n_parts && !arg->failed;
+        i += arg->step) {
+        part = &arg->tbl->parts[i];
+        if(!mph_tbl_build_part(arg->tbl, i, arg->x + part->offset,
+                               arg->items + part->offset)) {
+            arg->failed = 1;
+        }
+    }
+
+    return NULL;
+}
+
+
+/* mph_tbl_build_part() - finds the seed, pilots and remap entries of
+ * partition part_no of tbl, whose items are items[] with partition hashes
+ * x[], and places the items.  Returns 1 on success, or 0 if no seed was found
+ * in MPH_TBL_MAX_TRIES tries, or if two items have the same hash value.
+ */
+int mph_tbl_build_part(mph_tbl_t *tbl, int part_no, unsigned long *x,
+                       void **items)
+{
+    mph_part_t *part;
+    unsigned long *zs, z;
+    unsigned int n, m, nb, *bucket, *start, *order, *by_size, *size_start;
+    unsigned int *pos, b, i, j, k, s, max_size, pilot, q;
+    unsigned char *taken;
+    int attempt, ok;
+
+    part = &tbl->parts[part_no];
+    n = part->n;
+    m = part->m;
+    nb = part->n_buckets;
+    if(n == 0) return 1;
+
+    zs = malloc(n * sizeof(unsigned long));
+    bucket = malloc(n * sizeof(unsigned int));
+    order = malloc(n * sizeof(unsigned int));
+    pos = malloc(n * sizeof(unsigned int));
+    start = malloc((nb + 1) * sizeof(unsigned int));
+    by_size = malloc(nb * sizeof(unsigned int));
+    taken = malloc(m);
+    size_start = NULL;
+
+    ok = 0;
+    for(attempt = 0; attempt < MPH_TBL_MAX_TRIES && !ok; attempt++) {
+        part->seed = mph_tbl_mix(tbl->seed
+                                 + (unsigned long)part_no * MPH_TBL_MAX_TRIES
+                                 + attempt + 1);
+
+        /* Hash the items to buckets, and sort them by bucket. */
+        memset(start, 0, (nb + 1) * sizeof(unsigned int));
+        for(i = 0; i < n; i++) {
+            z = mph_tbl_mix(x[i] ^ part->seed);
+            bucket[i] = mph_tbl_bucket(z, nb);
+            zs[i] = z;
+            start[bucket[i] + 1]++;
+        }
+        max_size = 0;
+        for(b = 0; b < nb; b++) {
+            if(start[b + 1] > max_size) max_size = start[b + 1];
+            start[b + 1] += start[b];
+        }
+        for(i = 0; i < n; i++) order[start[bucket[i]]++] = i;
+        for(b = nb; b > 0; b--) start[b] = start[b - 1];
+        start[0] = 0;
+
+        /* Items with the same hash value always share a bucket, and can
+         * never be separated.
+         */
+        for(b = 0; b < nb; b++) {
+            for(j = start[b]; j < start[b + 1]; j++) {
+                for(k = j + 1; k < start[b + 1]; k++) {
+                    if(x[order[j]] == x[order[k]]) goto fail;
+                }
+            }
+        }
+
+        /* Sort the buckets by decreasing size. */
+        free(size_start);
+        size_start = calloc(max_size + 2, sizeof(unsigned int));
+        for(b = 0; b < nb; b++) {
+            size_start[max_size - (start[b + 1] - start[b]) + 1]++;
+        }
+        for(s = 0; s <= max_size; s++) size_start[s + 1] += size_start[s];
+        for(b = 0; b < nb; b++) {
+            by_size[size_start[max_size - (start[b + 1] - start[b])]++] = b;
+        }
+
+        /* Search for each bucket's pilot, placing the largest buckets first.
+         * A position is taken as soon as an item is placed there, and the
+         * bucket's positions are released again if a later item of the
+         * bucket collides.
+         */
+        memset(taken, 0, m);
+        ok = 1;
+        for(k = 0; k < nb && ok; k++) {
+            b = by_size[k];
+            if(start[b] == start[b + 1]) break;
+            for(pilot = 0; pilot < MPH_TBL_PILOTS; pilot++) {
+                for(j = start[b]; j < start[b + 1]; j++) {
+                    q = mph_tbl_pos(zs[order[j]], pilot, m);
+                    if(taken[q]) break;
+                    taken[q] = 1;
+                    pos[order[j]] = q;
+                }
+                if(j == start[b + 1]) break;
+                while(j > start[b]) taken[pos[order[--j]]] = 0;
+            }
+            if(pilot == MPH_TBL_PILOTS) ok = 0;
+            else tbl->pilots[part->bucket + b] = (unsigned short)pilot;
+        }
+        for(; k < nb && ok; k++) tbl->pilots[part->bucket + by_size[k]] = 0;
+    }
+
+    if(ok) {
+        /* Remap the items at positions n to m-1 to the free slots below n. */
+        for(q = n, j = 0; q < m; q++) {
+            if(taken[q]) {
+                while(taken[j]) j++;
+                tbl->remap[part->remap + q - n] = j++;
+            }
+            else {
+                tbl->remap[part->remap + q - n] = 0;
+            }
+        }
+        for(i = 0; i < n; i++) {
+            q = pos[i];
+            if(q >= n) q = tbl->remap[part->remap + q - n];
+            tbl->items[part->offset + q] = items[i];
+        }
+    }
+
+  fail:
+    free(zs);
+    free(bucket);
+    free(order);
+    free(pos);
+    free(start);
+    free(by_size);
+    free(taken);
+    free(size_start);
+
+    return ok;
+}
+
+
+/* mph_tbl_new() - returns a pointer to a table with space for n_items items,
+ * n_parts partitions, n_buckets pilots and n_remap remap entries.
+ */
+mph_tbl_t *mph_tbl_new(int n_items, int n_parts, int n_buckets, int n_remap)
+{
+    mph_tbl_t *tbl;
+
+    tbl = malloc(sizeof(mph_tbl_t));
+    tbl->n_items = n_items;
+    tbl->n_parts = n_parts;
+    tbl->n_buckets = n_buckets;
+    tbl->n_remap = n_remap;
+    tbl->parts = calloc(n_parts, sizeof(mph_part_t));
+    tbl->pilots = malloc(n_buckets * sizeof(unsigned short) + 1);
+    tbl->remap = malloc(n_remap * sizeof(unsigned int) + 1);
+    tbl->items = malloc(n_items * sizeof(void *) + 1);
+    tbl->store = NULL;
+
+    return tbl;
+}
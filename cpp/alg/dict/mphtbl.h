@@ -0,0 +1,165 @@
+/*** File mphtbl.h - Minimal Perfect Hash Table ***/
+#ifndef MPHTBL_H
+#define MPHTBL_H
+
+#include <stdio.h>
+
+/* A read-only hash table for a set of items which is known in advance.  It
+ * has the same item, hash function and compare function contract as the hash
+ * table in hashtbl.h, but it is built once from all of its items and can not
+ * be changed afterwards.
+ *
+ * The table is built around a minimal perfect hash function, which maps the n
+ * items to the slots 0, 1, ..., n-1 of a dense item array with no two items
+ * in the same slot.  The construction follows PTHash.  Items are split into
+ * partitions of about MPH_TBL_PARTITION items by their hash value, and each
+ * partition is built separately, so partitions can be built by several
+ * threads at once.  Within a partition, items are hashed into buckets, with
+ * the buckets of small numbers holding more items than the others.  Buckets
+ * are placed in decreasing order of size.  For each bucket, a 16 bit pilot is
+ * searched for that sends all of the bucket's items to free positions of the
+ * partition, when each item's position is found from its hash value and a
+ * hash of the pilot.  The partition has slightly more positions than items,
+ * to keep the search short for the last buckets, and the items sent to the
+ * extra positions are remapped to the free slots below the partition size.
+ *
+ * The index - the pilots, the remap entries and a small header for each
+ * partition - takes a little over 16 / MPH_TBL_BUCKET_SIZE + 32 * (1 /
+ * MPH_TBL_LOAD - 1) bits per item, which is about 3 with the default options.
+ * A lookup hashes the key once, reads one pilot, and then reads one slot of
+ * the item array, which holds the only item that can have that key.  There
+ * are no chains or probe sequences.
+ *
+ * Hash values must be well mixed unsigned long values, and no two items of
+ * the table may have the same hash value.  Items which are plain data, with
+ * no pointers, can be saved to a file with the table and loaded back without
+ * building the table again.
+ */
+
+
+/*** Compile Time Options ***/
+
+/* The average number of items in a partition. */
+#define MPH_TBL_PARTITION 16384
+
+/* The average number of items in a bucket.  Larger buckets use fewer bits per
+ * item, but take longer to build.
+ */
+#define MPH_TBL_BUCKET_SIZE 6
+
+/* The number of items in a partition divided by its number of positions. */
+#define MPH_TBL_LOAD 0.99
+
+/* The number of times a partition is tried, with different seeds, before the
+ * build gives up.
+ */
+#define MPH_TBL_MAX_TRIES 32
+
+
+
+/*** Structure Type Definitions. ***/
+
+/* A partition of the table:
+ *     seed - the seed of the hash that places the partition's items.
+ *     offset - the first slot of the partition in the item array.
+ *     n - the number of items in the partition.
+ *     m - the number of positions, n <= m.
+ *     bucket - the first pilot of the partition.
+ *     n_buckets - the number of buckets, and pilots, of the partition.
+ *     remap - the first remap entry of the partition.  There are m - n.
+ */
+typedef struct mph_part {
+    unsigned long seed;
+    unsigned int offset;
+    unsigned int n;
+    unsigned int m;
+    unsigned int bucket;
+    unsigned int n_buckets;
+    unsigned int remap;
+} mph_part_t;
+
+/* Structure type definition for the minimal perfect hash table:
+ *     n_items - the number of items in the table.
+ *     n_parts - the number of partitions.
+ *     n_buckets - the total number of buckets of all partitions.
+ *     n_remap - the total number of remap entries of all partitions.
+ *     seed - the seed of the hash that chooses partitions.
+ *     parts - the array of partitions.
+ *     pilots - the pilot of each bucket.
+ *     remap - for each partition, the slot of the item at each position from
+ *             n up to m - 1, relative to the partition's offset.
+ *     items - the array of pointers to the items, in slot order.
+ *     store - when the table was loaded from a file, the space holding the
+ *             items.  Otherwise NULL.
+ *     hash_fn - a pointer to the function for hashing an items key.
+ *     compare_fn - a pointer to the function for comparing items.
+ */
+typedef struct mph_tbl {
+    int n_items;
+    int n_parts;
+    int n_buckets;
+    int n_remap;
+    unsigned long seed;
+    mph_part_t *parts;
+    unsigned short *pilots;
+    unsigned int *remap;
+    void **items;
+    char *store;
+    unsigned long (*hash_fn)(const void *item);
+    int (*compare_fn)(const void *item1, const void *item2);
+} mph_tbl_t;
+
+
+
+/* mph_tbl_build() - Returns a pointer to a minimal perfect hash table of the
+ * n_items items pointed to by items[], built by n_threads threads.  Pointers
+ * to the following functions are required:
+ *     hash_fn - A hash function, which hashes the key of the item pointed to
+ *               by item to an unsigned long.  All bits of the value are used,
+ *               so they should be well mixed.
+ *     comp_fn - A comparison function.  Should returns zero only if item1 and
+ *               item2 have the same key.
+ * No two items may have the same hash value.  If two do, or the table can not
+ * otherwise be built, NULL is returned.
+ */
+mph_tbl_t *mph_tbl_build(void **items, int n_items, int n_threads,
+			 unsigned long (*hash_fn)(const void *item),
+			 int (*comp_fn)(const void *item1, const void *item2)
+                         );
+
+/* mph_tbl_free() - Frees up space used by the minimal perfect hash table
+ * pointed to by tbl, including the items if it was loaded from a file.
+ */
+void mph_tbl_free(mph_tbl_t *tbl);
+
+/* mph_tbl_index() - Returns the slot, from 0 to n_items - 1, of the item in
+ * the table pointed to by tbl with the same key as `item'.  Each item of the
+ * table has a different slot.  For keys not in the table, the slot of an
+ * arbitrary item, or -1, is returned.
+ */
+int mph_tbl_index(mph_tbl_t *tbl, const void *item);
+
+/* mph_tbl_find() - Returns a pointer to an item with the same key as `item'
+ * in the minimal perfect hash table pointed to by tbl.  If no matching item is
+ * found, NULL is returned.
+ */
+void *mph_tbl_find(mph_tbl_t *tbl, const void *item);
+
+/* mph_tbl_save() - Writes the minimal perfect hash table pointed to by tbl to
+ * the file fp, with the item_size bytes of each item.  The items must not
+ * hold pointers.  The file is only readable on machines with the same byte
+ * order and type sizes.  Returns 0 on success, or -1 if a write failed.
+ */
+int mph_tbl_save(mph_tbl_t *tbl, FILE *fp, int item_size);
+
+/* mph_tbl_load() - Reads a minimal perfect hash table written by
+ * mph_tbl_save() from the file fp, and returns a pointer to it.  The items
+ * are read into space owned by the table.  hash_fn and comp_fn must be the
+ * functions the table was built with.  Returns NULL if the file could not be
+ * read.
+ */
+mph_tbl_t *mph_tbl_load(FILE *fp,
+			unsigned long (*hash_fn)(const void *item),
+			int (*comp_fn)(const void *item1, const void *item2));
+
+#endif
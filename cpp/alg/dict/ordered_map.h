@@ -0,0 +1,1639 @@
+#ifndef ORDERED_MAP_H
+#define ORDERED_MAP_H
+/* File ordered_map.h - Typed Ordered Maps
+ * ----------------------------------------------------------------------------
+ */
+
+#include <new>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+extern "C" {
+#include "pool.h"
+}
+
+/* --- OrderedMap ---
+ * A typed front-end to the AVL tree, red-black tree, 2-3 tree and skip list
+ * algorithms of this directory.  The C dictionaries store a void pointer to
+ * each item and compare items through a function pointer, so every step of a
+ * search is an indirect call which then dereferences both items.  Here the
+ * algorithms are templates on the key and value types and on the comparison,
+ * so keys and values are stored inline in the nodes, and the comparison is
+ * known at compile time and can be inlined into the search loops.
+ *
+ * Backend is one of the class templates AvlTree, RbTree, Tree23 or SkipList
+ * below, each a port of the corresponding C dictionary.  Compare is a
+ * function object type defining a strict weak order on keys, as for the
+ * standard containers.  For example, OrderedMap<RbTree, int, int> is a
+ * red-black tree mapping int keys to int values, in increasing order of key.
+ *
+ * insert(k, v)    - inserts key k with value v.  If k is already in the map,
+ *                   the map is unchanged and a pointer to the value of k is
+ *                   returned.  Otherwise NULL is returned.
+ * find(k)         - returns a pointer to the value of key k, or NULL if k is
+ *                   not in the map.
+ * findMin(k, v)   - sets *k and *v to the smallest key and its value, and
+ *                   returns true, or returns false if the map is empty.
+ * remove(k, v)    - removes key k from the map, setting *v to its value if v
+ *                   is not NULL.  Returns false if k was not in the map.
+ * deleteMin(k, v) - removes the smallest key from the map, setting *k and *v
+ *                   to the key and its value if they are not NULL.  Returns
+ *                   false if the map is empty.
+ * nItems()        - returns the number of keys in the map.
+ *
+ * A value pointer is valid until the map is next changed.  Nodes are
+ * allocated from a pool of pool.h owned by the map, so programs using these
+ * templates are linked with pool.o.
+ */
+template <template <class, class, class> class Backend, class Key,
+          class Value, class Compare = std::less<Key> >
+class OrderedMap {
+  public:
+    Value *insert(const Key &k, const Value &v) { return impl.insert(k, v); }
+    Value *find(const Key &k) { return impl.find(k); }
+    bool findMin(Key *k, Value *v) const { return impl.findMin(k, v); }
+    bool remove(const Key &k, Value *v = 0) { return impl.remove(k, v); }
+    bool deleteMin(Key *k = 0, Value *v = 0) { return impl.deleteMin(k, v); }
+    int nItems() const { return impl.nItems(); }
+
+  private:
+    Backend<Key, Value, Compare> impl;
+};
+
+
+/* Size of the stacks used for storing the path traversed through a tree, as
+ * for AVL_STACK_SIZE and RBTREE_STACK_SIZE.
+ */
+const int ORDERED_MAP_STACK_SIZE = 1000;
+
+
+/* --- AvlTree ---
+ * The AVL tree of avl.c.  Each node holds its key and value, and a balance of
+ * -1, 0 or 1, the height of its right subtree less that of its left.
+ */
+template <class Key, class Value, class Compare>
+class AvlTree {
+  public:
+    AvlTree();
+    ~AvlTree();
+
+    Value *insert(const Key &k, const Value &v);
+    Value *find(const Key &k);
+    bool findMin(Key *k, Value *v) const;
+    bool remove(const Key &k, Value *v);
+    bool deleteMin(Key *k, Value *v);
+    int nItems() const { return n; }
+
+  private:
+    struct Node {
+        Key key;
+        Value value;
+        Node *left, *right;
+        signed char balance;
+        Node(const Key &k, const Value &v) : key(k), value(v) {}
+    };
+
+    Node *root;          // pointer: root node
+    int n;               // number of keys in the tree
+    Compare cmp;         // object: key comparison
+    Node **stack;        // array: nodes on the path from the root
+    signed char *pathInfo;  // array: -1 or 1 for left or right at each node
+    pool_t *pool;        // pointer: pool the nodes are allocated from
+
+    void unlink(Node *p, int tos);
+
+    AvlTree(const AvlTree &);
+    AvlTree &operator=(const AvlTree &);
+};
+
+
+/* --- RbTree ---
+ * The red-black tree of rbtree.c.
+ */
+template <class Key, class Value, class Compare>
+class RbTree {
+  public:
+    RbTree();
+    ~RbTree();
+
+    Value *insert(const Key &k, const Value &v);
+    Value *find(const Key &k);
+    bool findMin(Key *k, Value *v) const;
+    bool remove(const Key &k, Value *v);
+    bool deleteMin(Key *k, Value *v);
+    int nItems() const { return n; }
+
+  private:
+    struct Node {
+        Key key;
+        Value value;
+        Node *left, *right;
+        bool red;
+        Node(const Key &k, const Value &v) : key(k), value(v) {}
+    };
+
+    Node *root;          // pointer: root node
+    int n;               // number of keys in the tree
+    Compare cmp;         // object: key comparison
+    Node **stack;        // array: nodes on the path from the root
+    pool_t *pool;        // pointer: pool the nodes are allocated from
+
+    void unlink(int tos);
+    Node *restructure(int tos, Node *x, Node *y, Node *z);
+
+    RbTree(const RbTree &);
+    RbTree &operator=(const RbTree &);
+};
+
+
+/* --- Tree23 ---
+ * The 2-3 tree of tree23.c.  As there, keys and values are held at the lowest
+ * level of the tree, in entries which are the children of leaf nodes, and the
+ * nodes above them hold the smallest key of their middle and right subtrees.
+ * Those keys are copies held in the nodes, so a search only reaches an entry
+ * when it compares with the keys of a leaf node's left child.  A node has a
+ * right child when right is not NULL, rather than when it has a second key.
+ * Key must have a default constructor.
+ */
+template <class Key, class Value, class Compare>
+class Tree23 {
+  public:
+    Tree23();
+    ~Tree23();
+
+    Value *insert(const Key &k, const Value &v);
+    Value *find(const Key &k);
+    bool findMin(Key *k, Value *v) const;
+    bool remove(const Key &k, Value *v);
+    bool deleteMin(Key *k, Value *v);
+    int nItems() const { return n; }
+
+  private:
+    struct Entry {
+        Key key;
+        Value value;
+        Entry(const Key &k, const Value &v) : key(k), value(v) {}
+    };
+    struct Node;
+    union Link {
+        Node *node;      // link to an internal node...
+        Entry *item;     // ... or to an entry, from a leaf node.
+    };
+    struct Node {
+        Key key1, key2;
+        Link left, middle, right;
+        bool leaf;
+    };
+
+    Node *root;          // pointer: root node
+    int n;               // number of keys in the tree
+    Entry *minItem;      // pointer: entry with the smallest key
+    Compare cmp;         // object: key comparison
+    Node **stack;        // array: nodes on the path from the root
+    signed char *pathInfo;  // array: -1, 0 or 1 for the child taken
+    pool_t *pool;        // pointer: pool the nodes are allocated from
+
+    bool equal(const Key &a, const Key &b) const
+        { return !cmp(a, b) && !cmp(b, a); }
+    Entry *newEntry(const Key &k, const Value &v);
+    Node *newNode(bool leaf);
+    void freeEntry(Entry *e);
+
+    Tree23(const Tree23 &);
+    Tree23 &operator=(const Tree23 &);
+};
+
+
+/* --- SkipList ---
+ * The skip list of skip_list.c, with node heights chosen with probability
+ * SKIP_LIST_PROB, and enough levels for SKIP_LIST_MAX_N keys.  Each node holds
+ * its key and value ahead of its array of forward pointers.
+ */
+const int SKIP_LIST_MAX_N = 1000000;
+const double SKIP_LIST_PROB = 0.5;
+
+template <class Key, class Value, class Compare>
+class SkipList {
+  public:
+    SkipList();
+    ~SkipList();
+
+    Value *insert(const Key &k, const Value &v);
+    Value *find(const Key &k);
+    bool findMin(Key *k, Value *v) const;
+    bool remove(const Key &k, Value *v);
+    bool deleteMin(Key *k, Value *v);
+    int nItems() const { return n; }
+
+  private:
+    struct Node {
+        Key key;
+        Value value;
+        int size;
+        Node *forward[1];  // extends past the end of the node
+        Node(const Key &k, const Value &v) : key(k), value(v) {}
+    };
+
+    Node **head;         // array: head pointers
+    Node ***update;      // array: forward pointers to update
+    int maxLevel;        // number of head pointers
+    int n;               // number of keys in the list
+    Compare cmp;         // object: key comparison
+    pool_t *pool;        // pointer: pool the nodes are allocated from
+
+    static int nodeSize(int l)
+        { return sizeof(Node) + (l - 1) * sizeof(Node *); }
+    int randLevel() const;
+    void unlink(Node *p);
+
+    SkipList(const SkipList &);
+    SkipList &operator=(const SkipList &);
+};
+
+
+/*--- AvlTree (template methods) --------------------------------------------*/
+
+/* - Constructor - */
+template <class Key, class Value, class Compare>
+AvlTree<Key, Value, Compare>::AvlTree()
+{
+    root = 0;
+    n = 0;
+    stack = new Node *[ORDERED_MAP_STACK_SIZE];
+    pathInfo = new signed char[ORDERED_MAP_STACK_SIZE];
+    pool = pool_alloc();
+}
+
+/* - Destructor -
+ * Destroy the keys and values, then free the nodes with the pool.
+ */
+template <class Key, class Value, class Compare>
+AvlTree<Key, Value, Compare>::~AvlTree()
+{
+    Node *p;
+    int tos = 0;
+
+    if(root) stack[tos++] = root;
+    while(tos) {
+        p = stack[--tos];
+        if(p->left) stack[tos++] = p->left;
+        if(p->right) stack[tos++] = p->right;
+        p->~Node();
+    }
+    pool_free(pool);
+    delete [] stack;
+    delete [] pathInfo;
+}
+
+/* - insert() -
+ * Insert key k with value v, rebalancing with a single or double rotation as
+ * in avl_insert().
+ */
+template <class Key, class Value, class Compare>
+Value *AvlTree<Key, Value, Compare>::insert(const Key &k, const Value &v)
+{
+    Node *x, *p, *q, *r, **attachX;
+    int tos = 0, stackN;
+
+    if((p = root)) {
+        for(;;) {
+            stack[tos] = p;
+            if(cmp(k, p->key)) {
+                pathInfo[tos++] = -1;
+                p = p->left;
+                if(!p) {
+                    attachX = &stack[tos-1]->left;
+                    break;
+                }
+            }
+            else if(cmp(p->key, k)) {
+                pathInfo[tos++] = 1;
+                p = p->right;
+                if(!p) {
+                    attachX = &stack[tos-1]->right;
+                    break;
+                }
+            }
+            else {
+                return &p->value;
+            }
+        }
+    }
+    else {
+        attachX = &root;
+    }
+
+    x = new(pool_get(pool, sizeof(Node))) Node(k, v);
+    x->left = x->right = 0;
+    x->balance = 0;
+    *attachX = x;
+    n++;
+
+    /* Update the balance of ancestors, rotating at the first to become
+     * unbalanced.
+     */
+    stackN = tos;
+    while(tos) {
+        p = stack[--tos];
+        if(p->balance == 0) {
+            p->balance += pathInfo[tos];
+            continue;
+        }
+        p->balance += pathInfo[tos];
+        if(p->balance == 0) break;
+
+        /* p is unbalanced towards its child q on the path, which is not the
+         * new node.
+         */
+        q = stack[tos + 1];
+        if(pathInfo[tos] == pathInfo[tos + 1]) {
+            /* Single rotation: q replaces p. */
+            if(pathInfo[tos] == 1) {
+                p->right = q->left;
+                q->left = p;
+            }
+            else {
+                p->left = q->right;
+                q->right = p;
+            }
+            p->balance = q->balance = 0;
+        }
+        else {
+            /* Double rotation: r, the child of q, replaces p. */
+            r = tos + 2 < stackN ? stack[tos + 2] : x;
+            if(pathInfo[tos] == 1) {
+                q->left = r->right;
+                p->right = r->left;
+                r->right = q;
+                r->left = p;
+                p->balance = r->balance == 1 ? -1 : 0;
+                q->balance = r->balance == -1 ? 1 : 0;
+            }
+            else {
+                q->right = r->left;
+                p->left = r->right;
+                r->left = q;
+                r->right = p;
+                p->balance = r->balance == -1 ? 1 : 0;
+                q->balance = r->balance == 1 ? -1 : 0;
+            }
+            r->balance = 0;
+            q = r;
+        }
+
+        if(tos == 0) root = q;
+        else if(pathInfo[tos-1] == 1) stack[tos-1]->right = q;
+        else stack[tos-1]->left = q;
+        break;
+    }
+
+    return 0;
+}
+
+/* - find() -
+ * Return a pointer to the value of key k, or NULL if k is not in the tree.
+ */
+template <class Key, class Value, class Compare>
+Value *AvlTree<Key, Value, Compare>::find(const Key &k)
+{
+    Node *p = root;
+
+    while(p) {
+        if(cmp(k, p->key)) p = p->left;
+        else if(cmp(p->key, k)) p = p->right;
+        else return &p->value;
+    }
+
+    return 0;
+}
+
+/* - findMin() - */
+template <class Key, class Value, class Compare>
+bool AvlTree<Key, Value, Compare>::findMin(Key *k, Value *v) const
+{
+    Node *p = root;
+
+    if(!p) return false;
+    while(p->left) p = p->left;
+    *k = p->key;
+    *v = p->value;
+
+    return true;
+}
+
+/* - remove() - */
+template <class Key, class Value, class Compare>
+bool AvlTree<Key, Value, Compare>::remove(const Key &k, Value *v)
+{
+    Node *p = root;
+    int tos = 0;
+
+    for(;;) {
+        if(!p) return false;
+        if(cmp(k, p->key)) {
+            pathInfo[tos] = -1;
+            stack[tos++] = p;
+            p = p->left;
+        }
+        else if(cmp(p->key, k)) {
+            pathInfo[tos] = 1;
+            stack[tos++] = p;
+            p = p->right;
+        }
+        else {
+            break;
+        }
+    }
+
+    if(v) *v = p->value;
+    unlink(p, tos);
+
+    return true;
+}
+
+/* - deleteMin() - */
+template <class Key, class Value, class Compare>
+bool AvlTree<Key, Value, Compare>::deleteMin(Key *k, Value *v)
+{
+    Node *p = root;
+    int tos = 0;
+
+    if(!p) return false;
+    while(p->left) {
+        pathInfo[tos] = -1;
+        stack[tos++] = p;
+        p = p->left;
+    }
+
+    if(k) *k = p->key;
+    if(v) *v = p->value;
+    unlink(p, tos);
+
+    return true;
+}
+
+/* - unlink() -
+ * Remove node p, whose ancestors are stack[0..tos-1], and free it.  The tree
+ * is rebalanced on the way back to the root as in avl_delete().
+ */
+template <class Key, class Value, class Compare>
+void AvlTree<Key, Value, Compare>::unlink(Node *p, int tos)
+{
+    Node *m, *prevM, *q, *r, *child;
+    int stackP;
+
+    if(!p->left || !p->right) {
+        /* The only child of p, if any, replaces p. */
+        child = p->left ? p->left : p->right;
+        if(tos == 0) root = child;
+        else if(pathInfo[tos-1] == 1) stack[tos-1]->right = child;
+        else stack[tos-1]->left = child;
+    }
+    else {
+        /* The minimum node, m, in the right subtree replaces p. */
+        pathInfo[tos] = 1;
+        stack[tos] = p;
+        stackP = tos++;
+        m = p->right;
+        do {
+            pathInfo[tos] = -1;
+            stack[tos++] = m;
+            m = m->left;
+        } while(m);
+        m = stack[--tos];
+
+        if(stackP == 0) root = m;
+        else if(pathInfo[stackP-1] == 1) stack[stackP-1]->right = m;
+        else stack[stackP-1]->left = m;
+
+        prevM = stack[tos-1];
+        if(prevM != p) {
+            prevM->left = m->right;
+            m->right = p->right;
+        }
+        m->left = p->left;
+        m->balance = p->balance;
+        stack[stackP] = m;
+    }
+
+    p->~Node();
+    pool_put(pool, p, sizeof(Node));
+    n--;
+
+    /* Update the balance of ancestors, rotating where a node becomes
+     * unbalanced, until the height of a subtree is unchanged.
+     */
+    while(tos) {
+        p = stack[--tos];
+        if(p->balance == 0) {
+            p->balance -= pathInfo[tos];
+            break;
+        }
+        p->balance -= pathInfo[tos];
+        if(p->balance == 0) continue;
+
+        q = pathInfo[tos] == 1 ? p->left : p->right;
+        if(pathInfo[tos] != q->balance) {
+            /* Single rotation: q replaces p. */
+            if(pathInfo[tos] != 1) {
+                p->right = q->left;
+                q->left = p;
+            }
+            else {
+                p->left = q->right;
+                q->right = p;
+            }
+            r = q;
+        }
+        else {
+            /* Double rotation: r, the child of q, replaces p. */
+            if(pathInfo[tos] != 1) {
+                r = q->left;
+                q->left = r->right;
+                p->right = r->left;
+                r->right = q;
+                r->left = p;
+                p->balance = r->balance == 1 ? -1 : 0;
+                q->balance = r->balance == -1 ? 1 : 0;
+            }
+            else {
+                r = q->right;
+                q->right = r->left;
+                p->left = r->right;
+                r->left = q;
+                r->right = p;
+                p->balance = r->balance == -1 ? 1 : 0;
+                q->balance = r->balance == 1 ? -1 : 0;
+            }
+            r->balance = 0;
+        }
+
+        if(tos == 0) root = r;
+        else if(pathInfo[tos-1] == 1) stack[tos-1]->right = r;
+        else stack[tos-1]->left = r;
+
+        if(r == q) {
+            /* After a single rotation, the height is unchanged if q was
+             * balanced.
+             */
+            if(q->balance == 0) {
+                p->balance = p->balance > 0 ? 1 : -1;
+                q->balance = -p->balance;
+                break;
+            }
+            p->balance = q->balance = 0;
+        }
+    }
+}
+
+
+/*--- RbTree (template methods) ---------------------------------------------*/
+
+/* - Constructor - */
+template <class Key, class Value, class Compare>
+RbTree<Key, Value, Compare>::RbTree()
+{
+    root = 0;
+    n = 0;
+    stack = new Node *[ORDERED_MAP_STACK_SIZE];
+    pool = pool_alloc();
+}
+
+/* - Destructor -
+ * Destroy the keys and values, then free the nodes with the pool.
+ */
+template <class Key, class Value, class Compare>
+RbTree<Key, Value, Compare>::~RbTree()
+{
+    Node *p;
+    int tos = 0;
+
+    if(root) stack[tos++] = root;
+    while(tos) {
+        p = stack[--tos];
+        if(p->left) stack[tos++] = p->left;
+        if(p->right) stack[tos++] = p->right;
+        p->~Node();
+    }
+    pool_free(pool);
+    delete [] stack;
+}
+
+/* - insert() -
+ * Insert key k with value v, then resolve a red node with a red parent by
+ * recolouring or restructuring as in rbtree_insert().
+ */
+template <class Key, class Value, class Compare>
+Value *RbTree<Key, Value, Compare>::insert(const Key &k, const Value &v)
+{
+    Node *x, *p, *q, *m, **attachX;
+    int tos = 0;
+
+    if((p = root)) {
+        for(;;) {
+            stack[tos++] = p;
+            if(cmp(k, p->key)) {
+                if(!p->left) {
+                    attachX = &p->left;
+                    break;
+                }
+                p = p->left;
+            }
+            else if(cmp(p->key, k)) {
+                if(!p->right) {
+                    attachX = &p->right;
+                    break;
+                }
+                p = p->right;
+            }
+            else {
+                return &p->value;
+            }
+        }
+        tos--;  // p, the parent of the new node, is not kept on the stack
+    }
+    else {
+        attachX = &root;
+    }
+
+    x = new(pool_get(pool, sizeof(Node))) Node(k, v);
+    x->left = x->right = 0;
+    x->red = p != 0;
+    *attachX = x;
+    n++;
+
+    if(p) while(p->red) {
+        /* p is not the root, since the root is black. */
+        m = stack[--tos];
+        q = p == m->left ? m->right : m->left;
+        if(!q || !q->red) {
+            /* Black sibling: restructuring removes the double red. */
+            m = restructure(tos, m, p, x);
+            m->red = false;
+            m->left->red = m->right->red = true;
+            break;
+        }
+
+        /* Red sibling: recolour, and continue from the grandparent. */
+        p->red = q->red = false;
+        if(tos == 0) break;
+        m->red = true;
+        x = m;
+        p = stack[--tos];
+    }
+
+    return 0;
+}
+
+/* - find() -
+ * Return a pointer to the value of key k, or NULL if k is not in the tree.
+ */
+template <class Key, class Value, class Compare>
+Value *RbTree<Key, Value, Compare>::find(const Key &k)
+{
+    Node *p = root;
+
+    while(p) {
+        if(cmp(k, p->key)) p = p->left;
+        else if(cmp(p->key, k)) p = p->right;
+        else return &p->value;
+    }
+
+    return 0;
+}
+
+/* - findMin() - */
+template <class Key, class Value, class Compare>
+bool RbTree<Key, Value, Compare>::findMin(Key *k, Value *v) const
+{
+    Node *p = root;
+
+    if(!p) return false;
+    while(p->left) p = p->left;
+    *k = p->key;
+    *v = p->value;
+
+    return true;
+}
+
+/* - remove() - */
+template <class Key, class Value, class Compare>
+bool RbTree<Key, Value, Compare>::remove(const Key &k, Value *v)
+{
+    Node *p = root;
+    int tos = 0;
+
+    for(;;) {
+        if(!p) return false;
+        stack[tos++] = p;
+        if(cmp(k, p->key)) p = p->left;
+        else if(cmp(p->key, k)) p = p->right;
+        else break;
+    }
+
+    if(v) *v = p->value;
+    unlink(tos);
+
+    return true;
+}
+
+/* - deleteMin() - */
+template <class Key, class Value, class Compare>
+bool RbTree<Key, Value, Compare>::deleteMin(Key *k, Value *v)
+{
+    Node *p = root;
+    int tos = 0;
+
+    if(!p) return false;
+    for(; p; p = p->left) stack[tos++] = p;
+    p = stack[tos-1];
+
+    if(k) *k = p->key;
+    if(v) *v = p->value;
+    unlink(tos);
+
+    return true;
+}
+
+/* - unlink() -
+ * Remove the node stack[tos-1], whose ancestors are stack[0..tos-2], and
+ * free it.  A double black left by removing a black node is resolved as in
+ * rbtree_delete().
+ */
+template <class Key, class Value, class Compare>
+void RbTree<Key, Value, Compare>::unlink(int tos)
+{
+    Node *p, *r, *x, *y, *z, *b, *newY, *m;
+    bool removeRed;
+    int i;
+
+    p = stack[--tos];
+    x = y = 0;
+    if(!p->left || !p->right) {
+        /* The only child of p, if any, replaces p. */
+        r = p->left ? p->left : p->right;
+        if(tos == 0) {
+            root = r;
+        }
+        else {
+            x = stack[--tos];
+            if(p == x->left) {
+                x->left = r;
+                y = x->right;
+            }
+            else {
+                x->right = r;
+                y = x->left;
+            }
+        }
+        removeRed = p->red;
+    }
+    else {
+        /* The minimum node, m, in the right subtree replaces p. */
+        i = tos;
+        stack[tos++] = p;
+        for(m = p->right; m; m = m->left) stack[tos++] = m;
+        m = stack[--tos];
+
+        if(i == 0) root = m;
+        else if(p == stack[i-1]->left) stack[i-1]->left = m;
+        else stack[i-1]->right = m;
+
+        stack[i] = m;
+        x = stack[--tos];
+        r = m->right;
+        if(tos != i) {
+            y = x->right;
+            x->left = r;
+            m->right = p->right;
+        }
+        else {
+            y = p->left;
+        }
+        m->left = p->left;
+
+        /* Node m is treated as the node removed. */
+        removeRed = m->red;
+        m->red = p->red;
+    }
+
+    p->~Node();
+    pool_put(pool, p, sizeof(Node));
+    n--;
+
+    /* x is the parent of the removed node, y its sibling, and r the node
+     * which replaced it.  stack[tos-1] is the parent of x.
+     */
+    if(removeRed) return;
+    if(r && r->red) {
+        r->red = false;
+        return;
+    }
+    if(x) for(;;) {
+        if(!y->red) {
+            if(((z = y->left) && z->red) || ((z = y->right) && z->red)) {
+                /* Case 1: black sibling with a red child. */
+                b = restructure(tos, x, y, z);
+                b->red = x->red;
+                b->left->red = b->right->red = false;
+                break;
+            }
+
+            /* Case 2: black sibling with black children. */
+            y->red = true;
+            if(x->red) {
+                x->red = false;
+                break;
+            }
+            if(tos == 0) break;
+            r = x;
+            x = stack[--tos];
+            y = x->left == r ? x->right : x->left;
+        }
+        else {
+            /* Case 3: red sibling.  Restructure so that the sibling of r is
+             * black, then apply case 1 or 2.
+             */
+            if(x->left == y) {
+                newY = y->right;
+                z = y->left;
+            }
+            else {
+                newY = y->left;
+                z = y->right;
+            }
+            restructure(tos, x, y, z);
+            y->red = false;
+            x->red = true;
+            stack[tos++] = y;
+            y = newY;
+
+            if(((z = y->left) && z->red) || ((z = y->right) && z->red)) {
+                b = restructure(tos, x, y, z);
+                b->red = true;
+                b->left->red = b->right->red = false;
+            }
+            else {
+                y->red = true;
+                x->red = false;
+            }
+            break;
+        }
+    }
+}
+
+/* - restructure() -
+ * Restructure node x, its child y and grandchild z so that the middle of the
+ * three in key order becomes the parent of the other two, in the place of x.
+ * The parent of x is stack[tos-1].  Returns the middle node.
+ */
+template <class Key, class Value, class Compare>
+typename RbTree<Key, Value, Compare>::Node *
+RbTree<Key, Value, Compare>::restructure(int tos, Node *x, Node *y, Node *z)
+{
+    Node *parent, *mid;
+
+    if(y == x->left) {
+        if(z == y->left) {  // in-order: z, y, x
+            mid = y;
+            x->left = y->right;
+            y->right = x;
+        }
+        else {  // in-order: y, z, x
+            mid = z;
+            y->right = z->left;
+            z->left = y;
+            x->left = z->right;
+            z->right = x;
+        }
+    }
+    else {
+        if(z == y->left) {  // in-order: x, z, y
+            mid = z;
+            x->right = z->left;
+            z->left = x;
+            y->left = z->right;
+            z->right = y;
+        }
+        else {  // in-order: x, y, z
+            mid = y;
+            x->right = y->left;
+            y->left = x;
+        }
+    }
+
+    if(tos == 0) {
+        root = mid;
+    }
+    else {
+        parent = stack[tos-1];
+        if(x == parent->left) parent->left = mid;
+        else parent->right = mid;
+    }
+
+    return mid;
+}
+
+
+/*--- Tree23 (template methods) ---------------------------------------------*/
+
+/* - Constructor -
+ * The root is a leaf node, which holds up to three entries.
+ */
+template <class Key, class Value, class Compare>
+Tree23<Key, Value, Compare>::Tree23()
+{
+    n = 0;
+    minItem = 0;
+    stack = new Node *[ORDERED_MAP_STACK_SIZE];
+    pathInfo = new signed char[ORDERED_MAP_STACK_SIZE];
+    pool = pool_alloc();
+    root = newNode(true);
+}
+
+/* - Destructor -
+ * Destroy the keys and values, then free the nodes and entries with the pool.
+ * The stack can hold two nodes per level, for the children of a node, as in
+ * tree23_free().
+ */
+template <class Key, class Value, class Compare>
+Tree23<Key, Value, Compare>::~Tree23()
+{
+    Node *p, **s;
+    int tos = 0;
+
+    s = new Node *[2 * ORDERED_MAP_STACK_SIZE];
+    s[tos++] = root;
+    while(tos) {
+        p = s[--tos];
+        if(p->leaf) {
+            if(p->left.item) p->left.item->~Entry();
+            if(p->middle.item) p->middle.item->~Entry();
+            if(p->right.item) p->right.item->~Entry();
+        }
+        else {
+            s[tos++] = p->left.node;
+            s[tos++] = p->middle.node;
+            if(p->right.node) s[tos++] = p->right.node;
+        }
+        p->~Node();
+    }
+    delete [] s;
+    pool_free(pool);
+    delete [] stack;
+    delete [] pathInfo;
+}
+
+/* - newEntry() - */
+template <class Key, class Value, class Compare>
+typename Tree23<Key, Value, Compare>::Entry *
+Tree23<Key, Value, Compare>::newEntry(const Key &k, const Value &v)
+{
+    return new(pool_get(pool, sizeof(Entry))) Entry(k, v);
+}
+
+/* - newNode() -
+ * Return a new node with no children.
+ */
+template <class Key, class Value, class Compare>
+typename Tree23<Key, Value, Compare>::Node *
+Tree23<Key, Value, Compare>::newNode(bool leaf)
+{
+    Node *p = new(pool_get(pool, sizeof(Node))) Node();
+
+    p->leaf = leaf;
+    p->left.node = p->middle.node = p->right.node = 0;
+
+    return p;
+}
+
+/* - freeEntry() - */
+template <class Key, class Value, class Compare>
+void Tree23<Key, Value, Compare>::freeEntry(Entry *e)
+{
+    e->~Entry();
+    pool_put(pool, e, sizeof(Entry));
+}
+
+/* - insert() -
+ * Insert key k with value v.  A leaf node with four entries is split in two,
+ * and the new node is inserted beside it in the parent, which may split in
+ * turn, as in tree23_insert().
+ */
+template <class Key, class Value, class Compare>
+Value *Tree23<Key, Value, Compare>::insert(const Key &k, const Value &v)
+{
+    Node *p = root, *x, *nn;
+    Entry *item;
+    Key xMin, tempKey;
+    int tos = 0;
+
+    /* Special case: zero or one entries in the tree. */
+    if(n <= 1) {
+        if(n == 0) {
+            minItem = p->left.item = newEntry(k, v);
+        }
+        else if(cmp(p->left.item->key, k)) {
+            p->key1 = k;
+            p->middle.item = newEntry(k, v);
+        }
+        else if(cmp(k, p->left.item->key)) {
+            p->key1 = p->left.item->key;
+            p->middle.item = p->left.item;
+            minItem = p->left.item = newEntry(k, v);
+        }
+        else {
+            return &p->left.item->value;
+        }
+        n++;
+        return 0;
+    }
+
+    while(!p->leaf) {
+        stack[tos] = p;
+        if(p->right.node && !cmp(k, p->key2)) {
+            p = p->right.node;
+            pathInfo[tos] = 1;
+        }
+        else if(!cmp(k, p->key1)) {
+            p = p->middle.node;
+            pathInfo[tos] = 0;
+        }
+        else {
+            p = p->left.node;
+            pathInfo[tos] = -1;
+        }
+        tos++;
+    }
+
+    /* Insert among the entries of leaf node p, splitting it if it has three
+     * entries already.
+     */
+    if(p->right.item && !cmp(k, p->key2)) {
+        /* Beside the right entry. */
+        if(!cmp(p->key2, k)) return &p->right.item->value;
+        nn = newNode(true);
+        nn->left.item = p->right.item;
+        nn->key1 = k;
+        nn->middle.item = newEntry(k, v);
+        p->right.item = 0;
+    }
+    else if(!cmp(k, p->key1)) {
+        /* Beside the middle entry. */
+        if(!cmp(p->key1, k)) return &p->middle.item->value;
+        if(!p->right.item) {
+            p->key2 = k;
+            p->right.item = newEntry(k, v);
+            n++;
+            return 0;
+        }
+        nn = newNode(true);
+        nn->left.item = newEntry(k, v);
+        nn->key1 = p->key2;
+        nn->middle.item = p->right.item;
+        p->right.item = 0;
+    }
+    else {
+        /* Beside the left entry.  If k is smaller than any key in the tree,
+         * its entry replaces the left entry, which is inserted instead.
+         */
+        if(!cmp(p->left.item->key, k)) {
+            if(!cmp(k, p->left.item->key)) return &p->left.item->value;
+            item = p->left.item;
+            minItem = p->left.item = newEntry(k, v);
+        }
+        else {
+            item = newEntry(k, v);
+        }
+        if(!p->right.item) {
+            p->key2 = p->key1;
+            p->right.item = p->middle.item;
+            p->key1 = item->key;
+            p->middle.item = item;
+            n++;
+            return 0;
+        }
+        nn = newNode(true);
+        nn->left.item = p->middle.item;
+        nn->key1 = p->key2;
+        nn->middle.item = p->right.item;
+        p->key1 = item->key;
+        p->middle.item = item;
+        p->right.item = 0;
+    }
+    n++;
+
+    /* Insert the new node x, whose smallest key is xMin, into the parent of
+     * p, until a parent has room for it or the root is split.
+     */
+    x = nn;
+    xMin = nn->left.item->key;
+    while(tos) {
+        p = stack[--tos];
+        if(pathInfo[tos] > 0) {
+            nn = newNode(false);
+            nn->left.node = p->right.node;
+            nn->middle.node = x;
+            nn->key1 = xMin;
+            xMin = p->key2;
+            p->right.node = 0;
+        }
+        else if(pathInfo[tos] == 0) {
+            if(!p->right.node) {
+                p->right.node = x;
+                p->key2 = xMin;
+                return 0;
+            }
+            nn = newNode(false);
+            nn->left.node = x;
+            nn->middle.node = p->right.node;
+            nn->key1 = p->key2;
+            p->right.node = 0;
+        }
+        else {
+            if(!p->right.node) {
+                p->right.node = p->middle.node;
+                p->key2 = p->key1;
+                p->middle.node = x;
+                p->key1 = xMin;
+                return 0;
+            }
+            nn = newNode(false);
+            nn->left.node = p->middle.node;
+            nn->middle.node = p->right.node;
+            nn->key1 = p->key2;
+            p->middle.node = x;
+            tempKey = p->key1;
+            p->key1 = xMin;
+            xMin = tempKey;
+            p->right.node = 0;
+        }
+        x = nn;
+    }
+
+    /* The root was split. */
+    nn = newNode(false);
+    nn->left.node = p;
+    nn->middle.node = x;
+    nn->key1 = xMin;
+    root = nn;
+
+    return 0;
+}
+
+/* - find() -
+ * Return a pointer to the value of key k, or NULL if k is not in the tree.
+ */
+template <class Key, class Value, class Compare>
+Value *Tree23<Key, Value, Compare>::find(const Key &k)
+{
+    Node *p = root;
+
+    if(n <= 1) {
+        return n && equal(k, p->left.item->key) ? &p->left.item->value : 0;
+    }
+
+    while(!p->leaf) {
+        if(p->right.node && !cmp(k, p->key2)) p = p->right.node;
+        else if(!cmp(k, p->key1)) p = p->middle.node;
+        else p = p->left.node;
+    }
+
+    if(p->right.item && !cmp(k, p->key2)) {
+        return cmp(p->key2, k) ? 0 : &p->right.item->value;
+    }
+    else if(!cmp(k, p->key1)) {
+        return cmp(p->key1, k) ? 0 : &p->middle.item->value;
+    }
+    else {
+        return equal(k, p->left.item->key) ? &p->left.item->value : 0;
+    }
+}
+
+/* - findMin() - */
+template <class Key, class Value, class Compare>
+bool Tree23<Key, Value, Compare>::findMin(Key *k, Value *v) const
+{
+    if(!minItem) return false;
+    *k = minItem->key;
+    *v = minItem->value;
+
+    return true;
+}
+
+/* - remove() -
+ * Remove key k.  A leaf node left with one entry takes an entry from, or
+ * gives its entry to, a sibling, and a node left with one child does the
+ * same one level up, as in tree23_delete().
+ */
+template <class Key, class Value, class Compare>
+bool Tree23<Key, Value, Compare>::remove(const Key &k, Value *v)
+{
+    Node *p = root, *q, *parent, *mergeNode;
+    Entry *item, *mergeItem;
+    Key *minKeyPtr = 0;
+    int tos = 0;
+
+    /* Special cases: zero, one or two entries in the tree. */
+    if(n <= 2) {
+        if(n == 0) return false;
+        if(n == 2 && !cmp(k, p->middle.item->key)) {
+            if(cmp(p->middle.item->key, k)) return false;
+            item = p->middle.item;
+            p->middle.item = 0;
+        }
+        else if(equal(k, p->left.item->key)) {
+            item = p->left.item;
+            minItem = p->left.item = p->middle.item;
+            p->middle.item = 0;
+        }
+        else {
+            return false;
+        }
+        if(v) *v = item->value;
+        freeEntry(item);
+        n--;
+        return true;
+    }
+
+    while(!p->leaf) {
+        stack[tos] = p;
+        if(p->right.node && !cmp(k, p->key2)) {
+            minKeyPtr = &p->key2;
+            p = p->right.node;
+            pathInfo[tos] = 1;
+        }
+        else if(!cmp(k, p->key1)) {
+            minKeyPtr = &p->key1;
+            p = p->middle.node;
+            pathInfo[tos] = 0;
+        }
+        else {
+            p = p->left.node;
+            pathInfo[tos] = -1;
+        }
+        tos++;
+    }
+
+    /* Remove the entry from leaf node p. */
+    if(p->right.item && !cmp(k, p->key2)) {
+        if(cmp(p->key2, k)) return false;
+        item = p->right.item;
+        p->right.item = 0;
+        mergeItem = 0;
+    }
+    else if(!cmp(k, p->key1)) {
+        if(cmp(p->key1, k)) return false;
+        item = p->middle.item;
+        if(p->right.item) {
+            p->key1 = p->key2;
+            p->middle.item = p->right.item;
+            p->right.item = 0;
+            mergeItem = 0;
+        }
+        else {
+            mergeItem = p->left.item;
+        }
+    }
+    else {
+        if(!equal(k, p->left.item->key)) return false;
+        item = p->left.item;
+
+        /* The smallest key of the subtree changes. */
+        if(minKeyPtr) *minKeyPtr = p->key1;
+        else minItem = p->middle.item;
+
+        if(p->right.item) {
+            p->left.item = p->middle.item;
+            p->key1 = p->key2;
+            p->middle.item = p->right.item;
+            p->right.item = 0;
+            mergeItem = 0;
+        }
+        else {
+            mergeItem = p->middle.item;
+        }
+    }
+    if(v) *v = item->value;
+    freeEntry(item);
+    n--;
+    if(!mergeItem) return true;
+
+    /* Node p has only mergeItem left.  It takes an entry from a sibling q
+     * with three, or else gives mergeItem to q and is freed.  Node p is not
+     * the root, as that case is handled above.
+     */
+    parent = stack[--tos];
+    if(pathInfo[tos] > 0) {
+        q = parent->middle.node;
+        if(q->right.item) {
+            p->left.item = q->right.item;
+            parent->key2 = q->key2;
+            p->key1 = mergeItem->key;
+            p->middle.item = mergeItem;
+            q->right.item = 0;
+            return true;
+        }
+        q->key2 = mergeItem->key;
+        q->right.item = mergeItem;
+        parent->right.node = 0;
+        p->~Node();
+        pool_put(pool, p, sizeof(Node));
+        return true;
+    }
+    else if(pathInfo[tos] == 0) {
+        q = parent->left.node;
+        if(q->right.item) {
+            p->left.item = q->right.item;
+            parent->key1 = q->key2;
+            p->key1 = mergeItem->key;
+            p->middle.item = mergeItem;
+            q->right.item = 0;
+            return true;
+        }
+        q->key2 = mergeItem->key;
+        q->right.item = mergeItem;
+    }
+    else {
+        q = parent->middle.node;
+        if(q->right.item) {
+            p->left.item = mergeItem;
+            p->key1 = q->left.item->key;
+            p->middle.item = q->left.item;
+            parent->key1 = q->key1;
+            q->left.item = q->middle.item;
+            q->key1 = q->key2;
+            q->middle.item = q->right.item;
+            q->right.item = 0;
+            return true;
+        }
+        q->key2 = q->key1;
+        q->right.item = q->middle.item;
+        q->key1 = q->left.item->key;
+        q->middle.item = q->left.item;
+        q->left.item = mergeItem;
+    }
+    p->~Node();
+    pool_put(pool, p, sizeof(Node));
+
+    /* Node p was freed, from the middle or left of its parent.  While the
+     * parent is left with one child, q, it is merged in the same way with its
+     * own sibling.
+     */
+    for(;;) {
+        if(parent->right.node) {
+            if(pathInfo[tos] < 0) parent->left.node = q;
+            parent->middle.node = parent->right.node;
+            parent->key1 = parent->key2;
+            parent->right.node = 0;
+            return true;
+        }
+        mergeNode = q;
+        p = parent;
+        if(tos == 0) break;
+
+        parent = stack[--tos];
+        if(pathInfo[tos] > 0) {
+            q = parent->middle.node;
+            if(q->right.node) {
+                p->left.node = q->right.node;
+                p->middle.node = mergeNode;
+                p->key1 = parent->key2;
+                parent->key2 = q->key2;
+                q->right.node = 0;
+                return true;
+            }
+            q->right.node = mergeNode;
+            q->key2 = parent->key2;
+            parent->right.node = 0;
+            p->~Node();
+            pool_put(pool, p, sizeof(Node));
+            return true;
+        }
+        else if(pathInfo[tos] == 0) {
+            q = parent->left.node;
+            if(q->right.node) {
+                p->left.node = q->right.node;
+                p->middle.node = mergeNode;
+                p->key1 = parent->key1;
+                parent->key1 = q->key2;
+                q->right.node = 0;
+                return true;
+            }
+            q->right.node = mergeNode;
+            q->key2 = parent->key1;
+        }
+        else {
+            q = parent->middle.node;
+            if(q->right.node) {
+                p->left.node = mergeNode;
+                p->middle.node = q->left.node;
+                p->key1 = parent->key1;
+                q->left.node = q->middle.node;
+                parent->key1 = q->key1;
+                q->middle.node = q->right.node;
+                q->key1 = q->key2;
+                q->right.node = 0;
+                return true;
+            }
+            q->right.node = q->middle.node;
+            q->key2 = q->key1;
+            q->middle.node = q->left.node;
+            q->key1 = parent->key1;
+            q->left.node = mergeNode;
+        }
+        p->~Node();
+        pool_put(pool, p, sizeof(Node));
+    }
+
+    /* The root was left with one child, which becomes the root. */
+    p->~Node();
+    pool_put(pool, p, sizeof(Node));
+    root = mergeNode;
+
+    return true;
+}
+
+/* - deleteMin() -
+ * Remove the smallest key, by removing the key of minItem.
+ */
+template <class Key, class Value, class Compare>
+bool Tree23<Key, Value, Compare>::deleteMin(Key *k, Value *v)
+{
+    Key minKey;
+
+    if(!minItem) return false;
+    minKey = minItem->key;
+    if(k) *k = minKey;
+
+    return remove(minKey, v);
+}
+
+
+/*--- SkipList (template methods) -------------------------------------------*/
+
+/* - Constructor - */
+template <class Key, class Value, class Compare>
+SkipList<Key, Value, Compare>::SkipList()
+{
+    int i;
+
+    maxLevel = (int)(-std::log((double)SKIP_LIST_MAX_N)
+                     / std::log(SKIP_LIST_PROB));
+    head = new Node *[maxLevel];
+    update = new Node **[maxLevel];
+    for(i = 0; i < maxLevel; i++) head[i] = 0;
+    n = 0;
+    pool = pool_alloc();
+}
+
+/* - Destructor -
+ * Destroy the keys and values, then free the nodes with the pool.
+ */
+template <class Key, class Value, class Compare>
+SkipList<Key, Value, Compare>::~SkipList()
+{
+    Node *p, *next;
+
+    for(p = head[0]; p; p = next) {
+        next = p->forward[0];
+        p->~Node();
+    }
+    pool_free(pool);
+    delete [] head;
+    delete [] update;
+}
+
+/* - insert() -
+ * Insert key k with value v in a node of random height, as in
+ * skip_list_insert().
+ */
+template <class Key, class Value, class Compare>
+Value *SkipList<Key, Value, Compare>::insert(const Key &k, const Value &v)
+{
+    Node *x, **forward = head;
+    int i, l;
+
+    /* update[i] is set to the level i pointer to the first node whose key is
+     * not less than k.
+     */
+    for(i = maxLevel - 1; i >= 0; i--) {
+        while(forward[i] && cmp(forward[i]->key, k)) {
+            forward = forward[i]->forward;
+        }
+        update[i] = &forward[i];
+    }
+    if(forward[0] && !cmp(k, forward[0]->key)) return &forward[0]->value;
+
+    l = randLevel();
+    x = new(pool_get(pool, nodeSize(l))) Node(k, v);
+    x->size = l;
+    for(i = 0; i < l; i++) {
+        x->forward[i] = *update[i];
+        *update[i] = x;
+    }
+    n++;
+
+    return 0;
+}
+
+/* - find() -
+ * Return a pointer to the value of key k, or NULL if k is not in the list.
+ */
+template <class Key, class Value, class Compare>
+Value *SkipList<Key, Value, Compare>::find(const Key &k)
+{
+    Node **forward = head;
+    int i;
+
+    for(i = maxLevel - 1; i >= 0; i--) {
+        while(forward[i] && cmp(forward[i]->key, k)) {
+            forward = forward[i]->forward;
+        }
+    }
+    if(forward[0] && !cmp(k, forward[0]->key)) return &forward[0]->value;
+
+    return 0;
+}
+
+/* - findMin() - */
+template <class Key, class Value, class Compare>
+bool SkipList<Key, Value, Compare>::findMin(Key *k, Value *v) const
+{
+    if(!head[0]) return false;
+    *k = head[0]->key;
+    *v = head[0]->value;
+
+    return true;
+}
+
+/* - remove() - */
+template <class Key, class Value, class Compare>
+bool SkipList<Key, Value, Compare>::remove(const Key &k, Value *v)
+{
+    Node **forward = head, *p;
+    int i;
+
+    for(i = maxLevel - 1; i >= 0; i--) {
+        while(forward[i] && cmp(forward[i]->key, k)) {
+            forward = forward[i]->forward;
+        }
+        update[i] = &forward[i];
+    }
+    p = forward[0];
+    if(!p || cmp(k, p->key)) return false;
+
+    if(v) *v = p->value;
+    unlink(p);
+
+    return true;
+}
+
+/* - deleteMin() - */
+template <class Key, class Value, class Compare>
+bool SkipList<Key, Value, Compare>::deleteMin(Key *k, Value *v)
+{
+    Node *p = head[0];
+    int i;
+
+    if(!p) return false;
+    for(i = 0; i < p->size; i++) update[i] = &head[i];
+
+    if(k) *k = p->key;
+    if(v) *v = p->value;
+    unlink(p);
+
+    return true;
+}
+
+/* - unlink() -
+ * Remove node p, where update[i] points to the level i pointer to p for each
+ * level of p, and free it.
+ */
+template <class Key, class Value, class Compare>
+void SkipList<Key, Value, Compare>::unlink(Node *p)
+{
+    int i, l = p->size;
+
+    for(i = 0; i < l; i++) *update[i] = p->forward[i];
+    p->~Node();
+    pool_put(pool, p, nodeSize(l));
+    n--;
+}
+
+/* - randLevel() -
+ * Return a random node height, as in skip_list_rand_level().
+ */
+template <class Key, class Value, class Compare>
+int SkipList<Key, Value, Compare>::randLevel() const
+{
+    int i, randMark = (int)(SKIP_LIST_PROB * RAND_MAX);
+
+    for(i = 1; i < maxLevel; i++) {
+        if(std::rand() > randMark) break;
+    }
+
+    return i;
+}
+
+#endif
@@ -0,0 +1,227 @@
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include "ordered_map.h"
+
+/* dict_info_t has a member named delete, which is a keyword in C++, so it is
+ * renamed while the C headers are included.  The layout is unchanged.
+ */
+#define delete delete_item
+extern "C" {
+#include "avl.h"
+#include "rbtree.h"
+#include "tree23.h"
+#include "skip_list.h"
+}
+#undef delete
+/* Typed Ordered Maps - Inline Keys versus dict_info_t
+ * ----------------------------------------------------------------------------
+ * Times each of the AVL tree, red-black tree, 2-3 tree and skip list through
+ * its dict_info_t interface, where items are pointed to and compared through a
+ * function pointer, against the OrderedMap of ordered_map.h, where int keys
+ * and values are held in the nodes and compared inline.  Both are given the
+ * same keys: n distinct keys are inserted in random order, each is found
+ * once, half are deleted in random order, and the rest are removed with
+ * delete_min.  The values found and removed must be the same for both.
+ *
+ * Usage: ordered_map_bench [n [rounds]]
+ */
+
+/*--- Types -----------------------------------------------------------------*/
+
+/* Item type for the dict_info_t path. */
+struct Item {
+    int key;
+    int value;
+};
+
+/* Times in seconds of the phases of a run, and a checksum of the values found
+ * and removed.
+ */
+struct Result {
+    double insert, find, remove, deleteMin;
+    long checksum;
+};
+
+const int N_PHASES = 4;
+const char *phaseName[N_PHASES] = { "insert", "find", "delete", "delete_min" };
+
+/*--- Functions -------------------------------------------------------------*/
+
+extern "C" int itemCmp(const void *item1, const void *item2)
+{
+    return ((const Item *)item1)->key - ((const Item *)item2)->key;
+}
+
+/* - shuffle() -
+ * Put the n integers of a[] in random order.
+ */
+void shuffle(int *a, int n)
+{
+    int i, j, tmp;
+
+    for(i = n - 1; i > 0; i--) {
+        j = std::rand() % (i + 1);
+        tmp = a[i];  a[i] = a[j];  a[j] = tmp;
+    }
+}
+
+double seconds(clock_t start)
+{
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+/* - runInfo() -
+ * Run the phases on the dictionary of dict_info_t fns.  items[k] is the item
+ * with key k, and ins[], fnd[] and del[] are the orders of keys for the
+ * insert, find and delete phases.
+ */
+void runInfo(const dict_info_t *fns, Item *items, const int *ins,
+             const int *fnd, const int *del, int n, Result *res)
+{
+    void *t = fns->alloc(itemCmp, 0);
+    Item *item;
+    clock_t start;
+    int i;
+
+    res->checksum = 0;
+
+    start = clock();
+    for(i = 0; i < n; i++) fns->insert(t, &items[ins[i]]);
+    res->insert = seconds(start);
+
+    start = clock();
+    for(i = 0; i < n; i++) {
+        item = (Item *)fns->find(t, &items[fnd[i]]);
+        if(item) res->checksum += item->value;
+    }
+    res->find = seconds(start);
+
+    start = clock();
+    for(i = 0; i < n / 2; i++) {
+        item = (Item *)fns->delete_item(t, &items[del[i]]);
+        if(item) res->checksum += item->value;
+    }
+    res->remove = seconds(start);
+
+    start = clock();
+    for(i = 1; (item = (Item *)fns->delete_min(t)); i++) {
+        res->checksum += (long)i * item->value;
+    }
+    res->deleteMin = seconds(start);
+
+    fns->free(t);
+}
+
+/* - runTyped() -
+ * Run the same phases on an OrderedMap with the given backend.  The value of
+ * key k is items[k].value.
+ */
+template <template <class, class, class> class Backend>
+void runTyped(const Item *items, const int *ins, const int *fnd,
+              const int *del, int n, Result *res)
+{
+    OrderedMap<Backend, int, int> *map = new OrderedMap<Backend, int, int>;
+    clock_t start;
+    int i, k, v, *found;
+
+    res->checksum = 0;
+
+    start = clock();
+    for(i = 0; i < n; i++) map->insert(ins[i], items[ins[i]].value);
+    res->insert = seconds(start);
+
+    start = clock();
+    for(i = 0; i < n; i++) {
+        found = map->find(fnd[i]);
+        if(found) res->checksum += *found;
+    }
+    res->find = seconds(start);
+
+    start = clock();
+    for(i = 0; i < n / 2; i++) {
+        if(map->remove(del[i], &v)) res->checksum += v;
+    }
+    res->remove = seconds(start);
+
+    start = clock();
+    for(i = 1; map->deleteMin(&k, &v); i++) res->checksum += (long)i * v;
+    res->deleteMin = seconds(start);
+
+    delete map;
+}
+
+/*--- Main ------------------------------------------------------------------*/
+
+int main(int argc, char *argv[])
+{
+    int n = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    int rounds = argc > 2 ? std::atoi(argv[2]) : 3;
+    const char *algName[] = { "AVL", "RB", "2-3", "skip" };
+    const dict_info_t *info[] = { &AVL_info, &RBTREE_info, &TREE23_info,
+                                  &SKIP_LIST_info };
+    const int nAlgs = 4;
+    double cTime[nAlgs][N_PHASES], typedTime[nAlgs][N_PHASES];
+    Result cRes, typedRes;
+    Item *items = new Item[n];
+    int *ins = new int[n], *fnd = new int[n], *del = new int[n];
+    int a, r, p, k;
+    bool ok = true;
+
+    std::srand(1);
+    for(k = 0; k < n; k++) {
+        items[k].key = k;
+        items[k].value = std::rand() % 1000;
+        ins[k] = fnd[k] = del[k] = k;
+    }
+    for(a = 0; a < nAlgs; a++) {
+        for(p = 0; p < N_PHASES; p++) cTime[a][p] = typedTime[a][p] = 0;
+    }
+
+    for(r = 0; r < rounds; r++) {
+        shuffle(ins, n);
+        shuffle(fnd, n);
+        shuffle(del, n);
+        for(a = 0; a < nAlgs; a++) {
+            runInfo(info[a], items, ins, fnd, del, n, &cRes);
+            switch(a) {
+              case 0: runTyped<AvlTree>(items, ins, fnd, del, n, &typedRes);
+                break;
+              case 1: runTyped<RbTree>(items, ins, fnd, del, n, &typedRes);
+                break;
+              case 2: runTyped<Tree23>(items, ins, fnd, del, n, &typedRes);
+                break;
+              default: runTyped<SkipList>(items, ins, fnd, del, n, &typedRes);
+            }
+            if(cRes.checksum != typedRes.checksum) ok = false;
+
+            cTime[a][0] += cRes.insert;  typedTime[a][0] += typedRes.insert;
+            cTime[a][1] += cRes.find;  typedTime[a][1] += typedRes.find;
+            cTime[a][2] += cRes.remove;  typedTime[a][2] += typedRes.remove;
+            cTime[a][3] += cRes.deleteMin;
+            typedTime[a][3] += typedRes.deleteMin;
+        }
+    }
+
+    std::printf("n = %d, %d rounds; total seconds per phase\n", n, rounds);
+    std::printf("%-6s %-12s %12s %12s %9s\n", "dict", "phase", "dict_info_t",
+                "OrderedMap", "speedup");
+    for(a = 0; a < nAlgs; a++) {
+        for(p = 0; p < N_PHASES; p++) {
+            std::printf("%-6s %-12s %12.3f %12.3f", algName[a], phaseName[p],
+                        cTime[a][p], typedTime[a][p]);
+            if(typedTime[a][p] > 0) {
+                std::printf(" %9.2f", cTime[a][p] / typedTime[a][p]);
+            }
+            std::printf("\n");
+        }
+    }
+    std::printf("results %s\n", ok ? "match" : "DIFFER");
+
+    delete [] items;
+    delete [] ins;
+    delete [] fnd;
+    delete [] del;
+
+    return ok ? 0 : 1;
+}
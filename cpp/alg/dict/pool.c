@@ -0,0 +1,107 @@
+/*** File pool.c - Node Pool Allocator ***/
+#include <stdlib.h>
+#include "pool.h"
+
+
+
+/* Prototypes for functions only visible within this file. */
+void *pool_chunk_alloc(pool_t *pool, int size);
+
+
+
+/* pool_alloc() - Allocates an empty pool and returns a pointer to it. */
+pool_t *pool_alloc(void)
+{
+    pool_t *pool;
+    int c;
+
+    pool = malloc(sizeof(pool_t));
+    for(c = 0; c < POOL_MAX_SIZE / POOL_ALIGN; c++) pool->free_list[c] = NULL;
+    pool->next = pool->end = NULL;
+    pool->chunks = NULL;
+
+    return pool;
+}
+
+
+/* pool_free() - Frees the pool pointed to by pool, and all blocks obtained
+ * from it, whether or not they were returned.
+ */
+void pool_free(pool_t *pool)
+{
+    pool_chunk_t *chunk, *prev;
+
+    for(chunk = pool->chunks; chunk; chunk = prev) {
+        prev = chunk->prev;
+        free(chunk);
+    }
+    free(pool);
+}
+
+
+/* pool_get() - Returns a block of at least `size' bytes from the pool pointed
+ * to by pool.
+ */
+void *pool_get(pool_t *pool, int size)
+{
+    void *p;
+    int c;
+
+    if(size > POOL_MAX_SIZE) return pool_chunk_alloc(pool, size);
+
+    c = (size - 1) / POOL_ALIGN;
+    if((p = pool->free_list[c])) {
+        pool->free_list[c] = *(void **)p;
+        return p;
+    }
+
+    /* Carve a new block from the current chunk, starting a new chunk when
+     * there is no room left.  Any room at the end of the old chunk is unused.
+     */
+    size = (c + 1) * POOL_ALIGN;
+    if(pool->end - pool->next < size) {
+        pool->next = pool_chunk_alloc(pool, POOL_CHUNK_SIZE
+                                            - sizeof(pool_chunk_t));
+        pool->end = pool->next + POOL_CHUNK_SIZE - sizeof(pool_chunk_t);
+    }
+    p = pool->next;
+    pool->next += size;
+
+    return p;
+}
+
+
+/* pool_put() - Returns the block pointed to by p, of `size' bytes, to the pool
+ * pointed to by pool.  size must be the size that the block was obtained
+ * with.
+ */
+void pool_put(pool_t *pool, void *p, int size)
+{
+    int c;
+
+    /* Blocks with a chunk of their own are kept until the pool is freed. */
+    if(size > POOL_MAX_SIZE) return;
+
+    c = (size - 1) / POOL_ALIGN;
+    *(void **)p = pool->free_list[c];
+    pool->free_list[c] = p;
+}
+
+
+
+/*** Functions only visible within this file. ***/
+
+/* pool_chunk_alloc() - Allocates a chunk with room for `size' bytes after its
+ * header, links it into the chunks of the pool pointed to by pool, and returns
+ * a pointer to the room.
+ */
+void *pool_chunk_alloc(pool_t *pool, int size)
+{
+    pool_chunk_t *chunk;
+
+    chunk = malloc(sizeof(pool_chunk_t) + size);
+    chunk->prev = pool->chunks;
+    pool->chunks = chunk;
+
+    return chunk + 1;
+}
@@ -0,0 +1,84 @@
+/*** File pool.h - Node Pool Allocator ***/
+#ifndef POOL_H
+#define POOL_H
+
+/* A pool serves the small, fixed size blocks which dictionaries allocate for
+ * their nodes, without calling malloc() and free() for each node.  Memory is
+ * taken from the system in large chunks, and blocks are carved from the
+ * current chunk in turn.  Requested sizes are rounded up to a multiple of
+ * POOL_ALIGN, and each rounded size is a size class with its own list of
+ * free blocks.  A block returned to the pool goes on the free list of its
+ * size class, and is reused by the next request for that size class.
+ *
+ * Blocks are not given back to the system until the whole pool is freed by
+ * pool_free(), which frees its chunks without visiting the blocks in them.  A
+ * dictionary with its own pool can therefore be freed in time proportional to
+ * the number of chunks rather than the number of nodes.
+ *
+ * A pool is not safe for use by several threads at once.
+ */
+
+
+/*** Compile Time Options ***/
+
+/* Block sizes are rounded up to a multiple of POOL_ALIGN, which must be a
+ * multiple of the alignment needed by pointers and integers.
+ */
+#define POOL_ALIGN 8
+
+/* The largest block size with its own size class.  Larger blocks are given a
+ * chunk of their own, which is only freed with the pool.
+ */
+#define POOL_MAX_SIZE 4096
+
+/* The size of the chunks taken from the system. */
+#define POOL_CHUNK_SIZE 65536
+
+
+
+/*** Structure Type Definitions. ***/
+
+/* A chunk of memory, which starts with a pointer to the chunk allocated before
+ * it.  The header is padded to POOL_ALIGN bytes, and blocks follow it.
+ */
+typedef union pool_chunk {
+    union pool_chunk *prev;
+    char pad[POOL_ALIGN];
+} pool_chunk_t;
+
+/* Structure type for a pool:
+ *     free_list[c] - the free blocks of size (c+1)*POOL_ALIGN, linked through
+ *                    their first word.
+ *     next, end - the unused part of the current chunk.
+ *     chunks - the most recently allocated chunk.
+ */
+typedef struct pool {
+    void *free_list[POOL_MAX_SIZE / POOL_ALIGN];
+    char *next, *end;
+    pool_chunk_t *chunks;
+} pool_t;
+
+
+
+/*** Function prototypes. ***/
+
+/* pool_alloc() - Allocates an empty pool and returns a pointer to it. */
+pool_t *pool_alloc(void);
+
+/* pool_free() - Frees the pool pointed to by pool, and all blocks obtained
+ * from it, whether or not they were returned.
+ */
+void pool_free(pool_t *pool);
+
+/* pool_get() - Returns a block of at least `size' bytes from the pool pointed
+ * to by pool.
+ */
+void *pool_get(pool_t *pool, int size);
+
+/* pool_put() - Returns the block pointed to by p, of `size' bytes, to the pool
+ * pointed to by pool.  size must be the size that the block was obtained
+ * with.
+ */
+void pool_put(pool_t *pool, void *p, int size);
+
+#endif
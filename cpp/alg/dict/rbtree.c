@@ -13,38 +13,68 @@ rbtree_node_t *rbtree_restructure(rbtree_t *t, int tos, rbtree_node_t *x,
 rbtree_node_t *rbtree_restructure2(rbtree_t *t, int tos, rbtree_node_t *x,
 				   rbtree_node_t *y, rbtree_node_t *z);
 
+/* When RBTREE_RANKS is 1, RESIZE() recomputes the subtree size of node p from
+ * the sizes of its children, after restructuring has changed them.
+ */
+#if RBTREE_RANKS
+#define SIZE(p) ((p) ? (p)->size : 0)
+#define RESIZE(p) ((p)->size = SIZE((p)->left) + SIZE((p)->right) + 1)
+
+/* rbtree_add_size() - Adds d to the subtree size of each of the n nodes on
+ * the path stack[].
+ */
+static void rbtree_add_size(rbtree_node_t **stack, int n, int d)
+{
+    int i;
+
+    for(i = 0; i < n; i++) stack[i]->size += d;
+}
+#endif
+
     
 /* rbtree_alloc() - Allocates space for a red-black tree and returns a pointer
  * to it.  The function compar compares they keys of two items, and returns a
  * negative, zero, or positive integer depending on whether the first item is
- * less than, equal to, or greater than the second.
+ * less than, equal to, or greater than the second.  Nodes are allocated from
+ * the pool pointed to by pool, which may be shared with other dictionaries, or
+ * from a new pool of the tree's own if pool is NULL.
  */
-rbtree_t *rbtree_alloc(int (* compar)(const void *, const void *))
+rbtree_t *rbtree_alloc(int (* compar)(const void *, const void *), pool_t *pool)
 {
     rbtree_t *t;
 
 
     t = malloc(sizeof(rbtree_t));
+    t->own_pool = !pool;
+    t->pool = pool ? pool : pool_alloc();
     t->root = NULL;
     t->compar = compar;
     t->stack = malloc(RBTREE_STACK_SIZE * sizeof(rbtree_node_t *));
     t->n = 0;
+    OP_RESET(t->ops);
 
     return t;
 }
 
 
-/* rbtree_free() - Frees space used by the red-black tree pointed to by t. */
+/* rbtree_free() - Frees space used by the red-black tree pointed to by t.  The
+ * nodes of a tree with its own pool are freed all at once, by freeing the
+ * pool.  Otherwise they are returned to the shared pool.
+ */
 void rbtree_free(rbtree_t *t)
 {
     rbtree_node_t *p, **stack;
     int tos;
 
-    /* In order to free all nodes in the tree a depth first search is performed
-     * This is implemented using a stack.
+    /* The nodes of a tree with its own pool are freed with the pool.
+     * Otherwise, in order to return all nodes to the pool a depth first search
+     * is performed.  This is implemented using a stack.
      */
     
-    if(t->root) {
+    if(t->own_pool) {
+        pool_free(t->pool);
+    }
+    else if(t->root) {
         stack = t->stack;
 	stack[0] = t->root;
         tos = 1;
@@ -56,11 +86,11 @@ void rbtree_free(rbtree_t *t)
 	    if(p->right) {
 		stack[tos++] = p->right;
 	    }
-	    free(p);
+	    pool_put(t->pool, p, sizeof(rbtree_node_t));
 	}
-	free(stack);
     }
-    
+
+    free(t->stack);
     free(t);
 }
 
@@ -90,6 +120,7 @@ void *rbtree_insert(rbtree_t *t, void *item)
 	 */
         for(;;) {
 	    stack[tos++] = p;
+	    OP_COMP(t->ops);
 	    cmp_result = compar(item, p->item);
 	    if(cmp_result < 0) {
                 p = p->left;
@@ -111,6 +142,10 @@ void *rbtree_insert(rbtree_t *t, void *item)
 	        return p->item;
 	    }
 	}
+	OP_DEPTH(t->ops, tos + 1);
+#if RBTREE_RANKS
+	rbtree_add_size(stack, tos + 1, 1);  /* Ancestors of x, including p. */
+#endif
 	col = Red;
     }
     else {
@@ -118,12 +153,17 @@ void *rbtree_insert(rbtree_t *t, void *item)
 	col = Black;
     }
 
-    x = malloc(sizeof(rbtree_node_t));
+    x = pool_get(t->pool, sizeof(rbtree_node_t));
+    OP_ALLOC(t->ops);
     x->left = x->right = NULL;
     x->item = item;
     x->colour = col;
+#if RBTREE_RANKS
+    x->size = 1;
+#endif
 
     *attach_x = x;
+    OP_LINK(t->ops);
     t->n++;
 
     /* Restructuring or recolouring will be needed if node x and its parent, p,
@@ -186,6 +226,7 @@ void *rbtree_find(rbtree_t *t, void *key_item)
 	 */
         do {
 	    p = next_p;
+	    OP_COMP(t->ops);
 	    cmp_result = compar(key_item, p->item);
 	    if(cmp_result < 0) {
                 next_p = p->left;
@@ -204,6 +245,69 @@ void *rbtree_find(rbtree_t *t, void *key_item)
 }
 
 
+/* rbtree_find_many() - Finds the items in the red-black tree pointed to by t
+ * with the same keys as the n items pointed to by key_items[], and stores a
+ * pointer to each item found, or NULL, in items[].  The lookups are
+ * interleaved in groups of FIND_MANY_GROUP, with the next node of each
+ * prefetched, so that their cache misses overlap.
+ */
+void rbtree_find_many(rbtree_t *t, void **key_items, void **items, int n)
+{
+    int (* compar)(const void *, const void *);
+    int cmp_result;
+    rbtree_node_t *p[FIND_MANY_GROUP], *q;
+    int key_i[FIND_MANY_GROUP];
+    int i, j, group_n, active;
+
+    compar = t->compar;
+
+    for(i = 0; i < n; i += group_n) {
+	group_n = n - i < FIND_MANY_GROUP ? n - i : FIND_MANY_GROUP;
+	for(j = 0; j < group_n; j++) {
+	    PREFETCH(key_items[i+j]);
+	    p[j] = t->root;
+	    key_i[j] = i + j;
+	    items[i+j] = NULL;
+	}
+
+	/* Lookup j of the active lookups is at node p[j], for key
+	 * key_items[key_i[j]].  Each pass moves every active lookup down one
+	 * level.  The items of the nodes reached are prefetched before any of
+	 * them are compared, and the children moved to are prefetched for the
+	 * next pass.  A finished lookup is replaced by the last active one.
+	 */
+	active = t->root ? group_n : 0;
+	while(active) {
+	    for(j = 0; j < active; j++) PREFETCH(p[j]->item);
+	    for(j = 0; j < active; ) {
+		q = p[j];
+		OP_COMP(t->ops);
+		cmp_result = compar(key_items[key_i[j]], q->item);
+		if(cmp_result < 0) {
+		    q = q->left;
+		}
+		else if(cmp_result > 0) {
+		    q = q->right;
+		}
+		else {
+		    items[key_i[j]] = q->item;  /* Item found. */
+		    q = NULL;
+		}
+		if(q) {
+		    PREFETCH(q);
+		    p[j++] = q;
+		}
+		else {
+		    active--;
+		    p[j] = p[active];
+		    key_i[j] = key_i[active];
+		}
+	    }
+	}
+    }
+}
+
+
 /* rbtree_find_min() - Returns a pointer to the minimum item in the red-black
  * tree pointed to by t.  If there are no items in the tree a NULL pointer is
  * returned.
@@ -254,6 +358,7 @@ void *rbtree_delete(rbtree_t *t, void *key_item)
 	
         for(;;) {
 	    stack[tos++] = p;
+	    OP_COMP(t->ops);
 	    cmp_result = compar(key_item, p->item);
 	    if(cmp_result < 0) {
                 p = p->left;
@@ -275,6 +380,10 @@ void *rbtree_delete(rbtree_t *t, void *key_item)
     /* p points to the node to be deleted, and is currently on the top of the
      * stack.
      */
+#if RBTREE_RANKS
+    rbtree_add_size(stack, tos - 1, -1);  /* Ancestors of p. */
+#endif
+    OP_LINK(t->ops);
     if(!p->left) {
         tos--;  /* Adjust tos to remove p. */
 	/* Right child replaces p. */
@@ -326,6 +435,11 @@ void *rbtree_delete(rbtree_t *t, void *key_item)
             m = m->left;
 	} while(m);
 	m = stack[--tos];
+#if RBTREE_RANKS
+	/* The nodes between p and m lose m, and m takes over p's subtree. */
+	rbtree_add_size(stack + i + 1, tos - i - 1, -1);
+	m->size = p->size - 1;
+#endif
 
 	/* Update either the left or right child pointers of p's parent. */
 	if(i == 0) {
@@ -364,7 +478,7 @@ void *rbtree_delete(rbtree_t *t, void *key_item)
 
     /* Get return value and free the space used by node p. */
     return_item = p->item;
-    free(p);
+    pool_put(t->pool, p, sizeof(rbtree_node_t));
 
     t->n--;
     
@@ -533,12 +647,16 @@ void *rbtree_delete_min(rbtree_t *t)
             p = p->left;
 	} while(p);
 	p = stack[--tos];  /* Node to be deleted. */
+#if RBTREE_RANKS
+	rbtree_add_size(stack, tos, -1);  /* Ancestors of p. */
+#endif
     }
     else {
 	return NULL;
     }
 
     /* Right child replaces p. */
+    OP_LINK(t->ops);
     if(tos == 0) {
         r = t->root = p->right;
 	x = y = NULL;
@@ -552,7 +670,7 @@ void *rbtree_delete_min(rbtree_t *t)
 
     /* Get return value and free space used by node p. */
     return_item = p->item;
-    free(p);
+    pool_put(t->pool, p, sizeof(rbtree_node_t));
 
     t->n--;
 
@@ -739,6 +857,15 @@ rbtree_node_t *rbtree_restructure(rbtree_t *t, int tos, rbtree_node_t *x,
 	}
     }
 
+#if RBTREE_RANKS
+    /* Only the nodes moved below mid_node have new children. */
+    RESIZE(x);
+    if(mid_node != y) RESIZE(y);
+    RESIZE(mid_node);
+#endif
+    OP_LINKS(t->ops, mid_node == y ? 3 : 5);
+    OP_RESTRUCT(t->ops);
+
     if(tos != 0) {
 	parent = t->stack[tos-1];
         if(x == parent->left) {
@@ -779,6 +906,15 @@ rbtree_node_t *rbtree_restructure2(rbtree_t *t, int tos, rbtree_node_t *x,
 	y->right = z;
     }
 
+#if RBTREE_RANKS
+    /* Only the nodes moved below mid_node have new children. */
+    RESIZE(x);
+    if(mid_node != y) RESIZE(y);
+    RESIZE(mid_node);
+#endif
+    OP_LINKS(t->ops, mid_node == y ? 3 : 5);
+    OP_RESTRUCT(t->ops);
+
     if(tos != 0) {
 	parent = t->stack[tos-1];
         if(x == parent->left) {
@@ -796,13 +932,273 @@ rbtree_node_t *rbtree_restructure2(rbtree_t *t, int tos, rbtree_node_t *x,
 }
 
 
+/* rbtree_build() - Builds a perfectly balanced subtree from the n items in
+ * the array items[], and returns its root.  The root of the subtree is at the
+ * given depth in the tree, and nodes at depth red_depth or more are coloured
+ * red.
+ */
+rbtree_node_t *rbtree_build(rbtree_t *t, void **items, int n, int depth,
+			    int red_depth)
+{
+    rbtree_node_t *p;
+    int mid;
+
+    if(n == 0) return NULL;
+
+    mid = n / 2;
+    p = pool_get(t->pool, sizeof(rbtree_node_t));
+    OP_ALLOC(t->ops);
+    p->item = items[mid];
+    p->colour = depth < red_depth ? Black : Red;
+#if RBTREE_RANKS
+    p->size = n;
+#endif
+    p->left = rbtree_build(t, items, mid, depth + 1, red_depth);
+    p->right = rbtree_build(t, items + mid + 1, n - mid - 1, depth + 1,
+			    red_depth);
+    OP_LINK(t->ops);
+
+    return p;
+}
+
+
+/* rbtree_bulk_load() - Builds the red-black tree pointed to by t from the n
+ * items in the array items[], which must be in increasing order of key with no
+ * two keys equal.  An empty tree is built perfectly balanced, in O(n) time,
+ * with the nodes on the lowest level coloured red if that level is not full.
+ * If the red-black tree is not empty, the items are inserted one at a time
+ * instead.
+ */
+void rbtree_bulk_load(rbtree_t *t, void **items, int n)
+{
+    int i, red_depth;
+
+    if(t->n > 0) {
+        for(i = 0; i < n; i++) rbtree_insert(t, items[i]);
+        return;
+    }
+
+    /* Splitting at the middle item leaves every subtree with its empty
+     * positions on at most two adjacent levels.  The levels above red_depth
+     * are full, so colouring them black and any nodes below them red gives
+     * every path the same number of black nodes, and no red node has a red
+     * child.
+     */
+    for(red_depth = 0; (2 << red_depth) - 1 <= n; red_depth++);
+    t->root = rbtree_build(t, items, n, 0, red_depth);
+    t->n = n;
+}
+
+
+#if RBTREE_RANKS
+/* rbtree_select() - Returns a pointer to the item of rank k in the red-black
+ * tree pointed to by t, which is the item with k items of smaller key in the
+ * tree, for k from 0 to n-1.  Returns NULL if there is no such item.  Takes
+ * O(log n) time.  Only provided when RBTREE_RANKS is 1.
+ */
+void *rbtree_select(rbtree_t *t, int k)
+{
+    rbtree_node_t *p;
+    int left_size;
+
+    if(k < 0 || k >= t->n) return NULL;
+
+    /* Descend from the root, skipping the left subtree and node p whenever
+     * there are no more than k items in them.
+     */
+    p = t->root;
+    for(;;) {
+        left_size = SIZE(p->left);
+        if(k < left_size) {
+            p = p->left;
+        }
+        else if(k > left_size) {
+            k -= left_size + 1;
+            p = p->right;
+        }
+        else {
+            return p->item;
+        }
+    }
+}
+
+
+/* rbtree_rank() - Returns the number of items in the red-black tree pointed
+ * to by t with a key less than that of the item pointed to by `key_item',
+ * which need not be in the tree.  Takes O(log n) time.  Only provided when
+ * RBTREE_RANKS is 1.
+ */
+int rbtree_rank(rbtree_t *t, void *key_item)
+{
+    int (* compar)(const void *, const void *);
+    int cmp_result, rank;
+    rbtree_node_t *p;
+
+    compar = t->compar;
+    rank = 0;
+
+    /* Each time the right branch is taken, the left subtree and node p have
+     * keys less than that of key_item.
+     */
+    p = t->root;
+    while(p) {
+        OP_COMP(t->ops);
+        cmp_result = compar(key_item, p->item);
+        if(cmp_result < 0) {
+            p = p->left;
+        }
+        else if(cmp_result > 0) {
+            rank += SIZE(p->left) + 1;
+            p = p->right;
+        }
+        else {
+            return rank + SIZE(p->left);
+        }
+    }
+
+    return rank;
+}
+#endif
+
+
+/* rbtree_cursor_alloc() - Returns a new cursor on the red-black tree pointed
+ * to by t.  The cursor must be positioned by rbtree_cursor_seek() before use,
+ * and again whenever the tree has been changed.
+ */
+rbtree_cursor_t *rbtree_cursor_alloc(rbtree_t *t)
+{
+    rbtree_cursor_t *c;
+
+    c = malloc(sizeof(rbtree_cursor_t));
+    c->t = t;
+    c->stack = malloc(RBTREE_STACK_SIZE * sizeof(rbtree_node_t *));
+    c->tos = 0;
+
+    return c;
+}
+
+
+/* rbtree_cursor_free() - Frees space used by the cursor pointed to by c. */
+void rbtree_cursor_free(rbtree_cursor_t *c)
+{
+    free(c->stack);
+    free(c);
+}
+
+
+/* rbtree_cursor_seek() - Moves the cursor pointed to by c to the first item
+ * with a key not less than that of the item pointed to by `key_item', or to
+ * the first item if key_item is NULL, and returns it.  If there is no such
+ * item, the cursor is moved past the last item and NULL is returned.
+ */
+void *rbtree_cursor_seek(rbtree_cursor_t *c, void *key_item)
+{
+    rbtree_t *t;
+    rbtree_node_t *p, **stack;
+    int cmp_result, tos;
+
+    t = c->t;
+    stack = c->stack;
+    tos = 0;
+    c->tos = 0;
+
+    /* The path to the last node at which the search went left, or stopped,
+     * is the path to the item sought.
+     */
+    for(p = t->root; p; ) {
+	stack[tos++] = p;
+	if(key_item) {
+	    OP_COMP(t->ops);
+	    cmp_result = t->compar(key_item, p->item);
+	}
+	else {
+	    cmp_result = -1;
+	}
+	if(cmp_result <= 0) {
+	    c->tos = tos;
+	    if(cmp_result == 0) break;
+	    p = p->left;
+	}
+	else {
+	    p = p->right;
+	}
+    }
+
+    return c->tos ? stack[c->tos - 1]->item : NULL;
+}
+
+
+/* rbtree_cursor_next() - Moves the cursor pointed to by c to the next item and
+ * returns it.  If there is no next item, NULL is returned and the cursor is
+ * not moved.
+ */
+void *rbtree_cursor_next(rbtree_cursor_t *c)
+{
+    rbtree_node_t *p, **stack;
+    int tos;
+
+    stack = c->stack;
+    tos = c->tos;
+    if(!tos) return NULL;
+
+    /* The next item is the minimum of the right subtree, if there is one. */
+    p = stack[tos-1]->right;
+    if(p) {
+	for(; p; p = p->left) stack[tos++] = p;
+	c->tos = tos;
+	return stack[tos-1]->item;
+    }
+
+    /* Otherwise it is the nearest ancestor whose left subtree holds the
+     * current node.
+     */
+    while(tos > 1 && stack[tos-2]->right == stack[tos-1]) tos--;
+    if(tos == 1) return NULL;
+    c->tos = tos - 1;
+    return stack[tos-2]->item;
+}
+
+
+/* rbtree_cursor_prev() - Moves the cursor pointed to by c to the previous
+ * item, or to the last item if it is past the last item, and returns it.  If
+ * there is no such item, NULL is returned and the cursor is not moved.
+ */
+void *rbtree_cursor_prev(rbtree_cursor_t *c)
+{
+    rbtree_node_t *p, **stack;
+    int tos;
+
+    stack = c->stack;
+    tos = c->tos;
+    p = tos ? stack[tos-1]->left : c->t->root;
+
+    /* The previous item is the maximum of the left subtree, if there is one.
+     * From past the last item, it is the maximum of the whole tree.
+     */
+    if(p) {
+	for(; p; p = p->right) stack[tos++] = p;
+	c->tos = tos;
+	return stack[tos-1]->item;
+    }
+    if(!tos) return NULL;
+
+    /* Otherwise it is the nearest ancestor whose right subtree holds the
+     * current node.
+     */
+    while(tos > 1 && stack[tos-2]->left == stack[tos-1]) tos--;
+    if(tos == 1) return NULL;
+    c->tos = tos - 1;
+    return stack[tos-2]->item;
+}
+
+
 /*** Implement the universal dictionary structure type ***/
 
 /*** Red-Black tree wrapper functions. ***/
 
 void *_rbtree_alloc(int (* compar)(const void *, const void *),
 		    unsigned int (* get_value)(const void *)) {
-    return rbtree_alloc(compar);
+    return rbtree_alloc(compar, NULL);
 }
 
 void _rbtree_free(void *t) {
@@ -825,10 +1221,42 @@ void *_rbtree_find(void *t, void *key_item) {
     return rbtree_find((rbtree_t *)t, key_item);
 }
 
+void _rbtree_find_many(void *t, void **key_items, void **items, int n) {
+    rbtree_find_many((rbtree_t *)t, key_items, items, n);
+}
+
 void *_rbtree_find_min(void *t) {
     return rbtree_find_min((rbtree_t *)t);
 }
 
+const opcount_t *_rbtree_counts(void *t) {
+    return &((rbtree_t *)t)->ops;
+}
+
+void *_rbtree_cursor_alloc(void *t) {
+    return rbtree_cursor_alloc((rbtree_t *)t);
+}
+
+void _rbtree_cursor_free(void *c) {
+    rbtree_cursor_free((rbtree_cursor_t *)c);
+}
+
+void *_rbtree_cursor_seek(void *c, void *key_item) {
+    return rbtree_cursor_seek((rbtree_cursor_t *)c, key_item);
+}
+
+void *_rbtree_cursor_next(void *c) {
+    return rbtree_cursor_next((rbtree_cursor_t *)c);
+}
+
+void *_rbtree_cursor_prev(void *c) {
+    return rbtree_cursor_prev((rbtree_cursor_t *)c);
+}
+
+void _rbtree_bulk_load(void *t, void **items, int n) {
+    rbtree_bulk_load((rbtree_t *)t, items, n);
+}
+
 /* Red-Black tree info. */
 const dict_info_t RBTREE_info = {
     _rbtree_alloc,
@@ -837,6 +1265,14 @@ const dict_info_t RBTREE_info = {
     _rbtree_delete,
     _rbtree_delete_min,
     _rbtree_find,
-    _rbtree_find_min
+    _rbtree_find_min,
+    _rbtree_counts,
+    _rbtree_cursor_alloc,
+    _rbtree_cursor_free,
+    _rbtree_cursor_seek,
+    _rbtree_cursor_next,
+    _rbtree_cursor_prev,
+    _rbtree_bulk_load,
+    _rbtree_find_many
 };
 
@@ -5,38 +5,74 @@
 #ifndef RBTREE_H
 #define RBTREE_H
 #include "dict_info.h"  /* Defines the universal dictionary structure type. */
+#include "pool.h"
 
 
 #define RBTREE_STACK_SIZE 1000
 
+/* Use 1 to keep the number of items in each subtree, which rbtree_select() and
+ * rbtree_rank() need, or 0 for the plain red-black tree without the cost of
+ * keeping the counts.  This can also be set when compiling, using
+ * -DRBTREE_RANKS=1.
+ */
+#ifndef RBTREE_RANKS
+#define RBTREE_RANKS 0
+#endif
+
 
 typedef enum {Red,Black} rbtree_colour_t;
 
 
-/* Structure type for nodes in the red-black tree. */
+/* Structure type for nodes in the red-black tree.  When RBTREE_RANKS is 1,
+ * size is the number of items in the subtree rooted at the node.
+ */
 typedef struct rbtree_node {
     void *item;
     struct rbtree_node *left, *right;
     rbtree_colour_t colour;
+#if RBTREE_RANKS
+    int size;
+#endif
 } rbtree_node_t;
 
-/* Structure type for the red-black tree. */
+/* Structure type for the red-black tree.  ops counts the operations performed
+ * on the tree, for experimental purposes.  Nodes are allocated from pool,
+ * which is the tree's own pool if own_pool is 1.
+ */
 typedef struct rbtree {
     rbtree_node_t *root;
     int n;
     int (* compar)(const void *, const void *);
     rbtree_node_t **stack;
+    pool_t *pool;
+    int own_pool;
+    opcount_t ops;
 } rbtree_t;
 
+/* Structure type for a cursor on the red-black tree.  stack[0..tos-1] holds
+ * the path from the root to the node of the current item, and tos is 0 when
+ * the cursor is past the last item.
+ */
+typedef struct rbtree_cursor {
+    rbtree_t *t;
+    rbtree_node_t **stack;
+    int tos;
+} rbtree_cursor_t;
+
 
 /* rbtree_alloc() - Allocates space for a red-black tree and returns a pointer
  * to it.  The function compar compares they keys of two items, and returns a
  * negative, zero, or positive integer depending on whether the first item is
- * less than, equal to, or greater than the second.
+ * less than, equal to, or greater than the second.  Nodes are allocated from
+ * the pool pointed to by pool, which may be shared with other dictionaries, or
+ * from a new pool of the tree's own if pool is NULL.
  */
-rbtree_t *rbtree_alloc(int (* compar)(const void *, const void *));
+rbtree_t *rbtree_alloc(int (* compar)(const void *, const void *), pool_t *pool);
 
-/* rbtree_free() - Frees space used by the red-black tree pointed to by t. */
+/* rbtree_free() - Frees space used by the red-black tree pointed to by t.  The
+ * nodes of a tree with its own pool are freed all at once, by freeing the
+ * pool.  Otherwise they are returned to the shared pool.
+ */
 void rbtree_free(rbtree_t *t);
 
 /* rbtree_insert() - Inserts an item into the red-black tree pointed to by t,
@@ -53,6 +89,14 @@ void *rbtree_insert(rbtree_t *t, void *item);
  */
 void *rbtree_find(rbtree_t *t, void *key_item);
 
+/* rbtree_find_many() - Finds the items in the red-black tree pointed to by t
+ * with the same keys as the n items pointed to by key_items[], and stores a
+ * pointer to each item found, or NULL, in items[].  The lookups are
+ * interleaved in groups of FIND_MANY_GROUP, with the next node of each
+ * prefetched, so that their cache misses overlap.
+ */
+void rbtree_find_many(rbtree_t *t, void **key_items, void **items, int n);
+
 /* rbtree_find_min() - Returns a pointer to the minimum item in the red-black
  * tree pointed to by t.  If there are no items in the tree a NULL pointer is
  * returned.
@@ -71,6 +115,59 @@ void *rbtree_delete(rbtree_t *t, void *key_item);
  */
 void *rbtree_delete_min(rbtree_t *t);
 
+/* rbtree_bulk_load() - Builds the red-black tree pointed to by t from the n
+ * items in the array items[], which must be in increasing order of key with no
+ * two keys equal.  An empty tree is built perfectly balanced, in O(n) time,
+ * with the nodes on the lowest level coloured red if that level is not full.
+ * If the red-black tree is not empty, the items are inserted one at a time
+ * instead.
+ */
+void rbtree_bulk_load(rbtree_t *t, void **items, int n);
+
+#if RBTREE_RANKS
+/* rbtree_select() - Returns a pointer to the item of rank k in the red-black
+ * tree pointed to by t, which is the item with k items of smaller key in the
+ * tree, for k from 0 to n-1.  Returns NULL if there is no such item.  Takes
+ * O(log n) time.  Only provided when RBTREE_RANKS is 1.
+ */
+void *rbtree_select(rbtree_t *t, int k);
+
+/* rbtree_rank() - Returns the number of items in the red-black tree pointed
+ * to by t with a key less than that of the item pointed to by `key_item',
+ * which need not be in the tree.  Takes O(log n) time.  Only provided when
+ * RBTREE_RANKS is 1.
+ */
+int rbtree_rank(rbtree_t *t, void *key_item);
+#endif
+
+/* rbtree_cursor_alloc() - Returns a new cursor on the red-black tree pointed
+ * to by t.  The cursor must be positioned by rbtree_cursor_seek() before use,
+ * and again whenever the tree has been changed.
+ */
+rbtree_cursor_t *rbtree_cursor_alloc(rbtree_t *t);
+
+/* rbtree_cursor_free() - Frees space used by the cursor pointed to by c. */
+void rbtree_cursor_free(rbtree_cursor_t *c);
+
+/* rbtree_cursor_seek() - Moves the cursor pointed to by c to the first item
+ * with a key not less than that of the item pointed to by `key_item', or to
+ * the first item if key_item is NULL, and returns it.  If there is no such
+ * item, the cursor is moved past the last item and NULL is returned.
+ */
+void *rbtree_cursor_seek(rbtree_cursor_t *c, void *key_item);
+
+/* rbtree_cursor_next() - Moves the cursor pointed to by c to the next item and
+ * returns it.  If there is no next item, NULL is returned and the cursor is
+ * not moved.
+ */
+void *rbtree_cursor_next(rbtree_cursor_t *c);
+
+/* rbtree_cursor_prev() - Moves the cursor pointed to by c to the previous
+ * item, or to the last item if it is past the last item, and returns it.  If
+ * there is no such item, NULL is returned and the cursor is not moved.
+ */
+void *rbtree_cursor_prev(rbtree_cursor_t *c);
+
 /*** Alternative interface via the universal dictionary structure type. ***/
 extern const dict_info_t RBTREE_info;
 
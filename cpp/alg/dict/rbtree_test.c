@@ -104,15 +104,76 @@ int item_cmp(const void *item1, const void *item2)
 }
 
 
+/* Compares the items pointed to by two elements of an array of item pointers,
+ * for sorting the array with qsort().
+ */
+int item_ptr_cmp(const void *p1, const void *p2)
+{
+    return item_cmp(*(test_item_t **)p1, *(test_item_t **)p2);
+}
+
+
+/* The rank and select tests are only built into rbtree_rank_test, which is
+ * compiled with -DRBTREE_RANKS=1.
+ */
+#if RBTREE_RANKS
+
+/* Returns the number of items in the subtree rooted at p, after checking the
+ * size held in each node of the subtree.
+ */
+int rbtree_size_r(rbtree_node_t *p)
+{
+    int size;
+
+    if(!p) return 0;
+    size = rbtree_size_r(p->left) + rbtree_size_r(p->right) + 1;
+    if(p->size != size) {
+	printf("failed - size %d at key %d.\n", p->size,
+	       ((test_item_t *)p->item)->data1);
+	exit(1);
+    }
+    return size;
+}
+
+
+/* Checks rbtree_select() and rbtree_rank() against the n items of items[],
+ * which are the items in the red-black tree in increasing order of key.
+ */
+void check_ranks(rbtree_t *t, test_item_t **items, int n)
+{
+    int k;
+
+    if(rbtree_size_r(t->root) != n) { printf("failed.\n"); exit(1); }
+    for(k = 0; k < n; k++) {
+	if(rbtree_select(t, k) != items[k] || rbtree_rank(t, items[k]) != k) {
+	    printf("failed - rank %d.\n", k);
+	    exit(1);
+	}
+    }
+    if(rbtree_select(t, -1) || rbtree_select(t, n)) {
+	printf("failed.\n");
+	exit(1);
+    }
+}
+#endif
+
+
 int main(void)
 {
     rbtree_t *t;
+    pool_t *pool;
     test_item_t item_array[N_ITEMS], *i, *i2, duplicate, lookup_item;
-    test_item_t *result;
+    test_item_t keys[N_ITEMS];
+    void *key_ptrs[N_ITEMS], *found[N_ITEMS];
+    test_item_t *result, *sorted[N_ITEMS];
     int j;
+#if RBTREE_RANKS
+    test_item_t *rest[N_ITEMS];
+    int n_rest;
+#endif
 
     /* Create a red-black tree. */
-    t = rbtree_alloc(item_cmp);
+    t = rbtree_alloc(item_cmp, NULL);
     
     /* Add some items to it. */    
     printf("Inserting items:\n");
@@ -154,6 +215,23 @@ putchar('\n');  rbtree_dump(t->root, 0);
 	printf("failed.\n");
     }
 
+    /* Test rbtree_find_many() against rbtree_find(), with every second key
+     * changed so that it may not be in the tree.
+     */
+    printf("Testing rbtree_find_many()...");
+    for(j = 0; j < N_ITEMS; j++) {
+	keys[j].data1 = item_array[j].data1 + j % 2;
+	key_ptrs[j] = &keys[j];
+    }
+    rbtree_find_many(t, key_ptrs, found, N_ITEMS);
+    for(j = 0; j < N_ITEMS; j++) {
+	if(found[j] != rbtree_find(t, key_ptrs[j])) {
+	    printf("failed.\n");
+	    exit(1);
+	}
+    }
+    printf("successful.\n");
+
     /* Test rbtree_find_min() */
     printf("Testing rbtree_find_min()...");
     result = rbtree_find_min(t);
@@ -182,7 +260,8 @@ putchar('\n');  rbtree_dump(t->root, 0);
     printf("successful.\n");
     
     /* Create a new tree then repeat rbtree_insert()/rbtree_delete(). */
-    t = rbtree_alloc(item_cmp);
+    pool = pool_alloc();  /* A shared pool, which nodes are returned to. */
+    t = rbtree_alloc(item_cmp, pool);
     printf("\nRepeating rbtree_insert()/rbtree_delete()...");
     for(j = 0; j < N_ITEMS; j++) {
 	i = &item_array[j];  /* Uniqueness of keys was enforced earlier. */
@@ -218,5 +297,75 @@ rbtree_dump(t->root, 0);
 
     rbtree_free(t);
     
+    /* Test rbtree_bulk_load() with the items in increasing order of key, then
+     * check that the result can be updated.
+     */
+    printf("\nTesting rbtree_bulk_load()...");
+    for(j = 0; j < N_ITEMS; j++) sorted[j] = &item_array[j];
+    qsort(sorted, N_ITEMS, sizeof(test_item_t *), item_ptr_cmp);
+    t = rbtree_alloc(item_cmp, NULL);
+    rbtree_bulk_load(t, (void **)sorted, N_ITEMS);
+    rbtree_dump(t->root, 0);
+    for(j = 0; j < N_ITEMS; j++) {
+	i = &item_array[j];
+	if(rbtree_find(t, i) != i) { printf("failed.\n"); exit(1); }
+    }
+    for(j = 0; j < N_ITEMS/2; j++) {
+	i = &item_array[j];
+	if(rbtree_delete(t, i) != i) { printf("failed.\n"); exit(1); }
+    }
+    rbtree_dump(t->root, 0);
+    for(j = 0; j < N_ITEMS/2; j++) {
+	i = &item_array[j];
+	rbtree_insert(t, i);
+    }
+    rbtree_dump(t->root, 0);
+    for(j = 0; j < N_ITEMS; j++) {
+	if(rbtree_delete_min(t) != sorted[j]) { printf("failed.\n"); exit(1); }
+    }
+    rbtree_free(t);
+    printf("successful.\n");
+
+#if RBTREE_RANKS
+    /* Test rbtree_select() and rbtree_rank() after inserting items in random
+     * order, after deleting every second item, and after deleting minimums,
+     * and on a tree from rbtree_bulk_load().  Deleted keys are looked up by
+     * rbtree_rank() as keys which are not in the tree.
+     */
+    printf("\nTesting rbtree_select() and rbtree_rank()...");
+    t = rbtree_alloc(item_cmp, pool);
+    for(j = 0; j < N_ITEMS; j++) rbtree_insert(t, &item_array[j]);
+    check_ranks(t, sorted, N_ITEMS);
+    n_rest = 0;
+    for(j = 0; j < N_ITEMS; j++) {
+	if(j % 2) {
+	    if(rbtree_delete(t, sorted[j]) != sorted[j]) {
+		printf("failed.\n");
+		exit(1);
+	    }
+	}
+	else {
+	    rest[n_rest++] = sorted[j];
+	}
+    }
+    check_ranks(t, rest, n_rest);
+    for(j = 1; j < N_ITEMS; j += 2) {
+	if(rbtree_rank(t, sorted[j]) != (j + 1) / 2) {
+	    printf("failed.\n");
+	    exit(1);
+	}
+    }
+    for(j = 0; j < n_rest / 2; j++) rbtree_delete_min(t);
+    check_ranks(t, rest + j, n_rest - j);
+    rbtree_free(t);
+    t = rbtree_alloc(item_cmp, pool);
+    rbtree_bulk_load(t, (void **)sorted, N_ITEMS);
+    check_ranks(t, sorted, N_ITEMS);
+    rbtree_free(t);
+    printf("successful.\n");
+#endif
+
+    pool_free(pool);
+
     return 0;
 }
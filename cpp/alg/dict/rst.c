@@ -3,26 +3,32 @@
 
 
 /* Prototypes for functions only visible within this file. */
-void rst_free_dfs(rst_node_t *p);
+void rst_free_dfs(rst_t *t, rst_node_t *p);
 
 
-/* rst_alloc() - Allocates space for a radix search trie and returns a
- * pointer to it.  The function get_value() returns the key value for a data
- * item.
+/* rst_alloc() - Allocates space for a radix search trie and returns a pointer
+ * to it.  The function get_value() returns the key value for a data item.
+ * Nodes are allocated from the pool pointed to by pool, which may be shared
+ * with other dictionaries, or from a new pool of the trie's own if pool is
+ * NULL.
  */
-rst_t *rst_alloc(unsigned int (* get_value)(const void *), int max_b)
+rst_t *rst_alloc(unsigned int (* get_value)(const void *), int max_b,
+	       pool_t *pool)
 {
     rst_t *t;
     rst_node_t *r;
     
 
     t = malloc(sizeof(rst_t));
-    r = t->root = malloc(sizeof(rst_node_t));
+    t->own_pool = !pool;
+    t->pool = pool ? pool : pool_alloc();
+    r = t->root = pool_get(t->pool, sizeof(rst_node_t));
     r->child_links = 0;
     r->a[0] = r->a[1] = NULL;
     t->n = 0;
     t->max_b = max_b;
     t->get_value = get_value;
+    OP_RESET(t->ops);
     t->stack = malloc(max_b * sizeof(rst_node_t *));
     t->path_info = malloc(max_b * sizeof(int));
 
@@ -30,17 +36,22 @@ rst_t *rst_alloc(unsigned int (* get_value)(const void *), int max_b)
 }
 
 
-/* rst_free() - Frees space used by the radix search trie pointed to by t.
+/* rst_free() - Frees space used by the radix search trie pointed to by t.  The
+ * nodes of a trie with its own pool are freed all at once, by freeing the
+ * pool.  Otherwise they are returned to the shared pool.
  */
 void rst_free(rst_t *t) {
-    rst_free_dfs(t->root);
+    if(t->own_pool) pool_free(t->pool);
+    else rst_free_dfs(t, t->root);
+    free(t->stack);
+    free(t->path_info);
     free(t);
 }
 
-void rst_free_dfs(rst_node_t *p) {
-    if(p->child_links & 1) rst_free_dfs(p->a[0]);
-    if(p->child_links & 2) rst_free_dfs(p->a[1]);
-    free(p);
+void rst_free_dfs(rst_t *t, rst_node_t *p) {
+    if(p->child_links & 1) rst_free_dfs(t, p->a[0]);
+    if(p->child_links & 2) rst_free_dfs(t, p->a[1]);
+    pool_put(t->pool, p, sizeof(rst_node_t));
 }
 
 
@@ -83,6 +94,7 @@ void *rst_insert(rst_t *t, void *item)
     if((item2 = p->a[j])) {
 	/* Check that the same item does not already exist in the tree. */
 	key2 = t->get_value(item2);
+	OP_COMP(t->ops);
 	if(key2 == key) return p->a[j];  /* Insert failed. */
 	/* else */
 
@@ -92,7 +104,9 @@ void *rst_insert(rst_t *t, void *item)
 	 * two mkeys differ.
 	 */
 	stop_mask = key ^ key2;  /* Exclusive OR */
-	x = malloc(sizeof(rst_node_t));
+	x = pool_get(t->pool, sizeof(rst_node_t));
+	OP_ALLOC(t->ops);
+	OP_LINK(t->ops);
 	p->a[j] = x;
 	p->child_links = p->child_links | (j+1);  /* Set bit j. */
 	for(;;) {
@@ -108,7 +122,9 @@ void *rst_insert(rst_t *t, void *item)
 	     */
 	    if(mask & stop_mask) break;
 
-	    x = malloc(sizeof(rst_node_t));
+	    x = pool_get(t->pool, sizeof(rst_node_t));
+	    OP_ALLOC(t->ops);
+	    OP_LINK(t->ops);
 	    p->a[j] = x;
 	    p->a[!j] = NULL;
 	    p->child_links = (j+1);  /* Only bit j is set. */
@@ -121,6 +137,8 @@ void *rst_insert(rst_t *t, void *item)
     else {
 	p->a[j] = item;
     }
+    OP_LINK(t->ops);
+    OP_DEPTH(t->ops, t->max_b - i);
 
     t->n++;
 
@@ -155,7 +173,7 @@ void *rst_find(rst_t *t, void *key_item) {
 	i--;
     }
 
-    if(!p->a[j] || t->get_value(p->a[j]) != key) return NULL;
+    if(!p->a[j] || (OP_COMP(t->ops), t->get_value(p->a[j]) != key)) return NULL;
     
     return p->a[j];
 }
@@ -221,7 +239,7 @@ void *rst_delete(rst_t *t, void *key_item) {
     /* The delete operation fails if the tree contains no items, or no mathcing
      * item was found.
      */
-    if(!p->a[j] || t->get_value(p->a[j]) != key) return NULL;
+    if(!p->a[j] || (OP_COMP(t->ops), t->get_value(p->a[j]) != key)) return NULL;
     return_item = p->a[j];
 
     /* Currently p->a[j] points to the item which is to be removed.  After
@@ -229,6 +247,7 @@ void *rst_delete(rst_t *t, void *key_item) {
      * other child pointer is NULL.  This deletion can propagate up to the next
      * level.
      */
+    OP_LINK(t->ops);
     tos--;
     for(;;) {
 	if(tos == 0) {  /* Special case: deleteing a child of the root node. */
@@ -239,7 +258,8 @@ void *rst_delete(rst_t *t, void *key_item) {
 	
         if(p->a[!j]) break;
 	
-	free(p);
+	OP_LINK(t->ops);
+	pool_put(t->pool, p, sizeof(rst_node_t));
         p = stack[--tos];
 	j = path_info[tos];
     }
@@ -259,7 +279,8 @@ void *rst_delete(rst_t *t, void *key_item) {
 	 */
         y = p->a[!j];
         do {
-	    free(p);
+	    OP_LINK(t->ops);
+	    pool_put(t->pool, p, sizeof(rst_node_t));
             p = stack[--tos];
 	    j = path_info[tos];
 	    if(p->a[!j]) break;
@@ -314,6 +335,7 @@ void *rst_delete_min(rst_t *t)
      * other child pointer is NULL.  This deletion can propagate up to the next
      * level.
      */
+    OP_LINK(t->ops);
     tos--;
     for(;;) {
 	if(tos == 0) {  /* Speical case:  removing a child of the root node. */
@@ -327,7 +349,8 @@ void *rst_delete_min(rst_t *t)
 	
         if(p->a[!j]) break;
 	
-	free(p);
+	OP_LINK(t->ops);
+	pool_put(t->pool, p, sizeof(rst_node_t));
         p = stack[--tos];
 	j = path_info[tos];
     }
@@ -347,7 +370,8 @@ void *rst_delete_min(rst_t *t)
 	 */
         y = p->a[!j];
         do {
-	    free(p);
+	    OP_LINK(t->ops);
+	    pool_put(t->pool, p, sizeof(rst_node_t));
             p = stack[--tos];
 	    j = path_info[tos];
 	    if(p->a[!j]) break;
@@ -370,7 +394,7 @@ void *rst_delete_min(rst_t *t)
 
 void *_rst_alloc(int (* compar)(const void *, const void *),
 		 unsigned int (* getval)(const void *)) {
-    return rst_alloc(getval, 8*sizeof(unsigned int));
+    return rst_alloc(getval, 8*sizeof(unsigned int), NULL);
 }
 
 void _rst_free(void *t) {
@@ -397,6 +421,10 @@ void *_rst_find_min(void *t) {
     return rst_find_min((rst_t *)t);
 }
 
+const opcount_t *_rst_counts(void *t) {
+    return &((rst_t *)t)->ops;
+}
+
 /* Radix search tree info */
 const dict_info_t RST_info = {
     _rst_alloc,
@@ -405,5 +433,13 @@ const dict_info_t RST_info = {
     _rst_delete,
     _rst_delete_min,
     _rst_find,
-    _rst_find_min
+    _rst_find_min,
+    _rst_counts,
+    NULL,  /* Items are not kept in key order, so there are no cursors. */
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,  /* Sorted input does not help, so there is no bulk load. */
+    NULL   /* No batched find. */
 };
@@ -1,6 +1,7 @@
 #ifndef RST_H
 #define RST_H
 #include "dict_info.h"  /* Defines the universal dictionary structure type. */
+#include "pool.h"
 
 /* This radix search trie implementation has code for two different
  * rearrangement schemes after deleting a node.  Use #define RST_FAST_DELETE 1
@@ -21,7 +22,10 @@ typedef struct rst_node {
     void *a[2];
 } rst_node_t;
 
-/* Structure type definition for a radix search trie. */
+/* Structure type definition for a radix search trie.  ops counts the
+ * operations performed on the trie, for experimental purposes.  Nodes are
+ * allocated from pool, which is the trie's own pool if own_pool is 1.
+ */
 typedef struct rst {
     rst_node_t *root;
     int n;
@@ -29,16 +33,24 @@ typedef struct rst {
     unsigned int (* get_value)(const void *);
     rst_node_t **stack;
     int *path_info;
+    pool_t *pool;
+    int own_pool;
+    opcount_t ops;
 } rst_t;
 
 
-/* rst_alloc() - Allocates space for a radix search trie and returns a
- * pointer to it.  The function get_value() returns the key value for a data
- * item.
+/* rst_alloc() - Allocates space for a radix search trie and returns a pointer
+ * to it.  The function get_value() returns the key value for a data item.
+ * Nodes are allocated from the pool pointed to by pool, which may be shared
+ * with other dictionaries, or from a new pool of the trie's own if pool is
+ * NULL.
  */
-rst_t *rst_alloc(unsigned int (* get_value)(const void *), int max_b);
+rst_t *rst_alloc(unsigned int (* get_value)(const void *), int max_b,
+	       pool_t *pool);
 
-/* rst_free() - Frees space used by the radix search trie pointed to by t.
+/* rst_free() - Frees space used by the radix search trie pointed to by t.  The
+ * nodes of a trie with its own pool are freed all at once, by freeing the
+ * pool.  Otherwise they are returned to the shared pool.
  */
 void rst_free(rst_t *t);
 
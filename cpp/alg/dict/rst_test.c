@@ -69,13 +69,14 @@ unsigned int item_value(const void *item)
 int main(void)
 {
     rst_t *t;
+    pool_t *pool;
     test_item_t item_array[N_ITEMS], *i, *i2, duplicate, lookup_item;
     test_item_t *result;
     int j;
 
 
     /* Create a dgital search tree. */
-    t = rst_alloc(item_value, MAX_BITS);
+    t = rst_alloc(item_value, MAX_BITS, NULL);
     
     /* Add some items to it. */    
     printf("Inserting items:\n");
@@ -145,7 +146,8 @@ int main(void)
     printf("successful.\n");
     
     /* Create a new tree then repeat rst_insert()/rst_delete(). */
-    t = rst_alloc(item_value, MAX_BITS);
+    pool = pool_alloc();  /* A shared pool, which nodes are returned to. */
+    t = rst_alloc(item_value, MAX_BITS, pool);
     printf("\nRepeating rst_insert()/rst_delete()...\n");
     for(j = 0; j < N_ITEMS; j++) {
 	i = &item_array[j];  /* Uniqueness of keys was enforced earlier. */
@@ -193,5 +195,7 @@ int main(void)
     }
     rst_free(t);
     
+    pool_free(pool);
+
     return 0;
 }
@@ -0,0 +1,709 @@
+/*** File shard_dict.c - Sharded Dictionary ***/
+#include <stdlib.h>
+#include "shard_dict.h"
+#include "avl.h"
+#include "rbtree.h"
+#include "tree23.h"
+
+
+/* When OP_COUNTS is 1, backend finds and cursor moves write the backend's
+ * operation counts, so they hold the shard's write lock, and only finds in
+ * different shards run together.  With -DOP_COUNTS=0, finds in the same shard
+ * share its read lock.
+ */
+#if OP_COUNTS
+#define FIND_LOCK(s) pthread_rwlock_wrlock(&(s)->lock)
+#else
+#define FIND_LOCK(s) pthread_rwlock_rdlock(&(s)->lock)
+#endif
+
+
+/*** Prototypes of functions only visible within this file. ***/
+
+int shard_dict_index(shard_dict_t *t, const void *item);
+int *shard_dict_partition(shard_dict_t *t, void **items, int n,
+                          void **sorted, int *order);
+void shard_dict_lock_all(shard_dict_t *t, int write);
+void shard_dict_unlock_all(shard_dict_t *t);
+int shard_dict_cursor_min(shard_dict_cursor_t *c);
+
+
+
+/*** Definitions of functions visible outside of this file. ***/
+
+/* shard_dict_alloc() - Allocates space for a sharded dictionary with n_shards
+ * shards, each a dictionary made by the alloc() function of fns, and returns
+ * a pointer to it.  The function compar compares they keys of two items, and
+ * returns a negative, zero, or positive integer depending on whether the
+ * first item is less than, equal to, or greater than the second.  The
+ * function getval gives a value for the key of an item, which is hashed to
+ * choose the item's shard.
+ */
+shard_dict_t *shard_dict_alloc(const dict_info_t *fns, int n_shards,
+                               int (* compar)(const void *, const void *),
+                               unsigned int (* getval)(const void *))
+{
+    shard_dict_t *t;
+    shard_t *s;
+    void *shards;
+    int i;
+
+    t = malloc(sizeof(shard_dict_t));
+    if(posix_memalign(&shards, SHARD_DICT_LINE,
+                      n_shards * sizeof(shard_slot_t))) {
+        free(t);
+        return NULL;
+    }
+    t->shards = shards;
+    t->n_shards = n_shards;
+    t->fns = fns;
+    t->compar = compar;
+    t->getval = getval;
+    OP_RESET(t->ops);
+
+    for(i = 0; i < n_shards; i++) {
+        s = &t->shards[i].s;
+        pthread_rwlock_init(&s->lock, NULL);
+        s->t = fns->alloc(compar, getval);
+        s->n = 0;
+    }
+
+    return t;
+}
+
+
+/* shard_dict_free() - Frees space used by the sharded dictionary pointed to by
+ * t.  No other thread may be using the dictionary.
+ */
+void shard_dict_free(shard_dict_t *t)
+{
+    shard_t *s;
+    int i;
+
+    for(i = 0; i < t->n_shards; i++) {
+        s = &t->shards[i].s;
+        t->fns->free(s->t);
+        pthread_rwlock_destroy(&s->lock);
+    }
+    free(t->shards);
+    free(t);
+}
+
+
+/* shard_dict_insert() - Inserts an item into the sharded dictionary pointed
+ * to by t.  If an item with the same key already exists, a pointer to that
+ * item is returned.  Otherwise, NULL is returned, indicating insertion was
+ * successful.
+ */
+void *shard_dict_insert(shard_dict_t *t, void *item)
+{
+    shard_t *s;
+    void *result;
+
+    s = &t->shards[shard_dict_index(t, item)].s;
+    pthread_rwlock_wrlock(&s->lock);
+    result = t->fns->insert(s->t, item);
+    if(!result) s->n++;
+    pthread_rwlock_unlock(&s->lock);
+
+    return result;
+}
+
+
+/* shard_dict_delete() - Deletes the item in the sharded dictionary with the
+ * same key as the item pointed to by `key_item'.  Returns a pointer to the
+ * deleted item, and NULL if no item was found.
+ */
+void *shard_dict_delete(shard_dict_t *t, void *key_item)
+{
+    shard_t *s;
+    void *result;
+
+    s = &t->shards[shard_dict_index(t, key_item)].s;
+    pthread_rwlock_wrlock(&s->lock);
+    result = t->fns->delete(s->t, key_item);
+    if(result) s->n--;
+    pthread_rwlock_unlock(&s->lock);
+
+    return result;
+}
+
+
+/* shard_dict_delete_min() - Deletes the item with the smallest key from the
+ * sharded dictionary pointed to by t.  Returns a pointer to the deleted item.
+ * Returns a NULL pointer if there are no items in the dictionary, or if the
+ * backend has no delete_min().
+ */
+void *shard_dict_delete_min(shard_dict_t *t)
+{
+    shard_t *s, *min_s;
+    void *item, *min_item;
+    int i;
+
+    if(!t->fns->delete_min) return NULL;
+
+    /* With every shard locked, the smallest of the shards' minimums is the
+     * minimum of the dictionary, and stays so until it is deleted.
+     */
+    shard_dict_lock_all(t, 1);
+    min_s = NULL;
+    min_item = NULL;
+    for(i = 0; i < t->n_shards; i++) {
+        s = &t->shards[i].s;
+        if(!s->n) continue;
+        item = t->fns->find_min(s->t);
+        if(!min_item || t->compar(item, min_item) < 0) {
+            min_s = s;
+            min_item = item;
+        }
+    }
+    if(min_s) {
+        min_item = t->fns->delete_min(min_s->t);
+        min_s->n--;
+    }
+    shard_dict_unlock_all(t);
+
+    return min_item;
+}
+
+
+/* shard_dict_find() - Find an item in the sharded dictionary with the same key
+ * as the item pointed to by `key_item'.  Returns a pointer to the item found,
+ * or NULL if no item was found.
+ */
+void *shard_dict_find(shard_dict_t *t, void *key_item)
+{
+    shard_t *s;
+    void *result;
+
+    s = &t->shards[shard_dict_index(t, key_item)].s;
+    FIND_LOCK(s);
+    result = t->fns->find(s->t, key_item);
+    pthread_rwlock_unlock(&s->lock);
+
+    return result;
+}
+
+
+/* shard_dict_find_min() - Returns a pointer to the minimum item in the
+ * sharded dictionary pointed to by t.  If there are no items in the
+ * dictionary a NULL pointer is returned.
+ */
+void *shard_dict_find_min(shard_dict_t *t)
+{
+    shard_t *s;
+    void *item, *min_item;
+    int i;
+
+    shard_dict_lock_all(t, OP_COUNTS);
+    min_item = NULL;
+    for(i = 0; i < t->n_shards; i++) {
+        s = &t->shards[i].s;
+        if(!s->n) continue;
+        item = t->fns->find_min(s->t);
+        if(!min_item || t->compar(item, min_item) < 0) min_item = item;
+    }
+    shard_dict_unlock_all(t);
+
+    return min_item;
+}
+
+
+/* shard_dict_find_many() - Finds the items in the sharded dictionary pointed
+ * to by t with the same keys as the n items pointed to by key_items[], and
+ * stores a pointer to each item found, or NULL, in items[].  The keys are
+ * grouped by shard, and each shard is searched with the backend's find_many()
+ * where it has one.
+ */
+void shard_dict_find_many(shard_dict_t *t, void **key_items, void **items,
+                          int n)
+{
+    shard_t *s;
+    void **keys, **found;
+    int *start, *order;
+    int i, j;
+
+    order = malloc(n * sizeof(int));
+    keys = malloc(n * sizeof(void *));
+    found = malloc(n * sizeof(void *));
+    start = shard_dict_partition(t, key_items, n, keys, order);
+
+    for(i = 0; i < t->n_shards; i++) {
+        if(start[i] == start[i+1]) continue;
+        s = &t->shards[i].s;
+        FIND_LOCK(s);
+        if(t->fns->find_many) {
+            t->fns->find_many(s->t, keys + start[i], found + start[i],
+                              start[i+1] - start[i]);
+        }
+        else {
+            for(j = start[i]; j < start[i+1]; j++) {
+                found[j] = t->fns->find(s->t, keys[j]);
+            }
+        }
+        pthread_rwlock_unlock(&s->lock);
+    }
+
+    for(j = 0; j < n; j++) items[order[j]] = found[j];
+
+    free(order);
+    free(start);
+    free(keys);
+    free(found);
+}
+
+
+/* shard_dict_bulk_load() - Adds the n items in the array items[], which must
+ * be in increasing order of key with no two keys equal, to the sharded
+ * dictionary pointed to by t.  Each shard's items are passed to the backend's
+ * bulk_load(), where it has one, and are otherwise inserted one at a time.
+ */
+void shard_dict_bulk_load(shard_dict_t *t, void **items, int n)
+{
+    shard_t *s;
+    void **shard_items;
+    int *start;
+    int i, k, m;
+
+    /* The partition is stable, so each shard's items stay in order. */
+    shard_items = malloc(n * sizeof(void *));
+    start = shard_dict_partition(t, items, n, shard_items, NULL);
+
+    for(i = 0; i < t->n_shards; i++) {
+        m = start[i+1] - start[i];
+        if(!m) continue;
+
+        s = &t->shards[i].s;
+        pthread_rwlock_wrlock(&s->lock);
+        if(s->n == 0 && t->fns->bulk_load) {
+            t->fns->bulk_load(s->t, shard_items + start[i], m);
+            s->n = m;
+        }
+        else {
+            for(k = start[i]; k < start[i+1]; k++) {
+                if(!t->fns->insert(s->t, shard_items[k])) s->n++;
+            }
+        }
+        pthread_rwlock_unlock(&s->lock);
+    }
+
+    free(start);
+    free(shard_items);
+}
+
+
+/* shard_dict_counts() - Stores the sum of the operation counts of the shards
+ * of the sharded dictionary pointed to by t in the structure pointed to by
+ * ops.  Every shard is locked for writing while the counts are summed.
+ */
+void shard_dict_counts(shard_dict_t *t, opcount_t *ops)
+{
+    const opcount_t *s_ops;
+    int i;
+
+    shard_dict_lock_all(t, 1);
+    OP_RESET(*ops);
+    for(i = 0; i < t->n_shards; i++) {
+        s_ops = t->fns->counts(t->shards[i].s.t);
+        ops->comps += s_ops->comps;
+        ops->allocs += s_ops->allocs;
+        ops->links += s_ops->links;
+        ops->restructs += s_ops->restructs;
+        if(s_ops->max_depth > ops->max_depth) {
+            ops->max_depth = s_ops->max_depth;
+        }
+    }
+    shard_dict_unlock_all(t);
+}
+
+
+/* shard_dict_cursor_alloc() - Returns a new cursor on the sharded dictionary
+ * pointed to by t, or NULL if the backend has no cursors.  The cursor must be
+ * positioned by shard_dict_cursor_seek() before use, and again whenever the
+ * dictionary has been changed.
+ */
+shard_dict_cursor_t *shard_dict_cursor_alloc(shard_dict_t *t)
+{
+    shard_dict_cursor_t *c;
+    int i;
+
+    if(!t->fns->cursor_alloc) return NULL;
+
+    c = malloc(sizeof(shard_dict_cursor_t));
+    c->t = t;
+    c->cursors = malloc(t->n_shards * sizeof(void *));
+    c->ahead = malloc(t->n_shards * sizeof(void *));
+    c->last = malloc(t->n_shards * sizeof(void *));
+    for(i = 0; i < t->n_shards; i++) {
+        c->cursors[i] = t->fns->cursor_alloc(t->shards[i].s.t);
+        c->ahead[i] = c->last[i] = NULL;
+    }
+    c->cur = -1;
+
+    return c;
+}
+
+
+/* shard_dict_cursor_free() - Frees space used by the cursor pointed to by c.
+ */
+void shard_dict_cursor_free(shard_dict_cursor_t *c)
+{
+    int i;
+
+    for(i = 0; i < c->t->n_shards; i++) c->t->fns->cursor_free(c->cursors[i]);
+    free(c->cursors);
+    free(c->ahead);
+    free(c->last);
+    free(c);
+}
+
+
+/* shard_dict_cursor_seek() - Moves the cursor pointed to by c to the first
+ * item with a key not less than that of the item pointed to by `key_item', or
+ * to the first item if key_item is NULL, and returns it.  If there is no such
+ * item, the cursor is moved past the last item and NULL is returned.
+ */
+void *shard_dict_cursor_seek(shard_dict_cursor_t *c, void *key_item)
+{
+    shard_dict_t *t = c->t;
+    shard_t *s;
+    int i;
+
+    for(i = 0; i < t->n_shards; i++) {
+        s = &t->shards[i].s;
+        FIND_LOCK(s);
+        c->ahead[i] = t->fns->seek(c->cursors[i], key_item);
+        pthread_rwlock_unlock(&s->lock);
+        c->last[i] = NULL;
+    }
+    c->cur = shard_dict_cursor_min(c);
+
+    return c->cur >= 0 ? c->ahead[c->cur] : NULL;
+}
+
+
+/* shard_dict_cursor_next() - Moves the cursor pointed to by c to the next
+ * item and returns it.  If there is no next item, NULL is returned and the
+ * cursor is not moved.
+ */
+void *shard_dict_cursor_next(shard_dict_cursor_t *c)
+{
+    shard_dict_t *t = c->t;
+    shard_t *s;
+    void *item, *next_item;
+    int m;
+
+    if((m = c->cur) < 0) return NULL;
+
+    /* Only the shard of the current item moves.  If it has no next item, its
+     * cursor stays at its last item, which is the current item.
+     */
+    item = c->ahead[m];
+    s = &t->shards[m].s;
+    FIND_LOCK(s);
+    next_item = t->fns->next(c->cursors[m]);
+    pthread_rwlock_unlock(&s->lock);
+    c->ahead[m] = next_item;
+    if(!next_item) {
+        if(shard_dict_cursor_min(c) < 0) {
+            c->ahead[m] = item;  /* No next item in any shard. */
+            return NULL;
+        }
+        c->last[m] = item;
+    }
+    c->cur = shard_dict_cursor_min(c);
+
+    return c->ahead[c->cur];
+}
+
+
+/* shard_dict_cursor_prev() - Moves the cursor pointed to by c to the previous
+ * item, or to the last item if it is past the last item, and returns it.  If
+ * there is no such item, NULL is returned and the cursor is not moved.
+ */
+void *shard_dict_cursor_prev(shard_dict_cursor_t *c)
+{
+    shard_dict_t *t = c->t;
+    shard_t *s;
+    void *item, *max_item;
+    int i, max_i;
+
+    /* The previous item is the largest of the items before each shard's
+     * position.  Each shard's cursor is stepped back to find its item, and
+     * forward again, except that a cursor past the end is left at the last
+     * item, which is recorded in last[].
+     */
+    max_i = -1;
+    max_item = NULL;
+    for(i = 0; i < t->n_shards; i++) {
+        s = &t->shards[i].s;
+        FIND_LOCK(s);
+        if(c->ahead[i]) {
+            if((item = t->fns->prev(c->cursors[i]))) {
+                t->fns->next(c->cursors[i]);
+            }
+        }
+        else if(!(item = c->last[i])) {
+            item = c->last[i] = t->fns->prev(c->cursors[i]);
+        }
+        pthread_rwlock_unlock(&s->lock);
+        if(item && (!max_item || t->compar(item, max_item) > 0)) {
+            max_i = i;
+            max_item = item;
+        }
+    }
+    if(max_i < 0) return NULL;
+
+    /* Move the cursor of the shard with the previous item to it, unless it
+     * is already there at the shard's last item.
+     */
+    if(c->ahead[max_i]) {
+        s = &t->shards[max_i].s;
+        FIND_LOCK(s);
+        t->fns->prev(c->cursors[max_i]);
+        pthread_rwlock_unlock(&s->lock);
+    }
+    c->ahead[max_i] = max_item;
+    c->last[max_i] = NULL;
+    c->cur = max_i;
+
+    return max_item;
+}
+
+
+
+/*** Definitions of functions only visible within this file. ***/
+
+/* shard_dict_index() - Returns the number of the shard of the item pointed
+ * to by item.  The value of its key is scrambled by Fibonacci hashing, so
+ * that runs of values are spread over the shards.
+ */
+int shard_dict_index(shard_dict_t *t, const void *item)
+{
+    unsigned long h;
+
+    h = (t->getval(item) * 2654435769UL) & 0xffffffffUL;
+    return (h ^ (h >> 16)) % t->n_shards;
+}
+
+
+/* shard_dict_partition() - Sorts the n items pointed to by items[] by shard
+ * with a counting sort, which keeps the items of each shard in their order in
+ * items[].  The items of shard i are put in sorted[start[i]..start[i+1]-1],
+ * and if order is not NULL, order[] holds the position in items[] of each.
+ * Returns the array start[] of n_shards + 1 entries, which the caller must
+ * free.
+ */
+int *shard_dict_partition(shard_dict_t *t, void **items, int n,
+                          void **sorted, int *order)
+{
+    int *shard_i, *start;
+    int i, j, k;
+
+    shard_i = malloc(n * sizeof(int));
+    start = calloc(t->n_shards + 1, sizeof(int));
+
+    for(k = 0; k < n; k++) {
+        shard_i[k] = shard_dict_index(t, items[k]);
+        start[shard_i[k] + 1]++;
+    }
+    for(i = 0; i < t->n_shards; i++) start[i+1] += start[i];
+    for(k = 0; k < n; k++) {
+        j = start[shard_i[k]]++;
+        sorted[j] = items[k];
+        if(order) order[j] = k;
+    }
+    for(i = t->n_shards; i > 0; i--) start[i] = start[i-1];
+    start[0] = 0;
+
+    free(shard_i);
+
+    return start;
+}
+
+
+/* shard_dict_lock_all() - Takes the lock of every shard of the dictionary
+ * pointed to by t, for writing if write is 1, or for reading otherwise.  The
+ * locks are always taken in order of shard number, so that threads which lock
+ * all of the shards can not deadlock.
+ */
+void shard_dict_lock_all(shard_dict_t *t, int write)
+{
+    int i;
+
+    for(i = 0; i < t->n_shards; i++) {
+        if(write) pthread_rwlock_wrlock(&t->shards[i].s.lock);
+        else pthread_rwlock_rdlock(&t->shards[i].s.lock);
+    }
+}
+
+
+/* shard_dict_unlock_all() - Releases the locks taken by
+ * shard_dict_lock_all().
+ */
+void shard_dict_unlock_all(shard_dict_t *t)
+{
+    int i;
+
+    for(i = t->n_shards - 1; i >= 0; i--) {
+        pthread_rwlock_unlock(&t->shards[i].s.lock);
+    }
+}
+
+
+/* shard_dict_cursor_min() - Returns the shard whose cursor is at the smallest
+ * item, for the cursor pointed to by c, or -1 if every shard's cursor is past
+ * its items.
+ */
+int shard_dict_cursor_min(shard_dict_cursor_t *c)
+{
+    int i, min_i;
+
+    min_i = -1;
+    for(i = 0; i < c->t->n_shards; i++) {
+        if(c->ahead[i] &&
+           (min_i < 0 || c->t->compar(c->ahead[i], c->ahead[min_i]) < 0)) {
+            min_i = i;
+        }
+    }
+
+    return min_i;
+}
+
+
+
+/*** Implement the universal dictionary structure type ***/
+
+/*** Sharded dictionary wrapper functions. ***/
+
+void *_shard_avl_alloc(int (* compar)(const void *, const void *),
+                       unsigned int (* getval)(const void *)) {
+    return shard_dict_alloc(&AVL_info, SHARD_DICT_SHARDS, compar, getval);
+}
+
+void *_shard_rbtree_alloc(int (* compar)(const void *, const void *),
+                          unsigned int (* getval)(const void *)) {
+    return shard_dict_alloc(&RBTREE_info, SHARD_DICT_SHARDS, compar, getval);
+}
+
+void *_shard_tree23_alloc(int (* compar)(const void *, const void *),
+                          unsigned int (* getval)(const void *)) {
+    return shard_dict_alloc(&TREE23_info, SHARD_DICT_SHARDS, compar, getval);
+}
+
+void _shard_dict_free(void *t) {
+    shard_dict_free((shard_dict_t *)t);
+}
+
+void *_shard_dict_insert(void *t, void *item) {
+    return shard_dict_insert((shard_dict_t *)t, item);
+}
+
+void *_shard_dict_delete(void *t, void *key_item) {
+    return shard_dict_delete((shard_dict_t *)t, key_item);
+}
+
+void *_shard_dict_delete_min(void *t) {
+    return shard_dict_delete_min((shard_dict_t *)t);
+}
+
+void *_shard_dict_find(void *t, void *key_item) {
+    return shard_dict_find((shard_dict_t *)t, key_item);
+}
+
+void *_shard_dict_find_min(void *t) {
+    return shard_dict_find_min((shard_dict_t *)t);
+}
+
+/* The counts() of dict_info_t returns a pointer, so the sums are kept in the
+ * dictionary, and are only stable while no other thread calls counts().
+ */
+const opcount_t *_shard_dict_counts(void *t) {
+    shard_dict_counts((shard_dict_t *)t, &((shard_dict_t *)t)->ops);
+    return &((shard_dict_t *)t)->ops;
+}
+
+void *_shard_dict_cursor_alloc(void *t) {
+    return shard_dict_cursor_alloc((shard_dict_t *)t);
+}
+
+void _shard_dict_cursor_free(void *c) {
+    shard_dict_cursor_free((shard_dict_cursor_t *)c);
+}
+
+void *_shard_dict_cursor_seek(void *c, void *key_item) {
+    return shard_dict_cursor_seek((shard_dict_cursor_t *)c, key_item);
+}
+
+void *_shard_dict_cursor_next(void *c) {
+    return shard_dict_cursor_next((shard_dict_cursor_t *)c);
+}
+
+void *_shard_dict_cursor_prev(void *c) {
+    return shard_dict_cursor_prev((shard_dict_cursor_t *)c);
+}
+
+void _shard_dict_bulk_load(void *t, void **items, int n) {
+    shard_dict_bulk_load((shard_dict_t *)t, items, n);
+}
+
+void _shard_dict_find_many(void *t, void **key_items, void **items, int n) {
+    shard_dict_find_many((shard_dict_t *)t, key_items, items, n);
+}
+
+/* Sharded AVL tree info */
+const dict_info_t SHARD_AVL_info = {
+    _shard_avl_alloc,
+    _shard_dict_free,
+    _shard_dict_insert,
+    _shard_dict_delete,
+    _shard_dict_delete_min,
+    _shard_dict_find,
+    _shard_dict_find_min,
+    _shard_dict_counts,
+    _shard_dict_cursor_alloc,
+    _shard_dict_cursor_free,
+    _shard_dict_cursor_seek,
+    _shard_dict_cursor_next,
+    _shard_dict_cursor_prev,
+    _shard_dict_bulk_load,
+    _shard_dict_find_many
+};
+
+/* Sharded red-black tree info */
+const dict_info_t SHARD_RBTREE_info = {
+    _shard_rbtree_alloc,
+    _shard_dict_free,
+    _shard_dict_insert,
+    _shard_dict_delete,
+    _shard_dict_delete_min,
+    _shard_dict_find,
+    _shard_dict_find_min,
+    _shard_dict_counts,
+    _shard_dict_cursor_alloc,
+    _shard_dict_cursor_free,
+    _shard_dict_cursor_seek,
+    _shard_dict_cursor_next,
+    _shard_dict_cursor_prev,
+    _shard_dict_bulk_load,
+    _shard_dict_find_many
+};
+
+/* Sharded 2-3 tree info */
+const dict_info_t SHARD_TREE23_info = {
+    _shard_tree23_alloc,
+    _shard_dict_free,
+    _shard_dict_insert,
+    _shard_dict_delete,
+    _shard_dict_delete_min,
+    _shard_dict_find,
+    _shard_dict_find_min,
+    _shard_dict_counts,
+    _shard_dict_cursor_alloc,
+    _shard_dict_cursor_free,
+    _shard_dict_cursor_seek,
+    _shard_dict_cursor_next,
+    _shard_dict_cursor_prev,
+    _shard_dict_bulk_load,
+    _shard_dict_find_many
+};
@@ -0,0 +1,222 @@
+/*** File shard_dict.h - Sharded Dictionary ***/
+#ifndef SHARD_DICT_H
+#define SHARD_DICT_H
+
+#include <pthread.h>
+#include "dict_info.h"
+
+/* A dictionary which may be used by many threads at once, built from any of
+ * the dictionaries with a dict_info_t.  It has the same item and compare
+ * function contract as the dictionary it is built from, the backend.
+ *
+ * Items are partitioned between n_shards shards by a hash of their key, and
+ * each shard is a separate backend dictionary guarded by its own
+ * reader-writer lock.  Inserts and deletes hold the write lock of one shard,
+ * so writers to different shards do not block each other.  Backend finds
+ * only read the dictionary, apart from the operation counts.  When built with
+ * -DOP_COUNTS=0, as for shard_test, finds hold the read lock, so finds in the
+ * same shard run together.  Otherwise they hold the write lock, so that the
+ * counts are kept without data races.  Each shard is padded out to a whole
+ * number of cache lines, so that locking one shard does not take the cache
+ * line of a neighbouring shard away from another processor.
+ *
+ * The key is hashed from the value given by the getval() function, so getval
+ * must give equal values for items with equal keys.  It need not give
+ * distinct values for distinct keys, although shards are only balanced when
+ * values are mostly distinct.  getval is also passed on to the backend.
+ *
+ * The minimum item is that of the shard with the smallest minimum.
+ * shard_dict_find_min() and shard_dict_delete_min() lock every shard, in
+ * order of shard number, so they give the same result as if the dictionary
+ * were not sharded.  Cursors merge the items of the shards in key order.  A
+ * cursor step locks each shard it reads in turn, so the items seen are only
+ * consistent while the dictionary is not changed, as for the backends.
+ */
+
+
+/*** Compile Time Options ***/
+
+/* The size of a cache line, in bytes.  Shards are padded to a multiple of
+ * this.
+ */
+#define SHARD_DICT_LINE 64
+
+/* The number of shards of the dictionaries made through SHARD_AVL_info,
+ * SHARD_RBTREE_info and SHARD_TREE23_info.
+ */
+#define SHARD_DICT_SHARDS 16
+
+
+
+/*** Structure Type Definitions. ***/
+
+/* A shard:
+ *     lock - guards t and n.
+ *     t - the backend dictionary.
+ *     n - the number of items in t.
+ */
+typedef struct shard {
+    pthread_rwlock_t lock;
+    void *t;
+    int n;
+} shard_t;
+
+/* A shard padded to a multiple of SHARD_DICT_LINE bytes. */
+typedef union shard_slot {
+    shard_t s;
+    char pad[((sizeof(shard_t) + SHARD_DICT_LINE - 1) / SHARD_DICT_LINE)
+             * SHARD_DICT_LINE];
+} shard_slot_t;
+
+/* Structure type definition for the sharded dictionary:
+ *     shards - the array of shards, aligned to SHARD_DICT_LINE bytes.
+ *     n_shards - the number of shards.
+ *     fns - the backend's dict_info_t.
+ *     compar, getval - the functions the dictionary was created with.
+ *     ops - the sum of the operation counts of the shards, filled in by the
+ *           counts() function of SHARD_AVL_info, SHARD_RBTREE_info and
+ *           SHARD_TREE23_info.
+ */
+typedef struct shard_dict {
+    shard_slot_t *shards;
+    int n_shards;
+    const dict_info_t *fns;
+    int (* compar)(const void *, const void *);
+    unsigned int (* getval)(const void *);
+    opcount_t ops;
+} shard_dict_t;
+
+/* Structure type for a cursor on the sharded dictionary, which merges cursors
+ * on each shard.  For each shard i:
+ *     cursors[i] - a cursor on the backend of shard i.
+ *     ahead[i] - the first item of the shard which is not before the merged
+ *                cursor's position, which cursors[i] is at, or NULL if there
+ *                is none.
+ *     last[i] - when ahead[i] is NULL, the last item of the shard if
+ *               cursors[i] is at it, or NULL if cursors[i] is past the end.
+ * cur is the shard holding the current item, or -1 when the cursor is past the
+ * last item.
+ */
+typedef struct shard_dict_cursor {
+    shard_dict_t *t;
+    void **cursors;
+    void **ahead;
+    void **last;
+    int cur;
+} shard_dict_cursor_t;
+
+
+
+/*** Function prototypes. ***/
+
+/* shard_dict_alloc() - Allocates space for a sharded dictionary with n_shards
+ * shards, each a dictionary made by the alloc() function of fns, and returns
+ * a pointer to it.  The function compar compares they keys of two items, and
+ * returns a negative, zero, or positive integer depending on whether the
+ * first item is less than, equal to, or greater than the second.  The
+ * function getval gives a value for the key of an item, which is hashed to
+ * choose the item's shard.
+ */
+shard_dict_t *shard_dict_alloc(const dict_info_t *fns, int n_shards,
+                               int (* compar)(const void *, const void *),
+                               unsigned int (* getval)(const void *));
+
+/* shard_dict_free() - Frees space used by the sharded dictionary pointed to by
+ * t.  No other thread may be using the dictionary.
+ */
+void shard_dict_free(shard_dict_t *t);
+
+/* shard_dict_insert() - Inserts an item into the sharded dictionary pointed
+ * to by t.  If an item with the same key already exists, a pointer to that
+ * item is returned.  Otherwise, NULL is returned, indicating insertion was
+ * successful.
+ */
+void *shard_dict_insert(shard_dict_t *t, void *item);
+
+/* shard_dict_delete() - Deletes the item in the sharded dictionary with the
+ * same key as the item pointed to by `key_item'.  Returns a pointer to the
+ * deleted item, and NULL if no item was found.
+ */
+void *shard_dict_delete(shard_dict_t *t, void *key_item);
+
+/* shard_dict_delete_min() - Deletes the item with the smallest key from the
+ * sharded dictionary pointed to by t.  Returns a pointer to the deleted item.
+ * Returns a NULL pointer if there are no items in the dictionary, or if the
+ * backend has no delete_min().
+ */
+void *shard_dict_delete_min(shard_dict_t *t);
+
+/* shard_dict_find() - Find an item in the sharded dictionary with the same key
+ * as the item pointed to by `key_item'.  Returns a pointer to the item found,
+ * or NULL if no item was found.
+ */
+void *shard_dict_find(shard_dict_t *t, void *key_item);
+
+/* shard_dict_find_min() - Returns a pointer to the minimum item in the
+ * sharded dictionary pointed to by t.  If there are no items in the
+ * dictionary a NULL pointer is returned.
+ */
+void *shard_dict_find_min(shard_dict_t *t);
+
+/* shard_dict_find_many() - Finds the items in the sharded dictionary pointed
+ * to by t with the same keys as the n items pointed to by key_items[], and
+ * stores a pointer to each item found, or NULL, in items[].  The keys are
+ * grouped by shard, and each shard is searched with the backend's find_many()
+ * where it has one.
+ */
+void shard_dict_find_many(shard_dict_t *t, void **key_items, void **items,
+                          int n);
+
+/* shard_dict_bulk_load() - Adds the n items in the array items[], which must
+ * be in increasing order of key with no two keys equal, to the sharded
+ * dictionary pointed to by t.  Each shard's items are passed to the backend's
+ * bulk_load(), where it has one, and are otherwise inserted one at a time.
+ */
+void shard_dict_bulk_load(shard_dict_t *t, void **items, int n);
+
+/* shard_dict_counts() - Stores the sum of the operation counts of the shards
+ * of the sharded dictionary pointed to by t in the structure pointed to by
+ * ops.  Every shard is locked for writing while the counts are summed.
+ */
+void shard_dict_counts(shard_dict_t *t, opcount_t *ops);
+
+/* shard_dict_cursor_alloc() - Returns a new cursor on the sharded dictionary
+ * pointed to by t, or NULL if the backend has no cursors.  The cursor must be
+ * positioned by shard_dict_cursor_seek() before use, and again whenever the
+ * dictionary has been changed.
+ */
+shard_dict_cursor_t *shard_dict_cursor_alloc(shard_dict_t *t);
+
+/* shard_dict_cursor_free() - Frees space used by the cursor pointed to by c.
+ */
+void shard_dict_cursor_free(shard_dict_cursor_t *c);
+
+/* shard_dict_cursor_seek() - Moves the cursor pointed to by c to the first
+ * item with a key not less than that of the item pointed to by `key_item', or
+ * to the first item if key_item is NULL, and returns it.  If there is no such
+ * item, the cursor is moved past the last item and NULL is returned.
+ */
+void *shard_dict_cursor_seek(shard_dict_cursor_t *c, void *key_item);
+
+/* shard_dict_cursor_next() - Moves the cursor pointed to by c to the next
+ * item and returns it.  If there is no next item, NULL is returned and the
+ * cursor is not moved.
+ */
+void *shard_dict_cursor_next(shard_dict_cursor_t *c);
+
+/* shard_dict_cursor_prev() - Moves the cursor pointed to by c to the previous
+ * item, or to the last item if it is past the last item, and returns it.  If
+ * there is no such item, NULL is returned and the cursor is not moved.
+ */
+void *shard_dict_cursor_prev(shard_dict_cursor_t *c);
+
+/*** Alternative interface via the universal dictionary structure type. ***/
+
+/* Sharded AVL trees, red-black trees and 2-3 trees, with SHARD_DICT_SHARDS
+ * shards.  Their alloc() functions need a getval() function.
+ */
+extern const dict_info_t SHARD_AVL_info;
+extern const dict_info_t SHARD_RBTREE_info;
+extern const dict_info_t SHARD_TREE23_info;
+
+#endif
@@ -0,0 +1,342 @@
+/*** File: shard_test.c - Test program for the sharded dictionary ***/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "shard_dict.h"
+#include "avl.h"
+#include "bench_util.h"
+
+
+/* This program first checks the sharded dictionary, then measures its
+ * throughput against an AVL tree protected by a single mutex, with the runs
+ * of bench_run() in bench_util.h.
+ *
+ * The checks are made through SHARD_AVL_info, SHARD_RBTREE_info and
+ * SHARD_TREE23_info in turn, with one thread, and then with CHECK_THREADS
+ * threads inserting, finding and deleting at once, after which the contents
+ * are compared with what they should be.  Last, CHECK_THREADS threads empty
+ * the dictionary with delete_min() at once, and each must get its items in
+ * increasing order, with no item deleted twice.  Throughput runs are made for
+ * read percentages 100, 90, 50 and 0, and for 1 up to the number of online
+ * processors, or a maximum number of threads given on the command line.
+ *
+ * Usage: shard_test [ops_per_thread [max_threads]]
+ */
+
+#define N_KEYS (1 << 20)
+#define N_CHECK (N_KEYS / 16)
+#define CHECK_THREADS 4
+
+
+/* Structure type for items. */
+typedef struct test_item {
+    int key;
+    int other_data;
+} test_item_t;
+
+/* The dictionaries being compared. */
+#define SHARDED 0
+#define LOCKED 1
+char *dict_desc[] = { "Sharded AVL", "Mutex+avl" };
+
+/* items[k] - the item with key k.
+ * fns - the dict_info_t of the sharded dictionary being checked.
+ */
+test_item_t *items;
+const dict_info_t *fns;
+
+
+/* Function to compare two items. */
+int compar(const void *item1, const void *item2)
+{
+    return ((test_item_t *)item1)->key - ((test_item_t *)item2)->key;
+}
+
+/* Function to give the value of an item's key. */
+unsigned int getval(const void *item)
+{
+    return ((test_item_t *)item)->key;
+}
+
+
+/* Dictionary wrapper functions for bench_run(). */
+void *_shard_find(void *t, void *item) {
+    return shard_dict_find((shard_dict_t *)t, item);
+}
+
+void *_shard_insert(void *t, void *item) {
+    return shard_dict_insert((shard_dict_t *)t, item);
+}
+
+void *_shard_delete(void *t, void *item) {
+    return shard_dict_delete((shard_dict_t *)t, item);
+}
+
+void *_ltree_find(void *t, void *item) {
+    return avl_find((avl_t *)t, item);
+}
+
+void *_ltree_insert(void *t, void *item) {
+    return avl_insert((avl_t *)t, item);
+}
+
+void *_ltree_delete(void *t, void *item) {
+    return avl_delete((avl_t *)t, item);
+}
+
+const bench_fns_t dict_fns[] = {
+    { _shard_find, _shard_insert, _shard_delete, NULL },
+    { _ltree_find, _ltree_insert, _ltree_delete, NULL }
+};
+
+
+/* Perform one run on the dictionary selected by `dict', with n_threads
+ * threads, and return the throughput in millions of operations per second.
+ */
+double run(bench_t *b, int dict, int n_threads)
+{
+    shard_dict_t *sdict;
+    avl_t *ltree;
+    double mops;
+    int k;
+
+    b->fns = &dict_fns[dict];
+    b->locked = dict == LOCKED;
+    if(dict == SHARDED) {
+        b->t = sdict = shard_dict_alloc(&AVL_info, SHARD_DICT_SHARDS, compar,
+                                        getval);
+        for(k = 0; k < N_KEYS; k += 2) shard_dict_insert(sdict, &items[k]);
+        mops = bench_run(b, n_threads);
+        shard_dict_free(sdict);
+    }
+    else {
+        b->t = ltree = avl_alloc(compar, NULL);
+        for(k = 0; k < N_KEYS; k += 2) avl_insert(ltree, &items[k]);
+        mops = bench_run(b, n_threads);
+        avl_free(ltree);
+    }
+
+    return mops;
+}
+
+
+/* Thread id of the concurrent check.  Inserts the keys k with
+ * k % CHECK_THREADS == id, in random order, while finding other keys and
+ * now and then summing the operation counts, and then deletes those of its
+ * keys with (k / CHECK_THREADS) odd.
+ */
+void *check_worker(void *p)
+{
+    bench_thread_t *arg;
+    opcount_t ops;
+    void *sdict;
+    int i, j, n, tmp, *keys;
+
+    arg = p;
+    sdict = arg->shared;
+    n = N_CHECK / CHECK_THREADS;
+    keys = malloc(n * sizeof(int));
+    for(i = 0; i < n; i++) keys[i] = i * CHECK_THREADS + arg->id;
+    for(i = n - 1; i > 0; i--) {
+        j = (int)(next_rand(&arg->seed) % (i + 1));
+        tmp = keys[i];  keys[i] = keys[j];  keys[j] = tmp;
+    }
+
+    for(i = 0; i < n; i++) {
+        if(fns->insert(sdict, &items[keys[i]])) arg->errors++;
+        if(fns->find(sdict, &items[keys[i]]) != &items[keys[i]]) {
+            arg->errors++;
+        }
+        if(fns->find(sdict, &items[next_rand(&arg->seed) % N_CHECK])) {
+            arg->found++;
+        }
+        if(i % 1024 == 0) shard_dict_counts(sdict, &ops);
+    }
+    for(i = 0; i < n; i++) {
+        if(keys[i] / CHECK_THREADS % 2) {
+            if(fns->delete(sdict, &items[keys[i]]) != &items[keys[i]]) {
+                arg->errors++;
+            }
+            if(fns->find(sdict, &items[keys[i]])) arg->errors++;
+        }
+    }
+
+    free(keys);
+    return NULL;
+}
+
+
+/* Thread of the concurrent delete_min() check.  Deletes minimums until the
+ * dictionary is empty, counting each item in other_data.  The items a thread
+ * gets must be in increasing order.
+ */
+void *delete_min_worker(void *p)
+{
+    bench_thread_t *arg;
+    test_item_t *item;
+    void *sdict;
+    int last_key;
+
+    arg = p;
+    sdict = arg->shared;
+    last_key = -1;
+    while((item = fns->delete_min(sdict))) {
+        if(item->key <= last_key) arg->errors++;
+        last_key = item->key;
+        __sync_fetch_and_add(&item->other_data, 1);
+    }
+
+    return NULL;
+}
+
+
+/* Check operation of the sharded dictionary of info, first with one thread
+ * and then with CHECK_THREADS threads.  Returns the number of errors.
+ */
+int check(const dict_info_t *info)
+{
+    test_item_t other, *item;
+    void *sdict, *c, **key_items, **found;
+    int k, errors;
+
+    errors = 0;
+    fns = info;
+
+    /* One thread: inserts, duplicates, deletes and finds. */
+    sdict = fns->alloc(compar, getval);
+    for(k = N_CHECK - 1; k >= 0; k--) {
+        if(fns->insert(sdict, &items[k])) errors++;
+    }
+    for(k = 0; k < N_CHECK; k++) {
+        other.key = k;
+        if(fns->insert(sdict, &other) != &items[k]) errors++;
+        if(fns->find(sdict, &other) != &items[k]) errors++;
+    }
+    for(k = 1; k < N_CHECK; k += 2) {
+        if(fns->delete(sdict, &items[k]) != &items[k]) errors++;
+        if(fns->delete(sdict, &items[k])) errors++;
+    }
+    key_items = malloc(N_CHECK * sizeof(void *));
+    found = malloc(N_CHECK * sizeof(void *));
+    for(k = 0; k < N_CHECK; k++) key_items[k] = &items[N_CHECK - 1 - k];
+    fns->find_many(sdict, key_items, found, N_CHECK);
+    for(k = 0; k < N_CHECK; k++) {
+        item = k % 2 ? &items[N_CHECK - 1 - k] : NULL;
+        if(fns->find(sdict, &items[N_CHECK - 1 - k]) != item) errors++;
+        if(found[k] != item) errors++;
+    }
+    free(key_items);
+    free(found);
+
+    /* The merged cursor must visit the even keys in order, both ways. */
+    c = fns->cursor_alloc(sdict);
+    other.key = 1;
+    if(fns->seek(c, &other) != &items[2]) errors++;
+    if(fns->prev(c) != &items[0] || fns->prev(c)) errors++;
+    for(k = 2; k < N_CHECK; k += 2) {
+        if(fns->next(c) != &items[k]) errors++;
+    }
+    if(fns->next(c)) errors++;
+    for(k = N_CHECK - 4; k >= 0; k -= 2) {
+        if(fns->prev(c) != &items[k]) errors++;
+    }
+    other.key = N_CHECK;
+    if(fns->seek(c, &other)) errors++;
+    if(fns->prev(c) != &items[N_CHECK - 2]) errors++;
+    if(fns->next(c)) errors++;
+    fns->cursor_free(c);
+
+    if(fns->find_min(sdict) != &items[0]) errors++;
+    for(k = 0; k < N_CHECK; k += 2) {
+        if(fns->delete_min(sdict) != &items[k]) errors++;
+    }
+    if(fns->delete_min(sdict) || fns->find_min(sdict)) errors++;
+    fns->free(sdict);
+
+    /* bulk_load(), in order. */
+    sdict = fns->alloc(compar, getval);
+    key_items = malloc(N_CHECK * sizeof(void *));
+    for(k = 0; k < N_CHECK; k++) key_items[k] = &items[k];
+    fns->bulk_load(sdict, key_items, N_CHECK);
+    free(key_items);
+    for(k = 0; k < N_CHECK; k++) {
+        if(fns->delete_min(sdict) != &items[k]) errors++;
+    }
+    fns->free(sdict);
+
+    /* CHECK_THREADS threads inserting, finding and deleting. */
+    sdict = fns->alloc(compar, getval);
+    errors += bench_threads(CHECK_THREADS, check_worker, sdict);
+    for(k = 0; k < N_CHECK; k++) {
+        item = k / CHECK_THREADS % 2 ? NULL : &items[k];
+        if(fns->find(sdict, &items[k]) != item) errors++;
+    }
+
+    /* CHECK_THREADS threads deleting minimums.  Every remaining item must be
+     * deleted exactly once.
+     */
+    for(k = 0; k < N_CHECK; k++) items[k].other_data = 0;
+    errors += bench_threads(CHECK_THREADS, delete_min_worker, sdict);
+    for(k = 0; k < N_CHECK; k++) {
+        if(items[k].other_data != (k / CHECK_THREADS % 2 ? 0 : 1)) errors++;
+    }
+    fns->free(sdict);
+
+    return errors;
+}
+
+
+int main(int argc, char *argv[])
+{
+    static const int read_pcts[] = { 100, 90, 50, 0 };
+    static const dict_info_t *infos[] = {
+        &SHARD_AVL_info, &SHARD_RBTREE_info, &SHARD_TREE23_info
+    };
+    static const char *info_names[] = { "AVL", "RB", "2-3" };
+    bench_t b;
+    long n_ops;
+    int i, k, t, dict, max_threads, errors, e;
+
+    n_ops = argc > 1 ? atol(argv[1]) : 1000000;
+    max_threads = argc > 2 ? atoi(argv[2])
+                           : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if(max_threads < 1) max_threads = 1;
+
+    items = malloc(N_KEYS * sizeof(test_item_t));
+    for(k = 0; k < N_KEYS; k++) {
+        items[k].key = k;
+        items[k].other_data = 0;
+    }
+
+    errors = 0;
+    for(i = 0; i < 3; i++) {
+        e = check(infos[i]);
+        printf("Check of sharded %s: %s\n", info_names[i],
+               e ? "FAILED" : "passed");
+        errors += e;
+    }
+
+    printf("\nThroughput (million operations per second), %d keys, %d "
+           "shards, %ld operations per thread\n", N_KEYS, SHARD_DICT_SHARDS,
+           n_ops);
+    printf("dict,\t\treads,\tthreads,\tMops/s\n");
+    b.items = (char *)items;
+    b.item_size = sizeof(test_item_t);
+    b.n_keys = N_KEYS;
+    b.n_ops = n_ops;
+    for(i = 0; i < (int)(sizeof(read_pcts)/sizeof(int)); i++) {
+        b.read_pct = read_pcts[i];
+        for(dict = SHARDED; dict <= LOCKED; dict++) {
+            for(t = 1; t <= max_threads; t++) {
+                printf("%s\t%d%%\t%d\t%.2f\n", dict_desc[dict],
+                       b.read_pct, t, run(&b, dict, t));
+            }
+        }
+    }
+
+    if(errors) printf("\n%d errors\n", errors);
+    free(items);
+
+    return errors != 0;
+}
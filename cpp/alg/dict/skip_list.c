@@ -7,6 +7,15 @@
 #include "skip_list.h"
 
 
+/* COMPAR() compares two items using the local variable compar, counting the
+ * comparison in the operation counts of the list t.
+ */
+#define COMPAR(a, b) (OP_COMP(t->ops), compar(a, b))
+
+/* The size of a node with l forward pointers. */
+#define NODE_SIZE(l) (sizeof(skip_node_t) + ((l) - 1) * sizeof(skip_node_t *))
+
+
 
 /* Prototypes for functions not visible outside of this file. */
 int skip_list_rand_level(double p, int max_level);
@@ -18,10 +27,13 @@ int skip_list_rand_level(double p, int max_level);
  * height increase when generating random node heights.  The function compar
  * compares they keys of two items, and returns a negative, zero, or positive
  * integer depending on whether the first item is less than, equal to, or
- * greater than the second.  
+ * greater than the second.  Nodes, with their forward pointers, are allocated
+ * from the pool pointed to by pool, which may be shared with other
+ * dictionaries, or from a new pool of the list's own if pool is NULL.
  */
 skip_list_t *skip_list_alloc(int max_n, double prob,
-			     int (* compar)(const void *, const void *))
+			     int (* compar)(const void *, const void *),
+			     pool_t *pool)
 {
     int i, max_level;
     skip_list_t *t;
@@ -29,6 +41,8 @@ skip_list_t *skip_list_alloc(int max_n, double prob,
 
     
     t = malloc(sizeof(skip_list_t));
+    t->own_pool = !pool;
+    t->pool = pool ? pool : pool_alloc();
     t->p = prob;
     t->compar = compar;
     max_level = t->max_level = -log(max_n)/log(prob);
@@ -40,6 +54,7 @@ skip_list_t *skip_list_alloc(int max_n, double prob,
     }
     
     t->n = 0;
+    OP_RESET(t->ops);
 
     /* We prevent repeatedly allocating an updates array during each insertion,
      * by using an array which was allocated when the list was created.
@@ -54,17 +69,24 @@ skip_list_t *skip_list_alloc(int max_n, double prob,
 
 
 
-/* skip_list_free() - Frees space used by the skip list pointed to by t. */
+/* skip_list_free() - Frees space used by the skip list pointed to by t.  The
+ * nodes of a list with its own pool are freed all at once, by freeing the
+ * pool.  Otherwise they are returned to the shared pool.
+ */
 void skip_list_free(skip_list_t *t)
 {
     skip_node_t *remove_node, *next;
 
-    next = t->head_ptrs[0];
-    while(next) {
-	remove_node = next;
-	next = remove_node->forward[0];
-	free(remove_node->forward);
-	free(remove_node);
+    if(t->own_pool) {
+	pool_free(t->pool);
+    }
+    else {
+	next = t->head_ptrs[0];
+	while(next) {
+	    remove_node = next;
+	    next = remove_node->forward[0];
+	    pool_put(t->pool, remove_node, NODE_SIZE(remove_node->size));
+	}
     }
 
     free(t->head_ptrs);
@@ -82,7 +104,7 @@ void skip_list_free(skip_list_t *t)
  */
 void *skip_list_insert(skip_list_t *t, void *item)
 {
-    skip_node_t *new_node, **forward, ***update;
+    skip_node_t *new_node, *pred, **forward, ***update;
     int (* compar)(const void *, const void *);
     int cmp_result;
     int i;
@@ -92,8 +114,9 @@ void *skip_list_insert(skip_list_t *t, void *item)
     update = t->update;
     max_level = t->max_level;
 
-    /* Locate insertion position. */
+    /* Locate insertion position.  pred is the node before it, if any. */
     forward = t->head_ptrs;
+    pred = NULL;
     i = max_level - 1;
     for(;;) {
 
@@ -107,13 +130,14 @@ void *skip_list_insert(skip_list_t *t, void *item)
 	/* Don't traverse toward nodes which are not smaller than the
 	 * item being searched for.
 	 */
-        while((cmp_result = compar(forward[i]->item, item)) >= 0) {
+        while((cmp_result = COMPAR(forward[i]->item, item)) >= 0) {
 	    update[i] = &forward[i];
 	    i--;
 	    if(i < 0) goto end_find_loop;
 	}
 
-	forward = forward[i]->forward;
+	pred = forward[i];
+	forward = pred->forward;
     }
   end_find_loop:
 
@@ -123,9 +147,12 @@ void *skip_list_insert(skip_list_t *t, void *item)
     if(forward[0] && cmp_result == 0) return forward[0]->item;
 
     /* Allocate a new node of a random size. */
-    new_node = malloc(sizeof(skip_node_t));
-    l = new_node->size = skip_list_rand_level(t->p, max_level);
-    forward = new_node->forward = malloc(l * sizeof(skip_node_t *));
+    l = skip_list_rand_level(t->p, max_level);
+    new_node = pool_get(t->pool, NODE_SIZE(l));
+    OP_ALLOC(t->ops);
+    OP_DEPTH(t->ops, l);
+    new_node->size = l;
+    forward = new_node->forward;
     new_node->item = item;
 
     /* Update pointers in the list. */
@@ -133,6 +160,9 @@ void *skip_list_insert(skip_list_t *t, void *item)
 	forward[i] = *update[i];
 	*update[i] = new_node;
     }
+    new_node->backward = pred;
+    if(forward[0]) forward[0]->backward = new_node;
+    OP_LINKS(t->ops, l);
 
     t->n++;
     
@@ -170,7 +200,7 @@ void *skip_list_find(skip_list_t *t, void *key_item)
 	/* Don't traverse toward nodes which are not smaller than the
 	 * item being searched for.
 	 */
-        while((cmp_result = compar(forward[i]->item, key_item)) >= 0) {
+        while((cmp_result = COMPAR(forward[i]->item, key_item)) >= 0) {
 	    i--;
 	    if(i < 0) goto end_find_loop;
 	}
@@ -195,7 +225,7 @@ void *skip_list_find(skip_list_t *t, void *key_item)
  */
 void *skip_list_find_min(skip_list_t *t)
 {
-    return t->head_ptrs[0];
+    return t->head_ptrs[0] ? t->head_ptrs[0]->item : NULL;
 }
 
     
@@ -233,7 +263,7 @@ void *skip_list_delete(skip_list_t *t, void *item)
 	/* Don't traverse toward nodes which are not smaller than the
 	 * item being searched for.
 	 */
-        while((cmp_result = compar(forward[i]->item, item)) >= 0) {
+        while((cmp_result = COMPAR(forward[i]->item, item)) >= 0) {
 	    update[i] = &forward[i];
 	    i--;
 	    if(i < 0) goto end_find_loop;
@@ -255,11 +285,12 @@ void *skip_list_delete(skip_list_t *t, void *item)
     for(i = 0; i < l; i++) {
         *update[i] = forward[i];
     }
+    if(forward[0]) forward[0]->backward = remove_node->backward;
+    OP_LINKS(t->ops, l);
 
     /* Free space and return the deleted item. */
     return_item = remove_node->item;
-    free(forward);
-    free(remove_node);
+    pool_put(t->pool, remove_node, NODE_SIZE(l));
 
     t->n--;
     
@@ -293,11 +324,12 @@ void *skip_list_delete_min(skip_list_t *t)
     for(i = 0; i < l; i++) {
         head_ptrs[i] = forward[i];
     }
+    if(forward[0]) forward[0]->backward = NULL;
+    OP_LINKS(t->ops, l);
 
     /* Free space and return the deleted item. */
     return_item = remove_node->item;
-    free(forward);
-    free(remove_node);
+    pool_put(t->pool, remove_node, NODE_SIZE(l));
 
     t->n--;
     
@@ -306,6 +338,161 @@ void *skip_list_delete_min(skip_list_t *t)
 
 
 
+/* skip_list_bulk_load() - Builds the skip list pointed to by t from the n
+ * items in the array items[], which must be in increasing order of key with no
+ * two keys equal.  An empty list is built in O(n) time, with node levels
+ * chosen deterministically instead of at random: with b = 1/p, every node has
+ * level 1, every b'th node level 2 or more, every b*b'th node level 3 or more,
+ * and so on.  Searches then follow the same path as in a perfectly balanced
+ * search tree.  If the skip list is not empty, the items are inserted one at a
+ * time instead.
+ */
+void skip_list_bulk_load(skip_list_t *t, void **items, int n)
+{
+    skip_node_t *new_node, *pred, ***update;
+    int i, j, k, l, b, max_level;
+
+    if(t->n > 0) {
+        for(j = 0; j < n; j++) skip_list_insert(t, items[j]);
+        return;
+    }
+
+    /* update[i] points to the last forward[i] pointer set so far, which is
+     * where the next node of level greater than i is linked in.
+     */
+    update = t->update;
+    max_level = t->max_level;
+    for(i = 0; i < max_level; i++) update[i] = &t->head_ptrs[i];
+
+    b = 1.0 / t->p + 0.5;
+    if(b < 2) b = 2;
+
+    pred = NULL;
+    for(j = 0; j < n; j++) {
+        for(l = 1, k = j + 1; l < max_level && k % b == 0; l++, k /= b);
+
+        new_node = pool_get(t->pool, NODE_SIZE(l));
+        OP_ALLOC(t->ops);
+        OP_DEPTH(t->ops, l);
+        new_node->size = l;
+        new_node->item = items[j];
+        for(i = 0; i < l; i++) {
+            new_node->forward[i] = NULL;
+            *update[i] = new_node;
+            update[i] = &new_node->forward[i];
+        }
+        new_node->backward = pred;
+        pred = new_node;
+        OP_LINKS(t->ops, l);
+    }
+
+    t->n = n;
+}
+
+
+/* skip_list_cursor_alloc() - Returns a new cursor on the skip list pointed to
+ * by t.  The cursor must be positioned by skip_list_cursor_seek() before use,
+ * and again whenever the list has been changed.
+ */
+skip_list_cursor_t *skip_list_cursor_alloc(skip_list_t *t)
+{
+    skip_list_cursor_t *c;
+
+    c = malloc(sizeof(skip_list_cursor_t));
+    c->t = t;
+    c->node = NULL;
+
+    return c;
+}
+
+
+
+/* skip_list_cursor_free() - Frees space used by the cursor pointed to by c. */
+void skip_list_cursor_free(skip_list_cursor_t *c)
+{
+    free(c);
+}
+
+
+
+/* skip_list_cursor_seek() - Moves the cursor pointed to by c to the first
+ * item with a key not less than that of the item pointed to by `key_item', or
+ * to the first item if key_item is NULL, and returns it.  If there is no such
+ * item, the cursor is moved past the last item and NULL is returned.
+ */
+void *skip_list_cursor_seek(skip_list_cursor_t *c, void *key_item)
+{
+    skip_list_t *t;
+    skip_node_t **forward;
+    int (* compar)(const void *, const void *);
+    int i;
+
+    t = c->t;
+    compar = t->compar;
+    forward = t->head_ptrs;
+
+    /* As in skip_list_find(), forward[0] ends up pointing to the first node
+     * whose item is not smaller than key_item.
+     */
+    if(key_item) {
+	for(i = t->max_level - 1; i >= 0; i--) {
+	    while(forward[i] && COMPAR(forward[i]->item, key_item) < 0) {
+		forward = forward[i]->forward;
+	    }
+	}
+    }
+
+    c->node = forward[0];
+    return c->node ? c->node->item : NULL;
+}
+
+
+
+/* skip_list_cursor_next() - Moves the cursor pointed to by c to the next item
+ * and returns it.  If there is no next item, NULL is returned and the cursor
+ * is not moved.
+ */
+void *skip_list_cursor_next(skip_list_cursor_t *c)
+{
+    if(!c->node || !c->node->forward[0]) return NULL;
+
+    c->node = c->node->forward[0];
+    return c->node->item;
+}
+
+
+
+/* skip_list_cursor_prev() - Moves the cursor pointed to by c to the previous
+ * item, or to the last item if it is past the last item, and returns it.  If
+ * there is no such item, NULL is returned and the cursor is not moved.
+ */
+void *skip_list_cursor_prev(skip_list_cursor_t *c)
+{
+    skip_node_t *p, **forward;
+    int i;
+
+    if(c->node) {
+	p = c->node->backward;
+    }
+    else {
+	/* Find the last node, going along the highest levels first. */
+	p = NULL;
+	forward = c->t->head_ptrs;
+	for(i = c->t->max_level - 1; i >= 0; i--) {
+	    while(forward[i]) {
+		p = forward[i];
+		forward = p->forward;
+	    }
+	}
+    }
+    if(!p) return NULL;
+
+    c->node = p;
+    return p->item;
+}
+
+
+
 /* skip_list_rand_level() - Returns a random level, based on the probability,
  * p, and the maximum level allowed, max_level.
  */
@@ -336,3 +523,86 @@ int skip_list_rand_level(double p, int max_level)
 
 /*     return i; */
 /* } */
+
+
+
+/*** Implement the universal dictionary structure type ***/
+
+/*** Skip list wrapper functions. ***/
+
+void *_skip_list_alloc(int (* compar)(const void *, const void *),
+		       unsigned int (* getval)(const void *)) {
+    return skip_list_alloc(SKIP_LIST_INFO_MAX_N, SKIP_LIST_INFO_PROB, compar,
+			   NULL);
+}
+
+void _skip_list_free(void *t) {
+    skip_list_free((skip_list_t *)t);
+}
+
+void *_skip_list_insert(void *t, void *item) {
+    return skip_list_insert((skip_list_t *)t, item);
+}
+
+void *_skip_list_delete(void *t, void *key_item) {
+    return skip_list_delete((skip_list_t *)t, key_item);
+}
+
+void *_skip_list_delete_min(void *t) {
+    return skip_list_delete_min((skip_list_t *)t);
+}
+
+void *_skip_list_find(void *t, void *key_item) {
+    return skip_list_find((skip_list_t *)t, key_item);
+}
+
+void *_skip_list_find_min(void *t) {
+    return skip_list_find_min((skip_list_t *)t);
+}
+
+const opcount_t *_skip_list_counts(void *t) {
+    return &((skip_list_t *)t)->ops;
+}
+
+void *_skip_list_cursor_alloc(void *t) {
+    return skip_list_cursor_alloc((skip_list_t *)t);
+}
+
+void _skip_list_cursor_free(void *c) {
+    skip_list_cursor_free((skip_list_cursor_t *)c);
+}
+
+void *_skip_list_cursor_seek(void *c, void *key_item) {
+    return skip_list_cursor_seek((skip_list_cursor_t *)c, key_item);
+}
+
+void *_skip_list_cursor_next(void *c) {
+    return skip_list_cursor_next((skip_list_cursor_t *)c);
+}
+
+void *_skip_list_cursor_prev(void *c) {
+    return skip_list_cursor_prev((skip_list_cursor_t *)c);
+}
+
+void _skip_list_bulk_load(void *t, void **items, int n) {
+    skip_list_bulk_load((skip_list_t *)t, items, n);
+}
+
+/* Skip list info. */
+const dict_info_t SKIP_LIST_info = {
+    _skip_list_alloc,
+    _skip_list_free,
+    _skip_list_insert,
+    _skip_list_delete,
+    _skip_list_delete_min,
+    _skip_list_find,
+    _skip_list_find_min,
+    _skip_list_counts,
+    _skip_list_cursor_alloc,
+    _skip_list_cursor_free,
+    _skip_list_cursor_seek,
+    _skip_list_cursor_next,
+    _skip_list_cursor_prev,
+    _skip_list_bulk_load,
+    NULL   /* No batched find. */
+};
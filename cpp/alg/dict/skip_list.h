@@ -4,20 +4,34 @@
 /*
  *   Shane Saunders
  */
+#include "dict_info.h"  /* Defines the universal dictionary structure type. */
+#include "pool.h"
+
+
+/* The expected maximum number of items, and the probability for height
+ * increase, used for skip lists allocated through SKIP_LIST_info.
+ */
+#define SKIP_LIST_INFO_MAX_N 1000000
+#define SKIP_LIST_INFO_PROB 0.5
+
 
 /* Structure type for skip list nodes.  For flexibility, nodes point to items,
  * rather than having integer keys, and the skip list uses a comparison
  * function for comparing items.
  *   item - The nodes item.
- *   forward - An array of pointers pointing forward to other nodes in the
- *             list.
+ *   backward - A pointer to the previous node in the list, or NULL for the
+ *              first node.
  *   size - the size of the forward array.  (i.e. the number of forward
  *          pointers the node has.)
+ *   forward - An array of pointers pointing forward to other nodes in the
+ *             list.  The array is allocated with the node, and extends past
+ *             the end of the structure when it has more than one entry.
  */
 typedef struct skip_node {
     void *item;
-    struct skip_node **forward;
+    struct skip_node *backward;
     int size;
+    struct skip_node *forward[1];
 } skip_node_t;
 
 
@@ -33,6 +47,10 @@ typedef struct skip_node {
  *       1, 2, 3, ... , n, is  p, p^2, p^3, ... , p^n, respectively.
  *   compar - A function for comparing items in the list.
  *   n - the number of items currently stored in the list.
+ *   pool - the pool that nodes are allocated from.
+ *   own_pool - 1 if the pool belongs to the list, and 0 if it is shared.
+ *   ops - counts the operations performed on the list, for experimental
+ *         purposes.
  */
 typedef struct skip_list {
     skip_node_t **head_ptrs;
@@ -41,8 +59,19 @@ typedef struct skip_list {
     int max_level;
     int (* compar)(const void *, const void *);
     int n;
+    pool_t *pool;
+    int own_pool;
+    opcount_t ops;
 } skip_list_t;
 
+/* Structure type for a cursor on the skip list.  node points to the node of
+ * the current item, and is NULL when the cursor is past the last item.
+ */
+typedef struct skip_list_cursor {
+    skip_list_t *t;
+    skip_node_t *node;
+} skip_list_cursor_t;
+
 
 
 /* skip_list_alloc() - Allocates space for a skip list and returns a pointer to
@@ -51,11 +80,18 @@ typedef struct skip_list {
  * height increase when generating random node heights.  The function compar
  * compares they keys of two items, and returns a negative, zero, or positive
  * integer depending on whether the first item is less than, equal to, or
- * greater than the second.  
+ * greater than the second.  Nodes, with their forward pointers, are allocated
+ * from the pool pointed to by pool, which may be shared with other
+ * dictionaries, or from a new pool of the list's own if pool is NULL.
  */
-skip_list_t *skip_list_alloc(int max_n, double prob, int (* compar)(const void *, const void *));
+skip_list_t *skip_list_alloc(int max_n, double prob,
+			     int (* compar)(const void *, const void *),
+			     pool_t *pool);
 
-/* skip_list_free() - Frees space used by the skip list pointed to by t. */
+/* skip_list_free() - Frees space used by the skip list pointed to by t.  The
+ * nodes of a list with its own pool are freed all at once, by freeing the
+ * pool.  Otherwise they are returned to the shared pool.
+ */
 void skip_list_free(skip_list_t *t);
 
 /* skip_list_insert() - Inserts an item into the skip list pointed to by t,
@@ -90,4 +126,46 @@ void *skip_list_delete(skip_list_t *t, void *item);
  */
 void *skip_list_delete_min(skip_list_t *t);
 
+/* skip_list_bulk_load() - Builds the skip list pointed to by t from the n
+ * items in the array items[], which must be in increasing order of key with no
+ * two keys equal.  An empty list is built in O(n) time, with node levels
+ * chosen deterministically instead of at random: with b = 1/p, every node has
+ * level 1, every b'th node level 2 or more, every b*b'th node level 3 or more,
+ * and so on.  Searches then follow the same path as in a perfectly balanced
+ * search tree.  If the skip list is not empty, the items are inserted one at a
+ * time instead.
+ */
+void skip_list_bulk_load(skip_list_t *t, void **items, int n);
+
+/* skip_list_cursor_alloc() - Returns a new cursor on the skip list pointed to
+ * by t.  The cursor must be positioned by skip_list_cursor_seek() before use,
+ * and again whenever the list has been changed.
+ */
+skip_list_cursor_t *skip_list_cursor_alloc(skip_list_t *t);
+
+/* skip_list_cursor_free() - Frees space used by the cursor pointed to by c. */
+void skip_list_cursor_free(skip_list_cursor_t *c);
+
+/* skip_list_cursor_seek() - Moves the cursor pointed to by c to the first
+ * item with a key not less than that of the item pointed to by `key_item', or
+ * to the first item if key_item is NULL, and returns it.  If there is no such
+ * item, the cursor is moved past the last item and NULL is returned.
+ */
+void *skip_list_cursor_seek(skip_list_cursor_t *c, void *key_item);
+
+/* skip_list_cursor_next() - Moves the cursor pointed to by c to the next item
+ * and returns it.  If there is no next item, NULL is returned and the cursor
+ * is not moved.
+ */
+void *skip_list_cursor_next(skip_list_cursor_t *c);
+
+/* skip_list_cursor_prev() - Moves the cursor pointed to by c to the previous
+ * item, or to the last item if it is past the last item, and returns it.  If
+ * there is no such item, NULL is returned and the cursor is not moved.
+ */
+void *skip_list_cursor_prev(skip_list_cursor_t *c);
+
+/*** Alternative interface via the universal dictionary structure type. ***/
+extern const dict_info_t SKIP_LIST_info;
+
 #endif
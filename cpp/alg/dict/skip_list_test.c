@@ -38,16 +38,26 @@ int item_cmp(const void *item1, const void *item2)
 }
 
 
+/* Compares the items pointed to by two elements of an array of item pointers,
+ * for sorting the array with qsort().
+ */
+int item_ptr_cmp(const void *p1, const void *p2)
+{
+    return item_cmp(*(test_item_t **)p1, *(test_item_t **)p2);
+}
+
+
 int main(void)
 {
     skip_list_t *t;
+    pool_t *pool;
     test_item_t item_array[N_ITEMS], *i, *i2, duplicate, lookup_item;
-    test_item_t *result;
+    test_item_t *result, *sorted[N_ITEMS];
     int j;
 
 
     /* Create a skip list. */
-    t = skip_list_alloc(N_ITEMS, 0.5, item_cmp);
+    t = skip_list_alloc(N_ITEMS, 0.5, item_cmp, NULL);
     
     /* Add some items to it.  In this example, items have two fields, data1 and
      * data2.  The data1 field is used as the items key (see the item
@@ -121,7 +131,8 @@ int main(void)
 
     
     /* Create a new tree then repeat skip_list_insert()/skip_list_delete(). */
-    t = skip_list_alloc(N_ITEMS, 0.5, item_cmp);
+    pool = pool_alloc();  /* A shared pool, which nodes are returned to. */
+    t = skip_list_alloc(N_ITEMS, 0.5, item_cmp, pool);
     printf("\nRepeating skip_list_insert()/skip_list_delete()...");
     for(j = 0; j < N_ITEMS; j++) {
 	i = &item_array[j];  /* Uniqueness of keys was enforced earlier. */
@@ -162,5 +173,33 @@ int main(void)
     }
     skip_list_free(t);
     
+    /* Test skip_list_bulk_load() with the items in increasing order of key,
+     * then check that the result can be updated.
+     */
+    printf("\nTesting skip_list_bulk_load()...");
+    for(j = 0; j < N_ITEMS; j++) sorted[j] = &item_array[j];
+    qsort(sorted, N_ITEMS, sizeof(test_item_t *), item_ptr_cmp);
+    t = skip_list_alloc(N_ITEMS, 0.5, item_cmp, NULL);
+    skip_list_bulk_load(t, (void **)sorted, N_ITEMS);
+    for(j = 0; j < N_ITEMS; j++) {
+	i = &item_array[j];
+	if(skip_list_find(t, i) != i) { printf("failed.\n"); exit(1); }
+    }
+    for(j = 0; j < N_ITEMS/2; j++) {
+	i = &item_array[j];
+	if(skip_list_delete(t, i) != i) { printf("failed.\n"); exit(1); }
+    }
+    for(j = 0; j < N_ITEMS/2; j++) {
+	i = &item_array[j];
+	skip_list_insert(t, i);
+    }
+    for(j = 0; j < N_ITEMS; j++) {
+	if(skip_list_delete_min(t) != sorted[j]) { printf("failed.\n"); exit(1); }
+    }
+    skip_list_free(t);
+    printf("successful.\n");
+
+    pool_free(pool);
+
     return 0;
 }
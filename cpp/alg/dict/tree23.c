@@ -6,23 +6,41 @@
 #include "tree23.h"
 
 
-/* tree23_alloc() - Allocates space for a 2-3 tree and returns a pointer to
- * it.  The function compar compares they keys of two items, and returns a
- * negative, zero, or positive integer depending on whether the first item is
- * less than, equal to, or greater than the second.
+/* COMPAR() compares two items using the local variable compar, counting the
+ * comparison in the operation counts of the tree t.
  */
-tree23_t *tree23_alloc(int (* compar)(const void *, const void *))
+#define COMPAR(a, b) (OP_COMP(t->ops), compar(a, b))
+
+/* CHILD() is a pointer to child i (0, 1 or 2) of the node pointed to by p.
+ * Children which are not in use are NULL.
+ */
+#define CHILD(p, i) \
+    ((i) == 0 ? &(p)->left : (i) == 1 ? &(p)->middle : &(p)->right)
+
+
+/* tree23_alloc() - Allocates space for a 2-3 tree and returns a pointer to it.
+ * The function compar compares they keys of two items, and returns a negative,
+ * zero, or positive integer depending on whether the first item is less than,
+ * equal to, or greater than the second.  Nodes are allocated from the pool
+ * pointed to by pool, which may be shared with other dictionaries, or from a
+ * new pool of the tree's own if pool is NULL.
+ */
+tree23_t *tree23_alloc(int (* compar)(const void *, const void *),
+		       pool_t *pool)
 {
     tree23_t *t;
     tree23_node_t *r;
     
     t = malloc(sizeof(tree23_t));
+    t->own_pool = !pool;
+    t->pool = pool ? pool : pool_alloc();
     t->n = 0;
+    OP_RESET(t->ops);
     t->min_item = NULL;
     t->compar = compar;
     t->stack = malloc(TREE23_STACK_SIZE * sizeof(tree23_node_t *));
     t->path_info = malloc(TREE23_STACK_SIZE * sizeof(signed char));
-    r = t->root = malloc(sizeof(tree23_node_t));
+    r = t->root = pool_get(t->pool, sizeof(tree23_node_t));
     r->key_item1 = r->key_item2 = NULL;
     r->link_kind = LEAF_LINK;
     r->left.item = r->middle.item = r->right.item = NULL;
@@ -31,31 +49,39 @@ tree23_t *tree23_alloc(int (* compar)(const void *, const void *))
 }
 
 
-/* tree23_free() - Frees space used by the 2-3 tree pointed to by t. */
+/* tree23_free() - Frees space used by the 2-3 tree pointed to by t.  The nodes
+ * of a tree with its own pool are freed all at once, by freeing the pool.
+ * Otherwise they are returned to the shared pool.
+ */
 void tree23_free(tree23_t *t)
 {
     int tos;
     tree23_node_t *p, **stack;
 
-    /* In order to free all nodes in the tree a depth first search is performed
-     * This is implemented using a stack.
+    /* The nodes of a tree with its own pool are freed with the pool.
+     * Otherwise, in order to return all nodes to the pool a depth first search
+     * is performed.  This is implemented using a stack.
      */
-
-    stack = malloc(2 * TREE23_STACK_SIZE * sizeof(tree23_node_t *));
-    stack[0] = t->root;
-    tos = 1;
-
-    while(tos) {
-        p = stack[--tos];
-        if(p->link_kind == INTERNAL_LINK) {
-	    stack[tos++] = p->left.node;
-	    stack[tos++] = p->middle.node;
-	    if(p->right.node) stack[tos++] = p->right.node;
-	}
-	free(p);
+    if(t->own_pool) {
+        pool_free(t->pool);
     }
+    else {
+        stack = malloc(2 * TREE23_STACK_SIZE * sizeof(tree23_node_t *));
+        stack[0] = t->root;
+        tos = 1;
+
+        while(tos) {
+            p = stack[--tos];
+            if(p->link_kind == INTERNAL_LINK) {
+                stack[tos++] = p->left.node;
+                stack[tos++] = p->middle.node;
+                if(p->right.node) stack[tos++] = p->right.node;
+            }
+            pool_put(t->pool, p, sizeof(tree23_node_t));
+        }
 
-    free(stack);
+        free(stack);
+    }
 
     free(t->stack);
     free(t->path_info);
@@ -89,7 +115,7 @@ void *tree23_insert(tree23_t *t, void *item)
 	    t->min_item = p->left.item = item;
 	}
 	else {  /* 1 item --> 2 items */
-	    cmp_result = compar(item, p->left.item);
+	    cmp_result = COMPAR(item, p->left.item);
 
 	    /* Check that an item with the same key does not already exist. */
 	    if(cmp_result == 0) return p->left.item;
@@ -106,6 +132,7 @@ void *tree23_insert(tree23_t *t, void *item)
 	}
 
 	t->n++;
+	OP_LINK(t->ops);
 	return NULL;  /* Insertion successful. */
     }
 
@@ -119,11 +146,11 @@ void *tree23_insert(tree23_t *t, void *item)
     /* Search the tree to locate the insertion position. */
     while(p->link_kind != LEAF_LINK) {
 	stack[tos] = p;
-	if(p->key_item2 && compar(item, p->key_item2) >= 0) {
+	if(p->key_item2 && COMPAR(item, p->key_item2) >= 0) {
 	    p = p->right.node;
 	    path_info[tos] = 1;
 	}
-	else if(compar(item, p->key_item1) >= 0) {
+	else if(COMPAR(item, p->key_item1) >= 0) {
 	    p = p->middle.node;
 	    path_info[tos] = 0;
 	}
@@ -133,6 +160,7 @@ void *tree23_insert(tree23_t *t, void *item)
 	}
         tos++;
     }
+    OP_DEPTH(t->ops, tos);
 
     key_item1 = p->key_item1;
     key_item2 = p->key_item2;
@@ -140,7 +168,7 @@ void *tree23_insert(tree23_t *t, void *item)
     /* Insert at the leaf items of node p.   Note that key_item1 is the same as
      * p->middle.item and key_item2 is the same as p->right.item.
      */
-    if(key_item2 && (cmp_result = compar(item, key_item2)) >= 0) {
+    if(key_item2 && (cmp_result = COMPAR(item, key_item2)) >= 0) {
         /* Insert beside right branch. */
 
 	/* Check if the same key already exists. */
@@ -153,7 +181,10 @@ void *tree23_insert(tree23_t *t, void *item)
 	 * of the new node.  The inserted item is the middle child of the
 	 * new node.
 	 */
-	new_node = malloc(sizeof(tree23_node_t));
+	new_node = pool_get(t->pool, sizeof(tree23_node_t));
+	OP_ALLOC(t->ops);
+	OP_LINK(t->ops);
+	OP_RESTRUCT(t->ops);
 	new_node->link_kind = LEAF_LINK;
 	new_node->left.item = p->right.item;
 	new_node->key_item1 = new_node->middle.item = item;
@@ -162,7 +193,7 @@ void *tree23_insert(tree23_t *t, void *item)
 
 	/* Insertion for new_node will continue higher up in the tree. */
     }
-    else if((cmp_result = compar(item, key_item1)) >= 0) {
+    else if((cmp_result = COMPAR(item, key_item1)) >= 0) {
         /* Insert beside the middle branch. */
 
 	/* Check if the same key already exists. */
@@ -178,7 +209,10 @@ void *tree23_insert(tree23_t *t, void *item)
 	     * the new node.  Node p's right child becomes the middle
 	     * child of the new node.
 	     */
-	    new_node = malloc(sizeof(tree23_node_t));
+	    new_node = pool_get(t->pool, sizeof(tree23_node_t));
+	    OP_ALLOC(t->ops);
+	    OP_LINK(t->ops);
+	    OP_RESTRUCT(t->ops);
 	    new_node->link_kind = LEAF_LINK;
 	    new_node->left.item = item;
 	    new_node->key_item1 = new_node->middle.item = p->right.item;
@@ -194,6 +228,7 @@ void *tree23_insert(tree23_t *t, void *item)
 
 	    /* No need to insert higher up. */
 	    t->n++;
+	    OP_LINK(t->ops);
 	    return NULL;  /* Insertion successful. */
 	}
     }
@@ -203,7 +238,7 @@ void *tree23_insert(tree23_t *t, void *item)
 	/* Account for the special case, where the item being inserted is
 	 * smaller than any other item in the tree.
 	 */
-	if((cmp_result = compar(item, p->left.item)) <= 0) {
+	if((cmp_result = COMPAR(item, p->left.item)) <= 0) {
 	    
 	    /* Check if the same key already exists in the tree. */
 	    if(cmp_result == 0) {
@@ -228,7 +263,10 @@ void *tree23_insert(tree23_t *t, void *item)
 	     * child of the new node.  The item being inserted becomes the
 	     * middle child of node p.
 	     */
-	    new_node = malloc(sizeof(tree23_node_t));
+	    new_node = pool_get(t->pool, sizeof(tree23_node_t));
+	    OP_ALLOC(t->ops);
+	    OP_LINK(t->ops);
+	    OP_RESTRUCT(t->ops);
 	    new_node->link_kind = LEAF_LINK;
 	    new_node->left.item = p->middle.item;
 	    new_node->key_item1 = new_node->middle.item = p->right.item;
@@ -248,12 +286,14 @@ void *tree23_insert(tree23_t *t, void *item)
 
 	    /* No need to insert higher up. */
 	    t->n++;
+	    OP_LINK(t->ops);
 	    return NULL;  /* Insertion successful. */
 	}
     }
 
     return_item = NULL;  /* Insertion successful. */
     t->n++;
+    OP_LINK(t->ops);
 
     /* x points to the node being inserted into the tree.  x_min keeps track of
      * the minimum item in the subtree rooted at the node x.
@@ -274,7 +314,10 @@ void *tree23_insert(tree23_t *t, void *item)
 	    /* Create a new node.  Node p's right child becomes the left child
 	     * of the new node.  Node x is the middle child of the new node.
 	     */
-	    new_node = malloc(sizeof(tree23_node_t));
+	    new_node = pool_get(t->pool, sizeof(tree23_node_t));
+	    OP_ALLOC(t->ops);
+	    OP_LINK(t->ops);
+	    OP_RESTRUCT(t->ops);
 	    new_node->link_kind = INTERNAL_LINK;
 	    new_node->left.node = p->right.node;
 	    new_node->middle.node = x;
@@ -298,7 +341,10 @@ void *tree23_insert(tree23_t *t, void *item)
 		 * node.  Node p's right child becomes the middle child of the
 		 * new node.
 		 */
-		new_node = malloc(sizeof(tree23_node_t));
+		new_node = pool_get(t->pool, sizeof(tree23_node_t));
+		OP_ALLOC(t->ops);
+		OP_LINK(t->ops);
+		OP_RESTRUCT(t->ops);
 	        new_node->link_kind = INTERNAL_LINK;
 		new_node->left.node = x;  /* x_min does not change. */
 		new_node->middle.node = p->right.node;
@@ -333,7 +379,10 @@ void *tree23_insert(tree23_t *t, void *item)
 		 * middle child of the new node.  Node x becomes the middle
 		 * child of node p.
 		 */
-		new_node = malloc(sizeof(tree23_node_t));
+		new_node = pool_get(t->pool, sizeof(tree23_node_t));
+		OP_ALLOC(t->ops);
+		OP_LINK(t->ops);
+		OP_RESTRUCT(t->ops);
 	        new_node->link_kind = INTERNAL_LINK;
 		new_node->left.node = p->middle.node;
 		new_node->middle.node = p->right.node;
@@ -372,7 +421,9 @@ void *tree23_insert(tree23_t *t, void *item)
      * will be created, with the child nodes pointed to by p (old root node)
      * and x (inserted node).
      */
-    new_node = malloc(sizeof(tree23_node_t));
+    new_node = pool_get(t->pool, sizeof(tree23_node_t));
+    OP_ALLOC(t->ops);
+    OP_LINK(t->ops);
     new_node->link_kind = INTERNAL_LINK;
     new_node->left.node = p;
     new_node->middle.node = x;
@@ -405,7 +456,7 @@ void *tree23_find(tree23_t *t, void *key_item)
      * zero or one nodes.
      */
     if(t->n <= 1) {
-        if(t->n && (compar(key_item, p->left.item) == 0)) return p->left.item;
+        if(t->n && (COMPAR(key_item, p->left.item) == 0)) return p->left.item;
       	/* else */
 	
 	return NULL;
@@ -413,10 +464,10 @@ void *tree23_find(tree23_t *t, void *key_item)
 
     /* Search the tree to locate the item with key key_item. */
     while(p->link_kind != LEAF_LINK) {
-	if(p->key_item2 && compar(key_item, p->key_item2) >= 0) {
+	if(p->key_item2 && COMPAR(key_item, p->key_item2) >= 0) {
 	    p = p->right.node;
 	}
-	else if(compar(key_item, p->key_item1) >= 0) {
+	else if(COMPAR(key_item, p->key_item1) >= 0) {
 	    p = p->middle.node;
 	}
 	else {
@@ -430,7 +481,7 @@ void *tree23_find(tree23_t *t, void *key_item)
     /* Find a leaf item of node p.   Note key_item1 is the same as
      * p->middle.item and key_item2 is the same as p->right.item.
      */
-    if(key_item2 && (cmp_result = compar(key_item, key_item2)) >= 0) {
+    if(key_item2 && (cmp_result = COMPAR(key_item, key_item2)) >= 0) {
 	/* Item may be right child. */
 
        	if(cmp_result) {
@@ -440,7 +491,7 @@ void *tree23_find(tree23_t *t, void *key_item)
 	/* else */
 	return key_item2;  /* Item found. */
     }
-    else if((cmp_result = compar(key_item, key_item1)) >= 0) {
+    else if((cmp_result = COMPAR(key_item, key_item1)) >= 0) {
 	/* Item may be middle child. */
 
 	if(cmp_result) {
@@ -453,7 +504,7 @@ void *tree23_find(tree23_t *t, void *key_item)
     else {
 	/* Item may be left child. */
 
-	if(compar(key_item, p->left.item)) {
+	if(COMPAR(key_item, p->left.item)) {
 	    /* Find failed - matching item does not exist in the tree. */
 	    return NULL;
 	}
@@ -464,6 +515,93 @@ void *tree23_find(tree23_t *t, void *key_item)
 
 
 
+/* tree23_find_many() - Finds the items in the 2-3 tree pointed to by t with
+ * the same keys as the n items pointed to by key_items[], and stores a pointer
+ * to each item found, or NULL, in items[].  The lookups are interleaved in
+ * groups of FIND_MANY_GROUP, with the next node of each prefetched, so that
+ * their cache misses overlap.
+ */
+void tree23_find_many(tree23_t *t, void **key_items, void **items,
+		      int n)
+{
+    int (* compar)(const void *, const void *);
+    int cmp_result;
+    tree23_node_t *p[FIND_MANY_GROUP], *q;
+    tree23_link_t *link;
+    int key_i[FIND_MANY_GROUP];
+    int i, j, group_n, active;
+    void *key_item;
+
+    /* The special cases of trees with zero or one items are left to
+     * tree23_find().
+     */
+    if(t->n <= 1) {
+	for(i = 0; i < n; i++) items[i] = tree23_find(t, key_items[i]);
+	return;
+    }
+
+    compar = t->compar;
+
+    for(i = 0; i < n; i += group_n) {
+	group_n = n - i < FIND_MANY_GROUP ? n - i : FIND_MANY_GROUP;
+	for(j = 0; j < group_n; j++) {
+	    PREFETCH(key_items[i+j]);
+	    p[j] = t->root;
+	    key_i[j] = i + j;
+	    items[i+j] = NULL;
+	}
+
+	/* Lookup j of the active lookups is at node p[j], for key
+	 * key_items[key_i[j]].  Each pass moves every active lookup down one
+	 * level.  The key items of the nodes reached are prefetched before any
+	 * of them are compared, and the children moved to are prefetched for
+	 * the next pass.  A lookup finishes at a node with leaf links, by
+	 * comparing the leaf item it reaches, and is replaced by the last
+	 * active one.
+	 */
+	active = group_n;
+	while(active) {
+	    for(j = 0; j < active; j++) {
+		q = p[j];
+		PREFETCH(q->key_item1);
+		if(q->key_item2) PREFETCH(q->key_item2);
+		if(q->link_kind == LEAF_LINK) PREFETCH(q->left.item);
+	    }
+	    for(j = 0; j < active; ) {
+		q = p[j];
+		key_item = key_items[key_i[j]];
+		if(q->key_item2 &&
+		   (cmp_result = COMPAR(key_item, q->key_item2)) >= 0) {
+		    link = &q->right;
+		}
+		else if((cmp_result = COMPAR(key_item, q->key_item1)) >= 0) {
+		    link = &q->middle;
+		}
+		else {
+		    link = &q->left;
+		}
+
+		if(q->link_kind != LEAF_LINK) {
+		    p[j++] = link->node;
+		    PREFETCH(link->node);
+		    continue;
+		}
+
+		/* Note key_item1 is the same as q->middle.item and key_item2
+		 * is the same as q->right.item.
+		 */
+		if(link == &q->left) cmp_result = COMPAR(key_item, link->item);
+		if(cmp_result == 0) items[key_i[j]] = link->item;  /* Found. */
+		active--;
+		p[j] = p[active];
+		key_i[j] = key_i[active];
+	    }
+	}
+    }
+}
+
+
+
 /* tree23_find_min() - Returns a pointer to the minimum item in the 2-3 tree
  * pointed to by t.  If there are no items in the tree a NULL pointer is
  * returned.
@@ -503,10 +641,11 @@ void *tree23_delete(tree23_t *t, void *key_item)
     	    /* else: one item in the tree... */
 
 	    /* Check if the item is the left child. */
-	    if(compar(key_item, p->left.item) == 0) {
+	    if(COMPAR(key_item, p->left.item) == 0) {
 	         return_item = p->left.item;  /* Item found. */
 	         t->min_item = p->left.item = NULL;
 		 t->n--;
+		 OP_LINK(t->ops);
 		 return return_item;
 	    }
 	    /* else */
@@ -516,13 +655,14 @@ void *tree23_delete(tree23_t *t, void *key_item)
         /* else: two items in the tree... */
 
 	/* Check if the item may be the middle child. */
-        if((cmp_result = compar(key_item, p->middle.item)) >= 0) {
+        if((cmp_result = COMPAR(key_item, p->middle.item)) >= 0) {
 
 	    /* check if the item is the middle child. */
 	    if(cmp_result == 0) {
 		return_item = p->middle.item;  /* Item found. */
 		p->key_item1 = p->middle.item = NULL;
 		t->n--;
+		OP_LINK(t->ops);
 		return return_item;
             }
 	    /* else */
@@ -531,11 +671,12 @@ void *tree23_delete(tree23_t *t, void *key_item)
 	}
 
         /* Check if the item is the left child. */
-	if(compar(key_item, p->left.item) == 0) {
+	if(COMPAR(key_item, p->left.item) == 0) {
              return_item = p->left.item;  /* Item found. */
              t->min_item = p->left.item = p->key_item1;
 	     p->key_item1 = p->middle.item = NULL;
 	     t->n--;
+	     OP_LINK(t->ops);
 	     return return_item;
 	}
 	/* else */
@@ -556,12 +697,12 @@ void *tree23_delete(tree23_t *t, void *key_item)
      */
     while(p->link_kind != LEAF_LINK) {
 	stack[tos] = p;
-	if(p->key_item2 && compar(key_item, p->key_item2) >= 0) {
+	if(p->key_item2 && COMPAR(key_item, p->key_item2) >= 0) {
 	    min_key_ptr = &p->key_item2;
 	    p = p->right.node;
 	    path_info[tos] = 1;
 	}
-	else if(compar(key_item, p->key_item1) >= 0) {
+	else if(COMPAR(key_item, p->key_item1) >= 0) {
 	    min_key_ptr = &p->key_item1;
 	    p = p->middle.node;
 	    path_info[tos] = 0;
@@ -579,7 +720,7 @@ void *tree23_delete(tree23_t *t, void *key_item)
     /* Delete the appropriate leaf item of node p.  Note that key_item1 is the
      * same as p->middle.item and key_item2 is the same as p->right.item.
      */
-    if(key_item2 && (cmp_result = compar(key_item, key_item2)) >= 0) {
+    if(key_item2 && (cmp_result = COMPAR(key_item, key_item2)) >= 0) {
 	/* Item may be right child. */
 
 	/* Check whether the item to be deleted was found. */
@@ -591,13 +732,14 @@ void *tree23_delete(tree23_t *t, void *key_item)
 	    /* Item found. */
 	    return_item = key_item2;
 	    t->n--;
+	    OP_LINK(t->ops);
 	    p->key_item2 = p->right.item = NULL;
 	}
 
 	/* No need for merge since node p still has two items. */
 	return return_item;
     }
-    else if((cmp_result = compar(key_item, key_item1)) >= 0) {
+    else if((cmp_result = COMPAR(key_item, key_item1)) >= 0) {
 	/* Item may be middle child. */
 
 	/* Check whether the item to be deleted was found. */
@@ -609,6 +751,7 @@ void *tree23_delete(tree23_t *t, void *key_item)
 	
 	return_item = key_item1;  /* Item found. */
 	t->n--;
+	OP_LINK(t->ops);
 
   	/* If node p has three children, two are left after the delete, and no
 	 * further rearrangement is needed.
@@ -628,13 +771,14 @@ void *tree23_delete(tree23_t *t, void *key_item)
     else {
 	/* Item may be left child. */
 
-	if(compar(key_item, p->left.item)) {
+	if(COMPAR(key_item, p->left.item)) {
 	    /* Delete failed - matching item does not exist in the tree. */
 	    return NULL;
 	}
 
         return_item = p->left.item;  /* item found. */
 	t->n--;
+	OP_LINK(t->ops);
 
 	/* Check if a key in the tree changes after deletion. */
 	if(min_key_ptr) {
@@ -696,7 +840,9 @@ void *tree23_delete(tree23_t *t, void *key_item)
 	    q->key_item2 = q->right.item = merge_item;
 	    parent->right.node = NULL;
 	    parent->key_item2 = NULL;
-	    free(p);
+	    OP_LINK(t->ops);
+	    OP_RESTRUCT(t->ops);
+	    pool_put(t->pool, p, sizeof(tree23_node_t));
 
 	    return return_item;  /* The parent still has two children. */
 	}
@@ -721,7 +867,9 @@ void *tree23_delete(tree23_t *t, void *key_item)
 	    
             /* Make merge_item a child of node q, and delete p. */
 	    q->key_item2 = q->right.item = merge_item;
-	    free(p);
+	    OP_LINK(t->ops);
+	    OP_RESTRUCT(t->ops);
+	    pool_put(t->pool, p, sizeof(tree23_node_t));
 
   	    /* If the parent of p and q had three children, then two will be
 	     * left after the merge, and merging will not be needed at the next
@@ -768,7 +916,9 @@ void *tree23_delete(tree23_t *t, void *key_item)
 	    q->key_item2 = q->right.item = q->key_item1;
 	    q->key_item1 = q->middle.item = q->left.item;
 	    q->left.item = merge_item;
-	    free(p);
+	    OP_LINK(t->ops);
+	    OP_RESTRUCT(t->ops);
+	    pool_put(t->pool, p, sizeof(tree23_node_t));
 	    
   	    /* If the parent of p and q had three children, then two will be
 	     * left after the merge, and merging will not be needed at the next
@@ -829,7 +979,9 @@ void *tree23_delete(tree23_t *t, void *key_item)
 		q->key_item2 = parent->key_item2;  /* merge_min */
 		parent->right.node = NULL;
 		parent->key_item2 = NULL;
-		free(p);
+		OP_LINK(t->ops);
+		OP_RESTRUCT(t->ops);
+		pool_put(t->pool, p, sizeof(tree23_node_t));
 
 		return return_item;  /* The parent still has two children. */
 	    }
@@ -858,7 +1010,9 @@ void *tree23_delete(tree23_t *t, void *key_item)
 		/* Make merge_node a child of node q, and delete p. */
 		q->right.node = merge_node;
 		q->key_item2 = parent->key_item1;  /* merge_min */
-		free(p);
+		OP_LINK(t->ops);
+		OP_RESTRUCT(t->ops);
+		pool_put(t->pool, p, sizeof(tree23_node_t));
 		
   	        /* If the parent of p and q had three children, then two will
 	         * be left after the merge, and merging will not be needed at
@@ -912,7 +1066,9 @@ void *tree23_delete(tree23_t *t, void *key_item)
 		q->key_item1 = parent->key_item1;
 		    /* Equals minimum item in tree(q->left.node). */
 		q->left.node = merge_node;
-		free(p);
+		OP_LINK(t->ops);
+		OP_RESTRUCT(t->ops);
+		pool_put(t->pool, p, sizeof(tree23_node_t));
 	    
   	        /* If the parent of p and q had three children, then two will
 	         * be left after the merge, and merging will not be needed at
@@ -940,7 +1096,9 @@ void *tree23_delete(tree23_t *t, void *key_item)
 
     /* Remove the old root node, p, making node merge_node the new root node.
      */
-    free(p);
+    OP_LINK(t->ops);
+    OP_RESTRUCT(t->ops);
+    pool_put(t->pool, p, sizeof(tree23_node_t));
     t->root = merge_node;
     
 
@@ -980,6 +1138,7 @@ void *tree23_delete_min(tree23_t *t)
 	    p->key_item1 = p->middle.item = NULL;
 	}
 	t->n--;
+	OP_LINK(t->ops);
 	return return_item;
     }
     /* else */
@@ -997,6 +1156,7 @@ void *tree23_delete_min(tree23_t *t)
 
     return_item = p->left.item;  /* Item found. */
     t->n--;
+    OP_LINK(t->ops);
     t->min_item = p->key_item1;  /* Minimum item in the 2-3 tree changes. */
 
     /* If node p has three children, two are left after the delete, and no
@@ -1046,7 +1206,9 @@ void *tree23_delete_min(tree23_t *t)
 	q->key_item2 = q->right.item = q->key_item1;
 	q->key_item1 = q->middle.item = q->left.item;
 	q->left.item = merge_item;
-	free(p);
+	OP_LINK(t->ops);
+	OP_RESTRUCT(t->ops);
+	pool_put(t->pool, p, sizeof(tree23_node_t));
 
 	/* If the parent of p and q had three children, then two will be left
 	 * after the merge, and merging will not be needed at the next level
@@ -1111,7 +1273,9 @@ void *tree23_delete_min(tree23_t *t)
 	    q->key_item1 = parent->key_item1;
 	        /* Equals minimum item in tree(q->left.node). */
 	    q->left.node = merge_node;
-	    free(p);
+	    OP_LINK(t->ops);
+	    OP_RESTRUCT(t->ops);
+	    pool_put(t->pool, p, sizeof(tree23_node_t));
 	    
 	    /* If the parent of p and q had three children, then two will
 	     * be left after the merge, and merging will not be needed at the
@@ -1137,7 +1301,9 @@ void *tree23_delete_min(tree23_t *t)
 
 
     /* Remove the old root node, p, making node x the new root node. */
-    free(p);
+    OP_LINK(t->ops);
+    OP_RESTRUCT(t->ops);
+    pool_put(t->pool, p, sizeof(tree23_node_t));
     t->root = merge_node;
     
 
@@ -1145,13 +1311,253 @@ void *tree23_delete_min(tree23_t *t)
 }
 
 
+/* tree23_bulk_load() - Builds the 2-3 tree pointed to by t from the n items in
+ * the array items[], which must be in increasing order of key with no two keys
+ * equal.  An empty tree is built bottom up, in O(n) time, grouping the items
+ * and then the nodes of each level into nodes with three children, and using
+ * nodes with two children only at the right hand end of a level.  If the 2-3
+ * tree is not empty, the items are inserted one at a time instead.
+ */
+void tree23_bulk_load(tree23_t *t, void **items, int n)
+{
+    tree23_link_t *links;
+    tree23_node_t *p;
+    void **mins;
+    int i, j, m, size, link_kind;
+
+    /* Trees of zero or one items use the special case root node, which
+     * tree23_insert() sets up.
+     */
+    if(t->n > 0 || n <= 1) {
+        for(i = 0; i < n; i++) tree23_insert(t, items[i]);
+        return;
+    }
+
+    /* links[0..m-1] holds the subtrees of the level being built, and
+     * mins[0..m-1] the minimum item of each.  Each level is written over the
+     * start of the one below it.
+     */
+    links = malloc(n * sizeof(tree23_link_t));
+    mins = malloc(n * sizeof(void *));
+    for(i = 0; i < n; i++) {
+        links[i].item = mins[i] = items[i];
+    }
+
+    m = n;
+    link_kind = LEAF_LINK;
+    while(m > 1) {
+        for(i = j = 0; i < m; i += size, j++) {
+            /* Leaving two or four subtrees requires nodes with two
+             * children, since a node cannot have one child.
+             */
+            size = m - i == 2 || m - i == 4 ? 2 : 3;
+            p = pool_get(t->pool, sizeof(tree23_node_t));
+            OP_ALLOC(t->ops);
+            p->link_kind = link_kind;
+            p->left = links[i];
+            p->middle = links[i+1];
+            p->key_item1 = mins[i+1];
+            if(size == 3) {
+                p->right = links[i+2];
+                p->key_item2 = mins[i+2];
+            }
+            else {
+                p->right.node = NULL;
+                p->key_item2 = NULL;
+            }
+            OP_LINKS(t->ops, size);
+            links[j].node = p;
+            mins[j] = mins[i];
+        }
+        m = j;
+        link_kind = INTERNAL_LINK;
+    }
+
+    pool_put(t->pool, t->root, sizeof(tree23_node_t));
+    t->root = links[0].node;
+    t->min_item = items[0];
+    t->n = n;
+
+    free(links);
+    free(mins);
+}
+
+
+/* tree23_cursor_alloc() - Returns a new cursor on the 2-3 tree pointed to by
+ * t.  The cursor must be positioned by tree23_cursor_seek() before use, and
+ * again whenever the tree has been changed.
+ */
+tree23_cursor_t *tree23_cursor_alloc(tree23_t *t)
+{
+    tree23_cursor_t *c;
+
+    c = malloc(sizeof(tree23_cursor_t));
+    c->t = t;
+    c->stack = malloc(TREE23_STACK_SIZE * sizeof(tree23_node_t *));
+    c->index = malloc(TREE23_STACK_SIZE * sizeof(signed char));
+    c->tos = 0;
+
+    return c;
+}
+
+
+/* tree23_cursor_free() - Frees space used by the cursor pointed to by c. */
+void tree23_cursor_free(tree23_cursor_t *c)
+{
+    free(c->stack);
+    free(c->index);
+    free(c);
+}
+
+
+/* tree23_cursor_seek() - Moves the cursor pointed to by c to the first item
+ * with a key not less than that of the item pointed to by `key_item', or to
+ * the first item if key_item is NULL, and returns it.  If there is no such
+ * item, the cursor is moved past the last item and NULL is returned.
+ */
+void *tree23_cursor_seek(tree23_cursor_t *c, void *key_item)
+{
+    int (* compar)(const void *, const void *);
+    tree23_t *t;
+    tree23_node_t *p;
+    void *item;
+    int i, tos;
+
+    t = c->t;
+    compar = t->compar;
+    c->tos = 0;
+    if(t->n == 0) return NULL;
+
+    /* Go down to the node whose children are the leaf items where key_item
+     * belongs, as in tree23_find().
+     */
+    p = t->root;
+    tos = 0;
+    while(p->link_kind != LEAF_LINK) {
+	if(!key_item) {
+	    i = 0;
+	}
+	else if(p->key_item2 && COMPAR(key_item, p->key_item2) >= 0) {
+	    i = 2;
+	}
+	else if(COMPAR(key_item, p->key_item1) >= 0) {
+	    i = 1;
+	}
+	else {
+	    i = 0;
+	}
+	c->stack[tos] = p;
+	c->index[tos++] = i;
+	p = CHILD(p, i)->node;
+    }
+    c->stack[tos] = p;
+    c->tos = tos + 1;
+
+    /* Take the first leaf item not less than key_item.  If all of them are
+     * less, the item sought is the first item of the next node.
+     */
+    for(i = 0; i < 3 && (item = CHILD(p, i)->item); i++) {
+	if(!key_item || COMPAR(key_item, item) <= 0) {
+	    c->index[tos] = i;
+	    return item;
+	}
+    }
+    c->index[tos] = i - 1;
+    item = tree23_cursor_next(c);
+    if(!item) c->tos = 0;
+
+    return item;
+}
+
+
+/* tree23_cursor_next() - Moves the cursor pointed to by c to the next item
+ * and returns it.  If there is no next item, NULL is returned and the cursor
+ * is not moved.
+ */
+void *tree23_cursor_next(tree23_cursor_t *c)
+{
+    tree23_node_t *p, **stack;
+    signed char *index;
+    int d, i;
+
+    stack = c->stack;
+    index = c->index;
+    if(!c->tos) return NULL;
+
+    /* Find the lowest node on the path with a child to the right of the
+     * path.
+     */
+    for(d = c->tos - 1; d >= 0; d--) {
+	i = index[d] + 1;
+	if(i < 3 && CHILD(stack[d], i)->item) break;
+    }
+    if(d < 0) return NULL;
+
+    /* Go down the leftmost path of that child. */
+    index[d] = i;
+    p = stack[d];
+    for(; d < c->tos - 1; d++) {
+	p = stack[d+1] = CHILD(p, index[d])->node;
+	index[d+1] = 0;
+    }
+
+    return CHILD(p, index[d])->item;
+}
+
+
+/* tree23_cursor_prev() - Moves the cursor pointed to by c to the previous
+ * item, or to the last item if it is past the last item, and returns it.  If
+ * there is no such item, NULL is returned and the cursor is not moved.
+ */
+void *tree23_cursor_prev(tree23_cursor_t *c)
+{
+    tree23_node_t *p, **stack;
+    signed char *index;
+    int d, i;
+
+    stack = c->stack;
+    index = c->index;
+
+    if(!c->tos) {
+	/* Go down the rightmost path from the root. */
+	if(c->t->n == 0) return NULL;
+	p = c->t->root;
+	for(d = 0; ; d++) {
+	    stack[d] = p;
+	    for(i = 2; !CHILD(p, i)->item; i--);
+	    index[d] = i;
+	    if(p->link_kind == LEAF_LINK) break;
+	    p = CHILD(p, i)->node;
+	}
+	c->tos = d + 1;
+	return CHILD(p, i)->item;
+    }
+
+    /* Find the lowest node on the path with a child to the left of the
+     * path.
+     */
+    for(d = c->tos - 1; d >= 0 && index[d] == 0; d--);
+    if(d < 0) return NULL;
+
+    /* Go down the rightmost path of that child. */
+    index[d]--;
+    p = stack[d];
+    for(; d < c->tos - 1; d++) {
+	p = stack[d+1] = CHILD(p, index[d])->node;
+	index[d+1] = p->right.node ? 2 : 1;
+    }
+
+    return CHILD(p, index[d])->item;
+}
+
+
 /*** Implement the universal dictionary structure type ***/
 
 /*** 2-3 tree wrapper functions. ***/
 
 void *_tree23_alloc(int (* compar)(const void *, const void *),
 		    unsigned int (* getval)(const void *)) {
-    return tree23_alloc(compar);
+    return tree23_alloc(compar, NULL);
 }
 
 void _tree23_free(void *t) {
@@ -1174,10 +1580,42 @@ void *_tree23_find(void *t, void *key_item) {
     return tree23_find((tree23_t *)t, key_item);
 }
 
+void _tree23_find_many(void *t, void **key_items, void **items, int n) {
+    tree23_find_many((tree23_t *)t, key_items, items, n);
+}
+
 void *_tree23_find_min(void *t) {
     return tree23_find_min((tree23_t *)t);
 }
 
+const opcount_t *_tree23_counts(void *t) {
+    return &((tree23_t *)t)->ops;
+}
+
+void *_tree23_cursor_alloc(void *t) {
+    return tree23_cursor_alloc((tree23_t *)t);
+}
+
+void _tree23_cursor_free(void *c) {
+    tree23_cursor_free((tree23_cursor_t *)c);
+}
+
+void *_tree23_cursor_seek(void *c, void *key_item) {
+    return tree23_cursor_seek((tree23_cursor_t *)c, key_item);
+}
+
+void *_tree23_cursor_next(void *c) {
+    return tree23_cursor_next((tree23_cursor_t *)c);
+}
+
+void *_tree23_cursor_prev(void *c) {
+    return tree23_cursor_prev((tree23_cursor_t *)c);
+}
+
+void _tree23_bulk_load(void *t, void **items, int n) {
+    tree23_bulk_load((tree23_t *)t, items, n);
+}
+
 /* 2-3 tree info. */
 const dict_info_t TREE23_info = {
     _tree23_alloc,
@@ -1186,5 +1624,13 @@ const dict_info_t TREE23_info = {
     _tree23_delete,
     _tree23_delete_min,
     _tree23_find,
-    _tree23_find_min
+    _tree23_find_min,
+    _tree23_counts,
+    _tree23_cursor_alloc,
+    _tree23_cursor_free,
+    _tree23_cursor_seek,
+    _tree23_cursor_next,
+    _tree23_cursor_prev,
+    _tree23_bulk_load,
+    _tree23_find_many
 };
@@ -5,6 +5,7 @@
  *   Shane Saunders
  */
 #include "dict_info.h"  /* Defines the universal dictionary structure type. */
+#include "pool.h"
 
 /* Stack size.  Specifies the maximum tree depth supported.
  * See tree23_alloc() in tree23.c.
@@ -63,6 +64,10 @@ typedef struct tree23_node {
  *   n - the number of data items stored in the tree.
  *   height - the height of the tree.
  *   min_item - a pointer to the minimum item in the 2-3 tree.
+ *   pool - the pool that nodes are allocated from.
+ *   own_pool - 1 if the pool belongs to the tree, and 0 if it is shared.
+ *   ops - counts the operations performed on the tree, for experimental
+ *         purposes.
  */
 typedef struct tree23 {
     tree23_node_t *root;
@@ -71,18 +76,39 @@ typedef struct tree23 {
     void *min_item;
     tree23_node_t **stack;
     signed char *path_info;
+    pool_t *pool;
+    int own_pool;
+    opcount_t ops;
 } tree23_t;
 
+/* Structure type for a cursor on the 2-3 tree.  stack[0..tos-1] holds the
+ * path from the root to the node whose child is the current item, and
+ * index[i] is the child of stack[i] on the path: 0, 1 or 2 for the left,
+ * middle or right child.  tos is 0 when the cursor is past the last item.
+ */
+typedef struct tree23_cursor {
+    tree23_t *t;
+    tree23_node_t **stack;
+    signed char *index;
+    int tos;
+} tree23_cursor_t;
+
 
 
-/* tree23_alloc() - Allocates space for a 2-3 tree and returns a pointer to
- * it.  The function compar compares they keys of two items, and returns a
- * negative, zero, or positive integer depending on whether the first item is
- * less than, equal to, or greater than the second.
+/* tree23_alloc() - Allocates space for a 2-3 tree and returns a pointer to it.
+ * The function compar compares they keys of two items, and returns a negative,
+ * zero, or positive integer depending on whether the first item is less than,
+ * equal to, or greater than the second.  Nodes are allocated from the pool
+ * pointed to by pool, which may be shared with other dictionaries, or from a
+ * new pool of the tree's own if pool is NULL.
  */
-tree23_t *tree23_alloc(int (* compar)(const void *, const void *));
+tree23_t *tree23_alloc(int (* compar)(const void *, const void *),
+		       pool_t *pool);
 
-/* tree23_free() - Frees space used by the 2-3 tree pointed to by t. */
+/* tree23_free() - Frees space used by the 2-3 tree pointed to by t.  The nodes
+ * of a tree with its own pool are freed all at once, by freeing the pool.
+ * Otherwise they are returned to the shared pool.
+ */
 void tree23_free(tree23_t *t);
 
 /* tree23_insert() - Inserts an item into the 2-3 tree pointed to by t,
@@ -99,6 +125,15 @@ void *tree23_insert(tree23_t *t, void *item);
  */
 void *tree23_find(tree23_t *t, void *key_item);
 
+/* tree23_find_many() - Finds the items in the 2-3 tree pointed to by t with
+ * the same keys as the n items pointed to by key_items[], and stores a pointer
+ * to each item found, or NULL, in items[].  The lookups are interleaved in
+ * groups of FIND_MANY_GROUP, with the next node of each prefetched, so that
+ * their cache misses overlap.
+ */
+void tree23_find_many(tree23_t *t, void **key_items, void **items,
+		      int n);
+
 /* tree23_find_min() - Returns a pointer to the minimum item in the 2-3 tree
  * pointed to by t.  If there are no items in the tree a NULL pointer is
  * returned.
@@ -117,6 +152,43 @@ void *tree23_delete(tree23_t *t, void *key_item);
  */
 void *tree23_delete_min(tree23_t *t);
 
+/* tree23_bulk_load() - Builds the 2-3 tree pointed to by t from the n items in
+ * the array items[], which must be in increasing order of key with no two keys
+ * equal.  An empty tree is built bottom up, in O(n) time, grouping the items
+ * and then the nodes of each level into nodes with three children, and using
+ * nodes with two children only at the right hand end of a level.  If the 2-3
+ * tree is not empty, the items are inserted one at a time instead.
+ */
+void tree23_bulk_load(tree23_t *t, void **items, int n);
+
+/* tree23_cursor_alloc() - Returns a new cursor on the 2-3 tree pointed to by
+ * t.  The cursor must be positioned by tree23_cursor_seek() before use, and
+ * again whenever the tree has been changed.
+ */
+tree23_cursor_t *tree23_cursor_alloc(tree23_t *t);
+
+/* tree23_cursor_free() - Frees space used by the cursor pointed to by c. */
+void tree23_cursor_free(tree23_cursor_t *c);
+
+/* tree23_cursor_seek() - Moves the cursor pointed to by c to the first item
+ * with a key not less than that of the item pointed to by `key_item', or to
+ * the first item if key_item is NULL, and returns it.  If there is no such
+ * item, the cursor is moved past the last item and NULL is returned.
+ */
+void *tree23_cursor_seek(tree23_cursor_t *c, void *key_item);
+
+/* tree23_cursor_next() - Moves the cursor pointed to by c to the next item
+ * and returns it.  If there is no next item, NULL is returned and the cursor
+ * is not moved.
+ */
+void *tree23_cursor_next(tree23_cursor_t *c);
+
+/* tree23_cursor_prev() - Moves the cursor pointed to by c to the previous
+ * item, or to the last item if it is past the last item, and returns it.  If
+ * there is no such item, NULL is returned and the cursor is not moved.
+ */
+void *tree23_cursor_prev(tree23_cursor_t *c);
+
 /*** Alternative interface via the universal dictionary structure type. ***/
 extern const dict_info_t TREE23_info;
 
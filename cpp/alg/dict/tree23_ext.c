@@ -9,6 +9,16 @@
 #include "tree23_ext.h"
 
 
+/* CHILD() is a pointer to child i (0, 1 or 2) of the node pointed to by p.
+ * Children which are not in use are NULL.
+ */
+#define CHILD(p, i) \
+    ((i) == 0 ? &(p)->left : (i) == 1 ? &(p)->middle : &(p)->right)
+
+/* Prototypes for functions only visible within this file. */
+int tree23_child_index(tree23_node_t *p);
+
+
 /* tree23_alloc() - Allocates space for a 2-3 tree and returns a pointer to
  * it.  The function compar compares they keys of two items, and returns a
  * negative, zero, or positive integer depending on whether the first item is
@@ -1113,3 +1123,162 @@ void *tree23_delete_min(tree23_t *t)
 
     return return_item;
 }
+
+
+
+/* tree23_cursor_alloc() - Returns a new cursor on the 2-3 tree pointed to by
+ * t.  The cursor must be positioned by tree23_cursor_seek() before use, and
+ * again whenever the tree has been changed.
+ */
+tree23_cursor_t *tree23_cursor_alloc(tree23_t *t)
+{
+    tree23_cursor_t *c;
+
+    c = malloc(sizeof(tree23_cursor_t));
+    c->t = t;
+    c->node = NULL;
+    c->index = 0;
+
+    return c;
+}
+
+
+/* tree23_cursor_free() - Frees space used by the cursor pointed to by c. */
+void tree23_cursor_free(tree23_cursor_t *c)
+{
+    free(c);
+}
+
+
+/* tree23_cursor_seek() - Moves the cursor pointed to by c to the first item
+ * with a key not less than that of the item pointed to by `key_item', or to
+ * the first item if key_item is NULL, and returns it.  If there is no such
+ * item, the cursor is moved past the last item and NULL is returned.
+ */
+void *tree23_cursor_seek(tree23_cursor_t *c, void *key_item)
+{
+    int (* compar)(const void *, const void *);
+    tree23_node_t *p;
+    void *item;
+    int i;
+
+    compar = c->t->compar;
+    c->node = NULL;
+    if(c->t->n == 0) return NULL;
+
+    /* Go down to the node whose children are the leaf items where key_item
+     * belongs, as in tree23_find().
+     */
+    p = c->t->root;
+    while(p->key_node1) {
+	if(!key_item) {
+	    p = p->left.node;
+	}
+	else if(p->key_node2 && compar(key_item, p->key_node2->left.item) >= 0) {
+	    p = p->right.node;
+	}
+	else if(compar(key_item, p->key_node1->left.item) >= 0) {
+	    p = p->middle.node;
+	}
+	else {
+	    p = p->left.node;
+	}
+    }
+    c->node = p;
+
+    /* Take the first leaf item not less than key_item.  If all of them are
+     * less, the item sought is the first item of the next node.
+     */
+    for(i = 0; i < 3 && (item = CHILD(p, i)->item); i++) {
+	if(!key_item || compar(key_item, item) <= 0) {
+	    c->index = i;
+	    return item;
+	}
+    }
+    c->index = i - 1;
+    item = tree23_cursor_next(c);
+    if(!item) c->node = NULL;
+
+    return item;
+}
+
+
+/* tree23_cursor_next() - Moves the cursor pointed to by c to the next item
+ * and returns it.  If there is no next item, NULL is returned and the cursor
+ * is not moved.
+ */
+void *tree23_cursor_next(tree23_cursor_t *c)
+{
+    tree23_node_t *p;
+    int i;
+
+    p = c->node;
+    if(!p) return NULL;
+    i = c->index + 1;
+
+    /* Go up until there is a child to the right of the path. */
+    while(i == 3 || !CHILD(p, i)->item) {
+	if(!p->parent) return NULL;
+	i = tree23_child_index(p) + 1;
+	p = p->parent;
+    }
+
+    /* Go down the leftmost path of that child. */
+    if(p->key_node1) {
+	for(p = CHILD(p, i)->node; p->key_node1; p = p->left.node);
+	i = 0;
+    }
+    c->node = p;
+    c->index = i;
+
+    return CHILD(p, i)->item;
+}
+
+
+/* tree23_cursor_prev() - Moves the cursor pointed to by c to the previous
+ * item, or to the last item if it is past the last item, and returns it.  If
+ * there is no such item, NULL is returned and the cursor is not moved.
+ */
+void *tree23_cursor_prev(tree23_cursor_t *c)
+{
+    tree23_node_t *p;
+    int i;
+
+    p = c->node;
+    if(!p) {
+	/* Go down the rightmost path from the root. */
+	if(c->t->n == 0) return NULL;
+	p = c->t->root;
+	for(i = 3; !CHILD(p, i - 1)->item; i--);
+    }
+    else {
+	/* Go up until there is a child to the left of the path. */
+	i = c->index;
+	while(i == 0) {
+	    if(!p->parent) return NULL;
+	    i = tree23_child_index(p);
+	    p = p->parent;
+	}
+    }
+
+    /* Go down the rightmost path of child i - 1. */
+    for(i--; p->key_node1; i = p->right.node ? 2 : 1) {
+	p = CHILD(p, i)->node;
+    }
+    c->node = p;
+    c->index = i;
+
+    return CHILD(p, i)->item;
+}
+
+
+
+/* tree23_child_index() - returns which child (0, 1 or 2) of its parent the
+ * node pointed to by p is.
+ */
+int tree23_child_index(tree23_node_t *p)
+{
+    if(p->parent->left.node == p) return 0;
+    if(p->parent->middle.node == p) return 1;
+    return 2;
+}
@@ -68,6 +68,17 @@ typedef struct tree23 {
     int n, height;
 } tree23_t;
 
+/* Structure type for a cursor on the 2-3 tree.  The current item is child
+ * `index' (0, 1 or 2 for the left, middle or right child) of the node pointed
+ * to by node.  node is NULL when the cursor is past the last item.  Since
+ * nodes have parent pointers, no path needs to be kept.
+ */
+typedef struct tree23_cursor {
+    tree23_t *t;
+    tree23_node_t *node;
+    int index;
+} tree23_cursor_t;
+
 
 
 /* tree23_alloc() - Allocates space for a 2-3 tree and returns a pointer to
@@ -112,4 +123,32 @@ void *tree23_delete(tree23_t *t, void *key_item);
  */
 void *tree23_delete_min(tree23_t *t);
 
+/* tree23_cursor_alloc() - Returns a new cursor on the 2-3 tree pointed to by
+ * t.  The cursor must be positioned by tree23_cursor_seek() before use, and
+ * again whenever the tree has been changed.
+ */
+tree23_cursor_t *tree23_cursor_alloc(tree23_t *t);
+
+/* tree23_cursor_free() - Frees space used by the cursor pointed to by c. */
+void tree23_cursor_free(tree23_cursor_t *c);
+
+/* tree23_cursor_seek() - Moves the cursor pointed to by c to the first item
+ * with a key not less than that of the item pointed to by `key_item', or to
+ * the first item if key_item is NULL, and returns it.  If there is no such
+ * item, the cursor is moved past the last item and NULL is returned.
+ */
+void *tree23_cursor_seek(tree23_cursor_t *c, void *key_item);
+
+/* tree23_cursor_next() - Moves the cursor pointed to by c to the next item
+ * and returns it.  If there is no next item, NULL is returned and the cursor
+ * is not moved.
+ */
+void *tree23_cursor_next(tree23_cursor_t *c);
+
+/* tree23_cursor_prev() - Moves the cursor pointed to by c to the previous
+ * item, or to the last item if it is past the last item, and returns it.  If
+ * there is no such item, NULL is returned and the cursor is not moved.
+ */
+void *tree23_cursor_prev(tree23_cursor_t *c);
+
 #endif
@@ -133,7 +133,8 @@ int main(void)
     tree23_t *t;
     test_item_t item_array[N_ITEMS], *i, *i2, duplicate, lookup_item;
     test_item_t *result;
-    int j;
+    tree23_cursor_t *c;
+    int j, n;
 
     exit_flag = 0;  /* For debugging. */
 
@@ -198,6 +199,32 @@ int main(void)
 	printf("failed.\n");
     }
 
+    /* Test the cursor functions. */
+    printf("Testing cursor scans...");
+    c = tree23_cursor_alloc(t);
+    n = 0;
+    for(i = tree23_cursor_seek(c, NULL); i; i = i2) {
+	n++;
+	i2 = tree23_cursor_next(c);
+	if(i2 && item_cmp(i2, i) <= 0) { printf("failed.\n"); exit(1); }
+    }
+    lookup_item.data1 = RND_MAX;  /* Greater than all keys. */
+    if(tree23_cursor_seek(c, &lookup_item)) { printf("failed.\n"); exit(1); }
+    for(i = tree23_cursor_prev(c); i; i = i2) {
+	n--;
+	i2 = tree23_cursor_prev(c);
+	if(i2 && item_cmp(i2, i) >= 0) { printf("failed.\n"); exit(1); }
+    }
+    for(j = 0; j < N_ITEMS; j++) {
+	i = &item_array[j];
+	i2 = tree23_cursor_seek(c, i);
+	if(tree23_find(t, i) ? i2 != i : i2 && item_cmp(i2, i) <= 0) {
+	    printf("failed.\n"); exit(1);
+	}
+    }
+    tree23_cursor_free(c);
+    printf("%s\n", n == 0 ? "successful." : "failed.");
+
     /* Test tree23_delete_min() */
     printf("Testing tree23_delete_min()...");
     result = tree23_delete_min(t);
@@ -120,17 +120,29 @@ int item_cmp(const void *item1, const void *item2)
 }
 
 
+/* Compares the items pointed to by two elements of an array of item pointers,
+ * for sorting the array with qsort().
+ */
+int item_ptr_cmp(const void *p1, const void *p2)
+{
+    return item_cmp(*(test_item_t **)p1, *(test_item_t **)p2);
+}
+
+
 int main(void)
 {
     tree23_t *t;
+    pool_t *pool;
     test_item_t item_array[N_ITEMS], *i, *i2, duplicate, lookup_item;
-    test_item_t *result;
+    test_item_t keys[N_ITEMS];
+    void *key_ptrs[N_ITEMS], *found[N_ITEMS];
+    test_item_t *result, *sorted[N_ITEMS];
     int j;
 
     exit_flag = 0;  /* For debugging. */
 
     /* Create a 2-3 tree. */
-    t = tree23_alloc(item_cmp);
+    t = tree23_alloc(item_cmp, NULL);
     
     /* Add some items to it.  In this example, items have two fields, data1 and
      * data2.  The data1 field is used as the items key (see the item
@@ -175,6 +187,23 @@ int main(void)
 	printf("failed.\n");
     }
 
+    /* Test tree23_find_many() against tree23_find(), with every second key
+     * changed so that it may not be in the tree.
+     */
+    printf("Testing tree23_find_many()...");
+    for(j = 0; j < N_ITEMS; j++) {
+	keys[j].data1 = item_array[j].data1 + j % 2;
+	key_ptrs[j] = &keys[j];
+    }
+    tree23_find_many(t, key_ptrs, found, N_ITEMS);
+    for(j = 0; j < N_ITEMS; j++) {
+	if(found[j] != tree23_find(t, key_ptrs[j])) {
+	    printf("failed.\n");
+	    exit(1);
+	}
+    }
+    printf("successful.\n");
+
     /* Test tree23_find_min() */
     printf("Testing tree23_find_min()...");
     result = tree23_find_min(t);
@@ -205,7 +234,8 @@ int main(void)
 
     
     /* Create a new tree then repeat tree23_insert()/tree23_delete(). */
-    t = tree23_alloc(item_cmp);
+    pool = pool_alloc();  /* A shared pool, which nodes are returned to. */
+    t = tree23_alloc(item_cmp, pool);
     printf("\nRepeating tree23_insert()/tree23_delete()...");
     for(j = 0; j < N_ITEMS; j++) {
 	i = &item_array[j];  /* Uniqueness of keys was enforced earlier. */
@@ -253,5 +283,36 @@ int main(void)
     }
     tree23_free(t);
     
+    /* Test tree23_bulk_load() with the items in increasing order of key, then
+     * check that the result can be updated.
+     */
+    printf("\nTesting tree23_bulk_load()...");
+    for(j = 0; j < N_ITEMS; j++) sorted[j] = &item_array[j];
+    qsort(sorted, N_ITEMS, sizeof(test_item_t *), item_ptr_cmp);
+    t = tree23_alloc(item_cmp, NULL);
+    tree23_bulk_load(t, (void **)sorted, N_ITEMS);
+    tree23_dump_r(t->root, 0);
+    for(j = 0; j < N_ITEMS; j++) {
+	i = &item_array[j];
+	if(tree23_find(t, i) != i) { printf("failed.\n"); exit(1); }
+    }
+    for(j = 0; j < N_ITEMS/2; j++) {
+	i = &item_array[j];
+	if(tree23_delete(t, i) != i) { printf("failed.\n"); exit(1); }
+    }
+    tree23_dump_r(t->root, 0);
+    for(j = 0; j < N_ITEMS/2; j++) {
+	i = &item_array[j];
+	tree23_insert(t, i);
+    }
+    tree23_dump_r(t->root, 0);
+    for(j = 0; j < N_ITEMS; j++) {
+	if(tree23_delete_min(t) != sorted[j]) { printf("failed.\n"); exit(1); }
+    }
+    tree23_free(t);
+    printf("successful.\n");
+
+    pool_free(pool);
+
     return 0;
 }
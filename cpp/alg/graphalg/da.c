@@ -5,9 +5,13 @@
 /* Implementations of Dijkstra's Algorithm. */
 
 #include <stdlib.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sched.h>
 #include "da.h"
 #include "../timing/timing.h"
 #include "../graphs/dgraph.h"
+#include "../heaps/mqheap.h"
 
 /*** Special values. ***/
 #define TRUE 1
@@ -19,12 +23,18 @@
  * vertex, and a pointer to a da_heap_info_t structure for the heap used.
  * Returns a da_result_t structure containing the resulting shortest path
  * distances, and timing information.
+ *
+ * The inserts and decrease-keys resulting from scanning the out set of a
+ * vertex are collected and passed to the heap in two batches.
  */
 da_result_t *heap_dijkstra(const dgraph_t *g, int v0,
 			   const heap_info_t *heap_info)
 {
-    int v, w;
+    int v, w, i;
     int *f, *s;
+    int *ins_v, *dec_v, *pos;
+    long *ins_k, *dec_k;
+    int n_ins, n_dec;
     long dist, *d;
     int n;
     
@@ -33,14 +43,12 @@ da_result_t *heap_dijkstra(const dgraph_t *g, int v0,
     
     void *front;
     int (*heap_delete_min)(void *);
-    void (*heap_insert)(void *, int, long);
-    void (*heap_decrease_key)(void *, int, long);
     int (*heap_n)(void *);
     void *(*heap_alloc)(int);
     void (*heap_free)(void *);
     
     da_result_t *result;
-    long dist_comps;
+    opcount_t dist_ops;
     
     size_t int_size, long_size;
 
@@ -49,14 +57,12 @@ da_result_t *heap_dijkstra(const dgraph_t *g, int v0,
     int_size = sizeof(int);
     long_size = sizeof(long);
     heap_delete_min = heap_info->delete_min;
-    heap_insert = heap_info->insert;
-    heap_decrease_key = heap_info->decrease_key;
     heap_n = heap_info->n;
     heap_alloc = heap_info->alloc;
     heap_free = heap_info->free;
 
     /* Start of Dijkstra's algorithm. */
-    dist_comps = 0;
+    OP_RESET(dist_ops);
     timer_start();
     vertices = g->vertices;
     result = malloc(sizeof(da_result_t));
@@ -66,24 +72,45 @@ da_result_t *heap_dijkstra(const dgraph_t *g, int v0,
     s = calloc(n, int_size);
     front = heap_alloc(n);
 
+    /* Batches of inserts and decrease-keys.  pos[w] is the index of w in
+     * whichever batch it is in, which is valid when that batch entry is w.
+     */
+    ins_v = malloc(n * int_size);
+    ins_k = malloc(n * long_size);
+    dec_v = malloc(n * int_size);
+    dec_k = malloc(n * long_size);
+    pos = calloc(n, int_size);
+
     /* The start vertex is part of the solution set. */
     s[v0] = TRUE;
     d[v0] = 0;
+    result->scans = 1;
 
     /* Put out set of the starting vertex into the frontier and update the
      * distances to vertices in the out set.  k is the index for the out set.
      */
+    n_ins = 0;
     edge_ptr = vertices[v0].first_edge;
     while(edge_ptr) {
         w = edge_ptr->vertex_no;
-        dist = d[w] = edge_ptr->dist;
-        heap_insert(front, w, dist);
+        dist = edge_ptr->dist;
+        i = pos[w];
+        if(!f[w]) {
+            d[w] = dist;
+            pos[w] = n_ins;
+            ins_v[n_ins] = w;
+            ins_k[n_ins++] = dist;
+            f[w] = TRUE;
+        }
+        else if(dist < d[w]) {
+            d[w] = ins_k[i] = dist;
+        }
+	edge_ptr = edge_ptr->next;
+    }
+    heap_insert_batch(heap_info, front, ins_v, ins_k, n_ins);
 #if DA_HEAP_DUMP
     heap_info->dump(front);
 #endif
-        f[w] = TRUE;
-	edge_ptr = edge_ptr->next;
-    }
 
     /* At this point we are assuming that all vertices are reachable from the
      * starting vertex and N > 1 so that j > 0.
@@ -101,9 +128,11 @@ da_result_t *heap_dijkstra(const dgraph_t *g, int v0,
          */
         s[v] = TRUE;
         f[v] = FALSE;
+        result->scans++;
 
         /* Update distances to vertices, w, in the out set of v.
          */
+        n_ins = n_dec = 0;
         edge_ptr = vertices[v].first_edge;
 	while(edge_ptr) {
 	    w = edge_ptr->vertex_no;
@@ -117,40 +146,61 @@ da_result_t *heap_dijkstra(const dgraph_t *g, int v0,
                  */
                 dist = d[v] + edge_ptr->dist;
                 if(f[w]) {
-		    dist_comps++;
+		    OP_COMP(dist_ops);
                     if(dist < d[w]) {
                         d[w] = dist;
-                        heap_decrease_key(front, w, dist);
-#if DA_HEAP_DUMP
-    heap_info->dump(front);
-#endif
- 
+
+                        /* If w is already in one of the batches, only its key
+                         * in the batch is updated.
+                         */
+                        i = pos[w];
+                        if(i < n_ins && ins_v[i] == w) {
+                            ins_k[i] = dist;
+                        }
+                        else if(i < n_dec && dec_v[i] == w) {
+                            dec_k[i] = dist;
+                        }
+                        else {
+                            pos[w] = n_dec;
+                            dec_v[n_dec] = w;
+                            dec_k[n_dec++] = dist;
+                        }
                     }
                 }
                 else {
                     d[w] = dist;
-                    heap_insert(front, w, dist);
-#if DA_HEAP_DUMP
-    heap_info->dump(front);
-#endif
- 
+                    pos[w] = n_ins;
+                    ins_v[n_ins] = w;
+                    ins_k[n_ins++] = dist;
                     f[w] = TRUE;
                 }
             } /* if */
 
 	    edge_ptr = edge_ptr->next;
         } /* while */
+
+        heap_decrease_key_batch(heap_info, front, dec_v, dec_k, n_dec);
+        heap_insert_batch(heap_info, front, ins_v, ins_k, n_ins);
+#if DA_HEAP_DUMP
+    heap_info->dump(front);
+#endif
     } /* while */
 
     /* End of Dijkstra's algorithm. */
 
     /* Record timing information. */
     result->ticks = timer_stop();
-    result->key_comps = dist_comps + heap_info->key_comps(front);
+    result->ops = *heap_info->counts(front);
+    result->ops.comps += dist_ops.comps;
 
     /* Free space used by arrays local to this function. */
     free(f);
     free(s);
+    free(ins_v);
+    free(ins_k);
+    free(dec_v);
+    free(dec_k);
+    free(pos);
     heap_free(front);
 
     return result;
@@ -158,6 +208,291 @@ da_result_t *heap_dijkstra(const dgraph_t *g, int v0,
 
 
 
+/* Structure type for the entries in the heap of lazy_dijkstra(). */
+typedef struct da_entry {
+    long key;
+    int vertex_no;
+} da_entry_t;
+
+
+
+/* lazy_dijkstra() - Lazy deletion implementation of Dijkstra's algorithm.
+ * Requires a pointer, g, to the directed graph used, and the starting vertex.
+ * Returns a da_result_t structure containing the resulting shortest path
+ * distances, and timing information.  Vertices not reachable from v0 have
+ * distance LONG_MAX.
+ *
+ * Instead of using decrease-key, whenever the distance to a vertex is lowered
+ * a new (key, vertex) entry is inserted into the heap.  Entries whose key is
+ * greater than the current distance of their vertex are stale, and are skipped
+ * when removed from the heap.  The heap is a DA_LAZY_ARITY-ary heap stored in
+ * a flat array, with entry a[i] having children a[DA_LAZY_ARITY*i + 1] to
+ * a[DA_LAZY_ARITY*i + DA_LAZY_ARITY].  The array grows when full.  Operation
+ * counts for the heap are recorded as for the other heaps.
+ */
+da_result_t *lazy_dijkstra(const dgraph_t *g, int v0)
+{
+    int v, w, n, i, c, c_end, size, max_size, depth;
+    long k, dist, *d;
+    da_entry_t *a, e;
+
+    dgraph_vertex_t *vertices;
+    dgraph_edge_t *edge_ptr;
+
+    da_result_t *result;
+    opcount_t ops;
+
+
+    /* Start of Dijkstra's algorithm. */
+    OP_RESET(ops);
+    timer_start();
+    vertices = g->vertices;
+    result = malloc(sizeof(da_result_t));
+    n = result->n = g->n;
+    d = result->d = malloc(n * sizeof(long));
+    for(v = 0; v < n; v++) d[v] = LONG_MAX;
+    result->scans = 0;
+
+    max_size = n;
+    a = malloc(max_size * sizeof(da_entry_t));
+
+    /* The heap starts with the starting vertex at distance zero. */
+    d[v0] = 0;
+    a[0].key = 0;
+    a[0].vertex_no = v0;
+    size = 1;
+
+    while(size > 0) {
+
+        /* Remove the entry with minimum key from the heap, by sifting the
+         * last entry down from the root.
+         */
+        e = a[0];
+        size--;
+        if(size > 0) {
+            k = a[size].key;
+            i = 0;
+            depth = 0;
+            while((c = DA_LAZY_ARITY*i + 1) < size) {
+                /* Find the child with the smallest key. */
+                c_end = c + DA_LAZY_ARITY;
+                if(c_end > size) c_end = size;
+                for(w = c + 1; w < c_end; w++) {
+                    OP_COMP(ops);
+                    if(a[w].key < a[c].key) c = w;
+                }
+                OP_COMP(ops);
+                if(k <= a[c].key) break;
+                a[i] = a[c];
+                OP_LINK(ops);
+                i = c;
+                depth++;
+            }
+            a[i] = a[size];
+            OP_DEPTH(ops, depth);
+        }
+
+        /* Skip stale entries. */
+        v = e.vertex_no;
+        OP_COMP(ops);
+        if(e.key > d[v]) continue;
+        result->scans++;
+
+        /* Update distances to vertices, w, in the out set of v.
+         */
+        edge_ptr = vertices[v].first_edge;
+        while(edge_ptr) {
+            w = edge_ptr->vertex_no;
+            dist = e.key + edge_ptr->dist;
+            OP_COMP(ops);
+            if(dist < d[w]) {
+                d[w] = dist;
+
+                /* Insert a new entry for w, by sifting it up from the bottom
+                 * of the heap.
+                 */
+                if(size == max_size) {
+                    max_size *= 2;
+                    a = realloc(a, max_size * sizeof(da_entry_t));
+                    OP_ALLOC(ops);
+                }
+                i = size++;
+                depth = 0;
+                while(i > 0) {
+                    c = (i - 1) / DA_LAZY_ARITY;
+                    OP_COMP(ops);
+                    if(a[c].key <= dist) break;
+                    a[i] = a[c];
+                    OP_LINK(ops);
+                    i = c;
+                    depth++;
+                }
+                a[i].key = dist;
+                a[i].vertex_no = w;
+                OP_DEPTH(ops, depth);
+            }
+
+	    edge_ptr = edge_ptr->next;
+        } /* while */
+    } /* while */
+
+    /* End of Dijkstra's algorithm. */
+
+    /* Record timing information. */
+    result->ticks = timer_stop();
+    result->ops = ops;
+
+    free(a);
+
+    return result;
+}
+
+
+
+/* Structure type for the state shared by the threads of par_dijkstra().
+ *     g - the graph.
+ *     front - the frontier set, which all threads remove vertices from.
+ *     d - the distances, which are only lowered by atomic operations.
+ *     pending - the number of vertices in the frontier set plus the number
+ *               being scanned.  When it is zero no more work can appear.
+ *     scans, comps - totals of the counts kept by each thread.
+ */
+typedef struct da_par {
+    const dgraph_t *g;
+    mqheap_t *front;
+    volatile long *d;
+    volatile long pending;
+    long scans, comps;
+} da_par_t;
+
+void *da_par_thread(void *arg);
+
+
+
+/* par_dijkstra() - Multithreaded label-correcting version of Dijkstra's
+ * algorithm.  Requires a pointer, g, to the directed graph used, the starting
+ * vertex, and the number of threads to use.  Returns a da_result_t structure
+ * containing the resulting shortest path distances, and timing information.
+ * Vertices not reachable from v0 have distance LONG_MAX.
+ *
+ * The threads share a single frontier set, which is a MultiQueue (mqheap.h).
+ * Since the MultiQueue does not always remove the vertex with the minimum
+ * distance, a vertex may be scanned before its distance is final.  Its
+ * distance is then lowered again later, and it is put back into the frontier
+ * set to be rescanned.  result->scans counts the total number of scans.
+ * The time recorded is the CPU time of all threads together.
+ */
+da_result_t *par_dijkstra(const dgraph_t *g, int v0, int n_threads)
+{
+    int v, n, t;
+    long *d;
+    pthread_t *threads;
+    da_par_t par;
+    da_result_t *result;
+
+    timer_start();
+    result = malloc(sizeof(da_result_t));
+    n = result->n = g->n;
+    d = result->d = malloc(n * sizeof(long));
+    for(v = 0; v < n; v++) d[v] = LONG_MAX;
+
+    par.g = g;
+    par.front = mq_alloc_threads(n, n_threads);
+    par.d = d;
+    par.scans = par.comps = 0;
+
+    /* The start vertex begins in the frontier set with a distance of zero. */
+    d[v0] = 0;
+    mq_insert(par.front, v0, 0);
+    par.pending = 1;
+
+    threads = malloc(n_threads * sizeof(pthread_t));
+    for(t = 0; t < n_threads; t++) {
+        pthread_create(&threads[t], NULL, da_par_thread, &par);
+    }
+    for(t = 0; t < n_threads; t++) pthread_join(threads[t], NULL);
+
+    /* Record timing information. */
+    result->ticks = timer_stop();
+    result->ops = *mq_counts(par.front);
+    result->ops.comps += par.comps;
+    result->scans = par.scans;
+
+    free(threads);
+    mq_free(par.front);
+
+    return result;
+}
+
+
+
+/* da_par_thread() - the function run by each thread of par_dijkstra().  arg
+ * points to the shared da_par_t structure.  Repeatedly removes a vertex from
+ * the frontier set and lowers the distances of the vertices in its out set,
+ * until no vertices are left to scan.
+ */
+void *da_par_thread(void *arg)
+{
+    da_par_t *par;
+    dgraph_vertex_t *vertices;
+    dgraph_edge_t *edge_ptr;
+    volatile long *d;
+    long dist, old, scans, comps;
+    int v, w;
+
+    par = arg;
+    vertices = par->g->vertices;
+    d = par->d;
+    scans = comps = 0;
+
+    for(;;) {
+        v = mq_delete_min(par->front);
+        if(v < 0) {
+            /* The frontier set is empty, but vertices being scanned by other
+             * threads may still add to it.
+             */
+            if(par->pending == 0) break;
+            sched_yield();
+            continue;
+        }
+        scans++;
+
+        /* Lower the distances to vertices, w, in the out set of v.  When the
+         * distance to w is lowered, w is put in the frontier set if it is not
+         * already there.  pending is raised first, so that it never drops to
+         * zero while w could still be added.
+         */
+        edge_ptr = vertices[v].first_edge;
+        while(edge_ptr) {
+            w = edge_ptr->vertex_no;
+            dist = d[v] + edge_ptr->dist;
+            for(;;) {
+                old = d[w];
+                comps++;
+                if(dist >= old) break;
+                if(__sync_bool_compare_and_swap(&d[w], old, dist)) {
+                    __sync_fetch_and_add(&par->pending, 1);
+                    if(!mq_update(par->front, w, dist)) {
+                        __sync_fetch_and_add(&par->pending, -1);
+                    }
+                    break;
+                }
+            }
+            edge_ptr = edge_ptr->next;
+        }
+
+        /* v has been scanned. */
+        __sync_fetch_and_add(&par->pending, -1);
+    }
+
+    __sync_fetch_and_add(&par->scans, scans);
+    __sync_fetch_and_add(&par->comps, comps);
+
+    return NULL;
+}
+
+
+
 /* da_result_free() - frees up space used by a da_result_t structure. */
 void da_result_free(da_result_t *r)
 {
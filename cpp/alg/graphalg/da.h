@@ -14,14 +14,23 @@
  */
 #define DA_HEAP_DUMP 0
 
+/* The number of children of each node in the heap of lazy_dijkstra(). */
+#define DA_LAZY_ARITY 4
 
 
-/* Dijkstra's algorithm results structure. */
+
+/* Dijkstra's algorithm results structure.  ops holds the operation counts of
+ * the heap used, with the distance comparisons made by the algorithm itself
+ * added to ops.comps.  scans is the number of times the out set of a vertex
+ * was scanned, which is the number of reachable vertices for heap_dijkstra(),
+ * but may be more for par_dijkstra().
+ */
 typedef struct da_result {
     int n;
     long *d;
     clockval_t ticks;
-    long key_comps;
+    opcount_t ops;
+    long scans;
 } da_result_t;
 
 
@@ -31,6 +40,10 @@ typedef struct da_result {
 da_result_t *heap_dijkstra(const dgraph_t *g, int v0,
 			   const heap_info_t *heap_info);
 
+da_result_t *lazy_dijkstra(const dgraph_t *g, int v0);
+
+da_result_t *par_dijkstra(const dgraph_t *g, int v0, int n_threads);
+
 void da_result_free(da_result_t *r);
 
 #endif /* DA_H */
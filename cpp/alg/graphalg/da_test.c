@@ -5,25 +5,41 @@
 
 /* #include all heaps to be tested using dijkstra's algorithm. */
 #include "../heaps/bheap.h"
+#include "../heaps/dheap.h"
 #include "../heaps/fheap.h"
+#include "../heaps/pairheap.h"
 #include "../heaps/ttheap.h"
 #include "../heaps/triheap.h"
 #include "../heaps/triheap_ext.h"
+#include "../heaps/rheap.h"
+#include "../heaps/dialheap.h"
+#include "../heaps/mqheap.h"
+#include "../heaps/seqheap.h"
+#include "../heaps/dictheap.h"
 
 
 /* This program generates key comparisons data and/or CPU time data, by
- * selecting on of the following with a 1.
+ * selecting on of the following with a 1.  When both are selected, each line
+ * of results gives the CPU times followed by the key comparisons.
  */
-#define KEY_COMPS_DATA 0
+#define KEY_COMPS_DATA 1
 #define CPU_TIME_DATA 1
 
+/* Use 1 to print a table of the operation counts of each heap, for the
+ * largest graph size, after the results.  Operations are only counted when
+ * OP_COUNTS is 1 (see opcount.h).
+ */
+#define OP_COUNTS_DATA OP_COUNTS
+
 /* Step size between values of n used. */
 #define STEP 200
 
 /* Structure type for summing the results for each heap. */
 typedef struct timestruct {
     char *desc;  /* Heap description (i.e. name) */
-    const heap_info_t *fns;  /* Heap functions (passed to algorithm). */
+    const heap_info_t *fns;  /* Heap functions (passed to algorithm), or NULL
+                              * for lazy_dijkstra(), which has its own heap.
+                              */
     da_result_t sum;  /* For summing results of algorithm. */
 } timestruct_t;
 
@@ -31,10 +47,21 @@ typedef struct timestruct {
  */
 timestruct_t heap_times[] = {
     { "Binary",&BHEAP_info },
+    { "d-ary",&DHEAP_info },
     { "Fibonacci",&FHEAP_info },
+    { "Pairing",&PAIRHEAP_info },
     { "2-3",&TTHEAP_info },
     { "Trinomial",&TRIHEAP_info },
     { "Trinomial (ext)",&TRIHEAP_EXT_info },
+    { "Radix",&RHEAP_info },
+    { "Dial",&DIALHEAP_info },
+    { "MultiQueue",&MQHEAP_info },
+    { "Sequence",&SEQHEAP_info },
+    { "AVL tree",&DICTHEAP_AVL_info },
+    { "Red-black tree",&DICTHEAP_RBTREE_info },
+    { "2-3 tree",&DICTHEAP_TREE23_info },
+    { "Skip list",&DICTHEAP_SKIP_LIST_info },
+    { "Lazy 4-ary",NULL },
 };
 
 int main(int argc, char *argv[])
@@ -43,6 +70,7 @@ int main(int argc, char *argv[])
     double edge_f;
     da_result_t *r;
     dgraph_t *graph;
+    opcount_t *ops;
 
     /* Process command line arguments (if any), otherwise get input from the
      * user.  Arguments supplied correspond to:
@@ -88,7 +116,12 @@ int main(int argc, char *argv[])
 
     /* Print collumn labels */
     printf("\nResults:\nn");
+#if CPU_TIME_DATA
     for(j = 0; j < n_heaps; j++) printf(",\t%s", heap_times[j].desc);
+#endif
+#if KEY_COMPS_DATA
+    for(j = 0; j < n_heaps; j++) printf(",\t%s (comps)", heap_times[j].desc);
+#endif
     putchar('\n');
     
     /* Test over varying graph sizes. */
@@ -96,7 +129,7 @@ int main(int argc, char *argv[])
 
 	/* Initialize the sums used in average calculations to zero. */
         for(j = 0; j < n_heaps; j++) {
-	    heap_times[j].sum.key_comps = 0;
+	    OP_RESET(heap_times[j].sum.ops);
 	    heap_times[j].sum.ticks = 0;
 	}
 
@@ -112,8 +145,20 @@ int main(int argc, char *argv[])
 	     * algorithm in order to use the functions provided by that heap.
 	     */
 	    for(j = 0; j < n_heaps; j++) {
-	        r = heap_dijkstra(graph, StartVertex, heap_times[j].fns);
-                heap_times[j].sum.key_comps += r->key_comps;
+	        if(heap_times[j].fns) {
+	            r = heap_dijkstra(graph, StartVertex, heap_times[j].fns);
+	        }
+	        else {
+	            r = lazy_dijkstra(graph, StartVertex);
+	        }
+                ops = &heap_times[j].sum.ops;
+                ops->comps += r->ops.comps;
+                ops->allocs += r->ops.allocs;
+                ops->links += r->ops.links;
+                ops->restructs += r->ops.restructs;
+                if(r->ops.max_depth > ops->max_depth) {
+                    ops->max_depth = r->ops.max_depth;
+                }
                 heap_times[j].sum.ticks += r->ticks;
 	        da_result_free(r);
 	    }
@@ -121,21 +166,33 @@ int main(int argc, char *argv[])
 	    /* Free the random graph. */
             dgraph_free(graph);
 	}
-#if KEY_COMPS_DATA
-	/* Print line of key comparison results for current value of k. */
+	/* Print line of results for current value of k. */
 	printf("%d", k);
-	for(j = 0; j < n_heaps; j++)
-	    printf("\t%.2f", (double)heap_times[j].sum.key_comps/n_samples);
-	putchar('\n');
-#endif
 #if CPU_TIME_DATA
-	/* Print line of key comparison results for current value of k. */
-	printf("%d", k);
 	for(j = 0; j < n_heaps; j++) printf("\t%.2f",
 	    (((double)heap_times[j].sum.ticks/n_samples)/CLOCK_DIV)*1000);
-	putchar('\n');
 #endif
+#if KEY_COMPS_DATA
+	for(j = 0; j < n_heaps; j++)
+	    printf("\t%.2f", (double)heap_times[j].sum.ops.comps/n_samples);
+#endif
+	putchar('\n');
     }
 
+#if OP_COUNTS_DATA
+    /* The sums still hold the operation counts for the largest graph size.
+     * Counts are averaged over the samples, except for the maximum depth.
+     */
+    printf("\nOperation counts for n = %d:\n", k - STEP);
+    printf("Heap,\tcomps,\tallocs,\tlinks,\trestructs,\tmax depth\n");
+    for(j = 0; j < n_heaps; j++) {
+        ops = &heap_times[j].sum.ops;
+        printf("%s\t%.2f\t%.2f\t%.2f\t%.2f\t%d\n", heap_times[j].desc,
+               (double)ops->comps/n_samples, (double)ops->allocs/n_samples,
+               (double)ops->links/n_samples, (double)ops->restructs/n_samples,
+               ops->max_depth);
+    }
+#endif
+
     return 0;
 }
@@ -15,11 +15,17 @@
 /* mst_prim() - Minimum spanning tree algorithm.  Computes the minimum spanning
  * tree of the directed graph pointed to by g.  Returns the result as a
  * prim_result_t structure (see prim.h).
+ *
+ * The inserts and decrease-keys resulting from scanning the out set of a
+ * vertex are collected and passed to the heap in two batches.
  */
 mst_result_t *mst_prim(const dgraph_t *g, int v0, const heap_info_t *heap_info)
 {
     int v, w;
     int *s;
+    int *ins_v, *dec_v, *pos;
+    long *ins_k, *dec_k;
+    int n_ins, n_dec;
     long dist, *d;
     int i, n;
     
@@ -28,8 +34,6 @@ mst_result_t *mst_prim(const dgraph_t *g, int v0, const heap_info_t *heap_info)
     
     void *front;
     int (*heap_delete_min)(void *);
-    void (*heap_insert)(void *, int, long);
-    void (*heap_decrease_key)(void *, int, long);
     int (*heap_n)(void *);
     void *(*heap_alloc)(int);
     void (*heap_free)(void *);
@@ -40,8 +44,6 @@ mst_result_t *mst_prim(const dgraph_t *g, int v0, const heap_info_t *heap_info)
 
     /* Set up pointers to heap interface functions. */
     heap_delete_min = heap_info->delete_min;
-    heap_insert = heap_info->insert;
-    heap_decrease_key = heap_info->decrease_key;
     heap_n = heap_info->n;
     heap_alloc = heap_info->alloc;
     heap_free = heap_info->free;
@@ -57,6 +59,15 @@ mst_result_t *mst_prim(const dgraph_t *g, int v0, const heap_info_t *heap_info)
     
     /* Allocate arrays used by the algorithm. */
     s = calloc(n, sizeof(int));
+
+    /* Batches of inserts and decrease-keys.  pos[w] is the index of w in
+     * whichever batch it is in, which is valid when that batch entry is w.
+     */
+    ins_v = malloc(n * sizeof(int));
+    ins_k = malloc(n * sizeof(long));
+    dec_v = malloc(n * sizeof(int));
+    dec_k = malloc(n * sizeof(long));
+    pos = calloc(n, sizeof(int));
     
     /* Create the heap. */
     front = heap_alloc(n);
@@ -71,14 +82,24 @@ mst_result_t *mst_prim(const dgraph_t *g, int v0, const heap_info_t *heap_info)
     /* Put out set of the starting vertex into the frontier and update the
      * distances to vertices in the out set.  k is the index for the out set.
      */
+    n_ins = 0;
     edge_ptr = vertices[v0].first_edge;
     while(edge_ptr) {
         w = edge_ptr->vertex_no;
-        dist = d[w] = edge_ptr->dist;
-        heap_insert(front, w, dist);
-	reached[w] = v0;
+        dist = edge_ptr->dist;
+        if(reached[w] < 0) {
+            d[w] = dist;
+            pos[w] = n_ins;
+            ins_v[n_ins] = w;
+            ins_k[n_ins++] = dist;
+            reached[w] = v0;
+        }
+        else if(dist < d[w]) {
+            d[w] = ins_k[pos[w]] = dist;
+        }
 	edge_ptr = edge_ptr->next;
     }
+    heap_insert_batch(heap_info, front, ins_v, ins_k, n_ins);
 
     /* At this point we are assuming that all vertices are reachable from the
      * starting vertex and N > 1 so that j > 0.
@@ -94,6 +115,7 @@ mst_result_t *mst_prim(const dgraph_t *g, int v0, const heap_info_t *heap_info)
 
         /* Update distances to vertices, w, in the out set of v.
          */
+        n_ins = n_dec = 0;
         edge_ptr = vertices[v].first_edge;
 	while(edge_ptr) {
 	    w = edge_ptr->vertex_no;
@@ -110,24 +132,49 @@ mst_result_t *mst_prim(const dgraph_t *g, int v0, const heap_info_t *heap_info)
                 if(reached[w] >= 0) {
                     if(dist < d[w]) {
                         d[w] = dist;
-                        heap_decrease_key(front, w, dist);
 			reached[w] = v;
+
+                        /* If w is already in one of the batches, only its key
+                         * in the batch is updated.
+                         */
+                        i = pos[w];
+                        if(i < n_ins && ins_v[i] == w) {
+                            ins_k[i] = dist;
+                        }
+                        else if(i < n_dec && dec_v[i] == w) {
+                            dec_k[i] = dist;
+                        }
+                        else {
+                            pos[w] = n_dec;
+                            dec_v[n_dec] = w;
+                            dec_k[n_dec++] = dist;
+                        }
                     }
                 }
                 else {
                     d[w] = dist;
-                    heap_insert(front, w, dist); 
+                    pos[w] = n_ins;
+                    ins_v[n_ins] = w;
+                    ins_k[n_ins++] = dist;
                     reached[w] = v;
                 }
             } /* if */
 
 	    edge_ptr = edge_ptr->next;
         } /* while */
+
+        heap_decrease_key_batch(heap_info, front, dec_v, dec_k, n_dec);
+        heap_insert_batch(heap_info, front, ins_v, ins_k, n_ins);
     } /* while */
 
 
     /* Free space used by arrays local to this function. */
     free(s);
+    free(ins_v);
+    free(ins_k);
+    free(dec_v);
+    free(dec_k);
+    free(pos);
     heap_free(front);
 
     return result;
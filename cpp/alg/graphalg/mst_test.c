@@ -11,6 +11,7 @@
 /* #include all heaps to be tested using Prim's algorithm. */
 #include "../heaps/bheap.h"
 #include "../heaps/fheap.h"
+#include "../heaps/pairheap.h"
 #include "../heaps/ttheap.h"
 #include "../heaps/triheap.h"
 #include "../heaps/triheap_ext.h"
@@ -30,6 +31,7 @@ typedef struct heapdesc {
 heapdesc_t heaps[] = {
     { "Binary",&BHEAP_info },
     { "Fibonacci",&FHEAP_info },
+    { "Pairing",&PAIRHEAP_info },
     { "2-3",&TTHEAP_info },
     { "Trinomial",&TRIHEAP_info },
     { "Trinomial (ext)",&TRIHEAP_EXT_info },
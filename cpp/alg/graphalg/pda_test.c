@@ -0,0 +1,105 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include "da.h"
+#include "../graphs/dgraph.h"
+#include "../heaps/bheap.h"
+
+
+/* This program measures how the multithreaded par_dijkstra() scales from 1
+ * thread up to a maximum number of threads, on random graphs from
+ * dgraph_rnd_sparse().  Sequential heap_dijkstra() with a binary heap is run
+ * on the same graphs, both to give a baseline time and to check the distances
+ * computed by par_dijkstra().
+ *
+ * Times are elapsed (wall clock) times, since the CPU times recorded in
+ * da_result_t sum the time used by all threads.  The scans column gives the
+ * average number of times the out set of a vertex was scanned, which is above
+ * 1 when the relaxed frontier set causes vertices to be rescanned.
+ */
+
+/* Return the current wall clock time in milliseconds. */
+double wall_msec(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
+}
+
+int main(int argc, char *argv[])
+{
+    int i, t, v, n, n_samples, max_threads, errors;
+    double edge_f, start, seq_time, *par_time;
+    long *scans;
+    da_result_t *r, *r0;
+    dgraph_t *graph;
+
+    /* Process command line arguments (if any), otherwise get input from the
+     * user.  Arguments supplied correspond to:
+     *     - number of samples used for average calculation.
+     *     - graph size.
+     *     - edge factor (the average size of the out set).
+     *     - maximum number of threads.
+     */
+    if(argc == 5) {
+        n_samples = atoi(argv[1]);
+        n = atoi(argv[2]);
+        edge_f = atof(argv[3]);
+        max_threads = atoi(argv[4]);
+    }
+    else {
+	printf("Enter the number samples to use: ");
+	scanf("%d", &n_samples);
+	printf("Enter the value of n to use: ");
+	scanf("%d", &n);
+	printf("Enter the edge factor (i.e. average size of OUT set): ");
+	scanf("%lf", &edge_f);
+	printf("Enter the maximum number of threads: ");
+	scanf("%d", &max_threads);
+	putchar('\n');
+    }
+
+    par_time = calloc(max_threads + 1, sizeof(double));
+    scans = calloc(max_threads + 1, sizeof(long));
+    seq_time = 0;
+    errors = 0;
+
+    for(i = 0; i < n_samples; i++) {
+        graph = dgraph_rnd_sparse(n, edge_f);
+
+        start = wall_msec();
+        r0 = heap_dijkstra(graph, StartVertex, &BHEAP_info);
+        seq_time += wall_msec() - start;
+
+        for(t = 1; t <= max_threads; t++) {
+            start = wall_msec();
+            r = par_dijkstra(graph, StartVertex, t);
+            par_time[t] += wall_msec() - start;
+            scans[t] += r->scans;
+
+            for(v = 0; v < n; v++) if(r->d[v] != r0->d[v]) errors++;
+            da_result_free(r);
+        }
+
+        da_result_free(r0);
+        dgraph_free(graph);
+    }
+
+    printf("Parallel Dijkstra's Algorithm (MultiQueue frontier)\n");
+    printf("Graph Size = %d, Edge factor = %.3f, Number of samples = %d\n",
+           n, edge_f, n_samples);
+    printf("\nSequential (binary heap): %.2f msec\n", seq_time / n_samples);
+    printf("\nthreads,\tmsec,\tspeedup,\tvs seq,\tscans\n");
+    for(t = 1; t <= max_threads; t++) {
+        printf("%d\t%.2f\t%.2f\t%.2f\t%.3f\n", t, par_time[t] / n_samples,
+               par_time[1] / par_time[t], seq_time / par_time[t],
+               (double)scans[t] / n_samples / n);
+    }
+    if(errors) printf("\n%d distances differ from heap_dijkstra()\n", errors);
+
+    free(par_time);
+    free(scans);
+
+    return errors != 0;
+}
@@ -11,6 +11,8 @@
 /*** Prototypes for functions internal to the implementation. ***/
 
 void bh_siftup(bheap_t *h, int p, int q);
+void bh_heapify(bheap_t *h);
+int bh_log2(int n);
 
 
 
@@ -32,7 +34,7 @@ bheap_t *bh_alloc(int n)
     h->a = calloc(n+1, sizeof(bheap_item_t));
     h->p = calloc(n, sizeof(int));
     h->n = 0;
-    h->key_comps = 0;
+    OP_RESET(h->ops);
 
     return h;
 }
@@ -66,12 +68,14 @@ void bh_insert(bheap_t *h, int item, long key)
     /* i - insertion point
      * j - parent of i
      * y - parent's entry in the heap.
+     * d - the number of levels sifted.
      */
-    int i, j;
+    int i, j, d;
     bheap_item_t y;
 
     /* i initially indexes the new entry at the bottom of the heap. */
     i = ++(h->n);
+    d = 0;
 
     /* Stop if the insertion point reaches the top of the heap. */
     while(i >= 2) {
@@ -82,13 +86,16 @@ void bh_insert(bheap_t *h, int item, long key)
         /* We have the correct insertion point when the items key is >= parent
          * Otherwise we move the parent down and insertion point up.
          */
-	h->key_comps++;
+	OP_COMP(h->ops);
         if(key >= y.key) break;
 
         h->a[i] = y;
         h->p[y.item] = i;
+        OP_LINK(h->ops);
         i = j;
+        d++;
     }
+    OP_DEPTH(h->ops, d);
 
     /* Insert the new item at the insertion point found. */
     h->a[i].item = item;
@@ -118,7 +125,7 @@ void bh_delete(bheap_t *h, int item)
          * item and sift-up or sift-down to relocate it in the correct place in
          * the heap.
          */
-	h->key_comps++;
+	OP_COMP(h->ops);
         if(h->a[p].key <= h->a[n + 1].key) {
             h->a[p] = h->a[n + 1];
             h->p[h->a[p].item] = p;
@@ -154,6 +161,53 @@ void bh_decrease_key(bheap_t *h, int item, long new_key)
 
 
 
+/* bh_insert_batch() inserts items[i] with key keys[i], i = 0, 1, ..., n-1, into
+ * the binary heap pointed to by h.  When this at least doubles the size of the
+ * heap, the heap is rebuilt bottom-up in linear time.
+ */
+void bh_insert_batch(bheap_t *h, const int *items, const long *keys, int n)
+{
+    int i, j;
+
+    if(n < h->n) {
+        for(i = 0; i < n; i++) bh_insert(h, items[i], keys[i]);
+        return;
+    }
+
+    /* Append the new entries to the end of the heap and rebuild it. */
+    for(i = 0; i < n; i++) {
+        j = ++(h->n);
+        h->a[j].item = items[i];
+        h->a[j].key = keys[i];
+        h->p[items[i]] = j;
+    }
+    bh_heapify(h);
+}
+
+
+/* bh_decrease_key_batch() decreases the key of items[i] to keys[i], i = 0, 1,
+ * ..., n-1, in the binary heap pointed to by h.  When sifting each item would
+ * cost more than rebuilding the heap, the heap is rebuilt bottom-up instead.
+ */
+void bh_decrease_key_batch(bheap_t *h, const int *items, const long *keys,
+                           int n)
+{
+    int i;
+
+    /* Each sift costs up to log2(h->n) comparisons, whereas rebuilding the heap
+     * costs less than 2 * h->n comparisons.
+     */
+    if((double)n * bh_log2(h->n) <= 2.0 * h->n) {
+        for(i = 0; i < n; i++) bh_decrease_key(h, items[i], keys[i]);
+        return;
+    }
+
+    for(i = 0; i < n; i++) h->a[h->p[items[i]]].key = keys[i];
+    bh_heapify(h);
+}
+
+
+
 /*** Definitions for internal functions ***/
 
 /* siftup() considers the sub-tree rooted at p that ends at q and moves
@@ -166,8 +220,9 @@ void bh_siftup(bheap_t *h, int p, int q)
      * j - the current insertion point for the root.
      * k - the child of the insertion point.
      * z - heap entry of the child of the insertion point.
+     * d - the number of levels sifted.
      */
-    int j, k;
+    int j, k, d;
     bheap_item_t y, z;
 
     /* Get the value of the root and initialise the insertion point and child.
@@ -175,6 +230,7 @@ void bh_siftup(bheap_t *h, int p, int q)
     y = h->a[p];
     j = p;
     k = 2 * p;
+    d = 0;
 
     /* sift-up only if there is a child of the insertion point. */
     while(k <= q) {
@@ -182,7 +238,7 @@ void bh_siftup(bheap_t *h, int p, int q)
         /* Choose the minimum child unless there is only one. */
         z = h->a[k];
         if(k < q) {
-	    h->key_comps++;
+	    OP_COMP(h->ops);
             if(z.key > h->a[k + 1].key) z = h->a[++k];
         }
 
@@ -192,9 +248,12 @@ void bh_siftup(bheap_t *h, int p, int q)
         if(y.key <= z.key) break;
         h->a[j] = z;
         h->p[z.item] = j;
+        OP_LINK(h->ops);
         j = k;
         k = 2 * j;
+        d++;
     }
+    OP_DEPTH(h->ops, d);
 
     /* Insert the root in the correct place in the heap. */
     h->a[j] = y;
@@ -202,6 +261,36 @@ void bh_siftup(bheap_t *h, int p, int q)
 }
 
 
+/* bh_heapify() restores the heap ordering of all entries in the binary heap
+ * pointed to by h, by sifting down the root of each sub-tree from the bottom
+ * of the heap upwards.
+ */
+void bh_heapify(bheap_t *h)
+{
+    int i;
+
+    OP_RESTRUCT(h->ops);
+    for(i = h->n / 2; i >= 1; i--) bh_siftup(h, i, h->n);
+}
+
+
+/* bh_log2() returns the floor of the base 2 logarithm of n, for n > 0, or 0
+ * otherwise.
+ */
+int bh_log2(int n)
+{
+    int r;
+
+    r = 0;
+    while(n > 1) {
+        n >>= 1;
+        r++;
+    }
+
+    return r;
+}
+
+
 /*** Implement the univeral heap structure type ***/
 
 /* Binary heap wrapper functions. */
@@ -226,7 +315,11 @@ int _bh_n(void *h) {
 }
 
 long _bh_key_comps(void *h) {
-    return ((bheap_t *)h)->key_comps;
+    return ((bheap_t *)h)->ops.comps;
+}
+
+const opcount_t *_bh_counts(void *h) {
+    return &((bheap_t *)h)->ops;
 }
 
 void *_bh_alloc(int n) {
@@ -237,6 +330,14 @@ void _bh_free(void *h) {
     bh_free((bheap_t *)h);
 }
 
+void _bh_insert_batch(void *h, const int *v, const long *k, int n) {
+    bh_insert_batch((bheap_t *)h, v, k, n);
+}
+
+void _bh_decrease_key_batch(void *h, const int *v, const long *k, int n) {
+    bh_decrease_key_batch((bheap_t *)h, v, k, n);
+}
+
 void _bh_dump(void *h) {
 #if BHEAP_DUMP
     bh_dump((bheap_t *)h);
@@ -252,5 +353,9 @@ const heap_info_t BHEAP_info = {
     _bh_key_comps,
     _bh_alloc,
     _bh_free,
-    _bh_dump
+    _bh_dump,
+    NULL,
+    _bh_insert_batch,
+    _bh_decrease_key_batch,
+    _bh_counts
 };
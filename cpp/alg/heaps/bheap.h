@@ -23,12 +23,14 @@ typedef struct {
  * a[] - stores (distance, vertex) pairs of the binary heap.
  * p[] - stores the positions of vertices in the binary heap a[].
  * n - is the size of the binary heap.
+ * ops - counts the operations performed on the heap, for experimental
+ *       purposes.  See opcount.h.
  */
 typedef struct {
     bheap_item_t *a;
     int *p;
     int n;
-    long key_comps;
+    opcount_t ops;
 } bheap_t;
 
 
@@ -65,6 +67,19 @@ void bh_delete(bheap_t *h, int item);
  */
 void bh_decrease_key(bheap_t *h, int item, long new_key);
 
+/* bh_insert_batch() inserts items[i] with key keys[i], i = 0, 1, ..., n-1, into
+ * the binary heap pointed to by h.  When this at least doubles the size of the
+ * heap, the heap is rebuilt bottom-up in linear time.
+ */
+void bh_insert_batch(bheap_t *h, const int *items, const long *keys, int n);
+
+/* bh_decrease_key_batch() decreases the key of items[i] to keys[i], i = 0, 1,
+ * ..., n-1, in the binary heap pointed to by h.  When sifting each item would
+ * cost more than rebuilding the heap, the heap is rebuilt bottom-up instead.
+ */
+void bh_decrease_key_batch(bheap_t *h, const int *items, const long *keys,
+                           int n);
+
 
 /*** Alternative interface via the universal heap structure type. ***/
 extern const heap_info_t BHEAP_info;
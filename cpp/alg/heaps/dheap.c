@@ -0,0 +1,524 @@
+/*** d-ary Heap Implementation ***/
+/* This implementation stores the d-ary heap in separate, cache line aligned,
+ * key and item arrays.
+ */
+#include <stdlib.h>
+#include <limits.h>
+#include "dheap.h"
+#if DHEAP_DUMP
+#include <stdio.h>
+#endif
+
+/* SIMD child selection is only used for 4-ary and 8-ary heaps with 64-bit
+ * keys on x86-64.  The AVX2 and SSE4.2 versions are compiled for their
+ * instruction sets whatever the compiler target, and one is chosen when a
+ * heap is allocated, from the instruction sets the processor supports.
+ */
+#if DHEAP_SIMD && defined(__LP64__) && defined(__x86_64__) \
+    && defined(__GNUC__) && (DHEAP_ARITY == 4 || DHEAP_ARITY == 8)
+#include <immintrin.h>
+#define DHEAP_X86 1
+#else
+#define DHEAP_X86 0
+#endif
+
+/* The child selection used: 2 for AVX2, 1 for SSE4.2, or 0 for plain C. */
+static int dh_simd = 0;
+
+
+
+/*** Prototypes for functions internal to the implementation. ***/
+
+int dh_min_child(const long *group);
+#if DHEAP_X86
+int dh_min_child_avx2(const long *group) __attribute__((target("avx2")));
+int dh_min_child_sse4(const long *group) __attribute__((target("sse4.2")));
+#endif
+void dh_siftup(dheap_t *h, int i, int item, long key);
+void dh_siftdown(dheap_t *h, int i, int item, long key);
+void dh_heapify(dheap_t *h);
+int dh_log(int n);
+void *dh_aligned(void *block);
+
+
+
+/*** Definitions for visible functions. ***/
+
+/* dh_alloc() allocates space for a d-ary heap of size n and initialises it.
+ * Returns a pointer to the d-ary heap.
+ */
+dheap_t *dh_alloc(int n)
+{
+    dheap_t *h;
+    int i, n_slots;
+
+    /* Create the d-ary heap. */
+    h = malloc(sizeof(dheap_t));
+
+    /* Heap position i is stored in array slot i + d - 1, so that the children
+     * of position i, starting at slot d*(i+1), begin on an aligned boundary.
+     * The last group of children may extend d positions past the end of the
+     * heap, and these extra slots hold LONG_MAX.
+     */
+    n_slots = n + 2 * DHEAP_ARITY;
+    h->key_block = malloc(n_slots * sizeof(long) + DHEAP_CACHE_LINE);
+    h->item_block = malloc(n_slots * sizeof(int) + DHEAP_CACHE_LINE);
+    h->key = (long *)dh_aligned(h->key_block) + DHEAP_ARITY - 1;
+    h->item = (int *)dh_aligned(h->item_block) + DHEAP_ARITY - 1;
+    for(i = 0; i < n + DHEAP_ARITY; i++) {
+        h->key[i] = LONG_MAX;
+    }
+
+    h->p = calloc(n, sizeof(int));
+    h->n = 0;
+    OP_RESET(h->ops);
+
+#if DHEAP_X86
+    if(__builtin_cpu_supports("avx2")) dh_simd = 2;
+    else if(__builtin_cpu_supports("sse4.2")) dh_simd = 1;
+#endif
+
+    return h;
+}
+
+
+/* dh_free() frees the space taken up by the d-ary heap pointed to by h.
+ */
+void dh_free(dheap_t *h)
+{
+    free(h->key_block);
+    free(h->item_block);
+    free(h->p);
+    free(h);
+}
+
+
+/* dh_min() returns the item with the minimum key in the d-ary heap pointed to
+ * by h.
+ */
+int dh_min(dheap_t *h)
+{
+    /* The item at the top of the d-ary heap has the minimum key value. */
+    return h->item[0];
+}
+
+
+/* dh_insert() inserts an item and its key value into the d-ary heap pointed
+ * to by h.
+ */
+void dh_insert(dheap_t *h, int item, long key)
+{
+    /* The new entry starts at the bottom of the heap and sifts up. */
+    dh_siftup(h, h->n++, item, key);
+}
+
+
+/* dh_delete_min() deletes the item with the minimum key from the d-ary heap
+ * pointed to by h, and returns the item.
+ */
+int dh_delete_min(dheap_t *h)
+{
+    /* y, y_key - the last entry in the heap, which replaces the root. */
+    int n;
+    int min_item, y;
+    long y_key;
+    long *key;
+    int *item;
+
+    key = h->key;
+    item = h->item;
+
+    min_item = item[0];
+
+    /* Remove the last entry, restoring the LONG_MAX padding in its place. */
+    n = --(h->n);
+    y = item[n];
+    y_key = key[n];
+    key[n] = LONG_MAX;
+
+    if(n == 0) return min_item;
+
+    /* Sift the last entry down from the root. */
+    dh_siftdown(h, 0, y, y_key);
+
+    return min_item;
+}
+
+
+/* dh_decrease_key() decreases the value of 'item's key and then sifts 'item'
+ * towards the root until it is in the correct position in the d-ary heap.
+ */
+void dh_decrease_key(dheap_t *h, int item, long new_key)
+{
+    dh_siftup(h, h->p[item], item, new_key);
+}
+
+
+/* dh_insert_batch() inserts items[i] with key keys[i], i = 0, 1, ..., n-1, into
+ * the d-ary heap pointed to by h.  When this at least doubles the size of the
+ * heap, the heap is rebuilt bottom-up in linear time.
+ */
+void dh_insert_batch(dheap_t *h, const int *items, const long *keys, int n)
+{
+    int i, j;
+
+    if(n < h->n) {
+        for(i = 0; i < n; i++) dh_insert(h, items[i], keys[i]);
+        return;
+    }
+
+    /* Append the new entries to the end of the heap and rebuild it. */
+    for(i = 0; i < n; i++) {
+        j = h->n++;
+        h->key[j] = keys[i];
+        h->item[j] = items[i];
+        h->p[items[i]] = j;
+    }
+    dh_heapify(h);
+}
+
+
+/* dh_decrease_key_batch() decreases the key of items[i] to keys[i], i = 0, 1,
+ * ..., n-1, in the d-ary heap pointed to by h.  When sifting each item would
+ * cost more than rebuilding the heap, the heap is rebuilt bottom-up instead.
+ */
+void dh_decrease_key_batch(dheap_t *h, const int *items, const long *keys,
+                           int n)
+{
+    int i;
+
+    /* Each sift costs up to log_d(h->n) comparisons, whereas rebuilding the
+     * heap costs less than d * h->n / (d - 1) comparisons.
+     */
+    if((double)n * dh_log(h->n) * (DHEAP_ARITY - 1)
+       <= (double)DHEAP_ARITY * h->n) {
+        for(i = 0; i < n; i++) dh_decrease_key(h, items[i], keys[i]);
+        return;
+    }
+
+    for(i = 0; i < n; i++) h->key[h->p[items[i]]] = keys[i];
+    dh_heapify(h);
+}
+
+
+
+/*** Definitions for internal functions ***/
+
+/* dh_siftdown() places item y with key y_key at position i in the heap pointed
+ * to by h, moving minimum children up until the correct insertion point is
+ * found.
+ */
+void dh_siftdown(dheap_t *h, int i, int y, long y_key)
+{
+    /* c - index of the first child of i, then of the minimum child of i.
+     * d - the number of levels sifted.
+     */
+    int c, n, n_children, d;
+    long *key;
+    int *item, *p;
+
+    key = h->key;
+    item = h->item;
+    p = h->p;
+    n = h->n;
+    d = 0;
+
+    for(;;) {
+        c = DHEAP_ARITY * i + 1;
+        if(c >= n) break;
+
+        /* Choose the minimum child.  Padding slots past the end of the heap
+         * hold LONG_MAX and are never chosen over a real entry with a smaller
+         * key.  For comparison counting we only count the real children.
+         */
+        n_children = n - c < DHEAP_ARITY ? n - c : DHEAP_ARITY;
+        OP_COMPS(h->ops, n_children);
+        c += dh_min_child(&key[c]);
+
+        /* We stop if the insertion point for y is in the correct
+         * place.  Otherwise the child goes up and the insertion point moves
+         * down.
+         */
+        if(y_key <= key[c]) break;
+        key[i] = key[c];
+        item[i] = item[c];
+        p[item[i]] = i;
+        OP_LINK(h->ops);
+        i = c;
+        d++;
+    }
+    OP_DEPTH(h->ops, d);
+
+    /* Insert the entry in the correct place in the heap. */
+    key[i] = y_key;
+    item[i] = y;
+    p[y] = i;
+}
+
+
+/* dh_heapify() restores the heap ordering of all entries in the d-ary heap
+ * pointed to by h, by sifting down the root of each sub-tree from the bottom
+ * of the heap upwards.
+ */
+void dh_heapify(dheap_t *h)
+{
+    int i;
+
+    if(h->n < 2) return;
+    OP_RESTRUCT(h->ops);
+    for(i = (h->n - 2) / DHEAP_ARITY; i >= 0; i--) {
+        dh_siftdown(h, i, h->item[i], h->key[i]);
+    }
+}
+
+
+/* dh_log() returns the floor of the base d logarithm of n, for n > 0, or 0
+ * otherwise.
+ */
+int dh_log(int n)
+{
+    int r;
+
+    r = 0;
+    while(n >= DHEAP_ARITY) {
+        n /= DHEAP_ARITY;
+        r++;
+    }
+
+    return r;
+}
+
+/* dh_siftup() places 'item' with key 'key' at position i in the heap pointed
+ * to by h, moving parents down until the correct insertion point is found.
+ */
+void dh_siftup(dheap_t *h, int i, int item, long key)
+{
+    /* j - parent of the insertion point i.
+     * d - the number of levels sifted.
+     */
+    int j, d;
+    long *keys;
+    int *items, *p;
+
+    keys = h->key;
+    items = h->item;
+    p = h->p;
+    d = 0;
+
+    /* Stop if the insertion point reaches the top of the heap. */
+    while(i > 0) {
+        j = (i - 1) / DHEAP_ARITY;
+
+        /* We have the correct insertion point when the items key is >= parent
+         * Otherwise we move the parent down and insertion point up.
+         */
+        OP_COMP(h->ops);
+        if(key >= keys[j]) break;
+
+        keys[i] = keys[j];
+        items[i] = items[j];
+        p[items[i]] = i;
+        OP_LINK(h->ops);
+        i = j;
+        d++;
+    }
+    OP_DEPTH(h->ops, d);
+
+    /* Insert the new item at the insertion point found. */
+    keys[i] = key;
+    items[i] = item;
+    p[item] = i;
+}
+
+
+/* dh_min_child() returns the index, between 0 and d-1, of the minimum key in
+ * the aligned group of d keys pointed to by group.
+ */
+int dh_min_child(const long *group)
+{
+    int i, min_i;
+    long min_key;
+
+#if DHEAP_X86
+    if(dh_simd == 2) return dh_min_child_avx2(group);
+    if(dh_simd == 1) return dh_min_child_sse4(group);
+#endif
+
+    min_i = 0;
+    min_key = group[0];
+    for(i = 1; i < DHEAP_ARITY; i++) {
+        if(group[i] < min_key) {
+            min_key = group[i];
+            min_i = i;
+        }
+    }
+
+    return min_i;
+}
+
+
+#if DHEAP_X86
+/* dh_min_child_avx2() and dh_min_child_sse4() are dh_min_child() using AVX2
+ * and SSE4.2 instructions.
+ */
+int dh_min_child_avx2(const long *group)
+{
+    __m256i a, m, s;
+    int mask;
+#if DHEAP_ARITY == 8
+    __m256i b;
+
+    /* Take the element-wise minimum of the two halves of the cache line. */
+    a = _mm256_load_si256((const __m256i *)group);
+    b = _mm256_load_si256((const __m256i *)(group + 4));
+    m = _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b));
+#else
+    a = _mm256_load_si256((const __m256i *)group);
+    m = a;
+#endif
+
+    /* Reduce the four lanes of m to their minimum, broadcast to all lanes. */
+    s = _mm256_permute4x64_epi64(m, 0x4e);
+    m = _mm256_blendv_epi8(m, s, _mm256_cmpgt_epi64(m, s));
+    s = _mm256_shuffle_epi32(m, 0x4e);
+    m = _mm256_blendv_epi8(m, s, _mm256_cmpgt_epi64(m, s));
+
+    /* The first lane equal to the minimum identifies the minimum child. */
+    mask = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(a, m)));
+#if DHEAP_ARITY == 8
+    mask |= _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(b, m)))
+        << 4;
+#endif
+
+    return __builtin_ctz(mask);
+}
+
+
+int dh_min_child_sse4(const long *group)
+{
+    __m128i a[DHEAP_ARITY / 2], m, s;
+    int i, mask;
+
+    /* Take the element-wise minimum of all pairs of keys in the group. */
+    m = a[0] = _mm_load_si128((const __m128i *)group);
+    for(i = 1; i < DHEAP_ARITY / 2; i++) {
+        a[i] = _mm_load_si128((const __m128i *)(group + 2 * i));
+        m = _mm_blendv_epi8(m, a[i], _mm_cmpgt_epi64(m, a[i]));
+    }
+
+    /* Reduce the two lanes of m to their minimum, broadcast to both lanes. */
+    s = _mm_shuffle_epi32(m, 0x4e);
+    m = _mm_blendv_epi8(m, s, _mm_cmpgt_epi64(m, s));
+
+    /* The first lane equal to the minimum identifies the minimum child. */
+    mask = 0;
+    for(i = 0; i < DHEAP_ARITY / 2; i++) {
+        mask |= _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpeq_epi64(a[i], m)))
+            << (2 * i);
+    }
+
+    return __builtin_ctz(mask);
+}
+#endif
+
+
+/* dh_aligned() returns the first address in block which is aligned to a cache
+ * line boundary.  The block must have DHEAP_CACHE_LINE bytes to spare.
+ */
+void *dh_aligned(void *block)
+{
+    size_t a;
+
+    a = ((size_t)block + DHEAP_CACHE_LINE - 1) & ~(size_t)(DHEAP_CACHE_LINE - 1);
+    return (void *)a;
+}
+
+
+
+/*** Debugging functions ***/
+
+/* Print out a d-ary heap, one level per line. */
+#if DHEAP_DUMP
+void dh_dump(dheap_t *h)
+{
+    int i, level_end;
+
+    level_end = 1;
+    for(i = 0; i < h->n; i++) {
+        printf(" %d(%ld)", h->item[i], h->key[i]);
+        if(i + 1 == level_end) {
+            putchar('\n');
+            level_end = DHEAP_ARITY * level_end + 1;
+        }
+    }
+    printf("\n\n");
+    fflush(stdout);
+}
+#endif
+
+
+/*** Implement the univeral heap structure type ***/
+
+/* d-ary heap wrapper functions. */
+
+int _dh_delete_min(void *h) {
+    return dh_delete_min((dheap_t *)h);
+}
+
+void _dh_insert(void *h, int v, long k) {
+    dh_insert((dheap_t *)h, v, k);
+}
+
+void _dh_decrease_key(void *h, int v, long k) {
+    dh_decrease_key((dheap_t *)h, v, k);
+}
+
+int _dh_n(void *h) {
+    return ((dheap_t *)h)->n;
+}
+
+long _dh_key_comps(void *h) {
+    return ((dheap_t *)h)->ops.comps;
+}
+
+const opcount_t *_dh_counts(void *h) {
+    return &((dheap_t *)h)->ops;
+}
+
+void *_dh_alloc(int n) {
+    return dh_alloc(n);
+}
+
+void _dh_free(void *h) {
+    dh_free((dheap_t *)h);
+}
+
+void _dh_insert_batch(void *h, const int *v, const long *k, int n) {
+    dh_insert_batch((dheap_t *)h, v, k, n);
+}
+
+void _dh_decrease_key_batch(void *h, const int *v, const long *k, int n) {
+    dh_decrease_key_batch((dheap_t *)h, v, k, n);
+}
+
+void _dh_dump(void *h) {
+#if DHEAP_DUMP
+    dh_dump((dheap_t *)h);
+#endif
+}
+
+/* d-ary heap info. */
+const heap_info_t DHEAP_info = {
+    _dh_delete_min,
+    _dh_insert,
+    _dh_decrease_key,
+    _dh_n,
+    _dh_key_comps,
+    _dh_alloc,
+    _dh_free,
+    _dh_dump,
+    NULL,
+    _dh_insert_batch,
+    _dh_decrease_key_batch,
+    _dh_counts
+};
@@ -0,0 +1,121 @@
+#ifndef DHEAP_H
+#define DHEAP_H
+/*** Header File for the d-ary Heap Implementation ***/
+#include "heap_info.h"  /* Defines the uiversal heap structure type. */
+
+/* This implementation stores a d-ary heap in two separate arrays, one for keys
+ * and one for items.  The arrays are aligned so that the d children of any
+ * node occupy one aligned block of the key array.  With d = 8 and 64-bit keys,
+ * all the children of a node share a single cache line, so each level of a
+ * sift-down costs one cache miss instead of several.
+ */
+
+
+/*** Compile Time Options ***/
+
+/* The arity of the heap.  The SIMD child selection code supports 4 and 8.
+ * Other values greater than 1 work, but use the plain C child selection.
+ */
+#define DHEAP_ARITY 8
+
+/* The cache line size in bytes.  The key and item arrays are aligned to this
+ * boundary.
+ */
+#define DHEAP_CACHE_LINE 64
+
+/* Use 1 to select the minimum child using SIMD instructions (AVX2, or
+ * SSE4.2) when the processor supports them, or 0 to always use plain C.  The
+ * instruction set is chosen at run time, so no compiler flags are needed.
+ * This needs GCC or Clang on x86-64.
+ */
+#define DHEAP_SIMD 1
+
+/* Option to allow printing of debugging information.  Use 1 for yes, or 0 for
+ * no.
+ */
+#define DHEAP_DUMP 0
+
+
+
+/*** Structure Definitions ***/
+
+/* d-ary heap structure for the frontier set in Dijkstra's algorithm.
+ * key[] - stores the keys of heap entries.  key[i] is the key of the entry at
+ *         heap position i, where position 0 is the root and the children of
+ *         position i are positions d*i+1, ..., d*i+d.  Entries beyond the end
+ *         of the heap hold LONG_MAX, so a full group of children can always
+ *         be examined.
+ * item[] - stores the item (vertex number) of the entry at each position.
+ * p[] - stores the positions of items in the heap.
+ * n - is the number of entries in the heap.
+ * key_block, item_block - the unaligned blocks holding key[] and item[].
+ * ops - counts the operations performed on the heap, for experimental
+ *       purposes.  See opcount.h.
+ */
+typedef struct dheap {
+    long *key;
+    int *item;
+    int *p;
+    int n;
+    void *key_block, *item_block;
+    opcount_t ops;
+} dheap_t;
+
+
+
+/*** Function prototypes. ***/
+
+/* d-ary heap functions. */
+
+/* dh_alloc() allocates space for a d-ary heap of size n and initialises it.
+ * Returns a pointer to the d-ary heap.
+ */
+dheap_t *dh_alloc(int n);
+
+/* dh_free() frees the space taken up by the d-ary heap pointed to by h.
+ */
+void dh_free(dheap_t *h);
+
+/* dh_min() returns the item with the minimum key in the d-ary heap pointed to
+ * by h.
+ */
+int dh_min(dheap_t *h);
+
+/* dh_insert() inserts an item and its key value into the d-ary heap pointed
+ * to by h.
+ */
+void dh_insert(dheap_t *h, int item, long key);
+
+/* dh_delete_min() deletes the item with the minimum key from the d-ary heap
+ * pointed to by h, and returns the item.
+ */
+int dh_delete_min(dheap_t *h);
+
+/* dh_decrease_key() decreases the value of 'item's key and then sifts 'item'
+ * towards the root until it is in the correct position in the d-ary heap.
+ */
+void dh_decrease_key(dheap_t *h, int item, long new_key);
+
+/* dh_insert_batch() inserts items[i] with key keys[i], i = 0, 1, ..., n-1, into
+ * the d-ary heap pointed to by h.  When this at least doubles the size of the
+ * heap, the heap is rebuilt bottom-up in linear time.
+ */
+void dh_insert_batch(dheap_t *h, const int *items, const long *keys, int n);
+
+/* dh_decrease_key_batch() decreases the key of items[i] to keys[i], i = 0, 1,
+ * ..., n-1, in the d-ary heap pointed to by h.  When sifting each item would
+ * cost more than rebuilding the heap, the heap is rebuilt bottom-up instead.
+ */
+void dh_decrease_key_batch(dheap_t *h, const int *items, const long *keys,
+                           int n);
+
+/* Debugging functions. */
+#if DHEAP_DUMP
+void dh_dump(dheap_t *h);
+#endif
+
+
+/*** Alternative interface via the universal heap structure type. ***/
+extern const heap_info_t DHEAP_info;
+
+#endif
@@ -0,0 +1,262 @@
+/*** Dial Bucket Queue Implementation ***/
+#include <stdlib.h>
+#include "dialheap.h"
+#if DIALHEAP_DUMP
+#include <stdio.h>
+#endif
+
+
+
+/*** Prototypes of functions only visible within this file. ***/
+
+void dq_grow(dialheap_t *h, long range);
+void dq_add(dialheap_t *h, int v);
+void dq_remove(dialheap_t *h, int v);
+
+
+
+/*** Definitions of functions visible outside of this file. ***/
+
+/* dq_alloc() - creates and returns a pointer to a Dial bucket queue for items
+ * (vertex numbers) 0, 1, ..., max_nodes - 1.
+ */
+dialheap_t *dq_alloc(int max_nodes)
+{
+    dialheap_t *h;
+    int i;
+
+    h = malloc(sizeof(dialheap_t));
+    h->key = malloc(max_nodes * sizeof(long));
+    h->next = malloc(max_nodes * sizeof(int));
+    h->prev = malloc(max_nodes * sizeof(int));
+
+    h->n_buckets = DIALHEAP_MIN_BUCKETS;
+    h->mask = h->n_buckets - 1;
+    h->head = malloc(h->n_buckets * sizeof(int));
+    for(i = 0; i < h->n_buckets; i++) h->head[i] = -1;
+
+    h->last = 0;
+    h->n = 0;
+    OP_RESET(h->ops);
+
+    return h;
+}
+
+
+/* dq_free() - destroys the heap pointed to by h, freeing up any space that
+ * was used by it.
+ */
+void dq_free(dialheap_t *h)
+{
+    free(h->key);
+    free(h->next);
+    free(h->prev);
+    free(h->head);
+    free(h);
+}
+
+
+/* dq_insert() - inserts vertex_no with key k into the heap pointed to by h.
+ * The key k must be no smaller than the last key removed from the heap.
+ */
+void dq_insert(dialheap_t *h, int vertex_no, long k)
+{
+    /* Make sure that the buckets cover key k. */
+    if(k - h->last >= h->n_buckets) dq_grow(h, k - h->last + 1);
+
+    h->key[vertex_no] = k;
+    dq_add(h, vertex_no);
+    h->n++;
+}
+
+
+/* dq_delete_min() - deletes the item with the minimum key from the heap
+ * pointed to by h and returns its vertex number.
+ */
+int dq_delete_min(dialheap_t *h)
+{
+    int v;
+    long last;
+    int *head;
+
+    head = h->head;
+    last = h->last;
+
+    /* Advance to the first non-empty bucket.  Since all keys lie within
+     * n_buckets of the last key removed, this does not wrap around past
+     * the bucket holding the last key.
+     */
+    while(head[last & h->mask] < 0) last++;
+    OP_DEPTH(h->ops, (int)(last - h->last));
+    h->last = last;
+
+    v = head[last & h->mask];
+    dq_remove(h, v);
+    h->n--;
+
+    return v;
+}
+
+
+/* dq_decrease_key() - decreases the key of vertex_no to new_value.  The new
+ * value must be no smaller than the last key removed from the heap.
+ */
+void dq_decrease_key(dialheap_t *h, int vertex_no, long new_value)
+{
+    /* The new key is smaller than the old key, so is already within the range
+     * covered by the buckets.
+     */
+    dq_remove(h, vertex_no);
+    h->key[vertex_no] = new_value;
+    dq_add(h, vertex_no);
+}
+
+
+
+/*** Definitions of functions that are only visible within this file. ***/
+
+/* dq_grow() - increases the number of buckets until they cover at least range
+ * keys, and redistributes the items amongst the new buckets.
+ */
+void dq_grow(dialheap_t *h, long range)
+{
+    int *old_head;
+    long old_n_buckets, i;
+    int v, next;
+
+    old_head = h->head;
+    old_n_buckets = h->n_buckets;
+
+    OP_RESTRUCT(h->ops);
+    while(h->n_buckets < range) h->n_buckets *= 2;
+    h->mask = h->n_buckets - 1;
+    h->head = malloc(h->n_buckets * sizeof(int));
+    for(i = 0; i < h->n_buckets; i++) h->head[i] = -1;
+
+    for(i = 0; i < old_n_buckets; i++) {
+        v = old_head[i];
+        while(v >= 0) {
+            next = h->next[v];
+            dq_add(h, v);
+            v = next;
+        }
+    }
+
+    free(old_head);
+}
+
+
+/* dq_add() - adds item v to the front of the bucket for its key. */
+void dq_add(dialheap_t *h, int v)
+{
+    int b, first;
+
+    b = h->key[v] & h->mask;
+    first = h->head[b];
+    h->next[v] = first;
+    h->prev[v] = -1;
+    if(first >= 0) h->prev[first] = v;
+    h->head[b] = v;
+    OP_LINK(h->ops);
+}
+
+
+/* dq_remove() - removes item v from the bucket for its key. */
+void dq_remove(dialheap_t *h, int v)
+{
+    int next, prev;
+
+    next = h->next[v];
+    prev = h->prev[v];
+    if(prev >= 0) {
+        h->next[prev] = next;
+    }
+    else {
+        h->head[h->key[v] & h->mask] = next;
+    }
+    if(next >= 0) h->prev[next] = prev;
+}
+
+
+
+/*** Debugging functions ***/
+
+/* Print out the items in each non-empty bucket of a Dial bucket queue. */
+#if DIALHEAP_DUMP
+void dq_dump(dialheap_t *h)
+{
+    long b;
+    int v;
+
+    printf("\nlast = %ld, n = %d, n_buckets = %ld\n", h->last, h->n,
+           h->n_buckets);
+    for(b = 0; b < h->n_buckets; b++) {
+        if(h->head[b] < 0) continue;
+        printf("bucket %ld:", b);
+        for(v = h->head[b]; v >= 0; v = h->next[v]) {
+            printf(" %d(%ld)", v, h->key[v]);
+        }
+        putchar('\n');
+    }
+    fflush(stdout);
+}
+#endif
+
+
+/*** Implement the univeral heap structure type ***/
+
+/* Dial bucket queue wrapper functions. */
+
+int _dq_delete_min(void *h) {
+    return dq_delete_min((dialheap_t *)h);
+}
+
+void _dq_insert(void *h, int v, long k) {
+    dq_insert((dialheap_t *)h, v, k);
+}
+
+void _dq_decrease_key(void *h, int v, long k) {
+    dq_decrease_key((dialheap_t *)h, v, k);
+}
+
+int _dq_n(void *h) {
+    return ((dialheap_t *)h)->n;
+}
+
+long _dq_key_comps(void *h) {
+    return ((dialheap_t *)h)->ops.comps;
+}
+
+const opcount_t *_dq_counts(void *h) {
+    return &((dialheap_t *)h)->ops;
+}
+
+void *_dq_alloc(int n) {
+    return dq_alloc(n);
+}
+
+void _dq_free(void *h) {
+    dq_free((dialheap_t *)h);
+}
+
+void _dq_dump(void *h) {
+#if DIALHEAP_DUMP
+    dq_dump((dialheap_t *)h);
+#endif
+}
+
+/* Dial bucket queue info. */
+const heap_info_t DIALHEAP_info = {
+    _dq_delete_min,
+    _dq_insert,
+    _dq_decrease_key,
+    _dq_n,
+    _dq_key_comps,
+    _dq_alloc,
+    _dq_free,
+    _dq_dump,
+    NULL,
+    NULL,
+    NULL,
+    _dq_counts
+};
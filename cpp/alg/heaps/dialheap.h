@@ -0,0 +1,100 @@
+#ifndef DIALHEAP_H
+#define DIALHEAP_H
+/*** Header File for the Dial Bucket Queue Implementation ***/
+#include "heap_info.h"  /* Defines the uiversal heap structure type. */
+
+/* Dial's bucket queue is a monotone priority queue for non-negative integer
+ * keys.  The key of every item inserted, and every new key given to
+ * decrease_key(), must be no smaller than the key of the item most recently
+ * removed by delete_min().  Dijkstra's algorithm with non-negative integer edge
+ * costs satisfies this.  No check is made, so it is up to the user of the heap
+ * to ensure that it holds.
+ *
+ * The queue is a circular array of buckets, one per key value, which covers
+ * keys from the last key removed up to the last key removed plus the number of
+ * buckets.  For Dijkstra's algorithm this range only needs to be as large as
+ * the maximum edge cost.  Since the maximum edge cost is not known in advance,
+ * the number of buckets is doubled whenever an inserted key falls outside the
+ * range.  This makes Dial's bucket queue suitable when the range of edge costs
+ * is small.  For large ranges, the radix heap (rheap.h) is a better choice.
+ */
+
+
+/*** Compile Time Options ***/
+
+/* The initial number of buckets.  Must be a power of 2. */
+#define DIALHEAP_MIN_BUCKETS 64
+
+/* Option to print debugging information.  Use 1 for yes, or 0 for no. */
+#define DIALHEAP_DUMP 0
+
+
+
+/*** Structure Types ***/
+
+/* The structure type for Dial's bucket queue.
+ *
+ * Each bucket is a doubly linked list of items, which is maintained using
+ * arrays indexed by item (vertex number):
+ * key[v]     - the key of item v.
+ * next[v], prev[v] - the next and previous item in item v's bucket, or -1.
+ * head[i]    - the first item in bucket i, or -1 if bucket i is empty.  Items
+ *              with key k are in bucket k & mask.
+ *
+ * n_buckets - the number of buckets, which is a power of 2.
+ * mask - n_buckets - 1.
+ * last - the key of the item most recently removed by delete_min().
+ * n - the current number of items in the heap.
+ * ops - counts the operations performed on the heap, for experimental
+ *       purposes.  See opcount.h.  Dial's bucket queue makes no key
+ *       comparisons.
+ */
+typedef struct dialheap {
+    long *key;
+    int *next, *prev;
+    int *head;
+    long n_buckets, mask;
+    long last;
+    int n;
+    opcount_t ops;
+} dialheap_t;
+
+
+
+/*** Function prototypes. ***/
+
+/* dq_alloc() - creates and returns a pointer to a Dial bucket queue for items
+ * (vertex numbers) 0, 1, ..., max_nodes - 1.
+ */
+dialheap_t *dq_alloc(int max_nodes);
+
+/* dq_free() - destroys the heap pointed to by h, freeing up any space that
+ * was used by it.
+ */
+void dq_free(dialheap_t *h);
+
+/* dq_insert() - inserts vertex_no with key k into the heap pointed to by h.
+ * The key k must be no smaller than the last key removed from the heap.
+ */
+void dq_insert(dialheap_t *h, int vertex_no, long k);
+
+/* dq_delete_min() - deletes the item with the minimum key from the heap
+ * pointed to by h and returns its vertex number.
+ */
+int dq_delete_min(dialheap_t *h);
+
+/* dq_decrease_key() - decreases the key of vertex_no to new_value.  The new
+ * value must be no smaller than the last key removed from the heap.
+ */
+void dq_decrease_key(dialheap_t *h, int vertex_no, long new_value);
+
+/* Debugging functions. */
+#if DIALHEAP_DUMP
+void dq_dump(dialheap_t *h);
+#endif
+
+
+/*** Alternative interface via the universal heap structure type. ***/
+extern const heap_info_t DIALHEAP_info;
+
+#endif
@@ -0,0 +1,253 @@
+/*** Dictionary Heap Adapter Implementation ***/
+#include <stdlib.h>
+#include "dictheap.h"
+#include "../dict/avl.h"
+#include "../dict/rbtree.h"
+#include "../dict/tree23.h"
+#include "../dict/skip_list.h"
+#if DICTHEAP_DUMP
+#include <stdio.h>
+#endif
+
+
+
+/*** Prototypes of functions only visible within this file. ***/
+
+int dch_compar(const void *item1, const void *item2);
+
+
+
+/*** Definitions of functions visible outside of this file. ***/
+
+/* dch_alloc() - creates and returns a pointer to a dictionary heap for items
+ * (vertex numbers) 0, 1, ..., max_nodes - 1, which keeps its items in a
+ * dictionary allocated by the dictionary functions fns.
+ */
+dictheap_t *dch_alloc(int max_nodes, const dict_info_t *fns)
+{
+    dictheap_t *h;
+    int i;
+
+    h = malloc(sizeof(dictheap_t));
+    h->fns = fns;
+    h->t = fns->alloc(dch_compar, NULL);
+    h->items = malloc(max_nodes * sizeof(dictheap_item_t));
+    for(i = 0; i < max_nodes; i++) h->items[i].vertex_no = i;
+
+    h->n = 0;
+    OP_RESET(h->ops);
+
+    return h;
+}
+
+
+/* dch_free() - destroys the heap pointed to by h, freeing up any space that
+ * was used by it.
+ */
+void dch_free(dictheap_t *h)
+{
+    h->fns->free(h->t);
+    free(h->items);
+    free(h);
+}
+
+
+/* dch_insert() - inserts vertex_no with key k into the heap pointed to by h.
+ */
+void dch_insert(dictheap_t *h, int vertex_no, long k)
+{
+    h->items[vertex_no].key = k;
+    h->fns->insert(h->t, &h->items[vertex_no]);
+    h->n++;
+}
+
+
+/* dch_delete_min() - deletes the item with the minimum key from the heap
+ * pointed to by h and returns its vertex number.
+ */
+int dch_delete_min(dictheap_t *h)
+{
+    dictheap_item_t *item;
+
+    item = h->fns->delete_min(h->t);
+    h->n--;
+
+    return item->vertex_no;
+}
+
+
+/* dch_decrease_key() - decreases the key of vertex_no to new_value. */
+void dch_decrease_key(dictheap_t *h, int vertex_no, long new_value)
+{
+    dictheap_item_t *item;
+
+    /* The item's position in the dictionary depends on its key, so it is
+     * removed before the key is changed.
+     */
+    item = &h->items[vertex_no];
+    h->fns->delete(h->t, item);
+    item->key = new_value;
+    h->fns->insert(h->t, item);
+}
+
+
+/* dch_counts() - returns a pointer to the operation counts of the dictionary
+ * of the heap pointed to by h.
+ */
+const opcount_t *dch_counts(dictheap_t *h)
+{
+    h->ops = *h->fns->counts(h->t);
+    return &h->ops;
+}
+
+
+
+/*** Definitions of functions that are only visible within this file. ***/
+
+/* dch_compar() - compares two items by key, and then by vertex number. */
+int dch_compar(const void *item1, const void *item2)
+{
+    const dictheap_item_t *a = item1, *b = item2;
+
+    if(a->key != b->key) return a->key < b->key ? -1 : 1;
+    return a->vertex_no - b->vertex_no;
+}
+
+
+
+/*** Debugging functions ***/
+
+/* Print out the items of a dictionary heap in key order. */
+#if DICTHEAP_DUMP
+void dch_dump(dictheap_t *h)
+{
+    dictheap_item_t *item;
+    void *c;
+
+    printf("\nn = %d\n", h->n);
+    if(!h->fns->cursor_alloc) return;
+    c = h->fns->cursor_alloc(h->t);
+    for(item = h->fns->seek(c, NULL); item; item = h->fns->next(c)) {
+        printf(" %d(%ld)", item->vertex_no, item->key);
+    }
+    putchar('\n');
+    h->fns->cursor_free(c);
+    fflush(stdout);
+}
+#endif
+
+
+/*** Implement the univeral heap structure type ***/
+
+/* Dictionary heap wrapper functions. */
+
+int _dch_delete_min(void *h) {
+    return dch_delete_min((dictheap_t *)h);
+}
+
+void _dch_insert(void *h, int v, long k) {
+    dch_insert((dictheap_t *)h, v, k);
+}
+
+void _dch_decrease_key(void *h, int v, long k) {
+    dch_decrease_key((dictheap_t *)h, v, k);
+}
+
+int _dch_n(void *h) {
+    return ((dictheap_t *)h)->n;
+}
+
+long _dch_key_comps(void *h) {
+    return dch_counts((dictheap_t *)h)->comps;
+}
+
+const opcount_t *_dch_counts(void *h) {
+    return dch_counts((dictheap_t *)h);
+}
+
+void *_dch_avl_alloc(int n) {
+    return dch_alloc(n, &AVL_info);
+}
+
+void *_dch_rbtree_alloc(int n) {
+    return dch_alloc(n, &RBTREE_info);
+}
+
+void *_dch_tree23_alloc(int n) {
+    return dch_alloc(n, &TREE23_info);
+}
+
+void *_dch_skip_list_alloc(int n) {
+    return dch_alloc(n, &SKIP_LIST_info);
+}
+
+void _dch_free(void *h) {
+    dch_free((dictheap_t *)h);
+}
+
+void _dch_dump(void *h) {
+#if DICTHEAP_DUMP
+    dch_dump((dictheap_t *)h);
+#endif
+}
+
+/* Dictionary heap infos, one for each dictionary. */
+const heap_info_t DICTHEAP_AVL_info = {
+    _dch_delete_min,
+    _dch_insert,
+    _dch_decrease_key,
+    _dch_n,
+    _dch_key_comps,
+    _dch_avl_alloc,
+    _dch_free,
+    _dch_dump,
+    NULL,
+    NULL,
+    NULL,
+    _dch_counts
+};
+
+const heap_info_t DICTHEAP_RBTREE_info = {
+    _dch_delete_min,
+    _dch_insert,
+    _dch_decrease_key,
+    _dch_n,
+    _dch_key_comps,
+    _dch_rbtree_alloc,
+    _dch_free,
+    _dch_dump,
+    NULL,
+    NULL,
+    NULL,
+    _dch_counts
+};
+
+const heap_info_t DICTHEAP_TREE23_info = {
+    _dch_delete_min,
+    _dch_insert,
+    _dch_decrease_key,
+    _dch_n,
+    _dch_key_comps,
+    _dch_tree23_alloc,
+    _dch_free,
+    _dch_dump,
+    NULL,
+    NULL,
+    NULL,
+    _dch_counts
+};
+
+const heap_info_t DICTHEAP_SKIP_LIST_info = {
+    _dch_delete_min,
+    _dch_insert,
+    _dch_decrease_key,
+    _dch_n,
+    _dch_key_comps,
+    _dch_skip_list_alloc,
+    _dch_free,
+    _dch_dump,
+    NULL,
+    NULL,
+    NULL,
+    _dch_counts
+};
@@ -0,0 +1,102 @@
+#ifndef DICTHEAP_H
+#define DICTHEAP_H
+/*** Header File for the Dictionary Heap Adapter ***/
+#include "heap_info.h"  /* Defines the uiversal heap structure type. */
+#include "../dict/dict_info.h"  /* Defines the universal dictionary type. */
+
+/* A dictionary heap uses any dictionary providing dict_info_t, with a
+ * delete_min() function, as a priority queue.  The items in the dictionary
+ * are (key, vertex number) pairs, ordered by key and then by vertex number, so
+ * that no two items are equal even when their keys are.  The item of each
+ * vertex is kept in an array indexed by vertex number, which finds the item
+ * to remove when the vertex's key is decreased.  Decreasing a key deletes the
+ * item from the dictionary, changes its key, and inserts it again.
+ *
+ * The dictionary must compare items only with the compare function, so
+ * digital dictionaries, which need a getval() function, cannot be used.  Key
+ * comparisons are those counted by the dictionary.
+ *
+ * DICTHEAP_AVL_info, DICTHEAP_RBTREE_info, DICTHEAP_TREE23_info and
+ * DICTHEAP_SKIP_LIST_info allocate dictionary heaps using AVL trees,
+ * red-black trees, 2-3 trees and skip lists.
+ */
+
+
+/*** Option to print debugging information.  Use 1 for yes, or 0 for no. ***/
+#define DICTHEAP_DUMP 0
+
+
+
+/*** Structure Types ***/
+
+/* The structure type for the items kept in the dictionary.
+ * key - the item's key.
+ * vertex_no - the number of the graph vertex that the item corresponds to.
+ */
+typedef struct dictheap_item {
+    long key;
+    int vertex_no;
+} dictheap_item_t;
+
+/* The structure type for a dictionary heap.
+ * fns - the functions of the dictionary.
+ * t - the dictionary.
+ * items - items[v] is the item of vertex v, which is in the dictionary while
+ *         v is in the heap.
+ * n - the current number of items in the heap.
+ * ops - holds the operation counts of the dictionary, copied by
+ *       dch_counts().
+ */
+typedef struct dictheap {
+    const dict_info_t *fns;
+    void *t;
+    dictheap_item_t *items;
+    int n;
+    opcount_t ops;
+} dictheap_t;
+
+
+
+/*** Function prototypes. ***/
+
+/* dch_alloc() - creates and returns a pointer to a dictionary heap for items
+ * (vertex numbers) 0, 1, ..., max_nodes - 1, which keeps its items in a
+ * dictionary allocated by the dictionary functions fns.
+ */
+dictheap_t *dch_alloc(int max_nodes, const dict_info_t *fns);
+
+/* dch_free() - destroys the heap pointed to by h, freeing up any space that
+ * was used by it.
+ */
+void dch_free(dictheap_t *h);
+
+/* dch_insert() - inserts vertex_no with key k into the heap pointed to by h.
+ */
+void dch_insert(dictheap_t *h, int vertex_no, long k);
+
+/* dch_delete_min() - deletes the item with the minimum key from the heap
+ * pointed to by h and returns its vertex number.
+ */
+int dch_delete_min(dictheap_t *h);
+
+/* dch_decrease_key() - decreases the key of vertex_no to new_value. */
+void dch_decrease_key(dictheap_t *h, int vertex_no, long new_value);
+
+/* dch_counts() - returns a pointer to the operation counts of the dictionary
+ * of the heap pointed to by h.
+ */
+const opcount_t *dch_counts(dictheap_t *h);
+
+/* Debugging functions. */
+#if DICTHEAP_DUMP
+void dch_dump(dictheap_t *h);
+#endif
+
+
+/*** Alternative interface via the universal heap structure type. ***/
+extern const heap_info_t DICTHEAP_AVL_info;
+extern const heap_info_t DICTHEAP_RBTREE_info;
+extern const heap_info_t DICTHEAP_TREE23_info;
+extern const heap_info_t DICTHEAP_SKIP_LIST_info;
+
+#endif
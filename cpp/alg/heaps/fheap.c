@@ -11,8 +11,18 @@
 
 
 
+/*** Node links. ***/
+
+/* FH_NODE() gives a pointer to the node with index i, which is not FHEAP_NIL,
+ * and FH_INDEX() gives the index of the node pointed to by p.
+ */
+#define FH_NODE(h, i) (&(h)->nodes[i])
+#define FH_INDEX(h, p) ((uint32_t)((p) - (h)->nodes))
+
+
+
 /*** Prototypes of functions only visible within this file. ***/
-void fh_dump_nodes(fheap_node_t *ptr, int level);
+void fh_dump_nodes(fheap_t *h, fheap_node_t *ptr, int level);
 void fh_meld(fheap_t *h, fheap_node_t *tree_list);
 
 
@@ -35,7 +45,7 @@ printf("alloc, ");
     h->max_trees = 1.0 + 1.44 * log(max_nodes)/log(2.0);
     h->max_nodes = max_nodes;
     h->trees = calloc(h->max_trees, sizeof(fheap_node_t *));
-    h->nodes = calloc(max_nodes, sizeof(fheap_node_t *));
+    h->nodes = malloc(max_nodes * sizeof(fheap_node_t));
     h->n = 0;
 
     /* The value of the heap helps to keep track of the maximum rank while
@@ -43,10 +53,9 @@ printf("alloc, ");
      */
     h->value = 0;
 
-    /* For experimental purposes, we keep a count of the number of key
-     * comparisons.
+    /* For experimental purposes, we keep counts of the operations performed.
      */
-    h->key_comps = 0;
+    OP_RESET(h->ops);
 
 #if FHEAP_DUMP
 printf("alloc-exited, ");
@@ -60,16 +69,10 @@ printf("alloc-exited, ");
  */
 void fh_free(fheap_t *h)
 {
-    int i;
-    
 #if FHEAP_DUMP
 printf("free, ");
 #endif
 
-    for(i = 0; i < h->max_nodes; i++) {
-        free(h->nodes[i]);
-    }
-
     free(h->nodes);
     free(h->trees);
     free(h);
@@ -91,17 +94,13 @@ void fh_insert(fheap_t *h, int vertex_no, long k)
 printf("insert, ");
 #endif
 
-    /* Create an initialise the new node. */
-    new = malloc(sizeof(fheap_node_t));
-    new->child = NULL;
-    new->left = new->right = new;
+    /* Initialise the new node, which already has space in the slab. */
+    new = FH_NODE(h, vertex_no);
+    new->child = FHEAP_NIL;
+    new->left = new->right = vertex_no;
     new->rank = 0;
-    new->vertex_no = vertex_no;
     new->key = k;
 
-    /* Maintain a pointer vertex_no's new node in the heap. */
-    h->nodes[vertex_no] = new;
-
     /* Meld the new node into the heap. */
     fh_meld(h, new);
 
@@ -119,7 +118,7 @@ printf("insert-exited, ");
  */
 int fh_delete_min(fheap_t *h)
 {
-    fheap_node_t *min_node, *child, *next;
+    fheap_node_t *min_node, *next;
     long k, k2;
     int r, v, vertex_no;
 
@@ -146,7 +145,7 @@ printf("delete_min, ");
                 k = k2;
                 min_node = next;
             }
-            h->key_comps++;
+            OP_COMP(h->ops);
         }
     }
 
@@ -155,13 +154,12 @@ printf("delete_min, ");
     h->trees[r] = NULL;
     h->value -= (1 << r);
 
-    child = min_node->child;
-    if(child) fh_meld(h, child);
+    if(min_node->child != FHEAP_NIL) {
+        fh_meld(h, FH_NODE(h, min_node->child));
+    }
 
     /* Record the vertex no of the old minimum node before deleting it. */
-    vertex_no = min_node->vertex_no;
-    h->nodes[vertex_no] = NULL;
-    free(min_node);
+    vertex_no = FH_INDEX(h, min_node);
     h->n--;
 
 #if FHEAP_DUMP
@@ -180,6 +178,7 @@ printf("delete_min-exited, ");
 void fh_decrease_key(fheap_t *h, int vertex_no, long new_value)
 {
     fheap_node_t *cut_node, *parent, *new_roots, *r, *l;
+    uint32_t cut, p;
     int prev_rank;
 
 #if FHEAP_DUMP
@@ -189,12 +188,13 @@ printf("decrease_key on vn = %d, ", vertex_no);
     /* Obtain a pointer to the decreased node and its parent then decrease the
      * nodes key.
      */
-    cut_node = h->nodes[vertex_no];
-    parent = cut_node->parent;
+    cut = vertex_no;
+    cut_node = FH_NODE(h, cut);
+    p = cut_node->parent;
     cut_node->key = new_value;
 
     /* No reinsertion occurs if the node changed was a root. */
-    if(!parent) {
+    if(p == FHEAP_NIL) {
 #if FHEAP_DUMP
 printf("decrease_key-exited, ");
 #endif
@@ -204,65 +204,68 @@ printf("decrease_key-exited, ");
     /* Update the left and right pointers of cut_node and its two neighbouring
      * nodes.
      */
-    l = cut_node->left;
-    r = cut_node->right;
-    l->right = r;
-    r->left = l;
-    cut_node->left = cut_node->right = cut_node;
+    l = FH_NODE(h, cut_node->left);
+    r = FH_NODE(h, cut_node->right);
+    l->right = cut_node->right;
+    r->left = cut_node->left;
+    cut_node->left = cut_node->right = cut;
+    OP_LINK(h->ops);
 
     /* Initially the list of new roots contains only one node. */
     new_roots = cut_node;
 
     /* While there is a parent node that is marked a cascading cut occurs. */
-    while(parent && parent->marked) {
+    while(p != FHEAP_NIL && (parent = FH_NODE(h, p))->marked) {
 
-        /* Decrease the rank of cut_node's parent an update its child pointer.
-         */
+        /* Decrease the rank of cut_node's parent an update its child link. */
         parent->rank--;
         if(parent->rank) {
-            if(parent->child == cut_node) parent->child = r;
+            if(parent->child == cut) parent->child = FH_INDEX(h, r);
         }
         else {
-            parent->child = NULL;
+            parent->child = FHEAP_NIL;
         }
 
-        /* Update the cut_node and parent pointers to the parent. */
+        /* Update cut_node and the parent link to the parent. */
         cut_node = parent;
-        parent = cut_node->parent;
+        cut = p;
+        p = cut_node->parent;
 
-        /* Update the left and right pointers of cut_nodes two neighbouring
+        /* Update the left and right links of cut_nodes two neighbouring
          * nodes.
          */
-        l = cut_node->left;
-        r = cut_node->right;
-        l->right = r;
-        r->left = l;
+        l = FH_NODE(h, cut_node->left);
+        r = FH_NODE(h, cut_node->right);
+        l->right = cut_node->right;
+        r->left = cut_node->left;
 
         /* Add cut_node to the list of nodes to be reinserted as new roots. */
-        l = new_roots->left;
-        new_roots->left = l->right = cut_node;
-        cut_node->left = l;
-        cut_node->right = new_roots;
+        l = FH_NODE(h, new_roots->left);
+        cut_node->left = new_roots->left;
+        new_roots->left = l->right = cut;
+        cut_node->right = FH_INDEX(h, new_roots);
         new_roots = cut_node;
+        OP_LINK(h->ops);
+        OP_RESTRUCT(h->ops);
     }
 
     /* If the root node is being relocated then update the trees[] array.
      * Otherwise mark the parent of the last node cut.
      */
-    if(!parent) {
+    if(p == FHEAP_NIL) {
         prev_rank = cut_node->rank + 1;
         h->trees[prev_rank] = NULL;
         h->value -= (1 << prev_rank);
     }
     else {
-        /* Decrease the rank of cut_node's parent an update its child pointer.
-         */
+        /* Decrease the rank of cut_node's parent an update its child link. */
+        parent = FH_NODE(h, p);
         parent->rank--;
         if(parent->rank) {
-            if(parent->child == cut_node) parent->child = r;
+            if(parent->child == cut) parent->child = FH_INDEX(h, r);
         }
         else {
-            parent->child = NULL;
+            parent->child = FHEAP_NIL;
         }
 
         parent->marked = 1;
@@ -278,6 +281,48 @@ printf("decrease_key-exited, ");
 
 
 
+/* fh_insert_batch() - creates and inserts nodes representing vertices[i] with
+ * key keys[i], i = 0, 1, ..., n-1, into the heap h, melding them into the heap
+ * together.
+ */
+void fh_insert_batch(fheap_t *h, const int *vertices, const long *keys, int n)
+{
+    fheap_node_t *new, *first;
+    uint32_t v;
+    int i;
+
+    if(n == 0) return;
+
+    /* Create the new nodes in a circular list, in the same way as
+     * fh_insert().
+     */
+    first = NULL;
+    for(i = 0; i < n; i++) {
+        v = vertices[i];
+        new = FH_NODE(h, v);
+        new->child = FHEAP_NIL;
+        new->rank = 0;
+        new->key = keys[i];
+
+        if(first) {
+            new->left = first->left;
+            new->right = FH_INDEX(h, first);
+            FH_NODE(h, first->left)->right = v;
+            first->left = v;
+        }
+        else {
+            first = new;
+            new->left = new->right = v;
+        }
+    }
+
+    /* Meld the list of new nodes into the heap. */
+    fh_meld(h, first);
+    h->n += n;
+}
+
+
+
 /*** Definitions of functions that are only visible within this file. ***/
 
 /* fh_meld() - melds  the linked list of trees pointed to by *tree_list into
@@ -302,15 +347,15 @@ printf("meld: ");
     do {
 
 #if FHEAP_DUMP
-printf("%d, ", node_ptr->vertex_no);
+printf("%d, ", (int)FH_INDEX(h, node_ptr));
 #endif
 
         /* Keep a pointer to the next node and remove sibling and parent links
          * from the current node.  node_ptr points to the current node.
          */
-        next = node_ptr->right;
-        node_ptr->right = node_ptr->left = node_ptr;
-        node_ptr->parent = NULL;
+        next = FH_NODE(h, node_ptr->right);
+        node_ptr->right = node_ptr->left = FH_INDEX(h, node_ptr);
+        node_ptr->parent = FHEAP_NIL;
 
         /* We merge the current node, node_ptr, by inserting it into the
          * root level of the heap.
@@ -344,7 +389,7 @@ printf("%d, ", node_ptr->vertex_no);
                     new_root = temp;
                     temp = temp2;
                 }
-                h->key_comps++;
+                OP_COMP(h->ops);
 
                 /* Link temp with new_root, making sure that sibling pointers
                  * get updated if rank is greater than 0.  Also, increase r for
@@ -352,16 +397,19 @@ printf("%d, ", node_ptr->vertex_no);
                  * increased.
                  */
 	        if(r++ > 0) {
-                    rc = new_root->child;
-                    lc = rc->left;
-                    temp->left = lc;
-                    temp->right = rc;
-                    lc->right = rc->left = temp;
+                    rc = FH_NODE(h, new_root->child);
+                    lc = FH_NODE(h, rc->left);
+                    temp->left = rc->left;
+                    temp->right = new_root->child;
+                    lc->right = rc->left = FH_INDEX(h, temp);
                 }
-                new_root->child = temp;
+                new_root->child = FH_INDEX(h, temp);
                 new_root->rank = r;
-                temp->parent = new_root;
+                temp->parent = FH_INDEX(h, new_root);
                 temp->marked = 0;
+                OP_LINK(h->ops);
+                OP_RESTRUCT(h->ops);
+                OP_DEPTH(h->ops, r);
             }
             /* Otherwise if there is not a tree of degree r in the heap we
              * allow new_root, which possibly carries moved trees in the heap,
@@ -398,34 +446,34 @@ printf("meld-exited, ");
 
 /* Recursively print the nodes of a Fibonacci heap. */
 #if FHEAP_DUMP
-void fh_dump_nodes(fheap_node_t *ptr, int level)
+void fh_dump_nodes(fheap_t *h, fheap_node_t *ptr, int level)
 {
-     fheap_node_t *child_ptr, *partner;
+     fheap_node_t *child_ptr, *first;
      int i, ch_count;
 
      /* Print leading whitespace for this level. */
      for(i = 0; i < level; i++) printf("   ");
 
-     printf("%d(%ld)[%d]\n", ptr->vertex_no, ptr->key, ptr->rank);
+     printf("%d(%ld)[%d]\n", (int)FH_INDEX(h, ptr), ptr->key, ptr->rank);
      
-     if((child_ptr = ptr->child)) {
-	 child_ptr = ptr->child->right;
+     if(ptr->child != FHEAP_NIL) {
+	 first = child_ptr = FH_NODE(h, FH_NODE(h, ptr->child)->right);
 	 
          ch_count = 0;
 
          do {
-             fh_dump_nodes(child_ptr, level+1);
+             fh_dump_nodes(h, child_ptr, level+1);
 	     if(child_ptr->dim > ptr->dim) {
                  for(i = 0; i < level+1; i++) printf("   ");
 		 printf("error(dim)\n");  exit(1);
 	     }
-	     if(child_ptr->parent != ptr) {
+	     if(child_ptr->parent != FH_INDEX(h, ptr)) {
                  for(i = 0; i < level+1; i++) printf("   ");
 		 printf("error(parent)\n");
 	     }
-             child_ptr = child_ptr->right;
+             child_ptr = FH_NODE(h, child_ptr->right);
 	     ch_count++;
-         } while(child_ptr != ptr->child->right);
+         } while(child_ptr != first);
 
          if(ch_count != ptr->dim) {
 	     for(i = 0; i < level; i++) printf("   ");
@@ -459,7 +507,7 @@ void fh_dump(fheap_t *h)
     for(i=0; i<h->max_trees; i++) {
         if((ptr = h->trees[i])) {
             printf("tree %d\n\n", i);
-            fh_dump_nodes(ptr, 0);
+            fh_dump_nodes(h, ptr, 0);
 	    printf("\n");
         }
     }
@@ -489,7 +537,11 @@ int _fh_n(void *h) {
 }
 
 long _fh_key_comps(void *h) {
-    return ((fheap_t *)h)->key_comps;
+    return ((fheap_t *)h)->ops.comps;
+}
+
+const opcount_t *_fh_counts(void *h) {
+    return &((fheap_t *)h)->ops;
 }
 
 void *_fh_alloc(int n) {
@@ -500,6 +552,10 @@ void _fh_free(void *h) {
     fh_free((fheap_t *)h);
 }
 
+void _fh_insert_batch(void *h, const int *v, const long *k, int n) {
+    fh_insert_batch((fheap_t *)h, v, k, n);
+}
+
 void _fh_dump(void *h) {
 #if FHEAP_DUMP
     fh_dump((fheap_t *)h);
@@ -515,5 +571,9 @@ const heap_info_t FHEAP_info = {
     _fh_key_comps,
     _fh_alloc,
     _fh_free,
-    _fh_dump
+    _fh_dump,
+    NULL,
+    _fh_insert_batch,
+    NULL,
+    _fh_counts
 };
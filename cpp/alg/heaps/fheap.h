@@ -5,6 +5,7 @@
 /*
  *   Shane Saunders
  */
+#include <stdint.h>
 #include "heap_info.h"  /* Defines the uiversal heap structure type. */
 
 
@@ -13,33 +14,39 @@
  */
 #define FHEAP_DUMP 0
 
+/* The link value used in place of a NULL pointer. */
+#define FHEAP_NIL 0xffffffffU
+
 
 
 /*** Definitions of structure types. ***/
 
 /* The structure type for Fibonacci heap nodes.
  *
- * Nodes have the following pointers:
- * parent      - a pointer to the nodes parent node (if any).
- * child       - a pointer to a child node (typically the highest rank child).
- * left, right - sibling pointers which provide a circular doubly linked list
+ * All nodes are kept in one array, the heap's slab, and the node for vertex v
+ * is slab entry v.  Nodes are linked by their 32-bit indices in the slab
+ * rather than by pointers, with FHEAP_NIL for no node.  This makes a node 32
+ * bytes instead of 56 on machines with 64-bit pointers, so two fit in a
+ * 64-byte cache line.  The vertex number of a node is its index, so it is not
+ * stored.
+ *
+ * Nodes have the following links:
+ * parent      - the nodes parent node (if any).
+ * child       - a child node (typically the highest rank child).
+ * left, right - sibling links which provide a circular doubly linked list
  *               containing all the parents nodes children.
  *
  * The remaining structure fields are:
  * rank        - the nodes rank, that is, the number of children it has.
  * `key'       - the nodes key.
- * vertex_no   - the number of the graph vertex that the node corresponds to.
- *               Vertex numbering in the graph should be:
- *                    1, 2, 3, ... max_vertex.
  */
 typedef struct fheap_node {
-    struct fheap_node *parent;
-    struct fheap_node *left, *right;
-    struct fheap_node *child;
+    uint32_t parent;
+    uint32_t left, right;
+    uint32_t child;
     int rank;
     int marked;
     long key;
-    int vertex_no;
 } fheap_node_t;
 
 /* The structure type for a Fibonacci heap.
@@ -47,10 +54,7 @@ typedef struct fheap_node {
  * trees - An array of pointers to trees at root level in the heap.  Entry i
  *         in the array points to the root node of a tree that has nodes of
  *         dimension i on the main trunk.
- * nodes - An array of pointers to nodes in the heap.  Nodes are indexed
- *         according to their vertex number.  This array can then be used to
- *         look up the node for corresponding to a vertex number, and is
- *         useful when freeing space taken up by the heap.
+ * nodes - The slab of nodes, indexed by vertex number.
  * max_nodes - The maximum number of nodes allowed in the heap.
  * max_trees - The maximum number of trees allowed in the heap (calculated from
  *             max_nodes).
@@ -58,14 +62,14 @@ typedef struct fheap_node {
  * value - The binary value represented by trees in the heap.
  *         By maintaining this it is easy to keep track of the maximum rank
  *         tree in the heap.
- * key_comps - can be used for experimental purposes when counting the number
- *             of key comparisons.
+ * ops - counts the operations performed on the heap, for experimental
+ *       purposes.  See opcount.h.
  */
 typedef struct fheap {
     fheap_node_t **trees;
-    fheap_node_t **nodes;
+    fheap_node_t *nodes;
     int max_nodes, max_trees, n, value;
-    long key_comps;
+    opcount_t ops;
 } fheap_t;
 
 
@@ -106,6 +110,12 @@ int fh_delete_min(fheap_t *h);
  */
 void fh_decrease_key(fheap_t *h, int vertex_no, long new_value);
 
+/* fh_insert_batch() - creates and inserts nodes representing vertices[i] with
+ * key keys[i], i = 0, 1, ..., n-1, into the heap h, melding them into the heap
+ * together.
+ */
+void fh_insert_batch(fheap_t *h, const int *vertices, const long *keys, int n);
+
 /* Debugging functions. */
 #if FHEAP_DUMP
 void fh_dump(fheap_t *h);
@@ -0,0 +1,41 @@
+/*** heap_info.c - Functions shared by all heaps providing heap_info_t. ***/
+#include "heap_info.h"
+
+
+
+/* heap_insert_batch() - inserts nodes[i] with key keys[i], i = 0, 1, ...,
+ * n-1, into the heap pointed to by heap, which uses the functions in
+ * heap_info.
+ */
+void heap_insert_batch(const heap_info_t *heap_info, void *heap,
+                       const int *nodes, const long *keys, int n)
+{
+    int i;
+
+    if(heap_info->insert_batch) {
+        heap_info->insert_batch(heap, nodes, keys, n);
+    }
+    else {
+        for(i = 0; i < n; i++) heap_info->insert(heap, nodes[i], keys[i]);
+    }
+}
+
+
+/* heap_decrease_key_batch() - decreases the key of nodes[i] to keys[i], i = 0,
+ * 1, ..., n-1, in the heap pointed to by heap, which uses the functions in
+ * heap_info.
+ */
+void heap_decrease_key_batch(const heap_info_t *heap_info, void *heap,
+                             const int *nodes, const long *keys, int n)
+{
+    int i;
+
+    if(heap_info->decrease_key_batch) {
+        heap_info->decrease_key_batch(heap, nodes, keys, n);
+    }
+    else {
+        for(i = 0; i < n; i++) {
+            heap_info->decrease_key(heap, nodes[i], keys[i]);
+        }
+    }
+}
@@ -8,8 +8,33 @@
 /*
  *  Shane Saunders
  */
+#include "../timing/opcount.h"
 
-/* Structure to be provided by heaps and used by algorithms. */
+/* Structure to be provided by heaps and used by algorithms.
+ *
+ * meld(heap, other) is optional, and is NULL for heaps which do not provide
+ * it.  It moves all items in the heap pointed to by other into the heap pointed
+ * to by heap, leaving other empty.  Both heaps must have been allocated by the
+ * same heap type, and other must still be freed by the caller.  Heaps made by
+ * alloc() never share node storage, so for them meld() is a copy: each item
+ * of other is inserted into heap, taking time proportional to the size of
+ * other.  The pairing heap's O(1) meld is only available by calling ph_meld()
+ * on heaps made with ph_alloc_shared(), which heap_info_t has no way to do.
+ *
+ * insert_batch(heap, nodes, keys, n) and decrease_key_batch(heap, nodes, keys,
+ * n) are also optional.  They have the same effect as calling insert() or
+ * decrease_key() for nodes[i] and keys[i], i = 0, 1, ..., n-1, in turn.
+ * Algorithms should call them through heap_insert_batch() and
+ * heap_decrease_key_batch(), which fall back to calling insert() or
+ * decrease_key() for each node when a heap does not provide them.  The binary,
+ * d-ary and pairing heaps provide both, and the Fibonacci heap provides
+ * insert_batch().  The 2-3, trinomial, radix, Dial, MultiQueue, sequence and
+ * dictionary heaps provide neither.
+ *
+ * counts(heap) returns the operation counts of the heap pointed to by heap.
+ * The counts are only kept when OP_COUNTS is 1; otherwise they remain zero.
+ * key_comps(heap) returns the comps field of the counts.
+ */
 typedef struct heap_info {
     int (*delete_min)(void *heap);
     void (*insert)(void *heap, int node, long key);
@@ -19,6 +44,29 @@ typedef struct heap_info {
     void *(*alloc)(int n_items);
     void (*free)(void *heap);
     void (*dump)(void *heap);
+    void (*meld)(void *heap, void *other);
+    void (*insert_batch)(void *heap, const int *nodes, const long *keys,
+                         int n);
+    void (*decrease_key_batch)(void *heap, const int *nodes, const long *keys,
+                               int n);
+    const opcount_t *(*counts)(void *heap);
 } heap_info_t;
 
+
+/*** Function prototypes. ***/
+
+/* heap_insert_batch() - inserts nodes[i] with key keys[i], i = 0, 1, ...,
+ * n-1, into the heap pointed to by heap, which uses the functions in
+ * heap_info.
+ */
+void heap_insert_batch(const heap_info_t *heap_info, void *heap,
+                       const int *nodes, const long *keys, int n);
+
+/* heap_decrease_key_batch() - decreases the key of nodes[i] to keys[i], i = 0,
+ * 1, ..., n-1, in the heap pointed to by heap, which uses the functions in
+ * heap_info.
+ */
+void heap_decrease_key_batch(const heap_info_t *heap_info, void *heap,
+                             const int *nodes, const long *keys, int n);
+
 #endif
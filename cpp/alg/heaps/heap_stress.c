@@ -0,0 +1,182 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "heap_info.h"
+#include "../timing/timing.h"
+
+/* #include all heaps to be tested. */
+#include "bheap.h"
+#include "dheap.h"
+#include "seqheap.h"
+
+
+/* This program drives each heap with the same long random sequence of
+ * operations, with a frontier that can grow much larger than the cache, and
+ * reports the CPU time taken.  The sequence has three phases:
+ *
+ * 1. Grow: max_items/2 items are inserted.
+ * 2. Steady: n_ops random operations, which are inserts, delete-mins and
+ *    decrease-keys in the ratio 2:1:1 while items remain free, as in
+ *    Dijkstra's algorithm.
+ * 3. Drain: the remaining items are deleted.
+ *
+ * Keys are never smaller than the last key deleted, so the keys deleted must
+ * be in non-decreasing order.  This is checked, and a checksum of the
+ * sequence of keys deleted is printed, which must be the same for all heaps.
+ * So that all heaps delete items in the same order, no two items have the
+ * same key: each key is a random base times max_items plus the item number.
+ *
+ * Usage: heap_stress [n_ops [max_items]]
+ */
+
+/* The range of key bases above the base of the last key deleted. */
+#define KEY_RANGE 100000
+
+/* Structure type for the heaps being tested. */
+typedef struct heapstruct {
+    char *desc;  /* Heap description (i.e. name) */
+    const heap_info_t *fns;  /* Heap functions. */
+} heapstruct_t;
+
+heapstruct_t heaps[] = {
+    { "Binary",&BHEAP_info },
+    { "d-ary",&DHEAP_info },
+    { "Sequence",&SEQHEAP_info },
+};
+
+/* State of the items used by the operation sequence.
+ * key[v] - the key of item v, while v is in the heap.
+ * items[0..n_in-1] - the items in the heap, with where[v] the index of item v.
+ * items[n_in..max_items-1] - the items not in the heap.
+ * last - the last key deleted.
+ * checksum - a checksum of the sequence of keys deleted.
+ * errors - the number of times a key deleted was smaller than the last.
+ */
+long *key;
+int *items, *where;
+int n_in, max_items;
+long last;
+unsigned long checksum;
+long errors;
+
+/* Return a random long in the range 0..range-1. */
+long rnd(long range)
+{
+    return (((long)rand() << 15) ^ rand()) % range;
+}
+
+/* Insert a free item, with a random key above the last key deleted. */
+void do_insert(const heap_info_t *fns, void *h)
+{
+    int v;
+
+    v = items[n_in];
+    key[v] = (last / max_items + 1 + rnd(KEY_RANGE)) * max_items + v;
+    fns->insert(h, v, key[v]);
+    where[v] = n_in++;
+}
+
+/* Delete the minimum item, and check its key. */
+void do_delete_min(const heap_info_t *fns, void *h)
+{
+    int v, u, i;
+
+    v = fns->delete_min(h);
+    if(key[v] < last) errors++;
+    last = key[v];
+    checksum = checksum * 31 + last;
+
+    /* Swap v with the last item in the heap, moving it to the free items. */
+    i = where[v];
+    u = items[--n_in];
+    items[i] = u;
+    where[u] = i;
+    items[n_in] = v;
+    where[v] = n_in;
+}
+
+/* Decrease the key of a random item in the heap, staying above the last key
+ * deleted.
+ */
+void do_decrease_key(const heap_info_t *fns, void *h)
+{
+    int v;
+    long k, base;
+
+    v = items[rnd(n_in)];
+    base = last / max_items + 1;
+    if(key[v] / max_items <= base) return;
+    k = (base + rnd(key[v] / max_items - base)) * max_items + v;
+    key[v] = k;
+    fns->decrease_key(h, v, k);
+}
+
+int main(int argc, char *argv[])
+{
+    long n_ops, i;
+    int j, v, r, n_heaps;
+    void *h;
+    clockval_t ticks;
+
+    n_ops = argc > 1 ? atol(argv[1]) : 10000000;
+    max_items = argc > 2 ? atoi(argv[2]) : 1000000;
+
+    key = malloc(max_items * sizeof(long));
+    items = malloc(max_items * sizeof(int));
+    where = malloc(max_items * sizeof(int));
+
+    n_heaps = sizeof(heaps)/sizeof(heapstruct_t);
+
+    printf("Heap Stress Test\n");
+    printf("Operations = %ld, Maximum items = %d\n", n_ops, max_items);
+    printf("\nHeap,\tmsec,\tcomps,\tchecksum\n");
+
+    for(j = 0; j < n_heaps; j++) {
+        srand(1);
+        for(v = 0; v < max_items; v++) {
+            items[v] = v;
+            where[v] = v;
+        }
+        n_in = 0;
+        last = 0;
+        checksum = 0;
+        errors = 0;
+
+        timer_start();
+        h = heaps[j].fns->alloc(max_items);
+
+        for(i = 0; i < max_items/2; i++) do_insert(heaps[j].fns, h);
+
+        for(i = 0; i < n_ops; i++) {
+            r = rand() & 3;
+            if(r < 2 && n_in < max_items) {
+                do_insert(heaps[j].fns, h);
+            }
+            else if(n_in > 0) {
+                if(r == 3) {
+                    do_decrease_key(heaps[j].fns, h);
+                }
+                else {
+                    do_delete_min(heaps[j].fns, h);
+                }
+            }
+        }
+
+        while(n_in > 0) do_delete_min(heaps[j].fns, h);
+
+        ticks = timer_stop();
+        printf("%s\t%.2f\t%ld\t%lx\n", heaps[j].desc,
+               ((double)ticks/CLOCK_DIV)*1000, heaps[j].fns->key_comps(h),
+               checksum);
+        if(errors) {
+            printf("%s: %ld keys deleted out of order\n", heaps[j].desc,
+                   errors);
+        }
+        heaps[j].fns->free(h);
+    }
+
+    free(key);
+    free(items);
+    free(where);
+
+    return 0;
+}
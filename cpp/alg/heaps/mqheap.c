@@ -0,0 +1,434 @@
+/*** MultiQueue Implementation ***/
+#include <stdlib.h>
+#include <sched.h>
+#include "mqheap.h"
+#if MQHEAP_DUMP
+#include <stdio.h>
+#endif
+
+
+
+/*** Atomic operations. ***/
+
+/* Atomically replace *p with new_value if it equals old_value.  Evaluates to
+ * non-zero if the replacement was made.
+ */
+#define MQ_CAS(p, old_value, new_value) \
+    __sync_bool_compare_and_swap(p, old_value, new_value)
+
+/* Atomically add x to *p. */
+#define MQ_ADD(p, x) ((void)__sync_fetch_and_add(p, x))
+
+
+
+/*** Random number state. ***/
+
+/* Each thread has its own random number state, so that threads choose queues
+ * independently.  A state of 0 means that the thread has not yet been given a
+ * seed, which is taken from mq_next_seed.
+ */
+static __thread unsigned long mq_seed = 0;
+static unsigned long mq_next_seed = 0;
+
+
+
+/*** Prototypes of functions only visible within this file. ***/
+
+int mq_random_queue(mqheap_t *h);
+mq_queue_t *mq_lock_random(mqheap_t *h);
+void mq_push(mq_queue_t *q, int v, long k);
+mq_entry_t mq_pop(mq_queue_t *q);
+
+
+
+/*** Definitions of functions visible outside of this file. ***/
+
+/* mq_alloc() - creates and returns a pointer to a MultiQueue of n_queues
+ * queues, for items (vertex numbers) 0, 1, ..., max_nodes - 1.
+ */
+mqheap_t *mq_alloc(int max_nodes, int n_queues)
+{
+    mqheap_t *h;
+    mq_queue_t *q;
+    int i;
+
+    h = malloc(sizeof(mqheap_t));
+    h->key = malloc(max_nodes * sizeof(long));
+    for(i = 0; i < max_nodes; i++) h->key[i] = MQ_NOT_IN_HEAP;
+
+    h->n_queues = n_queues;
+    h->queues = malloc(n_queues * sizeof(mq_queue_t));
+    for(i = 0; i < n_queues; i++) {
+        q = &h->queues[i];
+        pthread_mutex_init(&q->lock, NULL);
+        q->max_size = MQ_MIN_QUEUE_SIZE;
+        q->a = malloc((q->max_size + 1) * sizeof(mq_entry_t));
+        q->size = 0;
+        q->top = MQ_NOT_IN_HEAP;
+        OP_RESET(q->ops);
+    }
+
+    h->n = 0;
+    OP_RESET(h->ops);
+
+    return h;
+}
+
+
+/* mq_alloc_threads() - creates and returns a pointer to a MultiQueue for items
+ * 0, 1, ..., max_nodes - 1, with MQ_QUEUES_PER_THREAD queues for each of
+ * n_threads threads.
+ */
+mqheap_t *mq_alloc_threads(int max_nodes, int n_threads)
+{
+    return mq_alloc(max_nodes, MQ_QUEUES_PER_THREAD * n_threads);
+}
+
+
+/* mq_free() - destroys the heap pointed to by h, freeing up any space that
+ * was used by it.
+ */
+void mq_free(mqheap_t *h)
+{
+    int i;
+
+    for(i = 0; i < h->n_queues; i++) {
+        pthread_mutex_destroy(&h->queues[i].lock);
+        free(h->queues[i].a);
+    }
+    free(h->queues);
+    free((void *)h->key);
+    free(h);
+}
+
+
+/* mq_update() - inserts vertex_no with key k into the heap pointed to by h if
+ * it is not in the heap, or decreases its key to k if k is smaller than its
+ * current key.  Returns 1 if vertex_no was inserted, otherwise 0.
+ */
+int mq_update(mqheap_t *h, int vertex_no, long k)
+{
+    long old;
+    mq_queue_t *q;
+
+    /* Atomically lower the current key to k.  Once this succeeds, the entry
+     * added below is the only valid entry for vertex_no.
+     */
+    do {
+        old = h->key[vertex_no];
+        if(old <= k) return 0;
+    } while(!MQ_CAS(&h->key[vertex_no], old, k));
+
+    /* Count the item before its entry becomes visible, so that n cannot drop
+     * below zero when another thread removes it straight away.
+     */
+    if(old == MQ_NOT_IN_HEAP) MQ_ADD(&h->n, 1);
+
+    q = mq_lock_random(h);
+    mq_push(q, vertex_no, k);
+    pthread_mutex_unlock(&q->lock);
+
+    return old == MQ_NOT_IN_HEAP;
+}
+
+
+/* mq_insert() - inserts vertex_no, which is not in the heap, with key k into
+ * the heap pointed to by h.
+ */
+void mq_insert(mqheap_t *h, int vertex_no, long k)
+{
+    mq_update(h, vertex_no, k);
+}
+
+
+/* mq_delete_min() - deletes an item with a small key from the heap pointed to
+ * by h and returns its vertex number.  Returns -1 if every queue was found to
+ * be empty.
+ */
+int mq_delete_min(mqheap_t *h)
+{
+    mq_queue_t *q, *q2;
+    mq_entry_t e;
+    int i;
+
+    for(;;) {
+        /* Choose the better of two random queues.  Their tops are read
+         * without locking, so may be out of date, which only affects how good
+         * the choice is.
+         */
+        q = &h->queues[mq_random_queue(h)];
+        q2 = &h->queues[mq_random_queue(h)];
+        if(q2->top < q->top) q = q2;
+
+        /* If both look empty, fall back to the non-empty queue with the
+         * smallest top, if there is one.
+         */
+        if(q->top == MQ_NOT_IN_HEAP) {
+            for(i = 0; i < h->n_queues; i++) {
+                q2 = &h->queues[i];
+                if(q2->top < q->top) q = q2;
+            }
+            if(q->top == MQ_NOT_IN_HEAP) return -1;
+        }
+
+        /* Another thread holding the lock will change the queue anyway, so
+         * choose again rather than wait.
+         */
+        if(pthread_mutex_trylock(&q->lock) != 0) continue;
+        if(q->size == 0) {
+            pthread_mutex_unlock(&q->lock);
+            continue;
+        }
+        e = mq_pop(q);
+        pthread_mutex_unlock(&q->lock);
+
+        /* Claim the item.  This fails if the entry is stale, in which case it
+         * is discarded.
+         */
+        if(MQ_CAS(&h->key[e.vertex_no], e.key, MQ_NOT_IN_HEAP)) {
+            MQ_ADD(&h->n, -1);
+            return e.vertex_no;
+        }
+    }
+}
+
+
+/* mq_decrease_key() - decreases the key of vertex_no, which is in the heap, to
+ * new_value.
+ */
+void mq_decrease_key(mqheap_t *h, int vertex_no, long new_value)
+{
+    mq_update(h, vertex_no, new_value);
+}
+
+
+/* mq_counts() - sums the operation counts of each queue of the heap pointed
+ * to by h, and returns a pointer to the sum.
+ */
+const opcount_t *mq_counts(mqheap_t *h)
+{
+    opcount_t *ops, *sum;
+    int i;
+
+    sum = &h->ops;
+    OP_RESET(*sum);
+    for(i = 0; i < h->n_queues; i++) {
+        ops = &h->queues[i].ops;
+        sum->comps += ops->comps;
+        sum->allocs += ops->allocs;
+        sum->links += ops->links;
+        sum->restructs += ops->restructs;
+        if(ops->max_depth > sum->max_depth) sum->max_depth = ops->max_depth;
+    }
+
+    return sum;
+}
+
+
+
+/*** Definitions of functions that are only visible within this file. ***/
+
+/* mq_random_queue() - returns the index of a random queue of the heap pointed
+ * to by h, using the random number state of the calling thread.
+ */
+int mq_random_queue(mqheap_t *h)
+{
+    unsigned long x;
+
+    x = mq_seed;
+    if(x == 0) {
+        /* Spread the seeds of different threads with an odd constant. */
+        x = __sync_add_and_fetch(&mq_next_seed, 0x9e3779b9UL) | 1;
+    }
+
+    /* xorshift */
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    mq_seed = x;
+
+    return (int)((x >> 16) % h->n_queues);
+}
+
+
+/* mq_lock_random() - locks a random queue of the heap pointed to by h, and
+ * returns a pointer to it.  Queues that are already locked are skipped, unless
+ * there is only one queue.
+ */
+mq_queue_t *mq_lock_random(mqheap_t *h)
+{
+    mq_queue_t *q;
+
+    if(h->n_queues == 1) {
+        q = &h->queues[0];
+        pthread_mutex_lock(&q->lock);
+        return q;
+    }
+
+    for(;;) {
+        q = &h->queues[mq_random_queue(h)];
+        if(pthread_mutex_trylock(&q->lock) == 0) return q;
+        sched_yield();
+    }
+}
+
+
+/* mq_push() - adds an entry for item v with key k to the queue pointed to by
+ * q, which must be locked.
+ */
+void mq_push(mq_queue_t *q, int v, long k)
+{
+    mq_entry_t *a;
+    int i, p, d;
+
+    if(q->size == q->max_size) {
+        q->max_size *= 2;
+        q->a = realloc(q->a, (q->max_size + 1) * sizeof(mq_entry_t));
+        OP_ALLOC(q->ops);
+        OP_RESTRUCT(q->ops);
+    }
+    a = q->a;
+
+    /* Sift the new entry up from the bottom of the heap. */
+    i = ++q->size;
+    d = 0;
+    while(i > 1) {
+        p = i >> 1;
+        OP_COMP(q->ops);
+        if(a[p].key <= k) break;
+        a[i] = a[p];
+        OP_LINK(q->ops);
+        i = p;
+        d++;
+    }
+    a[i].key = k;
+    a[i].vertex_no = v;
+    OP_DEPTH(q->ops, d);
+
+    q->top = a[1].key;
+}
+
+
+/* mq_pop() - removes and returns the entry with the minimum key from the
+ * non-empty queue pointed to by q, which must be locked.
+ */
+mq_entry_t mq_pop(mq_queue_t *q)
+{
+    mq_entry_t *a, min, last;
+    int i, c, size, d;
+
+    a = q->a;
+    min = a[1];
+    last = a[q->size--];
+    size = q->size;
+
+    /* Sift the last entry down from the root of the heap. */
+    i = 1;
+    d = 0;
+    while((c = i << 1) <= size) {
+        if(c < size) {
+            OP_COMP(q->ops);
+            if(a[c + 1].key < a[c].key) c++;
+        }
+        OP_COMP(q->ops);
+        if(last.key <= a[c].key) break;
+        a[i] = a[c];
+        OP_LINK(q->ops);
+        i = c;
+        d++;
+    }
+    a[i] = last;
+    OP_DEPTH(q->ops, d);
+
+    q->top = size > 0 ? a[1].key : MQ_NOT_IN_HEAP;
+
+    return min;
+}
+
+
+
+/*** Debugging functions ***/
+
+/* Print out the entries of each queue of a MultiQueue, marking stale entries
+ * with a '*'.
+ */
+#if MQHEAP_DUMP
+void mq_dump(mqheap_t *h)
+{
+    mq_queue_t *q;
+    int i, j;
+
+    printf("\nn = %d, n_queues = %d\n", h->n, h->n_queues);
+    for(i = 0; i < h->n_queues; i++) {
+        q = &h->queues[i];
+        printf("queue %d:", i);
+        for(j = 1; j <= q->size; j++) {
+            printf(" %d(%ld)%s", q->a[j].vertex_no, q->a[j].key,
+                   h->key[q->a[j].vertex_no] == q->a[j].key ? "" : "*");
+        }
+        putchar('\n');
+    }
+    fflush(stdout);
+}
+#endif
+
+
+/*** Implement the univeral heap structure type ***/
+
+/* MultiQueue wrapper functions. */
+
+int _mq_delete_min(void *h) {
+    return mq_delete_min((mqheap_t *)h);
+}
+
+void _mq_insert(void *h, int v, long k) {
+    mq_insert((mqheap_t *)h, v, k);
+}
+
+void _mq_decrease_key(void *h, int v, long k) {
+    mq_decrease_key((mqheap_t *)h, v, k);
+}
+
+int _mq_n(void *h) {
+    return ((mqheap_t *)h)->n;
+}
+
+long _mq_key_comps(void *h) {
+    return mq_counts((mqheap_t *)h)->comps;
+}
+
+const opcount_t *_mq_counts(void *h) {
+    return mq_counts((mqheap_t *)h);
+}
+
+void *_mq_alloc(int n) {
+    return mq_alloc(n, 1);
+}
+
+void _mq_free(void *h) {
+    mq_free((mqheap_t *)h);
+}
+
+void _mq_dump(void *h) {
+#if MQHEAP_DUMP
+    mq_dump((mqheap_t *)h);
+#endif
+}
+
+/* MultiQueue info.  A single queue is used, so that delete_min() always
+ * removes the item with the minimum key.
+ */
+const heap_info_t MQHEAP_info = {
+    _mq_delete_min,
+    _mq_insert,
+    _mq_decrease_key,
+    _mq_n,
+    _mq_key_comps,
+    _mq_alloc,
+    _mq_free,
+    _mq_dump,
+    NULL,
+    NULL,
+    NULL,
+    _mq_counts
+};
@@ -0,0 +1,166 @@
+#ifndef MQHEAP_H
+#define MQHEAP_H
+/*** Header File for the MultiQueue Implementation ***/
+#include <limits.h>
+#include <pthread.h>
+#include "heap_info.h"  /* Defines the uiversal heap structure type. */
+
+/* A MultiQueue is a relaxed concurrent priority queue.  It consists of a
+ * number of sequential binary heaps, called queues, each protected by its own
+ * lock.  Insertions go into a randomly chosen queue.  delete_min() samples two
+ * queues at random and removes the minimum item from the one whose minimum is
+ * smaller.  Any number of threads may use the heap at the same time.  With
+ * more than one queue the item removed is only close to the minimum, rather
+ * than exactly the minimum, so a MultiQueue suits label-correcting algorithms
+ * such as par_dijkstra() (see ../graphalg/da.h).  With a single queue it is an
+ * ordinary binary heap, and this is what the universal heap structure type,
+ * MQHEAP_info, allocates.
+ *
+ * Decreasing the key of an item does not move it within its queue.  Instead a
+ * new entry with the smaller key is inserted into a random queue, and the old
+ * entry is discarded when it is later removed.  The current key of each item
+ * is kept in an array shared by all queues, which is only changed with atomic
+ * compare-and-swap operations.  An entry is valid while its key matches the
+ * current key of its item.  delete_min() removes an item by atomically
+ * replacing its current key with MQ_NOT_IN_HEAP, so each item is removed by
+ * exactly one thread.
+ *
+ * The atomic operations use the GCC __sync builtins, and the random number
+ * state of each thread uses GCC's __thread storage class.
+ */
+
+
+/*** Compile Time Options ***/
+
+/* The number of queues to allocate for each thread by mq_alloc_threads().  At
+ * least 2 keeps lock contention low.
+ */
+#define MQ_QUEUES_PER_THREAD 2
+
+/* The initial number of entries each queue has space for.  The space is
+ * doubled whenever a queue becomes full.
+ */
+#define MQ_MIN_QUEUE_SIZE 64
+
+/* The size of a cache line.  Each queue is padded by this many bytes so that
+ * queues used by different threads do not share a cache line.
+ */
+#define MQ_CACHE_LINE 64
+
+/* Option to print debugging information.  Use 1 for yes, or 0 for no. */
+#define MQHEAP_DUMP 0
+
+
+
+/*** Special Values ***/
+
+/* The current key of an item that is not in the heap, and the minimum key of
+ * an empty queue.  Keys must be smaller than this.
+ */
+#define MQ_NOT_IN_HEAP LONG_MAX
+
+
+
+/*** Structure Types ***/
+
+/* An entry in one of the queues.  The entry is stale if key is no longer the
+ * current key of item vertex_no.
+ */
+typedef struct mq_entry {
+    long key;
+    int vertex_no;
+} mq_entry_t;
+
+/* A queue of a MultiQueue.
+ * lock - protects all other fields, except that top may be read without it.
+ * a - a binary heap a[1..size] of entries, of space for max_size entries.
+ * top - the key of a[1], or MQ_NOT_IN_HEAP if the queue is empty.
+ * ops - counts the operations performed on this queue.
+ */
+typedef struct mq_queue {
+    pthread_mutex_t lock;
+    mq_entry_t *a;
+    int size, max_size;
+    volatile long top;
+    opcount_t ops;
+    char pad[MQ_CACHE_LINE];
+} mq_queue_t;
+
+/* The structure type for a MultiQueue.
+ * queues - the array of n_queues queues.
+ * key - key[v] is the current key of item v, or MQ_NOT_IN_HEAP.
+ * n - the current number of items in the heap.
+ * ops - counts the operations performed on the heap, for experimental
+ *       purposes.  See opcount.h.  These are summed from the counts of each
+ *       queue by mq_counts().
+ */
+typedef struct mqheap {
+    mq_queue_t *queues;
+    int n_queues;
+    volatile long *key;
+    volatile int n;
+    opcount_t ops;
+} mqheap_t;
+
+
+
+/*** Function prototypes. ***/
+
+/* mq_alloc() - creates and returns a pointer to a MultiQueue of n_queues
+ * queues, for items (vertex numbers) 0, 1, ..., max_nodes - 1.
+ */
+mqheap_t *mq_alloc(int max_nodes, int n_queues);
+
+/* mq_alloc_threads() - creates and returns a pointer to a MultiQueue for items
+ * 0, 1, ..., max_nodes - 1, with MQ_QUEUES_PER_THREAD queues for each of
+ * n_threads threads.
+ */
+mqheap_t *mq_alloc_threads(int max_nodes, int n_threads);
+
+/* mq_free() - destroys the heap pointed to by h, freeing up any space that
+ * was used by it.
+ */
+void mq_free(mqheap_t *h);
+
+/* mq_update() - inserts vertex_no with key k into the heap pointed to by h if
+ * it is not in the heap, or decreases its key to k if k is smaller than its
+ * current key.  Returns 1 if vertex_no was inserted, otherwise 0.  Unlike
+ * mq_insert() and mq_decrease_key(), this may be used when other threads may
+ * insert or remove vertex_no at the same time.
+ */
+int mq_update(mqheap_t *h, int vertex_no, long k);
+
+/* mq_insert() - inserts vertex_no, which is not in the heap, with key k into
+ * the heap pointed to by h.
+ */
+void mq_insert(mqheap_t *h, int vertex_no, long k);
+
+/* mq_delete_min() - deletes an item with a small key from the heap pointed to
+ * by h and returns its vertex number.  The key is the minimum when the heap
+ * has a single queue.  Returns -1 if every queue was found to be empty, which
+ * can only happen when other threads are using the heap at the same time or
+ * the heap is empty.
+ */
+int mq_delete_min(mqheap_t *h);
+
+/* mq_decrease_key() - decreases the key of vertex_no, which is in the heap, to
+ * new_value.
+ */
+void mq_decrease_key(mqheap_t *h, int vertex_no, long new_value);
+
+/* mq_counts() - sums the operation counts of each queue of the heap pointed
+ * to by h, and returns a pointer to the sum.  Must not be called while other
+ * threads are using the heap.
+ */
+const opcount_t *mq_counts(mqheap_t *h);
+
+/* Debugging functions. */
+#if MQHEAP_DUMP
+void mq_dump(mqheap_t *h);
+#endif
+
+
+/*** Alternative interface via the universal heap structure type. ***/
+extern const heap_info_t MQHEAP_info;
+
+#endif
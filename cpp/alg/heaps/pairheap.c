@@ -0,0 +1,407 @@
+/*** Pairing Heap Implementation ***/
+#include <stdlib.h>
+#include "pairheap.h"
+#if PAIRHEAP_DUMP
+#include <stdio.h>
+#endif
+
+
+
+/*** Prototypes of functions only visible within this file. ***/
+
+pairheap_node_t *ph_link(pairheap_t *h, pairheap_node_t *a,
+                         pairheap_node_t *b);
+pairheap_node_t *ph_combine(pairheap_t *h, pairheap_node_t *first);
+void ph_cut(pairheap_node_t *node);
+
+
+
+/*** Definitions of functions visible outside of this file. ***/
+
+/* ph_alloc() - creates and returns a pointer to a pairing heap for vertices
+ * 0, 1, ..., max_nodes - 1.
+ */
+pairheap_t *ph_alloc(int max_nodes)
+{
+    pairheap_t *h;
+
+    h = malloc(sizeof(pairheap_t));
+    h->nodes = malloc(max_nodes * sizeof(pairheap_node_t));
+    h->n_sharing = malloc(sizeof(int));
+    *h->n_sharing = 1;
+    h->max_nodes = max_nodes;
+    h->root = NULL;
+    h->n = 0;
+    OP_RESET(h->ops);
+
+    return h;
+}
+
+
+/* ph_alloc_shared() - creates and returns a pointer to an empty pairing heap
+ * which shares the node slab of the heap pointed to by h.  The two heaps can
+ * then be melded in O(1) time.
+ */
+pairheap_t *ph_alloc_shared(pairheap_t *h)
+{
+    pairheap_t *new;
+
+    new = malloc(sizeof(pairheap_t));
+    new->nodes = h->nodes;
+    new->n_sharing = h->n_sharing;
+    (*new->n_sharing)++;
+    new->max_nodes = h->max_nodes;
+    new->root = NULL;
+    new->n = 0;
+    OP_RESET(new->ops);
+
+    return new;
+}
+
+
+/* ph_free() - destroys the heap pointed to by h, freeing up any space that was
+ * used by it.  The slab is freed with the last heap sharing it.
+ */
+void ph_free(pairheap_t *h)
+{
+    if(--(*h->n_sharing) == 0) {
+        free(h->nodes);
+        free(h->n_sharing);
+    }
+    free(h);
+}
+
+
+/* ph_insert() - inserts vertex_no with key k into the heap pointed to by h.
+ */
+void ph_insert(pairheap_t *h, int vertex_no, long k)
+{
+    pairheap_node_t *new;
+
+    new = &h->nodes[vertex_no];
+    new->child = new->sibling = new->prev = NULL;
+    new->key = k;
+    new->vertex_no = vertex_no;
+
+    h->root = h->root ? ph_link(h, h->root, new) : new;
+    h->n++;
+}
+
+
+/* ph_delete_min() - deletes the minimum node from the heap pointed to by h and
+ * returns its vertex number.
+ */
+int ph_delete_min(pairheap_t *h)
+{
+    pairheap_node_t *min_node;
+
+    min_node = h->root;
+    h->root = ph_combine(h, min_node->child);
+    h->n--;
+
+    return min_node->vertex_no;
+}
+
+
+/* ph_decrease_key() - decreases the key used for vertex, vertex_no, to
+ * new_value.  No check is made to ensure that new_value is in-fact less than
+ * the current value so it is up to the user of this function to ensure that
+ * it is.
+ */
+void ph_decrease_key(pairheap_t *h, int vertex_no, long new_value)
+{
+    pairheap_node_t *node;
+
+    node = &h->nodes[vertex_no];
+    node->key = new_value;
+
+    /* The root stays where it is.  Any other node is cut from its parent, along
+     * with its subtree, and linked with the root.
+     */
+    if(node == h->root) return;
+    ph_cut(node);
+    OP_LINK(h->ops);  /* The cut.  ph_link() counts the link that follows. */
+    h->root = ph_link(h, h->root, node);
+}
+
+
+/* ph_insert_batch() - inserts vertices[i] with key keys[i], i = 0, 1, ...,
+ * n-1, into the heap pointed to by h.  The new nodes are combined into a
+ * single tree before being linked with the root.
+ */
+void ph_insert_batch(pairheap_t *h, const int *vertices, const long *keys,
+                     int n)
+{
+    pairheap_node_t *new, *list;
+    int i;
+
+    if(n == 0) return;
+
+    /* Make a list of the new nodes, linked by sibling pointers. */
+    list = NULL;
+    for(i = n - 1; i >= 0; i--) {
+        new = &h->nodes[vertices[i]];
+        new->child = new->prev = NULL;
+        new->sibling = list;
+        new->key = keys[i];
+        new->vertex_no = vertices[i];
+        list = new;
+    }
+
+    list = ph_combine(h, list);
+    h->root = h->root ? ph_link(h, h->root, list) : list;
+    h->n += n;
+}
+
+
+/* ph_decrease_key_batch() - decreases the key of vertices[i] to keys[i], i = 0,
+ * 1, ..., n-1.  All of the cut subtrees are combined into a single tree before
+ * being linked with the root.
+ */
+void ph_decrease_key_batch(pairheap_t *h, const int *vertices,
+                           const long *keys, int n)
+{
+    pairheap_node_t *node, *list;
+    int i;
+
+    /* Cut each decreased node from its parent, and add it to a list linked by
+     * sibling pointers.  Nodes in the list have no prev pointer, so a node
+     * which is decreased twice is only cut once.
+     */
+    list = NULL;
+    for(i = 0; i < n; i++) {
+        node = &h->nodes[vertices[i]];
+        node->key = keys[i];
+        if(node == h->root || !node->prev) continue;
+        ph_cut(node);
+        OP_LINK(h->ops);  /* The cut. */
+        node->sibling = list;
+        list = node;
+    }
+
+    if(list) h->root = ph_link(h, h->root, ph_combine(h, list));
+}
+
+
+/* ph_meld() - moves all nodes in the heap pointed to by other into the heap
+ * pointed to by h, leaving other empty.
+ */
+void ph_meld(pairheap_t *h, pairheap_t *other)
+{
+    pairheap_node_t *stack, *node, *child, *next;
+
+    if(!other->root) return;
+
+    if(h->nodes == other->nodes) {
+        /* The nodes are already in the right place, so the two roots are
+         * linked.
+         */
+        h->root = h->root ? ph_link(h, h->root, other->root) : other->root;
+        h->n += other->n;
+    }
+    else {
+        /* Each node of other is inserted into h.  The sibling pointers of
+         * other's nodes are used as a stack for visiting its nodes.
+         */
+        stack = other->root;
+        while(stack) {
+            node = stack;
+            stack = node->sibling;
+            for(child = node->child; child; child = next) {
+                next = child->sibling;
+                child->sibling = stack;
+                stack = child;
+            }
+            ph_insert(h, node->vertex_no, node->key);
+        }
+    }
+
+    other->root = NULL;
+    other->n = 0;
+}
+
+
+
+/*** Definitions of functions that are only visible within this file. ***/
+
+/* ph_link() - links the two trees with roots a and b, making the root with the
+ * larger key the leftmost child of the other.  Returns the root of the
+ * resulting tree.  The sibling pointer of the returned root is unchanged.
+ */
+pairheap_node_t *ph_link(pairheap_t *h, pairheap_node_t *a,
+                         pairheap_node_t *b)
+{
+    pairheap_node_t *temp;
+
+    OP_COMP(h->ops);
+    if(b->key < a->key) {
+        temp = a;
+        a = b;
+        b = temp;
+    }
+
+    b->prev = a;
+    b->sibling = a->child;
+    if(a->child) a->child->prev = b;
+    a->child = b;
+    OP_LINK(h->ops);
+    OP_RESTRUCT(h->ops);
+
+    return a;
+}
+
+
+/* ph_combine() - combines the list of sibling trees starting with first into
+ * a single tree, using the two-pass method, and returns its root.  The length
+ * of the list is counted as the depth of the operation.
+ */
+pairheap_node_t *ph_combine(pairheap_t *h, pairheap_node_t *first)
+{
+    pairheap_node_t *a, *next, *list;
+    int d;
+
+    if(!first) return NULL;
+
+    /* First pass: link trees in pairs from left to right.  The resulting trees
+     * are kept in a list, linked by sibling pointers, in reverse order.
+     */
+    list = NULL;
+    d = 0;
+    while(first) {
+        a = first;
+        next = NULL;
+        if(a->sibling) {
+            next = a->sibling->sibling;
+            a = ph_link(h, a, a->sibling);
+            d++;
+        }
+        a->sibling = list;
+        list = a;
+        first = next;
+        d++;
+    }
+    OP_DEPTH(h->ops, d);
+
+    /* Second pass: link the trees from right to left. */
+    a = list;
+    list = list->sibling;
+    while(list) {
+        next = list->sibling;
+        a = ph_link(h, a, list);
+        list = next;
+    }
+
+    a->sibling = a->prev = NULL;
+    return a;
+}
+
+
+/* ph_cut() - removes the tree rooted at node from its parent's child list. */
+void ph_cut(pairheap_node_t *node)
+{
+    if(node->prev->child == node) {
+        node->prev->child = node->sibling;
+    }
+    else {
+        node->prev->sibling = node->sibling;
+    }
+    if(node->sibling) node->sibling->prev = node->prev;
+    node->sibling = node->prev = NULL;
+}
+
+
+
+/*** Debugging functions ***/
+
+/* Recursively print the nodes of a pairing heap. */
+#if PAIRHEAP_DUMP
+void ph_dump_nodes(pairheap_node_t *ptr, int level)
+{
+    int i;
+
+    for(; ptr; ptr = ptr->sibling) {
+        for(i = 0; i < level; i++) printf("   ");
+        printf("%d(%ld)\n", ptr->vertex_no, ptr->key);
+        ph_dump_nodes(ptr->child, level + 1);
+    }
+}
+
+/* Print out a pairing heap. */
+void ph_dump(pairheap_t *h)
+{
+    printf("\nn = %d\n", h->n);
+    ph_dump_nodes(h->root, 0);
+    fflush(stdout);
+}
+#endif
+
+
+/*** Implement the univeral heap structure type ***/
+
+/* Pairing heap wrapper functions. */
+
+int _ph_delete_min(void *h) {
+    return ph_delete_min((pairheap_t *)h);
+}
+
+void _ph_insert(void *h, int v, long k) {
+    ph_insert((pairheap_t *)h, v, k);
+}
+
+void _ph_decrease_key(void *h, int v, long k) {
+    ph_decrease_key((pairheap_t *)h, v, k);
+}
+
+int _ph_n(void *h) {
+    return ((pairheap_t *)h)->n;
+}
+
+long _ph_key_comps(void *h) {
+    return ((pairheap_t *)h)->ops.comps;
+}
+
+const opcount_t *_ph_counts(void *h) {
+    return &((pairheap_t *)h)->ops;
+}
+
+void *_ph_alloc(int n) {
+    return ph_alloc(n);
+}
+
+void _ph_free(void *h) {
+    ph_free((pairheap_t *)h);
+}
+
+void _ph_dump(void *h) {
+#if PAIRHEAP_DUMP
+    ph_dump((pairheap_t *)h);
+#endif
+}
+
+void _ph_meld(void *h, void *other) {
+    ph_meld((pairheap_t *)h, (pairheap_t *)other);
+}
+
+void _ph_insert_batch(void *h, const int *v, const long *k, int n) {
+    ph_insert_batch((pairheap_t *)h, v, k, n);
+}
+
+void _ph_decrease_key_batch(void *h, const int *v, const long *k, int n) {
+    ph_decrease_key_batch((pairheap_t *)h, v, k, n);
+}
+
+/* Pairing heap info. */
+const heap_info_t PAIRHEAP_info = {
+    _ph_delete_min,
+    _ph_insert,
+    _ph_decrease_key,
+    _ph_n,
+    _ph_key_comps,
+    _ph_alloc,
+    _ph_free,
+    _ph_dump,
+    _ph_meld,
+    _ph_insert_batch,
+    _ph_decrease_key_batch,
+    _ph_counts
+};
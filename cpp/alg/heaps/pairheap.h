@@ -0,0 +1,126 @@
+#ifndef PAIRHEAP_H
+#define PAIRHEAP_H
+/*** Header File for the Pairing Heap Implementation ***/
+#include "heap_info.h"  /* Defines the uiversal heap structure type. */
+
+/* This is a two-pass pairing heap.  Each tree is heap ordered, and the
+ * children of a node are kept in a doubly linked list, from the most recently
+ * linked child to the least.  delete_min() links the children of the root in
+ * pairs from left to right, then links the resulting trees from right to left.
+ *
+ * Nodes are stored in a slab indexed by vertex number.  Several heaps can
+ * share one slab by creating them with ph_alloc_shared(), provided that no
+ * vertex is in more than one of the heaps at a time.  Melding two heaps that
+ * share a slab takes O(1) time.  Melding heaps which do not share a slab takes
+ * time proportional to the size of the heap being melded in.
+ */
+
+
+/*** Option to print debugging information.  Use 1 for yes, or 0 for no. ***/
+#define PAIRHEAP_DUMP 0
+
+
+
+/*** Structure Types ***/
+
+/* The structure type for pairing heap nodes.
+ *
+ * child   - points to the first (leftmost) child of the node.
+ * sibling - points to the next sibling to the right of the node.
+ * prev    - points to the previous sibling to the left of the node, or the
+ *           parent if the node is the leftmost child.  NULL for the root.
+ * key     - the nodes key.
+ * vertex_no - the number of the graph vertex that the node corresponds to.
+ */
+typedef struct pairheap_node {
+    struct pairheap_node *child;
+    struct pairheap_node *sibling;
+    struct pairheap_node *prev;
+    long key;
+    int vertex_no;
+} pairheap_node_t;
+
+/* The structure type for a pairing heap.
+ *
+ * root  - points to the root node, which has the minimum key, or NULL if the
+ *         heap is empty.
+ * nodes - the slab of nodes, indexed by vertex number.
+ * n_sharing - points to a count of the number of heaps sharing the slab.
+ * max_nodes - the number of nodes in the slab.
+ * n     - the current number of nodes in the heap.
+ * ops - counts the operations performed on the heap, for experimental
+ *       purposes.  See opcount.h.
+ */
+typedef struct pairheap {
+    pairheap_node_t *root;
+    pairheap_node_t *nodes;
+    int *n_sharing;
+    int max_nodes, n;
+    opcount_t ops;
+} pairheap_t;
+
+
+
+/*** Function prototypes. ***/
+
+/* ph_alloc() - creates and returns a pointer to a pairing heap for vertices
+ * 0, 1, ..., max_nodes - 1.
+ */
+pairheap_t *ph_alloc(int max_nodes);
+
+/* ph_alloc_shared() - creates and returns a pointer to an empty pairing heap
+ * which shares the node slab of the heap pointed to by h.  The two heaps can
+ * then be melded in O(1) time.
+ */
+pairheap_t *ph_alloc_shared(pairheap_t *h);
+
+/* ph_free() - destroys the heap pointed to by h, freeing up any space that was
+ * used by it.  The slab is freed with the last heap sharing it.
+ */
+void ph_free(pairheap_t *h);
+
+/* ph_insert() - inserts vertex_no with key k into the heap pointed to by h.
+ */
+void ph_insert(pairheap_t *h, int vertex_no, long k);
+
+/* ph_delete_min() - deletes the minimum node from the heap pointed to by h and
+ * returns its vertex number.
+ */
+int ph_delete_min(pairheap_t *h);
+
+/* ph_decrease_key() - decreases the key used for vertex, vertex_no, to
+ * new_value.  No check is made to ensure that new_value is in-fact less than
+ * the current value so it is up to the user of this function to ensure that
+ * it is.
+ */
+void ph_decrease_key(pairheap_t *h, int vertex_no, long new_value);
+
+/* ph_insert_batch() - inserts vertices[i] with key keys[i], i = 0, 1, ...,
+ * n-1, into the heap pointed to by h.  The new nodes are combined into a
+ * single tree before being linked with the root.
+ */
+void ph_insert_batch(pairheap_t *h, const int *vertices, const long *keys,
+                     int n);
+
+/* ph_decrease_key_batch() - decreases the key of vertices[i] to keys[i], i = 0,
+ * 1, ..., n-1.  All of the cut subtrees are combined into a single tree before
+ * being linked with the root.
+ */
+void ph_decrease_key_batch(pairheap_t *h, const int *vertices,
+                           const long *keys, int n);
+
+/* ph_meld() - moves all nodes in the heap pointed to by other into the heap
+ * pointed to by h, leaving other empty.
+ */
+void ph_meld(pairheap_t *h, pairheap_t *other);
+
+/* Debugging functions. */
+#if PAIRHEAP_DUMP
+void ph_dump(pairheap_t *h);
+#endif
+
+
+/*** Alternative interface via the universal heap structure type. ***/
+extern const heap_info_t PAIRHEAP_info;
+
+#endif
@@ -0,0 +1,100 @@
+/*** File: pairheap_test.c - Test program for melding pairing heaps ***/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "pairheap.h"
+
+
+/* This program checks ph_meld() both ways it can work.  Two heaps made by
+ * ph_alloc() are melded through PAIRHEAP_info, which copies the nodes of one
+ * heap into the slab of the other, and two heaps sharing a slab, made by
+ * ph_alloc_shared(), are melded by ph_meld() directly, which links their
+ * roots.  Before each meld, the vertices are split between the two heaps and
+ * some keys are decreased in both.  The melded heap is then emptied with
+ * delete_min(), and every vertex must come out once, in order of key.
+ */
+
+#define N_ITEMS 1000
+#define RND_MAX 100000
+
+
+/* key[v] - the key of vertex v. */
+long key[N_ITEMS];
+
+
+/* Insert the vertices into h and other, alternately, with random keys, and
+ * then decrease the keys of every third vertex.  The heaps are used through
+ * the functions of fns.
+ */
+void fill(const heap_info_t *fns, void *h, void *other)
+{
+    int v;
+
+    for(v = 0; v < N_ITEMS; v++) {
+        key[v] = rand() % RND_MAX;
+        fns->insert(v % 2 ? other : h, v, key[v]);
+    }
+    for(v = 0; v < N_ITEMS; v += 3) {
+        key[v] /= 2;
+        fns->decrease_key(v % 2 ? other : h, v, key[v]);
+    }
+}
+
+/* Empty the heap h, checking that each vertex is deleted once, in order of
+ * key, and that other is empty.  Returns 0 if so, and 1 otherwise.
+ */
+int drain(const heap_info_t *fns, void *h, void *other)
+{
+    char seen[N_ITEMS];
+    long last;
+    int i, v;
+
+    if(fns->n(h) != N_ITEMS || fns->n(other) != 0) return 1;
+    for(v = 0; v < N_ITEMS; v++) seen[v] = 0;
+    last = -1;
+    for(i = 0; i < N_ITEMS; i++) {
+        v = fns->delete_min(h);
+        if(v < 0 || v >= N_ITEMS || seen[v] || key[v] < last) return 1;
+        seen[v] = 1;
+        last = key[v];
+    }
+
+    return fns->n(h) != 0;
+}
+
+
+int main(void)
+{
+    const heap_info_t *fns = &PAIRHEAP_info;
+    pairheap_t *h, *other;
+    int errors, e;
+
+    errors = 0;
+    srand(1);
+
+    /* Separate slabs, melded through heap_info_t. */
+    printf("Testing meld of heaps from ph_alloc()...");
+    h = fns->alloc(N_ITEMS);
+    other = fns->alloc(N_ITEMS);
+    fill(fns, h, other);
+    fns->meld(h, other);
+    e = drain(fns, h, other);
+    printf("%s\n", e ? "failed." : "successful.");
+    errors += e;
+    fns->free(other);
+    fns->free(h);
+
+    /* One shared slab. */
+    printf("Testing meld of heaps from ph_alloc_shared()...");
+    h = ph_alloc(N_ITEMS);
+    other = ph_alloc_shared(h);
+    fill(fns, h, other);
+    ph_meld(h, other);
+    e = drain(fns, h, other);
+    printf("%s\n", e ? "failed." : "successful.");
+    errors += e;
+    ph_free(other);
+    ph_free(h);
+
+    return errors != 0;
+}
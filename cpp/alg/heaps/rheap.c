@@ -0,0 +1,277 @@
+/*** Radix Heap Implementation ***/
+#include <stdlib.h>
+#include "rheap.h"
+#if RHEAP_DUMP
+#include <stdio.h>
+#endif
+
+
+
+/*** Prototypes of functions only visible within this file. ***/
+
+int rh_bucket_no(long last, long k);
+void rh_add(rheap_t *h, int v, int b);
+void rh_remove(rheap_t *h, int v);
+
+
+
+/*** Definitions of functions visible outside of this file. ***/
+
+/* rh_alloc() - creates and returns a pointer to a radix heap for items
+ * (vertex numbers) 0, 1, ..., max_nodes - 1.
+ */
+rheap_t *rh_alloc(int max_nodes)
+{
+    rheap_t *h;
+    int i;
+
+    h = malloc(sizeof(rheap_t));
+    h->key = malloc(max_nodes * sizeof(long));
+    h->bucket = malloc(max_nodes * sizeof(int));
+    h->next = malloc(max_nodes * sizeof(int));
+    h->prev = malloc(max_nodes * sizeof(int));
+    for(i = 0; i < RHEAP_BUCKETS; i++) h->head[i] = -1;
+
+    h->last = 0;
+    h->n = 0;
+    OP_RESET(h->ops);
+
+    return h;
+}
+
+
+/* rh_free() - destroys the heap pointed to by h, freeing up any space that
+ * was used by it.
+ */
+void rh_free(rheap_t *h)
+{
+    free(h->key);
+    free(h->bucket);
+    free(h->next);
+    free(h->prev);
+    free(h);
+}
+
+
+/* rh_insert() - inserts vertex_no with key k into the heap pointed to by h.
+ * The key k must be no smaller than the last key removed from the heap.
+ */
+void rh_insert(rheap_t *h, int vertex_no, long k)
+{
+    h->key[vertex_no] = k;
+    rh_add(h, vertex_no, rh_bucket_no(h->last, k));
+    h->n++;
+}
+
+
+/* rh_delete_min() - deletes the item with the minimum key from the heap
+ * pointed to by h and returns its vertex number.
+ */
+int rh_delete_min(rheap_t *h)
+{
+    int b, v, next;
+    long min_key;
+    int *head;
+
+    head = h->head;
+
+    /* If no item has a key equal to the last key removed, the lowest
+     * non-empty bucket is emptied into lower buckets, relative to its minimum
+     * key.
+     */
+    if(head[0] < 0) {
+        b = 1;
+        while(head[b] < 0) b++;
+
+        /* Find the minimum key in bucket b. */
+        v = head[b];
+        min_key = h->key[v];
+        for(v = h->next[v]; v >= 0; v = h->next[v]) {
+            OP_COMP(h->ops);
+            if(h->key[v] < min_key) min_key = h->key[v];
+        }
+
+        /* Redistribute the items in bucket b.  Every item goes to a lower
+         * bucket, since all keys in bucket b agree with min_key above bit
+         * b-1.
+         */
+        OP_RESTRUCT(h->ops);
+        OP_DEPTH(h->ops, b);
+        h->last = min_key;
+        v = head[b];
+        head[b] = -1;
+        while(v >= 0) {
+            next = h->next[v];
+            rh_add(h, v, rh_bucket_no(min_key, h->key[v]));
+            v = next;
+        }
+    }
+
+    /* Any item in bucket 0 has the minimum key. */
+    v = head[0];
+    rh_remove(h, v);
+    h->n--;
+
+    return v;
+}
+
+
+/* rh_decrease_key() - decreases the key of vertex_no to new_value.  The new
+ * value must be no smaller than the last key removed from the heap.
+ */
+void rh_decrease_key(rheap_t *h, int vertex_no, long new_value)
+{
+    int b;
+
+    h->key[vertex_no] = new_value;
+
+    /* The item only needs to move if its bucket has changed. */
+    b = rh_bucket_no(h->last, new_value);
+    if(b != h->bucket[vertex_no]) {
+        rh_remove(h, vertex_no);
+        rh_add(h, vertex_no, b);
+    }
+}
+
+
+
+/*** Definitions of functions that are only visible within this file. ***/
+
+/* rh_bucket_no() - returns the bucket number for key k, relative to the last
+ * key removed.  This is 0 if k equals last, or otherwise one more than the
+ * position of the highest bit in which k and last differ.
+ */
+int rh_bucket_no(long last, long k)
+{
+    unsigned long x;
+    int b;
+
+    x = (unsigned long)k ^ (unsigned long)last;
+    if(!x) return 0;
+
+#if defined(__GNUC__)
+    b = 8 * sizeof(long) - __builtin_clzl(x);
+#else
+    b = 0;
+    while(x) {
+        x >>= 1;
+        b++;
+    }
+#endif
+
+    return b;
+}
+
+
+/* rh_add() - adds item v to the front of bucket b. */
+void rh_add(rheap_t *h, int v, int b)
+{
+    int first;
+
+    first = h->head[b];
+    h->next[v] = first;
+    h->prev[v] = -1;
+    if(first >= 0) h->prev[first] = v;
+    h->head[b] = v;
+    h->bucket[v] = b;
+    OP_LINK(h->ops);
+}
+
+
+/* rh_remove() - removes item v from its bucket. */
+void rh_remove(rheap_t *h, int v)
+{
+    int next, prev;
+
+    next = h->next[v];
+    prev = h->prev[v];
+    if(prev >= 0) {
+        h->next[prev] = next;
+    }
+    else {
+        h->head[h->bucket[v]] = next;
+    }
+    if(next >= 0) h->prev[next] = prev;
+}
+
+
+
+/*** Debugging functions ***/
+
+/* Print out the items in each non-empty bucket of a radix heap. */
+#if RHEAP_DUMP
+void rh_dump(rheap_t *h)
+{
+    int b, v;
+
+    printf("\nlast = %ld, n = %d\n", h->last, h->n);
+    for(b = 0; b < RHEAP_BUCKETS; b++) {
+        if(h->head[b] < 0) continue;
+        printf("bucket %d:", b);
+        for(v = h->head[b]; v >= 0; v = h->next[v]) {
+            printf(" %d(%ld)", v, h->key[v]);
+        }
+        putchar('\n');
+    }
+    fflush(stdout);
+}
+#endif
+
+
+/*** Implement the univeral heap structure type ***/
+
+/* Radix heap wrapper functions. */
+
+int _rh_delete_min(void *h) {
+    return rh_delete_min((rheap_t *)h);
+}
+
+void _rh_insert(void *h, int v, long k) {
+    rh_insert((rheap_t *)h, v, k);
+}
+
+void _rh_decrease_key(void *h, int v, long k) {
+    rh_decrease_key((rheap_t *)h, v, k);
+}
+
+int _rh_n(void *h) {
+    return ((rheap_t *)h)->n;
+}
+
+long _rh_key_comps(void *h) {
+    return ((rheap_t *)h)->ops.comps;
+}
+
+const opcount_t *_rh_counts(void *h) {
+    return &((rheap_t *)h)->ops;
+}
+
+void *_rh_alloc(int n) {
+    return rh_alloc(n);
+}
+
+void _rh_free(void *h) {
+    rh_free((rheap_t *)h);
+}
+
+void _rh_dump(void *h) {
+#if RHEAP_DUMP
+    rh_dump((rheap_t *)h);
+#endif
+}
+
+/* Radix heap info. */
+const heap_info_t RHEAP_info = {
+    _rh_delete_min,
+    _rh_insert,
+    _rh_decrease_key,
+    _rh_n,
+    _rh_key_comps,
+    _rh_alloc,
+    _rh_free,
+    _rh_dump,
+    NULL,
+    NULL,
+    NULL,
+    _rh_counts
+};
@@ -0,0 +1,95 @@
+#ifndef RHEAP_H
+#define RHEAP_H
+/*** Header File for the Radix Heap Implementation ***/
+#include "heap_info.h"  /* Defines the uiversal heap structure type. */
+
+/* A radix heap is a monotone priority queue for non-negative integer keys.
+ * The key of every item inserted, and every new key given to decrease_key(),
+ * must be no smaller than the key of the item most recently removed by
+ * delete_min().  Dijkstra's algorithm with non-negative integer edge costs
+ * satisfies this.  No check is made, so it is up to the user of the heap to
+ * ensure that it holds.
+ *
+ * Items are kept in buckets according to the highest bit in which their key
+ * differs from the last key removed.  Bucket 0 holds items whose key equals
+ * the last key removed, and bucket i > 0 holds items whose key differs from it
+ * first at bit i-1.  When bucket 0 becomes empty, the lowest non-empty bucket
+ * is scanned for its minimum key, which becomes the new last key, and its
+ * items are redistributed into lower buckets.  Each item can only move to a
+ * lower bucket, so each item is moved at most once per bit of the key.
+ */
+
+
+/*** Option to print debugging information.  Use 1 for yes, or 0 for no. ***/
+#define RHEAP_DUMP 0
+
+/* The number of buckets needed for keys of type long. */
+#define RHEAP_BUCKETS (8 * sizeof(long) + 1)
+
+
+
+/*** Structure Types ***/
+
+/* The structure type for a radix heap.
+ *
+ * Each bucket is a doubly linked list of items, which is maintained using
+ * arrays indexed by item (vertex number):
+ * key[v]     - the key of item v.
+ * bucket[v]  - the bucket which item v is in.
+ * next[v], prev[v] - the next and previous item in item v's bucket, or -1.
+ * head[i]    - the first item in bucket i, or -1 if bucket i is empty.
+ *
+ * last - the key of the item most recently removed by delete_min().
+ * n - the current number of items in the heap.
+ * ops - counts the operations performed on the heap, for experimental
+ *       purposes.  See opcount.h.
+ */
+typedef struct rheap {
+    long *key;
+    int *bucket;
+    int *next, *prev;
+    int head[RHEAP_BUCKETS];
+    long last;
+    int n;
+    opcount_t ops;
+} rheap_t;
+
+
+
+/*** Function prototypes. ***/
+
+/* rh_alloc() - creates and returns a pointer to a radix heap for items
+ * (vertex numbers) 0, 1, ..., max_nodes - 1.
+ */
+rheap_t *rh_alloc(int max_nodes);
+
+/* rh_free() - destroys the heap pointed to by h, freeing up any space that
+ * was used by it.
+ */
+void rh_free(rheap_t *h);
+
+/* rh_insert() - inserts vertex_no with key k into the heap pointed to by h.
+ * The key k must be no smaller than the last key removed from the heap.
+ */
+void rh_insert(rheap_t *h, int vertex_no, long k);
+
+/* rh_delete_min() - deletes the item with the minimum key from the heap
+ * pointed to by h and returns its vertex number.
+ */
+int rh_delete_min(rheap_t *h);
+
+/* rh_decrease_key() - decreases the key of vertex_no to new_value.  The new
+ * value must be no smaller than the last key removed from the heap.
+ */
+void rh_decrease_key(rheap_t *h, int vertex_no, long new_value);
+
+/* Debugging functions. */
+#if RHEAP_DUMP
+void rh_dump(rheap_t *h);
+#endif
+
+
+/*** Alternative interface via the universal heap structure type. ***/
+extern const heap_info_t RHEAP_info;
+
+#endif
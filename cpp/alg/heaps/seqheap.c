@@ -0,0 +1,465 @@
+/*** Sequence Heap Implementation ***/
+#include <stdlib.h>
+#include "seqheap.h"
+#if SEQHEAP_DUMP
+#include <stdio.h>
+#endif
+
+
+
+/*** Prototypes of functions only visible within this file. ***/
+
+void sh_push(seqheap_t *h, int v, long k);
+sh_entry_t sh_pop_ins(seqheap_t *h);
+void sh_flush(seqheap_t *h);
+void sh_add_run(seqheap_t *h, sh_run_t run, int level);
+int sh_merge(seqheap_t *h, sh_run_t **runs, int n_runs, sh_entry_t *out,
+             int max_out);
+void sh_refill(seqheap_t *h);
+void sh_compact(seqheap_t *h, int level);
+
+
+
+/*** Definitions of functions visible outside of this file. ***/
+
+/* sh_alloc() - creates and returns a pointer to a sequence heap for items
+ * (vertex numbers) 0, 1, ..., max_nodes - 1.
+ */
+seqheap_t *sh_alloc(int max_nodes)
+{
+    seqheap_t *h;
+    int i;
+
+    h = malloc(sizeof(seqheap_t));
+    h->ins = malloc((SEQHEAP_M + 1) * sizeof(sh_entry_t));
+    h->ins_size = 0;
+    h->del = malloc(SEQHEAP_M * sizeof(sh_entry_t));
+    h->del_head = h->del_size = 0;
+    for(i = 0; i < SEQHEAP_MAX_LEVELS; i++) h->n_runs[i] = 0;
+
+    h->key = malloc(max_nodes * sizeof(long));
+    for(i = 0; i < max_nodes; i++) h->key[i] = SEQHEAP_NOT_IN_HEAP;
+
+    h->n = 0;
+    OP_RESET(h->ops);
+
+    return h;
+}
+
+
+/* sh_free() - destroys the heap pointed to by h, freeing up any space that
+ * was used by it.
+ */
+void sh_free(seqheap_t *h)
+{
+    int i, j;
+
+    for(i = 0; i < SEQHEAP_MAX_LEVELS; i++) {
+        for(j = 0; j < h->n_runs[i]; j++) free(h->runs[i][j].a);
+    }
+    free(h->ins);
+    free(h->del);
+    free(h->key);
+    free(h);
+}
+
+
+/* sh_insert() - inserts vertex_no with key k into the heap pointed to by h.
+ */
+void sh_insert(seqheap_t *h, int vertex_no, long k)
+{
+    h->key[vertex_no] = k;
+    sh_push(h, vertex_no, k);
+    h->n++;
+}
+
+
+/* sh_delete_min() - deletes the item with the minimum key from the heap
+ * pointed to by h and returns its vertex number.
+ */
+int sh_delete_min(seqheap_t *h)
+{
+    sh_entry_t e;
+    int i;
+
+    for(;;) {
+        /* The delete buffer must hold the smallest entries of the runs, so
+         * refill it if it is empty and any runs remain.
+         */
+        if(h->del_head == h->del_size) {
+            for(i = 0; i < SEQHEAP_MAX_LEVELS; i++) {
+                if(h->n_runs[i] > 0) {
+                    sh_refill(h);
+                    break;
+                }
+            }
+        }
+
+        /* Take the smaller of the two candidates for the minimum. */
+        if(h->del_head == h->del_size) {
+            e = sh_pop_ins(h);
+        }
+        else if(h->ins_size > 0) {
+            OP_COMP(h->ops);
+            if(h->ins[1].key < h->del[h->del_head].key) {
+                e = sh_pop_ins(h);
+            }
+            else {
+                e = h->del[h->del_head++];
+            }
+        }
+        else {
+            e = h->del[h->del_head++];
+        }
+
+        /* Stale entries are skipped. */
+        if(h->key[e.vertex_no] == e.key) {
+            h->key[e.vertex_no] = SEQHEAP_NOT_IN_HEAP;
+            h->n--;
+            return e.vertex_no;
+        }
+    }
+}
+
+
+/* sh_decrease_key() - decreases the key of vertex_no to new_value.
+ */
+void sh_decrease_key(seqheap_t *h, int vertex_no, long new_value)
+{
+    h->key[vertex_no] = new_value;
+    sh_push(h, vertex_no, new_value);
+}
+
+
+
+/*** Definitions of functions that are only visible within this file. ***/
+
+/* sh_push() - adds an entry for item v with key k to the insertion heap,
+ * first moving the insertion heap into a run if it is full.
+ */
+void sh_push(seqheap_t *h, int v, long k)
+{
+    sh_entry_t *ins;
+    int i, p;
+
+    if(h->ins_size == SEQHEAP_M) sh_flush(h);
+
+    ins = h->ins;
+    i = ++h->ins_size;
+    while(i > 1) {
+        p = i >> 1;
+        OP_COMP(h->ops);
+        if(ins[p].key <= k) break;
+        ins[i] = ins[p];
+        OP_LINK(h->ops);
+        i = p;
+    }
+    ins[i].key = k;
+    ins[i].vertex_no = v;
+}
+
+
+/* sh_pop_ins() - removes and returns the entry with the minimum key from the
+ * non-empty insertion heap.
+ */
+sh_entry_t sh_pop_ins(seqheap_t *h)
+{
+    sh_entry_t *ins, min, last;
+    int i, c, size;
+
+    ins = h->ins;
+    min = ins[1];
+    last = ins[h->ins_size--];
+    size = h->ins_size;
+
+    i = 1;
+    while((c = i << 1) <= size) {
+        if(c < size) {
+            OP_COMP(h->ops);
+            if(ins[c + 1].key < ins[c].key) c++;
+        }
+        OP_COMP(h->ops);
+        if(last.key <= ins[c].key) break;
+        ins[i] = ins[c];
+        OP_LINK(h->ops);
+        i = c;
+    }
+    ins[i] = last;
+
+    return min;
+}
+
+
+/* sh_flush() - empties the insertion heap and the delete buffer into a new
+ * run on level 0.  The delete buffer is included so that it remains no larger
+ * than any run.  Stale entries are dropped.
+ */
+void sh_flush(seqheap_t *h)
+{
+    sh_run_t run;
+    sh_entry_t e;
+    int size;
+
+    size = h->ins_size + h->del_size - h->del_head;
+    run.a = malloc(size * sizeof(sh_entry_t));
+    OP_ALLOC(h->ops);
+    run.head = run.size = 0;
+
+    /* Merge the insertion heap, taken in sorted order, with the delete
+     * buffer.
+     */
+    while(h->ins_size > 0 || h->del_head < h->del_size) {
+        if(h->ins_size == 0) {
+            e = h->del[h->del_head++];
+        }
+        else if(h->del_head == h->del_size) {
+            e = sh_pop_ins(h);
+        }
+        else {
+            OP_COMP(h->ops);
+            if(h->ins[1].key < h->del[h->del_head].key) {
+                e = sh_pop_ins(h);
+            }
+            else {
+                e = h->del[h->del_head++];
+            }
+        }
+        if(h->key[e.vertex_no] == e.key) run.a[run.size++] = e;
+    }
+    h->del_head = h->del_size = 0;
+
+    sh_add_run(h, run, 0);
+}
+
+
+/* sh_add_run() - adds run to the given level.  If the level is full, its runs
+ * are first merged into one run which is added to the next level.  Runs with
+ * no entries are freed rather than added.
+ */
+void sh_add_run(seqheap_t *h, sh_run_t run, int level)
+{
+    sh_run_t merged, *runs[SEQHEAP_K];
+    int i, size;
+
+    if(run.head == run.size) {
+        free(run.a);
+        return;
+    }
+
+    if(h->n_runs[level] == SEQHEAP_K) {
+        OP_RESTRUCT(h->ops);
+        size = 0;
+        for(i = 0; i < SEQHEAP_K; i++) {
+            runs[i] = &h->runs[level][i];
+            size += runs[i]->size - runs[i]->head;
+        }
+        merged.a = malloc(size * sizeof(sh_entry_t));
+        OP_ALLOC(h->ops);
+        merged.head = 0;
+        merged.size = sh_merge(h, runs, SEQHEAP_K, merged.a, size);
+        for(i = 0; i < SEQHEAP_K; i++) free(h->runs[level][i].a);
+        h->n_runs[level] = 0;
+
+        if(level + 1 < SEQHEAP_MAX_LEVELS) {
+            sh_add_run(h, merged, level + 1);
+        }
+        else {
+            /* The last level merges into itself. */
+            sh_add_run(h, merged, level);
+        }
+    }
+
+    h->runs[level][h->n_runs[level]++] = run;
+    OP_DEPTH(h->ops, level + 1);
+}
+
+
+/* sh_merge() - merges the entries remaining in the n_runs runs pointed to by
+ * runs[], in order of key, writing at most max_out of them to out[].  Stale
+ * entries are dropped.  Each run is advanced past the entries taken from it.
+ * Returns the number of entries written.
+ *
+ * The merge uses a binary heap of the runs, ordered by the key of the first
+ * remaining entry of each run.
+ */
+int sh_merge(seqheap_t *h, sh_run_t **runs, int n_runs, sh_entry_t *out,
+             int max_out)
+{
+    sh_run_t *t[SEQHEAP_K * SEQHEAP_MAX_LEVELS + 1], *r;
+    sh_entry_t e;
+    long k;
+    int i, c, p, size, count;
+
+    /* Build the heap of non-empty runs. */
+    size = 0;
+    for(i = 0; i < n_runs; i++) {
+        r = runs[i];
+        if(r->head == r->size) continue;
+        k = r->a[r->head].key;
+        c = ++size;
+        while(c > 1) {
+            p = c >> 1;
+            OP_COMP(h->ops);
+            if(t[p]->a[t[p]->head].key <= k) break;
+            t[c] = t[p];
+            c = p;
+        }
+        t[c] = r;
+    }
+
+    count = 0;
+    while(count < max_out && size > 0) {
+        r = t[1];
+        e = r->a[r->head++];
+        if(h->key[e.vertex_no] == e.key) out[count++] = e;
+
+        /* Move the run at the root, or the last run if the root run is
+         * exhausted, down to its place in the heap.
+         */
+        if(r->head == r->size) r = t[size--];
+        if(size == 0) break;
+        k = r->a[r->head].key;
+        i = 1;
+        while((c = i << 1) <= size) {
+            if(c < size) {
+                OP_COMP(h->ops);
+                if(t[c + 1]->a[t[c + 1]->head].key < t[c]->a[t[c]->head].key) {
+                    c++;
+                }
+            }
+            OP_COMP(h->ops);
+            if(k <= t[c]->a[t[c]->head].key) break;
+            t[i] = t[c];
+            i = c;
+        }
+        t[i] = r;
+    }
+    OP_LINKS(h->ops, count);
+
+    return count;
+}
+
+
+/* sh_refill() - refills the empty delete buffer with the smallest entries of
+ * all runs, and frees any runs that this exhausts.
+ */
+void sh_refill(seqheap_t *h)
+{
+    sh_run_t *runs[SEQHEAP_K * SEQHEAP_MAX_LEVELS];
+    int i, j, n_runs;
+
+    n_runs = 0;
+    for(i = 0; i < SEQHEAP_MAX_LEVELS; i++) {
+        for(j = 0; j < h->n_runs[i]; j++) runs[n_runs++] = &h->runs[i][j];
+    }
+
+    h->del_head = 0;
+    h->del_size = sh_merge(h, runs, n_runs, h->del, SEQHEAP_M);
+
+    for(i = 0; i < SEQHEAP_MAX_LEVELS; i++) sh_compact(h, i);
+}
+
+
+/* sh_compact() - frees the exhausted runs on the given level, and moves the
+ * remaining runs to the front of the level.
+ */
+void sh_compact(seqheap_t *h, int level)
+{
+    sh_run_t *runs;
+    int i, j;
+
+    runs = h->runs[level];
+    j = 0;
+    for(i = 0; i < h->n_runs[level]; i++) {
+        if(runs[i].head == runs[i].size) {
+            free(runs[i].a);
+        }
+        else {
+            runs[j++] = runs[i];
+        }
+    }
+    h->n_runs[level] = j;
+}
+
+
+
+/*** Debugging functions ***/
+
+/* Print out the sizes of the parts of a sequence heap. */
+#if SEQHEAP_DUMP
+void sh_dump(seqheap_t *h)
+{
+    int i, j;
+
+    printf("\nn = %d, insertion heap = %d, delete buffer = %d\n", h->n,
+           h->ins_size, h->del_size - h->del_head);
+    for(i = 0; i < SEQHEAP_MAX_LEVELS; i++) {
+        if(h->n_runs[i] == 0) continue;
+        printf("level %d:", i);
+        for(j = 0; j < h->n_runs[i]; j++) {
+            printf(" %d", h->runs[i][j].size - h->runs[i][j].head);
+        }
+        putchar('\n');
+    }
+    fflush(stdout);
+}
+#endif
+
+
+/*** Implement the univeral heap structure type ***/
+
+/* Sequence heap wrapper functions. */
+
+int _sh_delete_min(void *h) {
+    return sh_delete_min((seqheap_t *)h);
+}
+
+void _sh_insert(void *h, int v, long k) {
+    sh_insert((seqheap_t *)h, v, k);
+}
+
+void _sh_decrease_key(void *h, int v, long k) {
+    sh_decrease_key((seqheap_t *)h, v, k);
+}
+
+int _sh_n(void *h) {
+    return ((seqheap_t *)h)->n;
+}
+
+long _sh_key_comps(void *h) {
+    return ((seqheap_t *)h)->ops.comps;
+}
+
+const opcount_t *_sh_counts(void *h) {
+    return &((seqheap_t *)h)->ops;
+}
+
+void *_sh_alloc(int n) {
+    return sh_alloc(n);
+}
+
+void _sh_free(void *h) {
+    sh_free((seqheap_t *)h);
+}
+
+void _sh_dump(void *h) {
+#if SEQHEAP_DUMP
+    sh_dump((seqheap_t *)h);
+#endif
+}
+
+/* Sequence heap info. */
+const heap_info_t SEQHEAP_info = {
+    _sh_delete_min,
+    _sh_insert,
+    _sh_decrease_key,
+    _sh_n,
+    _sh_key_comps,
+    _sh_alloc,
+    _sh_free,
+    _sh_dump,
+    NULL,
+    NULL,
+    NULL,
+    _sh_counts
+};
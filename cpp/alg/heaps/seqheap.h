@@ -0,0 +1,139 @@
+#ifndef SEQHEAP_H
+#define SEQHEAP_H
+/*** Header File for the Sequence Heap Implementation ***/
+#include <limits.h>
+#include "heap_info.h"  /* Defines the uiversal heap structure type. */
+
+/* A sequence heap (after Sanders, "Fast Priority Queues for Cached Memory")
+ * keeps most of its entries in sorted arrays, called runs, which are only
+ * ever read and written sequentially, so it remains fast when the heap is
+ * much larger than the cache.  It consists of:
+ *
+ * - An insertion heap, a small binary heap of SEQHEAP_M entries that receives
+ *   all new entries.  When it is full, its entries are sorted into a new run.
+ * - Runs, arranged in levels.  Each level holds up to SEQHEAP_K runs.  When a
+ *   run is added to a full level, the SEQHEAP_K runs already there are merged
+ *   into a single run which is added to the next level, so the runs on level
+ *   i are roughly SEQHEAP_K^i times as long as those on level 0.
+ * - A delete buffer, holding the SEQHEAP_M smallest entries of the runs, in
+ *   sorted order.  It is refilled by a k-way merge of all runs when it becomes
+ *   empty.  No entry in the delete buffer is larger than any entry in a run.
+ *
+ * delete_min() takes the smaller of the minimum of the insertion heap and the
+ * first entry of the delete buffer.
+ *
+ * Entries are never moved within the structure by decrease_key().  Instead
+ * decrease_key() adds a new entry with the smaller key, and the old entry
+ * becomes stale.  The current key of each item is kept in an array, and an
+ * entry is stale when its key is not the current key of its item.
+ * delete_min() skips stale entries, and merges drop them.  This lazy deletion
+ * is internal to the heap, so through heap_info_t it behaves as any other
+ * heap.
+ */
+
+
+/*** Compile Time Options ***/
+
+/* The number of entries in the insertion heap and delete buffer. */
+#define SEQHEAP_M 256
+
+/* The number of runs on each level, which is also the number of runs merged
+ * together when a level is full.
+ */
+#define SEQHEAP_K 8
+
+/* The number of levels of runs.  When the last level is full, its runs are
+ * merged into a single run on the same level.
+ */
+#define SEQHEAP_MAX_LEVELS 12
+
+/* Option to print debugging information.  Use 1 for yes, or 0 for no. */
+#define SEQHEAP_DUMP 0
+
+
+
+/*** Special Values ***/
+
+/* The current key of an item that is not in the heap.  Keys must be smaller
+ * than this.
+ */
+#define SEQHEAP_NOT_IN_HEAP LONG_MAX
+
+
+
+/*** Structure Types ***/
+
+/* An entry in the heap.  The entry is stale if key is no longer the current
+ * key of item vertex_no.
+ */
+typedef struct sh_entry {
+    long key;
+    int vertex_no;
+} sh_entry_t;
+
+/* A run is a sorted array of entries a[0..size-1], of which a[head..size-1]
+ * have not yet been removed.
+ */
+typedef struct sh_run {
+    sh_entry_t *a;
+    int head, size;
+} sh_run_t;
+
+/* The structure type for a sequence heap.
+ * ins - the insertion heap, a binary heap ins[1..ins_size].
+ * del - the delete buffer, del[del_head..del_size-1] in sorted order.
+ * runs - runs[i][0..n_runs[i]-1] are the runs on level i.
+ * key - key[v] is the current key of item v, or SEQHEAP_NOT_IN_HEAP.
+ * n - the current number of items in the heap.
+ * ops - counts the operations performed on the heap, for experimental
+ *       purposes.  See opcount.h.
+ */
+typedef struct seqheap {
+    sh_entry_t *ins;
+    int ins_size;
+    sh_entry_t *del;
+    int del_head, del_size;
+    sh_run_t runs[SEQHEAP_MAX_LEVELS][SEQHEAP_K];
+    int n_runs[SEQHEAP_MAX_LEVELS];
+    long *key;
+    int n;
+    opcount_t ops;
+} seqheap_t;
+
+
+
+/*** Function prototypes. ***/
+
+/* sh_alloc() - creates and returns a pointer to a sequence heap for items
+ * (vertex numbers) 0, 1, ..., max_nodes - 1.
+ */
+seqheap_t *sh_alloc(int max_nodes);
+
+/* sh_free() - destroys the heap pointed to by h, freeing up any space that
+ * was used by it.
+ */
+void sh_free(seqheap_t *h);
+
+/* sh_insert() - inserts vertex_no with key k into the heap pointed to by h.
+ */
+void sh_insert(seqheap_t *h, int vertex_no, long k);
+
+/* sh_delete_min() - deletes the item with the minimum key from the heap
+ * pointed to by h and returns its vertex number.
+ */
+int sh_delete_min(seqheap_t *h);
+
+/* sh_decrease_key() - decreases the key of vertex_no to new_value.
+ */
+void sh_decrease_key(seqheap_t *h, int vertex_no, long new_value);
+
+/* Debugging functions. */
+#if SEQHEAP_DUMP
+void sh_dump(seqheap_t *h);
+#endif
+
+
+/*** Alternative interface via the universal heap structure type. ***/
+extern const heap_info_t SEQHEAP_info;
+
+#endif
@@ -22,12 +22,23 @@
 
 
 
+/*** Node links. ***/
+
+/* TRIH_NODE() gives a pointer to the node with index i, or NULL if i is
+ * TRIHEAP_NIL, and TRIH_INDEX() gives the index of the node pointed to by p.
+ */
+#define TRIH_NODE(h, i) ((i) == TRIHEAP_NIL ? NULL : &(h)->nodes[i])
+#define TRIH_INDEX(h, p) ((p) ? (uint32_t)((p) - (h)->nodes) : TRIHEAP_NIL)
+
+
+
 /*** Prototypes of functions only visible within this file. ***/
 
 void trih_meld(triheap_t *h, triheap_node_t *tree_list);
-int trih_merge(triheap_node_t **a, triheap_node_t **b);
-void trih_add_child(triheap_node_t *c, triheap_node_t *p);
-void trih_replace_child(triheap_node_t *old, triheap_node_t *new);
+int trih_merge(triheap_t *h, triheap_node_t **a, triheap_node_t **b);
+void trih_add_child(triheap_t *h, triheap_node_t *c, triheap_node_t *p);
+void trih_replace_child(triheap_t *h, triheap_node_t *old,
+                        triheap_node_t *new);
 
 
 
@@ -56,7 +67,7 @@ printf("init, ");  fflush(stdout);
      */
     h->trees = calloc(h->max_trees, sizeof(triheap_node_t *));
     h->active = calloc(h->max_trees, sizeof(triheap_node_t *));
-    h->nodes = calloc(max_nodes, sizeof(triheap_node_t *));
+    h->nodes = malloc(max_nodes * sizeof(triheap_node_t));
 
     /* We begin with no nodes in the heap. */
     h->n = 0;
@@ -66,10 +77,9 @@ printf("init, ");  fflush(stdout);
      */
     h->value = 0;
 
-    /* For experimental purposes, we keep a count of the number of key
-     * comparisons.
+    /* For experimental purposes, we keep counts of the operations performed.
      */
-    h->key_comps = 0;
+    OP_RESET(h->ops);
 
     return h;
 }
@@ -80,16 +90,10 @@ printf("init, ");  fflush(stdout);
  */
 void trih_free(triheap_t *h)
 {
-    int i;
-
 #if SHOW_trih
 printf("free, ");  fflush(stdout);
 #endif
 
-    for(i = 0; i < h->max_nodes; i++) {
-        free(h->nodes[i]);
-    }
-
     free(h->nodes);
     free(h->trees);
     free(h->active);
@@ -112,22 +116,19 @@ void trih_insert(triheap_t *h, int vertex_no, long k)
 printf("insert, ");  fflush(stdout);
 #endif
 
-    /* Create an initialise the new node.  The parent pointer will be set to
-     * NULL by trih_meld().
+    /* Initialise the new node, which already has space in the slab.  The
+     * parent link will be set to TRIHEAP_NIL by trih_meld().
      */
-    new = malloc(sizeof(triheap_node_t));
-    new->child = NULL;
+    new = &h->nodes[vertex_no];
+    new->child = TRIHEAP_NIL;
     new->extra = FALSE;
-    new->left = new->right = NULL;
-    new->partner = NULL;
+    new->left = new->right = TRIHEAP_NIL;
+    new->partner = TRIHEAP_NIL;
 
     new->dim = 0;
     new->vertex_no = vertex_no;
     new->key = k;
 
-    /* Maintain a pointer to vertex_no's new node in the heap. */
-    h->nodes[vertex_no] = new;
-
     /* Meld the new node into the heap. */
     trih_meld(h, new);
 
@@ -182,7 +183,7 @@ printf("delete_min, ");  fflush(stdout);
                 k = k2;
                 min_node = next;
             }
-            h->key_comps++;
+            OP_COMP(h->ops);
         }
         next = h->active[d];
         if(next) {
@@ -190,7 +191,7 @@ printf("delete_min, ");  fflush(stdout);
                 k = k2;
                 min_node = next;
             }
-            h->key_comps++;
+            OP_COMP(h->ops);
         }
     }
 
@@ -203,7 +204,7 @@ printf("on vertex no %d, ", min_node->vertex_no);  fflush(stdout);
      */
     
     /* An active node may have been destroyed. */
-    if(min_node->parent) {
+    if(min_node->parent != TRIHEAP_NIL) {
 	h->active[min_node->dim] = NULL;
     }
     
@@ -212,9 +213,10 @@ printf("on vertex no %d, ", min_node->vertex_no);  fflush(stdout);
      */
     break_node = min_node;
     d = break_node->dim;
-    partner = break_node->partner;
+    partner = TRIH_NODE(h, break_node->partner);
     first_child = break_node->extra ? partner : break_node;
-    parent = first_child->parent;  /* parent pointer of the broken node. */
+    /* The parent of the broken node. */
+    parent = TRIH_NODE(h, first_child->parent);
     
     /* A nodes child pointer always points to its highest dimension child,
      * so child->right is the smallest dimension.  For melding the linked list
@@ -224,19 +226,19 @@ printf("on vertex no %d, ", min_node->vertex_no);  fflush(stdout);
      * For the linked list, only the right pointer is used, so the value of the
      * left pointer will be left undefined.
      */
-    child = min_node->child;
+    child = TRIH_NODE(h, min_node->child);
     if(child) {
-        head = child->right;
+        head = TRIH_NODE(h, child->right);
 	ptr = tail = child;
 
 	/* Nodes in this break up may go from active to inactive. */
 	do {
-	    ptr = ptr->right;
+	    ptr = TRIH_NODE(h, ptr->right);
 	    if(h->active[ptr->dim] == ptr) h->active[ptr->dim] = NULL;
 	} while(ptr != tail);
 	
 	if(parent) {
-	    tail->right = parent;
+	    tail->right = TRIH_INDEX(h, parent);
 	    tail = parent;
 	}
     }
@@ -250,8 +252,8 @@ printf("on vertex no %d, ", min_node->vertex_no);  fflush(stdout);
      * with no parent.  Active nodes never occur as a second child.
      */
     if(parent) {
-    child_zero = parent->child->right;
-    child_higher = first_child->right;
+    child_zero = TRIH_NODE(h, TRIH_NODE(h, parent->child)->right);
+    child_higher = TRIH_NODE(h, first_child->right);
     while(1) {
 	/* At the start of the loop links are not yet updated to account for
 	 * the node that appears to have been removed.
@@ -269,9 +271,9 @@ printf("on vertex no %d, ", min_node->vertex_no);  fflush(stdout);
 	 */
 	next_dim = parent->dim;
 	parent->dim = d;
-	next_partner = parent->partner;
-        parent->partner = partner;
-        partner->partner = parent;
+	next_partner = TRIH_NODE(h, parent->partner);
+        parent->partner = TRIH_INDEX(h, partner);
+        partner->partner = TRIH_INDEX(h, parent);
 
        	/* For the last node pair added to the linked list
 	 * (i.e. (parent,partner) or (partner,parent)), we ensure that the
@@ -279,7 +281,7 @@ printf("on vertex no %d, ", min_node->vertex_no);  fflush(stdout);
 	 */
 	was_extra = parent->extra;
 	tail->extra = FALSE;
-	tail->partner->extra = TRUE;
+	TRIH_NODE(h, tail->partner)->extra = TRUE;
 
 	/* Obtain future values of pointer variables now.  This is done because
 	 * constructing the linked list overwrites pointers that are followed.
@@ -290,10 +292,10 @@ printf("on vertex no %d, ", min_node->vertex_no);  fflush(stdout);
 	else {
             next_first_child = parent;
 	}
-        next_parent = next_first_child->parent;
+        next_parent = TRIH_NODE(h, next_first_child->parent);
 	if(next_parent) {
-	    next_child_zero = next_parent->child->right;
-	    next_child_higher = next_first_child->right;
+	    next_child_zero = TRIH_NODE(h, TRIH_NODE(h, next_parent->child)->right);
+	    next_child_higher = TRIH_NODE(h, next_first_child->right);
 	}
 
 	
@@ -301,15 +303,15 @@ printf("on vertex no %d, ", min_node->vertex_no);  fflush(stdout);
 	 * first_child to the list of broken trunks.  Keep a pointer to
 	 * parent->child->right for use below.
 	 */
-	if(parent->child != first_child) {
+	if(parent->child != TRIH_INDEX(h, first_child)) {
 	    ptr = tail;
-	    tail->right = child_higher;
-	    tail = parent->child;
+	    tail->right = TRIH_INDEX(h, child_higher);
+	    tail = TRIH_NODE(h, parent->child);
 
 	    /* Nodes in this break up may go from active to inactive.
 	     */
 	    do {
-		ptr = ptr->right;
+		ptr = TRIH_NODE(h, ptr->right);
 		if(h->active[ptr->dim] == ptr) h->active[ptr->dim] = NULL;
 	    } while(ptr != tail);
 	}
@@ -322,14 +324,14 @@ printf("on vertex no %d, ", min_node->vertex_no);  fflush(stdout);
 	    /* Lower dimension children exist.  Note that tail currently points
 	     * to the highest dimension child.
 	     */
-	    l = first_child->left;
-	    l->right = child_zero;
-	    child_zero->left = l;
-	    parent->child = l;
+	    l = TRIH_NODE(h, first_child->left);
+	    l->right = TRIH_INDEX(h, child_zero);
+	    child_zero->left = TRIH_INDEX(h, l);
+	    parent->child = TRIH_INDEX(h, l);
 	}
 	else {
 	    /* No lower dimension children. */
-	    parent->child = NULL;
+	    parent->child = TRIHEAP_NIL;
 	}
 
 	
@@ -368,17 +370,17 @@ printf("on vertex no %d, ", min_node->vertex_no);  fflush(stdout);
                     /* We make the linked list point to `partner' instead of
 		     * `parent', and make parent an extra node.
 		     */
-		    tail->right = partner;
+		    tail->right = TRIH_INDEX(h, partner);
 		    tail = partner;
 		    continue;  /* Back to start of loop. */
 		}
-                h->key_comps++;
+                OP_COMP(h->ops);
 	    }
 	}
 	else {
             if(h->active[d] == break_node) h->active[d] = NULL;
 	}
-	tail->right = parent;
+	tail->right = TRIH_INDEX(h, parent);
 	tail = parent;
 
     }} /* if-while */
@@ -389,12 +391,12 @@ printf("on vertex no %d, ", min_node->vertex_no);  fflush(stdout);
      * will become empty unless break_node has a partner node.
      */
     if(partner) {
-	partner->partner = NULL;
+	partner->partner = TRIHEAP_NIL;
 
 	if(partner->extra) {
 	    partner->extra = FALSE;
-	    partner->parent = NULL;
-	    partner->left = partner->right = partner;
+	    partner->parent = TRIHEAP_NIL;
+	    partner->left = partner->right = TRIH_INDEX(h, partner);
 	    h->trees[d] = partner;
 	}
     }
@@ -408,17 +410,15 @@ printf("on vertex no %d, ", min_node->vertex_no);  fflush(stdout);
      * trunk level of the heap.
      */
     if(head) {
-	tail->right = NULL;
+	tail->right = TRIHEAP_NIL;
 	trih_meld(h, head);
     }
     
-    /* Record the vertex no to return. */
+    /* Record the vertex no to return.  The old minimum node's space in the
+     * slab is kept for reuse.
+     */
     vertex_no = min_node->vertex_no;
 
-    /* Delete the old minimum node. */
-    h->nodes[vertex_no] = NULL;
-    free(min_node);
-
 #if SHOW_trih
 trih_dump(h);
 printf("delete_min-exited, ");  fflush(stdout);
@@ -445,7 +445,7 @@ printf("decrease_key on vn = %d (%ld), ", vertex_no, new_value);  fflush(stdout)
 
     
     /* Pointer v points to the decreased node. */
-    v = h->nodes[vertex_no];
+    v = &h->nodes[vertex_no];
     v->key = new_value;
     d = v->dim;  /* dimension */
 
@@ -454,13 +454,13 @@ printf("decrease_key on vn = %d (%ld), ", vertex_no, new_value);  fflush(stdout)
     while(1) {
 	
 
-	v2 = v->partner;  /* partner */
+	v2 = TRIH_NODE(h, v->partner);  /* partner */
 	if(v->extra) {
-	    p = v2->parent;  /* parent */
+	    p = TRIH_NODE(h, v2->parent);  /* parent */
 	    above = v2;
 	}
 	else {
-	    above = p = v->parent; /* parent */
+	    above = p = TRIH_NODE(h, v->parent); /* parent */
 	}
 
 	
@@ -479,12 +479,13 @@ printf("decrease_key on vn = %d (%ld), ", vertex_no, new_value);  fflush(stdout)
 		 * child to maintain the correct ordering.
 	         */
 
-		h->key_comps++;
+		OP_COMP(h->ops);
 		if(v->key < above->key) {
 		    /* swap */		    
 		    v->extra = FALSE;
 		    v2->extra = TRUE;
-                    trih_replace_child(v2, v);
+                    trih_replace_child(h, v2, v);
+                    OP_LINK(h->ops);
 
                     /* If v2 is inconsistent try promotion.  By checking if
 		     * v2 was an active node we can avoid key comparison, since
@@ -492,7 +493,7 @@ printf("decrease_key on vn = %d (%ld), ", vertex_no, new_value);  fflush(stdout)
                      */
                     if(active_node == v2) {
 
-                        h->key_comps++;
+                        OP_COMP(h->ops);
 		        if(v2->key < p->key) goto promote;  /* see below */
 
                         /* At this point, v2 is active but is consistent, so v
@@ -524,7 +525,7 @@ printf("decrease_key on vn = %d (%ld), ", vertex_no, new_value);  fflush(stdout)
                  */
                 if(active_node == v2) {
 		    /* If v is inconsistent, then v2 is also, so promote. */
-                    h->key_comps++;
+                    OP_COMP(h->ops);
                     if(v->key < p->key) {
 		        /* Swap v and v2. */
                         v2 = v;
@@ -561,15 +562,15 @@ printf("decrease_key on vn = %d (%ld), ", vertex_no, new_value);  fflush(stdout)
 
 	/* Otherwise, v is the second node on a main trunk. */
 
-        h->key_comps++;
+        OP_COMP(h->ops);
 	if(v->key < above->key) {
 	    /* If v is smaller, we swap it with the first child
 	     * (i.e. the root node) to maintain the correct ordering.
 	     */
 	    v->extra = FALSE;
 	    v2->extra = TRUE;
-	    v->parent = NULL;
-	    v->left = v->right = v;
+	    v->parent = TRIHEAP_NIL;
+	    v->left = v->right = TRIH_INDEX(h, v);
 	    h->trees[d] = v;
             return;
 	}
@@ -587,38 +588,41 @@ printf("decrease_key on vn = %d (%ld), ", vertex_no, new_value);  fflush(stdout)
          * the currently active node for this dimension, which at this point
          * must exist.
 	 */	
+	OP_RESTRUCT(h->ops);
 
 
 	/* The current active node and its partner are w and w2 respectively.
 	 */
 	w = active_node;
-	w2 = w->partner;
+	w2 = TRIH_NODE(h, w->partner);
 
 	/* The final rearrangement always pairs v with w and v2 with w2. */
-	v->partner = w;    w->partner = v;
-	v2->partner = w2;  w2->partner = v2;
+	v->partner = TRIH_INDEX(h, w);    w->partner = TRIH_INDEX(h, v);
+	v2->partner = TRIH_INDEX(h, w2);  w2->partner = TRIH_INDEX(h, v2);
 
 	/* Determine the ordering in the rearrangement. */
-        h->key_comps++;
+        OP_COMP(h->ops);
 	if(v2->key < w2->key) {
 	    /* Make the (1st child, 2nd child) pair (v2,w2), replacing (v,v2).
 	     */
 	    v2->extra = FALSE;
-	    trih_replace_child(v, v2);
+	    trih_replace_child(h, v, v2);
+	    OP_LINK(h->ops);
 
-            h->key_comps++;
+            OP_COMP(h->ops);
 	    if(v->key < w->key) {
 		/* Make the pair (v,w), replacing (w,w2). */
 		w->extra = TRUE;
-		trih_replace_child(w,v);
+		trih_replace_child(h, w,v);
+		OP_LINK(h->ops);
 
-                h->key_comps++;
-		if(w->key < v->parent->key) {
+                OP_COMP(h->ops);
+		if(w->key < TRIH_NODE(h, v->parent)->key) {
 		    /* Both v and w are inconsistent, continue with
 		     * promotion.  Update v2, and p;
 		     */
 		    v2 = w;
-		    p = v->parent;
+		    p = TRIH_NODE(h, v->parent);
                     goto promote;  /* see below */
 		}
 
@@ -634,14 +638,14 @@ printf("decrease_key on vn = %d (%ld), ", vertex_no, new_value);  fflush(stdout)
 		/* Make the pair (w,v), replacing (w,w2). */
 		v->extra = TRUE;
 
-                h->key_comps++;
-		if(v->key < w->parent->key) {
+                OP_COMP(h->ops);
+		if(v->key < TRIH_NODE(h, w->parent)->key) {
 		    /* Both v and w are inconsistent, so continue with
 		     * promotion.  Update v, v2, and p.
 		     */
 		    v2 = v;
 		    v = w;
-		    p = w->parent;
+		    p = TRIH_NODE(h, w->parent);
                     goto promote;  /* see below */
 		}
 
@@ -654,15 +658,16 @@ printf("decrease_key on vn = %d (%ld), ", vertex_no, new_value);  fflush(stdout)
 	else {
 	    /* Make the pair (w2,v2), replacing (w,w2). */
 	    w2->extra = FALSE;
-	    trih_replace_child(w, w2);
+	    trih_replace_child(h, w, w2);
+	    OP_LINK(h->ops);
 
-            h->key_comps++;
+            OP_COMP(h->ops);
 	    if(v->key < w->key) {
 		/* Make the pair (v,w), replacing (v,v2). */
 		w->extra = TRUE;
 
-                h->key_comps++;
-		if(w->key < v->parent->key) {
+                OP_COMP(h->ops);
+		if(w->key < TRIH_NODE(h, v->parent)->key) {
 		    /* Both v and w are inconsistent, so continue with
                      * promotion.  Update v2.
 		     */
@@ -679,10 +684,11 @@ printf("decrease_key on vn = %d (%ld), ", vertex_no, new_value);  fflush(stdout)
 	    else {
 		/* Make the pair (w,v), replacing (v,v2). */
 		v->extra = TRUE;
-		trih_replace_child(v,w);
+		trih_replace_child(h, v,w);
+		OP_LINK(h->ops);
 
-                h->key_comps++;
-                if(v->key < w->parent->key) {
+                OP_COMP(h->ops);
+                if(v->key < TRIH_NODE(h, w->parent)->key) {
 		    /* Both v and w are inconsistent, so continue with
 		     * promotion.  Update v, v2.
 		     */
@@ -708,7 +714,8 @@ printf("decrease_key on vn = %d (%ld), ", vertex_no, new_value);  fflush(stdout)
 	
         /* First we make v2 a child node of v. */
 	v2->extra = FALSE;
-	trih_add_child(v2, v);
+	trih_add_child(h, v2, v);
+	OP_LINK(h->ops);
 		
 	/* Then v replaces p.  Any child nodes of p that have a higher
          * dimension than v will become child nodes of v.  Only child nodes of
@@ -716,19 +723,21 @@ printf("decrease_key on vn = %d (%ld), ", vertex_no, new_value);  fflush(stdout)
 	 */
 	
 	v->dim = p->dim;
-	partner = v->partner = p->partner;
-	high_child = p->child;
+	v->partner = p->partner;
+	partner = TRIH_NODE(h, p->partner);
+	high_child = TRIH_NODE(h, p->child);
 
 	if(d) {
 	    /* v has lower dimension siblings. */
-            l = p->child = v->left;
-	    r = high_child->right;
-	    l->right = r;
-	    r->left = l;
+            p->child = v->left;
+            l = TRIH_NODE(h, v->left);
+	    r = TRIH_NODE(h, high_child->right);
+	    l->right = TRIH_INDEX(h, r);
+	    r->left = TRIH_INDEX(h, l);
 	}
 	else {
 	    /* v was an only child. */
-	    p->child = NULL;
+	    p->child = TRIHEAP_NIL;
 	}
 	
 	if(high_child != v) {
@@ -737,20 +746,20 @@ printf("decrease_key on vn = %d (%ld), ", vertex_no, new_value);  fflush(stdout)
 	     * currently has at least one child, since v2 was made a child
 	     * of v.
 	     */
-            low_child = v->right;
-            l = v->child;
-	    r = v->child->right;
-	    l->right = low_child;
-	    low_child->left = l;
-	    r->left = high_child;
-	    high_child->right = r;
+            low_child = TRIH_NODE(h, v->right);
+            l = TRIH_NODE(h, v->child);
+	    r = TRIH_NODE(h, TRIH_NODE(h, v->child)->right);
+	    l->right = TRIH_INDEX(h, low_child);
+	    low_child->left = TRIH_INDEX(h, l);
+	    r->left = TRIH_INDEX(h, high_child);
+	    high_child->right = TRIH_INDEX(h, r);
 
-	    v->child = high_child;
+	    v->child = TRIH_INDEX(h, high_child);
 
 	    ptr = v;
 	    do {
-                ptr = ptr->right;
-		ptr->parent = v;
+                ptr = TRIH_NODE(h, ptr->right);
+		ptr->parent = TRIH_INDEX(h, v);
 	    } while(ptr != high_child);
 	}
 
@@ -764,17 +773,18 @@ printf("decrease_key on vn = %d (%ld), ", vertex_no, new_value);  fflush(stdout)
 	 * root node.
 	 */
 	if(!p->extra) {
-	    if(p->parent) {
+	    if(p->parent != TRIHEAP_NIL) {
 		/* p is non-root node and a first child. */
-		partner->partner = v;
-		trih_replace_child(p, v);
+		partner->partner = TRIH_INDEX(h, v);
+		trih_replace_child(h, p, v);
+		OP_LINK(h->ops);
 	    }
 	    else {
 		/* p is a root node, so update the tree pointer. */
-		if(partner) partner->partner = v;
+		if(partner) partner->partner = TRIH_INDEX(h, v);
 		h->trees[p->dim] = v;
-		v->left = v->right = v;
-		v->parent = NULL;
+		v->left = v->right = TRIH_INDEX(h, v);
+		v->parent = TRIHEAP_NIL;
 	    }
 
 	    /* p will become an extra node, see below. */
@@ -782,7 +792,7 @@ printf("decrease_key on vn = %d (%ld), ", vertex_no, new_value);  fflush(stdout)
 	}
 	else {
 	    /* If p was an extra node then v becomes an extra node. */
-	    partner->partner = v;
+	    partner->partner = TRIH_INDEX(h, v);
 	    v->extra = TRUE;
 	}
 
@@ -790,8 +800,8 @@ printf("decrease_key on vn = %d (%ld), ", vertex_no, new_value);  fflush(stdout)
 	 * node v).
 	 */
 	p->dim = d;
-	v2->partner = p;
-	p->partner = v2;
+	v2->partner = TRIH_INDEX(h, p);
+	p->partner = TRIH_INDEX(h, v2);
 
 	/* The result of promotion is to release the active node. */
 	h->active[d] = NULL;
@@ -823,13 +833,13 @@ printf("decrease_key-exited, ");  fflush(stdout);
 /*** Definitions of functions only visible within this file. ***/
 
 /* trih_meld() - melds  the linked list of trees pointed to by *tree_list into
- * the heap pointed to by h.  This function uses the `right' sibling pointer
- * of nodes to traverse the linked list from lower dimension nodes to higher
- * dimension nodes.  It expects the last nodes `right' pointer to be NULL.
+ * the heap pointed to by h.  This function uses the `right' sibling link of
+ * nodes to traverse the linked list from lower dimension nodes to higher
+ * dimension nodes.  It expects the last nodes `right' link to be TRIHEAP_NIL.
  */
 void trih_meld(triheap_t *h, triheap_node_t *tree_list)
 {
-    triheap_node_t *next, *add_tree;
+    triheap_node_t *next = NULL, *add_tree;
     triheap_node_t *carry_tree;
     int d;
 
@@ -856,9 +866,9 @@ printf("meld - ");  fflush(stdout);
          * there is only a carry_tree to be merged, so treat it like add_tree.
          */
         if(add_tree) {
-            next = add_tree->right;
-            add_tree->right = add_tree->left = add_tree;
-            add_tree->parent = NULL;
+            next = TRIH_NODE(h, add_tree->right);
+            add_tree->right = add_tree->left = TRIH_INDEX(h, add_tree);
+            add_tree->parent = TRIHEAP_NIL;
         }
         else {
             add_tree = carry_tree;
@@ -875,7 +885,9 @@ printf("%d, ", add_tree->vertex_no);  fflush(stdout);
          * treated as a 1-node main trunk one dimension higher up.
          */
 	if(carry_tree) {
-            h->key_comps += trih_merge(&add_tree, &carry_tree);
+            OP_COMPS(h->ops, trih_merge(h, &add_tree, &carry_tree));
+            OP_LINK(h->ops);
+            OP_RESTRUCT(h->ops);
         }
 
         /* After the merge, if add_tree is NULL, then the resulting tree
@@ -887,7 +899,9 @@ printf("%d, ", add_tree->vertex_no);  fflush(stdout);
             d = add_tree->dim;
 	    if(h->trees[d]) {
                 /* Nodes already in this main trunk position, so merge. */
-                h->key_comps += trih_merge(&h->trees[d], &add_tree);
+                OP_COMPS(h->ops, trih_merge(h, &h->trees[d], &add_tree));
+                OP_LINK(h->ops);
+                OP_RESTRUCT(h->ops);
                 if(!h->trees[d]) h->value -= (1 << d);
                 carry_tree = add_tree;
             }
@@ -895,6 +909,7 @@ printf("%d, ", add_tree->vertex_no);  fflush(stdout);
                 /* No nodes in this main trunk position, so use add_tree. */
                 h->trees[d] = add_tree;
                 h->value += (1 << d);
+                OP_DEPTH(h->ops, d);
             }
         }
 
@@ -921,7 +936,7 @@ printf("meld-exited, ");  fflush(stdout);
  *
  * Returns the number of key comparisons used.
  */
-int trih_merge(triheap_node_t **a, triheap_node_t **b)
+int trih_merge(triheap_t *h, triheap_node_t **a, triheap_node_t **b)
 {
     triheap_node_t *tree, *next_tree, *other, *next_other;
     int c;
@@ -948,8 +963,8 @@ int trih_merge(triheap_node_t **a, triheap_node_t **b)
      * next_other points to the next node on the trunk that `other' is the head
      * of (if there is another node).
      */
-    next_tree = tree->partner;
-    next_other = other->partner;
+    next_tree = TRIH_NODE(h, tree->partner);
+    next_other = TRIH_NODE(h, other->partner);
 
     /* The merging depends on the existence of nodes and the values of keys. */
     if(!next_tree) {
@@ -959,13 +974,13 @@ int trih_merge(triheap_node_t **a, triheap_node_t **b)
          */
 
         if(next_other) {
-            trih_add_child(other, tree);
+            trih_add_child(h, other, tree);
 	    tree->dim++;
             *a = NULL;  *b = tree;
         }
         else {
-	    tree->partner = other;
-	    other->partner = tree;
+	    tree->partner = TRIH_INDEX(h, other);
+	    other->partner = TRIH_INDEX(h, tree);
 	    other->extra = TRUE;
 	    
             *a = tree;  *b = NULL;
@@ -977,17 +992,17 @@ int trih_merge(triheap_node_t **a, triheap_node_t **b)
          * values of keys.  The resulting 3-node trunk becomes a carry tree.
          */
 
-	tree->partner = NULL;
-	other->partner = next_tree;
-	next_tree->partner = other;
+	tree->partner = TRIHEAP_NIL;
+	other->partner = TRIH_INDEX(h, next_tree);
+	next_tree->partner = TRIH_INDEX(h, other);
 	
         if(other->key < next_tree->key) {    
-            trih_add_child(other, tree);
+            trih_add_child(h, other, tree);
         }
         else {
 	    next_tree->extra = FALSE;
 	    other->extra = TRUE;	    
-            trih_add_child(next_tree, tree);
+            trih_add_child(h, next_tree, tree);
         }
 
 	tree->dim++;
@@ -1002,13 +1017,13 @@ int trih_merge(triheap_node_t **a, triheap_node_t **b)
          * and (next_tree).  This uses no key comparisons.
          */
 
-	tree->partner=NULL;
-	next_tree->partner = NULL;
+	tree->partner= TRIHEAP_NIL;
+	next_tree->partner = TRIHEAP_NIL;
 	next_tree->extra = FALSE;
-	next_tree->left = next_tree->right = next_tree;
-        next_tree->parent = NULL;
+	next_tree->left = next_tree->right = TRIH_INDEX(h, next_tree);
+        next_tree->parent = TRIHEAP_NIL;
 
-        trih_add_child(other, tree);
+        trih_add_child(h, other, tree);
 	
 	tree->dim++;
 	
@@ -1022,7 +1037,7 @@ int trih_merge(triheap_node_t **a, triheap_node_t **b)
 /* trih_add_child() - Adds a new child, c, to node p.  The user should ensure
  * that the correct dimension child is being added.
  */
-void trih_add_child(triheap_node_t *c, triheap_node_t *p)
+void trih_add_child(triheap_t *h, triheap_node_t *c, triheap_node_t *p)
 {
     triheap_node_t *l, *r;
 
@@ -1030,59 +1045,59 @@ void trih_add_child(triheap_node_t *c, triheap_node_t *p)
      * Otherwise only initialise the left and right pointers of the added
      * child.
      */
-    if((l = p->child)) {
-	r = l->right;
-	c->left = l;
-	c->right = r;
-	r->left = c;
-	l->right = c;
+    if((l = TRIH_NODE(h, p->child))) {
+	r = TRIH_NODE(h, l->right);
+	c->left = TRIH_INDEX(h, l);
+	c->right = TRIH_INDEX(h, r);
+	r->left = TRIH_INDEX(h, c);
+	l->right = TRIH_INDEX(h, c);
     }
     else {
-	c->left = c->right = c;
+	c->left = c->right = TRIH_INDEX(h, c);
     }
 
-    p->child = c;
-    c->parent = p;
+    p->child = TRIH_INDEX(h, c);
+    c->parent = TRIH_INDEX(h, p);
 }
 
 
 /* trih_replace_child() - replaces child node `old' and its sub-tree with child
  * node `new' and its sub-tree.
  */
-void trih_replace_child(triheap_node_t *old, triheap_node_t *new)
+void trih_replace_child(triheap_t *h, triheap_node_t *old, triheap_node_t *new)
 {
     triheap_node_t *parent, *l, *r;
 
-    r = old->right;
+    r = TRIH_NODE(h, old->right);
 
     /* If `old' is an only child we only need to initialise the sibling
      * pointers of the new node.  Otherwise we update sibling pointers of other
      * child nodes.
      */
     if(r == old) {
-	new->right = new->left = new;
+	new->right = new->left = TRIH_INDEX(h, new);
     }
     else {
-        l = old->left;
-	l->right = new;
-	r->left = new;
-	new->left = l;
-	new->right = r;
+        l = TRIH_NODE(h, old->left);
+	l->right = TRIH_INDEX(h, new);
+	r->left = TRIH_INDEX(h, new);
+	new->left = TRIH_INDEX(h, l);
+	new->right = TRIH_INDEX(h, r);
     }
 
     /* Update parent pointer of the new node and possibly the child pointer
      * of the parent node.
      */
-    parent = old->parent;
-    new->parent = parent;
-    if(parent->child == old) parent->child = new;
+    parent = TRIH_NODE(h, old->parent);
+    new->parent = TRIH_INDEX(h, parent);
+    if(parent->child == TRIH_INDEX(h, old)) parent->child = TRIH_INDEX(h, new);
 }
 
 
 
 /* Recursively print the nodes of a trinomial heap. */
 #if SHOW_trih
-void trih_dump_nodes(triheap_node_t *ptr, int level)
+void trih_dump_nodes(triheap_t *h, triheap_node_t *ptr, int level)
 {
      triheap_node_t *child_ptr, *partner;
      int i, ch_count;
@@ -1092,24 +1107,24 @@ void trih_dump_nodes(triheap_node_t *ptr, int level)
 
      printf("%d(%ld)\n", ptr->vertex_no, ptr->key);
      
-     if((child_ptr = ptr->child)) {
-	 child_ptr = ptr->child->right;
+     if((child_ptr = TRIH_NODE(h, ptr->child))) {
+	 child_ptr = TRIH_NODE(h, TRIH_NODE(h, ptr->child)->right);
 	 
          ch_count = 0;
 
          do {
-             trih_dump_nodes(child_ptr, level+1);
+             trih_dump_nodes(h, child_ptr, level+1);
 	     if(child_ptr->dim != ch_count) {
                  for(i = 0; i < level+1; i++) printf("   ");
 		 printf("error(dim)\n");  exit(1);
 	     }
-	     if(child_ptr->parent != ptr) {
+	     if(child_ptr->parent != TRIH_INDEX(h, ptr)) {
                  for(i = 0; i < level+1; i++) printf("   ");
 		 printf("error(parent)\n");
 	     }
-             child_ptr = child_ptr->right;
+             child_ptr = TRIH_NODE(h, child_ptr->right);
 	     ch_count++;
-         } while(child_ptr != ptr->child->right);
+         } while(child_ptr != TRIH_NODE(h, TRIH_NODE(h, ptr->child)->right));
 
          if(ch_count != ptr->dim) {
 	     for(i = 0; i < level; i++) printf("   ");
@@ -1123,7 +1138,7 @@ void trih_dump_nodes(triheap_node_t *ptr, int level)
 	 }
      }
      
-     if((partner=ptr->partner)) {
+     if((partner=TRIH_NODE(h, ptr->partner))) {
 	 if(ptr->extra==partner->extra) {
             for(i = 0; i < level; i++) printf("   ");
 	    printf("%d - error(extra?)\n", partner->vertex_no);  exit(1);
@@ -1133,10 +1148,10 @@ void trih_dump_nodes(triheap_node_t *ptr, int level)
                  for(i = 0; i < level; i++) printf("   ");
 		 printf("%d - error(dim)\n", partner->vertex_no);  exit(1);
 	     }
-	     trih_dump_nodes(partner, level);
+	     trih_dump_nodes(h, partner, level);
 	 }
      }
-     else if(ptr->parent) {
+     else if(ptr->parent != TRIHEAP_NIL) {
          for(i = 0; i < level; i++) printf("   ");
 	 printf("error(no partner)\n");  exit(1);
      }
@@ -1166,7 +1181,7 @@ void trih_dump(triheap_t *h)
 	    if(h->active[i]->extra) {
 		printf("-error(extra)\n");  exit(1);
 	    }
-	    if(!h->active[i]->parent) {
+	    if(h->active[i]->parent == TRIHEAP_NIL) {
 		printf("-error(parent)");  exit(1);
 	    }
 	}
@@ -1178,7 +1193,7 @@ void trih_dump(triheap_t *h)
     for(i=0; i<h->max_trees; i++) {
         if((ptr = h->trees[i])) {
             printf("tree %d\n\n", i);
-            trih_dump_nodes(ptr, 0);
+            trih_dump_nodes(h, ptr, 0);
 	    printf("\n");
         }
     }
@@ -1208,7 +1223,11 @@ int _trih_n(void *h) {
 }
 
 long _trih_key_comps(void *h) {
-    return ((triheap_t *)h)->key_comps;
+    return ((triheap_t *)h)->ops.comps;
+}
+
+const opcount_t *_trih_counts(void *h) {
+    return &((triheap_t *)h)->ops;
 }
 
 void *_trih_alloc(int n) {
@@ -1235,5 +1254,9 @@ const heap_info_t TRIHEAP_info = {
     _trih_key_comps,
     _trih_alloc,
     _trih_free,
-    _trih_dump
+    _trih_dump,
+    NULL,
+    NULL,
+    NULL,
+    _trih_counts
 };
@@ -5,6 +5,7 @@
 /*
  *   Shane Saunders
  */
+#include <stdint.h>
 #include "heap_info.h"  /* Defines the uiversal heap structure type. */
 
 /* This implementation uses a node-pair structure. */
@@ -14,11 +15,20 @@
 /*** Option to print debugging information.  Use 1 for yes, or 0 for no. ***/
 #define SHOW_trih 0
 
+/* The link value used in place of a NULL pointer. */
+#define TRIHEAP_NIL 0xffffffffU
+
 
 
 /*** Structure Types ***/
 
-/* The structure type used for node pairs is very similar to that used for
+/* All nodes are kept in one array, the heap's slab, and the node for vertex v
+ * is slab entry v.  Nodes are linked by their 32-bit indices in the slab
+ * rather than by pointers, with TRIHEAP_NIL for no node.  This makes a node
+ * 40 bytes instead of 64 on machines with 64-bit pointers.  Below, "pointer"
+ * means such a link.
+ *
+ * The structure type used for node pairs is very similar to that used for
  * the Fibonacci heap.  The main difference is that a partner pointer is used
  * which points to a nodes partner in a (2nd, 3rd) node-pair, from the nodes
  * (head, 2nd, 3rd) on a trunk.  Another naming convention is to call the
@@ -46,15 +56,16 @@
  * dimension of a single node with no children is zero.
  */
 typedef struct triheap_node {
-    struct triheap_node *parent;
-    struct triheap_node *left, *right;
-    struct triheap_node *child;
-    struct triheap_node *partner;
+    long key;
+
+    uint32_t parent;
+    uint32_t left, right;
+    uint32_t child;
+    uint32_t partner;
 
     int extra;    
     int dim;
 
-    long key;
     int vertex_no;
 } triheap_node_t;
 
@@ -66,10 +77,7 @@ typedef struct triheap_node {
  *         in the array points to the root node of a tree that has nodes of
  *         dimension i on the main trunk.
  * active - An array of pointers to active nodes in the heap.
- * nodes - An array of pointers to nodes in the heap.  Nodes are indexed
- *         according to their vertex number.  This array can then be used to
- *         look up the node corresponding to a vertex number, and is useful
- *         when freeing space taken up by the heap.
+ * nodes - The slab of nodes, indexed by vertex number.
  * max_nodes - The maximum number of nodes allowed in the heap.
  * max_trees - The maximum number of trees allowed in the heap (calculated from
  *             max_nodes).
@@ -77,15 +85,15 @@ typedef struct triheap_node {
  * value - The binary value represented by trees in the heap.
  *         By maintaining this it is easy to keep track of the maximum rank
  *         tree in the heap.
- * key_comps - can be used for experimental purposes when counting the number
- *             of key comparisons.
+ * ops - counts the operations performed on the heap, for experimental
+ *       purposes.  See opcount.h.
  */
 typedef struct triheap {
     triheap_node_t **trees;
     triheap_node_t **active;
-    triheap_node_t **nodes;
+    triheap_node_t *nodes;
     int max_nodes, max_trees, n, value;
-    long key_comps;
+    opcount_t ops;
 } triheap_t;
 
 
@@ -124,7 +132,7 @@ void trih_decrease_key(triheap_t *h, int vertex_no, long new_value);
 
 /* Debugging functions. */
 #if SHOW_trih
-void trih_dump_nodes(triheap_node_t *ptr, int level);
+void trih_dump_nodes(triheap_t *h, triheap_node_t *ptr, int level);
 void trih_dump(triheap_t *h);
 #endif
 
@@ -88,10 +88,9 @@ printf("init, ");  fflush(stdout);
      */
     h->value = 0;
 
-    /* For experimental purposes, we keep a count of the number of key
-     * comparisons.
+    /* For experimental purposes, we keep counts of the operations performed.
      */
-    h->key_comps = 0;
+    OP_RESET(h->ops);
 
     return h;
 }
@@ -136,6 +135,7 @@ printf("insert, ");  fflush(stdout);
      * NULL by trih_ext_meld().
      */
     new = malloc(sizeof(triheap_ext_node_t));
+    OP_ALLOC(h->ops);
     new->child = NULL;
     new->extra = FALSE;
     new->left = new->right = NULL;
@@ -197,7 +197,7 @@ printf("delete_min, ");  fflush(stdout);
         d--;
         next = h->trees[d];
         if(next) {
-            h->key_comps++;
+            OP_COMP(h->ops);
             if((k2 = next->key) < k) {
                 k = k2;
                 min_node = next;
@@ -209,7 +209,7 @@ printf("delete_min, ");  fflush(stdout);
     while(i > 0) {
 	i--;
         next = h->active[i];
-        h->key_comps++;
+        OP_COMP(h->ops);
         if((k2 = next->key) < k) {
             k = k2;
             min_node = next;
@@ -407,7 +407,7 @@ printf("on vertex no %d, ", min_node->vertex_no);  fflush(stdout);
 	 */
 	if(partner->active_entry) {
 	    trih_ext_deactivate(h, partner);
-            h->key_comps++;
+            OP_COMP(h->ops);
 	    if(partner->key < parent->key) {
                 /* We make the linked list point to `partner' instead of
 		 * `parent', and make parent an extra node.
@@ -511,12 +511,13 @@ void trih_ext_decrease_key(triheap_ext_t *h, int vertex_no, long new_value)
 	     * child to maintain the correct ordering.
 	     */
 
-	    h->key_comps++;
+	    OP_COMP(h->ops);
 	    if(v->key < above->key) {
 		/* swap */		    
 		v->extra = FALSE;
 		v2->extra = TRUE;
 		trih_ext_replace_child(v2, v);
+		OP_LINK(h->ops);
 	    }
 	    else {
                 /* If v remains as a second child, then only activate it if
@@ -546,7 +547,7 @@ void trih_ext_decrease_key(triheap_ext_t *h, int vertex_no, long new_value)
 
     /* Otherwise, v is the second node on a main trunk. */
 
-    h->key_comps++;
+    OP_COMP(h->ops);
     if(v->key < above->key) {
 	/* If v is smaller, we swap it with the first child (i.e. the root
 	 * node) to maintain the correct ordering.
@@ -566,6 +567,7 @@ void trih_ext_decrease_key(triheap_ext_t *h, int vertex_no, long new_value)
 
   /*------------------------------*/
   rearrange:
+    OP_RESTRUCT(h->ops);
 
     /* Get a candidate for rearrangement. */
     d = h->first_candidate->dim;
@@ -626,20 +628,22 @@ void trih_ext_decrease_key(triheap_ext_t *h, int vertex_no, long new_value)
     v2->partner = w2;  w2->partner = v2;
 	
     /* Determine the ordering in the rearrangement. */
-    h->key_comps++;
+    OP_COMP(h->ops);
     if(v2->key < w2->key) {
 	/* Make the (1st child, 2nd child) pair (v2,w2), replacing (v,v2). */
 	v2->extra = FALSE;
 	trih_ext_replace_child(v, v2);
+	OP_LINK(h->ops);
 
-	h->key_comps++;
+	OP_COMP(h->ops);
 	if(v->key < w->key) {
 	    /* Make the pair (v,w), replacing (w,w2). */
 	    w->extra = TRUE;
 	    trih_ext_replace_child(w,v);
+	    OP_LINK(h->ops);
 	    trih_ext_deactivate(h, w);
 
-	    h->key_comps++;
+	    OP_COMP(h->ops);
 	    if(w->key < v->parent->key) {
 		/* Both v and w are inconsistent, continue with promotion.
 		 * Update v2, and p;
@@ -661,7 +665,7 @@ void trih_ext_decrease_key(triheap_ext_t *h, int vertex_no, long new_value)
 	    v->extra = TRUE;
 	    trih_ext_deactivate(h, v);
 
-	    h->key_comps++;
+	    OP_COMP(h->ops);
 	    if(v->key < w->parent->key) {
 		/* Both v and w are inconsistent, so continue with promotion.
 		 * Update v, v2, and p.
@@ -681,14 +685,15 @@ void trih_ext_decrease_key(triheap_ext_t *h, int vertex_no, long new_value)
 	/* Make the pair (w2,v2), replacing (w,w2). */
 	w2->extra = FALSE;
 	trih_ext_replace_child(w, w2);
+	OP_LINK(h->ops);
 
-	h->key_comps++;
+	OP_COMP(h->ops);
 	if(v->key < w->key) {
 	    /* Make the pair (v,w), replacing (v,v2). */
 	    w->extra = TRUE;
 	    trih_ext_deactivate(h, w);
 	    
-	    h->key_comps++;
+	    OP_COMP(h->ops);
 	    if(w->key < v->parent->key) {
 		/* Both v and w are inconsistent, so continue with promotion.
 		 * Update v2.
@@ -705,9 +710,10 @@ void trih_ext_decrease_key(triheap_ext_t *h, int vertex_no, long new_value)
 	    /* Make the pair (w,v), replacing (v,v2). */
 	    v->extra = TRUE;
 	    trih_ext_replace_child(v,w);
+	    OP_LINK(h->ops);
 	    trih_ext_deactivate(h, v);
 	    
-	    h->key_comps++;
+	    OP_COMP(h->ops);
 	    if(v->key < w->parent->key) {
 		/* Both v and w are inconsistent, so continue with promotion.
 		 * Update v, v2.
@@ -736,6 +742,7 @@ void trih_ext_decrease_key(triheap_ext_t *h, int vertex_no, long new_value)
     /* First we make v2 a child node of v. */
     v2->extra = FALSE;
     trih_ext_add_child(v2, v);
+    OP_LINK(h->ops);
 		
 
     /* Then v replaces p.  Any child nodes of p that have a higher dimension
@@ -795,6 +802,7 @@ void trih_ext_decrease_key(triheap_ext_t *h, int vertex_no, long new_value)
 	    /* p is non-root node and a first child. */
 	    partner->partner = v;
 	    trih_ext_replace_child(p, v);
+	    OP_LINK(h->ops);
 	}
 	else {
 	    /* p is a root node, so update the tree pointer. */
@@ -826,7 +834,7 @@ void trih_ext_decrease_key(triheap_ext_t *h, int vertex_no, long new_value)
     if(v->extra) {
 	v2 = v->partner;
 	
-	h->key_comps++;
+	OP_COMP(h->ops);
 	if(v->key < v2->key) {
 	    /* swap */
 	    v->extra = FALSE;
@@ -836,6 +844,7 @@ void trih_ext_decrease_key(triheap_ext_t *h, int vertex_no, long new_value)
 	    if(v2->parent) {
 		/* Non-main trunk */
 	        trih_ext_replace_child(v2, v);
+	        OP_LINK(h->ops);
 	    }
 	    else {
 		/* Main trunk:  v replaces v2 as the root node. */
@@ -901,7 +910,7 @@ void trih_ext_decrease_key(triheap_ext_t *h, int vertex_no, long new_value)
  */
 void trih_ext_meld(triheap_ext_t *h, triheap_ext_node_t *tree_list)
 {
-    triheap_ext_node_t *next, *add_tree;
+    triheap_ext_node_t *next = NULL, *add_tree;
     triheap_ext_node_t *carry_tree;
     int d;
 
@@ -947,7 +956,9 @@ printf("%d, ", add_tree->vertex_no);  fflush(stdout);
          * treated as a 1-node main trunk one dimension higher up.
          */
 	if(carry_tree) {
-            h->key_comps += trih_ext_merge(&add_tree, &carry_tree);
+            OP_COMPS(h->ops, trih_ext_merge(&add_tree, &carry_tree));
+            OP_LINK(h->ops);
+            OP_RESTRUCT(h->ops);
         }
 
         /* After the merge, if add_tree is NULL, then the resulting tree
@@ -959,7 +970,9 @@ printf("%d, ", add_tree->vertex_no);  fflush(stdout);
             d = add_tree->dim;
 	    if(h->trees[d]) {
                 /* Nodes already in this main trunk position, so merge. */
-                h->key_comps += trih_ext_merge(&h->trees[d], &add_tree);
+                OP_COMPS(h->ops, trih_ext_merge(&h->trees[d], &add_tree));
+                OP_LINK(h->ops);
+                OP_RESTRUCT(h->ops);
                 if(!h->trees[d]) h->value -= (1 << d);
                 carry_tree = add_tree;
             }
@@ -967,6 +980,7 @@ printf("%d, ", add_tree->vertex_no);  fflush(stdout);
                 /* No nodes in this main trunk position, so use add_tree. */
                 h->trees[d] = add_tree;
                 h->value += (1 << d);
+                OP_DEPTH(h->ops, d);
             }
         }
 
@@ -1474,7 +1488,11 @@ int _trih_ext_n(void *h) {
 }
 
 long _trih_ext_key_comps(void *h) {
-    return ((triheap_ext_t *)h)->key_comps;
+    return ((triheap_ext_t *)h)->ops.comps;
+}
+
+const opcount_t *_trih_ext_counts(void *h) {
+    return &((triheap_ext_t *)h)->ops;
 }
 
 void *_trih_ext_alloc(int n) {
@@ -1501,5 +1519,9 @@ const heap_info_t TRIHEAP_EXT_info = {
     _trih_ext_key_comps,
     _trih_ext_alloc,
     _trih_ext_free,
-    _trih_ext_dump
+    _trih_ext_dump,
+    NULL,
+    NULL,
+    NULL,
+    _trih_ext_counts
 };
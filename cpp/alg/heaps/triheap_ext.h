@@ -107,8 +107,8 @@ typedef struct active_ptr {
  * candidate_ptrs - An array of pointers to entries in the candidate queue.
  * first_candidate - A pointer to the head of the candidate queue.
  *
- * key_comps - can be used for experimental purposes when counting the number
- *             of key comparisons.
+ * ops - counts the operations performed on the heap, for experimental
+ *       purposes.  See opcount.h.
  *
  * Note that the queues of candidate and active items are maintained using
  * circularly doubly linked lists.
@@ -123,7 +123,7 @@ typedef struct triheap_ext {
     candidate_ptr_t *first_candidate;
     
     int max_nodes, max_trees, t_limit, n, n_active, value;
-    long key_comps;
+    opcount_t ops;
 } triheap_ext_t;
 
 
@@ -17,15 +17,25 @@
 
 
 
+/*** Node links. ***/
+
+/* TTH_NODE() gives a pointer to the node with index i, or NULL if i is
+ * TTHEAP_NIL, and TTH_INDEX() gives the index of the node pointed to by p.
+ */
+#define TTH_NODE(h, i) ((i) == TTHEAP_NIL ? NULL : &(h)->nodes[i])
+#define TTH_INDEX(h, p) ((p) ? (uint32_t)((p) - (h)->nodes) : TTHEAP_NIL)
+
+
+
 /*** Prototypes of functions only visible within this file. ***/
 
 void tth_meld(ttheap_t *h, ttheap_node_t *tree_list);
-int merge(ttheap_node_t **a, ttheap_node_t **b);
+int merge(ttheap_t *h, ttheap_node_t **a, ttheap_node_t **b);
 void remove_node(ttheap_t *h, ttheap_node_t *cut_node);
-void trim_xnode(ttheap_node_t *x);
-void add_child(ttheap_node_t *p, ttheap_node_t *c);
-void replace_node(ttheap_node_t *old, ttheap_node_t *new);
-void swap_trunks(ttheap_node_t *tr_low, ttheap_node_t *tr_high);
+void trim_xnode(ttheap_t *h, ttheap_node_t *x);
+void add_child(ttheap_t *h, ttheap_node_t *p, ttheap_node_t *c);
+void replace_node(ttheap_t *h, ttheap_node_t *old, ttheap_node_t *new);
+void swap_trunks(ttheap_t *h, ttheap_node_t *tr_low, ttheap_node_t *tr_high);
 
 
 
@@ -53,7 +63,7 @@ printf("init, ");  fflush(stdout);
      * calloc() initialises all array entries to zero, that is, NULL pointers.
      */
     h->trees = calloc(h->max_trees, sizeof(ttheap_node_t *));
-    h->nodes = calloc(max_nodes, sizeof(ttheap_node_t *));
+    h->nodes = malloc(max_nodes * sizeof(ttheap_node_t));
 
     /* We begin with no nodes in the heap. */
     h->n = 0;
@@ -63,10 +73,9 @@ printf("init, ");  fflush(stdout);
      */
     h->value = 0;
 
-    /* For experimental purposes, we keep a count of the number of key
-     * comparisons.
+    /* For experimental purposes, we keep counts of the operations performed.
      */
-    h->key_comps = 0;
+    OP_RESET(h->ops);
 
     return h;
 }
@@ -77,16 +86,10 @@ printf("init, ");  fflush(stdout);
  */
 void tth_free(ttheap_t *h)
 {
-    int i;
-
 #if TTHEAP_DUMP
 printf("free, ");  fflush(stdout);
 #endif
 
-    for(i = 0; i < h->max_nodes; i++) {
-        free(h->nodes[i]);
-    }
-
     free(h->nodes);
     free(h->trees);
     free(h);
@@ -108,19 +111,16 @@ void tth_insert(ttheap_t *h, int vertex_no, long k)
 printf("insert, ");  fflush(stdout);
 #endif
 
-    /* Create an initialise the new node.  The parent pointer will be set to
-     * NULL by tth_meld().
+    /* Initialise the new node, which already has space in the slab.  The
+     * parent link will be set to TTHEAP_NIL by tth_meld().
      */
-    new = malloc(sizeof(ttheap_node_t));
-    new->child = NULL;
-    new->left = new->right = NULL;
+    new = &h->nodes[vertex_no];
+    new->child = TTHEAP_NIL;
+    new->left = new->right = TTHEAP_NIL;
     new->dim = 0;
     new->vertex_no = vertex_no;
     new->key = k;
 
-    /* Maintain a pointer to vertex_no's new node in the heap. */
-    h->nodes[vertex_no] = new;
-
     /* Meld the new node into the heap. */
     tth_meld(h, new);
 
@@ -167,7 +167,7 @@ printf("delete_min, ");  fflush(stdout);
                 k = k2;
                 min_node = next;
             }
-            h->key_comps++;
+            OP_COMP(h->ops);
         }
     }
 
@@ -177,25 +177,23 @@ printf("delete_min, ");  fflush(stdout);
     h->value -= (1 << r);
     h->n--;
 
-    /* A nodes child pointer always points to the child with the highest rank,
+    /* A nodes child link always refers to the child with the highest rank,
      * so child->right is the smallest rank.  For melding the linked list
-     * starting at child->right we terminate the circular link with a NULL
-     * pointer.
+     * starting at child->right we terminate the circular link with
+     * TTHEAP_NIL.
      */
-    child = min_node->child;
+    child = TTH_NODE(h, min_node->child);
         if(child) {
-        next = child->right;
-        next->left = child->right = NULL;
+        next = TTH_NODE(h, child->right);
+        next->left = child->right = TTHEAP_NIL;
         tth_meld(h, next);
     }
 
-    /* Record the vertex no to return. */
+    /* Record the vertex no to return.  The old minimum node's space in the
+     * slab is kept for reuse.
+     */
     vertex_no = min_node->vertex_no;
 
-    /* Delete the old minimum node. */
-    h->nodes[vertex_no] = NULL;
-    free(min_node);
-
 #if TTHEAP_DUMP
 printf("delete_min-exited, ");  fflush(stdout);
 #endif
@@ -218,8 +216,8 @@ printf("decrease_key on vn = %d, ", vertex_no);  fflush(stdout);
 #endif
 
     /* Obtain a pointer to the decreased node and its parent and child.*/
-    cut_node = h->nodes[vertex_no];
-    parent = cut_node->parent;
+    cut_node = &h->nodes[vertex_no];
+    parent = TTH_NODE(h, cut_node->parent);
     cut_node->key = new_value;
 
     /* No reinsertion occurs if the node changed was a root. */
@@ -232,7 +230,7 @@ printf("decrease_key-exited, ");  fflush(stdout);
 
     /* Now remove the node and its tree and reinsert it. */
     remove_node(h, cut_node);
-    cut_node->right = cut_node->left = NULL;
+    cut_node->right = cut_node->left = TTHEAP_NIL;
     tth_meld(h, cut_node);
 
 #if TTHEAP_DUMP
@@ -246,13 +244,13 @@ printf("decrease_key-exited, ");  fflush(stdout);
 /*** Definitions of functions only visible within this file. ***/
 
 /* tth_meld() - melds  the linked list of trees pointed to by *tree_list into
- * the heap pointed to by h.  This function uses the `right' sibling pointer
- * of nodes to traverse the linked list from lower dimension nodes to higher
- * dimension nodes.  It expects the last nodes `right' pointer to be NULL.
+ * the heap pointed to by h.  This function uses the `right' sibling link of
+ * nodes to traverse the linked list from lower dimension nodes to higher
+ * dimension nodes.  It expects the last nodes `right' link to be TTHEAP_NIL.
  */
 void tth_meld(ttheap_t *h, ttheap_node_t *tree_list)
 {
-    ttheap_node_t *next, *add_tree;
+    ttheap_node_t *next = NULL, *add_tree;
     ttheap_node_t *carry_tree;
     int d;
 
@@ -279,9 +277,9 @@ printf("meld - ");  fflush(stdout);
          * there is only a carry_tree to be merged, so treat it like add_tree.
          */
         if(add_tree) {
-            next = add_tree->right;
-            add_tree->right = add_tree->left = add_tree;
-            add_tree->parent = NULL;
+            next = TTH_NODE(h, add_tree->right);
+            add_tree->right = add_tree->left = TTH_INDEX(h, add_tree);
+            add_tree->parent = TTHEAP_NIL;
         }
         else {
             add_tree = carry_tree;
@@ -298,7 +296,9 @@ printf("%d, ", add_tree->vertex_no);  fflush(stdout);
          * treated as a 1-node main trunk one dimension higher up.
          */
         if(carry_tree) {
-            h->key_comps += merge(&add_tree, &carry_tree);
+            OP_COMPS(h->ops, merge(h, &add_tree, &carry_tree));
+            OP_LINK(h->ops);
+            OP_RESTRUCT(h->ops);
         }
 
         /* After the merge, if add_tree is NULL, then the resulting tree
@@ -310,7 +310,9 @@ printf("%d, ", add_tree->vertex_no);  fflush(stdout);
             d = add_tree->dim;
             if(h->trees[d]) {
                 /* Nodes already in this main trunk position, so merge. */
-                h->key_comps += merge(&h->trees[d], &add_tree);
+                OP_COMPS(h->ops, merge(h, &h->trees[d], &add_tree));
+                OP_LINK(h->ops);
+                OP_RESTRUCT(h->ops);
                 if(!h->trees[d]) h->value -= (1 << d);
                 carry_tree = add_tree;
             }
@@ -318,6 +320,7 @@ printf("%d, ", add_tree->vertex_no);  fflush(stdout);
                 /* No nodes in this main trunk position, so use add_tree. */
                 h->trees[d] = add_tree;
                 h->value += (1 << d);
+                OP_DEPTH(h->ops, d);
             }
         }
 
@@ -344,7 +347,7 @@ printf("meld-exited, ");  fflush(stdout);
  *
  * Returns the number of key comparisons used.
  */
-int merge(ttheap_node_t **a, ttheap_node_t **b)
+int merge(ttheap_t *h, ttheap_node_t **a, ttheap_node_t **b)
 {
     ttheap_node_t *tree, *next_tree, *other, *next_other;
     int c;
@@ -371,9 +374,9 @@ int merge(ttheap_node_t **a, ttheap_node_t **b)
      * next_other points to the next node on the trunk that `other' is the head
      * of (if there is another node).
      */
-    next_tree = tree->child;
+    next_tree = TTH_NODE(h, tree->child);
     if(next_tree && next_tree->dim != other->dim) next_tree = NULL;
-    next_other = other->child;
+    next_other = TTH_NODE(h, other->child);
     if(next_other && next_other->dim != other->dim) next_other = NULL;
 
     /* The merging depends on the existence of nodes and the values of keys. */
@@ -383,7 +386,7 @@ int merge(ttheap_node_t **a, ttheap_node_t **b)
          * tree.
          */
 
-        add_child(tree, other);
+        add_child(h, tree, other);
         if(next_other) {
             tree->dim++;
             *a = NULL;  *b = tree;
@@ -399,11 +402,11 @@ int merge(ttheap_node_t **a, ttheap_node_t **b)
          */
 
         if(other->key < next_tree->key) {
-            add_child(next_tree, other);
+            add_child(h, next_tree, other);
         }
         else {
-            replace_node(next_tree, other);
-            add_child(other, next_tree);
+            replace_node(h, next_tree, other);
+            add_child(h, other, next_tree);
         }
         c++;
         tree->dim++;
@@ -416,9 +419,9 @@ int merge(ttheap_node_t **a, ttheap_node_t **b)
          * and (next_tree).  This uses no key comparisons.
          */
 
-        replace_node(next_tree, other);
-        next_tree->left = next_tree->right = next_tree;
-        next_tree->parent = NULL;
+        replace_node(h, next_tree, other);
+        next_tree->left = next_tree->right = TTH_INDEX(h, next_tree);
+        next_tree->parent = TTHEAP_NIL;
         tree->dim++;
         *a = next_tree;  *b = tree;
     }
@@ -436,29 +439,33 @@ void remove_node(ttheap_t *h, ttheap_node_t *r_node)
     ttheap_node_t *parent, *child, *ax, *bx, *ap, *bp, *b1, *c, *p;
     int d, d1;
 
-    parent = r_node->parent;
-    child = r_node->child;
+    parent = TTH_NODE(h, r_node->parent);
+    child = TTH_NODE(h, r_node->child);
     d = r_node->dim;
 
     /* If this node is an extra node we simply cut the link between it and its
      * parent and update its sibling pointers.
      */
     if(d == parent->dim) {
-        trim_xnode(r_node);
+        trim_xnode(h, r_node);
+        OP_LINK(h->ops);
     }
     /* Else if its child is an extra node then use its child to replace it. */
     else if(child && child->dim == d) {
 
         /* First we remove the child. */
-        trim_xnode(child);
+        trim_xnode(h, child);
+        OP_LINK(h->ops);
 
         /* Now we put the child in r_nodes position. */
-        replace_node(r_node, child);
+        replace_node(h, r_node, child);
+        OP_LINK(h->ops);
 
     }
     /* Otherwise we need some rearrangement of the workspace. */
     else {
-        
+        OP_RESTRUCT(h->ops);
+
         /* Look at up to two similar nodes in the work space and determine if
          * they have an extra node under them.  Nodes relative to the node
          * being removed are pointed to by the pointers ax, ap, bx, and bp.
@@ -472,9 +479,9 @@ void remove_node(ttheap_t *h, ttheap_node_t *r_node)
          */
 
         /* Check for nodes on a similar trunk above in the work space. */
-        p = r_node->parent->left;
+        p = TTH_NODE(h, TTH_NODE(h, r_node->parent)->left);
         if (p->dim == d) {
-            c = p->child;
+            c = TTH_NODE(h, p->child);
             if(c && c->dim == d) {
                 ax = c;  ap = NULL;
             }
@@ -488,12 +495,12 @@ void remove_node(ttheap_t *h, ttheap_node_t *r_node)
 
         /* Check for nodes on a similar trunk below in the work space. */
         d1 = d + 1;
-        p = r_node->right;
+        p = TTH_NODE(h, r_node->right);
         if (p->dim == d1) {
-            p = p->child;
-            if(p->dim == d1) p = p->left;
+            p = TTH_NODE(h, p->child);
+            if(p->dim == d1) p = TTH_NODE(h, p->left);
 
-            c = p->child;
+            c = TTH_NODE(h, p->child);
             if(c && c->dim == d) {
                 bx = c;  bp = NULL;
             }
@@ -509,20 +516,23 @@ void remove_node(ttheap_t *h, ttheap_node_t *r_node)
         if(bx) {
 
             /* First break `bx's parent link and sibling links. */
-            trim_xnode(bx);
+            trim_xnode(h, bx);
+            OP_LINK(h->ops);
 
             /* Then we insert bx in r_nodes place. */
-            replace_node(r_node, bx);
+            replace_node(h, r_node, bx);
+            OP_LINK(h->ops);
         }
         else if(bp) {
 
-            b1 = bp->parent;
+            b1 = TTH_NODE(h, bp->parent);
 
             /* Recursively remove b1. */
             remove_node(h, b1);
             b1->dim = d;
 
-            replace_node(r_node, b1);
+            replace_node(h, r_node, b1);
+            OP_LINK(h->ops);
 
             /* It may improve speed by using trim_xnode() when recursion can be
              * avoided.
@@ -531,8 +541,10 @@ void remove_node(ttheap_t *h, ttheap_node_t *r_node)
         else if(ax) {
 
             /* Bend the tree to modify its shape then remove r_node. */
-            swap_trunks(ax->parent, parent);
-            trim_xnode(r_node);
+            swap_trunks(h, TTH_NODE(h, ax->parent), parent);
+            OP_LINK(h->ops);
+            trim_xnode(h, r_node);
+            OP_LINK(h->ops);
         }
         else if(ap) {
 
@@ -540,19 +552,22 @@ void remove_node(ttheap_t *h, ttheap_node_t *r_node)
              * larger key value.
              */
             if(parent->key < ap->key) {
-                swap_trunks(ap, parent);
+                swap_trunks(h, ap, parent);
+                OP_LINK(h->ops);
                 p = parent;
                 parent = ap;
                 ap = p;
             }
-            h->key_comps++;
+            OP_COMP(h->ops);
 
-            trim_xnode(r_node);
+            trim_xnode(h, r_node);
+            OP_LINK(h->ops);
             remove_node(h, parent);
             parent->dim = d;
 
             /* Make parent the child of ap. */
-            add_child(ap, parent);
+            add_child(h, ap, parent);
+            OP_LINK(h->ops);
         }
         else {
             /* The work space only has r_node node and parent.  This only
@@ -565,8 +580,9 @@ void remove_node(ttheap_t *h, ttheap_node_t *r_node)
             h->value -= (1 << (d+1));
 
             parent->dim = d;
-            trim_xnode(r_node);
-            parent->left = parent->right = NULL;
+            trim_xnode(h, r_node);
+            OP_LINK(h->ops);
+            parent->left = parent->right = TTHEAP_NIL;
 
             tth_meld(h, parent);
         }
@@ -576,7 +592,7 @@ void remove_node(ttheap_t *h, ttheap_node_t *r_node)
 
 /* trim_xnode() - trims an extra node, x, from its trunk.
  */
-void trim_xnode(ttheap_node_t *x)
+void trim_xnode(ttheap_t *h, ttheap_node_t *x)
 {
     ttheap_node_t *l, *r;
 
@@ -585,17 +601,17 @@ void trim_xnode(ttheap_node_t *x)
          * children.
          */
         
-        x->parent->child = NULL;
+        TTH_NODE(h, x->parent)->child = TTHEAP_NIL;
     }
     else {
         /* Otherwise, sibling pointers of other child nodes must be updated. */
         
-        l = x->left;
-        r = x->right;
-        l->right = r;
-        r->left = l;
+        l = TTH_NODE(h, x->left);
+        r = TTH_NODE(h, x->right);
+        l->right = TTH_INDEX(h, r);
+        r->left = TTH_INDEX(h, l);
 
-        x->parent->child = l;
+        TTH_NODE(h, x->parent)->child = TTH_INDEX(h, l);
     }
 }
 
@@ -604,7 +620,7 @@ void trim_xnode(ttheap_node_t *x)
  * (i+1)th trunk, tr_high, share the same parent, this function is used for
  * swapping them.
  */
-void swap_trunks(ttheap_node_t *tr_low, ttheap_node_t *tr_high)
+void swap_trunks(ttheap_t *h, ttheap_node_t *tr_low, ttheap_node_t *tr_high)
 {
     int d;
     ttheap_node_t *parent, *l, *r;
@@ -615,39 +631,39 @@ void swap_trunks(ttheap_node_t *tr_low, ttheap_node_t *tr_high)
     tr_high->dim = d;
 
     /* Obtain a pointer to the parent of both nodes. */
-    parent = tr_high->parent;
+    parent = TTH_NODE(h, tr_high->parent);
 
     /* If the left sibling of tr_low is not tr_high, we need to update sibling
      * pointers.  Otherwise, the child pointer of the common parent now
      * points to tr_low.
      */
-    if((l = tr_low->left) != tr_high) {
+    if((l = TTH_NODE(h, tr_low->left)) != tr_high) {
 
         /* Update sibling pointers. */
-        r = tr_high->right;
-        tr_high->left = l;
-        tr_low->right = r;
-        tr_high->right = tr_low;
-        tr_low->left = tr_high;
-        l->right = tr_high;
-        r->left = tr_low;
+        r = TTH_NODE(h, tr_high->right);
+        tr_high->left = TTH_INDEX(h, l);
+        tr_low->right = TTH_INDEX(h, r);
+        tr_high->right = TTH_INDEX(h, tr_low);
+        tr_low->left = TTH_INDEX(h, tr_high);
+        l->right = TTH_INDEX(h, tr_high);
+        r->left = TTH_INDEX(h, tr_low);
 
         /* Determine if the child pointer of the common parent will need to be
          * updated.
          */
-        if(parent->child == tr_high) {
-            parent->child = tr_low;
+        if(parent->child == TTH_INDEX(h, tr_high)) {
+            parent->child = TTH_INDEX(h, tr_low);
         }
     }
     else {
-        parent->child = tr_low;
+        parent->child = TTH_INDEX(h, tr_low);
     }
 }
 
 
 /* add_child() - makes node c and its tree a child of node p.
  */
-void add_child(ttheap_node_t *p, ttheap_node_t *c)
+void add_child(ttheap_t *h, ttheap_node_t *p, ttheap_node_t *c)
 {
     ttheap_node_t *l, *r;
 
@@ -655,52 +671,52 @@ void add_child(ttheap_node_t *p, ttheap_node_t *c)
      * Otherwise only initialise the left and right pointers of the added
      * child.
      */
-    if((l = p->child)) {
-        r = l->right;
-        c->left = l;
-        c->right = r;
-        r->left = c;
-        l->right = c;
+    if((l = TTH_NODE(h, p->child))) {
+        r = TTH_NODE(h, l->right);
+        c->left = TTH_INDEX(h, l);
+        c->right = TTH_INDEX(h, r);
+        r->left = TTH_INDEX(h, c);
+        l->right = TTH_INDEX(h, c);
     }
     else {
-        c->left = c->right = c;
+        c->left = c->right = TTH_INDEX(h, c);
     }
 
-    p->child = c;
-    c->parent = p;
+    p->child = TTH_INDEX(h, c);
+    c->parent = TTH_INDEX(h, p);
 }
 
 
 /* replace_node() - replaces node `old' and its sub-tree with node `new' and
  * its sub-tree.
  */
-void replace_node(ttheap_node_t *old, ttheap_node_t *new)
+void replace_node(ttheap_t *h, ttheap_node_t *old, ttheap_node_t *new)
 {
     ttheap_node_t *parent, *l, *r;
 
-    l = old->left;
-    r = old->right;
+    l = TTH_NODE(h, old->left);
+    r = TTH_NODE(h, old->right);
 
     /* If `old' is an only child we only need to initialise the sibling
      * pointers of the new node.  Otherwise we update sibling pointers of other
      * child nodes.
      */
     if(r == old) {
-        new->right = new->left = new;
+        new->right = new->left = TTH_INDEX(h, new);
     }
     else {
-        l->right = new;
-        r->left = new;
-        new->left = l;
-        new->right = r;
+        l->right = TTH_INDEX(h, new);
+        r->left = TTH_INDEX(h, new);
+        new->left = TTH_INDEX(h, l);
+        new->right = TTH_INDEX(h, r);
     }
 
     /* Update parent pointer of the new node and possibly the child pointer
      * of the parent node.
      */
-    parent = old->parent;
-    new->parent = parent;
-    if(parent->child == old) parent->child = new;
+    parent = TTH_NODE(h, old->parent);
+    new->parent = TTH_INDEX(h, parent);
+    if(parent->child == TTH_INDEX(h, old)) parent->child = TTH_INDEX(h, new);
 }
 
 
@@ -709,7 +725,7 @@ void replace_node(ttheap_node_t *old, ttheap_node_t *new)
 
 /* Recursively print the nodes of a 2-3 heap. */
 #if TTHEAP_DUMP
-void tth_dump_nodes(ttheap_node_t *ptr, int level)
+void tth_dump_nodes(ttheap_t *h, ttheap_node_t *ptr, int level)
 {
      ttheap_node_t *child_ptr, *partner;
      int i, ch_count;
@@ -719,24 +735,24 @@ void tth_dump_nodes(ttheap_node_t *ptr, int level)
 
      printf("%d(%ld)\n", ptr->vertex_no, ptr->key);
      
-     if((child_ptr = ptr->child)) {
-	 child_ptr = ptr->child->right;
+     if((child_ptr = TTH_NODE(h, ptr->child))) {
+	 child_ptr = TTH_NODE(h, TTH_NODE(h, ptr->child)->right);
 	 
          ch_count = 0;
 
          do {
-             tth_dump_nodes(child_ptr, level+1);
+             tth_dump_nodes(h, child_ptr, level+1);
 	     if(child_ptr->dim != ch_count) {
                  for(i = 0; i < level+1; i++) printf("   ");
 		 printf("error(dim)\n");  exit(1);
 	     }
-	     if(child_ptr->parent != ptr) {
+	     if(child_ptr->parent != TTH_INDEX(h, ptr)) {
                  for(i = 0; i < level+1; i++) printf("   ");
 		 printf("error(parent)\n");
 	     }
-             child_ptr = child_ptr->right;
+             child_ptr = TTH_NODE(h, child_ptr->right);
 	     ch_count++;
-         } while(child_ptr != ptr->child->right);
+         } while(child_ptr != TTH_NODE(h, TTH_NODE(h, ptr->child)->right));
 
          if(ch_count != ptr->dim && ch_count != ptr->dim + 1) {
 	     for(i = 0; i < level; i++) printf("   ");
@@ -770,7 +786,7 @@ void tth_dump(ttheap_t *h)
     for(i=0; i<h->max_trees; i++) {
         if((ptr = h->trees[i])) {
             printf("tree %d\n\n", i);
-            tth_dump_nodes(ptr, 0);
+            tth_dump_nodes(h, ptr, 0);
 	    printf("\n");
         }
     }
@@ -800,7 +816,11 @@ int _tth_n(void *h) {
 }
 
 long _tth_key_comps(void *h) {
-    return ((ttheap_t *)h)->key_comps;
+    return ((ttheap_t *)h)->ops.comps;
+}
+
+const opcount_t *_tth_counts(void *h) {
+    return &((ttheap_t *)h)->ops;
 }
 
 void *_tth_alloc(int n) {
@@ -826,5 +846,9 @@ const heap_info_t TTHEAP_info = {
     _tth_key_comps,
     _tth_alloc,
     _tth_free,
-    _tth_dump
+    _tth_dump,
+    NULL,
+    NULL,
+    NULL,
+    _tth_counts
 };
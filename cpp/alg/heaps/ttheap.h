@@ -5,6 +5,7 @@
 /*
  *   Shane Saunders
  */
+#include <stdint.h>
 #include "heap_info.h"  /* Defines the uiversal heap structure type. */
 
 /* This 2-3 heap implementation uses the same kind of pointer structure for
@@ -21,17 +22,25 @@
 /*** Option to print debugging information.  Use 1 for yes, or 0 for no. ***/
 #define TTHEAP_DUMP 0
 
+/* The link value used in place of a NULL pointer. */
+#define TTHEAP_NIL 0xffffffffU
+
 
 
 /*** Structure Types ***/
 
 /* The structure type for 2-3 heap nodes.
  *
- * The pointer `parent' points to a nodes parent, and `child' points to the
+ * All nodes are kept in one array, the heap's slab, and the node for vertex v
+ * is slab entry v.  Nodes are linked by their 32-bit indices in the slab
+ * rather than by pointers, with TTHEAP_NIL for no node.  This makes a node 32
+ * bytes instead of 48 on machines with 64-bit pointers.
+ *
+ * The link `parent' refers to a nodes parent, and `child' refers to the
  * highest dimension child in a circular doubly linked list of child nodes.
  * The circular doubly linked list of child nodes is maintained using the
- * sibling pointers `left' and `right'.  The parent pointer of root nodes is
- * NULL.
+ * sibling links `left' and `right'.  The parent link of root nodes is
+ * TTHEAP_NIL.
  *
  * The remaining structure fields are:
  * `dim'       - the nodes dimension.
@@ -44,11 +53,11 @@
  * dimension of a single node with no children is zero.
  */
 typedef struct ttheap_node {
-    struct ttheap_node *parent;
-    struct ttheap_node *child;
-    struct ttheap_node *left, *right;
-    int dim;
+    uint32_t parent;
+    uint32_t child;
+    uint32_t left, right;
     long key;
+    int dim;
     int vertex_no;
 } ttheap_node_t;
 
@@ -57,10 +66,7 @@ typedef struct ttheap_node {
  * trees - An array of pointers to trees at root level in the heap.  Entry i
  *         in the array points to the root node of a tree that has nodes of
  *         dimension i on the main trunk.
- * nodes - An array of pointers to nodes in the heap.  Nodes are indexed
- *         according to their vertex number.  This array can then be used to
- *         look up the node for corresponding to a vertex number, and is
- *         useful when freeing space taken up by the heap.
+ * nodes - The slab of nodes, indexed by vertex number.
  * max_nodes - The maximum number of nodes allowed in the heap.
  * max_trees - The maximum number of trees allowed in the heap (calculated from
  *             max_nodes).
@@ -68,14 +74,14 @@ typedef struct ttheap_node {
  * value - The binary value represented by trees in the heap.
  *         By maintaining this it is easy to keep track of the maximum rank
  *         tree in the heap.
- * key_comps - can be used for experimental purposes when counting the number
- *             of key comparisons.
+ * ops - counts the operations performed on the heap, for experimental
+ *       purposes.  See opcount.h.
  */
 typedef struct ttheap {
     ttheap_node_t **trees;
-    ttheap_node_t **nodes;
+    ttheap_node_t *nodes;
     int max_nodes, max_trees, n, value;
-    long key_comps;
+    opcount_t ops;
 } ttheap_t;
 
 
@@ -113,7 +119,7 @@ void tth_decrease_key(ttheap_t *h, int vertex_no, long new_value);
 
 /* Debugging functions. */
 #if TTHEAP_DUMP
-void tth_dump_nodes(ttheap_node_t *ptr, int level)
+void tth_dump_nodes(ttheap_t *h, ttheap_node_t *ptr, int level);
 void tth_dump(ttheap_t *h);
 #endif
 
@@ -21,14 +21,24 @@
 
 
 
+/*** Node links. ***/
+
+/* TTH_NODE() gives a pointer to the node with index i, or NULL if i is
+ * TTHEAP_NIL, and TTH_INDEX() gives the index of the node pointed to by p.
+ */
+#define TTH_NODE(h, i) ((i) == TTHEAP_NIL ? NULL : &(h)->nodes[i])
+#define TTH_INDEX(h, p) ((p) ? (uint32_t)((p) - (h)->nodes) : TTHEAP_NIL)
+
+
+
 /*** Prototypes of functions only visible within this file. ***/
 
 void meld(ttheap_t *h, ttheap_node_t *tree_list);
-int merge(ttheap_node_t **a, ttheap_node_t **b);
+int merge(ttheap_t *h, ttheap_node_t **a, ttheap_node_t **b);
 void remove_node(ttheap_t *h, ttheap_node_t *cut_node);
-void remove_child(ttheap_node_t *c, ttheap_node_t *p);
-void add_child(ttheap_node_t *c, ttheap_node_t *p);
-void replace_child(ttheap_node_t *old, ttheap_node_t *new);
+void remove_child(ttheap_t *h, ttheap_node_t *c, ttheap_node_t *p);
+void add_child(ttheap_t *h, ttheap_node_t *c, ttheap_node_t *p);
+void replace_child(ttheap_t *h, ttheap_node_t *old, ttheap_node_t *new);
 
 
 
@@ -57,7 +67,7 @@ printf("init, ");  fflush(stdout);
      * calloc() initialises all array entries to zero, that is, NULL pointers.
      */
     h->trees = calloc(h->max_trees, sizeof(ttheap_node_t *));
-    h->nodes = calloc(max_nodes, sizeof(ttheap_node_t *));
+    h->nodes = malloc(max_nodes * sizeof(ttheap_node_t));
 
     /* We begin with no nodes in the heap. */
     h->n = 0;
@@ -67,10 +77,9 @@ printf("init, ");  fflush(stdout);
      */
     h->value = 0;
 
-    /* For experimental purposes, we keep a count of the number of key
-     * comparisons.
+    /* For experimental purposes, we keep counts of the operations performed.
      */
-    h->key_comps = 0;
+    OP_RESET(h->ops);
 
     return h;
 }
@@ -81,16 +90,10 @@ printf("init, ");  fflush(stdout);
  */
 void tth_free(ttheap_t *h)
 {
-    int i;
-
 #if TTHEAP_DUMP
 printf("free, ");  fflush(stdout);
 #endif
 
-    for(i = 0; i < h->max_nodes; i++) {
-        free(h->nodes[i]);
-    }
-
     free(h->nodes);
     free(h->trees);
     free(h);
@@ -111,22 +114,19 @@ void tth_insert(ttheap_t *h, int vertex_no, long k)
 printf("insert, ");  fflush(stdout);
 #endif
 
-    /* Create an initialise the new node.  The parent pointer will be set to
-     * NULL by meld().
+    /* Initialise the new node, which already has space in the slab.  The
+     * parent link will be set to TTHEAP_NIL by meld().
      */
-    new = malloc(sizeof(ttheap_node_t));
-    new->child = NULL;
+    new = &h->nodes[vertex_no];
+    new->child = TTHEAP_NIL;
     new->extra = FALSE;
-    new->left = new->right = NULL;
-    new->partner = NULL;
+    new->left = new->right = TTHEAP_NIL;
+    new->partner = TTHEAP_NIL;
 
     new->dim = 0;
     new->vertex_no = vertex_no;
     new->key = k;
 
-    /* Maintain a pointer to vertex_no's new node in the heap. */
-    h->nodes[vertex_no] = new;
-
     /* Meld the new node into the heap. */
     meld(h, new);
 
@@ -173,7 +173,7 @@ printf("delete_min, ");  fflush(stdout);
                 k = k2;
                 min_node = next;
             }
-            h->key_comps++;
+            OP_COMP(h->ops);
         }
     }
 
@@ -182,11 +182,11 @@ printf("delete_min, ");  fflush(stdout);
      * partner node.
      */
     r = min_node->dim;
-    if((partner = min_node->partner)) {
-	partner->partner = NULL;
+    if((partner = TTH_NODE(h, min_node->partner))) {
+	partner->partner = TTHEAP_NIL;
 	partner->extra = FALSE;
-	partner->parent = NULL;
-	partner->left = partner->right = partner;
+	partner->parent = TTHEAP_NIL;
+	partner->left = partner->right = TTH_INDEX(h, partner);
 	h->trees[r] = partner;
     }
     else {
@@ -195,25 +195,23 @@ printf("delete_min, ");  fflush(stdout);
     }
     h->n--;
 
-    /* A nodes child pointer always points to the child with the highest rank,
+    /* A nodes child link always refers to the child with the highest rank,
      * so child->right is the smallest rank.  For melding the linked list
-     * starting at child->right we terminate the circular link with a NULL
-     * pointer.
+     * starting at child->right we terminate the circular link with
+     * TTHEAP_NIL.
      */
-    child = min_node->child;
+    child = TTH_NODE(h, min_node->child);
     if(child) {
-        next = child->right;
-        next->left = child->right = NULL;
+        next = TTH_NODE(h, child->right);
+        next->left = child->right = TTHEAP_NIL;
         meld(h, next);
     }
 
-    /* Record the vertex no to return. */
+    /* Record the vertex no to return.  The old minimum node's space in the
+     * slab is kept for reuse.
+     */
     vertex_no = min_node->vertex_no;
 
-    /* Delete the old minimum node. */
-    h->nodes[vertex_no] = NULL;
-    free(min_node);
-
 #if TTHEAP_DUMP
 printf("delete_min-exited, ");  fflush(stdout);
 #endif
@@ -236,11 +234,11 @@ printf("decrease_key on vn = %d, ", vertex_no);  fflush(stdout);
 #endif
 
     /* Obtain a pointer to the decreased node and its parent and child.*/
-    cut_node = h->nodes[vertex_no];
+    cut_node = &h->nodes[vertex_no];
     cut_node->key = new_value;
 
     /* No reinsertion occurs if the node changed was a root. */
-    if(!(cut_node->parent || cut_node->extra)) {
+    if(cut_node->parent == TTHEAP_NIL && !cut_node->extra) {
 #if TTHEAP_DUMP
 printf("decrease_key-exited, ");  fflush(stdout);
 #endif
@@ -250,7 +248,7 @@ printf("decrease_key-exited, ");  fflush(stdout);
     /* Now remove the node and its tree and reinsert it. */
     remove_node(h, cut_node);
 
-    cut_node->right = cut_node->left = NULL;
+    cut_node->right = cut_node->left = TTHEAP_NIL;
 
     meld(h, cut_node);
 
@@ -265,9 +263,9 @@ printf("decrease_key-exited, ");  fflush(stdout);
 /*** Definitions of functions only visible within this file. ***/
 
 /* meld() - melds  the linked list of trees pointed to by *tree_list into
- * the heap pointed to by h.  This function uses the `right' sibling pointer
- * of nodes to traverse the linked list from lower dimension nodes to higher
- * dimension nodes.  It expects the last nodes `right' pointer to be NULL.
+ * the heap pointed to by h.  This function uses the `right' sibling link of
+ * nodes to traverse the linked list from lower dimension nodes to higher
+ * dimension nodes.  It expects the last nodes `right' link to be TTHEAP_NIL.
  */
 void meld(ttheap_t *h, ttheap_node_t *tree_list)
 {
@@ -298,9 +296,9 @@ printf("meld - ");  fflush(stdout);
          * there is only a carry_tree to be merged, so treat it like add_tree.
          */
         if(add_tree) {
-            next = add_tree->right;
-            add_tree->right = add_tree->left = add_tree;
-            add_tree->parent = NULL;
+            next = TTH_NODE(h, add_tree->right);
+            add_tree->right = add_tree->left = TTH_INDEX(h, add_tree);
+            add_tree->parent = TTHEAP_NIL;
         }
         else {
             add_tree = carry_tree;
@@ -317,7 +315,9 @@ printf("%d, ", add_tree->vertex_no);  fflush(stdout);
          * treated as a 1-node main trunk one dimension higher up.
          */
 	if(carry_tree) {
-            h->key_comps += merge(&add_tree, &carry_tree);
+            OP_COMPS(h->ops, merge(h, &add_tree, &carry_tree));
+            OP_LINK(h->ops);
+            OP_RESTRUCT(h->ops);
         }
 
         /* After the merge, if add_tree is NULL, then the resulting tree
@@ -329,7 +329,9 @@ printf("%d, ", add_tree->vertex_no);  fflush(stdout);
             d = add_tree->dim;
 	    if(h->trees[d]) {
                 /* Nodes already in this main trunk position, so merge. */
-                h->key_comps += merge(&h->trees[d], &add_tree);
+                OP_COMPS(h->ops, merge(h, &h->trees[d], &add_tree));
+                OP_LINK(h->ops);
+                OP_RESTRUCT(h->ops);
                 if(!h->trees[d]) h->value -= (1 << d);
                 carry_tree = add_tree;
             }
@@ -337,6 +339,7 @@ printf("%d, ", add_tree->vertex_no);  fflush(stdout);
                 /* No nodes in this main trunk position, so use add_tree. */
                 h->trees[d] = add_tree;
                 h->value += (1 << d);
+                OP_DEPTH(h->ops, d);
             }
         }
 
@@ -363,7 +366,7 @@ printf("meld-exited, ");  fflush(stdout);
  *
  * Returns the number of key comparisons used.
  */
-int merge(ttheap_node_t **a, ttheap_node_t **b)
+int merge(ttheap_t *h, ttheap_node_t **a, ttheap_node_t **b)
 {
     ttheap_node_t *tree, *next_tree, *other, *next_other;
     int c;
@@ -390,8 +393,8 @@ int merge(ttheap_node_t **a, ttheap_node_t **b)
      * next_other points to the next node on the trunk that `other' is the head
      * of (if there is another node).
      */
-    next_tree = tree->partner;
-    next_other = other->partner;
+    next_tree = TTH_NODE(h, tree->partner);
+    next_other = TTH_NODE(h, other->partner);
 
     /* The merging depends on the existence of nodes and the values of keys. */
     if(!next_tree) {
@@ -401,13 +404,13 @@ int merge(ttheap_node_t **a, ttheap_node_t **b)
          */
 
         if(next_other) {
-            add_child(other, tree);
+            add_child(h, other, tree);
 	    tree->dim++;
             *a = NULL;  *b = tree;
         }
         else {
-	    tree->partner = other;
-	    other->partner = tree;
+	    tree->partner = TTH_INDEX(h, other);
+	    other->partner = TTH_INDEX(h, tree);
 	    other->extra = TRUE;
 	    
             *a = tree;  *b = NULL;
@@ -419,17 +422,17 @@ int merge(ttheap_node_t **a, ttheap_node_t **b)
          * values of keys.  The resulting 3-node trunk becomes a carry tree.
          */
 
-	tree->partner = NULL;
-	other->partner = next_tree;
-	next_tree->partner = other;
+	tree->partner = TTHEAP_NIL;
+	other->partner = TTH_INDEX(h, next_tree);
+	next_tree->partner = TTH_INDEX(h, other);
 	
         if(other->key < next_tree->key) {    
-            add_child(other, tree);
+            add_child(h, other, tree);
         }
         else {
 	    next_tree->extra = FALSE;
 	    other->extra = TRUE;	    
-            add_child(next_tree, tree);
+            add_child(h, next_tree, tree);
         }
 
 	tree->dim++;
@@ -444,13 +447,13 @@ int merge(ttheap_node_t **a, ttheap_node_t **b)
          * and (next_tree).  This uses no key comparisons.
          */
 
-	tree->partner=NULL;
-	next_tree->partner = NULL;
+	tree->partner= TTHEAP_NIL;
+	next_tree->partner = TTHEAP_NIL;
 	next_tree->extra = FALSE;
-	next_tree->left = next_tree->right = next_tree;
-        next_tree->parent = NULL;
+	next_tree->left = next_tree->right = TTH_INDEX(h, next_tree);
+        next_tree->parent = TTHEAP_NIL;
 
-        add_child(other, tree);
+        add_child(h, other, tree);
 	
 	tree->dim++;
 	
@@ -471,26 +474,27 @@ void remove_node(ttheap_t *h, ttheap_node_t *r_node)
     int d;
 
     
-    partner = r_node->partner;
+    partner = TTH_NODE(h, r_node->partner);
     
     /* If this node is an extra node we simply cut the link between it and its
      * partner.
      */
     if(r_node->extra) {
-        r_node->partner->partner = NULL;
-	r_node->partner = NULL;
+        TTH_NODE(h, r_node->partner)->partner = TTHEAP_NIL;
+	r_node->partner = TTHEAP_NIL;
 	r_node->extra = FALSE;
     }
     /* Else if has a partner, which will be an extra node, extra node then use
      * the partner to replace it.
      */
     else if(partner) {
-	partner->partner = NULL;
-	r_node->partner = NULL;
+	partner->partner = TTHEAP_NIL;
+	r_node->partner = TTHEAP_NIL;
 	partner->extra = FALSE;
 
         /* Now we put the partner in r_nodes position. */
-        replace_child(r_node, partner);
+        replace_child(h, r_node, partner);
+        OP_LINK(h->ops);
 
     }
     /* Otherwise we need some rearrangement of the workspace. */
@@ -498,6 +502,7 @@ void remove_node(ttheap_t *h, ttheap_node_t *r_node)
 	/* At this point, we know that r_node is not paired with another
 	 * node, so we need to rearrange the work space.
 	 */
+	OP_RESTRUCT(h->ops);
 	
         /* Look at up to two similar nodes in the work space and determine if
          * they have an extra node under them.  Nodes relative to the node
@@ -520,7 +525,7 @@ void remove_node(ttheap_t *h, ttheap_node_t *r_node)
 	
 	/* First, check if the right sibling, dimension i+1, node-pair exists.
 	 */
-	m = r_node->right;
+	m = TTH_NODE(h, r_node->right);
         if(m->dim) {
 	    /* A dimension i+1 sibling exists, so there is no similar trunk
 	     * above in the work space, but there is one below.
@@ -528,14 +533,14 @@ void remove_node(ttheap_t *h, ttheap_node_t *r_node)
 	    
 	    ax = ap = NULL;
 	    
-	    bx = m->child->partner;
-	    bp = bx ? NULL : m->child;
+	    bx = TTH_NODE(h, TTH_NODE(h, m->child)->partner);
+	    bp = bx ? NULL : TTH_NODE(h, m->child);
 	}
 	else {
 	    /* A dimension i+1 sibling does not exist, so determine which trunk
 	     * in the work space r_node lies on.
 	     */
-            m = r_node->parent;
+            m = TTH_NODE(h, r_node->parent);
 	    if(m->extra) {
 		/* There are no similar trunks below r_node's in the work
 		 * space, but there is one above.
@@ -543,27 +548,27 @@ void remove_node(ttheap_t *h, ttheap_node_t *r_node)
 		
                 bx = bp = NULL;
 		
-		m = m->partner;
-		ax = m->child->partner;
-		ap = ax ? NULL : m->child;
+		m = TTH_NODE(h, m->partner);
+		ax = TTH_NODE(h, TTH_NODE(h, m->child)->partner);
+		ap = ax ? NULL : TTH_NODE(h, m->child);
 	    }
 	    else {
 		/* Otherwise, either there may or may no be similar trunks
 		 * above or below.
 		 */
 		
-	        if(m->parent) {
-		    ax = m->left->partner;
-		    ap = ax ? NULL : m->left;
+	        if(m->parent != TTHEAP_NIL) {
+		    ax = TTH_NODE(h, TTH_NODE(h, m->left)->partner);
+		    ap = ax ? NULL : TTH_NODE(h, m->left);
                 }
 		else {
                     ax = ap = NULL;
 		}
 
 		
-      		if((m = m->partner)) {
-		    bx = m->child->partner;
-		    bp = bx ? NULL : m->child;
+      		if((m = TTH_NODE(h, m->partner))) {
+		    bx = TTH_NODE(h, TTH_NODE(h, m->child)->partner);
+		    bp = bx ? NULL : TTH_NODE(h, m->child);
 		}
 		else {
 		    bx = bp = NULL;
@@ -574,41 +579,45 @@ void remove_node(ttheap_t *h, ttheap_node_t *r_node)
 	
         if(bx) {
 	    /* First break 'bx's link to its partner. */
-	    bx->partner->partner = NULL;
-	    bx->partner = NULL;
+	    TTH_NODE(h, bx->partner)->partner = TTHEAP_NIL;
+	    bx->partner = TTHEAP_NIL;
 	    bx->extra = FALSE;
 
             /* Then we insert bx in r_nodes place. */
-            replace_child(r_node, bx);
+            replace_child(h, r_node, bx);
+            OP_LINK(h->ops);
 	}
         else if(bp) {
 
-            b1 = bp->parent;
+            b1 = TTH_NODE(h, bp->parent);
 
             /* Recursively remove b1. */
             remove_node(h, b1);
-	    remove_child(bp, b1);
-	    bp->partner = b1;
-	    b1->partner = bp;
+	    remove_child(h, bp, b1);
+	    OP_LINK(h->ops);
+	    bp->partner = TTH_INDEX(h, b1);
+	    b1->partner = TTH_INDEX(h, bp);
 	    bp->extra = TRUE;
             b1->dim = r_node->dim;
 
-            replace_child(r_node, b1);
+            replace_child(h, r_node, b1);
+            OP_LINK(h->ops);
 	    
             /* It may improve speed by using trim_xnode() when recursion can be
              * avoided.
              */        }
         else if(ax) {
 
-            p = r_node->parent;
-            a2 = ax->partner;
-	    a1 = a2->parent;
+            p = TTH_NODE(h, r_node->parent);
+            a2 = TTH_NODE(h, ax->partner);
+	    a1 = TTH_NODE(h, a2->parent);
 
             /* First remove r_node as a child of p */
-	    remove_child(r_node, p);
+	    remove_child(h, r_node, p);
+	    OP_LINK(h->ops);
 	    
 	    /* Break the partner link from ax to a2. */
-	    ax->partner = NULL;
+	    ax->partner = TTHEAP_NIL;
 	    ax->extra = FALSE;
 
 	    /* Start by swapping the dimensions of nodes p and a2. */
@@ -618,26 +627,28 @@ void remove_node(ttheap_t *h, ttheap_node_t *r_node)
 
 	    /* Node ax, which was a2's partner, becomes the child of node a2.
 	     */
-	    add_child(ax, a2);
+	    add_child(h, ax, a2);
+	    OP_LINK(h->ops);
 
 	    /* The swapping process depends on whether a node pair link or a
 	     * child link is involved.
 	     */
 	    if(p->extra) {
 		/* After swapping, node p has no partner node. */
-		p->partner = NULL;
+		p->partner = TTHEAP_NIL;
 		p->extra = FALSE;
 
 		/* a1 and a2 become a node pair... */
-                a2->partner = a1;
-		a1->partner = a2;
+                a2->partner = TTH_INDEX(h, a1);
+		a1->partner = TTH_INDEX(h, a2);
 		a2->extra = TRUE;
 
 		/* ...and node p replaces node a2 as the child of node a1. */
-		replace_child(a2, p);  /* unnecessary comparison. */
+		replace_child(h, a2, p);  /* unnecessary comparison. */
+		OP_LINK(h->ops);
 	    }
 	    else {
-                a2->partner = NULL;
+                a2->partner = TTHEAP_NIL;
 
                 /* At this point, nodes a2 and p, which are both child nodes of
 		 * node a1, are linked in the wrong order since their
@@ -647,65 +658,68 @@ void remove_node(ttheap_t *h, ttheap_node_t *r_node)
 		/* The left and right pointers only require updating if nodes
 		 * a2 and p are the only children of a1.
 		 */
-                if((l = a2->left) != p) {
+                if((l = TTH_NODE(h, a2->left)) != p) {
 
 	            /* Update sibling pointers. */
-                    r = p->right;
-                    p->left = l;
-		    a2->right = r;
-		    p->right = a2;
-		    a2->left = p;
-		    l->right = p;
-		    r->left = a2;
+                    r = TTH_NODE(h, p->right);
+                    p->left = TTH_INDEX(h, l);
+		    a2->right = TTH_INDEX(h, r);
+		    p->right = TTH_INDEX(h, a2);
+		    a2->left = TTH_INDEX(h, p);
+		    l->right = TTH_INDEX(h, p);
+		    r->left = TTH_INDEX(h, a2);
 
 	            /* Determine if the child pointer of a1 will need to be
 		     * updated.
 	             */
-		    if(a1->child == p) {
-			a1->child = a2;
+		    if(a1->child == TTH_INDEX(h, p)) {
+			a1->child = TTH_INDEX(h, a2);
 		    }
 		}
 		else {
-		    a1->child = a2;
+		    a1->child = TTH_INDEX(h, a2);
 		}
 	    }
         }
         else if(ap) {
 
-	    p = r_node->parent;
+	    p = TTH_NODE(h, r_node->parent);
 	    
             /* First remove r_node as a child of p */
-	    remove_child(r_node, p);
+	    remove_child(h, r_node, p);
+	    OP_LINK(h->ops);
 
 	    /* Recursively remove p. */
             remove_node(h, p);
             p->dim = r_node->dim;
 
             /* Make p and ap a node pair. */
-	    p->partner = ap;
-	    ap->partner = p;
+	    p->partner = TTH_INDEX(h, ap);
+	    ap->partner = TTH_INDEX(h, p);
 
 	    /* Now determine if p will be the extra node or ap will be. */
 	    if(p->key < ap-> key) {
                 /* p must replace ap, and ap must become an extra node. */
 		p->extra = FALSE;
-		replace_child(ap, p);
+		replace_child(h, ap, p);
+		OP_LINK(h->ops);
 		ap->extra = TRUE;
 	    }
 	    else {
 		/* p is the extra node. */
 		p->extra = TRUE;
 	    }
-            h->key_comps++;
+            OP_COMP(h->ops);
 	    
 
         }
         else {
             d = r_node->dim;
-	    p = r_node->parent;
+	    p = TTH_NODE(h, r_node->parent);
 
 	    /* Remove r_node. */
-	    remove_child(r_node, p);
+	    remove_child(h, r_node, p);
+	    OP_LINK(h->ops);
 
             /* The work space only has r_node node and parent.  This only
              * occurs when parent is a root node, so after removing r_node we
@@ -718,7 +732,7 @@ void remove_node(ttheap_t *h, ttheap_node_t *r_node)
             p->dim = d;
 
 	    /* Reinsert p. */
-            p->left = p->right = NULL;
+            p->left = p->right = TTHEAP_NIL;
             meld(h, p);
         }
     }
@@ -728,7 +742,7 @@ void remove_node(ttheap_t *h, ttheap_node_t *r_node)
 /* remove_child() - Removes a highest dimension child node, c, from its
  * parent, p.  Make sure the correct pointer for p is passed.
  */
-void remove_child(ttheap_node_t *c, ttheap_node_t *p)
+void remove_child(ttheap_t *h, ttheap_node_t *c, ttheap_node_t *p)
 {
     ttheap_node_t *l, *r;
 
@@ -736,15 +750,15 @@ void remove_child(ttheap_node_t *c, ttheap_node_t *p)
      * other child nodes must be updated.
      */
     if(c->dim) {
-	l = c->left;
-	r = c->right;
-	l->right = r;
-	r->left = l;
+	l = TTH_NODE(h, c->left);
+	r = TTH_NODE(h, c->right);
+	l->right = TTH_INDEX(h, r);
+	r->left = TTH_INDEX(h, l);
 
-	p->child = l;
+	p->child = TTH_INDEX(h, l);
     }
     else {
-	p->child = NULL;
+	p->child = TTHEAP_NIL;
     }
 }
 
@@ -752,7 +766,7 @@ void remove_child(ttheap_node_t *c, ttheap_node_t *p)
 /* add_child() - Adds a new child, c, to node p.  The user should ensure that
  * the correct dimension child is being added.
  */
-void add_child(ttheap_node_t *c, ttheap_node_t *p)
+void add_child(ttheap_t *h, ttheap_node_t *c, ttheap_node_t *p)
 {
     ttheap_node_t *l, *r;
 
@@ -760,59 +774,59 @@ void add_child(ttheap_node_t *c, ttheap_node_t *p)
      * Otherwise only initialise the left and right pointers of the added
      * child.
      */
-    if((l = p->child)) {
-	r = l->right;
-	c->left = l;
-	c->right = r;
-	r->left = c;
-	l->right = c;
+    if((l = TTH_NODE(h, p->child))) {
+	r = TTH_NODE(h, l->right);
+	c->left = TTH_INDEX(h, l);
+	c->right = TTH_INDEX(h, r);
+	r->left = TTH_INDEX(h, c);
+	l->right = TTH_INDEX(h, c);
     }
     else {
-	c->left = c->right = c;
+	c->left = c->right = TTH_INDEX(h, c);
     }
 
-    p->child = c;
-    c->parent = p;
+    p->child = TTH_INDEX(h, c);
+    c->parent = TTH_INDEX(h, p);
 }
 
 
 /* replace_child() - replaces child node `old' and its sub-tree with child
  * node `new' and its sub-tree.
  */
-void replace_child(ttheap_node_t *old, ttheap_node_t *new)
+void replace_child(ttheap_t *h, ttheap_node_t *old, ttheap_node_t *new)
 {
     ttheap_node_t *parent, *l, *r;
 
-    r = old->right;
+    r = TTH_NODE(h, old->right);
 
     /* If `old' is an only child we only need to initialise the sibling
      * pointers of the new node.  Otherwise we update sibling pointers of other
      * child nodes.
      */
     if(r == old) {
-	new->right = new->left = new;
+	new->right = new->left = TTH_INDEX(h, new);
     }
     else {
-        l = old->left;
-	l->right = new;
-	r->left = new;
-	new->left = l;
-	new->right = r;
+        l = TTH_NODE(h, old->left);
+	l->right = TTH_INDEX(h, new);
+	r->left = TTH_INDEX(h, new);
+	new->left = TTH_INDEX(h, l);
+	new->right = TTH_INDEX(h, r);
     }
 
     /* Update parent pointer of the new node and possibly the child pointer
      * of the parent node.
      */
-    parent = old->parent;
-    new->parent = parent;
-    if(parent->child == old) parent->child = new;
+    parent = TTH_NODE(h, old->parent);
+    new->parent = TTH_INDEX(h, parent);
+    if(parent->child == TTH_INDEX(h, old)) parent->child = TTH_INDEX(h, new);
 }
 
 
 
 /* Recursively print the nodes of a 2-3 heap. */
 #if TTHEAP_DUMP
-void tth_dump_nodes(ttheap_node_t *ptr, int level)
+void tth_dump_nodes(ttheap_t *h, ttheap_node_t *ptr, int level)
 {
      ttheap_node_t *child_ptr, *partner;
      int i, ch_count;
@@ -822,24 +836,24 @@ void tth_dump_nodes(ttheap_node_t *ptr, int level)
 
      printf("%d(%ld)\n", ptr->vertex_no, ptr->key);
      
-     if((child_ptr = ptr->child)) {
-	 child_ptr = ptr->child->right;
+     if((child_ptr = TTH_NODE(h, ptr->child))) {
+	 child_ptr = TTH_NODE(h, TTH_NODE(h, ptr->child)->right);
 	 
          ch_count = 0;
 
          do {
-             tth_dump_nodes(child_ptr, level+1);
+             tth_dump_nodes(h, child_ptr, level+1);
 	     if(child_ptr->dim != ch_count) {
                  for(i = 0; i < level+1; i++) printf("   ");
 		 printf("error(dim)\n");  exit(1);
 	     }
-	     if(child_ptr->parent != ptr) {
+	     if(child_ptr->parent != TTH_INDEX(h, ptr)) {
                  for(i = 0; i < level+1; i++) printf("   ");
 		 printf("error(parent)\n");
 	     }
-             child_ptr = child_ptr->right;
+             child_ptr = TTH_NODE(h, child_ptr->right);
 	     ch_count++;
-         } while(child_ptr != ptr->child->right);
+         } while(child_ptr != TTH_NODE(h, TTH_NODE(h, ptr->child)->right));
 
          if(ch_count != ptr->dim) {
 	     for(i = 0; i < level; i++) printf("   ");
@@ -853,7 +867,7 @@ void tth_dump_nodes(ttheap_node_t *ptr, int level)
 	 }
      }
      
-     if((partner=ptr->partner)) {
+     if((partner=TTH_NODE(h, ptr->partner))) {
 	 if(ptr->extra==partner->extra) {
             for(i = 0; i < level; i++) printf("   ");
 	    printf("%d - error(extra?)\n", partner->vertex_no);  exit(1);
@@ -863,7 +877,7 @@ void tth_dump_nodes(ttheap_node_t *ptr, int level)
                  for(i = 0; i < level; i++) printf("   ");
 		 printf("%d - error(dim)\n", partner->vertex_no);  exit(1);
 	     }
-	     tth_dump_nodes(partner, level);
+	     tth_dump_nodes(h, partner, level);
 	 }
      }
 
@@ -887,7 +901,7 @@ void tth_dump(ttheap_t *h)
     for(i=0; i<h->max_trees; i++) {
         if((ptr = h->trees[i])) {
             printf("tree %d\n\n", i);
-            tth_dump_nodes(ptr, 0);
+            tth_dump_nodes(h, ptr, 0);
 	    printf("\n");
         }
     }
@@ -917,7 +931,11 @@ int _tth_n(void *h) {
 }
 
 long _tth_key_comps(void *h) {
-    return ((ttheap_t *)h)->key_comps;
+    return ((ttheap_t *)h)->ops.comps;
+}
+
+const opcount_t *_tth_counts(void *h) {
+    return &((ttheap_t *)h)->ops;
 }
 
 void *_tth_alloc(int n) {
@@ -943,5 +961,9 @@ const heap_info_t TTHEAP_info = {
     _tth_key_comps,
     _tth_alloc,
     _tth_free,
-    _tth_dump
+    _tth_dump,
+    NULL,
+    NULL,
+    NULL,
+    _tth_counts
 };
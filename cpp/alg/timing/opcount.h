@@ -0,0 +1,80 @@
+#ifndef OPCOUNT_H
+#define OPCOUNT_H
+/*** File opcount.h - Counters for the basic operations of data structures ***/
+
+/* This file provides a structure for counting the basic operations performed
+ * by a heap or dictionary, and macros for updating the counts.  Each heap and
+ * dictionary keeps an opcount_t, which algorithms can read through the counts()
+ * function of heap_info_t or dict_info_t.  The counters are:
+ *
+ *   comps     - key comparisons.
+ *   allocs    - node allocations.  Structures which allocate all of their
+ *               nodes in one block do not count any.
+ *   links     - the number of times a node is linked to, or cut from, a parent
+ *               node.  In array based heaps, the number of entries moved, and
+ *               in bucket based heaps, the number of items added to buckets.
+ *   restructs - rotations, or node splits and merges, in search trees.  Tree
+ *               merges, cascading cuts and work space rearrangements in heaps,
+ *               heap rebuilds in array based heaps, and bucket redistributions
+ *               in bucket based heaps.
+ *   max_depth - the maximum depth of a node reached in a search tree, the
+ *               maximum tree rank (or dimension) in a heap, or the longest
+ *               sift path in an array based heap.  For bucket based heaps, the
+ *               largest bucket emptied or skipped, for pairing heaps, the
+ *               longest list of trees combined, and for skip lists, the
+ *               highest level of a node inserted.
+ */
+
+
+/* Use 1 to count operations, or 0 to remove all counting code, for example
+ * when timing.  This can also be set when compiling, using -DOP_COUNTS=0.
+ */
+#ifndef OP_COUNTS
+#define OP_COUNTS 1
+#endif
+
+
+
+/*** Type definitions ***/
+
+typedef struct opcount {
+    long comps;
+    long allocs;
+    long links;
+    long restructs;
+    int max_depth;
+} opcount_t;
+
+
+
+/*** Macros ***/
+
+/* Macros for updating the counters in the opcount_t structure ops.  When
+ * counting is turned off, the arguments k and d are still evaluated, but are
+ * not counted.  This allows expressions with side effects to be counted.
+ */
+#if OP_COUNTS
+#define OP_COMP(ops) ((ops).comps++)
+#define OP_COMPS(ops, k) ((ops).comps += (k))
+#define OP_ALLOC(ops) ((ops).allocs++)
+#define OP_LINK(ops) ((ops).links++)
+#define OP_LINKS(ops, k) ((ops).links += (k))
+#define OP_RESTRUCT(ops) ((ops).restructs++)
+#define OP_DEPTH(ops, d) \
+    ((d) > (ops).max_depth ? ((ops).max_depth = (d)) : 0)
+#else
+#define OP_COMP(ops) ((void)0)
+#define OP_COMPS(ops, k) ((void)(k))
+#define OP_ALLOC(ops) ((void)0)
+#define OP_LINK(ops) ((void)0)
+#define OP_LINKS(ops, k) ((void)(k))
+#define OP_RESTRUCT(ops) ((void)0)
+#define OP_DEPTH(ops, d) ((void)(d))
+#endif
+
+/* Set all counters in ops to zero. */
+#define OP_RESET(ops) \
+    ((ops).comps = (ops).allocs = (ops).links = (ops).restructs = 0, \
+     (ops).max_depth = 0)
+
+#endif
@@ -0,0 +1,164 @@
+#include <cstdio>
+#include "dgraph.h"
+/* Directed Graphs
+ * ----------------------------------------------------------------------------
+ */
+
+/*--- DGraph -------------------------------------------------------------*/
+
+/* - Constructor -
+ * Allocate a graph of n vertices with no edges.
+ */
+DGraph::DGraph(int n)
+{
+    nVertices = n;
+    vertices = new DGraphVertex[n];
+    initVertices();
+}
+
+/* - Destructor - */
+DGraph::~DGraph()
+{
+    clear();
+    delete [] vertices;
+}
+
+/* - clear() -
+ * Remove all edges from the graph.  Each edge is deleted from the OUT list of
+ * its source vertex.
+ */
+void DGraph::clear()
+{
+    DGraphEdge *edge, *nextEdge;
+    int v;
+
+    for(v = 0; v < nVertices; v++) {
+        edge = vertices[v].outHead;
+        while(edge) {
+            nextEdge = edge->nextOut;
+            delete edge;
+            edge = nextEdge;
+        }
+    }
+    initVertices();
+}
+
+/* - initVertices() -
+ * Set the edge lists of all vertices to empty.
+ */
+void DGraph::initVertices()
+{
+    int v;
+
+    for(v = 0; v < nVertices; v++) {
+        vertices[v].outHead = vertices[v].outTail = 0;
+        vertices[v].inHead = vertices[v].inTail = 0;
+        vertices[v].outSize = vertices[v].inSize = 0;
+    }
+}
+
+/* - addNewEdge() -
+ * Add an edge of distance dist from vertex source to vertex target.  The edge
+ * goes on the end of the OUT list of source and the IN list of target.
+ */
+void DGraph::addNewEdge(int source, int target, int dist)
+{
+    DGraphEdge *newEdge = new DGraphEdge;
+
+    newEdge->source = source;
+    newEdge->target = target;
+    newEdge->dist = dist;
+    newEdge->nextOut = 0;
+    newEdge->nextIn = 0;
+
+    DGraphVertex *vertex = &vertices[source];
+    if(vertex->outTail) {
+        vertex->outTail->nextOut = newEdge;
+    }
+    else {
+        vertex->outHead = newEdge;
+    }
+    vertex->outTail = newEdge;
+    vertex->outSize++;
+
+    vertex = &vertices[target];
+    if(vertex->inTail) {
+        vertex->inTail->nextIn = newEdge;
+    }
+    else {
+        vertex->inHead = newEdge;
+    }
+    vertex->inTail = newEdge;
+    vertex->inSize++;
+}
+
+/* - edgeExists() -
+ * Returns true if there is an edge from vertex v to vertex w.
+ */
+bool DGraph::edgeExists(int v, int w) const
+{
+    const DGraphEdge *edge = vertices[v].outHead;
+
+    while(edge) {
+        if(edge->target == w) return true;
+        edge = edge->nextOut;
+    }
+    return false;
+}
+
+/* - reachable() -
+ * Returns true if all vertices can be reached from vertex s.
+ */
+bool DGraph::reachable(int s) const
+{
+    int v, w, nReached, top;
+    const DGraphEdge *edge;
+
+    bool *reached = new bool[nVertices];
+    int *stack = new int[nVertices];
+
+    for(v = 0; v < nVertices; v++) reached[v] = false;
+
+    /* depth first search from s, stacking each vertex when first reached */
+    reached[s] = true;
+    stack[0] = s;
+    top = 1;
+    nReached = 1;
+    while(top > 0) {
+        v = stack[--top];
+        edge = vertices[v].outHead;
+        while(edge) {
+            w = edge->target;
+            if(!reached[w]) {
+                reached[w] = true;
+                stack[top++] = w;
+                nReached++;
+            }
+            edge = edge->nextOut;
+        }
+    }
+
+    delete [] stack;
+    delete [] reached;
+
+    return nReached == nVertices;
+}
+
+/* - print() -
+ * Print each vertex followed by its outgoing edges, as target(dist) pairs.
+ */
+void DGraph::print() const
+{
+    const DGraphEdge *edge;
+    int v;
+
+    for(v = 0; v < nVertices; v++) {
+        std::printf("%d:", v);
+        edge = vertices[v].outHead;
+        while(edge) {
+            std::printf(" %d(%d)", edge->target, edge->dist);
+            edge = edge->nextOut;
+        }
+        std::printf("\n");
+    }
+}
@@ -60,8 +60,8 @@ class DGraph {
     int nVertices;
     DGraphVertex *vertices;
 
-    DGraph::DGraph(int n);
-    DGraph::~DGraph();
+    DGraph(int n);
+    ~DGraph();
 
     void clear();
     void addNewEdge(int srcVertexNo, int destVertexNo, int dist);
@@ -0,0 +1,160 @@
+#ifndef BHEAP_H
+#define BHEAP_H
+/* File bheap.h - Binary Heap
+ * ----------------------------------------------------------------------------
+ */
+
+#include <cstdio>
+#include "heap.h"
+
+/* --- BHeap ---
+ * Binary heap class derived from the abstract base class Heap.  The heap is
+ * stored as an array a[1..itemCount] of items, in which the children of
+ * position i are at positions 2i and 2i+1.  The array key[] holds the key of
+ * each item, and p[] holds the position in a[] of each item, so that
+ * decreaseKey() can locate an item directly.  Items are integers in the range
+ * 0..n-1, where n is the constructor parameter.
+ *
+ * All methods are defined inline in this header.  When a BHeap is used through
+ * a Heap pointer, calls go through the virtual table as usual.  When a BHeap
+ * object is used directly, such as by StaticDijkstra<BHeap> (see
+ * hw2/dijkstra_static.h), the compiler binds the calls statically and can
+ * inline them into the caller.
+ */
+class BHeap: public Heap {
+  public:
+    BHeap(int n);
+    ~BHeap();
+
+    int deleteMin();
+    void insert(int item, long k);
+    void decreaseKey(int item, long newKey);
+    int nItems() const { return itemCount; }
+    long nComps() const { return compCount; }
+    void dump() const;
+
+  private:
+    int *a;            // array: heap positions -> items
+    int *p;            // array: items -> heap positions
+    long *key;         // array: items -> keys
+    int itemCount;     // number of items in the heap
+    long compCount;    // number of key comparisons
+
+    void siftUp(int item, int q);
+    void siftDown(int item, int q);
+};
+
+/*--- BHeap (inline methods) ------------------------------------------------*/
+
+/* - Constructor -
+ * Allocate a heap for items in the range 0..n-1.
+ */
+inline BHeap::BHeap(int n)
+{
+    a = new int[n + 1];
+    p = new int[n];
+    key = new long[n];
+    itemCount = 0;
+    compCount = 0;
+}
+
+/* - Destructor - */
+inline BHeap::~BHeap()
+{
+    delete [] a;
+    delete [] p;
+    delete [] key;
+}
+
+/* - deleteMin() -
+ * Remove the item with the minimum key from the heap and return it.
+ */
+inline int BHeap::deleteMin()
+{
+    int minItem = a[1];
+    int last = a[itemCount--];
+
+    if(itemCount > 0) siftDown(last, 1);
+
+    return minItem;
+}
+
+/* - insert() -
+ * Insert item 'item' with key k into the heap.
+ */
+inline void BHeap::insert(int item, long k)
+{
+    key[item] = k;
+    siftUp(item, ++itemCount);
+}
+
+/* - decreaseKey() -
+ * Decrease the key of item 'item', which is already in the heap, to newKey.
+ */
+inline void BHeap::decreaseKey(int item, long newKey)
+{
+    key[item] = newKey;
+    siftUp(item, p[item]);
+}
+
+/* - dump() -
+ * Print the heap array, one "item(key)" per position.
+ */
+inline void BHeap::dump() const
+{
+    int i;
+
+    for(i = 1; i <= itemCount; i++) {
+        std::printf("%d(%ld) ", a[i], key[a[i]]);
+    }
+    std::printf("\n");
+}
+
+/* - siftUp() -
+ * Place item at position q, or above it, moving larger parents down until the
+ * heap ordering is restored.
+ */
+inline void BHeap::siftUp(int item, int q)
+{
+    int parent;
+    long k = key[item];
+
+    while(q > 1) {
+        parent = q >> 1;
+        compCount++;
+        if(key[a[parent]] <= k) break;
+        a[q] = a[parent];
+        p[a[q]] = q;
+        q = parent;
+    }
+
+    a[q] = item;
+    p[item] = q;
+}
+
+/* - siftDown() -
+ * Place item at position q, or below it, moving smaller children up until the
+ * heap ordering is restored.
+ */
+inline void BHeap::siftDown(int item, int q)
+{
+    int child;
+    long k = key[item];
+
+    while((child = q << 1) <= itemCount) {
+        if(child < itemCount) {
+            compCount++;
+            if(key[a[child + 1]] < key[a[child]]) child++;
+        }
+        compCount++;
+        if(k <= key[a[child]]) break;
+        a[q] = a[child];
+        p[a[q]] = q;
+        q = child;
+    }
+
+    a[q] = item;
+    p[item] = q;
+}
+
+#endif
@@ -21,6 +21,10 @@
  * nComps()       - returns the number of key comparison operations.
  * dump()         - prints a text representation of the heap to the standard
  *                  output.
+ *
+ * A derived heap can also be used without virtual dispatch, by naming it as
+ * the heap type of an algorithm template such as StaticDijkstra
+ * (hw2/dijkstra_static.h).
  */
 class Heap {
   public:
@@ -0,0 +1,121 @@
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include "dijkstra.h"
+#include "dijkstra_static.h"
+#include "dgraph.h"
+#include "heaps/bheap.h"
+/* Dijkstra's Algorithm - Virtual versus Static Heap Dispatch
+ * ----------------------------------------------------------------------------
+ * Times Dijkstra (heap calls through the Heap virtual table) against
+ * StaticDijkstra<BHeap> (heap calls bound statically) on the same random
+ * graphs and source vertices, and checks that both compute the same
+ * distances.
+ *
+ * Usage: dijkstra_bench [n [degree [queries]]]
+ *
+ * Build with "make" in this directory, which links the Dijkstra class
+ * (dijkstra4.cc) and the DGraph class (../dgraph.cc).
+ */
+
+/*--- Constants -------------------------------------------------------------*/
+
+const int N_GRAPHS = 5;          // number of random graphs per size
+const int MAX_EDGE_DIST = 1000;  // edge distances are in 1..MAX_EDGE_DIST
+
+/*--- Functions -------------------------------------------------------------*/
+
+/* - randomGraph() -
+ * Fill g with a random graph in which each vertex v has an edge to v+1 (so
+ * that all vertices are reachable from any source) plus deg-1 edges to
+ * random vertices.
+ */
+void randomGraph(DGraph *g, int deg)
+{
+    int v, i;
+    const int n = g->nVertices;
+
+    g->clear();
+    for(v = 0; v < n; v++) {
+        g->addNewEdge(v, (v + 1) % n, 1 + std::rand() % MAX_EDGE_DIST);
+        for(i = 1; i < deg; i++) {
+            g->addNewEdge(v, std::rand() % n, 1 + std::rand() % MAX_EDGE_DIST);
+        }
+    }
+}
+
+/* - resetDist() -
+ * Set d[v] = INFINITE_DIST for all n vertices, as required by run().
+ */
+void resetDist(long *d, int n)
+{
+    int v;
+
+    for(v = 0; v < n; v++) d[v] = INFINITE_DIST;
+}
+
+/*--- Main ------------------------------------------------------------------*/
+
+int main(int argc, char *argv[])
+{
+    int n = argc > 1 ? std::atoi(argv[1]) : 10000;
+    int deg = argc > 2 ? std::atoi(argv[2]) : 8;
+    int queries = argc > 3 ? std::atoi(argv[3]) : 20;
+    int i, q, v, s;
+    clock_t start;
+    double virtualTime = 0, staticTime = 0;
+    long checksum = 0;
+    bool ok = true;
+
+    DGraph graph(n);
+    long *d1 = new long[n];
+    long *d2 = new long[n];
+    HeapD<BHeap> heapD;
+    Dijkstra virtualAlg(n, &heapD);
+    StaticDijkstra<BHeap> staticAlg(n);
+
+    std::srand(1);
+
+    for(i = 0; i < N_GRAPHS; i++) {
+        randomGraph(&graph, deg);
+        virtualAlg.init(&graph);
+        staticAlg.init(&graph);
+
+        for(q = 0; q < queries; q++) {
+            s = std::rand() % n;
+
+            resetDist(d1, n);
+            start = clock();
+            virtualAlg.run(d1, s);
+            virtualTime += (double)(clock() - start) / CLOCKS_PER_SEC;
+
+            resetDist(d2, n);
+            start = clock();
+            staticAlg.run(d2, s);
+            staticTime += (double)(clock() - start) / CLOCKS_PER_SEC;
+
+            for(v = 0; v < n; v++) {
+                if(d1[v] != d2[v]) ok = false;
+                checksum += d2[v];
+            }
+        }
+    }
+
+    std::printf("n = %d, degree = %d, %d graphs x %d queries\n",
+                n, deg, N_GRAPHS, queries);
+    std::printf("%-24s %10s %14s\n", "Dispatch", "time (s)", "us per query");
+    std::printf("%-24s %10.3f %14.1f\n", "virtual (HeapD<BHeap>)",
+                virtualTime, 1e6 * virtualTime / (N_GRAPHS * queries));
+    std::printf("%-24s %10.3f %14.1f\n", "static (BHeap)",
+                staticTime, 1e6 * staticTime / (N_GRAPHS * queries));
+    if(staticTime > 0) {
+        std::printf("speedup: %.2f\n", virtualTime / staticTime);
+    }
+    std::printf("checksum: %ld, results %s\n", checksum,
+                ok ? "match" : "DIFFER");
+
+    delete [] d1;
+    delete [] d2;
+
+    return ok ? 0 : 1;
+}
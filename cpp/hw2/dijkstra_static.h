@@ -0,0 +1,136 @@
+#ifndef DIJKSTRA_STATIC_H
+#define DIJKSTRA_STATIC_H
+/* Dijkstra's Algorithm - Statically Dispatched Heap
+ * ----------------------------------------------------------------------------
+ */
+
+#include "dgraph.h"
+
+/* --- StaticDijkstra ---
+ * Dijkstra's single-source algorithm, parameterised by the heap class to be
+ * used.  This is the same algorithm as the Dijkstra class (dijkstra.h), but the
+ * heap is a member object of type HeapPolicy instead of a Heap pointer created
+ * through a HeapDesc.  Since the compiler knows the exact type of the heap,
+ * calls to insert(), deleteMin() and decreaseKey() are bound statically and
+ * can be inlined into the relaxation loop, rather than going through the
+ * virtual table.
+ *
+ * HeapPolicy may be any class providing the following members.  Every heap
+ * that can be used with HeapD<T> (heaps/heap.h) qualifies:
+ *
+ * HeapPolicy(int n)   - constructs a heap for items in the range 0..n-1.
+ * deleteMin()         - removes and returns the item with minimum key.
+ * insert(item, key)   - inserts an item with the given key.
+ * decreaseKey(item, newKey) - decreases the key of an item in the heap.
+ * nItems()            - returns the number of items in the heap.
+ *
+ * For example, StaticDijkstra<BHeap> runs Dijkstra's algorithm with the binary
+ * heap of heaps/bheap.h, where Dijkstra(n, new HeapD<BHeap>) would use the same
+ * heap through virtual calls.
+ */
+template <class HeapPolicy>
+class StaticDijkstra {
+  public:
+    StaticDijkstra(int n);
+    ~StaticDijkstra();
+
+    void init(const DGraph *g) { graph = g; }
+    void run(long *d, int s = 0);
+
+    const HeapPolicy &getHeap() const { return heap; }
+
+  private:
+    HeapPolicy heap;   // object: heap
+    bool *s;           // array: solution set state of vertices
+    bool *f;           // array: frontier set state of vertices
+
+    const DGraph *graph;    // pointer: directed graph
+};
+
+/*--- StaticDijkstra (template methods) -------------------------------------*/
+
+/* - Constructor -
+ * Allocate the algorithm for use on graphs of n vertices.
+ */
+template <class HeapPolicy>
+StaticDijkstra<HeapPolicy>::StaticDijkstra(int n) : heap(n)
+{
+    s = new bool[n];
+    f = new bool[n];
+    graph = 0;
+}
+
+/* - Destructor - */
+template <class HeapPolicy>
+StaticDijkstra<HeapPolicy>::~StaticDijkstra()
+{
+    delete [] s;
+    delete [] f;
+}
+
+/* - run() -
+ * Run the algorithm, computing single-source from the starting vertex v0.
+ * This assumes that the array d has been initialised with d[v] = INFINITE_DIST
+ * for all vertices v != v0.
+ */
+template <class HeapPolicy>
+void StaticDijkstra<HeapPolicy>::run(long *d, int v0)
+{
+    /* indexes, counters, pointers */
+    int v, w;
+    long dist;
+    const DGraphEdge *edge;
+
+
+  /*** initialisation ***/
+
+    /* optimise access to the data structures allocated for the algorithm */
+    const int n = graph->nVertices;
+    const DGraphVertex *vertices = graph->vertices;
+
+  /*** algorithm ***/
+
+    /* initialise all vertices as unexplored */
+    for(v = 0; v < n; v++) s[v] = false;
+    for(v = 0; v < n; v++) f[v] = false;
+
+    /* place v0 into the frontier set with a distance of zero */
+    d[v0] = 0;
+    heap.insert(v0, 0);
+    f[v0] = true;
+
+    /* repeatedly update distances from the minimum remaining trigger vertex */
+    while(heap.nItems() > 0) {
+        /* delete the vertex in frontier that has minimum distance */
+        v = heap.deleteMin();
+
+        /* the selected vertex moves from the frontier to the solution set */
+        s[v] = true;
+        f[v] = false;
+
+        /* explore the OUT set of v */
+        edge = vertices[v].outHead;
+        while(edge) {
+            w = edge->target;
+
+            if(s[w] == false) {
+                dist = d[v] + edge->dist;
+                if(dist < d[w]) {
+                    d[w] = dist;
+                    if(f[w]) {
+                        heap.decreaseKey(w, dist);
+                    }
+                    else {
+                        heap.insert(w, dist);
+                        f[w] = true;
+                    }
+                }
+            }
+
+            edge = edge->nextOut;
+        } /* while */
+
+    } /* while */
+}
+
+#endif